@@ -0,0 +1,119 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// aggregate.hpp
+//
+// General Description
+//
+// Minimum, maximum and average of the numerical measured values over sliding windows, kept in memory.
+// The roll-up tables of the database have fixed buckets and need a query. These aggregates are always up to date.
+//
+// Each window is divided into AggregationBucketsPerWindow buckets. A bucket holds the aggregate of the values in its
+// time slice. The buckets are a ring: The bucket for a time is (time / bucket width) modulo the number of buckets.
+// Adding a value changes only one bucket. If the bucket belongs to an older slice, it is reset before.
+// Reading combines the buckets that are still inside the window. So the window slides with a resolution of one bucket.
+//
+// The values are added in the main thread. The TCP servers may read them in other reactor threads.
+// The buckets of each EHZ are protected by a sequence lock, like the blocks of the snapshot segment: The writer makes
+// the sequence odd, changes the buckets and makes it even again. A reader copies the buckets of a window and repeats
+// this, if the sequence was odd or has changed. So adding values never waits for a reader.
+//
+
+#ifndef AGGREGATE_HPP
+#define AGGREGATE_HPP
+
+#include "ehzmeasureddata.hpp"
+
+#include <vector>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General definitions
+
+	namespace AggregateInternal
+	{
+		// The sliding windows: 1 minute, 15 minutes, 1 hour and 1 day
+		const uint NumberOfAggregationWindows = 4U;
+		const time_t AggregationWindowInS[NumberOfAggregationWindows] = { 60L, 900L, 3600L, 86400L };
+		// Resolution of the windows. The window length must be a multiple of it
+		const uint AggregationBucketsPerWindow = 60U;
+
+		// The aggregate of one measured value over one window
+		struct WindowAggregate
+		{
+			WindowAggregate(void) : minimum(0.0), maximum(0.0), average(0.0), numberOfSamples(null<u64>()) {}
+			mdouble minimum;
+			mdouble maximum;
+			mdouble average;
+			u64 numberOfSamples;
+		};
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Sliding window aggregates of all EHZ
+
+	namespace AggregateInternal
+	{
+		class EhzWindowAggregates
+		{
+			public:
+				// Buckets for all used values of all EHZ of the configuration
+				EhzWindowAggregates(void);
+				virtual ~EhzWindowAggregates(void) {}
+
+				// Add the numerical values of one EHZ. Called for every new set of values
+				void add(const uint ehzIndex, const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz);
+
+				// Aggregate of one value over the window, that ends now. False for an invalid index or without samples
+				boolean get(const uint ehzIndex, const uint valueId, const uint window, const time_t nowTime, WindowAggregate &windowAggregate) const;
+
+			protected:
+				// Aggregate of the values in one time slice
+				struct Bucket
+				{
+					Bucket(void) : slice(-1LL), numberOfSamples(null<u64>()), minimum(0.0), maximum(0.0), sum(0.0) {}
+					s64 slice;			// Time / bucket width. -1: Never used
+					u64 numberOfSamples;
+					mdouble minimum;
+					mdouble maximum;
+					mdouble sum;
+				};
+
+				// Index of the first bucket of a value. The buckets of all windows follow each other
+				uint getFirstBucket(const uint ehzIndex, const uint valueId) const { return (firstValueOfEhz[ehzIndex] + valueId) * NumberOfAggregationWindows * AggregationBucketsPerWindow; }
+
+				// All buckets: Per EHZ, per used value, per window
+				std::vector<Bucket> bucket;
+				// Per EHZ: Index of its first value. The last element is the total number of values
+				std::vector<uint> firstValueOfEhz;
+
+				// Writer and readers are in different threads. One sequence lock per EHZ. Odd, while the buckets change
+				std::vector<u64> sequenceOfEhz;
+			private:
+				// No copies
+				EhzWindowAggregates(const EhzWindowAggregates &);
+				EhzWindowAggregates &operator =(const EhzWindowAggregates &);
+		};
+	}
+
+#endif
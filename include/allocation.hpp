@@ -0,0 +1,130 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// allocation.hpp
+//
+// General Description
+//
+// Accounting of heap allocations. A program, that runs for months on a small computer, suffers from
+// fragmentation of the heap. So after a warm up, the processing of the SML files shall not allocate anything.
+//
+// The accounting is a build mode: make allocationcheck (or ALLOCATION_FLAGS=-DALLOCATION_ACCOUNTING).
+// Then the global operator new is replaced and counts every allocation. The allocation is charged to the
+// subsystem of the calling thread. The entry points of the subsystems set it with an AllocationScope.
+// Everything outside of a scope is charged to "other".
+//
+// When all EHZ have published some SML files, the EhzSystem marks the begin of the steady state. The allocations
+// after this point are counted separately. They are shown by the metrics server. At the end of the program
+// they are reported, and the return code is not 0, if there was any.
+//
+// The server is the exception. It builds every reply and every pushed message as a string and a connection
+// is an object on the heap. So it allocates with each request. Its allocations are counted and reported,
+// but they do not make the check fail.
+//
+// Without the build mode, the scopes are empty and nothing is counted. The allocations of SQLITE are not
+// seen, because SQLITE uses malloc and manages its page cache itself.
+//
+
+#ifndef ALLOCATION_HPP
+#define ALLOCATION_HPP
+
+#include "mytypes.hpp"
+
+#include <ostream>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General definitions
+
+namespace AllocationInternal
+{
+	// Allocations are charged to the subsystem of the thread, that calls operator new
+	struct AllocationSubsystem
+	{
+		enum Type
+		{
+			Other,			// Start up, configuration and everything without a scope
+			Input,			// Serial port, ESC analysis, scanner and parser
+			Evaluation,		// Publishing the values, historian, aggregates and shared memory
+			Database,		// Queue and writer thread of the database
+			Server,			// TCP connections
+			Userinterface,	// Drawing the result windows
+			NumberOfSubsystems
+		};
+	};
+
+	// All EHZ must have published this number of SML files. Then the steady state begins
+	const u64 AllocationWarmUpSmlFiles = 16ULL;
+
+#ifdef ALLOCATION_ACCOUNTING
+	const boolean AllocationAccountingIsActive = true;
+
+	// The subsystem of this thread
+	extern __thread AllocationSubsystem::Type allocationSubsystemForThisThread;
+
+	// Charge the allocations of this thread to a subsystem, until the scope is left. Scopes may be nested
+	class AllocationScope
+	{
+		public:
+			explicit AllocationScope(const AllocationSubsystem::Type subsystem) : outerSubsystem(allocationSubsystemForThisThread) { allocationSubsystemForThisThread = subsystem; }
+			~AllocationScope(void) { allocationSubsystemForThisThread = outerSubsystem; }
+		protected:
+			const AllocationSubsystem::Type outerSubsystem;
+		private:
+			AllocationScope(void);
+			AllocationScope(const AllocationScope &);
+			AllocationScope &operator =(const AllocationScope &);
+	};
+#else
+	const boolean AllocationAccountingIsActive = false;
+
+	// Nothing to do. The compiler removes it
+	class AllocationScope
+	{
+		public:
+			explicit AllocationScope(const AllocationSubsystem::Type) {}
+			~AllocationScope(void) {}
+	};
+#endif
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Counters
+
+	// Number of allocations of a subsystem since program start. Always 0 without the build mode
+	u64 getNumberOfAllocations(const AllocationSubsystem::Type subsystem);
+	// And since the begin of the steady state. 0 before
+	u64 getNumberOfSteadyStateAllocations(const AllocationSubsystem::Type subsystem);
+
+	// The warm up is finished. Called once by the EhzSystem. Later calls are ignored
+	void beginSteadyState(void);
+	boolean isSteadyState(void);
+
+	// Format in the text exposition format of Prometheus. Nothing without the build mode
+	void writeAllocationMetrics(std::ostream &os);
+	// One line per subsystem with allocations in the steady state. Returns false, if there was any but in the server
+	// or the steady state was never reached
+	boolean reportSteadyStateAllocations(std::ostream &os);
+}
+
+
+#endif
@@ -0,0 +1,58 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// clock.hpp
+//
+// General Description
+//
+// Coarse wall clock for time stamps. The values of an SML file get one time stamp in seconds. There
+// is no need to read the clock for every value or to format the time for every value.
+//
+// Every reactor reads the coarse real time clock once, after it has waited for events. All event handlers
+// of this iteration use this value. The clock is stored per thread, because the reactors of the workers
+// run in their own threads. A thread without reactor reads the clock, whenever the time is requested.
+//
+// Only the time_t is stored with the values. The string is formatted, when the user interface or a
+// server needs it. The last formatted time is cached per thread. Most requests are for the same second.
+//
+
+#ifndef CLOCK_HPP
+#define CLOCK_HPP
+
+#include "mytypes.hpp"
+
+#include <time.h>
+
+
+namespace ClockInternal
+{
+	// Read the clock again. Called by the reactors after waiting for events
+	void refreshCoarseClock(void);
+	// Time of the last refresh in this thread. Threads without reactor read the clock directly
+	time_t getCoarseRealTime(void);
+
+	// Local time as "dd.mm.yy HH:MM:SS". The string belongs to this thread and is valid until the next call
+	const mchar *formatTime(const time_t timeToFormat);
+}
+
+
+#endif
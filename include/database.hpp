@@ -1,240 +1,638 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-//
-// General Description
-//
-// This is a part of a systems that reads data from electronic meters.
-// 
-// This data will be stored in a sqlite database.
-// So we inplement a data logger here.
-//
-// Some requirements
-//
-// We want to store measured values from the EHZ into a database
-// The data can be retrieved from the database to show historical values
-// The time of the measured values is important
-// Measured values shall be stored at fixed intervals. This we call Base interval
-// The base interval is x s
-// It shall be possible to retrieve values for multiples of the base interval
-// The folowing periodes shall be used: 30s, 1min, 5min, 10min, 30min, 1h, 2h, 6h, 12h, 1day, 1week. 1 month, 1 year
-// The database shall be created based on the EHZ configuration
-//
-// So as per definition of the EHZ System we will create the necessary fields in the database.
-// At program start it will be checked, if the database exists. If not, it will be created.
-// The names of the fields, the number of the fields and all associated data will be derived from the
-// EHZ configuration.
-// 
-// To make evaluation of the data easier and to avoid slow queries, we do not only store a timestamp
-// per record. Additionally we will store a flag to indicate that a multiple of the timestamp was hit.
-// With that queries like, give me all values for periods of 5 minutes easier.
-//
-#ifndef DATABASE_HPP
-#define DATABASE_HPP
-
-#include "ehzmeasureddata.hpp"
-
-#include "sqlite3.h"
-
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 1. General definitions
-
-	namespace DatabaseInternal
-	{
-		// The name of the database. At the moment hardcoded.
-		const char EhzDatabaseName[] = ROOT_DIRECTORY "/ehz.db";
-		
-	// ------------------------------------------------------------------------------------------------------------------------------
-	// 1.1 Helper structs for the defintion of SQLITE 3 names for columns and types
-			
-		// -----------------------------------------------------------------------------------------------------------
-		// 1.1.1 General struct that can hold the name of the any field/column/attribute and its type in SQLITE terms.
-		struct ColumnNameAndType
-		{
-			public:
-				// Main constructor. Simply copy name and type into this structure
-				explicit ColumnNameAndType(const std::string &cn, const std::string &ct) : columnName(cn), columnType(ct) {}
-				// Default constructor will create empty Strings
-				ColumnNameAndType(void) : columnName(), columnType() {}
-				// No specific destructor needed. The destructor of the struct members will be called
-				virtual ~ColumnNameAndType(void){}
-				
-				// Data member for field/column/attribute
-				std::string columnName;
-				// Data member for type
-				std::string columnType;
-				
-				// For reuse and initialization of this struct, we want to clear (set to empty) the names
-				void clear(void) { columnName.clear(); columnType.clear(); }
-		};
-
-		
-		// -----------------------------------------------------------------------------------------------------------
-		// 1.1.2 EHZ specific struct that can hold the name of the field/column/attribute and its type in SQLITE terms.
-		// We will store aquisition time and all measured values and units for a EHZ
-		struct EhzColumnNameAndType
-		{		
-			// Default consrtuctor. Set all values to default (empty, null)
-			EhzColumnNameAndType(void);
-			// No specific destructor needed. The destructor of the struct members will be called
-			virtual ~EhzColumnNameAndType(void) {}
-			
-			// Sub struct for EHZ measured values 
-			struct MeasuredValueAndUnit
-			{
-				// Default construct. Initalize everything to standard.
-				MeasuredValueAndUnit(void) : measuredValue(), unit() {}
-				// No specific destructor needed. The destructor of the struct members will be called
-				virtual ~MeasuredValueAndUnit(void) {}
-				// Name and Type strings for the measured numerical (text) value
-				ColumnNameAndType measuredValue;
-				// Name and Type strings for the unit of the measured numerical (text) value
-				ColumnNameAndType unit;
-				// For reuse and initialization of this struct, we want to clear (set to empty) the names
-				void clear(void) { measuredValue.clear(); unit.clear();}
-			};
-			// Name and Type strings for the aquisition time of measured values
-			ColumnNameAndType acquisitionTime;
-			// One EHZ may have many measured values. All will be stroed in this vector
-			std::vector<MeasuredValueAndUnit> measuredValueAndUnit;
-			// For reuse and initialization of this struct, we want to clear (set to empty) the names
-			void clear(void) { acquisitionTime.clear(); measuredValueAndUnit.clear(); }
-		};
-
-		// -----------------------------------------------------------------------------------------
-		// 1.1.3 Definition of acquisition time multipliers
-		// As described above we will store additional flage for special acquisition time periods
-		// to make queries simpler
-		// Here we define all periods that will be stored via a flag
-		typedef time_t EhzLogTimeUnit;
-		const EhzLogTimeUnit EhzLogPeriodInS[] = 
-		{
-			30L,
-			60L,
-			300L,
-			600L,
-			1800L,
-			3600L,
-			7200L,
-			21600L,
-			43200L,
-			604800L,
-			2628000L
-		};
-		// Number of periods
-		const uint EhzLogPeriodCount = sizeof(EhzLogPeriodInS) / sizeof(EhzLogPeriodInS[0]);
-
-		// -------------------------------------------------------------------------------------------------------------------
-		// 1.1.4 EHZ SYSTEM specific struct that can hold the name of the field/column/attribute and its type in SQLITE terms.
-		struct EhzSystemColumnNameAndType
-		{
-			// Default consrtuctor. Set all values to default (empty, null)
-			EhzSystemColumnNameAndType(void);
-			// No specific destructor needed. The destructor of the struct members will be called
-			~EhzSystemColumnNameAndType(void) {}
-			
-			// Base time. The time when all data from all EHZ will be stored in one shot
-			const ColumnNameAndType timeBase;
-			// All multiples of periods (see above)
-			std::vector<ColumnNameAndType> ehzTimePeriodNameAndType;
-			// An all names and types for all EHZ that are in the EHZ system
-			std::vector<EhzColumnNameAndType> ehzColumnNameAndType;
-			
-			void buildEhzSystemColumnNameAndType(void);
-		};
-
-
-		
-// ------------------------------------------------------------------------------------------------------------------------------
-// 2. The database
-	
-	// Functionality to store data acquired from all EHZ in a database
-	class EhzDataBase
-	{
-		public:
-			// Constructor creates (if necessary) and opens the database
-			explicit EhzDataBase(const std::string &ehzDatabaseNamel);
-			// Close database
-			~EhzDataBase(void);
-			
-			// Store the measured values and times in the database
-			void storeMeasuredValues(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz);
-			
-			
-		protected:
-			// Check if this database is existing in the specified path
-			boolean isExisting(void) const;
-			// And check, if it is already open
-			boolean isOpen(void)  const  { return (null<sqlite3 *>() != dbHandle);}
-
-			// Create the database from scratch
-			void createDatabase(void) const;
-			
-			// Database has some fixed SQL strings for
-			//- creating the database
-			//- insert data into the database
-			// This SQL strings will be created here
-			void createSqlStrings(void);
-
-			// Open the SQLITE database
-			void open(void);
-			// Close the SQLITE database
-			void close(void);
-			
-			// all field/column/attribute names and types
-			EhzSystemColumnNameAndType ehzSystemColumnNameAndType;
-			
-			// Database name. Given in constructor
-			//lint -e{1725}
-			const std::string ehzDatabaseName;
-			// The handle to the open SQLITE database
-			sqlite3 *dbHandle;
-			
-			// For all of the given time periods that we want to use,
-			// we store the last "time" when the period occurred
-			// This is the initial setting of the values
-			void initializeLastPeriodValues(void);
-			// And this are the last periods values themselves
-			std::vector<DatabaseInternal::EhzLogTimeUnit> lastPeriodValue;
-			
-			// String with the SQL statement for inserting a new record
-			std::string insertMdl;
-			
-			// String with the ddl. The data definition language.
-			std::string ddl;
-			
-			// Handle to SQLITE prepared insert statement
-			sqlite3_stmt *insertStmt;
-			
-		private: 
-		
-			// Default constructor must not be used
-			//lint -e{1704}
-			EhzDataBase(void);
-			
-	};
-}
-
- 
-
-
-#endif
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+//
+// General Description
+//
+// This is a part of a systems that reads data from electronic meters.
+// 
+// This data will be stored in a sqlite database.
+// So we inplement a data logger here.
+//
+// Some requirements
+//
+// We want to store measured values from the EHZ into a database
+// The data can be retrieved from the database to show historical values
+// The time of the measured values is important
+// Measured values shall be stored at fixed intervals. This we call Base interval
+// The base interval is x s
+// It shall be possible to retrieve values for multiples of the base interval
+// The folowing periodes shall be used: 30s, 1min, 5min, 10min, 30min, 1h, 2h, 6h, 12h, 1day, 1week. 1 month, 1 year
+// The database shall be created based on the EHZ configuration
+//
+// So as per definition of the EHZ System we will create the necessary fields in the database.
+// At program start it will be checked, if the database exists. If not, it will be created.
+// The names of the fields, the number of the fields and all associated data will be derived from the
+// EHZ configuration.
+// 
+// To make evaluation of the data easier and to avoid slow queries, we do not only store a timestamp
+// per record. Additionally we will store a flag to indicate that a multiple of the timestamp was hit.
+// With that queries like, give me all values for periods of 5 minutes easier.
+//
+#ifndef DATABASE_HPP
+#define DATABASE_HPP
+
+#include "ehzmeasureddata.hpp"
+
+#include "sqlite3.h"
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <utility>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General definitions
+
+	namespace DatabaseInternal
+	{
+		// The name of the database. At the moment hardcoded.
+		const char EhzDatabaseName[] = ROOT_DIRECTORY "/ehz.db";
+		
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 1.1 Helper structs for the defintion of SQLITE 3 names for columns and types
+			
+		// -----------------------------------------------------------------------------------------------------------
+		// 1.1.1 General struct that can hold the name of the any field/column/attribute and its type in SQLITE terms.
+		struct ColumnNameAndType
+		{
+			public:
+				// Main constructor. Simply copy name and type into this structure
+				explicit ColumnNameAndType(const std::string &cn, const std::string &ct) : columnName(cn), columnType(ct) {}
+				// Default constructor will create empty Strings
+				ColumnNameAndType(void) : columnName(), columnType() {}
+				// No specific destructor needed. The destructor of the struct members will be called
+				virtual ~ColumnNameAndType(void){}
+				
+				// Data member for field/column/attribute
+				std::string columnName;
+				// Data member for type
+				std::string columnType;
+				
+				// For reuse and initialization of this struct, we want to clear (set to empty) the names
+				void clear(void) { columnName.clear(); columnType.clear(); }
+		};
+
+		
+		// -----------------------------------------------------------------------------------------------------------
+		// 1.1.2 EHZ specific struct that can hold the name of the field/column/attribute and its type in SQLITE terms.
+		// We will store aquisition time and all measured values and units for a EHZ
+		struct EhzColumnNameAndType
+		{		
+			// Default consrtuctor. Set all values to default (empty, null)
+			EhzColumnNameAndType(void);
+			// No specific destructor needed. The destructor of the struct members will be called
+			virtual ~EhzColumnNameAndType(void) {}
+			
+			// Sub struct for EHZ measured values 
+			struct MeasuredValueAndUnit
+			{
+				// Default construct. Initalize everything to standard.
+				MeasuredValueAndUnit(void) : measuredValue(), unit() {}
+				// No specific destructor needed. The destructor of the struct members will be called
+				virtual ~MeasuredValueAndUnit(void) {}
+				// Name and Type strings for the measured numerical (text) value
+				ColumnNameAndType measuredValue;
+				// Name and Type strings for the unit of the measured numerical (text) value
+				ColumnNameAndType unit;
+				// For reuse and initialization of this struct, we want to clear (set to empty) the names
+				void clear(void) { measuredValue.clear(); unit.clear();}
+			};
+			// Name and Type strings for the aquisition time of measured values
+			ColumnNameAndType acquisitionTime;
+			// One EHZ may have many measured values. All will be stroed in this vector
+			std::vector<MeasuredValueAndUnit> measuredValueAndUnit;
+			// For reuse and initialization of this struct, we want to clear (set to empty) the names
+			void clear(void) { acquisitionTime.clear(); measuredValueAndUnit.clear(); }
+		};
+
+		// -----------------------------------------------------------------------------------------
+		// 1.1.3 Definition of acquisition time multipliers
+		// As described above we will store additional flage for special acquisition time periods
+		// to make queries simpler
+		// Here we define all periods that will be stored via a flag
+		typedef time_t EhzLogTimeUnit;
+		const EhzLogTimeUnit EhzLogPeriodInS[] = 
+		{
+			30L,
+			60L,
+			300L,
+			600L,
+			1800L,
+			3600L,
+			7200L,
+			21600L,
+			43200L,
+			604800L,
+			2628000L
+		};
+		// Number of periods
+		const uint EhzLogPeriodCount = sizeof(EhzLogPeriodInS) / sizeof(EhzLogPeriodInS[0]);
+
+		// -------------------------------------------------------------------------------------------------------------------
+		// 1.1.4 EHZ SYSTEM specific struct that can hold the name of the field/column/attribute and its type in SQLITE terms.
+		struct EhzSystemColumnNameAndType
+		{
+			// Default consrtuctor. Set all values to default (empty, null)
+			EhzSystemColumnNameAndType(void);
+			// No specific destructor needed. The destructor of the struct members will be called
+			~EhzSystemColumnNameAndType(void) {}
+			
+			// Base time. The time when all data from all EHZ will be stored in one shot
+			const ColumnNameAndType timeBase;
+			// All multiples of periods (see above)
+			std::vector<ColumnNameAndType> ehzTimePeriodNameAndType;
+			// An all names and types for all EHZ that are in the EHZ system
+			std::vector<EhzColumnNameAndType> ehzColumnNameAndType;
+			
+			void buildEhzSystemColumnNameAndType(void);
+		};
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 1.2 Write behind and journaling
+	
+		// Records are not written one by one. They are collected in memory and written in one transaction,
+		// if either the maximum number of records is reached or the oldest record is too old.
+		// Default: 30 records (5 minutes with a 10s timer)
+		const uint WriteBehindMaxNumberOfRecords = 30U;
+		const EhzLogTimeUnit WriteBehindMaxAgeInS = 300L;
+		
+		// The database runs in WAL mode. With synchronous NORMAL there is an fsync only on checkpoints
+		const char EhzDatabaseSynchronousMode[] = "NORMAL";
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 1.3 Storage schema
+	
+		// Wide: One row per record with columns for all values and all units of all EHZ. This is the original schema.
+		// Narrow: One row per value (time, meter, value id, value). Names and units are stored once in a dictionary table.
+		//         Primary key and index is (meter, value id, time). New meters or values need no new columns.
+		//         An existing database with the wide schema will be migrated, when the narrow tables are empty
+		struct DatabaseSchema
+		{
+			enum Type
+			{
+				Wide,
+				Narrow
+			};
+		};
+		const DatabaseSchema::Type EhzDatabaseSchema = DatabaseSchema::Wide;
+		
+		// In the narrow schema, the acquisition time of an EHZ is stored as value with this id. The id is stored
+		// in the database. So it is a fixed reserved number and does not depend on the number of measured values
+		const uint AcquisitionTimeValueId = 1000U;
+		//lint -e{751,761}
+		typedef char AcquisitionTimeValueIdCheck[(AcquisitionTimeValueId >= NumberOfEhzMeasuredData) ? 1 : -1];
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 1.4 Roll-up tables and retention
+	
+		// For each period in EhzLogPeriodInS there is a roll-up table. For every numerical value it holds
+		// minimum, maximum, average and last value per bucket (one bucket is one period).
+		// The buckets are aligned to the UTC epoch time, not to the local time. A bucket of 12 hours starts at 00:00 or 12:00 UTC,
+		// a bucket of one week on Thursday 00:00 UTC. The "month" of 2628000 s does not follow the calendar
+		// The roll-ups are updated with each insert. So long range queries need no scan of the raw data
+		
+		// Raw data older than this will be deleted. 0: Keep raw data forever
+		const EhzLogTimeUnit RawDataRetentionInS = 0L;
+		// Expired raw data is not deleted with every insert, but only once in this interval
+		const EhzLogTimeUnit RetentionCheckIntervalInS = 3600L;
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 1.5 Database writer thread
+	
+		// Number of snapshots that can wait for the database writer thread
+		const uint DatabaseWriterQueueSize = 16U;
+		
+		// What to do, if the database writer thread is too slow and the queue is full
+		struct OverflowPolicy
+		{
+			enum Type
+			{
+				DropOldest,		// Throw away the oldest snapshot in the queue
+				Coalesce		// Keep only the newest snapshot and queue it, when there is room again
+			};
+		};
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 1.6 Queries for time ranges
+	
+		// One row of a query result. For raw data minimum, maximum, average and last are the same value
+		struct HistoryRow
+		{
+			HistoryRow(void) : time(null<EhzLogTimeUnit>()), minimum(0.0), maximum(0.0), average(0.0), last(0.0) {}
+			EhzLogTimeUnit time;
+			mdouble minimum;
+			mdouble maximum;
+			mdouble average;
+			mdouble last;
+		};
+		
+		// Queries run in the callback of a reactor. One call reads only a window of the time range with at most so many rows
+		const uint HistoryQueryMaxScannedRows = 4096U;
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 1.7 Online backup
+	
+		// The database is copied with the SQLITE backup API on the connection of the writer. Each step copies only a few pages
+		// between the inserts. Pages that the writer changes are updated in the copy by SQLITE, because it is the same connection.
+		// The copy is written to a temporary file and renamed, when it is complete
+		const char EhzDatabaseBackupName[] = ROOT_DIRECTORY "/ehz-backup.db";
+		
+		// One backup per interval. The offset shifts the start, e.g. into the night (UTC)
+		const EhzLogTimeUnit DatabaseBackupIntervalInS = 86400L;
+		const EhzLogTimeUnit DatabaseBackupOffsetInS = 7200L;
+		// A backup step every period. The pages per step are limited by the I/O budget
+		const u32 DatabaseBackupStepPeriodInMs = 100UL;
+		const u32 DatabaseBackupBudgetInBytesPerS = 4194304UL;		// 4MB/s
+
+
+		
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. The database
+	
+	// Functionality to store data acquired from all EHZ in a database
+	class EhzDataBase
+	{
+		public:
+			// Constructor creates (if necessary) and opens the database
+			explicit EhzDataBase(const std::string &ehzDatabaseNamel, const DatabaseSchema::Type databaseSchemal = EhzDatabaseSchema);
+			// Close database
+			virtual ~EhzDataBase(void);
+			
+			// Store the measured values and times in the database
+			// The values are queued and written later (write behind)
+			void storeMeasuredValues(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz);
+			// Same, but with the time, when the values have been taken
+			void storeMeasuredValues(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz, const EhzLogTimeUnit timeOfValues);
+			
+			// Write all queued records in one transaction. If that fails, they stay in the queue and are written with the next flush
+			void flush(void);
+			
+			// Set the limits for the write behind queue. A maximum of 1 record switches write behind off
+			void setWriteBehind(const uint maxNumberOfRecords, const EhzLogTimeUnit maxAgeInS);
+			// Set the SQLITE synchronous mode: OFF, NORMAL or FULL
+			void setSynchronousMode(const std::string &synchronousMode);
+			// Set the time after which raw data will be deleted. Roll-ups are kept. 0: Keep forever
+			void setRawDataRetention(const EhzLogTimeUnit retentionInS) { rawDataRetentionInS = retentionInS; }
+			// Set the I/O budget for backups. With one step every stepPeriodInMs
+			void setBackupBudget(const u32 bytesPerSecond, const u32 stepPeriodInMs) { backupBudgetInBytesPerS = bytesPerSecond; backupStepPeriodInMs = stepPeriodInMs; }
+			
+			// Online backup. Start copying the database into the given file. A running backup is continued
+			void startBackup(const std::string &backupNamel);
+			// Copy the next pages. Returns false, if there is no backup (any longer)
+			boolean stepBackup(void);
+			boolean isBackupRunning(void) const { return (null<sqlite3_backup *>() != backup); }
+			
+		protected:
+			// One record waiting in the write behind queue
+			struct QueuedRecord
+			{
+				// Default constructor. Measured values for all EHZ of the configuration
+				QueuedRecord(void);
+				virtual ~QueuedRecord(void) {}
+				
+				// Time stamp of the record and the primary key
+				EhzLogTimeUnit timeBase;
+				// One bit for each period in EhzLogPeriodInS. Evaluated when the record was queued
+				u32 periodFlags;
+				// Copy of the measured values
+				AllMeasuredValuesForAllEhz allMeasuredValuesForAllEhz;
+				// For each EHZ one bit per measured value that changed beyond its deadband (see ChangeDetection)
+				std::vector<u32> reportedValues;
+				// False, if nothing changed and no period flag is set. Then only the roll-ups are updated
+				boolean isStored;
+			};
+			
+			// Aggregated values of one numerical measured value in one bucket
+			struct RollUpValue
+			{
+				RollUpValue(void) : numberOfSamples(null<u64>()), minimum(0.0), maximum(0.0), sum(0.0), last(0.0) {}
+				virtual ~RollUpValue(void) {}
+				// Only samples of an EHZ, that has already delivered values, are counted. 0: The columns are NULL
+				u64 numberOfSamples;
+				mdouble minimum;
+				mdouble maximum;
+				mdouble sum;		// Average is sum / numberOfSamples
+				mdouble last;
+			};
+			// The actual bucket of one roll-up table
+			struct RollUp
+			{
+				RollUp(void) : bucketStart(null<EhzLogTimeUnit>()), numberOfSamples(null<u64>()), rollUpValue() {}
+				virtual ~RollUp(void) {}
+				EhzLogTimeUnit bucketStart;			// Start time of the bucket. Multiple of the period. 0: Not yet known
+				u64 numberOfSamples;
+				std::vector<RollUpValue> rollUpValue;
+			};
+			
+			// Bind the values of one queued record to the insert statement and execute it
+			void insertRecord(const QueuedRecord &queuedRecord);
+			// Narrow schema: Insert one row per value and keep the dictionary up to date
+			void insertSamples(const QueuedRecord &queuedRecord);
+			// Narrow schema: Copy all data from a database with the wide schema
+			void migrateFromWideSchema(void);
+			// Check if a table exists and has at least one row
+			boolean hasRows(const mchar *const tableName) const;
+			// The database could not be written for a long time and the queue is full. Give up the oldest records
+			void dropOldestQueuedRecords(const uint numberOfRecords);
+			// Add the values of one record to the actual buckets of all roll-up tables and write them
+			void updateRollUps(const QueuedRecord &queuedRecord);
+			// After a restart, the actual bucket may already be in the database. Continue with it
+			void loadRollUp(const uint period);
+			// Delete raw data that is older than the retention time
+			void deleteExpiredRawData(const EhzLogTimeUnit nowTime);
+			// Create missing roll-up tables and prepare the statements for them
+			void prepareRollUps(void);
+			// Add the columns, that a table of an older version or of another configuration does not have
+			void addMissingColumns(const std::string &tableName, const std::vector<ColumnNameAndType> &columns);
+			// Execute an SQL statement without result. Show an error message in case of problems
+			boolean executeSql(const mchar *const sql) const;
+			// Show an error message on the user interface
+			virtual void showErrorMessage(const std::string &errorMessage) const;
+
+			// Check if this database is existing in the specified path
+			boolean isExisting(void) const;
+			// And check, if it is already open
+			boolean isOpen(void)  const  { return (null<sqlite3 *>() != dbHandle);}
+
+			// Create the database from scratch
+			void createDatabase(void) const;
+			
+			// Database has some fixed SQL strings for
+			//- creating the database
+			//- insert data into the database
+			// This SQL strings will be created here
+			void createSqlStrings(void);
+
+			// Open the SQLITE database
+			void open(void);
+			// Close the SQLITE database
+			void close(void);
+			
+			// all field/column/attribute names and types
+			EhzSystemColumnNameAndType ehzSystemColumnNameAndType;
+			
+			// Database name. Given in constructor
+			//lint -e{1725}
+			const std::string ehzDatabaseName;
+			// Wide or narrow. Given in constructor
+			const DatabaseSchema::Type databaseSchema;
+			// Table with one row per record: The time base and the period flags
+			const mchar *const recordTableName;
+			// The handle to the open SQLITE database
+			sqlite3 *dbHandle;
+			
+			// For all of the given time periods that we want to use,
+			// we store the last "time" when the period occurred
+			// This is the initial setting of the values
+			void initializeLastPeriodValues(void);
+			// And this are the last periods values themselves
+			std::vector<DatabaseInternal::EhzLogTimeUnit> lastPeriodValue;
+			// The last period values are also kept in a small table. Write the ones with a set flag
+			void writeLastPeriodValues(const u32 periodFlags);
+			// Handle to SQLITE prepared statement for the last period table
+			sqlite3_stmt *replaceLastPeriodStmt;
+			
+			// String with the SQL statement for inserting a new record
+			std::string insertMdl;
+			
+			// String with the ddl. The data definition language.
+			std::string ddl;
+			// The columns of the record table except the primary key. Missing columns are added to an existing table
+			std::vector<ColumnNameAndType> recordColumns;
+			
+			// Handle to SQLITE prepared insert statement
+			sqlite3_stmt *insertStmt;
+			
+			// Narrow schema: Statements for the values and the dictionary
+			std::string insertSampleMdl;
+			std::string replaceDictionaryMdl;
+			sqlite3_stmt *insertSampleStmt;
+			sqlite3_stmt *replaceDictionaryStmt;
+			// Units as stored in the dictionary. Index: EHZ * NumberOfEhzMeasuredData + measured value
+			std::vector<std::string> dictionaryUnit;
+			
+			// Write behind queue. The elements are reused. Only the first numberOfQueuedRecords are valid
+			std::vector<QueuedRecord> writeBehindQueue;
+			uint numberOfQueuedRecords;
+			// Limits for the write behind queue
+			uint writeBehindMaxNumberOfRecords;
+			EhzLogTimeUnit writeBehindMaxAgeInS;
+			// Values that did not change beyond their deadband are not stored. Only with a keyframe interval
+			EhzInternal::ChangeDetection changeDetection;
+			
+			// Roll-ups. The numerical values (index of EHZ and index of measured value) that will be aggregated
+			std::vector<std::pair<uint, uint> > rollUpSource;
+			// One roll-up per period with the SQL strings for creation, writing and reading
+			std::vector<RollUp> rollUp;
+			// The roll-ups as they are in the database. If a transaction fails, the roll-ups in memory are set back
+			std::vector<RollUp> rollUpAtLastCommit;
+			std::vector<std::string> rollUpDdl;
+			std::vector<std::string> rollUpReplaceMdl;
+			std::vector<std::string> rollUpSelectSql;
+			// Name and columns of each roll-up table. Tables of older versions or other configurations miss columns. They are added
+			std::vector<std::string> rollUpTableName;
+			std::vector<std::vector<ColumnNameAndType> > rollUpColumns;
+			std::vector<sqlite3_stmt *> rollUpReplaceStmt;
+			
+			// Retention of raw data
+			EhzLogTimeUnit rawDataRetentionInS;
+			EhzLogTimeUnit lastRetentionCheck;
+			
+			// Page size of the database. For the pages per backup step
+			sint getPageSize(void) const;
+			// End the backup. The temporary file is renamed, if the backup is complete, else removed
+			void finishBackup(const boolean isComplete);
+			// Online backup into a temporary file with its own connection
+			std::string backupName;
+			sqlite3 *backupDbHandle;
+			sqlite3_backup *backup;
+			sint backupPagesPerStep;
+			u32 backupBudgetInBytesPerS;
+			u32 backupStepPeriodInMs;
+			
+		private: 
+		
+			// Default constructor must not be used
+			//lint -e{1704}
+			EhzDataBase(void);
+			
+	};
+	
+	
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. The database with an own writer thread
+	
+	// SQLITE may need a long time for writing, especially during checkpoints. This must not delay the event loop.
+	// So the database is accessed by an own thread. The event loop pushes snapshots of the measured values into a
+	// single producer / single consumer ring. The ring does not use locks. The producer never waits for the database.
+	//
+	// The indices are free running. A snapshot is taken by the consumer with a compare and swap on the tail.
+	// With the policy DropOldest, the producer also takes (and throws away) the oldest snapshot this way.
+	// While the consumer copies a snapshot, it tells the producer which one, so that slot will not be overwritten.
+	class EhzDataBaseWriter : public EhzDataBase
+	{
+		public:
+			// Open the database and start the writer thread
+			explicit EhzDataBaseWriter(const std::string &ehzDatabaseNamel, const uint queueSize = DatabaseWriterQueueSize, const OverflowPolicy::Type overflowPolicyl = OverflowPolicy::DropOldest, const DatabaseSchema::Type databaseSchemal = EhzDatabaseSchema);
+			// Write all outstanding snapshots, stop the thread and close the database
+			virtual ~EhzDataBaseWriter(void);
+			
+			// Called by the event loop. Copy the measured values into the queue. Returns false, if a snapshot was lost
+			boolean push(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz);
+			boolean push(const EhzInternal::PublishedMeasuredValues &publishedMeasuredValues);
+			
+			// Number of snapshots that were thrown away or coalesced, because the queue was full
+			u64 getNumberOfLostSnapshots(void) const { return numberOfLostSnapshots; }
+			
+			// Called by the backup timer of the event loop. Starts a backup, when the interval is over, 
+			// and lets the writer thread copy the next pages of a running backup
+			void requestBackupStep(const EhzLogTimeUnit nowTime);
+			// Start a backup with the next step
+			void requestBackup(void) { __atomic_store_n(&backupStartRequested, true, __ATOMIC_SEQ_CST); }
+			
+		protected:
+			// Measured values and the time, when they have been taken
+			struct Snapshot
+			{
+				// Default constructor. Measured values for all EHZ of the configuration
+				Snapshot(void);
+				virtual ~Snapshot(void) {}
+				EhzLogTimeUnit timeOfValues;
+				// Compact form without strings. Cheap to copy into and out of the ring
+				EhzInternal::MeasuredValuesSnapshot measuredValues;
+			};
+			
+			// Thread function and the loop of the writer thread
+			static void *writerThreadFunction(void *ehzDataBaseWriter);
+			void runWriterThread(void);
+			
+			// Producer side. Free the coalesced snapshot buffer for new values. Returns false, if a snapshot was lost
+			boolean prepareCoalescedSnapshot(const EhzLogTimeUnit nowTime);
+			// Producer side. Put a snapshot in the ring. Returns false, if the ring is full and nothing was done
+			boolean putSnapshot(const Snapshot &snapshot);
+			// Consumer side. Copy the oldest snapshot from the ring. Returns false, if the ring is empty
+			boolean takeSnapshot(Snapshot &snapshot);
+			// Consumer side. Start a requested backup and copy the next pages
+			void runBackupStep(void);
+			
+			// Error messages of the writer thread are collected and shown by the event loop
+			virtual void showErrorMessage(const std::string &errorMessage) const;
+			void showDeferredErrorMessages(void);
+			
+			// The ring. Indices are free running and only used modulo the size of the ring
+			std::vector<Snapshot> ring;
+			u64 head;						// Next position to write. Changed by the producer only
+			u64 tail;						// Oldest position, not yet taken. Changed by compare and swap
+			u64 positionBeingCopied;		// Position + 1 of the snapshot, that the consumer copies right now. 0 for none
+			
+			// Overflow handling
+			const OverflowPolicy::Type overflowPolicy;
+			Snapshot coalescedSnapshot;
+			boolean coalescedSnapshotIsPending;
+			u64 numberOfLostSnapshots;
+			
+			// Snapshot that is processed by the writer thread and its values with strings for the database
+			Snapshot snapshotInWriterThread;
+			AllMeasuredValuesForAllEhz valuesInWriterThread;
+			
+			// Thread control
+			pthread_t writerThread;
+			boolean writerThreadIsRunning;
+			sem_t snapshotAvailable;
+			boolean stopRequested;
+			
+			// Backup control. The requests are set by the event loop and taken by the writer thread
+			EhzLogTimeUnit lastBackupInterval;
+			boolean backupStartRequested;
+			boolean backupStepRequested;
+			boolean backupIsRunning;			// Set by the writer thread
+			
+			// Error messages from the writer thread
+			mutable pthread_mutex_t deferredErrorMessagesMutex;
+			mutable std::string deferredErrorMessages;
+			
+		private:
+			// Default constructor must not be used
+			//lint -e{1704}
+			EhzDataBaseWriter(void);
+			// No copies
+			EhzDataBaseWriter(const EhzDataBaseWriter &);
+			EhzDataBaseWriter &operator =(const EhzDataBaseWriter &);
+	};
+	
+	
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. Read only access for queries
+	
+	// Queries use an own read only connection. In WAL mode they do not block the writer and the writer does not block them.
+	// All queries read via the primary key of the time column. Results are limited to a number of rows, the caller
+	// continues with the time after the last row
+	class EhzDataBaseReader
+	{
+		public:
+			// Open the database read only
+			explicit EhzDataBaseReader(const std::string &ehzDatabaseNamel, const DatabaseSchema::Type databaseSchemal = EhzDatabaseSchema);
+			// Close the database
+			virtual ~EhzDataBaseReader(void);
+			
+			// Read at most maxRows rows for one numerical value of one EHZ with a time in [fromTime, toTime].
+			// resolution 0: Raw data. Otherwise: The roll-up with the longest period that is not longer than resolution
+			// One call scans at most HistoryQueryMaxScannedRows rows, beginning with the first row at or after fromTime. So the result
+			// may have less rows, even none, although there are more in the range. nextFromTime is the time, where the next call
+			// continues. After toTime: Nothing more
+			// Returns false, if the value or the table does not exist
+			boolean readRange(const uint meter, const uint valueId, const EhzLogTimeUnit fromTime, const EhzLogTimeUnit toTime, 
+							  const EhzLogTimeUnit resolution, const uint maxRows, std::vector<HistoryRow> &historyRows, EhzLogTimeUnit &nextFromTime);
+			
+			// Check, if the database could be opened
+			boolean isOpen(void)  const  { return (null<sqlite3 *>() != dbHandle);}
+			
+		protected:
+			// Build the query for raw data or a roll-up table
+			std::string buildRangeQuery(const uint meter, const uint valueId, const EhzLogTimeUnit resolution, std::string &seekSql) const;
+			// Index of the roll-up period used for a resolution
+			static uint getRollUpPeriodForResolution(const EhzLogTimeUnit resolution);
+			
+			// Wide or narrow. Given in constructor
+			const DatabaseSchema::Type databaseSchema;
+			// The handle to the open SQLITE database
+			sqlite3 *dbHandle;
+			// Pages of one query use the same statement. It is only prepared again for a different query
+			std::string preparedSql;
+			sqlite3_stmt *rangeStmt;
+			// Time of the first row of a page. Belongs to the range statement
+			sqlite3_stmt *seekStmt;
+			
+		private:
+			// Default constructor must not be used
+			//lint -e{1704}
+			EhzDataBaseReader(void);
+			// No copies
+			EhzDataBaseReader(const EhzDataBaseReader &);
+			EhzDataBaseReader &operator =(const EhzDataBaseReader &);
+	};
+}
+
+ 
+
+
+#endif
@@ -42,6 +42,11 @@
 // A timer is used for cyclic storage of data records.
 // Other interested parties are informed as well abaout the availability of new datasets
 // via a publisher subscriber mechanism.
+//
+// Normally the main reactor reads and parses the data of all EHZ. An EHZ may be moved into a worker
+// thread instead. The worker thread has its own reactor. It owns the serial port, the parser and the
+// evaluation of the EHZ. Complete values are handed over to the main reactor through a lock free ring
+// of buffers in the EHZ. The main reactor publishes them, as if it had parsed them itself.
 // 
 
 #ifndef EHZ_HPP
@@ -52,13 +57,25 @@
 #include "serial.hpp"
 #include "timerevent.hpp"
 #include "database.hpp"
+#include "historian.hpp"
+#include "snapshotsegment.hpp"
+#include "aggregate.hpp"
 #include "parsetreevisitor.hpp"
 #include "ehzconfig.hpp"
+#include "metrics.hpp"
+#include "reactor.hpp"
 
 
 namespace EhzInternal
 {
 	const std::string StrEmpty;
+	// The results of the Ehz are shown on the terminal with this period. Not with every SML File
+	const u32 DefaultRenderPeriodInMs = 500UL;
+	// Buffers for the measured values of one Ehz: One is published, one is parsed into. The others wait for the main reactor
+	const uint NumberOfMeasuredValuesBuffers = 4U;
+	
+	// See below
+	class EhzWorkerNotification;
 	
 	
 // ------------------------------------------------------------------------------------------------------------------------------
@@ -85,24 +102,45 @@ namespace EhzInternal
 			virtual void update(SerialInternal::EhzSerialPort *const publisher); 
 
 			// EhzSystem and other functions are interested in the results of the parse activity
-			// This functions gives access to the results
-			const AllMeasuredValuesForOneEhz &getAllMeasuredDataForOneEhz(void) const { return allMeasuredValuesForOneEhz; }    
+			// This functions gives access to the results. They will not change, until the next SML file has been parsed
+			const AllMeasuredValuesForOneEhz &getAllMeasuredDataForOneEhz(void) const { return *__atomic_load_n(&publishedMeasuredValues, __ATOMIC_ACQUIRE); }    
+			// Number of the SML files, that have been evaluated. Changes, when there are new values
+			u64 getGeneration(void) const { return __atomic_load_n(&generation, __ATOMIC_ACQUIRE); }
 			
 			// Get index of this Ehz (index in Ehz system)
 			const uint &getEhzIndex(void) const { return ehzConfigDefinition.index; }
 			
+			// Counters and latencies. Only for the main reactor, because the counters of the parser are taken over
+			const MetricsInternal::EhzMetrics &getEhzMetrics(void);
+			
+			// Number of the worker thread from the configuration. 0 for the main reactor
+			uint getWorker(void) const { return ehzConfigDefinition.EhzWorker; }
+			// Parse in a worker thread. The main reactor is woken up through the notification. Must be set before the start
+			void setWorkerNotification(EhzWorkerNotification *const ehzWorkerNotificationP) { ehzWorkerNotification = ehzWorkerNotificationP; }
+			boolean isParsedInWorkerThread(void) const { return null<EhzWorkerNotification *>() != ehzWorkerNotification; }
+			// Main reactor: Publish the oldest values, that have been handed over, and inform the subscribers. False, if there are none
+			boolean takeMeasuredValues(void);
+			// Subscribe here to values, that are published early while the SML file is parsed
+			ParserInternal::SmlListEntryEvaluation &getSmlListEntryEvaluation(void) { return smlListEntryEvaluation; }
+			// Numbers of the SML files for the early published values
+			// Parsing thread: The SML file, that is parsed now. It will be handed over with this number
+			u64 getReceivingSmlFileNumber(void) const { return numberOfHandedOverMeasuredValues; }
+			// Main reactor: The SML file, whose values are published
+			u64 getPublishedSmlFileNumber(void) const { return numberOfTakenMeasuredValues - 1ULL; }
+			
 		protected:		
 			// The properties of this specific Ehz
 			//lint --e(1725)		class member 'Symbol' is a reference
 			const EhzConfigDefinition &ehzConfigDefinition;  // The specific configuration for this instance of the EHZ
 
 			// The data from the Ehz are read via a serial port. This is the related port for this Ehz
-			SerialInternal::EhzSerialPort ehzSerialPort;
+			// It may be a replay of a capture file as well. Created according to the configuration
+			SerialInternal::EhzSerialPort *ehzSerialPort;
 			
 			
 
-			// After a telegram (a SmlFile) from the Ehz has been received, it will be parsed. Then
-			// the below class will retrieve the data from the parse tree using the visitor pattern
+			// While a telegram (a SmlFile) from the Ehz is parsed, the below class will retrieve the
+			// data from each completed SmlListEntry. It is set as streaming visitor of the parser
 			ParserInternal::SmlListEntryEvaluation smlListEntryEvaluation; 
 
 		
@@ -111,10 +149,34 @@ namespace EhzInternal
 			// each successfully received SmlFile
 			Parser parser;
 			
-			// The measured results contained in the SML File will be stored here. This will
-			// be done by smlListEntryEvaluation
-			// The EhzSystem class will use this data for further processing
-			AllMeasuredValuesForOneEhz allMeasuredValuesForOneEhz;	
+			// Ring of buffers for the measured results. smlListEntryEvaluation writes the values of the SML File
+			// that is currently parsed into one buffer. Another one holds the last published results.
+			// If the complete SML File has been parsed without error, the buffer is handed over and the parser
+			// continues with the next free one. Nothing is copied. The main reactor takes the handed over buffers
+			// in order and publishes them. The EhzSystem class will use the published data for further processing
+			// Single producer, single consumer. The counters are free running. Both start with 1: Buffer 0 is published
+			AllMeasuredValuesForOneEhz measuredValuesBuffer[NumberOfMeasuredValuesBuffers];
+			AllMeasuredValuesForOneEhz *receivingMeasuredValues;
+			AllMeasuredValuesForOneEhz *publishedMeasuredValues;
+			u64 generation;
+			u64 numberOfHandedOverMeasuredValues;			// Changed by the parsing thread only
+			u64 numberOfTakenMeasuredValues;				// Changed by the main reactor only
+			// Start of the latency for the values in the buffer with the same index
+			u64 handOverTimeInNs[NumberOfMeasuredValuesBuffers];
+			// Null, if the main reactor parses. Then the values are taken at once
+			EhzWorkerNotification *ehzWorkerNotification;
+			
+			// Positions in a received data block where the parser finished
+			ParserBoundaryList parserBoundaryList;
+			
+			MetricsInternal::EhzMetrics ehzMetrics;
+			// Arrival of the bytes, that are just parsed. Start of the latency until the values are published
+			u64 updateStartTimeInNs;
+			
+			// Act on the result of the parser: Evaluate parse tree or show error
+			void evaluateParserResult(const prCode parserResult);
+			// Parsing thread: Hand over the values of a complete SML File and continue with the next free buffer
+			void handOverMeasuredValues(void);
 			
 		private:
 			// Hidden default constructor. Must not be used
@@ -122,24 +184,88 @@ namespace EhzInternal
 			Ehz(void) : Publisher<Ehz>(), 
 						Subscriber<SerialInternal::EhzSerialPort>(),
 						ehzConfigDefinition(EhzInternal::ehzConfigDefinitionNULL), 
-						ehzSerialPort(StrEmpty), 
+						ehzSerialPort(new SerialInternal::EhzSerialPort(StrEmpty)), 
 						smlListEntryEvaluation(EhzInternal::ehzConfigDefinitionNULL,&emdaDummy), 
 						parser(), 
-						allMeasuredValuesForOneEhz()    {}
+						measuredValuesBuffer(),
+						receivingMeasuredValues(&measuredValuesBuffer[1]),
+						publishedMeasuredValues(&measuredValuesBuffer[0]),
+						generation(null<u64>()),
+						numberOfHandedOverMeasuredValues(1ULL),
+						numberOfTakenMeasuredValues(1ULL),
+						handOverTimeInNs(),
+						ehzWorkerNotification(null<EhzWorkerNotification *>()),
+						parserBoundaryList(),
+						ehzMetrics(),
+						updateStartTimeInNs(null<u64>())    {}
 		
 	};
 
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Worker threads
+
+	// An Ehz in a worker thread has handed over values. The first one after a wake up writes the eventfd
+	// The event handler is registered with the main reactor. It informs the EhzSystem, which takes the values
+	class EhzWorkerNotification : public EventHandlerBasic,
+								  public Publisher<EhzWorkerNotification>
+	{
+		public:
+			EhzWorkerNotification(void);
+			virtual ~EhzWorkerNotification(void);
+			
+			// Any worker thread. Never blocks
+			void requestWakeUp(void);
+			// Main reactor
+			virtual EventProcessing::Action handleEvent(const EventType et);
+			
+		protected:
+			boolean wakeUpIsRequested;
+		private:
+			// No copies
+			EhzWorkerNotification(const EhzWorkerNotification &);
+			EhzWorkerNotification &operator =(const EhzWorkerNotification &);
+	};
+	
+	// A reactor thread for one or more Ehz. They are started and stopped in the thread
+	// So their serial ports are registered with the reactor of the thread
+	class EhzWorkerThread : public ReactorInternal::ReactorThread
+	{
+		public:
+			explicit EhzWorkerThread(const uint reactorIndexP) : ReactorInternal::ReactorThread(reactorIndexP), vehz() {}
+			virtual ~EhzWorkerThread(void) {}
+			
+			// Only before the start of the thread
+			void addEhz(Ehz *const ehz) { vehz.push_back(ehz); }
+			
+		protected:
+			// Start all Ehz. Open the serial ports and register them
+			virtual void initialize(void);
+			// Stop all Ehz
+			virtual void finalize(void);
+			
+			std::vector<Ehz *> vehz;
+		private:
+			// No copies
+			EhzWorkerThread(const EhzWorkerThread &);
+			EhzWorkerThread &operator =(const EhzWorkerThread &);
+	};
+
 } // end of namespace	
 
 
 // ------------------------------------------------------------------------------------------------------------------------------
-// 2. Definition of the EHZ System. A container of one or more EHZ
+// 3. Definition of the EHZ System. A container of one or more EHZ
 
 
 
 
+// The EhzSystem informs its subscribers about new values of one Ehz
 class EhzSystem : 	public Subscriber<EhzInternal::Ehz>,
-					public Subscriber<EventTimer>
+					public Subscriber<EventTimer>,
+					public Subscriber<EhzInternal::EhzWorkerNotification>,
+					public Subscriber<ParserInternal::SmlListEntryEvaluation>,
+					public Publisher<EhzSystem>
 {
 		const std::vector<EhzConfigDefinition> vecEhzConfigDefinitionNULL;
 
@@ -169,13 +295,41 @@ class EhzSystem : 	public Subscriber<EhzInternal::Ehz>,
 		virtual void update(EhzInternal::Ehz *const publisher);
 		//lint --e(955)
 		virtual void update(EventTimer *const);
+		// Worker threads have handed over values. Take them from all Ehz in worker threads
+		//lint --e(1735)
+		virtual void update(EhzInternal::EhzWorkerNotification *const);
+		// A value for early publication has been parsed, or the SML file with such values was invalid
+		// Called in the thread that parses the Ehz
+		//lint --e(1735)
+		virtual void update(ParserInternal::SmlListEntryEvaluation *const publisher);
 
 		
 		// Check if the EhzSystem was initialized and contains plausible data
 		boolean isInitialized(void) const;
 		
 		
-		const AllMeasuredValuesForAllEhz &getEhzSystemResult(void) const { return allMeasuredValuesForAllEhz; }
+		const EhzInternal::PublishedMeasuredValues &getEhzSystemResult(void) const { return publishedMeasuredValues; }
+		// The historian, if it is active. Else null
+		const HistorianInternal::EhzHistorian *getHistorian(void) const { return ehzHistorian; }
+		// Minimum, maximum and average over sliding windows. May be read in any thread
+		const AggregateInternal::EhzWindowAggregates &getWindowAggregates(void) const { return windowAggregates; }
+		// Values that are published before their SML file is complete. May be read in any thread
+		const EhzInternal::ProvisionalMeasuredValues &getProvisionalMeasuredValues(void) const { return provisionalMeasuredValues; }
+		// The index of the Ehz with new values. Valid during the notification of subscribers
+		uint getLastUpdatedEhzIndex(void) const { return lastUpdatedEhzIndex; }
+		// True, if the last update is a keyframe. Then subscribers shall send all values of this Ehz
+		boolean isLastUpdateKeyframe(void) const { return lastUpdateIsKeyframe; }
+		
+		// Readers in other threads, like the reactor threads of the TCP servers, need versions of the values
+		// Must be enabled before these threads start. The first version are the current values
+		void enableVersionedMeasuredValues(void) { versionedMeasuredValuesAreUsed = true; versionedMeasuredValues.store(publishedMeasuredValues); }
+		const EhzInternal::VersionedMeasuredValues &getVersionedMeasuredValues(void) const { return versionedMeasuredValues; }
+		
+		// Period for redrawing the values on the terminal. Takes effect with the next start
+		void setRenderPeriod(const u32 renderPeriodInMs) { renderTimer.setTimerValues(renderPeriodInMs); }
+		
+		// Metrics of one Ehz. Only for the main reactor
+		const MetricsInternal::EhzMetrics &getEhzMetrics(const uint ehzIndex) { return vehz[ehzIndex]->getEhzMetrics(); }
 		
 		friend std::ostream& operator<< (std::ostream &out, const EhzSystem &ehzSystemP);
 
@@ -183,9 +337,12 @@ class EhzSystem : 	public Subscriber<EhzInternal::Ehz>,
 		
 	protected:
 	
+		// Show the latest values of one Ehz in its result window
+		void renderMeasuredValues(const uint ehzIndex);
+	
 		// The final result
-		// Container for Measured values
-		AllMeasuredValuesForAllEhz allMeasuredValuesForAllEhz;	
+		// Pointers to the latest measured values of all Ehz. Nothing is copied
+		EhzInternal::PublishedMeasuredValues publishedMeasuredValues;	
 	
         // The configuration of the EhzSystem. Defines, how many Ehz are in the System
 		// and especially their properties. The Configuration is a global constant
@@ -200,7 +357,34 @@ class EhzSystem : 	public Subscriber<EhzInternal::Ehz>,
 		std::vector<EhzInternal::Ehz *> vehz;
 		
 		EventTimer ehzSystemTimer;
-		DatabaseInternal::EhzDataBase *ehzDataBase;
+		DatabaseInternal::EhzDataBaseWriter *ehzDataBase;
+		// Drives the online backup of the database in small steps
+		EventTimer backupTimer;
+		// Optional append only storage of every new value. Null, if not active
+		HistorianInternal::EhzHistorian *ehzHistorian;
+		// The latest published values in shared memory for local readers. Null, if not active
+		SnapshotSegmentInternal::SnapshotSegmentWriter *snapshotSegmentWriter;
+		// Sliding window aggregates of all numerical values. Updated with every new set of values
+		AggregateInternal::EhzWindowAggregates windowAggregates;
+		// Early published values, until the checksum of their SML file is verified
+		EhzInternal::ProvisionalMeasuredValues provisionalMeasuredValues;
+		// For subscribers: The Ehz that has just published new values
+		uint lastUpdatedEhzIndex;
+		boolean lastUpdateIsKeyframe;
+		// Values that did not change beyond their deadband are not published
+		EhzInternal::ChangeDetection changeDetection;
+		// A copy of the published values for other threads. Only stored, if someone needs it
+		EhzInternal::VersionedMeasuredValues versionedMeasuredValues;
+		boolean versionedMeasuredValuesAreUsed;
+		// Result windows are redrawn by this timer, if they have new values
+		EventTimer renderTimer;
+		std::vector<boolean> resultWindowIsDirty;
+		// Ehz with a worker number in the configuration are parsed in these threads. Empty, if there is none
+		std::vector<EhzInternal::EhzWorkerThread *> ehzWorkerThreads;
+		EhzInternal::EhzWorkerNotification ehzWorkerNotification;
+		
+		// Distribute the Ehz over the worker threads according to their configuration
+		void createWorkerThreads(void);
         
 	private:
 
@@ -208,24 +392,58 @@ class EhzSystem : 	public Subscriber<EhzInternal::Ehz>,
 		//lint --e(1704)
 		EhzSystem(void) : 	Subscriber<EhzInternal::Ehz>(), 
 							Subscriber<EventTimer>(),
+							Subscriber<EhzInternal::EhzWorkerNotification>(),
+							Subscriber<ParserInternal::SmlListEntryEvaluation>(),
+							Publisher<EhzSystem>(),
 							vecEhzConfigDefinitionNULL(),
-							allMeasuredValuesForAllEhz(),
+							publishedMeasuredValues(),
 							vehzConfigDefinition(vecEhzConfigDefinitionNULL), 
 							vehz(), 
 							ehzSystemTimer(null<u32>()),
-							ehzDataBase(null<DatabaseInternal::EhzDataBase *>()) 
+							ehzDataBase(null<DatabaseInternal::EhzDataBaseWriter *>()),
+							backupTimer(null<u32>()),
+							ehzHistorian(null<HistorianInternal::EhzHistorian *>()),
+							snapshotSegmentWriter(null<SnapshotSegmentInternal::SnapshotSegmentWriter *>()),
+							windowAggregates(),
+							provisionalMeasuredValues(),
+							lastUpdatedEhzIndex(null<uint>()),
+							lastUpdateIsKeyframe(false),
+							changeDetection(),
+							versionedMeasuredValues(),
+							versionedMeasuredValuesAreUsed(false),
+							renderTimer(null<u32>()),
+							resultWindowIsDirty(),
+							ehzWorkerThreads(),
+							ehzWorkerNotification()
 		{  }
 		
 		// Hidden copy constructor
 		//lint --e(1529) --e(1704) --e(1738)
 		EhzSystem(const EhzSystem &) :  Subscriber<EhzInternal::Ehz>(), 
 										Subscriber<EventTimer>(),
+										Subscriber<EhzInternal::EhzWorkerNotification>(),
+										Subscriber<ParserInternal::SmlListEntryEvaluation>(),
+										Publisher<EhzSystem>(),
 										vecEhzConfigDefinitionNULL(),
-										allMeasuredValuesForAllEhz(),
+										publishedMeasuredValues(),
 										vehzConfigDefinition(vecEhzConfigDefinitionNULL), 
 										vehz(),
 										ehzSystemTimer(null<u32>()), 
-										ehzDataBase(null<DatabaseInternal::EhzDataBase *>())
+										ehzDataBase(null<DatabaseInternal::EhzDataBaseWriter *>()),
+										backupTimer(null<u32>()),
+										ehzHistorian(null<HistorianInternal::EhzHistorian *>()),
+										snapshotSegmentWriter(null<SnapshotSegmentInternal::SnapshotSegmentWriter *>()),
+										windowAggregates(),
+										provisionalMeasuredValues(),
+										lastUpdatedEhzIndex(null<uint>()),
+										lastUpdateIsKeyframe(false),
+										changeDetection(),
+										versionedMeasuredValues(),
+										versionedMeasuredValuesAreUsed(false),
+										renderTimer(null<u32>()),
+										resultWindowIsDirty(),
+										ehzWorkerThreads(),
+										ehzWorkerNotification()
 		{ }
 		
 		// Hidden assignment operator
@@ -43,13 +43,19 @@
 // - The Linux device name of the serial port to which the EHZ is connected
 // - What values from an EHZ shall be processed. Name and type
 //
-// The whole data is defined as a constant
+// The whole data is defined as a constant. It is the built-in default
+// A site specific configuration can be loaded from a file at program start. See section 3
 //
 
 #ifndef EHZ_CONFIG_HPP
 #define EHZ_CONFIG_HPP
 
 #include "mytypes.hpp"
+#include "singleton.hpp"
+
+#include <list>
+#include <string>
+#include <vector>
  
  
 
@@ -83,7 +89,8 @@
 		};
 		//lint -e{935}	
 		// Index of Ehz in Ehz System. Must be a number 0..(Max-1), no double values
-		const uint index;
+		// The members are not const, so that definitions can be filled when reading a configuration file
+		uint index;
 		// Name of the EHZ, whatever we like								
 		const mchar *EhzName;
 		
@@ -93,7 +100,41 @@
 		// Definitions for data values
 		EhzDataValueDefinition ehzDataValueDefinition[NumberOfEhzMeasuredData];			
 		// Type of data value
-		const EhzMeasuredDataType::Type ehzMeasuredDataType[NumberOfEhzMeasuredData];	
+		EhzMeasuredDataType::Type ehzMeasuredDataType[NumberOfEhzMeasuredData];	
+		// Changes of a number up to this amount are not reported. 0: Every change is reported
+		mdouble ehzDeadband[NumberOfEhzMeasuredData];
+		// 0: Every value is stored and published. N: Only changed values, but all values again after N seconds (keyframe)
+		u32 EhzKeyframeIntervalInS;
+		// One bit (1UL << slot) for each value, that is published provisionally as soon as its list entry is parsed. 0: None
+		u32 EhzEarlyPublication;
+		// Skip mode of the parser. List entries of values, that are not configured, and unknown messages are skipped
+		boolean EhzSkipMode;
+		
+		// If not empty, all raw data from the serial port are recorded in this capture file
+		const mchar *EhzCaptureFileName;
+		// If not empty, the data are replayed from this capture file instead of being read from the serial port
+		const mchar *EhzReplayFileName;
+		// Replay speed: 1 is real time, N is N times faster, 0 is as fast as possible
+		u32 EhzReplaySpeed;
+		// 0: The main reactor reads and parses the data. N: Worker thread N does it. Ehz with the same N share the thread
+		uint EhzWorker;
+		// If not empty, the data are received via TCP from this host and port instead of the serial port
+		const mchar *EhzNetworkHost;
+		const mchar *EhzNetworkPort;
+		// 0: Standard profile of the serial port. N: Low latency profile. A frame ends, when the line is idle for N ms
+		u32 EhzFrameGapInMs;
+		
+		// Not all of the NumberOfEhzMeasuredData values need to be defined. Missing definitions are Null.
+		// Get the number of values up to and including the last defined one
+		uint getNumberOfUsedEhzMeasuredData(void) const
+		{
+			uint numberOfUsedEhzMeasuredData = NumberOfEhzMeasuredData;
+			while ((numberOfUsedEhzMeasuredData > 0U) && (EhzMeasuredDataType::Null == ehzMeasuredDataType[numberOfUsedEhzMeasuredData - 1U]))
+			{
+				--numberOfUsedEhzMeasuredData;
+			}
+			return numberOfUsedEhzMeasuredData;
+		}
 	};
 
 
@@ -152,7 +193,18 @@
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Null
-				}
+				},
+				{ 0.0 },			// No deadbands
+				0U,					// No change detection
+				0U,					// No early publication
+				false,					// No skip mode
+				"",					// No capture file
+				"",					// No replay. Read the serial port
+				1U,					// Replay speed
+				0U,					// Parsed by the main reactor
+				"",					// Not connected via the network
+				"",					// No network port
+				0U					// Standard serial port profile
 			},
 			
 			{
@@ -182,7 +234,18 @@
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Number
-				}
+				},
+				{ 0.0 },			// No deadbands
+				0U,					// No change detection
+				0U,					// No early publication
+				false,					// No skip mode
+				"",					// No capture file
+				"",					// No replay. Read the serial port
+				1U,					// Replay speed
+				0U,					// Parsed by the main reactor
+				"",					// Not connected via the network
+				"",					// No network port
+				0U					// Standard serial port profile
 			},
 				{
 				2U,
@@ -212,7 +275,18 @@
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Null
-				}
+				},
+				{ 0.0 },			// No deadbands
+				0U,					// No change detection
+				0U,					// No early publication
+				false,					// No skip mode
+				"",					// No capture file
+				"",					// No replay. Read the serial port
+				1U,					// Replay speed
+				0U,					// Parsed by the main reactor
+				"",					// Not connected via the network
+				"",					// No network port
+				0U					// Standard serial port profile
 			},
 
 			{
@@ -242,7 +316,18 @@
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Null
-				}
+				},
+				{ 0.0 },			// No deadbands
+				0U,					// No change detection
+				0U,					// No early publication
+				false,					// No skip mode
+				"",					// No capture file
+				"",					// No replay. Read the serial port
+				1U,					// Replay speed
+				0U,					// Parsed by the main reactor
+				"",					// Not connected via the network
+				"",					// No network port
+				0U					// Standard serial port profile
 			},		{
 				4U,
 				"Allgemein",			// Name of the EHZ, whatever we like	
@@ -270,7 +355,18 @@
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Null
-				}
+				},
+				{ 0.0 },			// No deadbands
+				0U,					// No change detection
+				0U,					// No early publication
+				false,					// No skip mode
+				"",					// No capture file
+				"",					// No replay. Read the serial port
+				1U,					// Replay speed
+				0U,					// Parsed by the main reactor
+				"",					// Not connected via the network
+				"",					// No network port
+				0U					// Standard serial port profile
 			},		
 			
 			{
@@ -300,16 +396,21 @@
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Number,
 					EhzMeasuredDataType::Number
-				}
+				},
+				{ 0.0 },			// No deadbands
+				0U,					// No change detection
+				0U,					// No early publication
+				false,					// No skip mode
+				"",					// No capture file
+				"",					// No replay. Read the serial port
+				1U,					// Replay speed
+				0U,					// Parsed by the main reactor
+				"",					// Not connected via the network
+				"",					// No network port
+				0U					// Standard serial port profile
 			}
 		};
 
-		// Number of defined Ehz in my System (sizeof array)
-		const uint MyNumberOfEhz = sizeof(myEhzConfigDefinition)/sizeof(myEhzConfigDefinition[0]);
-
-
-		
-		
 		// Dummy. Just for default initialisation. All null
 		const EhzConfigDefinition ehzConfigDefinitionNULL = 
 		{
@@ -340,9 +441,117 @@
 				EhzMeasuredDataType::Null,
 				EhzMeasuredDataType::Null
 			},
+			{ 0.0 },			// No deadbands
+			0U,					// No change detection
+			0U,					// No early publication
+			false,					// No skip mode
+			"",					// No capture file
+			"",					// No replay. Read the serial port
+			1U,					// Replay speed
+			0U,					// Parsed by the main reactor
+			"",					// Not connected via the network
+			"",					// No network port
+			0U					// Standard serial port profile
 		};
 	}
 
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Configuration of the EHZ system at runtime
+
+	// The EHZ system uses the built-in definitions above, or definitions read from a configuration file at program start
+	// Everything that can be derived from the definitions is calculated once while loading
+	//
+	// Format of the configuration file. One definition per line. Empty lines and lines starting with '#' are ignored
+	//
+	//	ehz <index> <serial port> <name of the EHZ>			The name is optional. Default: "EHZ <index>"
+	//	value <slot> <OBIS ID as 12 hex digits> number|string <name of the value>
+	//	capture <file>
+	//	replay <file> [speed]
+	//	worker <number>
+	//	network <host> <port>
+	//	deadband <slot> <amount>
+	//	keyframe <seconds>
+	//	early <slot>
+	//	skip
+	//	lowlatency [frame gap in ms]
+	//
+	// A value belongs to the EHZ defined above it. So do capture, replay, worker, network, deadband, keyframe, early, skip and lowlatency.
+	// "capture" records all raw data of the serial port into the file. "replay" reads the data from such a file
+	// instead of the serial port. Speed 1 (default) is real time, N is N times faster, 0 is as fast as possible.
+	// "worker" moves reading and parsing of the EHZ into a worker thread. EHZ with the same number share one thread.
+	// Without it, the main reactor does the work. "network" receives the raw data via TCP, for example from
+	// a remote optical head. A lost connection is made again. "keyframe" switches on change detection: Values,
+	// that did not change, are neither stored nor published. After the given seconds all values are sent again.
+	// "deadband" lets a number change by up to the amount, before it counts as changed. "early" publishes the value
+	// as soon as its list entry is parsed. It is marked as provisional, until the checksums of the SML file are verified.
+	// "skip" lets the parser jump over list entries of not configured values and over unknown messages with the help
+	// of the length fields. The checksums are still verified. "lowlatency" reads the serial port with fewer wakeups and hands over
+	// a whole frame at once, as soon as the line has been idle for the frame gap (default 30ms).
+	// The indices of the EHZ must be 0..(Number of EHZ-1)
+	// The slot is the position of the value in the results and in the database. Slots: 0..(NumberOfEhzMeasuredData-1)
+	//
+	// Example:
+	//	ehz 0 /dev/ttyUSB1 Einlieger
+	//	value 0 0100000000FF string Zaehler ID
+	//	value 1 0100010801FF number Verbrauch
+	//	replay /home/pidata/einlieger.cap 10
+	//	worker 1
+
+	namespace EhzInternal
+	{
+		// Default configuration file. If it is not existing, the built-in definition will be used
+		const mchar EhzConfigFileName[] = ROOT_DIRECTORY "/ehz.conf";
+		// Frame gap of "lowlatency" without a value
+		const u32 DefaultFrameGapInMs = 30U;
+
+		class EhzSystemConfiguration
+		{
+			public:
+				// Starts with the built-in definition
+				EhzSystemConfiguration(void);
+				~EhzSystemConfiguration(void) {}
+
+				// Read the definitions from a file. In case of error nothing is changed and false is returned
+				boolean load(const mchar *const fileName, std::string &errorMessage);
+
+				// Number of EHZ in the system
+				uint getNumberOfEhz(void) const { return numberOfEhz; }
+				// Definition for one EHZ. The definitions are sorted by their index
+				const EhzConfigDefinition &operator[](const uint ehzIndex) const { return ehzConfigDefinition[ehzIndex]; }
+				const std::vector<EhzConfigDefinition> &getEhzConfigDefinitions(void) const { return ehzConfigDefinition; }
+
+				// Precalculated during load
+				uint getNumberOfUsedEhzMeasuredData(const uint ehzIndex) const { return numberOfUsedEhzMeasuredData[ehzIndex]; }
+				uint getMaxNumberOfUsedEhzMeasuredData(void) const { return maxNumberOfUsedEhzMeasuredData; }
+				// Slots of all values with type Number for one EHZ
+				const std::vector<uint> &getNumberValueIds(const uint ehzIndex) const { return numberValueIds[ehzIndex]; }
+
+				SINGLETON_FOR_CLASS(EhzSystemConfiguration)
+			protected:
+				// Take over a set of definitions and calculate all lookup data
+				void assign(const std::vector<EhzConfigDefinition> &ecd);
+
+				std::vector<EhzConfigDefinition> ehzConfigDefinition;
+				std::vector<uint> numberOfUsedEhzMeasuredData;
+				std::vector<std::vector<uint> > numberValueIds;
+				uint numberOfEhz;
+				uint maxNumberOfUsedEhzMeasuredData;
+				// Texts read from the configuration file. The definitions point into them
+				// A list, because the strings must not move
+				std::list<std::string> configurationTexts;
+			private:
+				EhzSystemConfiguration(const EhzSystemConfiguration &);
+				EhzSystemConfiguration &operator =(const EhzSystemConfiguration &);
+		};
+
+		// Shortcut functions
+		inline uint getNumberOfEhz(void) { return EhzSystemConfiguration::getInstance()->getNumberOfEhz(); }
+		inline const EhzConfigDefinition &getEhzConfigDefinition(const uint ehzIndex) { return (*EhzSystemConfiguration::getInstance())[ehzIndex]; }
+		// The highest number of used values of all Ehz in the System
+		inline uint getMaxNumberOfUsedEhzMeasuredData(void) { return EhzSystemConfiguration::getInstance()->getMaxNumberOfUsedEhzMeasuredData(); }
+	}
+
  
 
 #endif
@@ -1,143 +1,466 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-// ehzmeasureddata.hpp
-//
-// General Description
-//
-// This module is a part of an application tor read the data from Electronic Meters for Electric Power
-//
-// In Germany they are called EHZ. Hence the name of the module
-//
-// The EHZ transmits data via an infrared interface. The protocoll is described in:
-//
-//  http://www.emsycon.de/downloads/SML_081112_103.pdf
-//
-// The EHZ System consists of one or more EHZ
-//
-// The software parses the datastream from an EHZ and provides resulting values as defined
-// in the following data structures.
-// The EHZ may transport several values of different types. In the configuration file
-// the needed values are selected.
-// Here we will show the data structes for one EHZ na d for the EHZ System
-// These definitions will be used for further data processing for other functions
-//
-
-#ifndef EHZMEASUREDDATA_HPP
-#define EHZMEASUREDDATA_HPP
-
-#include "mytypes.hpp"
-
-
-#include <vector>
-#include <iostream>
-#include <set>
- 
-
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 1. Definition of the structure to hold values for one EHZ
-
-	namespace EhzInternal
-	{
-
-		// This is a container for actual measured data from one Ehz
-		struct OneMeasuredValueForOneEhz
-		{
-			// Standard constructor. Set everything to 0
-			OneMeasuredValueForOneEhz(void) : 	doubleValue(0.0), 
-												smlByteString(), 
-												unit(), 
-												status(null<u64>())			
-			{}
-			
-			// Standard destructor does nothing
-			virtual ~OneMeasuredValueForOneEhz(void) {}
-			
-			// Deep Copy. Standard behaviour
-			OneMeasuredValueForOneEhz &operator =(const OneMeasuredValueForOneEhz &assignFromOneMeasuredValueForOneEhz);
-			
-			// Value fomr EHZ can be either a double or a string. We will not use a union here. Don't care about waste of memory
-			mdouble doubleValue;			
-			SmlByteString smlByteString;
-			
-			// Unit for a value
-			std::string unit;
-			
-			// Possible status information. For example the electric power maybe positive or negative
-			// See SML definition file for further information
-			u64 status;
-			
-			// This fills the EHZ data structure from an vector of strings
-			// It is the opposite of the << operator. But we use it in a different way
-			// and must use this functionality
-			void setValuesFromStrings(std::vector<std::string>::iterator &iter);
-			void clear(void) { doubleValue = 0.0; smlByteString.clear(); unit.clear();status = null<u64>(); } 
-		};
-		
-
-// ----------------------------------------------------------------------------------------
-// 2. Definition of the structure to hold values all values for all EHZ plus some timestamp
-
-
-		// As explained above, we are interested in NumberOfEhzMeasuredData from an Ehz
-		// This is a container that will hold all n data and the time when the data have been aquired
-		struct AllMeasuredValuesForOneEhz
-		{
-			// Default ctor resets everything to 0
-			AllMeasuredValuesForOneEhz(void) : measuredValueForOneEhz(NumberOfEhzMeasuredData), timeWhenDataHasBeenEvaluated(null<time_t>()), timeWhenDataHasBeenEvaluatedString(), obisValues()	{ }
-			virtual ~AllMeasuredValuesForOneEhz(void) {}
-			
-			// The measured values for all EHZ
-			std::vector<OneMeasuredValueForOneEhz> measuredValueForOneEhz;
-			
-			// Time information for when the data have been aquired
-			time_t timeWhenDataHasBeenEvaluated; 				// in time_t format
-			std::string timeWhenDataHasBeenEvaluatedString;		// As string
-						
-			std::set<std::string> obisValues;
-			
-			// This function will get the time and store it in our internal variables
-			void storeNowTime(void);
-			
-			// Convert EHZ System data to an output stream
-			//lint -e{1929}
-			friend std::ostream& operator<< (std::ostream &out, const AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz);
-
-			// This fills the EHZ System data structure from an vector of strings
-			// It is the opposite of the << operator. But we use it in a different way
-			// and must use this functionality
-			void setValuesFromStrings(std::vector<std::string>::iterator &iter);
-			void clear(void);
-			
-			AllMeasuredValuesForOneEhz &operator = (const AllMeasuredValuesForOneEhz &assignFromAllMeasuredValuesForOneEhz);
-		};
-	}
-		
-
-
-	// Dummy value for default initialization
-	//lint -e{956}
-	extern EhzInternal::AllMeasuredValuesForOneEhz emdaDummy;
-
-	typedef std::vector<EhzInternal::AllMeasuredValuesForOneEhz> AllMeasuredValuesForAllEhz;
-
-#endif
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+// ehzmeasureddata.hpp
+//
+// General Description
+//
+// This module is a part of an application tor read the data from Electronic Meters for Electric Power
+//
+// In Germany they are called EHZ. Hence the name of the module
+//
+// The EHZ transmits data via an infrared interface. The protocoll is described in:
+//
+//  http://www.emsycon.de/downloads/SML_081112_103.pdf
+//
+// The EHZ System consists of one or more EHZ
+//
+// The software parses the datastream from an EHZ and provides resulting values as defined
+// in the following data structures.
+// The EHZ may transport several values of different types. In the configuration file
+// the needed values are selected.
+// Here we will show the data structes for one EHZ na d for the EHZ System
+// These definitions will be used for further data processing for other functions
+//
+
+#ifndef EHZMEASUREDDATA_HPP
+#define EHZMEASUREDDATA_HPP
+
+#include "mytypes.hpp"
+
+
+#include <vector>
+#include <iostream>
+ 
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Definition of the structure to hold values for one EHZ
+
+	namespace EhzInternal
+	{
+		// Numbers from the EHZ are decimal fixed point values: An integer mantissa and a power of ten scaler
+		// Conversion to double uses a table of exactly representable powers of ten instead of pow()
+		mdouble convertScaledValueToDouble(const s64 mantissa, const s8 scaler);
+		// Exact decimal representation of a scaled value, e.g. mantissa 123456 and scaler -1 gives "12345.6"
+		std::string convertScaledValueToString(const s64 mantissa, const s8 scaler);
+		// The opposite. A decimal string like "12345.6" or "1.23457e+07" gives mantissa and scaler
+		void convertStringToScaledValue(const std::string &decimalString, s64 &mantissa, s8 &scaler);
+
+		// The ASCII data stream of the data server starts with a version field: STX version US data1 US ... ETX
+		// Version 1 had no version field and 4 fields per value: double value US SML byte string US unit US status US
+		// Version 2 has 6 fields per value: double value US mantissa US scaler US SML byte string US unit US status US
+		// The version field cannot be mistaken for the double value at the beginning of version 1
+		const mchar TextFormatVersionField[] = "V2";
+		const uint NumberOfStringsPerValueVersion1 = 4U;
+		const uint NumberOfStringsPerValue = 6U;
+		// Time and time as string after the values of one EHZ
+		const uint NumberOfStringsPerEhzTime = 2U;
+
+		// This is a container for actual measured data from one Ehz
+		struct OneMeasuredValueForOneEhz
+		{
+			// Standard constructor. Set everything to 0
+			OneMeasuredValueForOneEhz(void) : 	doubleValue(0.0), 
+												smlByteString(), 
+												mantissa(null<s64>()),
+												scaler(null<s8>()),
+												unit(), 
+												unitIndex(null<u8>()),
+												status(null<u64>())			
+			{}
+			
+			// Standard destructor does nothing
+			virtual ~OneMeasuredValueForOneEhz(void) {}
+			
+			// Deep Copy. Standard behaviour
+			OneMeasuredValueForOneEhz &operator =(const OneMeasuredValueForOneEhz &assignFromOneMeasuredValueForOneEhz);
+			
+			// Value fomr EHZ can be either a double or a string. We will not use a union here. Don't care about waste of memory
+			mdouble doubleValue;			
+			SmlByteString smlByteString;
+			
+			// For numbers: The exact value as received from the EHZ. doubleValue = mantissa * 10^scaler
+			s64 mantissa;
+			s8 scaler;
+			
+			// Store a number given as mantissa and scaler and calculate the double value
+			void setScaledValue(const s64 mantissaValue, const s8 scalerValue) { mantissa = mantissaValue; scaler = scalerValue; doubleValue = convertScaledValueToDouble(mantissaValue, scalerValue); }
+			// The exact number as decimal string
+			std::string getScaledValueAsString(void) const { return convertScaledValueToString(mantissa, scaler); }
+			// Compare the received data. The double value and the unit text follow from it
+			boolean hasChanged(const OneMeasuredValueForOneEhz &other) const { return (mantissa != other.mantissa) || (scaler != other.scaler) || (status != other.status) || (unitIndex != other.unitIndex) || (smlByteString != other.smlByteString); }
+			// Same, but numbers must differ by more than the deadband. A deadband of 0 means any change
+			boolean hasChangedBeyond(const OneMeasuredValueForOneEhz &other, const mdouble deadband) const;
+			
+			// Unit for a value
+			std::string unit;
+			// The same as index into ObisUnitLookup. 0: No unit
+			u8 unitIndex;
+			
+			// Possible status information. For example the electric power maybe positive or negative
+			// See SML definition file for further information
+			u64 status;
+			
+			// This fills the EHZ data structure from an vector of strings
+			// It is the opposite of the << operator. But we use it in a different way
+			// and must use this functionality
+			void setValuesFromStrings(std::vector<std::string>::iterator &iter);
+			// The same for the layout of version 1. Mantissa and scaler are taken from the text of the double value
+			void setValuesFromVersion1Strings(std::vector<std::string>::iterator &iter);
+			void clear(void) { doubleValue = 0.0; mantissa = null<s64>(); scaler = null<s8>(); smlByteString.clear(); unit.clear(); unitIndex = null<u8>(); status = null<u64>(); } 
+		};
+		
+		// Convert one measured value to an output stream. Each field is terminated by US
+		//lint -e{1929}
+		std::ostream& operator<< (std::ostream &out, const OneMeasuredValueForOneEhz &oneMeasuredValueForOneEhz);
+		
+
+// ----------------------------------------------------------------------------------------
+// 2. Definition of the structure to hold values all values for all EHZ plus some timestamp
+
+
+		// OBIS discovery. The OBIS IDs of all SmlListEntries of one SML file, in the order of the SML file.
+		// Only collected on request or in debug mode. The 6 bytes of an OBIS ID are packed into one integer
+		// and converted to text only, when they are shown
+		const uint MaxNumberOfDiscoveredObis = 64U;
+		struct DiscoveredObis
+		{
+			DiscoveredObis(void) : numberOfObis(null<uint>()) {}
+			void clear(void) { numberOfObis = null<uint>(); }
+			// Add an OBIS ID, if it is not yet known. If the table is full, it is ignored
+			void add(const u64 obisKey);
+			uint numberOfObis;
+			u64 obis[MaxNumberOfDiscoveredObis];
+		};
+		// One OBIS ID per line as hex bytes
+		//lint -e{1929}
+		std::ostream& operator<< (std::ostream &out, const DiscoveredObis &discoveredObis);
+
+		// As explained above, we are interested in NumberOfEhzMeasuredData from an Ehz
+		// This is a container that will hold all n data and the time when the data have been aquired
+		struct AllMeasuredValuesForOneEhz
+		{
+			// Default ctor resets everything to 0
+			AllMeasuredValuesForOneEhz(void) : measuredValueForOneEhz(NumberOfEhzMeasuredData), timeWhenDataHasBeenEvaluated(null<time_t>()), discoveredObis()	{ }
+			virtual ~AllMeasuredValuesForOneEhz(void) {}
+			
+			// The measured values for all EHZ
+			std::vector<OneMeasuredValueForOneEhz> measuredValueForOneEhz;
+			
+			// Time information for when the data have been aquired. Once per SML file
+			time_t timeWhenDataHasBeenEvaluated; 				// in time_t format
+
+			// OBIS IDs of the SML file. Empty, if no discovery was requested
+			DiscoveredObis discoveredObis;
+			
+			// This function will get the time from the coarse clock and store it in our internal variable
+			void storeNowTime(void);
+			// The time formatted only when needed. Empty, if there are no values. See ClockInternal::formatTime
+			const mchar *getTimeWhenDataHasBeenEvaluatedString(void) const;
+			
+			// Convert EHZ System data to an output stream
+			//lint -e{1929}
+			friend std::ostream& operator<< (std::ostream &out, const AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz);
+
+			// This fills the EHZ System data structure from an vector of strings
+			// It is the opposite of the << operator. But we use it in a different way
+			// and must use this functionality
+			void setValuesFromStrings(std::vector<std::string>::iterator &iter);
+			// Version 1 of the data stream. It may have less values per EHZ. The missing values are cleared
+			void setValuesFromVersion1Strings(std::vector<std::string>::iterator &iter, const uint numberOfValues);
+			void clear(void);
+			
+			AllMeasuredValuesForOneEhz &operator = (const AllMeasuredValuesForOneEhz &assignFromAllMeasuredValuesForOneEhz);
+		};
+	}
+		
+
+
+	// Dummy value for default initialization
+	//lint -e{956}
+	extern EhzInternal::AllMeasuredValuesForOneEhz emdaDummy;
+
+	typedef std::vector<EhzInternal::AllMeasuredValuesForOneEhz> AllMeasuredValuesForAllEhz;
+
+
+// ----------------------------------------------------------------------------------------
+// 3. Compact snapshot of the measured values of all EHZ
+
+	// The structures above are easy to use, but every value has own strings and a virtual destructor.
+	// For storing copies of the values (e.g. in queues), there is a compact form: One structure of arrays per EHZ
+	// without any string. Units are stored as index into ObisUnitLookup. Only values that really are strings
+	// are stored in an extra list. The time string and the OBIS debug values are not part of the snapshot.
+
+	namespace EhzInternal
+	{
+		// See below
+		class PublishedMeasuredValues;
+		
+		// All values of one EHZ. Plain data, so copying is a memcpy
+		struct CompactMeasuredValuesForOneEhz
+		{
+			time_t timeWhenDataHasBeenEvaluated;
+			mdouble doubleValue[NumberOfEhzMeasuredData];
+			s64 mantissa[NumberOfEhzMeasuredData];
+			u64 status[NumberOfEhzMeasuredData];
+			s8 scaler[NumberOfEhzMeasuredData];
+			u8 unitIndex[NumberOfEhzMeasuredData];
+		};
+		
+		// A value, that is a string
+		struct CompactTextValue
+		{
+			CompactTextValue(void) : ehzIndex(null<u16>()), valueIndex(null<u16>()), text() {}
+			u16 ehzIndex;
+			u16 valueIndex;
+			SmlByteString text;
+		};
+		
+		// Snapshot of all values of all EHZ
+		class MeasuredValuesSnapshot
+		{
+			public:
+				// Snapshot for the given number of EHZ
+				explicit MeasuredValuesSnapshot(const uint numberOfEhz = null<uint>());
+				virtual ~MeasuredValuesSnapshot(void) {}
+				
+				// Take over the values. The memory of the snapshot is reused
+				void assign(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz);
+				void assign(const PublishedMeasuredValues &publishedMeasuredValues);
+				// Write the values back. The target must have the same number of EHZ
+				void extract(AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz) const;
+				
+				// One element per EHZ
+				std::vector<CompactMeasuredValuesForOneEhz> compactMeasuredValues;
+				// Only the values that are strings
+				std::vector<CompactTextValue> textValues;
+				// Number of valid elements in textValues. Elements behind are kept for later reuse
+				uint numberOfTextValues;
+		};
+	}
+
+
+// ----------------------------------------------------------------------------------------
+// 4. Published measured values of all EHZ
+
+	// Each EHZ has two buffers for its values. The parser writes into one, readers use the other.
+	// After a complete SML file, the EHZ swaps the buffers and publishes a pointer to the new values.
+	// This class holds these pointers for all EHZ. So new values are available without any copy.
+	// The generation counts the publications. A reader can see with it, if there are new values.
+	
+	namespace EhzInternal
+	{
+		class PublishedMeasuredValues
+		{
+			public:
+				// All pointers refer to the dummy values, until the EHZ publish their own
+				explicit PublishedMeasuredValues(const uint numberOfEhz = null<uint>());
+				virtual ~PublishedMeasuredValues(void) {}
+				
+				// The latest values of one EHZ
+				const AllMeasuredValuesForOneEhz &operator[](const uint ehzIndex) const { return *measuredValues[ehzIndex]; }
+				uint size(void) const { return measuredValues.size(); }
+				
+				// An EHZ has new values. Store the pointer to them and count
+				void publish(const uint ehzIndex, const AllMeasuredValuesForOneEhz *const allMeasuredValuesForOneEhz);
+				// An EHZ swapped its buffers, but nothing worth reporting has changed. Store the pointer, but do not count
+				void refresh(const uint ehzIndex, const AllMeasuredValuesForOneEhz *const allMeasuredValuesForOneEhz) { measuredValues[ehzIndex] = allMeasuredValuesForOneEhz; }
+				// Refer to a copy of published values, for example in another thread. Their generation is taken over
+				void assign(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz, const u64 generationOfValues);
+				u64 getGeneration(void) const { return __atomic_load_n(&generation, __ATOMIC_ACQUIRE); }
+				
+			protected:
+				std::vector<const AllMeasuredValuesForOneEhz *> measuredValues;
+				u64 generation;
+		};
+		
+		// The published values must only be read in the thread of the EHZ. The parser overwrites the older buffer.
+		// Other threads get versions of the values. The owner stores a copy after each publication.
+		// A reader takes a copy only, if the generation has changed.
+		//
+		// There is no lock. The versions are in a pool of buffers. One of them is the current version. A reader pins the
+		// current buffer with its counter of readers, checks that it is still the current one, copies and unpins it.
+		// The owner writes the next version into a buffer, that is neither current nor pinned, and then makes it current.
+		// Each reader pins at most one buffer. With 2 buffers more than readers there is always a free one. So the owner
+		// never waits. A reader only tries again, if the owner has published a new version in between
+		const uint MaxNumberOfVersionReaders = 8U;
+		const uint NumberOfVersionBuffers = MaxNumberOfVersionReaders + 2U;
+		
+		class VersionedMeasuredValues
+		{
+			public:
+				VersionedMeasuredValues(void);
+				virtual ~VersionedMeasuredValues(void) {}
+				
+				// Owner: Store a new version
+				void store(const PublishedMeasuredValues &publishedMeasuredValues);
+				// Reader: Copy the values, if they are newer than the given generation. True, if something was copied
+				// Not more than MaxNumberOfVersionReaders threads may read
+				boolean load(AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz, u64 &generationOfValues) const;
+				
+			protected:
+				AllMeasuredValuesForAllEhz measuredValues[NumberOfVersionBuffers];
+				u64 generationOfBuffer[NumberOfVersionBuffers];
+				mutable uint numberOfReaders[NumberOfVersionBuffers];
+				// Index of the buffer with the current version
+				uint currentBuffer;
+				// Generation of the current version
+				u64 generation;
+			private:
+				// No copies
+				VersionedMeasuredValues(const VersionedMeasuredValues &);
+				VersionedMeasuredValues &operator =(const VersionedMeasuredValues &);
+		};
+	}
+
+
+// ----------------------------------------------------------------------------------------
+// 5. Binary wire format for the values of all EHZ
+
+	// The ASCII format (STX data1 US data2 US ... ETX) needs conversions from and to strings on both ends.
+	// The binary format transfers the received data as they are. All numbers are little endian with fixed width.
+	// Strings have a length prefix. The double value and the unit text are calculated again by the receiver.
+	//
+	// Frame:		SOH  version (u8)  length of payload (u32)  payload
+	// Payload:		number of EHZ (u16)  (EHZ)*
+	// EHZ:			time (s64)  time as string  number of values (u16)  (value)*
+	// Value:		mantissa (s64)  scaler (s8)  unit index (u8)  status (u64)  SML byte string
+	// String:		length (u16)  bytes
+	//
+	// Empty values at the end of an EHZ are not transferred. The receiver clears them.
+
+	namespace EhzInternal
+	{
+		const mchar BinaryFrameStart = '\x001';
+		const u8 BinaryFormatVersion = 1U;
+		const uint BinaryFrameHeaderSize = 6U;
+		// Longer payloads are treated as invalid data
+		const u32 MaxBinaryPayloadSize = 1048576UL;
+		
+		// Build a complete frame with the values of all EHZ
+		void encodeBinaryFrame(const PublishedMeasuredValues &publishedMeasuredValues, std::string &frame);
+		void encodeBinaryFrame(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz, std::string &frame);
+		
+		// Check the header at the beginning of the received data
+		// Returns the size of the complete frame, 0 if the header is not yet complete and -1 for an invalid header
+		sint getBinaryFrameSize(const std::string &receivedData);
+		
+		// Take over the values from a complete frame. The target gets the number of EHZ of the frame
+		// Returns false for an invalid frame. Then the target may be partly changed
+		boolean decodeBinaryFrame(const std::string &frame, AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz);
+	}
+
+
+// ----------------------------------------------------------------------------------------
+// 6. Change detection
+
+	// Many values, for example the energy counters, stay the same for minutes. They need not be stored or sent again.
+	// A value is reported, if it differs from the last reported one by more than its deadband (see EhzConfigDefinition).
+	// After the keyframe interval of the EHZ, all values are reported again. So a reader never waits longer for a
+	// complete set of values. Without a keyframe interval, the filter is off and every value is reported
+	
+	namespace EhzInternal
+	{
+		// All bits set. Every value is reported
+		const u32 AllMeasuredValuesReported = ~null<u32>();
+		
+		class ChangeDetection
+		{
+			public:
+				// For all EHZ of the configuration
+				ChangeDetection(void);
+				virtual ~ChangeDetection(void) {}
+				
+				// Compare the new values of one EHZ with the last reported ones and remember the reported values
+				// Returns one bit (1UL << value index) for each value to report. isKeyframe is set, if all values are reported because of the interval
+				u32 filter(const uint ehzIndex, const AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz, const time_t nowTime, boolean &isKeyframe);
+				
+			protected:
+				// The values as known by the readers
+				AllMeasuredValuesForAllEhz lastReportedValues;
+				// Time of the last keyframe for each EHZ. 0: There was none yet
+				std::vector<time_t> lastKeyframeTime;
+		};
+	}
+
+
+// ----------------------------------------------------------------------------------------
+// 7. Provisional values
+
+	// Values are normally published after the complete SML file has been parsed and its checksums are verified.
+	// Some values, for example the power for load switching, are needed earlier. They can be published as soon
+	// as their list entry has been parsed. Until the SML file is complete, they are provisional.
+	// The parser may run in a worker thread and readers are in reactor threads.
+	// Only the numerical part of a value is kept. The values of one EHZ and their valid bits are protected by a sequence lock.
+	// The parser sets the values. The EHZ system discards them in its own thread, when the SML file is published.
+	// Meanwhile the parser may already set values of the next SML file. So the values are marked with the number of
+	// their SML file and only the values of the discarded SML file are forgotten. Both writers take the lock with a compare exchange.
+	
+	namespace EhzInternal
+	{
+		class ProvisionalMeasuredValues
+		{
+			public:
+				// For all EHZ of the configuration. No provisional values
+				ProvisionalMeasuredValues(void);
+				virtual ~ProvisionalMeasuredValues(void) {}
+				
+				// A value of the SML file with this number has been parsed. The SML file is not yet verified
+				void set(const uint ehzIndex, const u64 smlFileNumber, const uint valueId, const OneMeasuredValueForOneEhz &oneMeasuredValueForOneEhz);
+				// The SML file with this number has been published or it was invalid. Forget its provisional values
+				void discard(const uint ehzIndex, const u64 smlFileNumber);
+				// Copy a provisional value. False, if there is none. Then the published value is valid
+				// Strings and the SML byte string are not copied. The unit is set from the unit index
+				boolean get(const uint ehzIndex, const uint valueId, OneMeasuredValueForOneEhz &oneMeasuredValueForOneEhz) const;
+				
+			protected:
+				// The numerical part of a value. Can be copied under the sequence lock
+				struct ProvisionalValue
+				{
+					ProvisionalValue(void) : mantissa(null<s64>()), status(null<u64>()), doubleValue(0.0), scaler(null<s8>()), unitIndex(null<u8>()) {}
+					s64 mantissa;
+					u64 status;
+					mdouble doubleValue;
+					s8 scaler;
+					u8 unitIndex;
+				};
+				// Per EHZ NumberOfEhzMeasuredData values
+				std::vector<ProvisionalValue> measuredValues;
+				// Per EHZ the sequence lock. Odd, while a value or the valid bits are changed
+				std::vector<u64> sequenceOfEhz;
+				// Per EHZ one bit (1UL << value index) for each valid provisional value
+				std::vector<u32> isProvisional;
+				// Per EHZ the number of the SML file, that the provisional values belong to
+				std::vector<u64> smlFileNumberOfEhz;
+				
+				// Wait until the sequence is even and make it odd. Returns the even sequence for unlock
+				u64 lock(const uint ehzIndex);
+				// Make the sequence even again. Readers may use the values
+				void unlock(const uint ehzIndex, const u64 sequence) { __atomic_store_n(&sequenceOfEhz[ehzIndex], sequence + 2ULL, __ATOMIC_RELEASE); }
+			private:
+				// No copies
+				ProvisionalMeasuredValues(const ProvisionalMeasuredValues &);
+				ProvisionalMeasuredValues &operator =(const ProvisionalMeasuredValues &);
+		};
+	}
+
+#endif
@@ -144,6 +144,14 @@
 		crc16t crc16Calculated;	// The calculated crc16 checksum from the SML file
 		u8 numberOfFillBytes;	// The number of fill bytes in the SML File
 	};
+	
+	// Counted at every ESC-Stop sequence. For the metrics. Only the thread of the parser writes them
+	struct EscAnalysisStatistics
+	{
+		EscAnalysisStatistics(void) : numberOfEscFrames(null<u64>()), numberOfCrc16Mismatches(null<u64>()) {}
+		u64 numberOfEscFrames;
+		u64 numberOfCrc16Mismatches;
+	};
 
 
 	// These are the function return codes for the main analysis function
@@ -186,7 +194,8 @@
 		{
 		    EscAnalysisContextData(void) : resultCode(EscAnalysisResult::ESC_ANALYSIS_RESULT_ERROR),
 											escSmlFileEndData(),
-											smlFileCrc16Calculator()
+											smlFileCrc16Calculator(),
+											escAnalysisStatistics()
             {}
 			// Function return code for all analyse functions
 			EscAnalysisResult::Code resultCode;
@@ -194,6 +203,8 @@
 			EscSmlFileEndData escSmlFileEndData;
 			// Helper Class for calculating the CRC16 for an SML File
 			Crc16CalculatorSmlStart smlFileCrc16Calculator;
+			// Not touched by reset
+			EscAnalysisStatistics escAnalysisStatistics;
 		};
 
 	// ------------------------------------------------------------------------------------------------------------------------------
@@ -228,8 +239,13 @@
 			// Main working function for the outer world
 			EscAnalysisResult::Code analyse(const EhzDatabyte databyte);
 			
+			// Interface compatibility with the table driven analyzer. The reference
+			// implementation does no look ahead. All bytes must go through "analyse"
+			size_t analysePayload(const EhzDatabyte *const, const size_t) { return null<size_t>(); }
+			
 			// In case that the outer world is interested in checksum and fill byte information
 			const EscSmlFileEndData &getLastEscFileEndData(void) const; 
+			const EscAnalysisStatistics &getEscAnalysisStatistics(void) const { return eacd.escAnalysisStatistics; }
 			
 		protected:
 		
@@ -556,6 +572,205 @@ class EscAnalysisBaseState
 	}
 
 
+
+// ----------------------------------------------------------------------------------------------------------------------------------
+// 5. Table driven ESC analysis
+// ----------------------------------------------------------------------------------------------------------------------------------
+
+// The above design with state classes is easy to read and to maintain. It is the reference
+// implementation. But it needs a virtual function call for every byte of the data stream.
+//
+// The class "EscAnalysisTableDriven" implements exactly the same DFA with a flat transition
+// table. The table is indexed with the current state and the class of the databyte. Each entry
+// contains the next state, the result code and an action for the few states that have to
+// evaluate the databyte itself (fill byte, crc16 bytes) or control the crc16 calculator.
+//
+// Nearly all bytes of an SML file are net data that arrive in state "Idle". Those bytes do not
+// need to go through the state machine at all. "analysePayload" searches for the next ESC in a
+// block of data and runs only the crc16 calculation for all bytes before that ESC. The caller
+// may then treat all those bytes as "ESC_CONDITION_WAITING".
+
+
+	namespace EscAnalyisInternal
+	{
+		// ------------------------------------------------------------------------------------------------------------------------------
+		// 5.1 States, byte classes and actions for the transition table
+		// ------------------------------------------------------------------------------------------------------------------------------
+	
+		// The state numbers correspond to the state classes of the reference implementation
+		struct EscTableState
+		{
+			enum Code
+			{
+				Idle,				// EscStateIdle
+				WaitFor2ndEsc,		// EscStateWaitFor2ndEsc
+				WaitFor3rdEsc,		// EscStateWaitFor3rdEsc
+				WaitFor4thEsc,		// EscStateWaitFor4thEsc
+				InitialEscRead,		// EscState4InitialEscRead
+				WaitFor2ndEscEsc,	// EscStateWaitFor2ndESCESC
+				WaitFor3rdEscEsc,	// EscStateWaitFor3rdESCESC
+				WaitFor4thEscEsc,	// EscStateWaitFor4thESCESC
+				WaitFor2ndStart,	// EscStateWaitFor2ndStart
+				WaitFor3rdStart,	// EscStateWaitFor3rdStart
+				WaitFor4thStart,	// EscStateWaitFor4thStart
+				WaitForFillByte,	// StateWaitForFillByte
+				WaitForCrc16Byte1,	// StateWaitForCrc16Byte1
+				WaitForCrc16Byte2,	// StateWaitForCrc16Byte2
+				NumberOfStates
+			};
+		};
+		
+		// The DFA needs to distinguish only 4 classes of databytes
+		struct EscByteClass
+		{
+			enum Code
+			{
+				Esc,			// 0x1B
+				Start,			// 0x01
+				Stop,			// 0x1A
+				Other,			// Anything else
+				NumberOfByteClasses
+			};
+		};
+		
+		// Additional activities for a transition
+		struct EscTableAction
+		{
+			enum Code
+			{
+				None,
+				StartCrc16,			// Complete ESC-Start read. Start the crc16 calculation for the SML file
+				StoreFillByte,		// Store the number of fill bytes and stop the crc16 calculation
+				StoreCrc16Byte1,	// Store the first byte of the crc16 checksum
+				CheckCrc16			// Store the second byte of the crc16 checksum and compare it
+			};
+		};
+
+		// One entry of the transition table
+		struct EscTableTransition
+		{
+			u8 nextState;
+			EscAnalysisResult::Code resultCode;
+			u8 action;
+		};
+		
+		// The transition table itself, defined in the cpp file
+		extern const EscTableTransition escTransitionTable[EscTableState::NumberOfStates][EscByteClass::NumberOfByteClasses];
+		
+		// Map a databyte to its class
+		inline EscByteClass::Code getEscByteClass(const EhzDatabyte databyte)
+		{
+			EscByteClass::Code ebc = EscByteClass::Other;
+			//lint -e{911}
+			if (DATABYTE_ESC == databyte)
+			{
+				ebc = EscByteClass::Esc;
+			}
+			else if (DATABYTE_START == databyte)
+			{
+				ebc = EscByteClass::Start;
+			}
+			else if (DATABYTE_STOP == databyte)
+			{
+				ebc = EscByteClass::Stop;
+			}
+			return ebc;
+		}
+	} // End of	namespace EscAnalyisInternal
+	
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 5.2 Main class for the table driven ESC analysis
+	// ------------------------------------------------------------------------------------------------------------------------------
+
+	// Same interface as the reference implementation "EscAnalysis"
+	class EscAnalysisTableDriven
+	{
+		public:
+			EscAnalysisTableDriven(void) : currentState(EscAnalyisInternal::EscTableState::Idle), eacd() {}
+			void reset(void) { currentState = EscAnalyisInternal::EscTableState::Idle; }
+			
+			// Main working function for the outer world. Same results as EscAnalysis::analyse
+			EscAnalysisResult::Code analyse(const EhzDatabyte databyte);
+			
+			// Look ahead in a block of data. Returns the number of bytes at the beginning of the
+			// block that are net data (no ESC and state "Idle"). The crc16 for those bytes has
+			// been calculated already. The bytes must not be passed to "analyse" again
+			size_t analysePayload(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes);
+			
+			// In case that the outer world is interested in checksum and fill byte information
+			const EscSmlFileEndData &getLastEscFileEndData(void) const { return eacd.escSmlFileEndData; }
+			const EscAnalysisStatistics &getEscAnalysisStatistics(void) const { return eacd.escAnalysisStatistics; }
+			
+		protected:
+			// The current state of the state machine. Index into transition table
+			u8 currentState;
+
+			// Same common data as in the reference implementation
+			EscAnalyisInternal::EscAnalysisContextData eacd;
+	};
+	
+	
+	// Transition for one databyte
+	inline EscAnalysisResult::Code EscAnalysisTableDriven::analyse(const EhzDatabyte databyte) 
+	{
+		// Continuosly Run the CRC16 calculation for a complete SmlFile
+		eacd.smlFileCrc16Calculator.update(databyte);
+		
+		const EscAnalyisInternal::EscTableTransition &ett = EscAnalyisInternal::escTransitionTable[currentState][EscAnalyisInternal::getEscByteClass(databyte)];
+		
+		eacd.resultCode = ett.resultCode;
+		currentState = ett.nextState;
+		
+		// Only very few transitions need an additional action
+		//lint -e{788}
+		switch (ett.action)
+		{
+			case EscAnalyisInternal::EscTableAction::None:
+				break;
+			case EscAnalyisInternal::EscTableAction::StartCrc16:
+				eacd.smlFileCrc16Calculator.start();
+				break;
+			case EscAnalyisInternal::EscTableAction::StoreFillByte:
+				eacd.escSmlFileEndData.numberOfFillBytes = databyte;
+				eacd.smlFileCrc16Calculator.stop();
+				break;
+			case EscAnalyisInternal::EscTableAction::StoreCrc16Byte1:
+				//lint -e{921}
+				eacd.escSmlFileEndData.crc16FromEscStop = static_cast<crc16t>(databyte);
+				break;
+			case EscAnalyisInternal::EscTableAction::CheckCrc16:
+				//lint -e{921}
+				eacd.escSmlFileEndData.crc16FromEscStop = 
+					((eacd.escSmlFileEndData.crc16FromEscStop << 8U) & 0xff00U) | static_cast<crc16t>(databyte);
+				eacd.escSmlFileEndData.crc16Calculated = eacd.smlFileCrc16Calculator.getResult();
+				++eacd.escAnalysisStatistics.numberOfEscFrames;
+				if (eacd.escSmlFileEndData.crc16FromEscStop != eacd.escSmlFileEndData.crc16Calculated)
+				{
+					// Checksum mismatch --> error
+					eacd.resultCode = EscAnalysisResult::ESC_ANALYSIS_RESULT_ERROR;
+					++eacd.escAnalysisStatistics.numberOfCrc16Mismatches;
+				}
+				break;
+			default:
+				break;
+		}
+		return eacd.resultCode;
+	}
+
+
+
+// ----------------------------------------------------------------------------------------------------------------------------------
+// 6. Search for the next ESC-Start sequence
+// ----------------------------------------------------------------------------------------------------------------------------------
+
+// After a parser error, all bytes up to the next SML file are useless. Instead of running them through
+// the ESC analysis one by one, the parser searches the block for the next ESC-Start sequence.
+// Returns the position of that sequence. If the block ends with the beginning of an ESC-Start sequence,
+// the position of this beginning. Else the number of bytes in the block
+
+	size_t findEscStartSequence(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes);
+
  
 
 #endif
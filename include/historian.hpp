@@ -0,0 +1,179 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// historian.hpp
+//
+// General Description
+//
+// Append only storage for measured values. An alternative to the SQLITE database for high sampling rates.
+//
+// Numerical values are stored as fixed size binary records in segment files. The segment files are
+// memory mapped. So writing a record is just a store into memory. The operating system writes the pages.
+//
+// Layout of a segment file:
+//  - One page with the header: Identification, number of records and a sparse time index
+//    The index holds the time stamp of every HistorianIndexStride'th record
+//  - HistorianRecordsPerSegment records
+//
+// The file name contains the time of the first record. If a segment is full, the next one is started.
+// Reading a time range is a binary search in the sparse index and then a sequential scan of the mapped pages.
+// For evaluation with SQL, the segments can be exported into an SQLITE database and then be removed.
+//
+
+#ifndef HISTORIAN_HPP
+#define HISTORIAN_HPP
+
+#include "ehzmeasureddata.hpp"
+
+#include <string>
+#include <vector>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General definitions
+
+	namespace HistorianInternal
+	{
+		// Directory for the segment files. At the moment hardcoded
+		const char EhzHistorianDirectory[] = ROOT_DIRECTORY "/historian";
+		
+		// The historian is an additional backend. Switched off by default
+		const boolean EhzHistorianIsActive = false;
+		
+		// Size definitions for a segment
+		const uint HistorianRecordsPerSegment = 131072U;		// 4MB with 32 byte records
+		const uint HistorianIndexStride = 512U;					// Sparse index: One entry per 512 records
+		const uint HistorianIndexSize = HistorianRecordsPerSegment / HistorianIndexStride;
+		const uint HistorianHeaderSize = 4096U;					// One page
+		
+		// Identification of a segment file
+		// u32 is a long and has 64 bit on some targets. The file format uses uint for 32 bit fields
+		const uint HistorianMagic = 0x5A484548U;				// "HEHZ"
+		const uint HistorianVersion = 1U;
+		
+		// Filter value for reading: All meters or all values
+		const uint HistorianAnyIndex = 0xFFFFU;
+		
+		// One measured value. Fixed size of 32 bytes. Natural alignment, no padding
+		struct HistorianRecord
+		{
+			s64 timeStamp;			// Time, when the value has been acquired
+			s64 mantissa;			// Value = mantissa * 10^scaler
+			u64 status;				// Status information from the EHZ
+			u16 meterIndex;			// Index of the EHZ
+			u8 valueIndex;			// Index of the measured value of the EHZ
+			s8 scaler;
+			uint sequenceNumber;	// Counts the records of one meter with the same time stamp. Starts with 0. Was reserved and 0 before
+		};
+		
+		// Header of a segment. Occupies the first page of the file
+		struct HistorianSegmentHeader
+		{
+			uint magic;
+			uint version;
+			uint recordSize;
+			uint numberOfRecords;							// Number of valid records in this segment
+			s64 timeIndex[HistorianIndexSize];				// Time stamp of record i * HistorianIndexStride
+		};
+		
+		// The layout is part of the file format. Check it at compile time
+		typedef char HistorianRecordSizeCheck[(32U == sizeof(HistorianRecord)) ? 1 : -1];
+		typedef char HistorianHeaderSizeCheck[(HistorianHeaderSize >= sizeof(HistorianSegmentHeader)) ? 1 : -1];
+	}
+	
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. The historian
+
+	namespace HistorianInternal
+	{
+		class EhzHistorian
+		{
+			public:
+				// Open the newest segment in the directory or create a new one
+				explicit EhzHistorian(const std::string &directoryl);
+				// Write everything to disk and unmap
+				virtual ~EhzHistorian(void);
+				
+				// Append all numerical values of one EHZ
+				void append(const uint meterIndex, const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz);
+				// Append one record
+				void append(const HistorianRecord &historianRecord);
+				
+				// Get all records with a time stamp in [fromTime, toTime]
+				void read(const s64 fromTime, const s64 toTime, std::vector<HistorianRecord> &historianRecords) const;
+				// Get at most maxRecords records of one value of one EHZ with a time stamp in [fromTime, toTime]
+				// Records with the time stamp fromTime must have at least the fromSequenceNumber. So a page continues exactly after the last record
+				void read(const s64 fromTime, const uint fromSequenceNumber, const s64 toTime, const uint meterIndex, const uint valueIndex, const uint maxRecords, std::vector<HistorianRecord> &historianRecords) const;
+				
+				// Write all records of the segments into a table in an SQLITE database. Returns the number of records.
+				// If removeSegments is true, then all segments, but the active one, will be deleted after a successful export
+				u64 exportToSqlite(const std::string &databaseName, const boolean removeSegments);
+				
+				// Write the mapped pages of the active segment to disk
+				void sync(void) const;
+				
+				// Check if there is an active segment that we can write to
+				boolean isOpen(void) const { return (null<u8 *>() != activeSegment.memory); }
+				
+			protected:
+				// A segment file, that is mapped into memory
+				struct MappedSegment
+				{
+					MappedSegment(void) : memory(null<u8 *>()), header(null<HistorianSegmentHeader *>()), records(null<HistorianRecord *>()) {}
+					virtual ~MappedSegment(void) {}
+					u8 *memory;
+					HistorianSegmentHeader *header;
+					HistorianRecord *records;
+				};
+				
+				// Map a segment file. Create it, if necessary. Returns false in case of error
+				static boolean mapSegment(const std::string &fileName, const boolean create, MappedSegment &mappedSegmentl);
+				static void unmapSegment(MappedSegment &mappedSegmentl);
+				// Start a new segment for records beginning with the given time
+				void startNewSegment(const s64 timeOfFirstRecord);
+				// Names of all segment files in the directory. Sorted by time of the first record
+				void getSegmentFileNames(std::vector<std::string> &segmentFileNames) const;
+				// Sequence number for the next records of a meter with this time stamp
+				uint getSequenceNumber(const uint meterIndex, const s64 timeStamp);
+				// Find the records in the range in one segment
+				// Find the records in the range in one segment. Stops, when there are maxRecords records in the result
+				static void readFromSegment(const MappedSegment &segment, const s64 fromTime, const uint fromSequenceNumber, const s64 toTime, const uint meterIndex, const uint valueIndex, const uint maxRecords, std::vector<HistorianRecord> &historianRecords);
+				
+				// Directory for the segments
+				const std::string directory;
+				// The active segment, where we append
+				std::string activeSegmentFileName;
+				MappedSegment activeSegment;
+				// Per meter: time stamp and sequence number of the last appended records
+				std::vector<std::pair<s64, uint> > lastTimeStampAndSequenceNumber;
+				
+			private:
+				// Default constructor and copies must not be used
+				//lint -e{1704}
+				EhzHistorian(void);
+				EhzHistorian(const EhzHistorian &);
+				EhzHistorian &operator =(const EhzHistorian &);
+		};
+	}
+
+#endif
@@ -0,0 +1,210 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// logger.hpp
+//
+// General Description
+//
+// Diagnostic messages must not slow down the event loop. Writing to the user interface costs a refresh
+// of the terminal for every message. And only the main reactor may use the user interface.
+//
+// So a message is formatted into a record of fixed size and put into a ring buffer. This is lock free
+// and can be done by any thread. The first record wakes up the main reactor through an eventfd. The main
+// reactor then writes all queued records at once to the selected sink: The user interface, a file or syslog.
+// If the ring buffer is full, records are dropped and counted.
+//
+// Every place in the code, that writes messages, has its own LogSite. It limits the number of records
+// per second. Suppressed records are counted and reported with the next record of this site.
+// So a burst of errors will not flood anything.
+//
+// Usage:
+//
+//		static LogSite logSite;
+//		{
+//			Log log(logSite);
+//			log << "Connection closed: " << address;
+//		}
+//
+// The record is queued, when the Log is destroyed
+//
+
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include "mytypes.hpp"
+#include "eventhandler.hpp"
+#include "singleton.hpp"
+
+#include <stdio.h>
+#include <time.h>
+
+#include <ostream>
+#include <string>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General definitions
+
+namespace LoggerInternal
+{
+	// Longer messages are cut
+	const uint LogRecordTextSize = 120U;
+	// Must be a power of 2
+	const uint NumberOfLogRecords = 256U;
+	const u32 DefaultMaxNumberOfLogRecordsPerSecond = 10UL;
+	// Records with this window number go to the main window of the user interface
+	const uint LogMainWindow = 0xFFFFFFFFU;
+
+	struct LogRecord
+	{
+		// Position in the ring buffer, for which this record can be written or read
+		uint sequence;
+		uint windowNumber;
+		time_t timeOfRecord;
+		uint length;
+		mchar text[LogRecordTextSize];
+	};
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Ring buffer
+
+	// Bounded queue for many producers and one consumer, as described by Dmitry Vyukov.
+	// Every record has a sequence number, that tells, if it is free for writing or ready for reading
+	class LogRingBuffer
+	{
+		public:
+			LogRingBuffer(void);
+			~LogRingBuffer(void) {}
+			// Any thread. Returns false, if the buffer is full
+			boolean push(const uint windowNumber, const time_t timeOfRecord, const mchar *const text, const uint length);
+			// Only the main reactor. Returns false, if the buffer is empty
+			boolean pop(LogRecord &logRecord);
+		protected:
+			LogRecord logRecord[NumberOfLogRecords];
+			uint enqueuePosition;
+			uint dequeuePosition;
+	};
+}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Logger
+
+	struct LogSink
+	{
+		enum Type
+		{
+			Userinterface,
+			File,
+			Syslog
+		};
+	};
+
+	// Singleton. The event handler is registered with the main reactor
+	class Logger : public EventHandlerBasic
+	{
+		public:
+			Logger(void);
+			virtual ~Logger(void);
+
+			// Queue a record. May be called by any thread. Never blocks
+			void log(const uint windowNumber, const mchar *const text, const uint length);
+			// Select, where the records go. A file will be opened for appending
+			boolean setSink(const LogSink::Type logSinkP, const std::string &fileName = std::string());
+
+			// The main reactor has been woken up. Write everything
+			virtual EventProcessing::Action handleEvent(const EventType et);
+
+			//lint -e{956}  // 956 Non const, non volatile static or external variable
+			SINGLETON_FOR_CLASS(Logger)
+		protected:
+			// Write all queued records to the sink
+			void drain(void);
+			void write(const LoggerInternal::LogRecord &logRecord);
+			// Refresh the window of the user interface or flush the file
+			void flush(const uint windowNumber);
+
+			LoggerInternal::LogRingBuffer logRingBuffer;
+			LogSink::Type logSink;
+			FILE *logFile;
+			// Only the first record after a drain writes the eventfd
+			boolean drainIsRequested;
+			u32 numberOfDroppedRecords;
+		private:
+			// No copies
+			Logger(const Logger &);
+			Logger &operator =(const Logger &);
+	};
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. Rate limit for one place in the code
+
+	// Static objects. Can be used by any thread
+	class LogSite
+	{
+		public:
+			explicit LogSite(const u32 maxNumberOfRecordsPerSecondP = LoggerInternal::DefaultMaxNumberOfLogRecordsPerSecond) : 
+								maxNumberOfRecordsPerSecond(maxNumberOfRecordsPerSecondP), currentSecond(null<time_t>()), 
+								numberOfRecordsInCurrentSecond(null<u32>()), numberOfSuppressedRecords(null<u32>()) {}
+			~LogSite(void) {}
+			// Check the limit. If allowed, the records suppressed before are returned and count as reported
+			boolean allow(u32 &numberOfSuppressedRecordsP);
+		protected:
+			const u32 maxNumberOfRecordsPerSecond;
+			time_t currentSecond;
+			u32 numberOfRecordsInCurrentSecond;
+			u32 numberOfSuppressedRecords;
+		private:
+			LogSite(const LogSite &);
+			LogSite &operator =(const LogSite &);
+	};
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 5. Stream for one record
+
+	// Formats into a fixed buffer. If the site does not allow the record, the stream is set to bad and nothing is formatted
+	//lint -e{1790}
+	class Log : public std::ostream, private std::streambuf
+	{
+		public:
+			explicit Log(LogSite &logSite, const uint windowNumberP = LoggerInternal::LogMainWindow);
+			// Queue the record
+			virtual ~Log(void);
+		protected:
+			//lint -e{1961}
+			virtual std::streambuf::int_type overflow(std::streambuf::int_type c);
+			virtual std::streamsize xsputn(const mchar *s, std::streamsize num);
+
+			uint windowNumber;
+			boolean isAllowed;
+			uint length;
+			mchar text[LoggerInternal::LogRecordTextSize];
+		private:
+			Log(const Log &);
+			Log &operator =(const Log &);
+	};
+
+
+#endif
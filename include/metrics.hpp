@@ -0,0 +1,178 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// metrics.hpp
+//
+// General Description
+//
+// Counters and latency histograms for the hot paths: The Ehz (bytes, ESC frames, checksum errors,
+// parser errors, time from receiving the last bytes of an SML File until all subscribers have been informed),
+// the database (time for writing the queued records) and the reactors (time for a batch of events and
+// for calling one EventHandler).
+//
+// Every counter and every histogram is written by exactly one thread. This is the thread, that owns
+// the measured object. So there is no read-modify-write on the bus and no lock. Only relaxed loads and stores.
+// Each reactor has its own set. Other threads may read the values at any time. They will see values,
+// that are maybe a little bit old, but never torn.
+//
+// The values are shown by a TCP server in the text format of Prometheus
+//
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include "mytypes.hpp"
+#include "singleton.hpp"
+
+#include <time.h>
+
+#include <ostream>
+#include <string>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General definitions
+
+namespace MetricsInternal
+{
+	// Same value as in reactor.hpp. Checked there
+	const uint NumberOfReactorsWithMetrics = 8U;
+
+	// Upper bounds of the buckets are 1us, 4us, 16us, . . ., 4^11 us (about 4s) and infinity
+	const uint NumberOfHistogramBuckets = 13U;
+
+	// Current time of the monotonic clock in ns. Cheap. No system call with vDSO
+	inline u64 getMonotonicTimeInNs(void)
+	{
+		struct timespec monotonicTime;
+		//lint -e{534}
+		clock_gettime(CLOCK_MONOTONIC, &monotonicTime);
+		return (static_cast<u64>(monotonicTime.tv_sec) * 1000000000ULL) + static_cast<u64>(monotonicTime.tv_nsec);
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Counter and histogram
+
+	// Only the owning thread adds. Any thread may read
+	class Counter
+	{
+		public:
+			Counter(void) : value(null<u64>()) {}
+			void add(const u64 increment) { __atomic_store_n(&value, __atomic_load_n(&value, __ATOMIC_RELAXED) + increment, __ATOMIC_RELAXED); }
+			void increment(void) { add(1ULL); }
+			// For values that are counted by someone else
+			void set(const u64 newValue) { __atomic_store_n(&value, newValue, __ATOMIC_RELAXED); }
+			u64 get(void) const { return __atomic_load_n(&value, __ATOMIC_RELAXED); }
+		protected:
+			u64 value;
+	};
+
+	// Durations in ns. The number of observations is the sum of all buckets
+	class Histogram
+	{
+		public:
+			Histogram(void) : bucket(), sumInNs() {}
+			void observe(const u64 durationInNs);
+			// Measure from startTimeInNs until now
+			void observeSince(const u64 startTimeInNs) { observe(getMonotonicTimeInNs() - startTimeInNs); }
+
+			u64 getBucket(const uint bucketIndex) const { return bucket[bucketIndex].get(); }
+			u64 getSumInNs(void) const { return sumInNs.get(); }
+			u64 getCount(void) const;
+		protected:
+			Counter bucket[NumberOfHistogramBuckets];
+			Counter sumInNs;
+	};
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Sets of metrics
+
+	// For one Ehz. The counters are written by the thread, that parses the data of the Ehz. The latency by the main reactor
+	struct EhzMetrics
+	{
+		EhzMetrics(void) : bytesRead(), escFrames(), crc16Mismatches(), parserResyncs(), resyncSkippedBytes(), octetBufferOverflows(), droppedMeasuredValues(), parseToPublishLatency() {}
+		Counter bytesRead;
+		// Counted by the ESC analysis. Taken over, when the metrics are read
+		Counter escFrames;
+		Counter crc16Mismatches;
+		// The parser found an error and started again with the next SML File
+		Counter parserResyncs;
+		// Bytes up to the next SML File, that have been skipped after an error. Counted by the parser
+		Counter resyncSkippedBytes;
+		// SML files, that were dropped, because their octet strings did not fit. Counted by the parser
+		Counter octetBufferOverflows;
+		// A worker thread had no free buffer, because the main reactor was behind. The values were overwritten
+		Counter droppedMeasuredValues;
+		Histogram parseToPublishLatency;
+	};
+
+	// For one reactor. Written by the thread of the reactor
+	struct ReactorMetrics
+	{
+		ReactorMetrics(void) : eventLoopLatency(), dispatchLatency() {}
+		// Handling of all events of one wake up
+		Histogram eventLoopLatency;
+		// One call of an EventHandler
+		Histogram dispatchLatency;
+	};
+
+	// Format in the text exposition format of Prometheus. labels is for example: ehz="0"
+	void writeMetricHeader(std::ostream &os, const mchar *const name, const mchar *const type, const mchar *const help);
+	void writeCounter(std::ostream &os, const mchar *const name, const std::string &labels, const Counter &counter);
+	void writeHistogram(std::ostream &os, const mchar *const name, const std::string &labels, const Histogram &histogram);
+}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. Metrics, that do not belong to an Ehz
+
+	class Metrics
+	{
+		public:
+			Metrics(void) : reactorMetrics(), databaseInsertLatency(), databaseLostRecords() {}
+			~Metrics(void) {}
+
+			// The metrics of the reactor, whose thread calls this
+			MetricsInternal::ReactorMetrics &getReactorMetrics(const uint reactorIndex) { return reactorMetrics[reactorIndex]; }
+			// Written by the database writer thread. Or by the event loop, if there is no thread. Never by both
+			MetricsInternal::Histogram &getDatabaseInsertLatency(void) { return databaseInsertLatency; }
+			// Records, that could not be written and were given up. Same writer as the latency
+			MetricsInternal::Counter &getDatabaseLostRecords(void) { return databaseLostRecords; }
+
+			// Reactors and the database in the text format of Prometheus
+			void write(std::ostream &os) const;
+
+			//lint -e{956}  // 956 Non const, non volatile static or external variable
+			SINGLETON_FOR_CLASS(Metrics)
+		protected:
+			MetricsInternal::ReactorMetrics reactorMetrics[MetricsInternal::NumberOfReactorsWithMetrics];
+			MetricsInternal::Histogram databaseInsertLatency;
+			MetricsInternal::Counter databaseLostRecords;
+		private:
+			Metrics(const Metrics &);
+			Metrics &operator =(const Metrics &);
+	};
+
+
+#endif
@@ -96,6 +96,14 @@ typedef sint Handle;                  	// Handle is a synonym for a Linux file d
 
 typedef std::string SmlByteString;
 
+// A reference to a SmlByteString, whose bytes are stored somewhere else. So no copy is needed.
+// The view is only valid as long as the storage for the bytes is valid
+typedef struct _SmlByteStringView
+{
+	const EhzDatabyte *data;
+	TokenLength length;
+} SmlByteStringView;
+
 
 // --------------------------------------------------------------------------------------------------------------------------------------
 // 4. Library specific Constants 
@@ -115,8 +123,9 @@ const EventType EventTypeNotValid = 	static_cast<EventType>(0x020);
 // 5. Project specific Constants 
 
 
-// We are requesting/searching for max 4 measured values from our Ehz
-const uint NumberOfEhzMeasuredData = 4U;
+// We are requesting/searching for max 32 measured values from our Ehz
+// Values that are not defined in the configuration of an Ehz have the type Null
+const uint NumberOfEhzMeasuredData = 32U;
 
 const u32 MAX_SML_STRING_LEN = 32UL;
 
@@ -138,6 +147,9 @@ enum GlobalDebugMode
 	DebugModeMax
 };
 
+// OBIS discovery on request. Incremented for each request. Each EHZ collects the OBIS IDs of its next SML file
+extern u32 globalObisDiscoveryRequest;
+
 
 
 
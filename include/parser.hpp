@@ -133,13 +133,16 @@
 #ifndef PARSER_H
 #define PARSER_H
 #include <math.h>
+#include <stddef.h>
 
+#include <new>
 #include <vector>
 
 #include "mytypes.hpp"
 #include "scanner.hpp"
 
 #include "factory.hpp"
+#include "singleton.hpp"
 #include "visitor.hpp"
 
 
@@ -171,6 +174,29 @@
 	const prCode pr_PROCESSING = ParserResult::PROCESSING;  // Parse activity ongoing. Result not yet available
 	const prCode pr_ERROR = ParserResult::ERROR;            // Error detected. Input not matching expected values  
 
+	// The block oriented parse function takes a complete chunk of data and reports the positions
+	// in the chunk, where a parse activity has been finished (either with DONE or ERROR)
+	struct ParserBoundary
+	{
+		ParserBoundary(const size_t pos, const prCode prc) : positionInBlock(pos), parserResult(prc) {}
+		// Index of the byte in the chunk that finished the parse activity
+		size_t positionInBlock;
+		// pr_DONE or pr_ERROR
+		prCode parserResult;
+	};
+	// All boundaries found in one chunk
+	typedef std::vector<ParserBoundary> ParserBoundaryList;
+	
+	// After an error the block oriented parse function skips everything up to the next ESC-Start sequence
+	// Only the thread of the parser writes the counters
+	struct ParserStatistics
+	{
+		ParserStatistics(void) : numberOfResyncs(null<u64>()), numberOfSkippedBytes(null<u64>()), numberOfOctetBufferOverflows(null<u64>()) {}
+		u64 numberOfResyncs;				// Searches for the next ESC-Start sequence
+		u64 numberOfSkippedBytes;			// Bytes that have been skipped without scanning
+		u64 numberOfOctetBufferOverflows;	// SML files, whose octet strings did not fit in the octet buffer of the scanner
+	};
+
 	
 // ------------------------------------------------------------------------------------------------------------------------------
 // 2. Parser internal data and structures
@@ -183,13 +209,22 @@
 	// --------------------------------------------------------------------------------------------------------------------------
 	// 2.1 Mediator class for internal information exchange
 
+		// Skip mode: Decides after the OBIS ID of a SmlListEntry has been parsed, if the rest of the entry is needed
+		class SmlListEntryFilter
+		{
+			public:
+				SmlListEntryFilter(void) {}
+				virtual ~SmlListEntryFilter(void) {}
+				virtual boolean isNeeded(const SmlByteStringView &objName) const = 0;
+		};
 
 		// Mediator class to share information between parsing functions of different classes
 		// All "parse" functions will use this as a parameter
 		struct ParserContext
 		{
 			public:
-				ParserContext(void) : token(null<Token *>()), crc16Calculator(), fillByteCounter(null<u8>()), ignoreRestOfSequence(false)  {};
+				ParserContext(void) : token(null<Token *>()), crc16Calculator(), fillByteCounter(null<u8>()), ignoreRestOfSequence(false), streamingVisitor(null<VisitorBase *>()), staticParsing(true),
+										skipMode(false), smlListEntryFilter(null<const SmlListEntryFilter *>()), numberOfElementsToSkip(null<TokenLength>()), isOctetContentSkipped(false) {};
 				// Pointer to current token returned by the Scanner. The token is matched against the grammar
 				// and used to store values, which will be copied into the parse tree
 				const Token *token;						
@@ -209,11 +244,116 @@
 				// at roughly each 2 seconds. Since people may use this software also with other meters, this flag
 				// has been introduced to ignore all none EDL21 compatible messages
 				boolean ignoreRestOfSequence;			
+
+				// Event driven (streaming) mode. If a visitor is set, then each SmlSequence (for example a
+				// SmlListEntry or a SmlPublicOpenResponse) will be visited immediately after it has been parsed.
+				// A SmlSequenceOf will then only create one element and parse it again for all elements of the
+				// sequence. So the parse tree does not grow with the number of list entries and no traversal is needed
+				VisitorBase *streamingVisitor;
+
+				// The known message bodies (SmlPublicOpenResponse, SmlGetListResponse, SmlPublicCloseResponse
+				// with their SmlListEntry) and SmlTime are created without factory and parsed with statically bound
+				// calls. Unknown message bodies are always created by the factory and parsed through virtual functions.
+				// If switched off, everything is parsed dynamically. Then the result must be the same
+				boolean staticParsing;
+
+				// Skip mode. The TL fields give the number of elements of each list. This is sufficient to jump over
+				// unknown message bodies and over SmlListEntries that are not needed, without matching them against
+				// the grammar. The bytes are still used for the crc16 calculation. Octet strings, whose content is not
+				// needed (signatures, server IDs), are checked, but not stored by the scanner
+				boolean skipMode;
+				const SmlListEntryFilter *smlListEntryFilter;	// Selects the needed SmlListEntries. 0: All are needed
+				TokenLength numberOfElementsToSkip;				// Elements that will be skipped, including the current one
+				boolean isOctetContentSkipped;					// The content of the next octet string is not needed
 		};
 
 		
 	// --------------------------------------------------------------------------------------------------------------------------
-	// 2.2 Abstract base class for all SML Elements
+	// 2.2 Memory pool for the nodes of the parse tree
+
+		// For each SML file the parser creates SmlMessages, fill bytes, the ESC end primitive and all
+		// the elements of SmlSequenceOf and SmlChoice dynamically. And after the evaluation of the
+		// parse tree everything will be deleted again. Since the structure of the SML files sent by a meter
+		// is always the same, the same number of nodes with the same sizes is requested again and again.
+		//
+		// So we do not give the memory back to the heap, but store it in a free list. There is one free
+		// list for each size class. The next request for a node of the same size class will take the memory
+		// from the free list. After the first SML file has been parsed, no further heap activity is needed.
+		// Memory for bigger objects will be requested from and released to the heap directly.
+		//
+		// The pool is used through class specific operators new and delete of SmlElementBase and through
+		// an allocator for the vectors of the containers. So the creation of nodes is not visible elsewhere.
+		//
+		// Parsers may run in worker threads. So each thread has its own free lists. A block released by
+		// another thread than the one that allocated it, simply moves to the free list of the releasing thread
+		
+		// Granularity of the size classes in bytes. All blocks in the free lists are a multiple of this
+		const size_t SmlNodePoolGranularity = 16U;
+		// Number of size classes. Objects bigger than SmlNodePoolGranularity * SmlNodePoolNumberOfSizeClasses
+		// will not be pooled
+		const size_t SmlNodePoolNumberOfSizeClasses = 64U;
+		// An empty free list is refilled with this number of blocks at once. The number of nodes differs
+		// a little bit from SML file to SML file (for example the fill bytes). The spare blocks absorb this,
+		// so that the pool does not need the heap again after the warm up
+		const size_t SmlNodePoolBlocksPerRefill = 16U;
+		
+		class SmlNodePool
+		{
+			public:
+				// Get memory from the free list or, if the free list is empty, from the heap
+				static void *allocate(const size_t size);
+				// Give memory back to the free list
+				static void release(void *const memory, const size_t size);
+			protected:
+				// A released block is used to store the link to the next free block
+				struct FreeBlock
+				{
+					FreeBlock *next;
+				};
+				// Calculate index of free list for a given size
+				static size_t getSizeClass(const size_t size) { return (null<size_t>() == size) ? null<size_t>() : ((size - 1U) / SmlNodePoolGranularity); }
+				// One free list for each size class and thread
+				static __thread FreeBlock *freeList[SmlNodePoolNumberOfSizeClasses];
+		};
+		
+		
+		// Allocator for the std::vector of the container classes. This allocates the memory for the
+		// pointers to the contained elements from the SmlNodePool.
+		template<typename T>
+		class SmlNodeAllocator
+		{
+			public:
+				typedef T value_type;
+				typedef T *pointer;
+				typedef const T *const_pointer;
+				typedef T &reference;
+				typedef const T &const_reference;
+				typedef size_t size_type;
+				typedef ptrdiff_t difference_type;
+				template<typename U> struct rebind { typedef SmlNodeAllocator<U> other; };
+				
+				SmlNodeAllocator(void) {}
+				template<typename U> SmlNodeAllocator(const SmlNodeAllocator<U> &) {}
+				~SmlNodeAllocator(void) {}
+				
+				pointer address(reference r) const { return &r; }
+				const_pointer address(const_reference r) const { return &r; }
+				//lint -e{925}  // 925 Cast from pointer to pointer
+				pointer allocate(const size_type n, const void * = null<const void *>()) { return static_cast<pointer>(SmlNodePool::allocate(n * sizeof(T))); }
+				void deallocate(pointer p, const size_type n) { SmlNodePool::release(p, n * sizeof(T)); }
+				size_type max_size(void) const { return static_cast<size_type>(-1) / sizeof(T); }
+				void construct(pointer p, const T &t) { new (static_cast<void *>(p)) T(t); }
+				void destroy(pointer p) { p->~T(); }
+		};
+		// All SmlNodeAllocators are using the same pool and are therefore interchangeable
+		template<typename T, typename U>
+		inline bool operator == (const SmlNodeAllocator<T> &, const SmlNodeAllocator<U> &) { return true; }
+		template<typename T, typename U>
+		inline bool operator != (const SmlNodeAllocator<T> &, const SmlNodeAllocator<U> &) { return false; }
+
+		
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 2.3 Abstract base class for all SML Elements
 
 		// This is the base class for all SML Data Elements. All other SML Elements are derived from this
 		// class.
@@ -240,18 +380,30 @@
 				virtual prCode parse(ParserContext &pc) = 0;		
 				// Per default an SML Element is not a container
 				virtual boolean isContainer(void) const { return false; }
+				
+				// All dynamically created SML Elements will be taken from / given back to the node pool
+				static void *operator new(const size_t size) { return SmlNodePool::allocate(size); }
+				static void operator delete(void *const memory, const size_t size) { SmlNodePool::release(memory, size); }
 		};
+
+		// Parse an element, whose type is known at compile time. The qualified name suppresses the virtual
+		// call, so that the compiler can inline the parse function. Used for static parsing
+		template<class SmlElementType>
+		inline prCode parseStatically(SmlElementType &smlElement, ParserContext &pc) { return smlElement.SmlElementType::parse(pc); }
+
+		// Skip mode: Eat the tokens of pc.numberOfElementsToSkip elements. pr_DONE after the last one
+		prCode skipElements(ParserContext &pc);
 	
 		
 	// --------------------------------------------------------------------------------------------------------------------------
-	// 2.3 Templates for generic primitives. Primitives are "terminals" in compiler language
+	// 2.4 Templates for generic primitives. Primitives are "terminals" in compiler language
 		
 		 // All primitives are following the same pattern. They analyse the token and match it to the expected 
 		 // grammar element (interpreter pattern). If a token has an attribute (value) then this is stored. Since SML has
 		 // the concept of an "optional" value, a mechanism for dealing with that situation is also available.
 
 		// ----------------------------------------------------------------------------------------------------------------------
-		// 2.3.1 Template for primitives that only have a type and maybe a length 
+		// 2.4.1 Template for primitives that only have a type and maybe a length 
 
 			template<const Token::TokenType tokenType, const TokenLength tokenLength=0UL>
 			class SmlPrimitive : public SmlElementBase
@@ -267,7 +419,7 @@
 
 
 		// ----------------------------------------------------------------------------------------------------------------------
-		// 2.3.2 Template for Primitives that have a type, a value and maybe an associated length	
+		// 2.4.2 Template for Primitives that have a type, a value and maybe an associated length	
 
 			template<typename ValueType, const Token::TokenType tokenType, const TokenLength tokenLength=0UL>
 			class SmlPrimitiveWithValue : public SmlPrimitive<tokenType, tokenLength>
@@ -289,7 +441,7 @@
 
 			
 		// ----------------------------------------------------------------------------------------------------------------------
-		// 2.3.3 Template for Primitives that have a type, a (maybe optional) value and maybe an associated length	
+		// 2.4.3 Template for Primitives that have a type, a (maybe optional) value and maybe an associated length	
 		
 			template<typename ValueType, const Token::TokenType tokenType, const TokenLength tokenLength=0UL>
 			class SmlPrimitiveWithOptionalValue : public SmlPrimitiveWithValue<ValueType, tokenType, tokenLength>
@@ -306,7 +458,7 @@
 
 			
 		// ----------------------------------------------------------------------------------------------------------------------
-		// 2.3.4 A primitive that matches to everything and returns immediately "Done"
+		// 2.4.4 A primitive that matches to everything and returns immediately "Done"
 		
 			// Can be used for optional value handling	
 			class SmlPrimitiveAny : public SmlElementBase
@@ -322,7 +474,7 @@
 
 
 	// --------------------------------------------------------------------------------------------------------------------------
-	// 2.4 Templates for generic containers
+	// 2.5 Templates for generic containers
 
 		// "Container" contain Primitives or other "Containers". The matching algorithm of the Primitives is
 		// used. Other containers are parsed recursively (depth first). SML defines several kinds of containers, 
@@ -335,7 +487,7 @@
 
 
 		// ----------------------------------------------------------------------------------------------------------------------
-		// 2.4.1 Abstract Base class for other containers. Can also be visited by a Visitor hierarchy.
+		// 2.5.1 Abstract Base class for other containers. Can also be visited by a Visitor hierarchy.
 		// Containers are "Non Terminals" in compiler language
 		
 			// The standard "Container" contains static elements. (Not dynamic created elements)
@@ -343,8 +495,10 @@
 								 public VisitableBase		// Make class visitable
 			{
 				public: 
+					// The vector for the pointers to the contained elements takes its memory from the node pool
+					typedef std::vector<SmlElementBase *, SmlNodeAllocator<SmlElementBase *> > SmlElementVector;
 					// size type for vector
-					typedef std::vector<SmlElementBase *>::size_type vst;
+					typedef SmlElementVector::size_type vst;
 					
 					// Ctor initializes the vector and the iterator for the vector
 					explicit SmlContainer(const vst numberOfElements = 9U) : SmlElementBase(), VisitableBase(), smlElementContainer() , smlContainerIterator()
@@ -364,8 +518,8 @@
 					DEFINE_VISITABLE()
 
 				protected:
-					std::vector<SmlElementBase *> smlElementContainer;				// The vector for storing other SML elements
-					std::vector<SmlElementBase *>::iterator smlContainerIterator;	// And its associated iterator
+					SmlElementVector smlElementContainer;				// The vector for storing other SML elements
+					SmlElementVector::iterator smlContainerIterator;	// And its associated iterator
 							
 					// Inline alias functions to save typing work and to make code more readable		
 					void resetIterator(void) { smlContainerIterator = smlElementContainer.begin(); }
@@ -380,7 +534,7 @@
 
 			
 		// ----------------------------------------------------------------------------------------------------------------------
-		// 2.4.2 Base class for container with dynamically created elements
+		// 2.5.2 Base class for container with dynamically created elements
 
 		// Most SML-containers have static elements. But some container will be build during the parsing process.
 		// A typical need for this kind of container is the "SML Sequence Of". Here the contents are not known in
@@ -426,14 +580,16 @@
 		class SmlValue : public SmlElementBase
 		{
 			public:
-				SmlValue(void) : SmlElementBase(), token(), value(null<mdouble>()), sbs() {}
+				SmlValue(void) : SmlElementBase(), token(), value(null<s64>()), sbs() {}
 				virtual ~SmlValue(void) {}
 				// Special handling: Copy token and finish. No match functionality
-				virtual prCode parse(ParserContext &pc) { token = *pc.token; value = token.getDoubleValue(); token.getValueForType(&sbs); return pr_DONE; }
+				virtual prCode parse(ParserContext &pc) { token = *pc.token; value = token.getIntegerValue(); token.getValueForType(&sbs); return pr_DONE; }
 				
 				Token token;
-				mdouble value;
-				SmlByteString sbs;
+				// Raw integer value (mantissa). Scaling is done by the consumer
+				s64 value;
+				// Reference to the string in the octet buffer of the scanner. Valid until the next SML file starts
+				SmlByteStringView sbs;
 			protected:
 				
 		};
@@ -479,11 +635,11 @@
 		// Start of an SML File:
 		typedef SmlPrimitive<Token::START_OF_SML_FILE> 												SmlFileStart;
 		
-		// Match Octet and store String:
-		typedef SmlPrimitiveWithValue<SmlByteString, Token::OCTET, MAX_SML_STRING_LEN> 				OctetString;
+		// Match Octet and store String. Only a reference to the string in the octet buffer is stored
+		typedef SmlPrimitiveWithValue<SmlByteStringView, Token::OCTET, MAX_SML_STRING_LEN> 			OctetString;
 
 		// Match Octet and store string or "optional2:
-		typedef SmlPrimitiveWithOptionalValue<SmlByteString, Token::OCTET, MAX_SML_STRING_LEN>	 	OctetStringOptional;
+		typedef SmlPrimitiveWithOptionalValue<SmlByteStringView, Token::OCTET, MAX_SML_STRING_LEN>	OctetStringOptional;
 
 		// Match an unsigned 8 and store its value:
 		typedef SmlPrimitiveWithValue<u8, Token::UNSIGNED_INTEGER, 1UL> 							Unsigned8;
@@ -555,13 +711,20 @@
 				// Reserve requested number of elements (+1 for the SML list)
 				// Add the SML List as first Element
 				//lint -e{917}	//917 Prototype coercion (Context) Type to Type
-				SmlSequence(void) :  SmlContainer(NumberOfSmlElements+1UL), smlList()   {addL(&smlList);}
+				SmlSequence(void) :  SmlContainer(NumberOfSmlElements+1UL), smlList(), unneededOctetContent(null<u32>())   {addL(&smlList);}
 				virtual ~SmlSequence(void) {}
 				// Parsing function for SML Sequence
 				virtual prCode parse(ParserContext &pc);
 			protected:
+				// Evaluate the parse result of the current element. Go to the next element or finish the sequence
+				prCode completeStep(const prCode elementResult, ParserContext &pc);
+				// Position of the element that will be parsed next. 0 is the SML List
+				//lint -e{1702,1901}
+				ptrdiff_t getStep(void) const { return smlContainerIterator - smlElementContainer.begin(); }
 				// The SML List
 				SmlPrimitiveWithValue<SmlListLength, Token::LIST, NumberOfSmlElements> smlList;
+				// Skip mode: Bit n is set, if the content of the octet string at position n is not needed
+				u32 unneededOctetContent;
 		};
 
 		
@@ -575,9 +738,13 @@
 				//lint -e{1732,1733}
 				//1732 new in constructor for class 'Name' which has no assignment
 				//1733 new in constructor for class 'Name' which has no copy constructor
-				SmlSequenceOf(void) : SmlContainerDynamic() { addL( new SmlList); }   // Add SML List as first Element in the container
+				SmlSequenceOf(void) : SmlContainerDynamic(), numberOfElementsToParse(null<TokenLength>()) { addL( new SmlList); }   // Add SML List as first Element in the container
 				virtual ~SmlSequenceOf(void) { try{releaseElements();}catch(...){} }   // Destruct Elements and shrink container
 				virtual prCode parse(ParserContext &pc);  // Parse it 
+			protected:
+				// With static parsing, SmlElementType::parseStatic is called for the elements of the sequence
+				prCode parseElement(ParserContext &pc);
+				TokenLength numberOfElementsToParse;	// Elements of the sequence that have not yet been parsed
 		};
 		
 		
@@ -601,15 +768,17 @@
 		{
 			public:
 				SmlChoice(void);
-				// Destructor will delete the factory and the allocated message body 
+				// Destructor will delete the allocated message body. The factory is shared and will not be deleted
 				//lint -e{9008,1740}
 				//1740 pointer member 'Symbol' (Location) not directly freed or zero'ed by destructor 
 				//9008   comma operator used
-				virtual ~SmlChoice(void) { try{delete choiceFactory; delete smlElementContainer[2U];smlElementContainer[2U]=null<SmlElementBase *>();}catch(...){}}
+				virtual ~SmlChoice(void) { try{delete smlElementContainer[2U];smlElementContainer[2U]=null<SmlElementBase *>();}catch(...){}}
 				// Also here the parse function
 				virtual prCode parse(ParserContext &pc);
 			protected:
-				ChoiceFactory* choiceFactory;		// Choice factory that will be used
+				// With static parsing, all 3 elements are parsed with statically bound calls
+				prCode parseElement(ParserContext &pc);
+				ChoiceFactory* choiceFactory;		// Choice factory that will be used. One for all SmlChoice of the same type
 				Unsigned32 tag;						// Tag to select the choice
 				SmlElementBase *specificSmlElement; // Sub Container element
 		};
@@ -618,6 +787,9 @@
 		// ----------------------------------------------------------------------------------------
 		// For the definition of dedicated SML Choice objects we need to define the Factory classes
 
+		// The factories do not have a state. So all SML Choice objects of the same type may use the
+		// same factory object. Otherwise each created SML Choice would need to build its own std::map
+		
 		// For SML Message Body
 		class ChoiceFactorySmlMessageBody : public BaseClassFactory<u32, SmlElementBase>
 		{
@@ -626,6 +798,12 @@
 				virtual ~ChoiceFactorySmlMessageBody(void) {}
 				
 				virtual SmlElementBase* createInstance(const u32 &selector);
+				// Static parsing: Create a known message body without lookup. 0 for an unknown selector
+				static SmlElementBase *createKnownInstance(const u32 selector);
+				// Static parsing: Parse a known message body with a statically bound call. Others are parsed dynamically
+				static prCode parseKnownInstance(const u32 selector, SmlElementBase *const smlElement, ParserContext &pc);
+				// Factory shared by all SmlMessageBody objects
+				SINGLETON_FOR_CLASS(ChoiceFactorySmlMessageBody)
 		};
 		
 		// For SML Time
@@ -634,6 +812,11 @@
 			public:
 				ChoiceFactorySmlTime(void);
 				virtual ~ChoiceFactorySmlTime(void) {}
+				// Static parsing. See ChoiceFactorySmlMessageBody
+				static SmlElementBase *createKnownInstance(const u32 selector);
+				static prCode parseKnownInstance(const u32 selector, SmlElementBase *const smlElement, ParserContext &pc);
+				// Factory shared by all SmlTime objects
+				SINGLETON_FOR_CLASS(ChoiceFactorySmlTime)
 		};
 
 		
@@ -694,7 +877,7 @@
 			public:
 				virtual ~SmlListEntry(void) {}
 				// Add container elements to internal vector
-				SmlListEntry(void) : SmlSequence(), objName(),status(),valTime(),unit(),scaler(),value(),valueSignature()
+				SmlListEntry(void) : SmlSequence(), objName(),status(),valTime(),unit(),scaler(),value(),valueSignature(), isSkippingRest(false)
 				{
 					add(&objName);
 					add(&status);
@@ -703,7 +886,12 @@
 					add(&scaler);
 					add(&value);
 					addL(&valueSignature);
+					unneededOctetContent = (1UL << 7U);
 				}
+				// Skip mode: The rest of the entry is skipped, if the OBIS ID is not needed
+				virtual prCode parse(ParserContext &pc);
+				// Static parsing. Non virtual. The elements are parsed with statically bound calls
+				prCode parseStatic(ParserContext &pc);
 				// SML Container elements 
 				OctetString 			objName;
 				SmlStatusOptional 		status;
@@ -715,10 +903,17 @@
 				
 				// This container accepts a visitor
 				DEFINE_VISITABLE() 
+			protected:
+				// Skip mode: Check the OBIS ID, after it has been parsed in step "stepBefore"
+				void checkIfRestIsNeeded(const ptrdiff_t stepBefore, const prCode pr, ParserContext &pc);
+				// Skip mode: Eat the tokens of the remaining elements. The entry is not visited
+				prCode skipRest(ParserContext &pc);
+				boolean isSkippingRest;
 		};
 		
 		
 		// SML Val List:
+		// With static parsing the elements are parsed with SmlListEntry::parseStatic
 		typedef SmlSequenceOf<SmlListEntry> SmlValList;
 
 		// SML Message: GetListResponse:
@@ -736,9 +931,11 @@
 					add(&valList);
 					add(&listSignature);
 					addL(&actGatewayTime);
+					unneededOctetContent = (1UL << 2U) | (1UL << 6U);
 				}
-			protected:
-				// SML Container elements 
+				// Static parsing. Non virtual. The elements are parsed with statically bound calls
+				prCode parseStatic(ParserContext &pc);
+				// SML Container elements. Public because of visitor pattern
 				OctetStringOptional 	clientID;
 				OctetString 			serverID;
 				OctetStringOptional 	listName;
@@ -746,6 +943,7 @@
 				SmlValList 				valList;
 				SmlSignatureOptional 	listSignature;
 				SmlTimeOptional 		actGatewayTime;
+				DEFINE_VISITABLE() 
 		};
 		
 		// SML Message: Public Open Response:
@@ -762,15 +960,18 @@
 					add(&serverId);
 					add(&refTime);
 					addL(&smlVersion);
+					unneededOctetContent = (1UL << 4U);
 				}
-			protected:
-				// SML Container elements 
+				// Static parsing. Non virtual. The elements are parsed with statically bound calls
+				prCode parseStatic(ParserContext &pc);
+				// SML Container elements. Public because of visitor pattern
 				OctetStringOptional 	codepage;
 				OctetStringOptional 	clientId;		
 				OctetString 			reqFileId;
 				OctetString				serverId;
 				SmlTimeOptional 		refTime;
 				OctetStringOptional 	smlVersion;
+				DEFINE_VISITABLE() 
 		};
 
 		
@@ -784,10 +985,13 @@
 				SmlPublicCloseResponse(void) : SmlSequence(), globalSignature()
 				{
 					addL(&globalSignature);
+					unneededOctetContent = (1UL << 1U);
 				}
-			protected:
-				// SML Container elements 
+				// Static parsing. Non virtual. The elements are parsed with statically bound calls
+				prCode parseStatic(ParserContext &pc);
+				// SML Container elements. Public because of visitor pattern
 				SmlSignatureOptional 	globalSignature;
+				DEFINE_VISITABLE() 
 		};
 
 		// General SML Message:
@@ -878,28 +1082,56 @@
 // 		prCode parse(EhzDatabyte databyte);
 
 // This function takes a raw databyte and returns pr_Done, after a complete SML File has been read.
+// An overload of this function takes a block of raw databytes and returns the number of consumed bytes.
+
+// Results can be retrieved after pr_Done by traversing the parse tree with a visitor. Or a visitor is
+// set as streaming visitor. Then it will be called during parsing for each completed SmlSequence.
 
 
 
 class Parser
 {
 	public: 
-		Parser(void) : smlFile(),pc(),scanner() {}
+		Parser(void) : smlFile(),pc(),scanner(), isResynchronizing(false), parserStatistics() {}
 		~Parser(void) {}
 	
 		prCode parse(const EhzDatabyte databyte, const uint ehzIndex);
 		
-		void reset(void) { smlFile.reset(); }
+		// Block oriented parse function. Feeds all bytes of a chunk into the parser. Parser errors
+		// are recorded in the boundary list and the parse tree is reset. Parsing stops after the byte
+		// that completed an SML file (pr_DONE), because the caller must evaluate the parse tree first.
+		// Returns the number of consumed bytes. Call again with the rest of the chunk.
+		// After an error the bytes up to the next ESC-Start sequence are skipped. Also in the following chunks
+		size_t parse(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes, const uint ehzIndex, ParserBoundaryList &parserBoundaryList);
+
+		void reset(void) { smlFile.reset(); pc.numberOfElementsToSkip = null<TokenLength>(); }
 		void traverseAndEvaluate(ParserInternal::VisitorForSmlListEntry * const visitorForSmlListEntry );
+		// Set visitor for event driven mode. 0 switches back to building the complete parse tree
+		void setStreamingVisitor(VisitorBase *const streamingVisitor) { pc.streamingVisitor = streamingVisitor; }
+		// Statically bound parsing of the known message bodies (default) or everything dynamically
+		void setStaticParsing(const boolean staticParsing) { pc.staticParsing = staticParsing; }
+		// Skip mode. Unknown message bodies and SmlListEntries, that the filter does not need, are skipped
+		void setSkipMode(const boolean skipMode, const ParserInternal::SmlListEntryFilter *const smlListEntryFilter) { pc.skipMode = skipMode; pc.smlListEntryFilter = smlListEntryFilter; }
+		// Counters of the ESC analysis
+		const EscAnalysisStatistics &getEscAnalysisStatistics(void) const { return scanner.getEscAnalysisStatistics(); }
+		// Counters of the resynchronization after errors
+		const ParserStatistics &getParserStatistics(void) const { return parserStatistics; }
 
 	protected:
+		// Match the current token against the grammar
+		prCode parseToken(const EhzDatabyte databyte, const uint ehzIndex);
+	
 		// Main / Root Cointainer
 		ParserInternal::SmlFile smlFile;
 		
 		// The context for the parsing process
 		ParserInternal::ParserContext pc;
 		// The Scanner(Lexer). This will produce the tokens
-		Scanner scanner;
+		ScannerEngine scanner;
+		
+		// An error occured. Search the next ESC-Start sequence, before scanning again
+		boolean isResynchronizing;
+		ParserStatistics parserStatistics;
 };
 
 
@@ -1,103 +1,169 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-// 
-// parsetreevisitor.hpp
-//
-// Special Visitor for evaluation of an SmlListEntry
-//
-// Please refer also to parser.hpp/cpp
-// After the parser has successfully read a SML File, a parse tree with all information
-// regarding that file is available. That tree will be traversed. All needed information
-// will be extracted. This is done using the visitor pattern. And the following class
-// gets all important information for a Ehz
-//
-
-
-
-#ifndef PARSETREEVISITOR_HPP
-#define PARSETREEVISITOR_HPP
-
-#include "ehzconfig.hpp"
-#include "ehzmeasureddata.hpp"
-#include "parser.hpp"
-
- 
- 
-
-namespace ParserInternal
-{
-
-// ------------------------------------------------------------------------------------------------------------------------------------------------
-// 1. Definition of visitor class to get all values of one EHZ
-	
-	class SmlListEntryEvaluation : public ParserInternal::VisitorForSmlListEntry
-	{
-		public:
-			// Explicit constructor for this class.
-			// Set references to Ehz properties and the array where the result will be stored
-			explicit SmlListEntryEvaluation(const EhzConfigDefinition &ecd, EhzInternal::AllMeasuredValuesForOneEhz *const emd);
-			virtual ~SmlListEntryEvaluation(void)  {}	// Empty virtual destructor
-			
-			// Overwrite for the visit function of the parent class
-			// You need to understand the visitor pattern first. Please search the internet.
-			// This visit function will be called, if the element in the parse tree is a SmlListEntry
-			// It will then extract the values from the parse tree and store it in the EHZ - System
-			// This is the function that acts as an interface between parsed values and the Ehz - System
-			// for further data processing
-			virtual void visit(ParserInternal::SmlListEntry &smlListEntry);
-
-			void clear(void) {allMeasuredValuesForOneEhz->clear();}
-		protected:
-			// Reference to the properties of the Ehz. We need to know these in order to be 
-			// able to interpret all values correctly for this specific Ehz
-			//lint --e(1725)		class member 'Symbol' is a reference
-			const EhzConfigDefinition &ehzConfigDefinition;
-			
-			// This functions reads measured values from the parsed SML File. The values will be stored in 
-			// an array. There is an array for measured values for each Ehz in EhzSystem
-			//lint --e(1725)		class member 'Symbol' is a reference
-			EhzInternal::AllMeasuredValuesForOneEhz *allMeasuredValuesForOneEhz;
-			
-		private:
-			// Standard constructor. Must not be used. Hence --> private
-			//lint --e(1704)  // 1704 Constructor 'Symbol' has private access specification
-			SmlListEntryEvaluation(void) : ParserInternal::VisitorForSmlListEntry(), ehzConfigDefinition(EhzInternal::ehzConfigDefinitionNULL), allMeasuredValuesForOneEhz(&emdaDummy) {}
-			// Hide copy constructor. Avoid subtle problems with reference members
-			//lint --e(1704) --e(1738)
-			// 1704 Constructor 'Symbol' has private access specification
-			//1738 non-copy constructor 'Symbol' used to initialize copy constructor
-			SmlListEntryEvaluation(const SmlListEntryEvaluation &) : ParserInternal::VisitorForSmlListEntry(), ehzConfigDefinition(EhzInternal::ehzConfigDefinitionNULL), allMeasuredValuesForOneEhz(&emdaDummy) {}
-			// Hide assignment operator. Avoid subtle problems with reference members
-			//lint --e(1704) --e(1529)
-			// 1704 Constructor 'Symbol' has private access specification
-			// 1529 Symbol 'Symbol' not first checking for assignment to this
-			const SmlListEntryEvaluation &operator=(const SmlListEntryEvaluation &) { return *this; }
-
-	};
-
-
-}
-
-
- 
-
-#endif
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+// 
+// parsetreevisitor.hpp
+//
+// Special Visitor for evaluation of an SmlListEntry
+//
+// Please refer also to parser.hpp/cpp
+// After the parser has successfully read a SML File, a parse tree with all information
+// regarding that file is available. That tree will be traversed. All needed information
+// will be extracted. This is done using the visitor pattern. And the following class
+// gets all important information for a Ehz
+//
+
+
+
+#ifndef PARSETREEVISITOR_HPP
+#define PARSETREEVISITOR_HPP
+
+#include "ehzconfig.hpp"
+#include "ehzmeasureddata.hpp"
+#include "parser.hpp"
+#include "observer.hpp"
+
+#include <vector>
+
+ 
+ 
+
+namespace ParserInternal
+{
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------
+// 1. Lookup index for the OBIS values of one EHZ
+
+	// For each SmlListEntry we need to know, if we are interested in its value. The OBIS IDs of all configured
+	// values of an EHZ are stored in a sorted index. This is built once. The search is then a binary search
+	// over integers, independent of the position of the value in the configuration
+	class ObisIndex
+	{
+		public:
+			explicit ObisIndex(const EhzConfigDefinition &ecd);
+			virtual ~ObisIndex(void) {}
+			
+			// Get the index of the measured value for the OBIS ID. NumberOfEhzMeasuredData, if not found
+			uint find(const SmlByteStringView &obis) const;
+			// Convert the OBIS ID to an integer
+			static u64 getKey(const EhzDatabyte *const obis);
+		protected:
+			// One configured value
+			struct ObisIndexEntry
+			{
+				ObisIndexEntry(const u64 k, const uint i) : key(k), indexEhzMeasuredData(i) {}
+				boolean operator < (const ObisIndexEntry &other) const { return key < other.key; }
+				u64 key;					// The 6 bytes OBIS ID in one integer
+				uint indexEhzMeasuredData;	// Index in the configuration and in the measured values
+			};
+			// Sorted by key
+			std::vector<ObisIndexEntry> obisIndexEntries;
+	};
+
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------
+// 2. Definition of visitor class to get all values of one EHZ
+	
+	// The class can be used to traverse a complete parse tree or as streaming visitor of the parser.
+	// In the latter case the SmlPublicOpenResponse at the beginning of a SML file is used to clear
+	// the values of the previous SML file
+	// Values configured for early publication are announced to the subscribers as soon as they are stored
+	class SmlListEntryEvaluation : public ParserInternal::VisitorForSmlListEntry,
+								   public Visitor<ParserInternal::SmlPublicOpenResponse>,
+								   public Publisher<SmlListEntryEvaluation>,
+								   public ParserInternal::SmlListEntryFilter
+	{
+		public:
+			// Explicit constructor for this class.
+			// Set references to Ehz properties and the array where the result will be stored
+			explicit SmlListEntryEvaluation(const EhzConfigDefinition &ecd, EhzInternal::AllMeasuredValuesForOneEhz *const emd);
+			virtual ~SmlListEntryEvaluation(void)  {}	// Empty virtual destructor
+			
+			// Overwrite for the visit function of the parent class
+			// You need to understand the visitor pattern first. Please search the internet.
+			// This visit function will be called, if the element in the parse tree is a SmlListEntry
+			// It will then extract the values from the parse tree and store it in the EHZ - System
+			// This is the function that acts as an interface between parsed values and the Ehz - System
+			// for further data processing
+			virtual void visit(ParserInternal::SmlListEntry &smlListEntry);
+			// A new SML file starts with a SmlPublicOpenResponse. Forget old values. Start an OBIS discovery, if requested
+			virtual void visit(ParserInternal::SmlPublicOpenResponse &);
+			// Skip mode of the parser: Only configured values are needed. In debug mode all OBIS IDs are shown
+			virtual boolean isNeeded(const SmlByteStringView &objName) const;
+
+			void clear(void) {allMeasuredValuesForOneEhz->clear();}
+			// Store the values of the next SML files here. The values announced early have been handed over with the SML file
+			void setMeasuredValues(EhzInternal::AllMeasuredValuesForOneEhz *const emd) { allMeasuredValuesForOneEhz = emd; earlyValuesAreAnnounced = false; }
+			
+			// Early publication. During the notification: The index of the new value, or NumberOfEhzMeasuredData,
+			// if the SML file is invalid and the values announced before must be discarded
+			uint getEarlyValueIndex(void) const { return earlyValueIndex; }
+			const EhzInternal::OneMeasuredValueForOneEhz &getEarlyValue(void) const { return allMeasuredValuesForOneEhz->measuredValueForOneEhz[earlyValueIndex]; }
+			uint getEhzIndex(void) const { return ehzConfigDefinition.index; }
+			// The SML file could not be parsed. Inform the subscribers, if values have been announced
+			void discardEarlyValues(void);
+		protected:
+			// Reference to the properties of the Ehz. We need to know these in order to be 
+			// able to interpret all values correctly for this specific Ehz
+			//lint --e(1725)		class member 'Symbol' is a reference
+			const EhzConfigDefinition &ehzConfigDefinition;
+			
+			// Find the configured value for an OBIS ID
+			ObisIndex obisIndex;
+			
+			// This functions reads measured values from the parsed SML File. The values will be stored in 
+			// an array. There is an array for measured values for each Ehz in EhzSystem
+			//lint --e(1725)		class member 'Symbol' is a reference
+			EhzInternal::AllMeasuredValuesForOneEhz *allMeasuredValuesForOneEhz;
+			
+			// Value for the actual notification
+			uint earlyValueIndex;
+			// Values have been announced for the SML file, that is just parsed
+			boolean earlyValuesAreAnnounced;
+			// The OBIS IDs of the SML file, that is just parsed, are collected
+			boolean isDiscoveringObis;
+			// Value of globalObisDiscoveryRequest, when the last discovery started
+			u32 handledObisDiscoveryRequest;
+			
+		private:
+			// Standard constructor. Must not be used. Hence --> private
+			//lint --e(1704)  // 1704 Constructor 'Symbol' has private access specification
+			SmlListEntryEvaluation(void) : ParserInternal::VisitorForSmlListEntry(), Visitor<ParserInternal::SmlPublicOpenResponse>(), Publisher<SmlListEntryEvaluation>(), ParserInternal::SmlListEntryFilter(), ehzConfigDefinition(EhzInternal::ehzConfigDefinitionNULL), obisIndex(EhzInternal::ehzConfigDefinitionNULL), allMeasuredValuesForOneEhz(&emdaDummy), earlyValueIndex(NumberOfEhzMeasuredData), earlyValuesAreAnnounced(false), isDiscoveringObis(false), handledObisDiscoveryRequest(null<u32>()) {}
+			// Hide copy constructor. Avoid subtle problems with reference members
+			//lint --e(1704) --e(1738)
+			// 1704 Constructor 'Symbol' has private access specification
+			//1738 non-copy constructor 'Symbol' used to initialize copy constructor
+			SmlListEntryEvaluation(const SmlListEntryEvaluation &) : ParserInternal::VisitorForSmlListEntry(), Visitor<ParserInternal::SmlPublicOpenResponse>(), Publisher<SmlListEntryEvaluation>(), ParserInternal::SmlListEntryFilter(), ehzConfigDefinition(EhzInternal::ehzConfigDefinitionNULL), obisIndex(EhzInternal::ehzConfigDefinitionNULL), allMeasuredValuesForOneEhz(&emdaDummy), earlyValueIndex(NumberOfEhzMeasuredData), earlyValuesAreAnnounced(false), isDiscoveringObis(false), handledObisDiscoveryRequest(null<u32>()) {}
+			// Hide assignment operator. Avoid subtle problems with reference members
+			//lint --e(1704) --e(1529)
+			// 1704 Constructor 'Symbol' has private access specification
+			// 1529 Symbol 'Symbol' not first checking for assignment to this
+			const SmlListEntryEvaluation &operator=(const SmlListEntryEvaluation &) { return *this; }
+
+	};
+
+
+}
+
+
+ 
+
+#endif
@@ -123,6 +123,13 @@
 
 	namespace ScannerInternal
 	{
+		// Selection of the ESC analyzer. The table driven version is the default.
+		// The state pattern based class can be activated as reference with -DESC_ANALYSIS_REFERENCE
+#ifdef ESC_ANALYSIS_REFERENCE
+		typedef EscAnalysis EscAnalysisEngine;
+#else
+		typedef EscAnalysisTableDriven EscAnalysisEngine;
+#endif
 
 		// Design pattern state is used
 		//
@@ -141,7 +148,7 @@
 			virtual ~ScannerContextData(void) {}
 		    
 			EscAnalysisResult::Code escAnalysisResultCode;	// Result of EsCAnalysis
-			EscAnalysis escAnalysis;						// The ESC sequence analyzer
+			EscAnalysisEngine escAnalysis;					// The ESC sequence analyzer
 
 			TokenLength ehzDatabyteReadLoopCounter;			// Number of bytes to read for a type
 
@@ -151,7 +158,9 @@
 			s64 s64TempSignedInteger;						// Temp for building up s64 from bytes
 			u64 u64TempUnsignedInteger;						// Temp for building up u64 from bytes
 			boolean isFirstSignedIntegerByte;					// Needed for correct handlign of sign bit
+			boolean isSkippingOctetContent;					// Octet strings are checked, but their bytes are not stored
 
+			SmlOctetBuffer octetBuffer;						// Storage for all octet strings of one SML file
 			Token token;									// Token that is produced by scanner
 		};
 		
@@ -165,8 +174,10 @@
               s64TempSignedInteger(0LL),
               u64TempUnsignedInteger(0ULL),
               isFirstSignedIntegerByte(true),
+              isSkippingOctetContent(false),
+              octetBuffer(),
               token()
-		{}
+		{ token.setOctetBuffer(&octetBuffer); }
               
 
 
@@ -209,6 +220,18 @@
 			// Main "working" function for the outer world
 			const Token &scan(const EhzDatabyte ehzDatabyte);
 			
+			// Look ahead in a block of data. Get the number of following net data bytes for which
+			// no ESC analysis is necessary. Those bytes must then be given to "scanPayload"
+			size_t analysePayload(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes) { return scd.escAnalysis.analysePayload(ehzDatabytes, numberOfBytes); }
+			// Number of ESC frames and checksum errors
+			const EscAnalysisStatistics &getEscAnalysisStatistics(void) const { return scd.escAnalysis.getEscAnalysisStatistics(); }
+			// Scan a net data byte for which ESC analysis has already been done by "analysePayload"
+			const Token &scanPayload(const EhzDatabyte ehzDatabyte);
+			// Interface compatibility with the switch based scanner. Scans always exactly one byte
+			const Token &scanPayloadBlock(const EhzDatabyte *const ehzDatabytes, const size_t, size_t &numberOfScannedBytes) { numberOfScannedBytes = 1U; return scanPayload(*ehzDatabytes); }
+			// Skip mode of the parser. The content of the next octet strings is not needed. The token has an empty value
+			void setSkippingOctetContent(const boolean isSkippingOctetContent) { scd.isSkippingOctetContent = isSkippingOctetContent; }
+			
 			void reset(void); 
 		protected:
 
@@ -288,22 +311,43 @@
 		}
 		//lint -restore
 		
+		// What has to be done after a TL byte has been read. The state pattern based scanner
+		// calls a handler function. The switch based scanner uses this code. There is one code
+		// for each handler function
+		struct TlByteAction
+		{
+			enum Code
+			{
+				Basic,
+				Optional,
+				BasicReset,
+				Octet,
+				Boolean,
+				SignedInteger,
+				UnsignedInteger,
+				MultiByteOctet,
+				MultiByteList
+			};
+		};
+
 		// TL Byte Analysis using a jump table.
 		// All possible TL-Bytes (Max 256 different values) will be handled with a tabular approach
 		class TlByteAnalysis : public ScannerBaseState
 		{  
 			public:  
 				virtual ScannerBaseState* scan(const EhzDatabyte ehzDatabyte, ScannerContextData &scd); 
-			protected:
+
 				// The Table declaration
 				struct TLBT
 				{
 					Token::TokenType tokenType;	// Token type (depending on TL byte)
 					TokenLength tokenLength;	// Token length (depending on TL byte)
 					ScannerBaseState* (*handleTlByte)(ScannerContextData &scd);
+					TlByteAction::Code tlByteAction;	// Same as handleTlByte, for the switch based scanner
 				};
-				// Table definition
+				// Table definition. Used also by the switch based scanner
 				static const TLBT tlbt[256];
+			protected:
 				
 				// Handling functions used in the table
 				static ScannerBaseState* handleTlByteBasic(ScannerContextData &scd);
@@ -393,6 +437,24 @@ inline const Token &Scanner::scan(const EhzDatabyte ehzDatabyte)
 {
 	// Check for potential ESC Sequence
 	scd.escAnalysisResultCode = scd.escAnalysis.analyse(ehzDatabyte);
+	// An ESC-Start sequence cannot be net data. If the previous SML file was incomplete, the next one begins anyway
+	if (EscAnalysisResult::ESC_ANALYSIS_RESULT_START == scd.escAnalysisResultCode)
+	{
+		currentState = ScannerInternal::ScannerBaseState::getInstance<ScannerInternal::ScannerStateIdle>();
+	}
+
+	// The main state machine. Read bytes and produce tokens
+	currentState = currentState->scan(ehzDatabyte, scd);
+
+	// Return the found token
+	return scd.token;
+}
+
+// Net data byte. ESC analysis was already done
+inline const Token &Scanner::scanPayload(const EhzDatabyte ehzDatabyte)
+{
+	// Result of ESC analysis is known
+	scd.escAnalysisResultCode = EscAnalysisResult::ESC_CONDITION_WAITING;
 
 	// The main state machine. Read bytes and produce tokens
 	currentState = currentState->scan(ehzDatabyte, scd);
@@ -401,6 +463,113 @@ inline const Token &Scanner::scan(const EhzDatabyte ehzDatabyte)
 	return scd.token;
 }
 
+
+
+// ----------------------------------------------------------------------------------------------------------------------------------
+// 5. Switch based scanner
+// ----------------------------------------------------------------------------------------------------------------------------------
+
+// The state pattern based scanner above is the reference implementation. For every byte it needs
+// a virtual function call and, for TL bytes, an additional call via a function pointer.
+//
+// "ScannerSwitchBased" implements the identical state machine with a state enum and one switch
+// statement. The TL bytes are decoded with the same lookup table. There are no virtual calls.
+//
+// Additionally, if all bytes of a fixed width integer or of an octet are available in a block
+// of net data (no ESC sequence in between), the value is read directly from the buffer with
+// "scanPayloadBlock". The resulting tokens are identical to the ones of the reference scanner.
+//
+// The scanner used by the parser is selected at compile time via the typedef "ScannerEngine"
+// The reference implementation can be activated with -DSCANNER_REFERENCE
+
+
+	namespace ScannerInternal
+	{
+		// States of the switch based scanner. Same meaning as the states in chapter 3
+		struct ScannerSwitchState
+		{
+			enum Code
+			{
+				Idle,					// ScannerStateIdle
+				AnalyzeTl,				// ScannerStateAnalyzeTl
+				ReadOctet,				// ScannerStateReadOctet
+				ReadMultiByteOctet,		// ScannerStateReadMultiByteOctet
+				ReadBoolean,			// ScannerStateReadBoolean
+				ReadSignedInteger,		// ScannerStateReadSignedInteger
+				ReadUnsignedInteger,	// ScannerStateReadUnsignedInteger
+				ReadMultiByteList		// ScannerStateReadMultiByteList
+			};
+		};
+	} // end of namespace ScannerInternal
+
+
+	class ScannerSwitchBased
+	{
+		public:
+			ScannerSwitchBased(void) : currentState(ScannerInternal::ScannerSwitchState::Idle), scd() {}
+			virtual ~ScannerSwitchBased(void) {}
+
+			// Main "working" function for the outer world
+			const Token &scan(const EhzDatabyte ehzDatabyte);
+			
+			// Look ahead in a block of data. Same as in the reference scanner
+			size_t analysePayload(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes) { return scd.escAnalysis.analysePayload(ehzDatabytes, numberOfBytes); }
+			// Number of ESC frames and checksum errors
+			const EscAnalysisStatistics &getEscAnalysisStatistics(void) const { return scd.escAnalysis.getEscAnalysisStatistics(); }
+			// Scan a net data byte for which ESC analysis has already been done by "analysePayload"
+			const Token &scanPayload(const EhzDatabyte ehzDatabyte);
+			// Scan net data from a block. If the value of the current token is completely in the block,
+			// then it will be read at once. Else one byte is scanned. All scanned bytes but the last one
+			// did not produce a token. 
+			const Token &scanPayloadBlock(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes, size_t &numberOfScannedBytes);
+			// Skip mode of the parser. Same as in the reference scanner
+			void setSkippingOctetContent(const boolean isSkippingOctetContent) { scd.isSkippingOctetContent = isSkippingOctetContent; }
+			
+			void reset(void) { currentState = ScannerInternal::ScannerSwitchState::Idle; scd.escAnalysis.reset(); }
+		protected:
+			// The state machine
+			void scanDatabyte(const EhzDatabyte ehzDatabyte);
+			// Handling of a TL byte
+			void analyzeTlByte(const EhzDatabyte ehzDatabyte);
+			
+			// Current state of the state machine
+			ScannerInternal::ScannerSwitchState::Code currentState;
+
+			// Same common context data as for the reference scanner
+			ScannerInternal::ScannerContextData scd;
+	};
+
+
+	// Main "worker" function
+	inline const Token &ScannerSwitchBased::scan(const EhzDatabyte ehzDatabyte)
+	{
+		// Check for potential ESC Sequence
+		scd.escAnalysisResultCode = scd.escAnalysis.analyse(ehzDatabyte);
+		// Same as in the reference scanner: An ESC-Start sequence always begins a new SML file
+		if (EscAnalysisResult::ESC_ANALYSIS_RESULT_START == scd.escAnalysisResultCode)
+		{
+			currentState = ScannerInternal::ScannerSwitchState::Idle;
+		}
+		scanDatabyte(ehzDatabyte);
+		return scd.token;
+	}
+
+	// Net data byte. ESC analysis was already done
+	inline const Token &ScannerSwitchBased::scanPayload(const EhzDatabyte ehzDatabyte)
+	{
+		scd.escAnalysisResultCode = EscAnalysisResult::ESC_CONDITION_WAITING;
+		scanDatabyte(ehzDatabyte);
+		return scd.token;
+	}
+
+
+	// Selection of the scanner for the parser
+#ifdef SCANNER_REFERENCE
+	typedef Scanner ScannerEngine;
+#else
+	typedef ScannerSwitchBased ScannerEngine;
+#endif
+
  
 
 
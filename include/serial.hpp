@@ -1,196 +1,437 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-// serial.hpp
-//
-// General Description
-//
-// This module is a part of an application tor read the data from Electronic Meters for Electric Power
-//
-// In Germany they are called EHZ. Hence the name of the module an variables.
-//
-// The EHZ transmits data via an infrared interface. The protocoll is described in:
-//
-//  http://www.emsycon.de/downloads/SML_081112_103.pdf
-//
-// All this is done via a standard serial RS232 optical interface
-// Here we have some basic classes to handle a serial port
-//
-
-
-#ifndef SERIAL_HPP
-#define SERIAL_HPP
-
-#include "mytypes.hpp"
-
-#include "eventhandler.hpp"
-#include "observer.hpp"
-
-#include <termios.h>
-
-#include <string>
-
-
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 1. Setting Serial Port Parameters
-
-
-namespace SerialInternal
-{
-
-	// --------------------------------------------------------------
-	// 1.1 General
-
-
-	// Helper Class for setting parameters for a serial port
-	// Abstract base class
-	// Handle must be present. So file is already open. FCNTL functions can be used to change behaviour
-	class SerialPortParameter
-	{
-		public:
-			// Initialize class. Copy handle
-			explicit SerialPortParameter(const Handle handleSerialPort);
-			// Empty ctor
-			virtual ~SerialPortParameter(void) {}
-
-			// Check if everything is OK
-			boolean isOK(void) const { return(ok); }
-			
-		protected:
-			// Set the specific data. Pure virtual function. Define specific attributes in derived class.
-			virtual void setSerialPortParameter(void) = 0;	
-
-			// Data struct needed to set attributes
-			struct termios serialOptions;
-			// Internal check, if everything worked well
-			boolean ok;
-			// Copy of file handle
-			Handle handle;
-			
-		private:
-			// Default constructors set handle to 0. Use initialize to set handle afterwards
-			SerialPortParameter(void) : serialOptions() , ok(false), handle(null<Handle>())	{}
-	};
-
-	// --------------------------------------------------------------
-	// 1.2 EHZ Specific
-	
-	
-	
-	// Concrete implementation for Serial Port Parameters for an EHZ
-	class EhzSerialPortParameter : public SerialPortParameter
-	{
-		public:
-			// Construct and initialize class
-			//lint -e{1933,1506}
-			//Note 1933: Call to unqualified virtual function 'SerialInternal::EhzSerialPortParameter::setSerialPortParameter(void)' from non-static member function
-			//Warning 1506: Call to virtual function 'SerialInternal::EhzSerialPortParameter::setSerialPortParameter(void)' within a constructor or destructor [MISRA C++ Rule 12-1-1], ---    Eff. C++ 3rd Ed. item 9
-			explicit EhzSerialPortParameter(const Handle xhandle) : SerialPortParameter(xhandle) { setSerialPortParameter();}
-			// Empty dtor
-			virtual ~EhzSerialPortParameter(void) {}
-
-		protected:
-			// Set EHZ specific serial port parameter
-			virtual void setSerialPortParameter(void);		
-		private:
-			// Default constructor. Do not use
-			EhzSerialPortParameter(void) : SerialPortParameter(0) {}
-	};
-
-	
-	
-	
-// ------------------------------------------------------------------------------------------------------------------------------
-// 2. Simple serial port class. Uses Reactor for Event Notification
-
-
-	// -------------------------------------------------------------------
-	// 2.2 General
-
-	// A serial port class. Implemented as event handler for the reactor
-	// Uses the device name of a serial port. Opens this device (serial port)
-	// and set attributes
-	class SerialPort : public CommunicationEndPoint
-	{
-		public:
-			// Standard constructor copies the name of the serial port (device)
-			explicit SerialPort(const std::string &pn) : CommunicationEndPoint(), portName(pn) {}
-			// Dtor
-			virtual ~SerialPort(void) { }
-
-			// Pure virtual function. Override this to open the desired serial port in the necessary way
-			virtual void start(void) = 0;
-		protected: 
-			// Copy of the physical port name (device)
-			std::string portName;
-			
-		private:
-			// Default ctor. Do not use
-			SerialPort(void) : CommunicationEndPoint(), portName() {}
-		
-	};
-
-	
-	// -------------------------------------------------------------------
-	// 2.3 Specific for EHZ
-	
-	// Has an Event Handler
-	// Is notfied by the Reactor that data is present
-	// Reads data from ersial port, byte by byte
-	// Notifies Subscribers that data is available and 
-	// provides data via one main interface function getLastReceivedByte
-	
-	
-	// Specific call for an EHZ serial port
-	class EhzSerialPort : public SerialPort, public Publisher<EhzSerialPort>
-	{
-		public:
-			// Standard constructor. Copy name of port (device)
-			explicit EhzSerialPort(const std::string &pn) : SerialPort(pn), Publisher<EhzSerialPort>(), databyte(null<EhzDatabyte>()){}		
-			// Empty dtor
-			virtual ~EhzSerialPort(void) {}
-
-			// Open serial port and set parameters
-			virtual void start(void);
-			// Event Handler for Reactor
-			virtual EventProcessing::Action handleEvent(const EventType et); 
-			
-			// Retrieve the last byte received by the SIO
-			virtual EhzDatabyte getLastReceivedByte(void) const { return databyte; }
-		protected:
-			// We will read the SIO byte by byte and store here the last read byte
-			EhzDatabyte databyte;
-			
-		private:
-			// Default ctor. Do not use
-			//lint -e{1901,1911}
-			//Note 1901: Creating a temporary of type 'const std::basic_string<char>'
-			//Note 1911: Implicit call of constructor 'std::basic_string<char>::basic_string(const char *, const std::allocator<char> &)' (see text)
-			EhzSerialPort(void) : SerialPort(""), Publisher<EhzSerialPort>(), databyte(null<EhzDatabyte>()) {}
-		
-	};
-
-}
-
- 
-
-#endif
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+// serial.hpp
+//
+// General Description
+//
+// This module is a part of an application tor read the data from Electronic Meters for Electric Power
+//
+// In Germany they are called EHZ. Hence the name of the module an variables.
+//
+// The EHZ transmits data via an infrared interface. The protocoll is described in:
+//
+//  http://www.emsycon.de/downloads/SML_081112_103.pdf
+//
+// All this is done via a standard serial RS232 optical interface
+// Here we have some basic classes to handle a serial port
+//
+// For load tests the raw data of a serial port can be recorded into a capture file. A capture file
+// can be replayed by an EhzReplayPort. It behaves like a serial port with a meter connected to it.
+// So many virtual meters can run on a desk without optical heads
+//
+// A meter may also be far away. Then a small device with the optical head forwards the raw byte stream
+// via TCP. The EhzNetworkPort connects to it and delivers the bytes like a serial port
+//
+
+
+#ifndef SERIAL_HPP
+#define SERIAL_HPP
+
+#include "mytypes.hpp"
+
+#include "eventhandler.hpp"
+#include "observer.hpp"
+#include "timerevent.hpp"
+
+#include <termios.h>
+
+#include <string>
+
+
+namespace AcceptorConnectorInternal
+{
+	class Connector;
+}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Setting Serial Port Parameters
+
+
+namespace SerialInternal
+{
+
+	// --------------------------------------------------------------
+	// 1.1 General
+
+
+	// Helper Class for setting parameters for a serial port
+	// Abstract base class
+	// Handle must be present. So file is already open. FCNTL functions can be used to change behaviour
+	class SerialPortParameter
+	{
+		public:
+			// Initialize class. Copy handle
+			explicit SerialPortParameter(const Handle handleSerialPort);
+			// Empty ctor
+			virtual ~SerialPortParameter(void) {}
+
+			// Check if everything is OK
+			boolean isOK(void) const { return(ok); }
+			
+		protected:
+			// Set the specific data. Pure virtual function. Define specific attributes in derived class.
+			virtual void setSerialPortParameter(void) = 0;	
+
+			// Data struct needed to set attributes
+			struct termios serialOptions;
+			// Internal check, if everything worked well
+			boolean ok;
+			// Copy of file handle
+			Handle handle;
+			
+		private:
+			// Default constructors set handle to 0. Use initialize to set handle afterwards
+			SerialPortParameter(void) : serialOptions() , ok(false), handle(null<Handle>())	{}
+	};
+
+	// --------------------------------------------------------------
+	// 1.2 EHZ Specific
+	
+	// There are 2 profiles for the serial port of an EHZ:
+	// Standard: Every chunk of bytes from the driver wakes up the reader and is handed over to the parser at once
+	// Low latency: The driver pushes received bytes without delay. Poll reports data only, when VMIN bytes are there.
+	// The rest of a frame is read, when the line has been idle for the frame gap. Meters send a frame and then pause
+	// for about a second. So the idle line marks the end of a frame and the whole frame is handed over in one notification
+	
+	// 9600 baud with 8N1 are 10 bits per byte
+	const u32 SerialBytesPerSecond = 960U;
+	
+	// Concrete implementation for Serial Port Parameters for an EHZ
+	class EhzSerialPortParameter : public SerialPortParameter
+	{
+		public:
+			// Construct and initialize class. A frame gap of 0 is the standard profile, else low latency
+			//lint -e{1933,1506}
+			//Note 1933: Call to unqualified virtual function 'SerialInternal::EhzSerialPortParameter::setSerialPortParameter(void)' from non-static member function
+			//Warning 1506: Call to virtual function 'SerialInternal::EhzSerialPortParameter::setSerialPortParameter(void)' within a constructor or destructor [MISRA C++ Rule 12-1-1], ---    Eff. C++ 3rd Ed. item 9
+			explicit EhzSerialPortParameter(const Handle xhandle, const u32 frameGapInMsl = null<u32>()) : SerialPortParameter(xhandle), frameGapInMs(frameGapInMsl) { setSerialPortParameter();}
+			// Empty dtor
+			virtual ~EhzSerialPortParameter(void) {}
+
+		protected:
+			// Set EHZ specific serial port parameter
+			virtual void setSerialPortParameter(void);		
+			// Low latency profile: VMIN, the low latency flag of the driver and non blocking reads
+			void setLowLatencyProfile(void);
+			
+			const u32 frameGapInMs;
+		private:
+			// Default constructor. Do not use
+			EhzSerialPortParameter(void) : SerialPortParameter(0), frameGapInMs(null<u32>()) {}
+	};
+
+	
+	
+	
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Simple serial port class. Uses Reactor for Event Notification
+
+
+	// -------------------------------------------------------------------
+	// 2.2 General
+
+	// A serial port class. Implemented as event handler for the reactor
+	// Uses the device name of a serial port. Opens this device (serial port)
+	// and set attributes
+	class SerialPort : public CommunicationEndPoint
+	{
+		public:
+			// Standard constructor copies the name of the serial port (device)
+			explicit SerialPort(const std::string &pn) : CommunicationEndPoint(), portName(pn) {}
+			// Dtor
+			virtual ~SerialPort(void) { }
+
+			// Pure virtual function. Override this to open the desired serial port in the necessary way
+			virtual void start(void) = 0;
+		protected: 
+			// Copy of the physical port name (device)
+			std::string portName;
+			
+		private:
+			// Default ctor. Do not use
+			SerialPort(void) : CommunicationEndPoint(), portName() {}
+		
+	};
+
+	
+	// -------------------------------------------------------------------
+	// 2.3 Specific for EHZ
+	
+	// Has an Event Handler
+	// Is notfied by the Reactor that data is present
+	// Reads data from serial port, either byte by byte or all available bytes at once
+	// Notifies Subscribers that data is available and 
+	// provides data via the interface functions getLastReceivedByte and getLastReceivedBytes
+	
+	
+	// The serial port may be read in 2 different ways
+	struct SerialReadMode
+	{
+		enum Code
+		{
+			SingleByte,		// One read call and one notification per byte
+			Block			// Drain all available data into the receive buffer. One notification per read call
+		};
+	};
+	
+	// Capture file with the raw data of a serial port
+	//
+	// File header: the 8 characters "EHZCAP01"
+	// Then one record for each read call: time (u64, ns, CLOCK_MONOTONIC), number of bytes (uint, 4 bytes), the bytes
+	// Numbers are stored in the byte order of the machine, that made the capture
+	const mchar CaptureFileMagic[] = "EHZCAP01";
+	const size_t CaptureFileHeaderSize = sizeof(CaptureFileMagic) - 1U;
+	const size_t CaptureRecordHeaderSize = sizeof(u64) + sizeof(uint);
+	
+	// Size of the receive ring buffer of one serial port. At 9600 baud this is much more than what
+	// arrives between 2 calls of the event handler. The low latency profile collects a whole frame in it
+	const size_t SerialReceiveBufferSize = 2048U;
+	// If less than this is left at the end of the ring buffer, then the next read starts at the beginning
+	const size_t SerialReceiveBufferMinimumReadSize = 128U;
+	
+	
+	// Specific call for an EHZ serial port
+	// The timer is the frame gap timer of the low latency profile
+	class EhzSerialPort : public SerialPort, public Publisher<EhzSerialPort>, public Subscriber<EventTimer>
+	{
+		public:
+			// Standard constructor. Copy name of port (device)
+			explicit EhzSerialPort(const std::string &pn, const SerialReadMode::Code srm = SerialReadMode::Block) : SerialPort(pn), Publisher<EhzSerialPort>(), Subscriber<EventTimer>(), databyte(null<EhzDatabyte>()), 
+								serialReadMode(srm), receiveBufferWriteIndex(null<size_t>()), lastReceivedBytesStartIndex(null<size_t>()), numberOfLastReceivedBytes(null<size_t>()),
+								captureFileName(), captureHandle(null<Handle>()), frameGapInMs(null<u32>()), frameGapTimer(null<u32>()), frameGapTimerIsRunning(false),
+								frameStartIndex(null<size_t>()), numberOfFrameBytes(null<size_t>()), lastReadTimeInNs(null<u64>()) {}		
+			// Close the capture file
+			virtual ~EhzSerialPort(void);
+
+			// Open serial port and set parameters
+			virtual void start(void);
+			// Close serial port and capture file
+			virtual void stop(void);
+			// Event Handler for Reactor
+			virtual EventProcessing::Action handleEvent(const EventType et); 
+			
+			// Retrieve the last byte received by the SIO
+			virtual EhzDatabyte getLastReceivedByte(void) const { return databyte; }
+			// Retrieve all bytes received by the last read call. Returns a pointer into the receive buffer
+			// The data is valid until the next call of the event handler
+			virtual const EhzDatabyte *getLastReceivedBytes(size_t &numberOfBytes) const;
+			
+			// Select how the serial port will be read
+			void setSerialReadMode(const SerialReadMode::Code srm) { serialReadMode = srm; }
+			// Record all received data in this file. Takes effect with the next start. Data are appended
+			void setCaptureFileName(const std::string &cfn) { captureFileName = cfn; }
+			// Low latency profile with this frame gap. 0: Standard profile. Takes effect with the next start. Only for block reads
+			void setFrameGap(const u32 frameGapInMsl) { frameGapInMs = frameGapInMsl; }
+			
+			// The frame gap timer expired. Deliver the frame, if the line is still idle
+			virtual void update(EventTimer *publisher);
+		protected:
+			// Open the capture file, if a name has been set. A new file gets the file header
+			void openCaptureFile(void);
+			// Read all available bytes into the ring buffer, capture and notify. Returns the result of the read call
+			// With the low latency profile, subscribers are notified only, when the frame is complete
+			ssize_t readBlock(void);
+			// Read all available bytes into the ring buffer and capture them. Returns the result of the read call
+			ssize_t readIntoReceiveBuffer(void);
+			// Low latency profile. Hand over the collected bytes of the frame
+			void deliverFrame(void);
+			// Low latency profile. Hand over the first bytes of the frame. The rest stays as the start of the next frame
+			void deliverFrameUntil(const size_t numberOfBytes);
+			// Low latency profile. Number of frame bytes up to the last ESC end sequence, that has been completed
+			// by the bytes after the first numberOfBytesChecked. 0, if there is none
+			size_t findEndOfSmlFile(const size_t numberOfBytesChecked) const;
+			// Write the data of the last read call into the capture file
+			void captureLastReceivedBytes(void);
+			
+			// Store here the last read byte
+			EhzDatabyte databyte;
+			
+			// Byte by byte or block read
+			SerialReadMode::Code serialReadMode;
+			// Ring buffer for block reads
+			EhzDatabyte receiveBuffer[SerialReceiveBufferSize];
+			// Position in ring buffer for the next read call
+			size_t receiveBufferWriteIndex;
+			// Span of the data received with the last read call
+			size_t lastReceivedBytesStartIndex;
+			size_t numberOfLastReceivedBytes;
+			
+			// Optional recording of the received data. Null handle, if nothing is recorded
+			std::string captureFileName;
+			Handle captureHandle;
+			
+			// Low latency profile. The bytes of a frame are collected in the ring buffer until the ESC end sequence
+			// of the SML file has been received. Or, if it is never seen, until the line is idle
+			u32 frameGapInMs;
+			EventTimer frameGapTimer;
+			boolean frameGapTimerIsRunning;
+			size_t frameStartIndex;
+			size_t numberOfFrameBytes;
+			u64 lastReadTimeInNs;
+			
+		private:
+			// Default ctor. Do not use
+			//lint -e{1901,1911}
+			//Note 1901: Creating a temporary of type 'const std::basic_string<char>'
+			//Note 1911: Implicit call of constructor 'std::basic_string<char>::basic_string(const char *, const std::allocator<char> &)' (see text)
+			EhzSerialPort(void) : SerialPort(""), Publisher<EhzSerialPort>(), Subscriber<EventTimer>(), databyte(null<EhzDatabyte>()),
+								serialReadMode(SerialReadMode::Block), receiveBufferWriteIndex(null<size_t>()), lastReceivedBytesStartIndex(null<size_t>()), numberOfLastReceivedBytes(null<size_t>()),
+								captureFileName(), captureHandle(null<Handle>()), frameGapInMs(null<u32>()), frameGapTimer(null<u32>()), frameGapTimerIsRunning(false),
+								frameStartIndex(null<size_t>()), numberOfFrameBytes(null<size_t>()), lastReadTimeInNs(null<u64>()) {}
+		
+	};
+	
+	
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Replay of a capture file. A virtual meter
+
+	// The capture file is mapped into memory. A timerfd is the handle for the reactor. It expires, when the next
+	// record is due. Subscribers get the bytes of one record per notification, exactly like from a serial port.
+	// At the end of the file the replay starts again from the beginning
+	
+	// Speed of a replay. Other values N: N times faster than real time
+	const u32 ReplaySpeedAsFastAsPossible = 0U;
+	const u32 ReplaySpeedRealTime = 1U;
+	// Maximum number of records per event. So other event handlers get their turn, even if the replay runs flat out
+	const uint ReplayMaximumNumberOfRecordsPerEvent = 16U;
+	
+	class EhzReplayPort : public EhzSerialPort
+	{
+		public:
+			// The name of the capture file is used as port name
+			EhzReplayPort(const std::string &captureFileNameForReplay, const u32 rs);
+			// Unmap the capture file
+			virtual ~EhzReplayPort(void);
+
+			// Map the capture file and start the timer
+			virtual void start(void);
+			// Stop the timer and unmap the capture file
+			virtual void stop(void);
+			// Timer expired. Hand over all records, that are due
+			virtual EventProcessing::Action handleEvent(const EventType et); 
+			// Points into the mapped capture file
+			virtual const EhzDatabyte *getLastReceivedBytes(size_t &numberOfBytes) const;
+			
+		protected:
+			// Get the header of the record at the read position. False, if there is no complete record
+			boolean readRecordHeader(u64 &recordTimeInNs, uint &numberOfBytes) const;
+			// Time, when a record has to be handed over
+			u64 getDueTimeInNs(const u64 recordTimeInNs) const;
+			// Start again with the first record
+			void rewind(void);
+			// Set the timerfd to the due time of the record at the read position
+			void setTimerForNextRecord(void);
+			
+			// 1 is real time. See above
+			u32 replaySpeed;
+			// The mapped capture file
+			const EhzDatabyte *capture;
+			size_t captureSize;
+			// Position of the next record in the capture file
+			size_t readPosition;
+			// Time of the first record and the time, when it was replayed
+			u64 firstRecordTimeInNs;
+			u64 replayStartTimeInNs;
+			// Bytes of the record that has been handed over last
+			const EhzDatabyte *lastReceivedBytes;
+			
+		private:
+			// Default ctor. Do not use
+			EhzReplayPort(void);
+			EhzReplayPort(const EhzReplayPort &);
+			EhzReplayPort &operator =(const EhzReplayPort &);
+	};
+
+	
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. Meter attached via the network
+
+	// The Connector makes the TCP connection. Then the socket is the handle of the network port and the received
+	// bytes go through the ring buffer to the subscribers, exactly like the bytes of a serial port.
+	// A failed connect or a lost connection is tried again after a delay. The delay is doubled with every attempt
+	// up to a maximum. It starts again with the minimum, when data is received. The timer for the delay
+	// is also the timeout for a connect, that hangs
+	// A connection that delivers nothing is seen as lost. A meter sends a file every few seconds. So if no byte comes
+	// in between two checks of the idle timer, the connection is closed and made again. This finds a remote end, that
+	// hangs or a half open connection. TCP keep alive additionally finds a dead peer, when the connection is idle anyway
+	
+	const u32 NetworkReconnectMinimumDelayInMs = 1000U;
+	const u32 NetworkReconnectMaximumDelayInMs = 60000U;
+	const u32 NetworkReceiveIdleTimeoutInMs = 30000U;
+	const sint NetworkKeepAliveIdleInS = 10;
+	const sint NetworkKeepAliveIntervalInS = 5;
+	const sint NetworkKeepAliveProbes = 3;
+	
+	// The reconnect timer is handled in the update function of the EhzSerialPort for its timers
+	class EhzNetworkPort : public EhzSerialPort,
+						   public Subscriber<AcceptorConnectorInternal::Connector>
+	{
+		public:
+			// Remote host and port (name or number)
+			EhzNetworkPort(const std::string &hostName, const std::string &portNameOrNumber);
+			virtual ~EhzNetworkPort(void);
+
+			// Start connecting. The handle stays null, until the connection has been made
+			virtual void start(void);
+			// Close the connection and the capture file. No more reconnects
+			virtual void stop(void);
+			// Data received or connection lost
+			virtual EventProcessing::Action handleEvent(const EventType et); 
+			
+			// The connector made the connection. Take over the socket
+			virtual void update(AcceptorConnectorInternal::Connector *publisher);
+			// Connect timeout, reconnect delay expired or receive idle check. Other timers are handled by the EhzSerialPort
+			virtual void update(EventTimer *publisher);
+			
+		protected:
+			// Start a connect and the timer for the next attempt
+			void connect(void);
+			// Close the socket and wait for the reconnect
+			void disconnect(void);
+			// Let the kernel probe an idle connection
+			void setKeepAlive(void);
+			
+			// The connector keeps references to these strings. So they are defined before the connector
+			std::string networkHostName;
+			std::string networkPortNameOrNumber;
+			AcceptorConnectorInternal::Connector *connector;
+			EventTimer reconnectTimer;
+			u32 reconnectDelayInMs;
+			// Periodic check, if something has been received since the last check
+			EventTimer receiveIdleTimer;
+			boolean dataReceivedSinceIdleCheck;
+			// Between start and stop. The handle is null, while the port is connecting
+			boolean started;
+			
+		private:
+			// Default ctor. Do not use
+			EhzNetworkPort(void);
+			EhzNetworkPort(const EhzNetworkPort &);
+			EhzNetworkPort &operator =(const EhzNetworkPort &);
+	};
+
+}
+
+ 
+
+#endif
@@ -0,0 +1,236 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// snapshotsegment.hpp
+//
+// General Description
+//
+// The latest published values of all EHZ in a POSIX shared memory segment. Local programs, like
+// a control daemon or an exporter, read the values directly from memory. No TCP connection and no text formatting.
+//
+// Layout of the segment:
+//  - A header with identification, the sizes of the structures and a generation counter
+//  - One block per EHZ. It starts with a sequence counter and contains all NumberOfEhzMeasuredData values
+//
+// There is one writer, the EhzSystem. Each block is protected by a sequence lock:
+// The writer makes the sequence odd, writes the values and makes the sequence even again.
+// A reader reads the sequence, reads the values and reads the sequence again. If the sequence was odd or has changed,
+// the values may be inconsistent and the reader must try again. The writer never waits for a reader.
+//
+// The generation counter in the header is incremented with every update of any EHZ. Polling readers
+// compare it with the last seen value, before they look into the blocks.
+//
+// A restarted writer uses the existing segment. It is never made smaller, because readers may still have it mapped.
+// Each writer increments the number of writer starts in the header. With another configuration the layout may have changed.
+// Long running readers check isStale and map the segment again.
+//
+// The reader is in an own library (libehzsnapshot.a). It needs only this header and mytypes.hpp
+//
+
+#ifndef SNAPSHOTSEGMENT_HPP
+#define SNAPSHOTSEGMENT_HPP
+
+#include "mytypes.hpp"
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General definitions
+
+	namespace SnapshotSegmentInternal
+	{
+		// Name of the shared memory object. It is found in /dev/shm
+		const mchar SnapshotSegmentName[] = "/ehzsnapshot";
+		
+		// The EhzSystem publishes the values into the segment
+		const boolean SnapshotSegmentIsActive = true;
+		
+		// Identification of the segment
+		// u32 is a long and has 64 bit on some targets. The layout uses uint for 32 bit fields
+		const uint SnapshotSegmentMagic = 0x535A4845U;			// "EHZS"
+		const uint SnapshotSegmentVersion = 1U;
+		
+		// Longer string values are truncated
+		const uint SnapshotTextLength = 32U;
+		
+		// One measured value. Fixed size of 64 bytes. Natural alignment, no padding
+		struct SharedSnapshotValue
+		{
+			s64 mantissa;						// Value = mantissa * 10^scaler
+			u64 status;							// Status information from the EHZ
+			mdouble doubleValue;				// The same as double
+			s8 scaler;
+			u8 unitIndex;						// Index into ObisUnitLookup. 0: No unit
+			u16 textLength;						// Number of bytes in text. 0 for numbers
+			uint reserved;
+			mchar text[SnapshotTextLength];		// String values. Not 0 terminated
+		};
+		
+		// All values of one EHZ. Starts with the sequence lock
+		struct SharedSnapshotEhz
+		{
+			u64 sequence;						// Odd, while the writer changes the block
+			s64 timeWhenDataHasBeenEvaluated;	// time_t of the values
+			u64 generation;						// Number of updates of this EHZ
+			u64 reserved[5];
+			SharedSnapshotValue value[NumberOfEhzMeasuredData];
+		};
+		
+		// Header of the segment. The blocks of the EHZ follow
+		struct SharedSnapshotHeader
+		{
+			uint magic;							// Written last. A reader must not use the segment before it is valid
+			uint version;
+			uint headerSize;
+			uint ehzSize;
+			uint valueSize;
+			uint numberOfEhz;
+			uint numberOfValues;				// Per EHZ. Always NumberOfEhzMeasuredData
+			uint reserved1;
+			u64 generation;						// Number of updates of all EHZ
+			u64 writerStarts;					// Incremented, when a writer initializes the segment
+			u64 reserved2[2];
+		};
+		
+		// The layout is shared with other programs. Check it at compile time
+		typedef char SharedSnapshotValueSizeCheck[(64U == sizeof(SharedSnapshotValue)) ? 1 : -1];
+		typedef char SharedSnapshotEhzSizeCheck[((64U + (NumberOfEhzMeasuredData * 64U)) == sizeof(SharedSnapshotEhz)) ? 1 : -1];
+		typedef char SharedSnapshotHeaderSizeCheck[(64U == sizeof(SharedSnapshotHeader)) ? 1 : -1];
+		
+		// Size of the complete segment
+		inline size_t getSnapshotSegmentSize(const uint numberOfEhz) { return sizeof(SharedSnapshotHeader) + (static_cast<size_t>(numberOfEhz) * sizeof(SharedSnapshotEhz)); }
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. The writer. Used by the EhzSystem
+
+	namespace EhzInternal
+	{
+		// See ehzmeasureddata.hpp
+		struct AllMeasuredValuesForOneEhz;
+	}
+
+	namespace SnapshotSegmentInternal
+	{
+		class SnapshotSegmentWriter
+		{
+			public:
+				// Create the segment or use the existing one. All blocks are empty. An existing segment is only made larger
+				SnapshotSegmentWriter(const mchar *const segmentName, const uint numberOfEhzl);
+				// Unmap the segment. It is not removed, so that readers keep the last values
+				virtual ~SnapshotSegmentWriter(void);
+				
+				// Copy the values of one EHZ into its block
+				void publish(const uint ehzIndex, const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz);
+				
+				// Check if the segment could be mapped
+				boolean isOpen(void) const { return (null<SharedSnapshotHeader *>() != header); }
+				
+			protected:
+				const uint numberOfEhz;
+				SharedSnapshotHeader *header;
+				SharedSnapshotEhz *ehz;
+				
+			private:
+				// Default constructor and copies must not be used
+				//lint -e{1704}
+				SnapshotSegmentWriter(void);
+				SnapshotSegmentWriter(const SnapshotSegmentWriter &);
+				SnapshotSegmentWriter &operator =(const SnapshotSegmentWriter &);
+		};
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. The reader. For other programs on the same machine
+
+	// Nothing is copied, if the values are read directly in the segment:
+	//
+	//	u64 sequence;
+	//	do
+	//	{
+	//		sequence = reader.beginRead(ehzIndex);
+	//		power = reader.getEhz(ehzIndex).value[2].doubleValue;
+	//	} while (!reader.isReadValid(ehzIndex, sequence));
+	//
+	// The values must not be used, before isReadValid returned true
+
+	namespace SnapshotSegmentInternal
+	{
+		class SnapshotSegmentReader
+		{
+			public:
+				// Map the segment read only. Check isOpen for the result
+				explicit SnapshotSegmentReader(const mchar *const segmentName = &SnapshotSegmentName[0]);
+				virtual ~SnapshotSegmentReader(void);
+				
+				// Check if the segment is mapped and valid
+				boolean isOpen(void) const { return (null<const SharedSnapshotHeader *>() != header); }
+				uint getNumberOfEhz(void) const { return numberOfEhz; }
+				// Changes with every update of any EHZ
+				u64 getGeneration(void) const { return isOpen() ? __atomic_load_n(&header->generation, __ATOMIC_ACQUIRE) : null<u64>(); }
+				// True, if a writer has initialized the segment again since it was mapped. Then the reader must be created again
+				boolean isStale(void) const { return !isOpen() || (SnapshotSegmentMagic != __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE)) || (writerStarts != __atomic_load_n(&header->writerStarts, __ATOMIC_ACQUIRE)); }
+				
+				// Direct access to the block of one EHZ. Only between beginRead and isReadValid
+				const SharedSnapshotEhz &getEhz(const uint ehzIndex) const { return ehz[ehzIndex]; }
+				// Wait until the writer has finished the block. Returns the sequence for isReadValid
+				u64 beginRead(const uint ehzIndex) const;
+				// True, if the block has not been changed since beginRead
+				boolean isReadValid(const uint ehzIndex, const u64 sequence) const;
+				
+				// Copy the block of one EHZ. Returns false for an invalid index
+				boolean read(const uint ehzIndex, SharedSnapshotEhz &sharedSnapshotEhz) const;
+				
+			protected:
+				const SharedSnapshotHeader *header;
+				const SharedSnapshotEhz *ehz;
+				uint numberOfEhz;
+				size_t segmentSize;
+				u64 writerStarts;
+				
+			private:
+				// No copies. The mapping belongs to one reader
+				SnapshotSegmentReader(const SnapshotSegmentReader &);
+				SnapshotSegmentReader &operator =(const SnapshotSegmentReader &);
+		};
+		
+		// Inline, because a reader calls it in its loop
+		inline u64 SnapshotSegmentReader::beginRead(const uint ehzIndex) const
+		{
+			u64 sequence = __atomic_load_n(&ehz[ehzIndex].sequence, __ATOMIC_ACQUIRE);
+			while (null<u64>() != (sequence & 1ULL))
+			{
+				sequence = __atomic_load_n(&ehz[ehzIndex].sequence, __ATOMIC_ACQUIRE);
+			}
+			return sequence;
+		}
+		
+		inline boolean SnapshotSegmentReader::isReadValid(const uint ehzIndex, const u64 sequence) const
+		{
+			// The values must have been read, before the sequence is read again
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			return (sequence == __atomic_load_n(&ehz[ehzIndex].sequence, __ATOMIC_RELAXED));
+		}
+	}
+
+#endif
@@ -1,351 +1,648 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-//
-// tcpconnection.hpp
-//
-//
-// General Description
-//
-// This module is a part of an application to read the data from Electronic Meters for Electric Power
-//
-// In Germany they are called EHZ. Hence the name of the module an variables.
-//
-// The EHZ transmits data via an infrared interface. The protocoll is described in:
-//
-//  http://www.emsycon.de/downloads/SML_081112_103.pdf
-//
-// After data has been evaluated it will be provided to others for further usage.
-//
-// Server and Client classes for communicating data over a TCP Connection
-// Socket must be open and ready to use
-//
-// There are generic classes for Communication and EHZ specific classses.
-// Additionally a nano WebServer is present.
-//
-// Either all measured values from an EHZ can be shown or just the Powerstate are transmitted
-// With that it is possible to see, if there is spare power that can be consumed by special devices
-//
-
-
-#ifndef TCPCONNECTION_HPP
-#define TCPCONNECTION_HPP
-
-
-
-#include "userinterface.hpp"
-
-#include "observer.hpp"
-#include "timerevent.hpp"
-#include "ehzmeasureddata.hpp"
-
-
- 
- 
-
-
-
-
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 1. General Definitions
-	
-	const mchar tcpConnectionGetEhzDataCommand[] = "g";
-
-	// Base class for TCP connections
-	// Handles data exchange over TCP connections
-	// Reads data buffered
-
-	const size_t MaxSizeReceiveBuffer = 64U;
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 2. Generic Base class for all TCP Connections
-	
-	
-	class TcpConnectionBase : 	public CommunicationEndPoint, 
-								public Publisher<TcpConnectionBase>
-	{
-		public:
-			// Explicit constructor 
-			// Constructor gets the connection handle (socket handle) 
-
-			explicit TcpConnectionBase(const Handle connectionHandle) : CommunicationEndPoint(connectionHandle), Publisher<TcpConnectionBase>(), receivedRawData(), peerIPAddress(),peerIPAddressPort() {}
-
-			// Empty virtual destructor so that we can delete derived classes via base class
-			virtual ~TcpConnectionBase(void) {}		
-			
-			// Start does nothing. 
-			//lint -e{1961}   1961 virtual member function 'Symbol' could be made const
-			virtual void start(void) {}
-			
-			// Event handler for reactor. Handle all incoming events (data is arriving)
-			virtual EventProcessing::Action handleEvent(const EventType et);
-			
-			virtual void setPeerAddressData(const std::string address, const std::string port) {peerIPAddress=address;peerIPAddressPort=port;}
-			virtual std::string getPeerIPAddress(void) {return peerIPAddress;}
-			virtual std::string getPeerIPAddressPort(void) {return peerIPAddressPort;}
-		protected:
-			// Because a lot of the functionality of the handleEvent function is the same
-			// we use an specific function for handling the data received by handleEvent
-			// So we can reuse most functionality and override this function for the specifics. Hence pure virtual
-			virtual EventProcessing::Action handleReadData(const sint bytesRead) = 0;
-
-			// // The buffer for the raw read data
-			mchar receivedRawData[MaxSizeReceiveBuffer];
-			
-			// Some Address information of peer
-			std::string peerIPAddress;
-			std::string peerIPAddressPort;
-		private:
-			// Do not use
-			// Default constructor. Handle must be set before using this class
-			//lint -e{1704}     1704 Constructor 'Symbol' has private access specification
-			TcpConnectionBase(void) : CommunicationEndPoint(), Publisher<TcpConnectionBase>() , receivedRawData() , peerIPAddress(),peerIPAddressPort(){ handle = null<Handle>(); }
-	};
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 3. TCP Connection Server
-
-	// -------------------------------------------------------------------------------
-	// 3.1. TCP Connection Server for transmitting all measured values from all EHZ
-		
-		class EhzSystem;
-		// A data server for rather raw connections
-		// The raw contents of the data values read by the EHZ will be transmitted
-		// Transmission of data will be done in ASCII. Framed bei STX and ETX and seperated by US
-		class TcpConnectionEhzDataServer :	public TcpConnectionBase
-		{
-			public:
-				// Just store the connection handle / socket handle
-				explicit TcpConnectionEhzDataServer(const Handle connectionHandle) : TcpConnectionBase(connectionHandle), outputData(), ehzSystem(null<EhzSystem *>()) {}
-				virtual ~TcpConnectionEhzDataServer(void) {}	//lint !e1540
-				virtual void setEhzSystemDataPointer(EhzSystem *const ehzSystemP) { ehzSystem = ehzSystemP; }
-
-
-			protected:
-				virtual EventProcessing::Action handleReadData(const sint bytesRead);
-				// Build the data that we want to send to the connected peer
-				// This is the specific working horse for this functionality
-				virtual void buildOutputData(void);
-				// We need persistent data, becuase we will send this data via aio services
-				std::string outputData;
-				// Set reference data
-				EhzSystem *ehzSystem;
-
-			private:
-				//lint -e{1704}      1704 Constructor 'Symbol' has private access specification
-				TcpConnectionEhzDataServer(void) : TcpConnectionBase(null<Handle>()), outputData(), ehzSystem(null<EhzSystem *>()) {}
-		};									
-
-	// -------------------------------------------------------------------------------
-	// 3.2. TCP Connection Server for transmitting the overall Power state
-
-		// A data server for just transmitting the overall power (plus or minus) of the system
-		// Transmission of raw data, embedded in STX ETX
-		class TcpConnectionEhzPowerStateServer : public TcpConnectionEhzDataServer
-		{
-			public:
-				// Just store the connection handle / socket handle
-				explicit TcpConnectionEhzPowerStateServer(const Handle connectionHandle) : TcpConnectionEhzDataServer(connectionHandle) {}
-				virtual ~TcpConnectionEhzPowerStateServer(void) {}
-			protected:
-				// Build specific output data. Just the power value as ascii
-				virtual void buildOutputData(void);
-			private:
-				//lint -e{1704}     1704 Constructor 'Symbol' has private access specification
-				TcpConnectionEhzPowerStateServer(void) : TcpConnectionEhzDataServer(null<Handle>()) {}
-		};
-
-
-
-	// -------------------------------------------------------------------------------------
-	// 3.3. TCP Connection Server for transmitting all measured values from all EHZ in HTML
-
-		// So this is a tiny nano Web Server
-
-		// This class will answer to a GET request from a web browser and send the measured values from the EHZ to the connected peer
-		class TcpConnectionSimpleHtmlAnswer : public TcpConnectionEhzDataServer
-		{
-			//lint --e{935}      935 int within struct
-			public:
-				// Just store the connection handle / socket handle
-				explicit TcpConnectionSimpleHtmlAnswer(const Handle connectionHandle) : TcpConnectionEhzDataServer(connectionHandle), state(StateWaitForGet), 
-					url(),headerLengthCounter(null<sint>()), newLineCounter(null<sint>()), matchIndex(null<uint>()) {}
-					
-				virtual ~TcpConnectionSimpleHtmlAnswer(void) {}
-			protected:
-				// Parse data that is sent from the peer
-				virtual EventProcessing::Action handleReadData(const sint bytesRead);
-				// Buld the reply string, so reply all EHZ data in HTML
-				virtual void buildOutputData(void);
-				
-				// Maximum number of HTML Get header that we will wait for. Safeguard.
-				enum {maxHeaderLength = 1024};  
-				// States for small state machine to parse GET request
-				enum {StateWaitForGet, StateWaitForUrl, WaitForHeaderEnd}; 
-				// The current state of the small state machine to parese the HTML get request header
-				sint state; 
-				// The URL that is contained in the GET header will be stored here
-				std::string url; 
-				// Counter for bytes in HTML GET request header. We will only analyze a maximun number of 
-				// bytes in the header. Otherwise we will ignore it and reset the parser
-				sint headerLengthCounter;
-				// 2 new lines separate the header from the rest. Will be used while parsing
-				sint newLineCounter;
-				// Will be using to parse the GET token
-				uint matchIndex;
-				
-			private:
-				// delete standard constructor
-				//lint -e{1704}     1704 Constructor 'Symbol' has private access specification
-				TcpConnectionSimpleHtmlAnswer(void) : TcpConnectionEhzDataServer(null<Handle>()), state(StateWaitForGet), 
-					url(),headerLengthCounter(null<sint>()), newLineCounter(null<sint>()), matchIndex(null<uint>()) {}
-		};
-
-	// -------------------------------------------------------------------------------------
-	// 3.4. TCP Connection Server for transmitting the Powerstate of the EHZ System in HTML
-
-		// So this is a tiny pico Web Server
-		// Simply return the overall power state of the EHZ system to a WEB browser
-		class TcpConnectionSimpleHtmlAnswerPowerState : public TcpConnectionSimpleHtmlAnswer
-		{
-			public:
-				explicit TcpConnectionSimpleHtmlAnswerPowerState(const Handle connectionHandle) : TcpConnectionSimpleHtmlAnswer(connectionHandle) {}
-				virtual ~TcpConnectionSimpleHtmlAnswerPowerState(void) {}
-			protected:
-				// Build the reply string in HTML. Send power information
-				virtual void buildOutputData(void);
-			private:
-				//lint -e{1704}       1704 Constructor 'Symbol' has private access specification
-				TcpConnectionSimpleHtmlAnswerPowerState(void) : TcpConnectionSimpleHtmlAnswer(null<Handle>()) {}
-		};
-
-
-
-
-	// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-	// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-	// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-	// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-	// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-	
-// ------------------------------------------------------------------------------------------------------------------------------
-// 4. TCP Connection Clients
-
-	// ------------------------------------------------------------------------------------------------------------------------------
-	// 4.1 TCP Connection Client: Get all EHZ System data from connected Server
-	
-		// Send all x seconds a request to the server and get last EHZ System Data
-		class TcpConnectionGetEhzDataClient :	public TcpConnectionBase,
-												public Subscriber<EventTimer>
-		{
-			//lint --e{935}
-			public:
-				// Give socket handle and specify poll time
-				explicit TcpConnectionGetEhzDataClient(const Handle connectionHandle, const u32 pollPeriod = 30000UL);
-				virtual ~TcpConnectionGetEhzDataClient(void);
-				
-				// Start the communication. Start the timer and wait for notification event
-				// Function is given becuase of virtual start function
-				virtual void start(void) { this->startPoll();}
-
-				// Start the poll timer and add handler to reactor
-				virtual void startPoll(void);
-				// Stop timer
-				virtual void stopPoll(void);
-				
-				
-			protected:
-			
-				// Notify all registered subscribers
-				// This means that the TCP connection was closed
-				virtual void notifySubscribers(void); 
-
-				// Here we will store the result. So, the data from the other side
-				std::vector<EhzInternal::AllMeasuredValuesForOneEhz> vEMDA;	
-				// This function will be invoked when the timer fires. It will send a get request to the connected peer
-				//lint -e{955,1768}
-				virtual void update(EventTimer *const);
-				// Data over TCP connection is transferred via ASCII. With beginning STX, terminating ETX and US as separator
-				// From take this transmitted strings and create values out of that
-				virtual void setValuesFromStrings(std::vector<std::string>::iterator &iter);
-				// Handle the received data
-				virtual EventProcessing::Action handleReadData(const sint bytesRead);
-				// Internal state machine for conversion of received data
-				enum {StateWaitForStart, StateDoConversion};
-				// The request command ('g') that will be transmitted to the connected peer
-				const std::string requestCommand;
-				// And the timer taht we use for periodic polling data from the connected peer
-				EventTimer pollTimer;
-				// Here we store all received data as single string. Afterwords we will convert all stings back to the corresponding data structure
-				std::vector<std::string> receivedDataAsStrings;
-				// Temporary string container for byte by byte received data
-				std::string convertedDataPart;
-				// Current state of the internal state machine for converions of received data
-				sint state;
-				
-			private:
-				//lint -e{1704}
-				TcpConnectionGetEhzDataClient(void);
-		};
-
-
-	// ------------------------------------------------------------------------------------------------------------------------------
-	// 4.2 TCP Connection Client: Get all EHZ System Power State from a connected Server
-
-
-		// Get all x seconds the Power state form the connected client
-		// We want to know if we have enough solar power to consume
-		class TcpConnectionGetEhzPowerStateClient : public TcpConnectionGetEhzDataClient
-		{
-			public:
-				// Give socket handle and specify poll time
-				explicit TcpConnectionGetEhzPowerStateClient(const Handle connectionHandle, const u32 pollPeriod = 5000UL) : TcpConnectionGetEhzDataClient(connectionHandle, pollPeriod), power(0.0) {}
-				virtual ~TcpConnectionGetEhzPowerStateClient(void) {}
-			protected:
-				// Data over TCP connection is transferred via ASCII. With beginning STX, terminating ETX and US as separator
-				// From take this transmitted strings and create values out of that
-				virtual void setValuesFromStrings(std::vector<std::string>::iterator &iter);
-				//The resulting read value
-				mdouble power;
-			private:
-				//lint -e{1704}
-				TcpConnectionGetEhzPowerStateClient(void) : TcpConnectionGetEhzDataClient(null<Handle>(), null<u32>()), power(0.0) {}
-		};
-
-
-	// ------------------------------------------------------------------------------------------------------------------------------
-	// 4.3 TCP Connection Client: Calculate the overall power state from the received data
-
-		// Convert the received ASCII string into a double. So we will calculate the power here
-		inline void TcpConnectionGetEhzPowerStateClient::setValuesFromStrings(std::vector<std::string>::iterator &iter)
-		{
-		
-			static sint i=0;
-			power = strtod((*iter).c_str(),null<mchar **>());++iter;
-			ui << "Power " << i << " " << power << std::endl;
-			++i;
-		}
-
-
- 
-
-#endif
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+//
+// tcpconnection.hpp
+//
+//
+// General Description
+//
+// This module is a part of an application to read the data from Electronic Meters for Electric Power
+//
+// In Germany they are called EHZ. Hence the name of the module an variables.
+//
+// The EHZ transmits data via an infrared interface. The protocoll is described in:
+//
+//  http://www.emsycon.de/downloads/SML_081112_103.pdf
+//
+// After data has been evaluated it will be provided to others for further usage.
+//
+// Server and Client classes for communicating data over a TCP Connection
+// Socket must be open and ready to use
+//
+// There are generic classes for Communication and EHZ specific classses.
+// Additionally a nano WebServer is present.
+//
+// Either all measured values from an EHZ can be shown or just the Powerstate are transmitted
+// With that it is possible to see, if there is spare power that can be consumed by special devices
+//
+
+
+#ifndef TCPCONNECTION_HPP
+#define TCPCONNECTION_HPP
+
+
+
+#include "userinterface.hpp"
+
+#include "observer.hpp"
+#include "timerevent.hpp"
+#include "ehzmeasureddata.hpp"
+#include "transfer.hpp"
+
+
+ 
+ 
+
+
+
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General Definitions
+	
+	const mchar tcpConnectionGetEhzDataCommand[] = "g";
+	// The same data in the binary format (see ehzmeasureddata.hpp). The client chooses the format with the command
+	const mchar tcpConnectionGetEhzDataBinaryCommand[] = "b";
+	// Minimum, maximum and average over the sliding windows (see aggregate.hpp)
+	// Reply: STX (ehz US value US window in s US number of samples US min US max US avg US)* ETX
+	// The power state server sends only the windows of the power value: STX (window in s US number of samples US min US max US avg US)* ETX
+	const mchar tcpConnectionGetEhzAggregatesCommand[] = "w";
+	// The values configured for early publication (see ehzconfig.hpp). P: Provisional, the SML file is not yet verified. C: Confirmed
+	// Reply: STX (ehz US value US scaled value US P|C US)* ETX
+	// The power state server sends only the power value: STX scaled value US P|C US ETX
+	const mchar tcpConnectionGetEhzEarlyValuesCommand[] = "e";
+
+	// Base class for TCP connections
+	// Handles data exchange over TCP connections
+	// Reads data buffered
+
+	const size_t MaxSizeReceiveBuffer = 64U;
+	
+	// Queries for time ranges: Commands, number of rows per reply and maximum length of a request
+	const mchar tcpConnectionQueryCommand = 'q';
+	const mchar tcpConnectionNextPageCommand = 'n';
+	const uint HistoryQueryPageSize = 256U;
+	// Latest time for a query. Far in the future, but there is room for calculations
+	const s64 HistoryQueryMaxTime = 0x7FFFFFFF00000000LL;
+	const size_t MaxSizeQueryRequest = 128U;
+	
+	// Subscriptions for pushed values: Commands
+	const mchar tcpConnectionSubscribeCommand = 's';
+	const mchar tcpConnectionUnsubscribeCommand = 'u';
+
+	// Persistent HTTP connections are closed after this idle time. If the peer wants to close, the sending direction is shut down
+	// after the reply has been sent completely. The peer closes then. If not, the idle time closes the connection
+	const u32 HttpKeepAliveTimeoutInMs = 30000UL;
+
+	// The reply of a data server depends only on the measured values. So all connections of one class can share it
+	// It will be built again, when the EhzSystem has published new values (new generation)
+	// The generation is also the entity tag for HTTP replies
+	// Every reactor has its own caches. So reactor threads do not share any SharedString
+	struct SharedReplyCache
+	{
+		SharedReplyCache(void) : reply(), generation(null<u64>()), isValid(false) {}
+		SharedString reply;
+		u64 generation;
+		boolean isValid;
+	};
+
+	// A reactor thread must not read the published values of the EhzSystem. It works with a copy
+	struct MeasuredValuesOfReactorThread
+	{
+		// Nothing copied yet. The first read will take any version
+		MeasuredValuesOfReactorThread(void) : measuredValues(), publishedMeasuredValues(), generation(~null<u64>()) {}
+		AllMeasuredValuesForAllEhz measuredValues;
+		// Points into measuredValues
+		EhzInternal::PublishedMeasuredValues publishedMeasuredValues;
+		u64 generation;
+	};
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Generic Base class for all TCP Connections
+	
+	
+	class TcpConnectionBase : 	public CommunicationEndPoint, 
+								public Publisher<TcpConnectionBase>
+	{
+		public:
+			// Explicit constructor 
+			// Constructor gets the connection handle (socket handle) 
+
+			explicit TcpConnectionBase(const Handle connectionHandle) : CommunicationEndPoint(connectionHandle), Publisher<TcpConnectionBase>(), registryPrevious(null<TcpConnectionBase *>()), registryNext(null<TcpConnectionBase *>()),
+																		receivedRawData(), peerIPAddress(),peerIPAddressPort(), writeQueue(), closeAfterWriteIsRequested(false) {}
+
+			// Empty virtual destructor so that we can delete derived classes via base class
+			virtual ~TcpConnectionBase(void) {}		
+			
+			// Start does nothing. 
+			//lint -e{1961}   1961 virtual member function 'Symbol' could be made const
+			virtual void start(void) {}
+			
+			// Event handler for reactor. Handle all incoming events (data is arriving)
+			virtual EventProcessing::Action handleEvent(const EventType et);
+			// handleEvent reads until the socket is empty and writes until the socket is full or the queue is empty
+			virtual boolean wantsEdgeTriggeredEvents(void) const { return true; }
+			
+			virtual void setPeerAddressData(const std::string address, const std::string port) {peerIPAddress=address;peerIPAddressPort=port;}
+			virtual std::string getPeerIPAddress(void) {return peerIPAddress;}
+			virtual std::string getPeerIPAddressPort(void) {return peerIPAddressPort;}
+			
+			// Links for the connection registry of the acceptor. Only used there
+			//lint -e{1925}
+			TcpConnectionBase *registryPrevious;
+			//lint -e{1925}
+			TcpConnectionBase *registryNext;
+		protected:
+			// Because a lot of the functionality of the handleEvent function is the same
+			// we use an specific function for handling the data received by handleEvent
+			// So we can reuse most functionality and override this function for the specifics. Hence pure virtual
+			virtual EventProcessing::Action handleReadData(const sint bytesRead) = 0;
+			
+			// Send data to the peer with a non blocking write. What cannot be sent at once, is sent later
+			// when the reactor reports that the socket is writable. No AIO and no allocation of a writer
+			void writeData(const SharedString &sharedString);
+			void writeData(const std::string &sourceString) { writeData(SharedString(sourceString)); }
+			void writeData(const std::ostringstream &s) { writeData(SharedString(s.str())); }
+			// The socket is writable again. Send the queued data
+			void handleWriteReady(void);
+			// The last reply has been given. Shut down the sending direction, when everything is sent. Nothing is written afterwards
+			void closeAfterWrite(void);
+
+			// // The buffer for the raw read data
+			mchar receivedRawData[MaxSizeReceiveBuffer];
+			
+			// Some Address information of peer
+			std::string peerIPAddress;
+			std::string peerIPAddressPort;
+			
+			// Data that could not be sent yet
+			TransferInternal::WriteQueue writeQueue;
+			// Shut down the sending direction, when the write queue is empty
+			boolean closeAfterWriteIsRequested;
+		private:
+			// Do not use
+			// Default constructor. Handle must be set before using this class
+			//lint -e{1704}     1704 Constructor 'Symbol' has private access specification
+			TcpConnectionBase(void) : CommunicationEndPoint(), Publisher<TcpConnectionBase>(), registryPrevious(null<TcpConnectionBase *>()), registryNext(null<TcpConnectionBase *>()),
+										receivedRawData() , peerIPAddress(),peerIPAddressPort(), writeQueue(), closeAfterWriteIsRequested(false) { handle = null<Handle>(); }
+	};
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. TCP Connection Server
+
+	// -------------------------------------------------------------------------------
+	// 3.1. TCP Connection Server for transmitting all measured values from all EHZ
+		
+		class EhzSystem;
+		// A data server for rather raw connections
+		// The raw contents of the data values read by the EHZ will be transmitted
+		// Transmission of data will be done in ASCII. Framed bei STX and ETX and seperated by US
+		// Or in the binary format, if the peer requests it
+		class TcpConnectionEhzDataServer :	public TcpConnectionBase
+		{
+			public:
+				// Just store the connection handle / socket handle
+				explicit TcpConnectionEhzDataServer(const Handle connectionHandle) : TcpConnectionBase(connectionHandle), outputData(), ehzSystem(null<EhzSystem *>()) {}
+				virtual ~TcpConnectionEhzDataServer(void) {}	//lint !e1540
+				virtual void setEhzSystemDataPointer(EhzSystem *const ehzSystemP) { ehzSystem = ehzSystemP; }
+
+
+			protected:
+				virtual EventProcessing::Action handleReadData(const sint bytesRead);
+				// Build the data that we want to send to the connected peer
+				// This is the specific working horse for this functionality
+				virtual void buildOutputData(void);
+				// The window aggregates. Built for each request, because they change with every new value
+				virtual void buildAggregateOutputData(void);
+				// The early published values. Built for each request, because they change during parsing
+				virtual void buildEarlyOutputData(void);
+				// Complete the output data to the reply for the peer. Raw data needs nothing
+				virtual void buildReply(const u64) {}
+				// Each class has its own cache, because the output formats are different
+				virtual SharedReplyCache &getSharedReplyCache(void);
+				// Get the reply from the cache. Build it, only if there are new measured values
+				const SharedString &getSharedReply(void);
+				// The same for the binary format. There is only one for all connections of a reactor
+				const SharedString &getSharedBinaryReply(void);
+				// The measured values to serve. The EhzSystem must be set
+				const EhzInternal::PublishedMeasuredValues &getMeasuredValues(void);
+				// We need persistent data, becuase we will send this data via aio services
+				std::string outputData;
+				// Set reference data
+				EhzSystem *ehzSystem;
+
+			private:
+				//lint -e{1704}      1704 Constructor 'Symbol' has private access specification
+				TcpConnectionEhzDataServer(void) : TcpConnectionBase(null<Handle>()), outputData(), ehzSystem(null<EhzSystem *>()) {}
+		};									
+
+	// -------------------------------------------------------------------------------
+	// 3.2. TCP Connection Server for transmitting the overall Power state
+
+		// A data server for just transmitting the overall power (plus or minus) of the system
+		// Transmission of raw data, embedded in STX ETX
+		class TcpConnectionEhzPowerStateServer : public TcpConnectionEhzDataServer
+		{
+			public:
+				// Just store the connection handle / socket handle
+				explicit TcpConnectionEhzPowerStateServer(const Handle connectionHandle) : TcpConnectionEhzDataServer(connectionHandle) {}
+				virtual ~TcpConnectionEhzPowerStateServer(void) {}
+			protected:
+				// Build specific output data. Just the power value as ascii
+				virtual void buildOutputData(void);
+				// Only the windows of the power value
+				virtual void buildAggregateOutputData(void);
+				// Only the power value
+				virtual void buildEarlyOutputData(void);
+				virtual SharedReplyCache &getSharedReplyCache(void);
+			private:
+				//lint -e{1704}     1704 Constructor 'Symbol' has private access specification
+				TcpConnectionEhzPowerStateServer(void) : TcpConnectionEhzDataServer(null<Handle>()) {}
+		};
+
+
+
+	// -------------------------------------------------------------------------------------
+	// 3.3. TCP Connection Server for transmitting all measured values from all EHZ in HTML
+
+		// So this is a tiny nano Web Server
+
+		// This class will answer to a GET request from a web browser and send the measured values from the EHZ to the connected peer
+		// Connections are persistent (HTTP/1.1 keep-alive). Several requests in one read (pipelining) are answered in order
+		// An idle connection is closed by a timer. If the values did not change, then 304 Not Modified is sent
+		class TcpConnectionSimpleHtmlAnswer : 	public TcpConnectionEhzDataServer,
+												public Subscriber<EventTimer>
+		{
+			//lint --e{935}      935 int within struct
+			public:
+				// Store the connection handle / socket handle and start the idle timer
+				explicit TcpConnectionSimpleHtmlAnswer(const Handle connectionHandle);
+				// Stop the idle timer
+				virtual ~TcpConnectionSimpleHtmlAnswer(void);
+				// Close the connection. Also stop the idle timer
+				virtual void stop(void);
+				// The idle timer expired. Close the connection
+				virtual void update(EventTimer *const);
+			protected:
+				// Parse data that is sent from the peer
+				virtual EventProcessing::Action handleReadData(const sint bytesRead);
+				// Buld the reply string, so reply all EHZ data in HTML
+				virtual void buildOutputData(void);
+				// Add the HTTP header
+				virtual void buildReply(const u64 generation);
+				virtual SharedReplyCache &getSharedReplyCache(void);
+				// Evaluate one line of the request header
+				void evaluateHeaderLine(void);
+				// The request is complete. Send the reply
+				virtual void answerRequest(void);
+				
+				// Entity tag for a generation of measured values. Generations start again with each program start. So the tag contains the start
+				static std::string getEntityTag(const u64 generation);
+				
+				// Maximum number of HTML Get header that we will wait for. Safeguard.
+				enum {maxHeaderLength = 1024};  
+				// States for small state machine to parse GET request
+				enum {StateWaitForGet, StateWaitForUrl, WaitForHeaderEnd}; 
+				// The current state of the small state machine to parese the HTML get request header
+				sint state; 
+				// The URL that is contained in the GET header will be stored here
+				std::string url; 
+				// Counter for bytes in HTML GET request header. We will only analyze a maximun number of 
+				// bytes in the header. Otherwise we will ignore it and reset the parser
+				sint headerLengthCounter;
+				// 2 new lines separate the header from the rest. Will be used while parsing
+				sint newLineCounter;
+				// Will be using to parse the GET token
+				uint matchIndex;
+				
+				// The current line of the request header
+				std::string headerLine;
+				// Evaluated header: HTTP/1.0 request, "Connection: close", "Connection: keep-alive" and "If-None-Match"
+				boolean requestIsHttp10;
+				boolean requestConnectionClose;
+				boolean requestConnectionKeepAlive;
+				std::string requestEntityTag;
+				
+				// Closes the connection, if the peer does not send requests
+				EventTimer idleTimer;
+				
+			private:
+				// delete standard constructor
+				//lint -e{1704}     1704 Constructor 'Symbol' has private access specification
+				TcpConnectionSimpleHtmlAnswer(void);
+				// No copies
+				TcpConnectionSimpleHtmlAnswer(const TcpConnectionSimpleHtmlAnswer &);
+				TcpConnectionSimpleHtmlAnswer &operator =(const TcpConnectionSimpleHtmlAnswer &);
+		};
+
+	// -------------------------------------------------------------------------------------
+	// 3.4. TCP Connection Server for transmitting the Powerstate of the EHZ System in HTML
+
+		// So this is a tiny pico Web Server
+		// Simply return the overall power state of the EHZ system to a WEB browser
+		class TcpConnectionSimpleHtmlAnswerPowerState : public TcpConnectionSimpleHtmlAnswer
+		{
+			public:
+				explicit TcpConnectionSimpleHtmlAnswerPowerState(const Handle connectionHandle) : TcpConnectionSimpleHtmlAnswer(connectionHandle) {}
+				virtual ~TcpConnectionSimpleHtmlAnswerPowerState(void) {}
+			protected:
+				// Build the reply string in HTML. Send power information
+				virtual void buildOutputData(void);
+				virtual SharedReplyCache &getSharedReplyCache(void);
+			private:
+				//lint -e{1704}       1704 Constructor 'Symbol' has private access specification
+				TcpConnectionSimpleHtmlAnswerPowerState(void) : TcpConnectionSimpleHtmlAnswer(null<Handle>()) {}
+		};
+
+
+
+
+	// -------------------------------------------------------------------------------------
+	// 3.5. TCP Connection Server for queries of time ranges
+		
+		namespace DatabaseInternal
+		{
+			class EhzDataBaseReader;
+		}
+		
+		// History of one numerical value of one EHZ. Requests are lines in ASCII:
+		//   q <meter> <value> <from> <to> <resolution>		First page. Times in seconds since epoch. Resolution 0: raw data
+		//   n												Next page of the last query
+		// Raw data is read from the historian, if it is active, else from the database. Otherwise from the roll-up tables.
+		// Reply: STX more US time US min US max US avg US last US ... ETX.  more is 1, if there is a next page
+		// The database is read in windows of the time range. So a page may have less rows, even none, and more is still 1
+		// For an invalid request: STX E US ETX
+		class TcpConnectionEhzHistoryServer : public TcpConnectionEhzDataServer
+		{
+			public:
+				explicit TcpConnectionEhzHistoryServer(const Handle connectionHandle);
+				// Close the database connection
+				virtual ~TcpConnectionEhzHistoryServer(void);
+			protected:
+				// Collect a request line and answer it
+				virtual EventProcessing::Action handleReadData(const sint bytesRead);
+				// Read the next page of the active query
+				virtual void buildOutputData(void);
+				// Evaluate a complete request line. Returns false, if the request is invalid
+				boolean evaluateRequest(void);
+				
+				// The request line, collected from the received data
+				std::string requestLine;
+				// The active query. Key of the first row of the next page: queryFromTime and for the historian the sequence number
+				boolean queryIsActive;
+				uint queryMeter;
+				uint queryValueId;
+				s64 queryFromTime;
+				uint queryFromSequenceNumber;
+				s64 queryToTime;
+				s64 queryResolution;
+				// Read only connection to the database. Opened with the first query
+				DatabaseInternal::EhzDataBaseReader *ehzDataBaseReader;
+			private:
+				//lint -e{1704}     1704 Constructor 'Symbol' has private access specification
+				TcpConnectionEhzHistoryServer(void);
+				// No copies
+				TcpConnectionEhzHistoryServer(const TcpConnectionEhzHistoryServer &);
+				TcpConnectionEhzHistoryServer &operator =(const TcpConnectionEhzHistoryServer &);
+		};
+
+	// -------------------------------------------------------------------------------------
+	// 3.6. TCP Connection Server pushing new values to subscribers
+
+		// Instead of polling, a client subscribes once. Requests are lines in ASCII:
+		//   s <minimum period in ms>		Subscribe. New values are pushed, when an EHZ has evaluated an SML File
+		//									But not more often than the minimum period. 0: No rate limit
+		//   u								Unsubscribe
+		// Only values that changed since the last push by more than their deadband will be sent. After subscribing
+		// and with each keyframe of an Ehz, all values are sent
+		// Push: STX ehz US time US time as string US (slot US value in the format of the data server)* ETX
+		// For an invalid request: STX E US ETX
+		class TcpConnectionEhzPushServer : 	public TcpConnectionEhzDataServer,
+											public Subscriber<EhzSystem>,
+											public Subscriber<EventTimer>
+		{
+			public:
+				explicit TcpConnectionEhzPushServer(const Handle connectionHandle);
+				// Unsubscribe and stop the timer
+				virtual ~TcpConnectionEhzPushServer(void);
+				// Close the connection. No more pushes
+				virtual void stop(void);
+				// An Ehz has new values
+				virtual void update(EhzSystem *const publisher);
+				// The minimum period is over. Push the values that came in meanwhile
+				virtual void update(EventTimer *const);
+			protected:
+				// Collect a request line and evaluate it
+				virtual EventProcessing::Action handleReadData(const sint bytesRead);
+				// Evaluate a complete request line. Returns false, if the request is invalid
+				boolean evaluateRequest(void);
+				// Send the changed values of all Ehz with pending new values. Or all values after subscribing
+				void pushPendingValues(const boolean sendAllValues);
+				// No more pushes
+				void unsubscribe(void);
+				
+				// The request line, collected from the received data
+				std::string requestLine;
+				boolean isSubscribed;
+				// Rate limit
+				u32 minimumPeriodInMs;
+				// Monotonic time of the last push in ms
+				u64 lastPushTime;
+				// Ehz with new values, that have not been sent yet
+				std::vector<boolean> pushIsPending;
+				// Ehz with a pending keyframe. All their values are sent with the next push
+				std::vector<boolean> keyframeIsPending;
+				// The values as known by the peer
+				std::vector<EhzInternal::AllMeasuredValuesForOneEhz> sentMeasuredValues;
+				// Runs, if a push is deferred because of the rate limit
+				EventTimer rateLimitTimer;
+				boolean rateLimitTimerIsRunning;
+			private:
+				//lint -e{1704}     1704 Constructor 'Symbol' has private access specification
+				TcpConnectionEhzPushServer(void);
+				// No copies
+				TcpConnectionEhzPushServer(const TcpConnectionEhzPushServer &);
+				TcpConnectionEhzPushServer &operator =(const TcpConnectionEhzPushServer &);
+		};
+
+	// -------------------------------------------------------------------------------------
+	// 3.7. TCP Connection Server for the metrics
+
+		// Answers HTTP GET requests with the counters and latencies in the text format of Prometheus (see metrics.hpp)
+		// The metrics change all the time. So there is no shared reply and no entity tag
+		// Runs in the main reactor, because the metrics of the Ehz are taken from the parser
+		class TcpConnectionEhzMetricsServer : public TcpConnectionSimpleHtmlAnswer
+		{
+			public:
+				explicit TcpConnectionEhzMetricsServer(const Handle connectionHandle) : TcpConnectionSimpleHtmlAnswer(connectionHandle) {}
+				virtual ~TcpConnectionEhzMetricsServer(void) {}
+			protected:
+				// All metrics of all Ehz, the reactors and the database
+				virtual void buildOutputData(void);
+				// Always a new reply
+				virtual void answerRequest(void);
+			private:
+				//lint -e{1704}       1704 Constructor 'Symbol' has private access specification
+				TcpConnectionEhzMetricsServer(void) : TcpConnectionSimpleHtmlAnswer(null<Handle>()) {}
+		};
+
+	// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. TCP Connection Clients
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 4.1 TCP Connection Client: Get all EHZ System data from connected Server
+	
+		// Send all x seconds a request to the server and get last EHZ System Data
+		// Or subscribe at a push server (see 3.6). Then the poll period is the minimum period between two pushes
+		class TcpConnectionGetEhzDataClient :	public TcpConnectionBase,
+												public Subscriber<EventTimer>
+		{
+			//lint --e{935}
+			public:
+				// Give socket handle and specify poll time
+				// For polling, the data may be requested in the binary format
+				explicit TcpConnectionGetEhzDataClient(const Handle connectionHandle, const u32 pollPeriod = 30000UL, const boolean subscribe = false, const boolean binary = false);
+				virtual ~TcpConnectionGetEhzDataClient(void);
+				
+				// Start the communication. Start the timer and wait for notification event
+				// Or send the subscription. Then the server sends the data without further requests
+				// Function is given becuase of virtual start function
+				virtual void start(void);
+
+				// Start the poll timer and add handler to reactor
+				virtual void startPoll(void);
+				// Stop timer
+				virtual void stopPoll(void);
+				
+				
+			protected:
+			
+				// Notify all registered subscribers
+				// This means that the TCP connection was closed
+				virtual void notifySubscribers(void); 
+
+				// Here we will store the result. So, the data from the other side
+				std::vector<EhzInternal::AllMeasuredValuesForOneEhz> vEMDA;	
+				// This function will be invoked when the timer fires. It will send a get request to the connected peer
+				//lint -e{955,1768}
+				virtual void update(EventTimer *const);
+				// Data over TCP connection is transferred via ASCII. With beginning STX, terminating ETX and US as separator
+				// From take this transmitted strings and create values out of that
+				virtual void setValuesFromStrings(std::vector<std::string>::iterator &iter, const std::vector<std::string>::iterator &end);
+				// A push contains only the changed values of one EHZ. Store them
+				virtual void setPushedValuesFromStrings(std::vector<std::string>::iterator &iter, const std::vector<std::string>::iterator &end);
+				// Handle the received data
+				virtual EventProcessing::Action handleReadData(const sint bytesRead);
+				// Collect binary frames and store the values
+				void handleReadBinaryData(const sint bytesRead);
+				// Show the time and the numerical values of one EHZ after they have been received
+				void showReceivedValues(const uint ehzIndex);
+				// Internal state machine for conversion of received data
+				enum {StateWaitForStart, StateDoConversion};
+				// The request command ('g') that will be transmitted to the connected peer
+				const std::string requestCommand;
+				// And the timer taht we use for periodic polling data from the connected peer
+				EventTimer pollTimer;
+				// Subscribe instead of polling
+				const boolean subscribeForPush;
+				const u32 pollPeriodInMs;
+				// Request and receive in the binary format
+				const boolean binaryFormat;
+				// Received binary data, until a frame is complete
+				std::string receivedBinaryData;
+				// Here we store all received data as single string. Afterwords we will convert all stings back to the corresponding data structure
+				std::vector<std::string> receivedDataAsStrings;
+				// Temporary string container for byte by byte received data
+				std::string convertedDataPart;
+				// Current state of the internal state machine for converions of received data
+				sint state;
+				
+			private:
+				//lint -e{1704}
+				TcpConnectionGetEhzDataClient(void);
+		};
+
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 4.2 TCP Connection Client: Get all EHZ System Power State from a connected Server
+
+
+		// Get all x seconds the Power state form the connected client
+		// We want to know if we have enough solar power to consume
+		class TcpConnectionGetEhzPowerStateClient : public TcpConnectionGetEhzDataClient
+		{
+			public:
+				// Give socket handle and specify poll time
+				explicit TcpConnectionGetEhzPowerStateClient(const Handle connectionHandle, const u32 pollPeriod = 5000UL) : TcpConnectionGetEhzDataClient(connectionHandle, pollPeriod), power(0.0) {}
+				virtual ~TcpConnectionGetEhzPowerStateClient(void) {}
+			protected:
+				// Data over TCP connection is transferred via ASCII. With beginning STX, terminating ETX and US as separator
+				// From take this transmitted strings and create values out of that
+				virtual void setValuesFromStrings(std::vector<std::string>::iterator &iter, const std::vector<std::string>::iterator &end);
+				//The resulting read value
+				mdouble power;
+			private:
+				//lint -e{1704}
+				TcpConnectionGetEhzPowerStateClient(void) : TcpConnectionGetEhzDataClient(null<Handle>(), null<u32>()), power(0.0) {}
+		};
+
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 4.3 TCP Connection Client: Calculate the overall power state from the received data
+
+		// Convert the received ASCII string into a double. So we will calculate the power here
+		inline void TcpConnectionGetEhzPowerStateClient::setValuesFromStrings(std::vector<std::string>::iterator &iter, const std::vector<std::string>::iterator &)
+		{
+		
+			static sint i=0;
+			power = strtod((*iter).c_str(),null<mchar **>());++iter;
+			ui << "Power " << i << " " << power << std::endl;
+			++i;
+		}
+
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 4.4 TCP Connection Clients for the binary format and for pushed values
+
+		// The connector creates a connection only with the socket handle. So each way to get the data has its own class
+		class TcpConnectionGetEhzDataBinaryClient : public TcpConnectionGetEhzDataClient
+		{
+			public:
+				// Request the data in the binary format all 30s
+				explicit TcpConnectionGetEhzDataBinaryClient(const Handle connectionHandle) : TcpConnectionGetEhzDataClient(connectionHandle, 30000UL, false, true) {}
+				virtual ~TcpConnectionGetEhzDataBinaryClient(void) {}
+			private:
+				//lint -e{1704}
+				TcpConnectionGetEhzDataBinaryClient(void);
+		};
+		
+		class TcpConnectionSubscribeEhzDataClient : public TcpConnectionGetEhzDataClient
+		{
+			public:
+				// Subscribe at the push server. At most one push per second
+				explicit TcpConnectionSubscribeEhzDataClient(const Handle connectionHandle) : TcpConnectionGetEhzDataClient(connectionHandle, 1000UL, true, false) {}
+				virtual ~TcpConnectionSubscribeEhzDataClient(void) {}
+			private:
+				//lint -e{1704}
+				TcpConnectionSubscribeEhzDataClient(void);
+		};
+
+
+ 
+
+#endif
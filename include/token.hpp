@@ -33,6 +33,11 @@
 // This module defines only 3 data members) Type, Value, Length and a lot of functions to access 
 // that data in various ways.
 
+// Octet strings are not copied into the token. All bytes of octet strings of one SML file are
+// stored one after the other in a buffer (owned by the scanner). The token and later the parse tree
+// will only hold a view (pointer and length) into that buffer. A std::string will only be created,
+// if somebody really needs an own copy. The buffer will be reused for the next SML file.
+
 // SML uses a Type-Length Field. Coded in one byte. One nibble contains the type and the other the length
 // We will use a similar approach for the token here 
 
@@ -41,6 +46,10 @@
 
 #include "escanalysis.hpp"
 
+#include <string.h>
+
+#include <vector>
+
 
 
  
@@ -48,11 +57,43 @@
 
 
 // ------------------------------------------------------------------------------------------------------------------------------------------------
-// 1. The token class
+// 1. Storage for the octet strings of one SML file
+
+	// Number of octet string bytes that can be stored for one SML file at the start. Since strings are limited to
+	// MAX_SML_STRING_LEN, this is sufficient for a lot of SmlListEntries. If an SML file has even more,
+	// the octet string, that does not fit any longer, is marked as truncated. The parser reports an error.
+	// Then the buffer is doubled for the next SML file, up to the maximum size. So a meter with long signatures
+	// and server IDs loses only its first SML files
+	const size_t SmlOctetBufferSize = 1024U;
+	const size_t SmlOctetBufferMaxSize = 16384U;
+
+	class SmlOctetBuffer
+	{
+		public:
+			SmlOctetBuffer(void) : buffer(SmlOctetBufferSize), numberOfStoredBytes(null<size_t>()), isOverflowed(false) {}
+			// Forget all stored bytes. All views into the buffer are invalid then. Grow, if the last SML file did not fit
+			void reset(void);
+			// Position where the next byte will be stored
+			const EhzDatabyte *getEnd(void) const { return &buffer[0] + numberOfStoredBytes; }
+			// Append bytes to the buffer. Returns the number of bytes that could be stored
+			size_t append(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes);
+		protected:
+			// The size changes only in reset. Views into the buffer stay valid until then
+			std::vector<EhzDatabyte> buffer;
+			size_t numberOfStoredBytes;
+			// Not all octet strings of the actual SML file could be stored
+			boolean isOverflowed;
+	};
+
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------
+// 2. The token class
 
 	class Token
 	{
 		public: 
+			Token(void) : tokenType(CONDITION_NOT_YET_DETECTED), tokenLength(null<TokenLength>()), tokenValue(), octetBuffer(null<SmlOctetBuffer *>()) {}
+			
 			// Definition of all Token Types
 			enum TokenType
 			{
@@ -82,13 +123,20 @@
 			// Get teh length of the token
 			TokenLength getLength(void) const { return tokenLength; }
 
+			// Set the buffer where the bytes of octet strings will be stored
+			void setOctetBuffer(SmlOctetBuffer *const ob) { octetBuffer = ob; }
+
 			// This are functions to set associated values beside type and length
 			// Add/Append a value (char) to the SMLByteString
-			void setValue(EhzDatabyte ehzDatabyte);
-			// setValue with now parameter will clear all values. Reset to 0
-			void setValue(void) { tokenValue.smlByteString.clear(); tokenValue.boolValue = false; tokenValue.s64Value = 0L; tokenValue.u64Value = 0ULL;}
+			void setValue(EhzDatabyte ehzDatabyte) { setValue(&ehzDatabyte, 1U); }
+			// Append a block of values to the SMLByteString
+			void setValue(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes);
+			// setValue with now parameter will clear all values. Reset to 0. A new SMLByteString starts at the end of the octet buffer
+			void setValue(void);
 			// Store the boolean value
 			void setValue(boolean b) { tokenValue.boolValue = b; }
+			// The octet buffer was full. The SMLByteString misses bytes and must not be used
+			boolean isByteStringTruncated(void) const { return tokenValue.byteStringIsTruncated; }
 			// Any kind of signed integer. Length field determines which
 			void setValue(s64 s) { tokenValue.s64Value = s; }
 			// Any kind of unsigned integer. Length field determines which
@@ -101,6 +149,7 @@
 			s64 getS64Value (void) const { return tokenValue.s64Value;} // signed integer
 			u64 getU64Value (void) const { return tokenValue.u64Value;} // unsigned integer
 			mdouble getDoubleValue(void) const; // Signed or unsigned value converted to double
+			s64 getIntegerValue(void) const; // Signed or unsigned value as signed 64 bit integer
 			// And, the SML FIle End Data
 			void getEscSmlFileEndData(EscSmlFileEndData &fed) const { fed = tokenValue.escSmlFileEndData; }
 			
@@ -115,6 +164,7 @@
 			void getValueForType(s64 *data) const { *data =  tokenValue.s64Value ;}
 			void getValueForType(boolean *data) const { *data =  tokenValue.boolValue ;}
 			void getValueForType(SmlByteString *sbs) const;
+			void getValueForType(SmlByteStringView *sbsv) const { *sbsv = tokenValue.smlByteStringView; }
 			void getValueForType(EscSmlFileEndData *data) const { *data = tokenValue.escSmlFileEndData; }
 			void getValueForType(SmlListLength *data) const { data->lenght = static_cast<u8>(tokenLength); }
 			
@@ -132,20 +182,51 @@
 				s64 s64Value;
 				u64 u64Value;
 				EscSmlFileEndData escSmlFileEndData;
-				SmlByteString smlByteString;
+				SmlByteStringView smlByteStringView;
+				boolean byteStringIsTruncated;
 			};
 			// Instantiation
 			TokenValue tokenValue;
+			// Storage for the bytes of the SMLByteString
+			SmlOctetBuffer *octetBuffer;
 	};
 
 	
 	
 // ------------------------------------------------------------------------------------------------------------------------------------------------
-// 2. Inline functions
+// 3. Inline functions
 
 
 	// -----------------------------------------------------------------------
-	// 2.1 Get a double value from the token
+	// 3.1 Store bytes in the octet buffer
+
+	// Copy as much as possible into the buffer
+	inline size_t SmlOctetBuffer::append(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes)
+	{
+		const size_t freeSpace = buffer.size() - numberOfStoredBytes;
+		const size_t bytesToStore = (freeSpace < numberOfBytes) ? freeSpace : numberOfBytes;
+		memcpy(&buffer[0] + numberOfStoredBytes, ehzDatabytes, bytesToStore);
+		numberOfStoredBytes += bytesToStore;
+		if (bytesToStore < numberOfBytes)
+		{
+			isOverflowed = true;
+		}
+		return bytesToStore;
+	}
+
+	// Only an SML file, that did not fit, leads to an allocation. In the steady state the size stays the same
+	inline void SmlOctetBuffer::reset(void)
+	{
+		if (isOverflowed && (buffer.size() < SmlOctetBufferMaxSize))
+		{
+			buffer.resize(buffer.size() * 2U);
+		}
+		isOverflowed = false;
+		numberOfStoredBytes = null<size_t>();
+	}
+
+	// -----------------------------------------------------------------------
+	// 3.2 Get a double value from the token
 
 	// The token stores only integer types.
 	// This will convert, depending on the sign, an integer to a double
@@ -169,23 +250,54 @@
 	}
 
 	// -----------------------------------------------------------------------
-	// 2.2 Append a byte to the SmlByteString which is a std::string
-	inline void Token::setValue(EhzDatabyte ehzDatabyte)
+	// 3.3 Get the raw integer value from the token
+
+	// Meter readings are far below 2^63, so an unsigned value can be stored as signed
+	inline s64 Token::getIntegerValue(void) const
+	{
+		return (UNSIGNED_INTEGER == tokenType) ? static_cast<s64>(tokenValue.u64Value) : tokenValue.s64Value;
+	}
+
+	// -----------------------------------------------------------------------
+	// 3.4 Clear all values and start a new, empty SmlByteString
+	inline void Token::setValue(void)
+	{
+		tokenValue.smlByteStringView.data = (null<SmlOctetBuffer *>() == octetBuffer) ? null<const EhzDatabyte *>() : octetBuffer->getEnd();
+		tokenValue.smlByteStringView.length = null<TokenLength>();
+		tokenValue.byteStringIsTruncated = false;
+		tokenValue.boolValue = false;
+		tokenValue.s64Value = 0L;
+		tokenValue.u64Value = 0ULL;
+	}
+
+	// -----------------------------------------------------------------------
+	// 3.5 Append bytes to the SmlByteString. They are stored in the octet buffer
+	inline void Token::setValue(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes)
 	{
 		// SmlByte string is limited in length
-		if (static_cast<TokenLength>(MAX_SML_STRING_LEN - 2) > tokenValue.smlByteString.length() )
+		const size_t maxLength = static_cast<size_t>(MAX_SML_STRING_LEN - 2);
+		const size_t length = static_cast<size_t>(tokenValue.smlByteStringView.length);
+		if ((maxLength > length) && (null<SmlOctetBuffer *>() != octetBuffer))
 		{
-			// Append a byte to the string
-			tokenValue.smlByteString += static_cast<mchar>(ehzDatabyte);  
+			// Append as much as possible. The view grows with the stored bytes
+			const size_t bytesToStore = ((maxLength - length) < numberOfBytes) ? (maxLength - length) : numberOfBytes;
+			const size_t storedBytes = octetBuffer->append(ehzDatabytes, bytesToStore);
+			tokenValue.smlByteStringView.length += static_cast<TokenLength>(storedBytes);
+			// Cutting at the maximum length is intended. A full buffer is not
+			if (storedBytes < bytesToStore)
+			{
+				tokenValue.byteStringIsTruncated = true;
+			}
 		}
 	}
 
 	// -----------------------------------------------------------------------
-	// 2.3 Get string from token
+	// 3.6 Get string from token
 	inline void Token::getValueForType(SmlByteString *sbs) const
 	{  
-		// Copy the SmlByteSTring which is a std::string
-		*sbs = tokenValue.smlByteString;
+		// Create a copy of the bytes in a std::string
+		//lint -e{926,9176}
+		sbs->assign(reinterpret_cast<const mchar *>(tokenValue.smlByteStringView.data), static_cast<size_t>(tokenValue.smlByteStringView.length));
 	}
 
  	
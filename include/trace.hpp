@@ -0,0 +1,143 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// trace.hpp
+//
+// General Description
+//
+// Probes at the boundaries of the processing stages. The metrics show, how long a stage takes on
+// average. A trace shows, where the time of one SML file went: Read, ESC frame, parser, publication,
+// database, reactor dispatch and TCP write.
+//
+// The probes are compiled in, but do nothing until the trace is started with the key 't'. A probe then
+// costs only one relaxed load of a flag and a branch. The next 't' stops the trace and writes the file
+// EhzTraceFileName in the Chrome trace format (JSON). It can be opened with ui.perfetto.dev or
+// chrome://tracing. A running trace is also written at the end of the program.
+//
+// Each thread writes its records into its own ring buffer. So there is no lock. Only the latest records
+// are kept. Spans are measured with the monotonic clock. Instants mark single events.
+//
+// With TRACE_FLAGS=-DTRACE_PROBES_REMOVED the probes are removed completely by the compiler.
+//
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include "mytypes.hpp"
+#include "metrics.hpp"
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General definitions
+
+namespace TraceInternal
+{
+	// The probes. The argument of a record is given in the comment
+	struct TraceProbe
+	{
+		enum Type
+		{
+			SerialRead,				// Span for the read of a serial or network port. Instant for a record of a replay. Number of bytes
+			EscFrameStart,			// Instant. ESC-Start sequence. EHZ index
+			EscFrameEnd,			// Instant. ESC-End sequence. EHZ index
+			Parse,					// Span. Parser with streaming evaluation for a block of bytes. EHZ index
+			ParserDone,				// Instant. Complete SML file. EHZ index
+			ParserError,			// Instant. EHZ index
+			TraverseAndEvaluate,	// Span. Evaluation of a complete parse tree. No argument
+			EhzSystemUpdate,		// Span. Publication of the values of one EHZ. EHZ index
+			StoreMeasuredValues,	// Span. Database. Number of EHZ
+			ReactorDispatch,		// Span. One call of an EventHandler. Handle
+			TcpWrite,				// Span. Writing or queuing data for a TCP connection. Handle
+			TcpWriteComplete,		// Instant. All data of a TCP connection have been written. Handle
+			NumberOfProbes
+		};
+	};
+
+	const mchar EhzTraceFileName[] = ROOT_DIRECTORY "/ehz-trace.json";
+
+	// Set by startTrace and stopTrace. Read by all probes
+	//lint -e{956}
+	extern boolean traceIsActive;
+
+#ifdef TRACE_PROBES_REMOVED
+	inline boolean isTraceActive(void) { return false; }
+#else
+	inline boolean isTraceActive(void) { return __atomic_load_n(&traceIsActive, __ATOMIC_RELAXED); }
+#endif
+
+	// Store a record in the ring buffer of this thread. Only called, if the trace is active
+	void recordSpan(const TraceProbe::Type probe, const u64 startTimeInNs, const u64 argument);
+	void recordInstant(const TraceProbe::Type probe, const u64 argument);
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Probes
+
+	// An event without duration
+	inline void traceInstant(const TraceProbe::Type probe, const u64 argument)
+	{
+		if (isTraceActive())
+		{
+			recordInstant(probe, argument);
+		}
+	}
+
+	// A span, for which the start time has already been measured. For example for the metrics
+	inline void traceSpanSince(const TraceProbe::Type probe, const u64 startTimeInNs, const u64 argument)
+	{
+		if (isTraceActive())
+		{
+			recordSpan(probe, startTimeInNs, argument);
+		}
+	}
+
+	// A span from the construction until the end of the scope. The clock is only read, if the trace is active
+	class TraceSpan
+	{
+		public:
+			explicit TraceSpan(const TraceProbe::Type probeL, const u64 argumentL = null<u64>()) : probe(probeL), argument(argumentL),
+																						startTimeInNs(isTraceActive() ? MetricsInternal::getMonotonicTimeInNs() : null<u64>()) {}
+			~TraceSpan(void) { if ((null<u64>() != startTimeInNs) && isTraceActive()) { recordSpan(probe, startTimeInNs, argument); } }
+			// The argument may be known only at the end of the span
+			void setArgument(const u64 argumentL) { argument = argumentL; }
+		protected:
+			const TraceProbe::Type probe;
+			u64 argument;
+			const u64 startTimeInNs;
+		private:
+			TraceSpan(void);
+			TraceSpan(const TraceSpan &);
+			TraceSpan &operator =(const TraceSpan &);
+	};
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Control
+
+	// Records from before the start are not written. Returns false, if the probes have been removed
+	boolean startTrace(void);
+	// Stop the probes and write the trace file. Returns false, if the file could not be written
+	boolean stopTrace(void);
+}
+
+
+#endif
@@ -1,149 +1,294 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-//
-// transfer.hpp
-//
-// Send data asynchronously to a stream
-//
-// Helper functions for asynchronous data transmission. Mainly used to send data via TCP.
-// in most cases, handles of file descriptors point to sockets
-//
-// A class is defined for transmitting data over a socket asynchronously and with
-// no handshake or whatsoever. Meaning, we don't care, if the function succeeds or not.
-// The class instance is dynamically created on the heap and self destructs after it
-// completes its work.
-//
-
-
-#ifndef TRANSFER_HPP
-#define TRANSFER_HPP
-
-
-#include "proactor.hpp"
-#include <sstream>
-
-
-// -------------------------------------------------------------------------------------------------------------------------------------
-// 1. Wrapper functions for transmitting data via class AsynchronousDataWriterWithSelfDestruct
-
-	// -----------------------------------------------------
-	// 1.1 Declaration of functions defined in transfer.cpp
-	
-	// This functions will always be used to transmit the data
-	// So far we will not use and instance of AsynchronousDataWriterWithSelfDestruct explicetely
-	
-		extern void writeDataAsynchronous(const std::string &sourceString, const Handle h);
-		extern void writeDataAsynchronous(const std::ostringstream &s, const Handle h);
-
-	namespace TransferInternal
-	{
-
-	// -----------------------------------------------------
-	// 1.2 Asynchronous Data Transmission class
-
-		// Typically this class will be created / instantiated on the heap
-		// The function operator () will be called.
-		// After the work is finsihed, the object will self destruct via delete this
-	
-		class AsynchronousDataWriterWithSelfDestruct : public CompletionHandlerWithAo
-		{
-			public:
-				// The constructors will work with different types of sources. Handle (file descriptor) to socket will always be given
-
-				// Take a string as source
-				explicit AsynchronousDataWriterWithSelfDestruct(const std::string &sourceString, const Handle h);
-				// Take a stringstream as source
-				explicit AsynchronousDataWriterWithSelfDestruct(const std::ostringstream &s, const Handle h);
-				// Self destruct
-				AsynchronousDataWriterWithSelfDestruct(void);
-				
-				// The only interface of this class
-				void operator ()(void);
-				
-				// Eventhandler for proactor
-				virtual AsynchronousCompletionEvent::Action handleCompletionEventAsync(ACT *actl);
-				virtual EventProcessing::Action handleCompletionEventSync(ACT *actl);			
-			protected:
-				//lint -e{9008}    Bug in Lint
-				void destroy(void) { delete this;}
-				// We do not want to have called the destructor explicetly				
-				virtual ~AsynchronousDataWriterWithSelfDestruct(void){}
-				
-				
-		
-				// Handle or file desciptor of (normally) an open TCP socket
-				Handle handle;
-				// And the output string. All data given in the contructors will be copied into this variable
-				// The ourputString is a persistent buffer and exists until all AIO functions are completed
-				// and the class finally self destructs
-				std::string outputString;
-		};
-
-	// -----------------------------------------------------------
-	// 1.3 Asynchronous Data Transmission class inline functions
-		
-
-		// -----------------------------------------------------------
-		// 1.3.1 Constructors
-		// All constructors copy the given data into the internal data buffer outputString
-		
-			
-			// Source is string
-			inline AsynchronousDataWriterWithSelfDestruct::AsynchronousDataWriterWithSelfDestruct(const std::string &sourceString, const Handle h) : 
-				CompletionHandlerWithAo(&handle),
-				handle(h),
-				outputString(sourceString)
-			{
-			}
-
-			// Source is ostringstream
-			inline AsynchronousDataWriterWithSelfDestruct::AsynchronousDataWriterWithSelfDestruct(const std::ostringstream &s, const Handle h) : 
-				CompletionHandlerWithAo(&handle),
-				handle(h),
-				outputString(s.str())
-			{
-			}
-			
-			// Default constructor will not be called. Sets everything to null and empty
-			inline AsynchronousDataWriterWithSelfDestruct::AsynchronousDataWriterWithSelfDestruct(void) : 
-				CompletionHandlerWithAo(&handle),
-				handle(null<Handle>()),
-				outputString()
-			{
-			}
-
-
-
-		// -----------------------------------------------------------
-		// 1.3.2 Write the data
-
-			inline void AsynchronousDataWriterWithSelfDestruct::operator () (void)
-			{
-				//lint -e(1960,925,9005,534,926)
-				ao.aWrite(reinterpret_cast<byte* const>(const_cast<mchar *>(outputString.c_str())), outputString.length(), getFreeAct());
-			}
-	}
-
- 
-
-	
-#endif
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+//
+// transfer.hpp
+//
+// Send data asynchronously to a stream
+//
+// Helper functions for asynchronous data transmission. Mainly used to send data via TCP.
+// in most cases, handles of file descriptors point to sockets
+//
+// A class is defined for transmitting data over a socket asynchronously and with
+// no handshake or whatsoever. Meaning, we don't care, if the function succeeds or not.
+// The class instance is dynamically created on the heap and self destructs after it
+// completes its work.
+//
+// Alternatively, a connection owns a WriteQueue. Data is sent directly with a non blocking
+// send. What could not be sent is queued and sent later, when the reactor reports that the
+// socket is writable again. Queue elements come from a pool. So there is no allocation for a write.
+//
+
+
+#ifndef TRANSFER_HPP
+#define TRANSFER_HPP
+
+
+#include "proactor.hpp"
+#include "reactor.hpp"
+#include "singleton.hpp"
+#include <sstream>
+
+
+// -------------------------------------------------------------------------------------------------------------------------------------
+// 1. Wrapper functions for transmitting data via class AsynchronousDataWriterWithSelfDestruct
+
+	// -----------------------------------------------------
+	// 1.1 Immutable string with reference counting
+
+		// Many connections may send the same data. Then they share one buffer and nothing is copied
+		// The buffer is deleted together with the last copy of the SharedString
+		class SharedString
+		{
+			public:
+				SharedString(void) : sharedData(new SharedData(std::string())) {}
+				explicit SharedString(const std::string &s) : sharedData(new SharedData(s)) {}
+				SharedString(const SharedString &ss) : sharedData(ss.sharedData) { addReference(); }
+				SharedString &operator =(const SharedString &ss);
+				~SharedString(void) { release(); }
+				
+				const std::string &str(void) const { return sharedData->data; }
+			protected:
+				struct SharedData
+				{
+					explicit SharedData(const std::string &s) : data(s), referenceCount(1U) {}
+					const std::string data;
+					uint referenceCount;
+				};
+				//lint -e{534}
+				void addReference(void) { __atomic_add_fetch(&sharedData->referenceCount, 1U, __ATOMIC_RELAXED); }
+				void release(void);
+				
+				SharedData *sharedData;
+		};
+
+		inline SharedString &SharedString::operator =(const SharedString &ss)
+		{
+			// Take the new reference first. So self assignment works
+			SharedData *const oldSharedData = sharedData;
+			sharedData = ss.sharedData;
+			addReference();
+			if (0U == __atomic_sub_fetch(&oldSharedData->referenceCount, 1U, __ATOMIC_ACQ_REL))
+			{
+				delete oldSharedData;
+			}
+			return *this;
+		}
+		
+		inline void SharedString::release(void)
+		{
+			if (0U == __atomic_sub_fetch(&sharedData->referenceCount, 1U, __ATOMIC_ACQ_REL))
+			{
+				delete sharedData;
+			}
+		}
+
+	// -----------------------------------------------------
+	// 1.2 Declaration of functions defined in transfer.cpp
+	
+	// This functions will always be used to transmit the data
+	// So far we will not use and instance of AsynchronousDataWriterWithSelfDestruct explicetely
+	
+		extern void writeDataAsynchronous(const std::string &sourceString, const Handle h);
+		extern void writeDataAsynchronous(const std::ostringstream &s, const Handle h);
+		// Send a shared buffer. The data is not copied
+		extern void writeDataAsynchronous(const SharedString &sharedString, const Handle h);
+
+	namespace TransferInternal
+	{
+
+	// -----------------------------------------------------
+	// 1.3 Asynchronous Data Transmission class
+
+		// Typically this class will be created / instantiated on the heap
+		// The function operator () will be called.
+		// After the work is finsihed, the object will self destruct via delete this
+	
+		class AsynchronousDataWriterWithSelfDestruct : public CompletionHandlerWithAo
+		{
+			public:
+				// The constructors will work with different types of sources. Handle (file descriptor) to socket will always be given
+
+				// Take a string as source
+				explicit AsynchronousDataWriterWithSelfDestruct(const std::string &sourceString, const Handle h);
+				// Take a stringstream as source
+				explicit AsynchronousDataWriterWithSelfDestruct(const std::ostringstream &s, const Handle h);
+				// Take a shared buffer as source. Will not be copied
+				explicit AsynchronousDataWriterWithSelfDestruct(const SharedString &sharedString, const Handle h);
+				// Self destruct
+				AsynchronousDataWriterWithSelfDestruct(void);
+				
+				// The only interface of this class
+				void operator ()(void);
+				
+				// Eventhandler for proactor
+				virtual AsynchronousCompletionEvent::Action handleCompletionEventAsync(ACT *actl);
+				virtual EventProcessing::Action handleCompletionEventSync(ACT *actl);			
+			protected:
+				//lint -e{9008}    Bug in Lint
+				void destroy(void) { delete this;}
+				// We do not want to have called the destructor explicetly				
+				virtual ~AsynchronousDataWriterWithSelfDestruct(void){}
+				
+				
+		
+				// Handle or file desciptor of (normally) an open TCP socket
+				Handle handle;
+				// And the output string. All data given in the contructors will be stored in this variable
+				// The ourputString is a persistent buffer and exists until all AIO functions are completed
+				// and the class finally self destructs. A shared buffer is only referenced
+				SharedString outputString;
+		};
+
+	// -----------------------------------------------------------
+	// 1.4 Asynchronous Data Transmission class inline functions
+		
+
+		// -----------------------------------------------------------
+		// 1.4.1 Constructors
+		// All constructors copy the given data into the internal data buffer outputString. But the shared buffer
+		
+			
+			// Source is string
+			inline AsynchronousDataWriterWithSelfDestruct::AsynchronousDataWriterWithSelfDestruct(const std::string &sourceString, const Handle h) : 
+				CompletionHandlerWithAo(&handle),
+				handle(h),
+				outputString(sourceString)
+			{
+			}
+
+			// Source is a shared buffer
+			inline AsynchronousDataWriterWithSelfDestruct::AsynchronousDataWriterWithSelfDestruct(const SharedString &sharedString, const Handle h) : 
+				CompletionHandlerWithAo(&handle),
+				handle(h),
+				outputString(sharedString)
+			{
+			}
+
+			// Source is ostringstream
+			inline AsynchronousDataWriterWithSelfDestruct::AsynchronousDataWriterWithSelfDestruct(const std::ostringstream &s, const Handle h) : 
+				CompletionHandlerWithAo(&handle),
+				handle(h),
+				outputString(s.str())
+			{
+			}
+			
+			// Default constructor will not be called. Sets everything to null and empty
+			inline AsynchronousDataWriterWithSelfDestruct::AsynchronousDataWriterWithSelfDestruct(void) : 
+				CompletionHandlerWithAo(&handle),
+				handle(null<Handle>()),
+				outputString()
+			{
+			}
+
+
+
+		// -----------------------------------------------------------
+		// 1.4.2 Write the data
+
+			inline void AsynchronousDataWriterWithSelfDestruct::operator () (void)
+			{
+				//lint -e(1960,925,9005,534,926)
+				ao.aWrite(reinterpret_cast<byte* const>(const_cast<mchar *>(outputString.str().c_str())), outputString.str().length(), getFreeAct());
+			}
+	}
+
+
+// -------------------------------------------------------------------------------------------------------------------------------------
+// 2. Non blocking transmission of data with a queue per connection
+
+	namespace TransferInternal
+	{
+	
+	// -----------------------------------------------------
+	// 2.1 Pool for the elements of the write queues
+
+		// One buffer waiting to be sent
+		struct QueuedBuffer
+		{
+			QueuedBuffer(void) : sharedString(), next(null<QueuedBuffer *>()) {}
+			SharedString sharedString;
+			QueuedBuffer *next;
+		};
+
+		// Elements are never given back to the heap. They are reused for the next writes
+		// There is one pool per reactor. A connection always writes in the thread of its reactor. So no locking
+		class QueuedBufferPool
+		{
+			public:
+				QueuedBufferPool(void) : freeList(null<QueuedBuffer *>()) {}
+				~QueuedBufferPool(void);
+				
+				QueuedBuffer *get(const SharedString &sharedString);
+				// The shared buffer is released at once. Only the element is kept
+				void put(QueuedBuffer *const queuedBuffer);
+				
+				// The pool of the reactor of the calling thread
+				static QueuedBufferPool *getInstance(void) { static QueuedBufferPool queuedBufferPool[MaxNumberOfReactors]; return &queuedBufferPool[getReactorIndexForThisThread()]; }
+			protected:
+				QueuedBuffer *freeList;
+			private:
+				// No copies
+				QueuedBufferPool(const QueuedBufferPool &);
+				QueuedBufferPool &operator =(const QueuedBufferPool &);
+		};
+
+
+	// -----------------------------------------------------
+	// 2.2 Write queue for one connection
+
+		class WriteQueue
+		{
+			public:
+				// Result of write and flush
+				enum WriteState {Complete, Pending, Error};
+				
+				WriteQueue(void) : head(null<QueuedBuffer *>()), tail(null<QueuedBuffer *>()), headOffset(null<size_t>()) {}
+				~WriteQueue(void) { clear(); }
+				
+				// Send the data, if nothing else is waiting. Queue what could not be sent
+				// Pending means: The caller has to wait for EventTypeOut and then call flush
+				WriteState write(const SharedString &sharedString, const Handle h);
+				// Send as much queued data as possible
+				WriteState flush(const Handle h);
+				
+				boolean isEmpty(void) const { return null<QueuedBuffer *>() == head; }
+				// Drop all unsent data
+				void clear(void);
+			protected:
+				// Remove the first element
+				void pop(void);
+				
+				QueuedBuffer *head;
+				QueuedBuffer *tail;
+				// Bytes of the first element that have already been sent
+				size_t headOffset;
+			private:
+				// No copies
+				WriteQueue(const WriteQueue &);
+				WriteQueue &operator =(const WriteQueue &);
+		};
+	}
+
+ 
+
+	
+#endif
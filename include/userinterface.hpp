@@ -34,6 +34,10 @@
 //
 // Note: We will not call wrefresh everytime. "endl"  or "flush" must be used for refreshing the screen.
 //
+// For servers, where nobody looks at a terminal, the program can be built with -DHEADLESS_USERINTERFACE.
+// Then ncurses is not used at all. Output to the main window goes to stdout, the output to all other windows
+// is discarded. Positioning and clearing do nothing.
+//
 // Reference books:
 // - "Programmer's Guide to nCurses" by  Dan Gookin
 // - "The C++ Standard Library, Second Edition" by Nicolai M. Josuttis
@@ -44,9 +48,14 @@
 #define USERINTERFACE_HPP
 
 #include "mytypes.hpp"
-#include "curses.h"
 #include "eventhandler.hpp"
 
+#ifdef HEADLESS_USERINTERFACE
+#include <stdio.h>
+#else
+#include "curses.h"
+#endif
+
 #include <vector>
 #include <ostream>
 
@@ -54,8 +63,13 @@
 // 
 	namespace UserinterfaceInternal
 	{
+#ifdef HEADLESS_USERINTERFACE
+		// Without ncurses, a window is a file. Or null, if the output shall be discarded
+		typedef FILE *NcursesWindow;
+#else
 		// Make more coenvient name for ncurses window pointer
 		typedef WINDOW *NcursesWindow;
+#endif
 
 // ----------------------------------------------------------------------------------------------------------------------------------------------
 // 2. Output Stream (ostream) for ncurses window + output streambuffer
@@ -75,6 +89,11 @@
 				// Destructor does nothing. Pointer will be deleted by ncurses endwin fonction
 				virtual ~NCursesWindowStream(void) { }
 				
+#ifdef HEADLESS_USERINTERFACE
+				// There is no screen. Positioning and clearing have no effect
+				virtual void setCursorPosition(const sint, const sint) {}
+				virtual void clearScreen(void) {}
+#else
 				// UserInterface specific functions. All realized via nCurses. Can be called directly or via manipulator
 				//lint -e{534}
 				// Set the cursor in this window
@@ -83,12 +102,22 @@
 				//lint -e{534}
 				// clear the screen for this window
 				virtual void clearScreen(void) { wclear(thisWindow); }
+#endif
 				
 				NcursesWindow getWindow(void)  { return thisWindow; }  //lint !e1962
 			protected:
 
 				// And a local copy of the WINDOW *
 				NcursesWindow thisWindow;
+#ifdef HEADLESS_USERINTERFACE
+				// Write to the file, if there is one
+				//lint -e{921,952,1961,1960} 
+				virtual std::streambuf::int_type overflow (std::streambuf::int_type c) { if (null<NcursesWindow>() != thisWindow) { (void)fputc(c, thisWindow); } return c; }
+				//lint -e{534,952,1961,1960} 
+				virtual std::streamsize xsputn(const mchar* s, std::streamsize num) { if (null<NcursesWindow>() != thisWindow) { (void)fwrite(s, 1U, static_cast<size_t>(num), thisWindow); } return num; }
+				//lint -e{1961}
+				virtual sint sync(void) { return (null<NcursesWindow>() != thisWindow) ? fflush(thisWindow) : null<sint>(); }
+#else
 			
 				// Write one character to the screen. Called by sputc
 				//lint -e{921,952,1961,1960} 
@@ -101,6 +130,7 @@
 				// Refresh the screen (Called by std::endl or std::flush)
 				//lint -e{1961}
 				virtual sint sync(void) { return wrefresh(thisWindow);  }
+#endif
 		};
 	} // End of namespace
 
@@ -189,7 +219,17 @@
 // 5. Global reference for UI.
 
 extern NCursesUserinterface ui;
+
+#ifdef HEADLESS_USERINTERFACE
+// Nobody will press a key. Standard input is read byte by byte
+const boolean UserinterfaceIsHeadless = true;
+inline sint readKey(void) { mchar ch = null<mchar>(); return (1 == read(STDIN_FILENO, &ch, 1U)) ? static_cast<sint>(ch) : -1; }
+inline void waitForKeyPress(void) {}
+#else
+const boolean UserinterfaceIsHeadless = false;
+inline sint readKey(void) { return getch(); }
 inline void waitForKeyPress(void) {(void)getch();}
+#endif
 
 #define SHOWINFO   ui << " --> "<< __FILE__ << " / " << __FUNCTION__ << " / " << __LINE__ << std::endl; //lint !e773
 
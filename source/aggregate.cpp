@@ -0,0 +1,154 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// aggregate.cpp
+//
+// General Description
+//
+// Sliding window aggregates of the measured values in ring buckets.
+// See aggregate.hpp for a description
+//
+
+
+
+#include "aggregate.hpp"
+#include "ehzconfig.hpp"
+
+#include <algorithm>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Sliding window aggregates of all EHZ
+
+	namespace AggregateInternal
+	{
+		// -------------------------------------------------------------------
+		// 2.1 Constructor. Buckets for the used values of all EHZ. All are empty
+		EhzWindowAggregates::EhzWindowAggregates(void) : bucket(), firstValueOfEhz(EhzInternal::getNumberOfEhz() + 1U, null<uint>()), sequenceOfEhz(EhzInternal::getNumberOfEhz(), null<u64>())
+		{
+			for (uint ehzIndex = null<uint>(); ehzIndex < EhzInternal::getNumberOfEhz(); ++ehzIndex)
+			{
+				firstValueOfEhz[ehzIndex + 1U] = firstValueOfEhz[ehzIndex] + EhzInternal::EhzSystemConfiguration::getInstance()->getNumberOfUsedEhzMeasuredData(ehzIndex);
+			}
+			bucket.resize(firstValueOfEhz[EhzInternal::getNumberOfEhz()] * NumberOfAggregationWindows * AggregationBucketsPerWindow);
+		}
+
+
+		// -------------------------------------------------------------------
+		// 2.2 Add the values of one EHZ. One bucket per window and value is changed
+		void EhzWindowAggregates::add(const uint ehzIndex, const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz)
+		{
+			if (ehzIndex < EhzInternal::getNumberOfEhz())
+			{
+				const EhzConfigDefinition &ecd = EhzInternal::getEhzConfigDefinition(ehzIndex);
+				const s64 timeOfValues = static_cast<s64>(allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated);
+
+				// Odd: Readers must not use the buckets. The buckets must not be written before the sequence
+				const u64 sequence = sequenceOfEhz[ehzIndex];
+				__atomic_store_n(&sequenceOfEhz[ehzIndex], sequence + 1ULL, __ATOMIC_RELAXED);
+				__atomic_thread_fence(__ATOMIC_RELEASE);
+				for (uint valueId = null<uint>(); valueId < (firstValueOfEhz[ehzIndex + 1U] - firstValueOfEhz[ehzIndex]); ++valueId)
+				{
+					if (EhzMeasuredDataType::Number == ecd.ehzMeasuredDataType[valueId])
+					{
+						const mdouble value = allMeasuredValuesForOneEhz.measuredValueForOneEhz[valueId].doubleValue;
+						Bucket *const firstBucket = &bucket[getFirstBucket(ehzIndex, valueId)];
+						for (uint window = null<uint>(); window < NumberOfAggregationWindows; ++window)
+						{
+							const s64 slice = timeOfValues / static_cast<s64>(AggregationWindowInS[window] / static_cast<time_t>(AggregationBucketsPerWindow));
+							//lint -e{571}
+							Bucket &b = firstBucket[(window * AggregationBucketsPerWindow) + static_cast<uint>(slice % static_cast<s64>(AggregationBucketsPerWindow))];
+							if (b.slice != slice)
+							{
+								// The ring wrapped around. The old slice is outside of the window
+								b.slice = slice;
+								b.numberOfSamples = null<u64>();
+								b.minimum = value;
+								b.maximum = value;
+								b.sum = 0.0;
+							}
+							++b.numberOfSamples;
+							b.minimum = (value < b.minimum) ? value : b.minimum;
+							b.maximum = (value > b.maximum) ? value : b.maximum;
+							b.sum += value;
+						}
+					}
+				}
+				// Even again: The buckets are consistent
+				__atomic_store_n(&sequenceOfEhz[ehzIndex], sequence + 2ULL, __ATOMIC_RELEASE);
+			}
+		}
+
+
+		// -------------------------------------------------------------------
+		// 2.3 Combine the buckets, that are inside of the window
+		// The buckets are copied under the sequence lock. The combination is done with the copy
+		boolean EhzWindowAggregates::get(const uint ehzIndex, const uint valueId, const uint window, const time_t nowTime, WindowAggregate &windowAggregate) const
+		{
+			windowAggregate = WindowAggregate();
+			if ((ehzIndex < EhzInternal::getNumberOfEhz()) && (valueId < (firstValueOfEhz[ehzIndex + 1U] - firstValueOfEhz[ehzIndex])) && (window < NumberOfAggregationWindows))
+			{
+				const s64 nowSlice = static_cast<s64>(nowTime) / static_cast<s64>(AggregationWindowInS[window] / static_cast<time_t>(AggregationBucketsPerWindow));
+				const Bucket *const firstBucket = &bucket[getFirstBucket(ehzIndex, valueId) + (window * AggregationBucketsPerWindow)];
+				Bucket bucketsOfWindow[AggregationBucketsPerWindow];
+				mdouble sum = 0.0;
+
+				boolean copyIsValid = false;
+				while (!copyIsValid)
+				{
+					// Wait until the writer has finished
+					u64 sequence = __atomic_load_n(&sequenceOfEhz[ehzIndex], __ATOMIC_ACQUIRE);
+					while (null<u64>() != (sequence & 1ULL))
+					{
+						sequence = __atomic_load_n(&sequenceOfEhz[ehzIndex], __ATOMIC_ACQUIRE);
+					}
+					std::copy(firstBucket, firstBucket + AggregationBucketsPerWindow, &bucketsOfWindow[0]);
+					// The buckets must have been read, before the sequence is read again
+					__atomic_thread_fence(__ATOMIC_ACQUIRE);
+					copyIsValid = (sequence == __atomic_load_n(&sequenceOfEhz[ehzIndex], __ATOMIC_RELAXED));
+				}
+				
+				for (uint i = null<uint>(); i < AggregationBucketsPerWindow; ++i)
+				{
+					const Bucket &b = bucketsOfWindow[i];
+					if ((b.slice > (nowSlice - static_cast<s64>(AggregationBucketsPerWindow))) && (b.slice <= nowSlice) && (null<u64>() != b.numberOfSamples))
+					{
+						if (null<u64>() == windowAggregate.numberOfSamples)
+						{
+							windowAggregate.minimum = b.minimum;
+							windowAggregate.maximum = b.maximum;
+						}
+						windowAggregate.minimum = (b.minimum < windowAggregate.minimum) ? b.minimum : windowAggregate.minimum;
+						windowAggregate.maximum = (b.maximum > windowAggregate.maximum) ? b.maximum : windowAggregate.maximum;
+						windowAggregate.numberOfSamples += b.numberOfSamples;
+						sum += b.sum;
+					}
+				}
+				if (null<u64>() != windowAggregate.numberOfSamples)
+				{
+					//lint -e{915}
+					windowAggregate.average = sum / static_cast<mdouble>(windowAggregate.numberOfSamples);
+				}
+			}
+			return (null<u64>() != windowAggregate.numberOfSamples);
+		}
+	}
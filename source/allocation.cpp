@@ -0,0 +1,181 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// allocation.cpp
+//
+// General Description
+//
+// Counters for heap allocations per subsystem and the replacement of the global operator new.
+// See allocation.hpp
+//
+
+
+
+#include "allocation.hpp"
+#include "metrics.hpp"
+
+#include <stdlib.h>
+
+#include <new>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Counters
+
+namespace AllocationInternal
+{
+	namespace
+	{
+		// Names for the metrics and the report
+		const mchar *const AllocationSubsystemName[AllocationSubsystem::NumberOfSubsystems] = { "other", "input", "evaluation", "database", "server", "userinterface" };
+
+		// Any thread may allocate. So the counters are incremented atomically
+		//lint -e{956}
+		u64 numberOfAllocations[AllocationSubsystem::NumberOfSubsystems];
+		// Value of the counters at the begin of the steady state
+		//lint -e{956}
+		u64 numberOfAllocationsAtSteadyState[AllocationSubsystem::NumberOfSubsystems];
+		//lint -e{956}
+		boolean steadyStateHasBegun = false;
+	}
+
+#ifdef ALLOCATION_ACCOUNTING
+	__thread AllocationSubsystem::Type allocationSubsystemForThisThread = AllocationSubsystem::Other;
+#endif
+
+	u64 getNumberOfAllocations(const AllocationSubsystem::Type subsystem)
+	{
+		return __atomic_load_n(&numberOfAllocations[subsystem], __ATOMIC_RELAXED);
+	}
+
+	u64 getNumberOfSteadyStateAllocations(const AllocationSubsystem::Type subsystem)
+	{
+		// The start values are written before the flag is set
+		return isSteadyState() ? (getNumberOfAllocations(subsystem) - numberOfAllocationsAtSteadyState[subsystem]) : null<u64>();
+	}
+
+	void beginSteadyState(void)
+	{
+		if (!isSteadyState())
+		{
+			for (uint subsystem = null<uint>(); subsystem < static_cast<uint>(AllocationSubsystem::NumberOfSubsystems); ++subsystem)
+			{
+				numberOfAllocationsAtSteadyState[subsystem] = getNumberOfAllocations(static_cast<AllocationSubsystem::Type>(subsystem));
+			}
+			__atomic_store_n(&steadyStateHasBegun, true, __ATOMIC_RELEASE);
+		}
+	}
+
+	boolean isSteadyState(void)
+	{
+		return __atomic_load_n(&steadyStateHasBegun, __ATOMIC_ACQUIRE);
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Output
+
+	void writeAllocationMetrics(std::ostream &os)
+	{
+		if (AllocationAccountingIsActive)
+		{
+			MetricsInternal::writeMetricHeader(os, "ehz_allocations_total", "counter", "Heap allocations with operator new since program start");
+			for (uint subsystem = null<uint>(); subsystem < static_cast<uint>(AllocationSubsystem::NumberOfSubsystems); ++subsystem)
+			{
+				os << "ehz_allocations_total{subsystem=\"" << AllocationSubsystemName[subsystem] << "\"} " << getNumberOfAllocations(static_cast<AllocationSubsystem::Type>(subsystem)) << '\n';
+			}
+			MetricsInternal::writeMetricHeader(os, "ehz_steady_state_allocations_total", "counter", "Heap allocations with operator new after the warm up. Shall be 0");
+			for (uint subsystem = null<uint>(); subsystem < static_cast<uint>(AllocationSubsystem::NumberOfSubsystems); ++subsystem)
+			{
+				os << "ehz_steady_state_allocations_total{subsystem=\"" << AllocationSubsystemName[subsystem] << "\"} " << getNumberOfSteadyStateAllocations(static_cast<AllocationSubsystem::Type>(subsystem)) << '\n';
+			}
+		}
+	}
+
+	boolean reportSteadyStateAllocations(std::ostream &os)
+	{
+		boolean rc = isSteadyState();
+		if (!rc)
+		{
+			os << "Allocations: The warm up of " << AllocationWarmUpSmlFiles << " SML files per EHZ has not been finished" << std::endl;
+		}
+		const boolean isChecked = rc;
+		for (uint subsystem = null<uint>(); isChecked && (subsystem < static_cast<uint>(AllocationSubsystem::NumberOfSubsystems)); ++subsystem)
+		{
+			const u64 numberOfSteadyStateAllocations = getNumberOfSteadyStateAllocations(static_cast<AllocationSubsystem::Type>(subsystem));
+			if (null<u64>() != numberOfSteadyStateAllocations)
+			{
+				os << "Allocations in the steady state: " << AllocationSubsystemName[subsystem] << ' ' << numberOfSteadyStateAllocations << std::endl;
+				// The server allocates for each request. That is not an error
+				if (AllocationSubsystem::Server != subsystem)
+				{
+					rc = false;
+				}
+			}
+		}
+		if (rc)
+		{
+			os << "Allocations: None in the steady state outside of the server" << std::endl;
+		}
+		return rc;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Replacement of the global operator new
+
+#ifdef ALLOCATION_ACCOUNTING
+
+	namespace AllocationInternal
+	{
+		namespace
+		{
+			inline void *allocate(const size_t size)
+			{
+				//lint -e{534}
+				__atomic_add_fetch(&numberOfAllocations[allocationSubsystemForThisThread], 1ULL, __ATOMIC_RELAXED);
+				return malloc((null<size_t>() == size) ? 1U : size);
+			}
+		}
+	}
+
+	void *operator new(const size_t size)
+	{
+		void *const memory = AllocationInternal::allocate(size);
+		if (null<void *>() == memory)
+		{
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+	void *operator new[](const size_t size) { return operator new(size); }
+	void *operator new(const size_t size, const std::nothrow_t &) throw() { return AllocationInternal::allocate(size); }
+	void *operator new[](const size_t size, const std::nothrow_t &) throw() { return AllocationInternal::allocate(size); }
+	void operator delete(void *const memory) throw() { free(memory); }
+	void operator delete[](void *const memory) throw() { free(memory); }
+	void operator delete(void *const memory, const size_t) throw() { free(memory); }
+	void operator delete[](void *const memory, const size_t) throw() { free(memory); }
+	void operator delete(void *const memory, const std::nothrow_t &) throw() { free(memory); }
+	void operator delete[](void *const memory, const std::nothrow_t &) throw() { free(memory); }
+
+#endif
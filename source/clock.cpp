@@ -0,0 +1,94 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// clock.cpp
+//
+// General Description
+//
+// Coarse wall clock per thread and lazy formatting of time stamps. See clock.hpp
+//
+
+
+
+#include "clock.hpp"
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Coarse clock
+
+namespace ClockInternal
+{
+	namespace
+	{
+		// Big enough for the formatted time
+		const size_t TimeStringSize = 32U;
+
+		// Thread local static data, so initialized with 0 for every thread. 0 means: No reactor in this thread
+		//lint -e{956}
+		__thread time_t coarseRealTime;
+
+		// The last formatted time of this thread
+		//lint -e{956}
+		__thread time_t lastFormattedTime;
+		//lint -e{956}
+		__thread mchar lastFormattedTimeString[TimeStringSize];
+
+		// The coarse clock has the resolution of the scheduler tick. This is more than enough for seconds.
+		// And it is read without system call
+		time_t readCoarseRealTime(void)
+		{
+			struct timespec realTime;
+			//lint -e{534}
+			clock_gettime(CLOCK_REALTIME_COARSE, &realTime);
+			return realTime.tv_sec;
+		}
+	}
+
+	void refreshCoarseClock(void)
+	{
+		coarseRealTime = readCoarseRealTime();
+	}
+
+	time_t getCoarseRealTime(void)
+	{
+		return (null<time_t>() == coarseRealTime) ? readCoarseRealTime() : coarseRealTime;
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Formatting
+
+	// Only a new second needs localtime and strftime. The thread safe variant of localtime is used
+	const mchar *formatTime(const time_t timeToFormat)
+	{
+		if ((timeToFormat != lastFormattedTime) || ('\0' == lastFormattedTimeString[0]))
+		{
+			struct tm localTime;
+			//lint -e{534}
+			localtime_r(&timeToFormat, &localTime);
+			//lint --e(920)
+			(void)strftime(&lastFormattedTimeString[0], TimeStringSize, "%d.%m.%y %H:%M:%S", &localTime);
+			lastFormattedTime = timeToFormat;
+		}
+		return &lastFormattedTimeString[0];
+	}
+}
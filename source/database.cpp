@@ -1,657 +1,2230 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-//
-// General Description
-//
-// This is a part of a systems that reads data from electronic meters.
-// 
-// This data will be stored in a sqlite database.
-// So we inplement a data logger here.
-//
-// Some requirements
-//
-// We want to store measured values from the EHZ into a database
-// The data can be retrieved from the database to show historical values
-// The time of the measured values is important
-// Measured values shall be stored at fixed intervals. This we call Base interval
-// The base interval is x s
-// It shall be possible to retrieve values for multiples of the base interval
-// The folowing periodes shall be used: 30s, 1min, 5min, 10min, 30min, 1h, 2h, 6h, 12h, 1day, 1week. 1 month, 1 year
-// The database shall be created based on the EHZ configuration
-//
-// So as per definition of the EHZ System we will create the necessary fields in the database.
-// At program start it will be checked, if the database exists. If not, it will be created.
-// The names of the fields, the number of the fields and all associated data will be derived from the
-// EHZ configuration.
-// 
-// To make evaluation of the data easier and to avoid slow queries, we do not only store a timestamp
-// per record. Additionally we will store a flag to indicate that a multiple of the timestamp was hit.
-// With that queries like, give me all values for periods of 5 minutes easier.
-//
-
- 
-
-//lint -e{830,1960,1963}
-
-
-#include "database.hpp"
-#include "userinterface.hpp"
-#include "ehzconfig.hpp"
-
-#include <sstream>
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 1. General definitions
-
-	// Then names column / field / attribute are used with the same meaning
-	
-	namespace DatabaseInternal
-	{
-
-	// ------------------------------------------------------------------------------------------------------------------------------
-	// 1.1 SQLITE 3 column type names and column names
-
-		// SQLLITE types
-		const mchar sqliteTypeNameInteger[] = "INTEGER";
-		const mchar sqliteTypeNameBoolean[] = "BOOLEAN";
-		const mchar sqliteTypeNameText[] = "TEXT";
-		const mchar sqliteTypeNameFloat[] = "FLOAT";
-
-		// Basic columns names. Additional text will be appended to distinguish the columns
-		const mchar timeBaseColumnName[] = "timeBase";
-		const mchar *const timeBaseColumnType = sqliteTypeNameInteger;
-		const mchar timeForOneEhzColumnName[] = "timeEhz";
-		const mchar timePeriodColumnName[] = "timePeriod";
-		const mchar unitColumnName[] = "unit";
-		const mchar ehzColumnName[] = "Ehz";
-		const mchar measuredValueColumnName[] = "measuredValue";
-		const mchar ehzSqliteDatabaseTableName[] = "ehzMeasuredDataValues";
-
-		
-
-	// ------------------------------------------------------------------------------------------------------------------------------
-	// 1.2 Default constructors. Do nothing specific. Call default constructors of struct members and initialize everyting to empty
-	
-		// For on EHZ
-		EhzColumnNameAndType::EhzColumnNameAndType(void) : 	acquisitionTime(),
-															measuredValueAndUnit()
-		{
-		}
-
-		//lint -e{1901,1911,1938}
-		// For the whole EHZ system
-		EhzSystemColumnNameAndType::EhzSystemColumnNameAndType(void) : 	timeBase(timeBaseColumnName, timeBaseColumnType),
-																		ehzTimePeriodNameAndType(),
-																		ehzColumnNameAndType()
-																		
-		{
-
-		}																
-
-	// ------------------------------------------------------------------------------------------------------------------------------
-	// 1.3 Creation of Strings for field/type names 
-		
-		
-		// For each EHZ we will store 
-		// - Time, when data has been read
-		//    For each value that the EHZ will give us we will store 
-		//		- Acquisition time
-		//      - The Value (Text or Double, depending on values type
-		//      - the Unit
-		void EhzSystemColumnNameAndType::buildEhzSystemColumnNameAndType(void)
-		{
-
-			// For all EHZ in the EHZ system 
-			for (uint noEhz = null<uint>(); noEhz < EhzInternal::MyNumberOfEhz; ++noEhz)
-			{
-				// At the beginning of each loop we set everything to empty
-				EhzColumnNameAndType ecnat;
-				ecnat.clear();
-
-				// Brackets because of name scoping
-				{
-					// We want to define one time for each EHZ i the EHZ system
-					// And several values and units for Each EHZ in the EHZ system 
-					// Build the name for the time field for one EHZ in the EHZ syte,
-					std::ostringstream tempBuf;
-					//lint -e{830,1960,1963,9050}
-					tempBuf << timeForOneEhzColumnName << noEhz; 
-					// and assign it
-					ecnat.acquisitionTime.columnName = tempBuf.str();
-				}
-				// And the ytpe for that column
-				ecnat.acquisitionTime.columnType = &sqliteTypeNameInteger[0];
-
-				
-				// Now for each value for one of the EHZ in the EHZ system
-				for (uint noemd = null<uint>(); noemd< NumberOfEhzMeasuredData; ++noemd)
-				{
-					// at the beginning of each loop iteration we set everything to empty
-					EhzColumnNameAndType::MeasuredValueAndUnit measuredValueAndUnit;
-					measuredValueAndUnit.clear();
-					
-					// Get the type of the value stored in the EHZ. Either Double or Text, or NULL (Nothing)
-					const EhzMeasuredDataType::Type emdt = EhzInternal::myEhzConfigDefinition[noEhz].ehzMeasuredDataType[noemd];
-					// If there is an associated value
-					if (EhzMeasuredDataType::Null != emdt)
-					{
-						// Build field name with the index of the value and the index of the EHZ
-						{
-							std::ostringstream tempBuf;
-							//lint -e{830,1960,1963,9050}
-							tempBuf << measuredValueColumnName << noemd << ehzColumnName << noEhz;
-							measuredValueAndUnit.measuredValue.columnName = tempBuf.str();
-						}
-						// Check the type of the value. Is either Number (Double) or Text
-						// and then define the type of the corresponding field
-						// Basically SQLITE doesnt care so much abaout types, but anyway. Lets assign the right type
-						if (EhzMeasuredDataType::Number == emdt)
-						{
-							// Type: Number / DOUBLE / Float
-							measuredValueAndUnit.measuredValue.columnType = &sqliteTypeNameFloat[0];
-						}
-						else
-						{
-							// Type: Text
-							measuredValueAndUnit.measuredValue.columnType = &sqliteTypeNameText[0];
-						}
-
-						// And the individual name of the unit with index of measured value and index of EHZ
-						{
-							std::ostringstream tempBuf;
-							//lint -e{830,1960,1963,9050}
-							tempBuf << unitColumnName << noemd << ehzColumnName << noEhz;
-							measuredValueAndUnit.unit.columnName = tempBuf.str();
-						}
-						// Unit is always of type TEXT
-						measuredValueAndUnit.unit.columnType = &sqliteTypeNameText[0];
-						// Add this instance to trhe array of names/types
-						ecnat.measuredValueAndUnit.push_back(measuredValueAndUnit);
-					}
-				}
-				// So, now all data for one EHZ has been defined
-				// Store it in the vector
-				ehzColumnNameAndType.push_back(ecnat);
-			}
-
-			// Now we will create the name and type strings for the period flag fields
-			{
-				
-				ColumnNameAndType cnat;
-				cnat.clear();
-				// All time period flag fields will be of type boolean
-				cnat.columnType = &sqliteTypeNameBoolean[0];
-				// For all flag fields
-				for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
-				{	
-					// Create name
-					std::ostringstream tempBuf;
-					//lint -e{830,1960,1963,9050}
-					tempBuf << timePeriodColumnName << EhzLogPeriodInS[period];
-					cnat.columnName = tempBuf.str();
-					// And add to the vector
-					ehzTimePeriodNameAndType.push_back(cnat);
-				}
-			}
-		}
-		
-		
-// ------------------------------------------------------------------------------------------------------------------------------
-// 2. Member functions for Database
-		
-	// --------------------------------------------------------------------------------------------------------------------------
-	// 2.1 Construction / Destruction of Databae object
-		
-		// -----------------------------
-		// 2.1.1 Standard constructor
-		// Do not use
-		// Sets everything to empty / Null
-		EhzDataBase::EhzDataBase(void) : 								ehzSystemColumnNameAndType(),
-																		ehzDatabaseName(), 
-																		dbHandle(null<sqlite3 *>()), 
-																		lastPeriodValue(EhzLogPeriodCount,null<EhzLogTimeUnit>()),
-																		insertMdl(),
-																		ddl(),
-																		insertStmt(null<sqlite3_stmt *>())
-		{
-		}
-		
-		
-		
-		// -----------------------------
-		// 2.1.2 Explicit constructor
-		// Create or open Database. Initialize internal structures. Create SQL String
-		// Prepare the insert statement
-		// Database path and name will be given
-		EhzDataBase::EhzDataBase(const std::string &ehzDatabaseNamel) : ehzSystemColumnNameAndType(),
-																		ehzDatabaseName(ehzDatabaseNamel),
-																		dbHandle(null<sqlite3 *>()),
-																		lastPeriodValue(EhzLogPeriodCount,null<EhzLogTimeUnit>()),
-																		insertMdl(),
-																		ddl(),
-																		insertStmt(null<sqlite3_stmt *>())
-																		
-		{
-			sqlite3_initialize( );	//lint !e534
-			
-			// Create the DDL (Data Definition language) string for the database creation
-			// and create the MDL for the insert statement
-			createSqlStrings();
-
-			
-			// If the database is not existing
-			if (!isExisting())
-			{
-				// then create it
-				//lint -e{534}
-				createDatabase();
-			}
-			// Open the database
-			open();
-			
-			// Read the last period values from the database and define database class internal values
-			initializeLastPeriodValues();
-			// SQLITE prepare statement for inserting values
-			//lint -e{971,534}
-			sqlite3_prepare_v2( dbHandle, insertMdl.c_str(), -1, &insertStmt, null<const mchar **>() );
-			//ui.msgf("Insert sql statement Prepare Result:   %d\n",rc);
-		}
-
-		// -----------------------------
-		// 2.1.3 Destructor
-		//lint -e{1579}
-		EhzDataBase::~EhzDataBase(void)
-		{
-			try
-			{
-				//lint -e{534}
-				// SQLITE Statement finalization
-				sqlite3_finalize( insertStmt );
-				// close the database
-				close();
-			}
-			catch(...)
-			{
-			}
-		}
-
-	// --------------------------------------------------------------------------------------------------------------------------
-	// 2.2 Database administration
-		
-		// -------------------
-		// 2.2.1 Open Database
-		void EhzDataBase::open(void)
-		{
-			
-			dbHandle = null<sqlite3 *>();
-			//lint -e{971}
-			const sint rc = sqlite3_open_v2(ehzDatabaseName.c_str(), &dbHandle, SQLITE_OPEN_READWRITE, null<mchar *>() );
-			if (SQLITE_OK!= rc )
-			{
-				dbHandle = null<sqlite3 *>();
-				ui << "Could not open database"  << std::endl;
-			} 
-			else
-			{
-				ui <<"Database '" << ehzDatabaseName << "' opened"  << std::endl;
-			}
-		}
-
-		// -------------------
-		// 2.2.2 Close Database
-		void EhzDataBase::close(void)
-		{
-			if (isOpen())
-			{
-				//lint -e{534}
-				sqlite3_close(dbHandle);
-			}
-			dbHandle = null<sqlite3 *>();
-		}
-
-		// -------------------------------
-		// 2.2.2 CHeck if database is existing
-		boolean EhzDataBase::isExisting(void) const 
-		{
-			// LOcal instance. Shall not interfere with class database handle
-			sqlite3 *db = null<sqlite3 *>();
-			
-			// Try to open
-			//lint -e{971}
-			const sint rc = sqlite3_open_v2( ehzDatabaseName.c_str(), &db, SQLITE_OPEN_READONLY, null<mchar *>() );
-			boolean existing = false;
-			// If we could open the database, then it is existing
-			if (SQLITE_OK == rc)
-			{
-				// CLose again
-				//lint -e{534}
-				sqlite3_close(db);
-				existing = true;
-			}
-			return existing;
-		}
-
-
-		// ---------------------------------------------
-		// 2.2.3  Create a new database and it's schema
-		void EhzDataBase::createDatabase(void) const
-		{
-			sqlite3 *db = null<sqlite3 *>();
-			// Set flags. Open with read write and create
-			//lint -e{921}
-			const sint flags = static_cast<sint>(static_cast<uint>(SQLITE_OPEN_READWRITE) | static_cast<uint>(SQLITE_OPEN_CREATE));
-			//lint -e{971}
-			const sint rc = sqlite3_open_v2( ehzDatabaseName.c_str(), &db, flags, null<mchar *>() );
-			if (SQLITE_OK == rc)
-			{
-				// We could open and create
-				// Now create the needed table
-				//lint -e{971,534}
-				sqlite3_exec( db, ddl.c_str(), null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>() ); 	 
-				// Check and inform on result
-				//ui.msgf("DB Creation result: %d\n",rc);
-				//lint -e{534}
-				sqlite3_close(db);
-			}    
-		}
-
-
-		// -------------------------------------------------------------------
-		// 2.2.4  Create SQL strings
-		// For database creation and for inserting values into the main table
-		void EhzDataBase::createSqlStrings(void)
-		{
-			// We will use SQLITE prepared statements with parameters
-			// Since the columns of the database are deduced from the EHZ configuration
-			// We do not know the count in advance. The columns are created dynamically.
-			sint parameterCount = null<sint>();
-			
-			// Build the strings for the column name and type
-			ehzSystemColumnNameAndType.buildEhzSystemColumnNameAndType();
-			
-			// Reset the ddl and the insert Mdl strings
-			ddl.clear();
-			insertMdl.clear();
-			
-			// Start building the ddl SQL string
-			// We want to create a table. Name is a constant
-			ddl += "CREATE TABLE ";
-			ddl += &ehzSqliteDatabaseTableName[0];
-			ddl += " (\n";
-			
-			// Start building the insert mdl string
-			// We want to insert data in the main table
-			insertMdl += "INSERT INTO ";
-			insertMdl += &ehzSqliteDatabaseTableName[0];
-			insertMdl += " (\n";
-			
-			// Create the time base column, where the time of acquisition of the complete record will be stored
-			ddl += ehzSystemColumnNameAndType.timeBase.columnName;
-			ddl += " ";
-			ddl += ehzSystemColumnNameAndType.timeBase.columnType;
-			// This is also the primary key of the main table
-			ddl += " PRIMARY KEY NOT NULL";
-			
-			// mdl part
-			insertMdl += ehzSystemColumnNameAndType.timeBase.columnName;
-			// and, one new parameter
-			++parameterCount;
-			
-			// To make evaluation of the data easier and to avoid slow queries, we do not only store a timestamp
-			// per record. Additionally we will store a flag to indicate that a multiple of the timestamp was hit.
-			// With that queries like, give me all values for periods of 5 minutes will be easier.
-			// For all time flags
-			for (std::vector<ColumnNameAndType>::iterator cnati = ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.begin(); cnati != ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.end(); ++cnati)
-			{
-				ddl += ",\n";
-				ddl += (*cnati).columnName;
-				ddl += " ";
-				ddl += (*cnati).columnType;
-				ddl += " DEFAULT FALSE";
-
-				insertMdl += ",\n";
-				insertMdl += (*cnati).columnName;
-				++parameterCount;
-			}
-			
-			// So, now the columns for each EHZ
-			for (std::vector<EhzColumnNameAndType>::iterator ehzi = ehzSystemColumnNameAndType.ehzColumnNameAndType.begin(); ehzi != ehzSystemColumnNameAndType.ehzColumnNameAndType.end(); ++ehzi)
-			{
-				// Every EHZ has its own time stamp for the acquired data
-				ddl += ",\n";
-				ddl += (*ehzi).acquisitionTime.columnName;
-				ddl += " ";
-				ddl += (*ehzi).acquisitionTime.columnType;
-				
-				insertMdl += ",\n";
-				insertMdl += (*ehzi).acquisitionTime.columnName;
-				++parameterCount;
-
-				// And every EHZ has up to x  measured values and units
-				for (std::vector<EhzColumnNameAndType::MeasuredValueAndUnit>::iterator mvi = (*ehzi).measuredValueAndUnit.begin(); mvi != (*ehzi).measuredValueAndUnit.end(); ++mvi)
-				{
-					ddl += ",\n";
-					ddl += (*mvi).measuredValue.columnName;
-					ddl += " ";
-					ddl += (*mvi).measuredValue.columnType;
-					
-					ddl += ",\n";
-					ddl += (*mvi).unit.columnName;
-					ddl += " ";
-					ddl += (*mvi).unit.columnType;
-					
-					insertMdl += ",\n";
-					insertMdl += (*mvi).measuredValue.columnName;
-					insertMdl += ",\n";
-					insertMdl += (*mvi).unit.columnName;
-					++parameterCount;
-					++parameterCount;
-				}
-			}
-			// Finalize ddl
-			ddl += ");\n";
-
-			// Add the parameter part to the mdl
-			// We counted the number of parameters
-			insertMdl += ")\nVALUES (\n?1";
-			
-			for (sint i = 2; i <= parameterCount;++i)
-			{
-				insertMdl += ",\n?";
-				std::ostringstream tempBuf;
-				//lint -e{830,1960,1963,9050}
-				tempBuf << i;
-				insertMdl += tempBuf.str();
-			}
-			// Finalize mdl statement
-			insertMdl += "\n);\n";
-		}	
-
-
-
-	// --------------------------------------------------------------------------------------------------------------------------
-	// 2.3 Data manipulation
-			
-		// -------------------------------------------------------------------
-		// 2.3.1  Set last period values
-			
-		// To make evaluation of the data easier and to avoid slow queries, we do not only store a timestamp
-		// per record. Additionally we will store a flag to indicate that a multiple of the timestamp was hit.
-		// With that queries like, give me all values for periods of 5 minutes will be easier.		
-		
-		// We store internally, at which time the last flag has been set
-		// Then we can compare against this time stamps and set the flags accordingly
-		
-		// When this application is started, then no "old values" are existing
-		// So we will check the database and read for each flag the "last time", when it has been set
-		
-		void EhzDataBase::initializeLastPeriodValues(void)
-		{
-			// First we will bild the sql string
-			std::string sql;
-			sint i = null<sint>();
-			// For all flags
-			for (std::vector<ColumnNameAndType>::iterator cnati = ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.begin(); cnati != ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.end(); ++cnati)
-			{
-				// New iteration. Clear string. Then build new query string
-				sql.clear();
-				sql += "SELECT ";
-				sql += &timeBaseColumnName[0];
-				sql += " FROM ";
-				sql += &ehzSqliteDatabaseTableName[0];
-				sql += " WHERE ";
-				sql += (*cnati).columnName;
-				sql += "='TRUE' ORDER BY ";
-				sql += &timeBaseColumnName[0];
-				sql += " DESC LIMIT 1;";
-				//lastPeriodSqlStrings.push_back(sql);
-				//ui.msgf("%s\n",sql.c_str());
-				// We will prepare the statement and step through the results
-				sqlite3_stmt *stmt = null<sqlite3_stmt *>();
-				//lint -e{971,534}
-				sqlite3_prepare_v2( dbHandle, sql.c_str(), -1, &stmt, null<const mchar **>() );
-				
-				// Execute the query
-				//ui.msgf("Prepare Result:   %d\n",rc);
-				if (SQLITE_ROW == sqlite3_step(stmt))
-				{
-					// We got a result, a time. Ok read it from the database and store it internally for later usage
-					//lint -e{1960,732,917,921}
-					lastPeriodValue[i] = static_cast<EhzLogTimeUnit>(sqlite3_column_int64( stmt, 0));
-					//ui.msgf("%s: ++++++++++ %d\n", sql.c_str(),lastPeriodValue[i]);
-				}
-				else
-				{
-					// We could not read a value. We do not care and set the internal value to null.
-					// Then, for the next storage of values, the flage will be guaranteed be set
-					//lint -e{1960,732,917,921}
-					lastPeriodValue[i] = null<EhzLogTimeUnit>();
-					//ui.msgf("%s:   0\n",sql.c_str());
-				}
-				//lint -e{534}
-				// Done with this flag
-				sqlite3_finalize( stmt );
-				// Work on next flag
-				++i;
-			}
-		}
-
-
-		// -------------------------------------------------------------------
-		// 2.3.2  Store measured values
-		
-		// Main databases function and fucntionality
-		// Store the measured values from the EHZ System
-		// +time stamps and time flags
-	
-		void EhzDataBase::storeMeasuredValues(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz)
-		{
-			//lint --e{534,917}
-			// We use an SQLITE prepared statement with parameters
-			// We will bin all values to the prepared statement
-			// This variable is the index of the parameter for the related value
-			sint pidx = 1;
-
-			//Get time of now
-			//lint -e{921}
-			const EhzLogTimeUnit nowTime = static_cast<EhzLogTimeUnit>(time(null<time_t*>() ));
-			
-			// Timestamp for this record
-			sqlite3_bind_int(insertStmt, pidx, nowTime);
-			++pidx;
-
-			//ui.msgf("Now: %ld ", nowTime);
-			
-			// To make evaluation of the data easier and to avoid slow queries, we do not only store a timestamp
-			// per record. Additionally we will store a flag to indicate that a multiple of the timestamp was hit.
-			// With that queries like, give me all values for periods of 5 minutes, will be easier.
-			
-			// Check if we will set a period flag
-			for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
-			{
-
-				// If the respective number of seconds elapsed
-				if (nowTime >= (lastPeriodValue[period] + EhzLogPeriodInS[period]))
-				{
-					//ui.msgf("(%ld-%ld)->1 ",lastPeriodValue[period],EhzLogPeriodInS[period]);
-
-					// Store new Value: Time of now
-					lastPeriodValue[period] = nowTime;
-					// And set flag
-					sqlite3_bind_int(insertStmt, pidx, 1);   // true
-					++pidx;
-				}
-				else
-				{
-					// No, no multiple value hit
-					// Set flag to false
-					sqlite3_bind_int(insertStmt, pidx, 0);   // False
-					++pidx;
-				}
-			}
-			
-
-			// Now for all EHZ in the EHZ system
-			for (uint noEhz = null<uint>(); noEhz < EhzInternal::MyNumberOfEhz; ++noEhz)
-			{
-				// Time, when data has been acquired by one single EHZ
-				sqlite3_bind_int(insertStmt, pidx, allMeasuredValuesForAllEhz[noEhz].timeWhenDataHasBeenEvaluated );
-				++pidx;
-				// Now for each value for one of the EHZ in the EHZ system
-				for (uint noemd = null<uint>(); noemd< NumberOfEhzMeasuredData; ++noemd)
-				{
-					// Get the type of the value stored in the EHZ. Either Double or Text, or NULL (Nothing)
-					const EhzMeasuredDataType::Type emdt = EhzInternal::myEhzConfigDefinition[noEhz].ehzMeasuredDataType[noemd];
-					// If there is an associated value
-					if (EhzMeasuredDataType::Null != emdt)
-					{
-						// Check the type of the value. Is either Number (Double) or Text
-						// and then define the type of the corresponding field
-						// Basically SQLITE doesnt care so much abaout types, but anyway. Lets assign the right type
-						if (EhzMeasuredDataType::Number == emdt )
-						{
-							// Type: Number / DOUBLE / Float
-							sqlite3_bind_double(insertStmt, pidx, allMeasuredValuesForAllEhz[noEhz].measuredValueForOneEhz[noemd].doubleValue);
-							++pidx;
-						}
-						else
-						{
-							// Type: Text
-							sqlite3_bind_text(insertStmt, pidx,allMeasuredValuesForAllEhz[noEhz].measuredValueForOneEhz[noemd].smlByteString.c_str(),-1,null<void(*)(void*)>());
-							++pidx;
-						}
-						// Now bind the unit
-						sqlite3_bind_text(insertStmt, pidx,allMeasuredValuesForAllEhz[noEhz].measuredValueForOneEhz[noemd].unit.c_str(),-1,null<void(*)(void*)>());
-						++pidx;
-					}
-				}
-			}
-			// Store all values in the database
-			sqlite3_step( insertStmt );
-			// And make the prepared statement ready for next usage
-			sqlite3_reset( insertStmt );
-		}
-		
-		
-		
-	} // End of namespace
-
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+//
+// General Description
+//
+// This is a part of a systems that reads data from electronic meters.
+// 
+// This data will be stored in a sqlite database.
+// So we inplement a data logger here.
+//
+// Some requirements
+//
+// We want to store measured values from the EHZ into a database
+// The data can be retrieved from the database to show historical values
+// The time of the measured values is important
+// Measured values shall be stored at fixed intervals. This we call Base interval
+// The base interval is x s
+// It shall be possible to retrieve values for multiples of the base interval
+// The folowing periodes shall be used: 30s, 1min, 5min, 10min, 30min, 1h, 2h, 6h, 12h, 1day, 1week. 1 month, 1 year
+// The database shall be created based on the EHZ configuration
+//
+// So as per definition of the EHZ System we will create the necessary fields in the database.
+// At program start it will be checked, if the database exists. If not, it will be created.
+// The names of the fields, the number of the fields and all associated data will be derived from the
+// EHZ configuration.
+// 
+// To make evaluation of the data easier and to avoid slow queries, we do not only store a timestamp
+// per record. Additionally we will store a flag to indicate that a multiple of the timestamp was hit.
+// With that queries like, give me all values for periods of 5 minutes easier.
+//
+
+ 
+
+//lint -e{830,1960,1963}
+
+
+#include "database.hpp"
+#include "userinterface.hpp"
+#include "ehzconfig.hpp"
+#include "metrics.hpp"
+#include "allocation.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <sched.h>
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General definitions
+
+	// Then names column / field / attribute are used with the same meaning
+	
+	namespace DatabaseInternal
+	{
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 1.1 SQLITE 3 column type names and column names
+
+		// SQLLITE types
+		const mchar sqliteTypeNameInteger[] = "INTEGER";
+		const mchar sqliteTypeNameBoolean[] = "BOOLEAN";
+		const mchar sqliteTypeNameText[] = "TEXT";
+		const mchar sqliteTypeNameFloat[] = "FLOAT";
+
+		// Basic columns names. Additional text will be appended to distinguish the columns
+		const mchar timeBaseColumnName[] = "timeBase";
+		const mchar *const timeBaseColumnType = sqliteTypeNameInteger;
+		const mchar timeForOneEhzColumnName[] = "timeEhz";
+		const mchar timePeriodColumnName[] = "timePeriod";
+		const mchar unitColumnName[] = "unit";
+		const mchar ehzColumnName[] = "Ehz";
+		const mchar measuredValueColumnName[] = "measuredValue";
+		const mchar ehzSqliteDatabaseTableName[] = "ehzMeasuredDataValues";
+		// Tables and columns of the narrow schema
+		const mchar ehzSqliteRecordTableName[] = "ehzRecords";
+		const mchar ehzSqliteSampleTableName[] = "ehzSamples";
+		const mchar ehzSqliteDictionaryTableName[] = "ehzValueDictionary";
+		const mchar meterColumnName[] = "meter";
+		const mchar valueIdColumnName[] = "valueId";
+		const mchar valueColumnName[] = "value";
+		const mchar nameColumnName[] = "name";
+		const mchar acquisitionTimeName[] = "Acquisition time";
+		const mchar acquisitionTimeUnit[] = "s";
+		// Roll-up tables. The name of the table is followed by the period in seconds
+		const mchar ehzSqliteRollUpTableName[] = "ehzRollUp";
+		const mchar bucketStartColumnName[] = "bucketStart";
+		const mchar numberOfSamplesColumnName[] = "numberOfSamples";
+		// Suffixes for the aggregated values. In the order of the columns
+		const mchar *const rollUpColumnSuffix[] = { "Min", "Max", "Avg", "Last" };
+		const uint NumberOfRollUpColumnSuffixes = sizeof(rollUpColumnSuffix) / sizeof(rollUpColumnSuffix[0]);
+		// Followed by the number of samples for this value. Meters, that did not yet report, are not counted
+		const mchar rollUpCountColumnSuffix[] = "Count";
+		const uint NumberOfRollUpColumnsPerValue = NumberOfRollUpColumnSuffixes + 1U;
+		// Table with the last time, when a period flag has been set. One row per period
+		const mchar ehzSqliteLastPeriodTableName[] = "ehzLastPeriod";
+		const mchar periodColumnName[] = "period";
+		const mchar lastTimeColumnName[] = "lastTime";
+		// A backup is written into a file with this suffix and renamed, when it is complete
+		const mchar backupTemporarySuffix[] = ".tmp";
+
+		
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 1.2 Default constructors. Do nothing specific. Call default constructors of struct members and initialize everyting to empty
+	
+		// For on EHZ
+		EhzColumnNameAndType::EhzColumnNameAndType(void) : 	acquisitionTime(),
+															measuredValueAndUnit()
+		{
+		}
+
+		//lint -e{1901,1911,1938}
+		// For the whole EHZ system
+		EhzSystemColumnNameAndType::EhzSystemColumnNameAndType(void) : 	timeBase(timeBaseColumnName, timeBaseColumnType),
+																		ehzTimePeriodNameAndType(),
+																		ehzColumnNameAndType()
+																		
+		{
+
+		}																
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 1.3 Creation of Strings for field/type names 
+		
+		
+		// For each EHZ we will store 
+		// - Time, when data has been read
+		//    For each value that the EHZ will give us we will store 
+		//		- Acquisition time
+		//      - The Value (Text or Double, depending on values type
+		//      - the Unit
+		void EhzSystemColumnNameAndType::buildEhzSystemColumnNameAndType(void)
+		{
+
+			// For all EHZ in the EHZ system 
+			for (uint noEhz = null<uint>(); noEhz < EhzInternal::getNumberOfEhz(); ++noEhz)
+			{
+				// At the beginning of each loop we set everything to empty
+				EhzColumnNameAndType ecnat;
+				ecnat.clear();
+
+				// Brackets because of name scoping
+				{
+					// We want to define one time for each EHZ i the EHZ system
+					// And several values and units for Each EHZ in the EHZ system 
+					// Build the name for the time field for one EHZ in the EHZ syte,
+					std::ostringstream tempBuf;
+					//lint -e{830,1960,1963,9050}
+					tempBuf << timeForOneEhzColumnName << noEhz; 
+					// and assign it
+					ecnat.acquisitionTime.columnName = tempBuf.str();
+				}
+				// And the ytpe for that column
+				ecnat.acquisitionTime.columnType = &sqliteTypeNameInteger[0];
+
+				
+				// Now for each value for one of the EHZ in the EHZ system
+				for (uint noemd = null<uint>(); noemd< NumberOfEhzMeasuredData; ++noemd)
+				{
+					// at the beginning of each loop iteration we set everything to empty
+					EhzColumnNameAndType::MeasuredValueAndUnit measuredValueAndUnit;
+					measuredValueAndUnit.clear();
+					
+					// Get the type of the value stored in the EHZ. Either Double or Text, or NULL (Nothing)
+					const EhzMeasuredDataType::Type emdt = EhzInternal::getEhzConfigDefinition(noEhz).ehzMeasuredDataType[noemd];
+					// If there is an associated value
+					if (EhzMeasuredDataType::Null != emdt)
+					{
+						// Build field name with the index of the value and the index of the EHZ
+						{
+							std::ostringstream tempBuf;
+							//lint -e{830,1960,1963,9050}
+							tempBuf << measuredValueColumnName << noemd << ehzColumnName << noEhz;
+							measuredValueAndUnit.measuredValue.columnName = tempBuf.str();
+						}
+						// Check the type of the value. Is either Number (Double) or Text
+						// and then define the type of the corresponding field
+						// Basically SQLITE doesnt care so much abaout types, but anyway. Lets assign the right type
+						if (EhzMeasuredDataType::Number == emdt)
+						{
+							// Type: Number / DOUBLE / Float
+							measuredValueAndUnit.measuredValue.columnType = &sqliteTypeNameFloat[0];
+						}
+						else
+						{
+							// Type: Text
+							measuredValueAndUnit.measuredValue.columnType = &sqliteTypeNameText[0];
+						}
+
+						// And the individual name of the unit with index of measured value and index of EHZ
+						{
+							std::ostringstream tempBuf;
+							//lint -e{830,1960,1963,9050}
+							tempBuf << unitColumnName << noemd << ehzColumnName << noEhz;
+							measuredValueAndUnit.unit.columnName = tempBuf.str();
+						}
+						// Unit is always of type TEXT
+						measuredValueAndUnit.unit.columnType = &sqliteTypeNameText[0];
+						// Add this instance to trhe array of names/types
+						ecnat.measuredValueAndUnit.push_back(measuredValueAndUnit);
+					}
+				}
+				// So, now all data for one EHZ has been defined
+				// Store it in the vector
+				ehzColumnNameAndType.push_back(ecnat);
+			}
+
+			// Now we will create the name and type strings for the period flag fields
+			{
+				
+				ColumnNameAndType cnat;
+				cnat.clear();
+				// All time period flag fields will be of type boolean
+				cnat.columnType = &sqliteTypeNameBoolean[0];
+				// For all flag fields
+				for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
+				{	
+					// Create name
+					std::ostringstream tempBuf;
+					//lint -e{830,1960,1963,9050}
+					tempBuf << timePeriodColumnName << EhzLogPeriodInS[period];
+					cnat.columnName = tempBuf.str();
+					// And add to the vector
+					ehzTimePeriodNameAndType.push_back(cnat);
+				}
+			}
+		}
+		
+		
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Member functions for Database
+		
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 2.1 Construction / Destruction of Databae object
+		
+		// -----------------------------
+		// 2.1.1 Standard constructor
+		// Do not use
+		// Sets everything to empty / Null
+		EhzDataBase::EhzDataBase(void) : 								ehzSystemColumnNameAndType(),
+																		ehzDatabaseName(), 
+																		databaseSchema(EhzDatabaseSchema),
+																		recordTableName(&ehzSqliteDatabaseTableName[0]),
+																		dbHandle(null<sqlite3 *>()), 
+																		lastPeriodValue(EhzLogPeriodCount,null<EhzLogTimeUnit>()),
+																		replaceLastPeriodStmt(null<sqlite3_stmt *>()),
+																		insertMdl(),
+																		ddl(),
+																		recordColumns(),
+																		insertStmt(null<sqlite3_stmt *>()),
+																		insertSampleMdl(),
+																		replaceDictionaryMdl(),
+																		insertSampleStmt(null<sqlite3_stmt *>()),
+																		replaceDictionaryStmt(null<sqlite3_stmt *>()),
+																		dictionaryUnit(EhzInternal::getNumberOfEhz() * NumberOfEhzMeasuredData),
+																		writeBehindQueue(WriteBehindMaxNumberOfRecords),
+																		numberOfQueuedRecords(null<uint>()),
+																		writeBehindMaxNumberOfRecords(WriteBehindMaxNumberOfRecords),
+																		writeBehindMaxAgeInS(WriteBehindMaxAgeInS),
+																		changeDetection(),
+																		rollUpSource(),
+																		rollUp(EhzLogPeriodCount),
+																		rollUpAtLastCommit(EhzLogPeriodCount),
+																		rollUpDdl(),
+																		rollUpReplaceMdl(),
+																		rollUpSelectSql(),
+																		rollUpTableName(),
+																		rollUpColumns(),
+																		rollUpReplaceStmt(EhzLogPeriodCount, null<sqlite3_stmt *>()),
+																		rawDataRetentionInS(RawDataRetentionInS),
+																		lastRetentionCheck(null<EhzLogTimeUnit>()),
+																		backupName(),
+																		backupDbHandle(null<sqlite3 *>()),
+																		backup(null<sqlite3_backup *>()),
+																		backupPagesPerStep(1),
+																		backupBudgetInBytesPerS(DatabaseBackupBudgetInBytesPerS),
+																		backupStepPeriodInMs(DatabaseBackupStepPeriodInMs)
+		{
+		}
+		
+		
+		
+		// -----------------------------
+		// 2.1.2 Explicit constructor
+		// Create or open Database. Initialize internal structures. Create SQL String
+		// Prepare the insert statement
+		// Database path and name will be given
+		EhzDataBase::EhzDataBase(const std::string &ehzDatabaseNamel, const DatabaseSchema::Type databaseSchemal) : 
+																		ehzSystemColumnNameAndType(),
+																		ehzDatabaseName(ehzDatabaseNamel),
+																		databaseSchema(databaseSchemal),
+																		recordTableName((DatabaseSchema::Narrow == databaseSchemal) ? &ehzSqliteRecordTableName[0] : &ehzSqliteDatabaseTableName[0]),
+																		dbHandle(null<sqlite3 *>()),
+																		lastPeriodValue(EhzLogPeriodCount,null<EhzLogTimeUnit>()),
+																		replaceLastPeriodStmt(null<sqlite3_stmt *>()),
+																		insertMdl(),
+																		ddl(),
+																		recordColumns(),
+																		insertStmt(null<sqlite3_stmt *>()),
+																		insertSampleMdl(),
+																		replaceDictionaryMdl(),
+																		insertSampleStmt(null<sqlite3_stmt *>()),
+																		replaceDictionaryStmt(null<sqlite3_stmt *>()),
+																		dictionaryUnit(EhzInternal::getNumberOfEhz() * NumberOfEhzMeasuredData),
+																		writeBehindQueue(WriteBehindMaxNumberOfRecords),
+																		numberOfQueuedRecords(null<uint>()),
+																		writeBehindMaxNumberOfRecords(WriteBehindMaxNumberOfRecords),
+																		writeBehindMaxAgeInS(WriteBehindMaxAgeInS),
+																		changeDetection(),
+																		rollUpSource(),
+																		rollUp(EhzLogPeriodCount),
+																		rollUpAtLastCommit(EhzLogPeriodCount),
+																		rollUpDdl(),
+																		rollUpReplaceMdl(),
+																		rollUpSelectSql(),
+																		rollUpTableName(),
+																		rollUpColumns(),
+																		rollUpReplaceStmt(EhzLogPeriodCount, null<sqlite3_stmt *>()),
+																		rawDataRetentionInS(RawDataRetentionInS),
+																		lastRetentionCheck(null<EhzLogTimeUnit>()),
+																		backupName(),
+																		backupDbHandle(null<sqlite3 *>()),
+																		backup(null<sqlite3_backup *>()),
+																		backupPagesPerStep(1),
+																		backupBudgetInBytesPerS(DatabaseBackupBudgetInBytesPerS),
+																		backupStepPeriodInMs(DatabaseBackupStepPeriodInMs)
+																		
+		{
+			sqlite3_initialize( );	//lint !e534
+			
+			// Create the DDL (Data Definition language) string for the database creation
+			// and create the MDL for the insert statement
+			createSqlStrings();
+
+			
+			// If the database is not existing
+			if (!isExisting())
+			{
+				// then create it
+				//lint -e{534}
+				createDatabase();
+			}
+			// Open the database
+			open();
+			
+			if (DatabaseSchema::Narrow == databaseSchema)
+			{
+				// The database may have been created with the wide schema. Then the narrow tables are missing 
+				//lint -e{534}
+				executeSql(ddl.c_str());
+				//lint -e{971,534}
+				sqlite3_prepare_v2( dbHandle, insertSampleMdl.c_str(), -1, &insertSampleStmt, null<const mchar **>() );
+				//lint -e{971,534}
+				sqlite3_prepare_v2( dbHandle, replaceDictionaryMdl.c_str(), -1, &replaceDictionaryStmt, null<const mchar **>() );
+				// Take over old data
+				migrateFromWideSchema();
+			}
+			
+			// Read the last period values from the database and define database class internal values
+			initializeLastPeriodValues();
+			// The table may have been created with another configuration
+			if (isOpen())
+			{
+				addMissingColumns(recordTableName, recordColumns);
+			}
+			// SQLITE prepare statement for inserting values
+			//lint -e{971}
+			if (isOpen() && (SQLITE_OK != sqlite3_prepare_v2( dbHandle, insertMdl.c_str(), -1, &insertStmt, null<const mchar **>() )))
+			{
+				showErrorMessage(std::string("Database: Table ") + recordTableName + " can not be written: " + sqlite3_errmsg(dbHandle));
+			}
+			
+			// Roll-up tables may be missing in older databases
+			prepareRollUps();
+		}
+
+		// -----------------------------
+		// 2.1.3 Queued record. Measured values for all EHZ
+		EhzDataBase::QueuedRecord::QueuedRecord(void) : timeBase(null<EhzLogTimeUnit>()), periodFlags(null<u32>()), allMeasuredValuesForAllEhz(EhzInternal::getNumberOfEhz()),
+																	reportedValues(EhzInternal::getNumberOfEhz(), EhzInternal::AllMeasuredValuesReported), isStored(true)
+		{
+		}
+		
+		// -----------------------------
+		// 2.1.4 Destructor
+		//lint -e{1579}
+		EhzDataBase::~EhzDataBase(void)
+		{
+			try
+			{
+				// Write all records that are still in the queue
+				flush();
+				dropOldestQueuedRecords(numberOfQueuedRecords);
+				//lint -e{534}
+				// SQLITE Statement finalization
+				sqlite3_finalize( insertStmt );
+				//lint -e{534}
+				sqlite3_finalize( insertSampleStmt );
+				//lint -e{534}
+				sqlite3_finalize( replaceDictionaryStmt );
+				//lint -e{534}
+				sqlite3_finalize( replaceLastPeriodStmt );
+				for (std::vector<sqlite3_stmt *>::iterator stmti = rollUpReplaceStmt.begin(); stmti != rollUpReplaceStmt.end(); ++stmti)
+				{
+					//lint -e{534}
+					sqlite3_finalize( *stmti );
+				}
+				// An incomplete backup is thrown away
+				finishBackup(false);
+				// close the database
+				close();
+			}
+			catch(...)
+			{
+			}
+		}
+
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 2.2 Database administration
+		
+		// -------------------
+		// 2.2.1 Open Database
+		void EhzDataBase::open(void)
+		{
+			
+			dbHandle = null<sqlite3 *>();
+			//lint -e{971}
+			const sint rc = sqlite3_open_v2(ehzDatabaseName.c_str(), &dbHandle, SQLITE_OPEN_READWRITE, null<mchar *>() );
+			if (SQLITE_OK!= rc )
+			{
+				dbHandle = null<sqlite3 *>();
+				ui << "Could not open database"  << std::endl;
+			} 
+			else
+			{
+				ui <<"Database '" << ehzDatabaseName << "' opened"  << std::endl;
+				// Write ahead log. Readers do not block the writer and there are much less fsyncs
+				//lint -e{534}
+				executeSql("PRAGMA journal_mode=WAL;");
+				setSynchronousMode(&EhzDatabaseSynchronousMode[0]);
+			}
+		}
+
+		// -------------------
+		// 2.2.2 Close Database
+		void EhzDataBase::close(void)
+		{
+			if (isOpen())
+			{
+				//lint -e{534}
+				sqlite3_close(dbHandle);
+			}
+			dbHandle = null<sqlite3 *>();
+		}
+
+		// -------------------------------
+		// 2.2.3 CHeck if database is existing
+		boolean EhzDataBase::isExisting(void) const 
+		{
+			// LOcal instance. Shall not interfere with class database handle
+			sqlite3 *db = null<sqlite3 *>();
+			
+			// Try to open
+			//lint -e{971}
+			const sint rc = sqlite3_open_v2( ehzDatabaseName.c_str(), &db, SQLITE_OPEN_READONLY, null<mchar *>() );
+			boolean existing = false;
+			// If we could open the database, then it is existing
+			if (SQLITE_OK == rc)
+			{
+				// CLose again
+				//lint -e{534}
+				sqlite3_close(db);
+				existing = true;
+			}
+			return existing;
+		}
+
+
+		// ---------------------------------------------
+		// 2.2.4  Create a new database and it's schema
+		void EhzDataBase::createDatabase(void) const
+		{
+			sqlite3 *db = null<sqlite3 *>();
+			// Set flags. Open with read write and create
+			//lint -e{921}
+			const sint flags = static_cast<sint>(static_cast<uint>(SQLITE_OPEN_READWRITE) | static_cast<uint>(SQLITE_OPEN_CREATE));
+			//lint -e{971}
+			const sint rc = sqlite3_open_v2( ehzDatabaseName.c_str(), &db, flags, null<mchar *>() );
+			if (SQLITE_OK == rc)
+			{
+				// We could open and create
+				// Now create the needed table
+				//lint -e{971,534}
+				sqlite3_exec( db, ddl.c_str(), null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>() ); 	 
+				// Check and inform on result
+				//ui.msgf("DB Creation result: %d\n",rc);
+				//lint -e{534}
+				sqlite3_close(db);
+			}    
+		}
+
+
+		// -------------------------------------------------------------------
+		// 2.2.5  Create SQL strings
+		// For database creation and for inserting values into the main table
+		void EhzDataBase::createSqlStrings(void)
+		{
+			// We will use SQLITE prepared statements with parameters
+			// Since the columns of the database are deduced from the EHZ configuration
+			// We do not know the count in advance. The columns are created dynamically.
+			sint parameterCount = null<sint>();
+			
+			// Build the strings for the column name and type
+			ehzSystemColumnNameAndType.buildEhzSystemColumnNameAndType();
+			
+			// Reset the ddl and the insert Mdl strings
+			ddl.clear();
+			insertMdl.clear();
+			recordColumns.clear();
+			
+			// Start building the ddl SQL string
+			// We want to create a table. Name is a constant
+			ddl += "CREATE TABLE IF NOT EXISTS ";
+			ddl += recordTableName;
+			ddl += " (\n";
+			
+			// Start building the insert mdl string
+			// We want to insert data in the main table
+			insertMdl += "INSERT INTO ";
+			insertMdl += recordTableName;
+			insertMdl += " (\n";
+			
+			// Create the time base column, where the time of acquisition of the complete record will be stored
+			ddl += ehzSystemColumnNameAndType.timeBase.columnName;
+			ddl += " ";
+			ddl += ehzSystemColumnNameAndType.timeBase.columnType;
+			// This is also the primary key of the main table
+			ddl += " PRIMARY KEY NOT NULL";
+			
+			// mdl part
+			insertMdl += ehzSystemColumnNameAndType.timeBase.columnName;
+			// and, one new parameter
+			++parameterCount;
+			
+			// To make evaluation of the data easier and to avoid slow queries, we do not only store a timestamp
+			// per record. Additionally we will store a flag to indicate that a multiple of the timestamp was hit.
+			// With that queries like, give me all values for periods of 5 minutes will be easier.
+			// For all time flags
+			for (std::vector<ColumnNameAndType>::iterator cnati = ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.begin(); cnati != ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.end(); ++cnati)
+			{
+				ddl += ",\n";
+				ddl += (*cnati).columnName;
+				ddl += " ";
+				ddl += (*cnati).columnType;
+				ddl += " DEFAULT FALSE";
+				recordColumns.push_back(ColumnNameAndType((*cnati).columnName, (*cnati).columnType + " DEFAULT FALSE"));
+
+				insertMdl += ",\n";
+				insertMdl += (*cnati).columnName;
+				++parameterCount;
+			}
+			
+			// So, now the columns for each EHZ
+			// Only for the wide schema. In the narrow schema, the values are stored in an own table
+			if (DatabaseSchema::Wide == databaseSchema)
+			{
+				for (std::vector<EhzColumnNameAndType>::iterator ehzi = ehzSystemColumnNameAndType.ehzColumnNameAndType.begin(); ehzi != ehzSystemColumnNameAndType.ehzColumnNameAndType.end(); ++ehzi)
+				{
+					// Every EHZ has its own time stamp for the acquired data
+					ddl += ",\n";
+					ddl += (*ehzi).acquisitionTime.columnName;
+					ddl += " ";
+					ddl += (*ehzi).acquisitionTime.columnType;
+					recordColumns.push_back((*ehzi).acquisitionTime);
+				
+					insertMdl += ",\n";
+					insertMdl += (*ehzi).acquisitionTime.columnName;
+					++parameterCount;
+
+					// And every EHZ has up to x  measured values and units
+					for (std::vector<EhzColumnNameAndType::MeasuredValueAndUnit>::iterator mvi = (*ehzi).measuredValueAndUnit.begin(); mvi != (*ehzi).measuredValueAndUnit.end(); ++mvi)
+					{
+						ddl += ",\n";
+						ddl += (*mvi).measuredValue.columnName;
+						ddl += " ";
+						ddl += (*mvi).measuredValue.columnType;
+					
+						ddl += ",\n";
+						ddl += (*mvi).unit.columnName;
+						ddl += " ";
+						ddl += (*mvi).unit.columnType;
+						recordColumns.push_back((*mvi).measuredValue);
+						recordColumns.push_back((*mvi).unit);
+					
+						insertMdl += ",\n";
+						insertMdl += (*mvi).measuredValue.columnName;
+						insertMdl += ",\n";
+						insertMdl += (*mvi).unit.columnName;
+						++parameterCount;
+						++parameterCount;
+					}
+				}
+			}
+			// Finalize ddl
+			ddl += ");\n";
+
+			// Add the parameter part to the mdl
+			// We counted the number of parameters
+			insertMdl += ")\nVALUES (\n?1";
+			
+			for (sint i = 2; i <= parameterCount;++i)
+			{
+				insertMdl += ",\n?";
+				std::ostringstream tempBuf;
+				//lint -e{830,1960,1963,9050}
+				tempBuf << i;
+				insertMdl += tempBuf.str();
+			}
+			// Finalize mdl statement
+			insertMdl += "\n);\n";
+			
+			// The narrow schema needs 2 more tables. One for the values and one for the names and units
+			// The primary key is the index for queries of one value of one meter over time
+			//lint --e{1963,9050}
+			insertSampleMdl.clear();
+			replaceDictionaryMdl.clear();
+			if (DatabaseSchema::Narrow == databaseSchema)
+			{
+				std::ostringstream narrowDdl;
+				narrowDdl << "CREATE TABLE IF NOT EXISTS " << ehzSqliteSampleTableName << " (\n" 
+						<< meterColumnName << " " << sqliteTypeNameInteger << " NOT NULL,\n" 
+						<< valueIdColumnName << " " << sqliteTypeNameInteger << " NOT NULL,\n" 
+						<< timeBaseColumnName << " " << timeBaseColumnType << " NOT NULL,\n" 
+						// No type. Numbers and texts are stored as they are
+						<< valueColumnName << ",\n" 
+						<< "PRIMARY KEY (" << meterColumnName << ", " << valueIdColumnName << ", " << timeBaseColumnName << ")) WITHOUT ROWID;\n";
+				narrowDdl << "CREATE TABLE IF NOT EXISTS " << ehzSqliteDictionaryTableName << " (\n" 
+						<< meterColumnName << " " << sqliteTypeNameInteger << " NOT NULL,\n" 
+						<< valueIdColumnName << " " << sqliteTypeNameInteger << " NOT NULL,\n" 
+						<< nameColumnName << " " << sqliteTypeNameText << ",\n" 
+						<< unitColumnName << " " << sqliteTypeNameText << ",\n"
+						<< "PRIMARY KEY (" << meterColumnName << ", " << valueIdColumnName << "));\n";
+				ddl += narrowDdl.str();
+				
+				insertSampleMdl = std::string("INSERT INTO ") + ehzSqliteSampleTableName + " (" + meterColumnName + ", " + valueIdColumnName + ", " + timeBaseColumnName + ", " + valueColumnName + ") VALUES (?1, ?2, ?3, ?4);";
+				replaceDictionaryMdl = std::string("INSERT OR REPLACE INTO ") + ehzSqliteDictionaryTableName + " (" + meterColumnName + ", " + valueIdColumnName + ", " + nameColumnName + ", " + unitColumnName + ") VALUES (?1, ?2, ?3, ?4);";
+			}
+			
+			// Now the roll-up tables. Only numerical values can be aggregated
+			rollUpSource.clear();
+			for (uint noEhz = null<uint>(); noEhz < EhzInternal::getNumberOfEhz(); ++noEhz)
+			{
+				for (uint noemd = null<uint>(); noemd< NumberOfEhzMeasuredData; ++noemd)
+				{
+					if (EhzMeasuredDataType::Number == EhzInternal::getEhzConfigDefinition(noEhz).ehzMeasuredDataType[noemd])
+					{
+						rollUpSource.push_back(std::make_pair(noEhz, noemd));
+					}
+				}
+			}
+			
+			rollUpDdl.clear();
+			rollUpReplaceMdl.clear();
+			rollUpSelectSql.clear();
+			rollUpTableName.clear();
+			rollUpColumns.clear();
+			for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
+			{
+				std::ostringstream tableName;
+				//lint -e{830,1960,1963,9050}
+				tableName << ehzSqliteRollUpTableName << EhzLogPeriodInS[period];
+				
+				std::ostringstream rollUpDdlStream;
+				std::ostringstream rollUpReplaceMdlStream;
+				std::ostringstream rollUpSelectSqlStream;
+				std::ostringstream parameterStream;
+				// All columns except the primary key. For the migration of tables of older versions or configurations
+				std::vector<ColumnNameAndType> columns(1U, ColumnNameAndType(numberOfSamplesColumnName, sqliteTypeNameInteger));
+				//lint --e{1963,9050}
+				rollUpDdlStream << "CREATE TABLE IF NOT EXISTS " << tableName.str() << " (\n" << bucketStartColumnName << " " << timeBaseColumnType << " PRIMARY KEY NOT NULL,\n" << numberOfSamplesColumnName << " " << sqliteTypeNameInteger;
+				rollUpReplaceMdlStream << "INSERT OR REPLACE INTO " << tableName.str() << " (\n" << bucketStartColumnName << ",\n" << numberOfSamplesColumnName;
+				rollUpSelectSqlStream << "SELECT " << numberOfSamplesColumnName;
+				parameterStream << "?1,\n?2";
+				sint parameterCount = 2;
+				
+				// Columns for all aggregations of all numerical values
+				for (std::vector<std::pair<uint, uint> >::const_iterator rsi = rollUpSource.begin(); rsi != rollUpSource.end(); ++rsi)
+				{
+					for (uint suffix = null<uint>(); suffix < NumberOfRollUpColumnSuffixes; ++suffix)
+					{
+						std::ostringstream columnName;
+						columnName << measuredValueColumnName << rsi->second << ehzColumnName << rsi->first << rollUpColumnSuffix[suffix];
+						rollUpDdlStream << ",\n" << columnName.str() << " " << sqliteTypeNameFloat;
+						rollUpReplaceMdlStream << ",\n" << columnName.str();
+						rollUpSelectSqlStream << ", " << columnName.str();
+						columns.push_back(ColumnNameAndType(columnName.str(), sqliteTypeNameFloat));
+						++parameterCount;
+						parameterStream << ",\n?" << parameterCount;
+					}
+					std::ostringstream countColumnName;
+					countColumnName << measuredValueColumnName << rsi->second << ehzColumnName << rsi->first << rollUpCountColumnSuffix;
+					rollUpDdlStream << ",\n" << countColumnName.str() << " " << sqliteTypeNameInteger;
+					rollUpReplaceMdlStream << ",\n" << countColumnName.str();
+					rollUpSelectSqlStream << ", " << countColumnName.str();
+					columns.push_back(ColumnNameAndType(countColumnName.str(), sqliteTypeNameInteger));
+					++parameterCount;
+					parameterStream << ",\n?" << parameterCount;
+				}
+				rollUpDdlStream << ");\n";
+				rollUpReplaceMdlStream << ")\nVALUES (\n" << parameterStream.str() << "\n);\n";
+				rollUpSelectSqlStream << " FROM " << tableName.str() << " WHERE " << bucketStartColumnName << "=?1;";
+				
+				rollUpDdl.push_back(rollUpDdlStream.str());
+				rollUpReplaceMdl.push_back(rollUpReplaceMdlStream.str());
+				rollUpSelectSql.push_back(rollUpSelectSqlStream.str());
+				rollUpTableName.push_back(tableName.str());
+				rollUpColumns.push_back(columns);
+			}
+		}	
+
+
+		// -------------------------------------------------------------------
+		// 2.2.6  Execute an SQL statement that has no result
+		boolean EhzDataBase::executeSql(const mchar *const sql) const
+		{
+			mchar *errorMessage = null<mchar *>();
+			//lint -e{971}
+			const sint rc = sqlite3_exec( dbHandle, sql, null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), &errorMessage );
+			if (SQLITE_OK != rc)
+			{
+				std::string message("Database error for '");
+				message += sql;
+				message += "': ";
+				message += (null<mchar *>() == errorMessage) ? "unknown" : errorMessage;
+				showErrorMessage(message);
+			}
+			sqlite3_free(errorMessage);
+			return (SQLITE_OK == rc);
+		}
+		
+		// -------------------------------------------------------------------
+		// 2.2.7  Show an error message
+		void EhzDataBase::showErrorMessage(const std::string &errorMessage) const
+		{
+			ui << errorMessage << std::endl;
+		}
+		
+		// -------------------------------------------------------------------
+		// 2.2.8  Set the SQLITE synchronous mode
+		void EhzDataBase::setSynchronousMode(const std::string &synchronousMode)
+		{
+			const std::string sql = "PRAGMA synchronous=" + synchronousMode + ";";
+			//lint -e{534}
+			executeSql(sql.c_str());
+		}
+		
+		// -------------------------------------------------------------------
+		// 2.2.9  Set the limits of the write behind queue
+		void EhzDataBase::setWriteBehind(const uint maxNumberOfRecords, const EhzLogTimeUnit maxAgeInS)
+		{
+			// Write what we have with the old limits
+			flush();
+			// At least one record must fit in the queue
+			writeBehindMaxNumberOfRecords = (null<uint>() == maxNumberOfRecords) ? 1U : maxNumberOfRecords;
+			writeBehindMaxAgeInS = maxAgeInS;
+			// Records, that could not be written, may not fit any longer
+			if (numberOfQueuedRecords > writeBehindMaxNumberOfRecords)
+			{
+				dropOldestQueuedRecords(numberOfQueuedRecords - writeBehindMaxNumberOfRecords);
+			}
+			writeBehindQueue.resize(writeBehindMaxNumberOfRecords);
+		}
+
+
+
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 2.3 Data manipulation
+			
+		// -------------------------------------------------------------------
+		// 2.3.1  Set last period values
+			
+		// To make evaluation of the data easier and to avoid slow queries, we do not only store a timestamp
+		// per record. Additionally we will store a flag to indicate that a multiple of the timestamp was hit.
+		// With that queries like, give me all values for periods of 5 minutes will be easier.		
+		
+		// We store internally, at which time the last flag has been set
+		// Then we can compare against this time stamps and set the flags accordingly
+		
+		// When this application is started, then no "old values" are existing
+		// So we will read them from the small table with the last period values. One row per period.
+		// Databases of older versions do not have this table. Then the values are evaluated once with
+		// one query on the records table. The query reads only the records within the longest period
+		// before the newest record, because a flag has always been set within one period length.
+		
+		void EhzDataBase::initializeLastPeriodValues(void)
+		{
+			std::ostringstream sql;
+			sql << "CREATE TABLE IF NOT EXISTS " << ehzSqliteLastPeriodTableName << " (" << periodColumnName << " INTEGER PRIMARY KEY NOT NULL, " 
+				<< lastTimeColumnName << ' ' << sqliteTypeNameInteger << " NOT NULL);";
+			//lint -e{534}
+			executeSql(sql.str().c_str());
+			
+			std::fill(lastPeriodValue.begin(), lastPeriodValue.end(), null<EhzLogTimeUnit>());
+			boolean lastPeriodTableHasRows = false;
+			
+			// Read all markers with one query
+			sql.str(std::string());
+			sql << "SELECT " << periodColumnName << ", " << lastTimeColumnName << " FROM " << ehzSqliteLastPeriodTableName << ';';
+			sqlite3_stmt *stmt = null<sqlite3_stmt *>();
+			//lint -e{971}
+			if (SQLITE_OK == sqlite3_prepare_v2( dbHandle, sql.str().c_str(), -1, &stmt, null<const mchar **>() ))
+			{
+				while (SQLITE_ROW == sqlite3_step(stmt))
+				{
+					lastPeriodTableHasRows = true;
+					//lint -e{732,917,921}
+					const EhzLogTimeUnit period = static_cast<EhzLogTimeUnit>(sqlite3_column_int64( stmt, 0));
+					// Periods that are not defined any longer are ignored
+					const EhzLogTimeUnit *const periodFound = std::find(&EhzLogPeriodInS[0], &EhzLogPeriodInS[EhzLogPeriodCount], period);
+					if (&EhzLogPeriodInS[EhzLogPeriodCount] != periodFound)
+					{
+						//lint -e{732,917,921,946,947}
+						lastPeriodValue[static_cast<uint>(periodFound - &EhzLogPeriodInS[0])] = static_cast<EhzLogTimeUnit>(sqlite3_column_int64( stmt, 1));
+					}
+				}
+			}
+			//lint -e{534}
+			sqlite3_finalize( stmt );
+			
+			if (!lastPeriodTableHasRows)
+			{
+				// Evaluate the markers once from the records. All flags in one query
+				const EhzLogTimeUnit longestPeriod = *std::max_element(&EhzLogPeriodInS[0], &EhzLogPeriodInS[EhzLogPeriodCount]);
+				sql.str(std::string());
+				sql << "SELECT ";
+				for (std::vector<ColumnNameAndType>::iterator cnati = ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.begin(); cnati != ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.end(); ++cnati)
+				{
+					// Older versions have stored the flags as text
+					sql << ((cnati == ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.begin()) ? "" : ", ") 
+						<< "MAX(CASE WHEN " << (*cnati).columnName << " IN (1, 'TRUE') THEN " << timeBaseColumnName << " END)";
+				}
+				sql << " FROM " << recordTableName << " WHERE " << timeBaseColumnName << " >= (SELECT MAX(" << timeBaseColumnName << ") FROM " 
+					<< recordTableName << ") - " << longestPeriod << ';';
+				
+				stmt = null<sqlite3_stmt *>();
+				//lint -e{971}
+				if ((SQLITE_OK == sqlite3_prepare_v2( dbHandle, sql.str().c_str(), -1, &stmt, null<const mchar **>() )) && (SQLITE_ROW == sqlite3_step(stmt)))
+				{
+					for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
+					{
+						// NULL, if the flag was never set. Then, for the next storage of values, the flag will be guaranteed be set
+						//lint -e{732,917,921}
+						lastPeriodValue[period] = static_cast<EhzLogTimeUnit>(sqlite3_column_int64( stmt, static_cast<sint>(period)));
+					}
+				}
+				//lint -e{534}
+				sqlite3_finalize( stmt );
+			}
+			
+			// Statement for writing the markers
+			sql.str(std::string());
+			sql << "INSERT OR REPLACE INTO " << ehzSqliteLastPeriodTableName << " (" << periodColumnName << ", " << lastTimeColumnName << ") VALUES (?1, ?2);";
+			//lint -e{971,534}
+			sqlite3_prepare_v2( dbHandle, sql.str().c_str(), -1, &replaceLastPeriodStmt, null<const mchar **>() );
+			
+			if (!lastPeriodTableHasRows)
+			{
+				// Next start will be fast
+				//lint -e{921}
+				writeLastPeriodValues(static_cast<u32>((1UL << EhzLogPeriodCount) - 1UL));
+			}
+		}
+		
+		// Write the last period values for all periods with a set flag. Called within the transaction of the records
+		void EhzDataBase::writeLastPeriodValues(const u32 periodFlags)
+		{
+			if (null<sqlite3_stmt *>() != replaceLastPeriodStmt)
+			{
+				for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
+				{
+					if (null<u32>() != (periodFlags & (1UL << period)))
+					{
+						//lint --e{534}
+						sqlite3_bind_int64(replaceLastPeriodStmt, 1, static_cast<sqlite3_int64>(EhzLogPeriodInS[period]));
+						sqlite3_bind_int64(replaceLastPeriodStmt, 2, static_cast<sqlite3_int64>(lastPeriodValue[period]));
+						sqlite3_step( replaceLastPeriodStmt );
+						sqlite3_reset( replaceLastPeriodStmt );
+					}
+				}
+			}
+		}
+
+
+		// -------------------------------------------------------------------
+		// 2.3.2  Store measured values
+		
+		// Main databases function and fucntionality
+		// Store the measured values from the EHZ System
+		// +time stamps and time flags
+		
+		// The values are not written immediately. They are copied into the write behind queue.
+		// The queue is written in one transaction, if it is full or if the oldest record is too old
+	
+		void EhzDataBase::storeMeasuredValues(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz)
+		{
+			//Get time of now
+			//lint -e{921}
+			storeMeasuredValues(allMeasuredValuesForAllEhz, static_cast<EhzLogTimeUnit>(time(null<time_t*>() )));
+		}
+		
+		void EhzDataBase::storeMeasuredValues(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz, const EhzLogTimeUnit nowTime)
+		{
+			const TraceInternal::TraceSpan traceSpan(TraceInternal::TraceProbe::StoreMeasuredValues, allMeasuredValuesForAllEhz.size());
+			// The queue is still full, because the last flush failed. Make room for the new record
+			if (numberOfQueuedRecords >= writeBehindMaxNumberOfRecords)
+			{
+				dropOldestQueuedRecords(numberOfQueuedRecords - writeBehindMaxNumberOfRecords + 1U);
+			}
+			// Next free element in the queue. Reuse it
+			QueuedRecord &queuedRecord = writeBehindQueue[numberOfQueuedRecords];
+			
+			// Timestamp for this record
+			queuedRecord.timeBase = nowTime;
+			queuedRecord.periodFlags = null<u32>();
+			
+			// To make evaluation of the data easier and to avoid slow queries, we do not only store a timestamp
+			// per record. Additionally we will store a flag to indicate that a multiple of the timestamp was hit.
+			// With that queries like, give me all values for periods of 5 minutes, will be easier.
+			
+			// Check if we will set a period flag
+			for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
+			{
+				// If the respective number of seconds elapsed
+				if (nowTime >= (lastPeriodValue[period] + EhzLogPeriodInS[period]))
+				{
+					// Store new Value: Time of now
+					lastPeriodValue[period] = nowTime;
+					// And set flag
+					queuedRecord.periodFlags |= (1UL << period);
+				}
+			}
+			
+			// Copy the measured values
+			queuedRecord.allMeasuredValuesForAllEhz = allMeasuredValuesForAllEhz;
+			
+			// Unchanged values need not be stored again. A record with a period flag is always stored
+			queuedRecord.isStored = (null<u32>() != queuedRecord.periodFlags);
+			for (uint noEhz = null<uint>(); noEhz < queuedRecord.reportedValues.size(); ++noEhz)
+			{
+				boolean isKeyframe = false;
+				//lint -e{921}
+				queuedRecord.reportedValues[noEhz] = changeDetection.filter(noEhz, allMeasuredValuesForAllEhz[noEhz], static_cast<time_t>(nowTime), isKeyframe);
+				if (null<u32>() != queuedRecord.reportedValues[noEhz])
+				{
+					queuedRecord.isStored = true;
+				}
+			}
+			++numberOfQueuedRecords;
+			
+			// Write the queue, if it is full or if the oldest record waits too long
+			if ((numberOfQueuedRecords >= writeBehindMaxNumberOfRecords) || (nowTime >= (writeBehindQueue[0].timeBase + writeBehindMaxAgeInS)))
+			{
+				flush();
+			}
+		}
+		
+		
+		// -------------------------------------------------------------------
+		// 2.3.3  Write all queued records
+		
+		// All records are written in one transaction. So there is only one commit and
+		// (in WAL mode with synchronous NORMAL) normally no fsync.
+		// If the transaction fails (for example the disk is full or the database is locked), nothing of it is
+		// in the database. The records stay in the queue and the next flush writes them again
+		void EhzDataBase::flush(void)
+		{
+			if ((null<uint>() < numberOfQueuedRecords) && isOpen())
+			{
+				// The time for the complete transaction including the commit
+				const u64 flushStartTimeInNs = MetricsInternal::getMonotonicTimeInNs();
+				// A failed rollback may have left the last transaction open
+				if (0 == sqlite3_get_autocommit(dbHandle))
+				{
+					//lint -e{534}
+					executeSql("ROLLBACK TRANSACTION;");
+				}
+				// The roll-ups in memory are updated with each record. Keep them, in case the transaction fails
+				for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
+				{
+					rollUpAtLastCommit[period] = rollUp[period];
+				}
+				// Take the write lock at once. If another connection holds it, nothing is inserted and the records stay in the queue
+				boolean isCommitted = executeSql("BEGIN IMMEDIATE TRANSACTION;");
+				if (isCommitted)
+				{
+					// Insert all records. A failing insert of one record does not affect the others
+					for (uint i = null<uint>(); i < numberOfQueuedRecords; ++i)
+					{
+						if (writeBehindQueue[i].isStored)
+						{
+							insertRecord(writeBehindQueue[i]);
+						}
+						else
+						{
+							// Nothing new. But the roll-ups count every record
+							updateRollUps(writeBehindQueue[i]);
+						}
+					}
+					// In the same transaction: Remember the times of the period flags
+					u32 periodFlags = null<u32>();
+					for (uint i = null<uint>(); i < numberOfQueuedRecords; ++i)
+					{
+						periodFlags |= writeBehindQueue[i].periodFlags;
+					}
+					writeLastPeriodValues(periodFlags);
+					// Remove old raw data
+					deleteExpiredRawData(writeBehindQueue[numberOfQueuedRecords - 1U].timeBase);
+					
+					isCommitted = executeSql("COMMIT TRANSACTION;");
+					if (!isCommitted)
+					{
+						//lint -e{534}
+						executeSql("ROLLBACK TRANSACTION;");
+					}
+				}
+				Metrics::getInstance()->getDatabaseInsertLatency().observeSince(flushStartTimeInNs);
+				
+				if (isCommitted)
+				{
+					// Queue is empty again
+					numberOfQueuedRecords = null<uint>();
+				}
+				else
+				{
+					// The records will be aggregated again with the next flush
+					for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
+					{
+						rollUp[period] = rollUpAtLastCommit[period];
+					}
+					std::ostringstream message;
+					message << "Database: " << numberOfQueuedRecords << " records could not be written. They stay in the queue";
+					showErrorMessage(message.str());
+				}
+			}
+			else
+			{
+				// Without database there is nothing to write
+				numberOfQueuedRecords = null<uint>();
+			}
+		}
+		
+		// The oldest records are moved to the end of the queue. They will be reused first
+		void EhzDataBase::dropOldestQueuedRecords(const uint numberOfRecords)
+		{
+			const uint numberOfDroppedRecords = (numberOfRecords < numberOfQueuedRecords) ? numberOfRecords : numberOfQueuedRecords;
+			if (null<uint>() < numberOfDroppedRecords)
+			{
+				std::rotate(writeBehindQueue.begin(), writeBehindQueue.begin() + static_cast<std::ptrdiff_t>(numberOfDroppedRecords), writeBehindQueue.begin() + static_cast<std::ptrdiff_t>(numberOfQueuedRecords));
+				numberOfQueuedRecords -= numberOfDroppedRecords;
+				Metrics::getInstance()->getDatabaseLostRecords().add(static_cast<u64>(numberOfDroppedRecords));
+				std::ostringstream message;
+				message << "Database: " << numberOfDroppedRecords << " records could not be written and are lost";
+				showErrorMessage(message.str());
+			}
+		}
+		
+		
+		// -------------------------------------------------------------------
+		// 2.3.4  Insert one record
+
+		void EhzDataBase::insertRecord(const QueuedRecord &queuedRecord)
+		{
+			//lint --e{534,917}
+			// We use an SQLITE prepared statement with parameters
+			// We will bin all values to the prepared statement
+			// This variable is the index of the parameter for the related value
+			sint pidx = 1;
+			
+			// Timestamp for this record
+			sqlite3_bind_int(insertStmt, pidx, queuedRecord.timeBase);
+			++pidx;
+
+			// Period flags as evaluated when the record was queued
+			for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
+			{
+				sqlite3_bind_int(insertStmt, pidx, (null<u32>() != (queuedRecord.periodFlags & (1UL << period))) ? 1 : 0);
+				++pidx;
+			}
+			
+			// Now for all EHZ in the EHZ system (only for the wide schema)
+			if (DatabaseSchema::Wide == databaseSchema)
+			{
+				for (uint noEhz = null<uint>(); noEhz < EhzInternal::getNumberOfEhz(); ++noEhz)
+				{
+					const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz = queuedRecord.allMeasuredValuesForAllEhz[noEhz];
+					// Time, when data has been acquired by one single EHZ
+					sqlite3_bind_int(insertStmt, pidx, allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated );
+					++pidx;
+					// Now for each value for one of the EHZ in the EHZ system
+					for (uint noemd = null<uint>(); noemd< NumberOfEhzMeasuredData; ++noemd)
+					{
+						// Get the type of the value stored in the EHZ. Either Double or Text, or NULL (Nothing)
+						const EhzMeasuredDataType::Type emdt = EhzInternal::getEhzConfigDefinition(noEhz).ehzMeasuredDataType[noemd];
+						// If there is an associated value
+						if (EhzMeasuredDataType::Null != emdt)
+						{
+							// Check the type of the value. Is either Number (Double) or Text
+							// and then define the type of the corresponding field
+							// Basically SQLITE doesnt care so much abaout types, but anyway. Lets assign the right type
+							if (EhzMeasuredDataType::Number == emdt )
+							{
+								// Type: Number / DOUBLE / Float
+								sqlite3_bind_double(insertStmt, pidx, allMeasuredValuesForOneEhz.measuredValueForOneEhz[noemd].doubleValue);
+								++pidx;
+							}
+							else
+							{
+								// Type: Text
+								sqlite3_bind_text(insertStmt, pidx,allMeasuredValuesForOneEhz.measuredValueForOneEhz[noemd].smlByteString.c_str(),-1,null<void(*)(void*)>());
+								++pidx;
+							}
+							// Now bind the unit
+							sqlite3_bind_text(insertStmt, pidx,allMeasuredValuesForOneEhz.measuredValueForOneEhz[noemd].unit.c_str(),-1,null<void(*)(void*)>());
+							++pidx;
+						}
+					}
+				}
+			}
+			// Store all values in the database
+			const sint rc = sqlite3_step( insertStmt );
+			// And make the prepared statement ready for next usage
+			sqlite3_reset( insertStmt );
+			
+			// And aggregate the values, if they could be stored
+			if (SQLITE_DONE == rc)
+			{
+				if (DatabaseSchema::Narrow == databaseSchema)
+				{
+					insertSamples(queuedRecord);
+				}
+				updateRollUps(queuedRecord);
+			}
+		}
+		
+		
+		// -------------------------------------------------------------------
+		// 2.3.5  Narrow schema. Insert one row per value
+		
+		void EhzDataBase::insertSamples(const QueuedRecord &queuedRecord)
+		{
+			//lint --e{534,917}
+			for (uint noEhz = null<uint>(); noEhz < EhzInternal::getNumberOfEhz(); ++noEhz)
+			{
+				const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz = queuedRecord.allMeasuredValuesForAllEhz[noEhz];
+				// Only the values, that changed beyond their deadband
+				const u32 reportedValues = queuedRecord.reportedValues[noEhz];
+				
+				// Acquisition time of this EHZ. Not needed, if no value is stored
+				if (null<u32>() != reportedValues)
+				{
+					sqlite3_bind_int(insertSampleStmt, 1, static_cast<sint>(noEhz));
+					sqlite3_bind_int(insertSampleStmt, 2, static_cast<sint>(AcquisitionTimeValueId));
+					sqlite3_bind_int64(insertSampleStmt, 3, static_cast<sqlite3_int64>(queuedRecord.timeBase));
+					sqlite3_bind_int64(insertSampleStmt, 4, static_cast<sqlite3_int64>(allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated));
+					sqlite3_step( insertSampleStmt );
+					sqlite3_reset( insertSampleStmt );
+				}
+				
+				for (uint noemd = null<uint>(); noemd< NumberOfEhzMeasuredData; ++noemd)
+				{
+					const EhzMeasuredDataType::Type emdt = EhzInternal::getEhzConfigDefinition(noEhz).ehzMeasuredDataType[noemd];
+					if ((EhzMeasuredDataType::Null != emdt) && (null<u32>() != (reportedValues & (1UL << noemd))))
+					{
+						const EhzInternal::OneMeasuredValueForOneEhz &omv = allMeasuredValuesForOneEhz.measuredValueForOneEhz[noemd];
+						sqlite3_bind_int(insertSampleStmt, 1, static_cast<sint>(noEhz));
+						sqlite3_bind_int(insertSampleStmt, 2, static_cast<sint>(noemd));
+						sqlite3_bind_int64(insertSampleStmt, 3, static_cast<sqlite3_int64>(queuedRecord.timeBase));
+						if (EhzMeasuredDataType::Number == emdt )
+						{
+							sqlite3_bind_double(insertSampleStmt, 4, omv.doubleValue);
+						}
+						else
+						{
+							sqlite3_bind_text(insertSampleStmt, 4, omv.smlByteString.c_str(), -1, null<void(*)(void*)>());
+						}
+						sqlite3_step( insertSampleStmt );
+						sqlite3_reset( insertSampleStmt );
+						
+						// The unit is stored only once. Write it again, if it changes
+						std::string &unit = dictionaryUnit[(noEhz * NumberOfEhzMeasuredData) + noemd];
+						if ((unit != omv.unit) && (null<sqlite3_stmt *>() != replaceDictionaryStmt))
+						{
+							unit = omv.unit;
+							sqlite3_bind_int(replaceDictionaryStmt, 1, static_cast<sint>(noEhz));
+							sqlite3_bind_int(replaceDictionaryStmt, 2, static_cast<sint>(noemd));
+							sqlite3_bind_text(replaceDictionaryStmt, 3, EhzInternal::getEhzConfigDefinition(noEhz).ehzDataValueDefinition[noemd].NameForDataValue, -1, null<void(*)(void*)>());
+							sqlite3_bind_text(replaceDictionaryStmt, 4, unit.c_str(), -1, null<void(*)(void*)>());
+							sqlite3_step( replaceDictionaryStmt );
+							sqlite3_reset( replaceDictionaryStmt );
+						}
+					}
+				}
+			}
+		}
+		
+		
+		// -------------------------------------------------------------------
+		// 2.3.6  Narrow schema. Migration from the wide schema
+		
+		// If there is a table with the wide schema and the narrow tables are still empty, then
+		// all data will be copied in one transaction. The old table is kept and may be dropped manually
+		void EhzDataBase::migrateFromWideSchema(void)
+		{
+			if (hasRows(&ehzSqliteDatabaseTableName[0]) && !hasRows(recordTableName))
+			{
+				ui << "Migrating database to narrow schema. This may take a while" << std::endl;
+				
+				//lint --e{1963,9050}
+				std::ostringstream sql;
+				sql << "BEGIN TRANSACTION;\n";
+				
+				// Time base and period flags
+				sql << "INSERT INTO " << recordTableName << " (" << timeBaseColumnName;
+				for (std::vector<ColumnNameAndType>::const_iterator cnati = ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.begin(); cnati != ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.end(); ++cnati)
+				{
+					sql << ", " << cnati->columnName;
+				}
+				sql << ") SELECT " << timeBaseColumnName;
+				for (std::vector<ColumnNameAndType>::const_iterator cnati = ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.begin(); cnati != ehzSystemColumnNameAndType.ehzTimePeriodNameAndType.end(); ++cnati)
+				{
+					sql << ", " << cnati->columnName;
+				}
+				sql << " FROM " << ehzSqliteDatabaseTableName << ";\n";
+				
+				// One column of the wide table after the other
+				const std::string insertSample = std::string("INSERT OR IGNORE INTO ") + ehzSqliteSampleTableName + " (" + meterColumnName + ", " + valueIdColumnName + ", " + timeBaseColumnName + ", " + valueColumnName + ") SELECT ";
+				for (uint noEhz = null<uint>(); noEhz < EhzInternal::getNumberOfEhz(); ++noEhz)
+				{
+					const EhzColumnNameAndType &ecnat = ehzSystemColumnNameAndType.ehzColumnNameAndType[noEhz];
+					sql << insertSample << noEhz << ", " << AcquisitionTimeValueId << ", " << timeBaseColumnName << ", " << ecnat.acquisitionTime.columnName << " FROM " << ehzSqliteDatabaseTableName << " WHERE " << ecnat.acquisitionTime.columnName << " IS NOT NULL;\n";
+					
+					uint columnIndex = null<uint>();
+					for (uint noemd = null<uint>(); noemd< NumberOfEhzMeasuredData; ++noemd)
+					{
+						if (EhzMeasuredDataType::Null != EhzInternal::getEhzConfigDefinition(noEhz).ehzMeasuredDataType[noemd])
+						{
+							const EhzColumnNameAndType::MeasuredValueAndUnit &mvu = ecnat.measuredValueAndUnit[columnIndex];
+							++columnIndex;
+							sql << insertSample << noEhz << ", " << noemd << ", " << timeBaseColumnName << ", " << mvu.measuredValue.columnName << " FROM " << ehzSqliteDatabaseTableName << " WHERE " << mvu.measuredValue.columnName << " IS NOT NULL;\n";
+							
+							// The name and the last unit go to the dictionary
+							std::string name(EhzInternal::getEhzConfigDefinition(noEhz).ehzDataValueDefinition[noemd].NameForDataValue);
+							for (size_t quote = name.find('\''); std::string::npos != quote; quote = name.find('\'', quote + 2U))
+							{
+								name.insert(quote, 1U, '\'');
+							}
+							sql << "INSERT OR REPLACE INTO " << ehzSqliteDictionaryTableName << " (" << meterColumnName << ", " << valueIdColumnName << ", " << nameColumnName << ", " << unitColumnName << ") SELECT " 
+								<< noEhz << ", " << noemd << ", '" << name << "', " << mvu.unit.columnName << " FROM " << ehzSqliteDatabaseTableName << " ORDER BY " << timeBaseColumnName << " DESC LIMIT 1;\n";
+						}
+					}
+				}
+				
+				if (executeSql(sql.str().c_str()) && executeSql("COMMIT TRANSACTION;"))
+				{
+					ui << "Migration done. Table " << ehzSqliteDatabaseTableName << " is not used any longer" << std::endl;
+				}
+				else
+				{
+					// Probably the configuration has been changed and the columns do not fit
+					//lint -e{534}
+					executeSql("ROLLBACK TRANSACTION;");
+					showErrorMessage(std::string("Migration to the narrow schema failed. The data stays in table ") + ehzSqliteDatabaseTableName);
+				}
+			}
+			
+			// Names for the acquisition times
+			for (uint noEhz = null<uint>(); (noEhz < EhzInternal::getNumberOfEhz()) && (null<sqlite3_stmt *>() != replaceDictionaryStmt); ++noEhz)
+			{
+				//lint --e{534}
+				sqlite3_bind_int(replaceDictionaryStmt, 1, static_cast<sint>(noEhz));
+				sqlite3_bind_int(replaceDictionaryStmt, 2, static_cast<sint>(AcquisitionTimeValueId));
+				sqlite3_bind_text(replaceDictionaryStmt, 3, &acquisitionTimeName[0], -1, null<void(*)(void*)>());
+				sqlite3_bind_text(replaceDictionaryStmt, 4, &acquisitionTimeUnit[0], -1, null<void(*)(void*)>());
+				sqlite3_step( replaceDictionaryStmt );
+				sqlite3_reset( replaceDictionaryStmt );
+			}
+		}
+		
+		
+		// -------------------------------------------------------------------
+		// 2.3.7  Check, if a table exists and is not empty
+		
+		boolean EhzDataBase::hasRows(const mchar *const tableName) const
+		{
+			boolean rowsFound = false;
+			const std::string sql = std::string("SELECT 1 FROM ") + tableName + " LIMIT 1;";
+			sqlite3_stmt *stmt = null<sqlite3_stmt *>();
+			// Preparing fails, if the table does not exist
+			//lint -e{971}
+			if (SQLITE_OK == sqlite3_prepare_v2( dbHandle, sql.c_str(), -1, &stmt, null<const mchar **>() ))
+			{
+				rowsFound = (SQLITE_ROW == sqlite3_step(stmt));
+			}
+			//lint -e{534}
+			sqlite3_finalize( stmt );
+			return rowsFound;
+		}
+		
+		
+		// -------------------------------------------------------------------
+		// 2.3.8  Create the roll-up tables, if necessary, and prepare the statements
+		
+		void EhzDataBase::prepareRollUps(void)
+		{
+			if (isOpen())
+			{
+				for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
+				{
+					//lint -e{534}
+					executeSql(rollUpDdl[period].c_str());
+					// An existing table keeps its layout. Add what is missing
+					addMissingColumns(rollUpTableName[period], rollUpColumns[period]);
+					//lint -e{971}
+					if (SQLITE_OK != sqlite3_prepare_v2( dbHandle, rollUpReplaceMdl[period].c_str(), -1, &rollUpReplaceStmt[period], null<const mchar **>() ))
+					{
+						// Without the statement, this roll-up table is not written
+						showErrorMessage(std::string("Database: Roll-up table ") + rollUpTableName[period] + " can not be written: " + sqlite3_errmsg(dbHandle));
+						//lint -e{534}
+						sqlite3_finalize( rollUpReplaceStmt[period] );
+						rollUpReplaceStmt[period] = null<sqlite3_stmt *>();
+					}
+					rollUp[period].rollUpValue.resize(rollUpSource.size());
+					rollUpAtLastCommit[period].rollUpValue.resize(rollUpSource.size());
+				}
+			}
+		}
+		
+		// A table of an older version or of another configuration (other meters or values) misses columns.
+		// Existing rows keep NULL there. Columns, that are not used any longer, stay in the table
+		void EhzDataBase::addMissingColumns(const std::string &tableName, const std::vector<ColumnNameAndType> &columns)
+		{
+			// Read the names of the existing columns. The name is in the second column of the result
+			std::vector<std::string> existingColumns;
+			const std::string sql = std::string("PRAGMA table_info(") + tableName + ");";
+			sqlite3_stmt *stmt = null<sqlite3_stmt *>();
+			//lint -e{971}
+			if (SQLITE_OK == sqlite3_prepare_v2( dbHandle, sql.c_str(), -1, &stmt, null<const mchar **>() ))
+			{
+				while (SQLITE_ROW == sqlite3_step(stmt))
+				{
+					//lint -e{1924,9176}
+					const mchar *const columnName = reinterpret_cast<const mchar *>(sqlite3_column_text(stmt, 1));
+					if (null<const mchar *>() != columnName)
+					{
+						existingColumns.push_back(columnName);
+					}
+				}
+			}
+			//lint -e{534}
+			sqlite3_finalize( stmt );
+			
+			for (std::vector<ColumnNameAndType>::const_iterator cnati = columns.begin(); cnati != columns.end(); ++cnati)
+			{
+				if (existingColumns.end() == std::find(existingColumns.begin(), existingColumns.end(), cnati->columnName))
+				{
+					const std::string ddl = std::string("ALTER TABLE ") + tableName + " ADD COLUMN " + cnati->columnName + " " + cnati->columnType + ";";
+					//lint -e{534}
+					executeSql(ddl.c_str());
+				}
+			}
+		}
+		
+		
+		// -------------------------------------------------------------------
+		// 2.3.9  Update the roll-up tables
+		
+		// Each roll-up table has one row per bucket. The actual bucket is held in memory.
+		// With each new record, it is updated and the row is written again
+		void EhzDataBase::updateRollUps(const QueuedRecord &queuedRecord)
+		{
+			//lint --e{534,917}
+			for (uint period = null<uint>(); period < EhzLogPeriodCount; ++period)
+			{
+				RollUp &ru = rollUp[period];
+				// The buckets are aligned to the UTC epoch time, not to the local time
+				const EhzLogTimeUnit bucketStart = queuedRecord.timeBase - (queuedRecord.timeBase % EhzLogPeriodInS[period]);
+				
+				// Older data than the actual bucket will not be aggregated. Shall not happen
+				if ((null<sqlite3_stmt *>() != rollUpReplaceStmt[period]) && (bucketStart >= ru.bucketStart))
+				{
+					if (bucketStart != ru.bucketStart)
+					{
+						// A new bucket starts. The old one is already in the database
+						const boolean isFirstBucket = (null<EhzLogTimeUnit>() == ru.bucketStart);
+						ru.bucketStart = bucketStart;
+						ru.numberOfSamples = null<u64>();
+						for (std::vector<RollUpValue>::iterator ruvi = ru.rollUpValue.begin(); ruvi != ru.rollUpValue.end(); ++ruvi)
+						{
+							ruvi->numberOfSamples = null<u64>();
+						}
+						if (isFirstBucket)
+						{
+							loadRollUp(period);
+						}
+					}
+					
+					// Aggregate all numerical values
+					for (uint i = null<uint>(); i < rollUpSource.size(); ++i)
+					{
+						const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz = queuedRecord.allMeasuredValuesForAllEhz[rollUpSource[i].first];
+						// An EHZ without evaluation time did not yet deliver any values. Its zeros would distort minimum and average
+						if (null<time_t>() != allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated)
+						{
+							const mdouble value = allMeasuredValuesForOneEhz.measuredValueForOneEhz[rollUpSource[i].second].doubleValue;
+							RollUpValue &ruv = ru.rollUpValue[i];
+							if (null<u64>() == ruv.numberOfSamples)
+							{
+								ruv.minimum = value;
+								ruv.maximum = value;
+								ruv.sum = 0.0;
+							}
+							ruv.minimum = (value < ruv.minimum) ? value : ruv.minimum;
+							ruv.maximum = (value > ruv.maximum) ? value : ruv.maximum;
+							ruv.sum += value;
+							ruv.last = value;
+							++ruv.numberOfSamples;
+						}
+					}
+					++ru.numberOfSamples;
+					
+					// Write the bucket
+					sqlite3_stmt *const stmt = rollUpReplaceStmt[period];
+					sint pidx = 1;
+					sqlite3_bind_int64(stmt, pidx, static_cast<sqlite3_int64>(ru.bucketStart));
+					++pidx;
+					sqlite3_bind_int64(stmt, pidx, static_cast<sqlite3_int64>(ru.numberOfSamples));
+					++pidx;
+					for (std::vector<RollUpValue>::const_iterator ruvi = ru.rollUpValue.begin(); ruvi != ru.rollUpValue.end(); ++ruvi)
+					{
+						if (null<u64>() == ruvi->numberOfSamples)
+						{
+							// No valid sample in this bucket
+							for (uint suffix = null<uint>(); suffix < NumberOfRollUpColumnSuffixes; ++suffix)
+							{
+								sqlite3_bind_null(stmt, pidx);
+								++pidx;
+							}
+						}
+						else
+						{
+							sqlite3_bind_double(stmt, pidx, ruvi->minimum);
+							++pidx;
+							sqlite3_bind_double(stmt, pidx, ruvi->maximum);
+							++pidx;
+							sqlite3_bind_double(stmt, pidx, ruvi->sum / static_cast<mdouble>(ruvi->numberOfSamples));
+							++pidx;
+							sqlite3_bind_double(stmt, pidx, ruvi->last);
+							++pidx;
+						}
+						sqlite3_bind_int64(stmt, pidx, static_cast<sqlite3_int64>(ruvi->numberOfSamples));
+						++pidx;
+					}
+					sqlite3_step( stmt );
+					sqlite3_reset( stmt );
+				}
+			}
+		}
+		
+		
+		// -------------------------------------------------------------------
+		// 2.3.10 Read the actual bucket of a roll-up table from the database
+		
+		// Only necessary once after program start. Then we continue aggregating with the values of the last run
+		void EhzDataBase::loadRollUp(const uint period)
+		{
+			//lint --e{534}
+			RollUp &ru = rollUp[period];
+			sqlite3_stmt *stmt = null<sqlite3_stmt *>();
+			//lint -e{971}
+			if (SQLITE_OK == sqlite3_prepare_v2( dbHandle, rollUpSelectSql[period].c_str(), -1, &stmt, null<const mchar **>() ))
+			{
+				sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(ru.bucketStart));
+				if (SQLITE_ROW == sqlite3_step(stmt))
+				{
+					ru.numberOfSamples = static_cast<u64>(sqlite3_column_int64(stmt, 0));
+					sint column = 1;
+					for (std::vector<RollUpValue>::iterator ruvi = ru.rollUpValue.begin(); ruvi != ru.rollUpValue.end(); ++ruvi)
+					{
+						const sint countColumn = column + static_cast<sint>(NumberOfRollUpColumnSuffixes);
+						if (SQLITE_NULL == sqlite3_column_type(stmt, column))
+						{
+							ruvi->numberOfSamples = null<u64>();
+						}
+						else if (SQLITE_NULL == sqlite3_column_type(stmt, countColumn))
+						{
+							// Row written before there were count columns. All samples of the bucket were counted
+							ruvi->numberOfSamples = ru.numberOfSamples;
+						}
+						else
+						{
+							ruvi->numberOfSamples = static_cast<u64>(sqlite3_column_int64(stmt, countColumn));
+						}
+						ruvi->minimum = sqlite3_column_double(stmt, column);
+						ruvi->maximum = sqlite3_column_double(stmt, column + 1);
+						ruvi->sum = sqlite3_column_double(stmt, column + 2) * static_cast<mdouble>(ruvi->numberOfSamples);
+						ruvi->last = sqlite3_column_double(stmt, column + 3);
+						column += static_cast<sint>(NumberOfRollUpColumnsPerValue);
+					}
+				}
+			}
+			sqlite3_finalize( stmt );
+		}
+		
+		
+		// -------------------------------------------------------------------
+		// 2.3.11 Retention. Delete old raw data
+		
+		// timeBase is the primary key. So this is a range delete on the index
+		void EhzDataBase::deleteExpiredRawData(const EhzLogTimeUnit nowTime)
+		{
+			if ((null<EhzLogTimeUnit>() < rawDataRetentionInS) && (nowTime >= (lastRetentionCheck + RetentionCheckIntervalInS)))
+			{
+				lastRetentionCheck = nowTime;
+				const EhzLogTimeUnit oldestTimeToKeep = nowTime - rawDataRetentionInS;
+				std::ostringstream sql;
+				//lint --e{1963,9050}
+				sql << "DELETE FROM " << recordTableName << " WHERE " << timeBaseColumnName << " < " << oldestTimeToKeep << ";\n";
+				if (DatabaseSchema::Narrow == databaseSchema)
+				{
+					// One range delete per value. So the primary key can be used
+					for (uint noEhz = null<uint>(); noEhz < EhzInternal::getNumberOfEhz(); ++noEhz)
+					{
+						for (uint valueId = null<uint>(); valueId < NumberOfEhzMeasuredData; ++valueId)
+						{
+							if (EhzMeasuredDataType::Null != EhzInternal::getEhzConfigDefinition(noEhz).ehzMeasuredDataType[valueId])
+							{
+								sql << "DELETE FROM " << ehzSqliteSampleTableName << " WHERE " << meterColumnName << "=" << noEhz << " AND " << valueIdColumnName << "=" << valueId << " AND " << timeBaseColumnName << " < " << oldestTimeToKeep << ";\n";
+							}
+						}
+						sql << "DELETE FROM " << ehzSqliteSampleTableName << " WHERE " << meterColumnName << "=" << noEhz << " AND " << valueIdColumnName << "=" << AcquisitionTimeValueId << " AND " << timeBaseColumnName << " < " << oldestTimeToKeep << ";\n";
+					}
+				}
+				//lint -e{534}
+				executeSql(sql.str().c_str());
+			}
+		}
+
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 2.4 Online backup
+	
+		// -------------------------------------------------------------------
+		// 2.4.1  Start a backup into a temporary file
+		void EhzDataBase::startBackup(const std::string &backupNamel)
+		{
+			if (isOpen() && !isBackupRunning())
+			{
+				backupName = backupNamel;
+				const std::string temporaryName = backupName + backupTemporarySuffix;
+				// The rest of an interrupted backup is not continued
+				//lint -e{534}
+				remove(temporaryName.c_str());
+				//lint -e{971}
+				if (SQLITE_OK == sqlite3_open_v2(temporaryName.c_str(), &backupDbHandle, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, null<mchar *>()))
+				{
+					backup = sqlite3_backup_init(backupDbHandle, "main", dbHandle, "main");
+				}
+				if (isBackupRunning())
+				{
+					// Pages per step from the I/O budget. At least one page
+					const u64 bytesPerStep = (static_cast<u64>(backupBudgetInBytesPerS) * static_cast<u64>(backupStepPeriodInMs)) / 1000ULL;
+					const u64 pagesPerStep = bytesPerStep / static_cast<u64>(getPageSize());
+					backupPagesPerStep = (null<u64>() == pagesPerStep) ? 1 : static_cast<sint>(std::min(pagesPerStep, 0x7FFFFFFFULL));
+					std::ostringstream message;
+					//lint -e{1963,9050}
+					message << "Database backup started. " << backupPagesPerStep << " pages per step";
+					showErrorMessage(message.str());
+				}
+				else
+				{
+					showErrorMessage(std::string("Could not start database backup: ") + sqlite3_errmsg(backupDbHandle));
+					finishBackup(false);
+				}
+			}
+		}
+		
+		// -------------------------------------------------------------------
+		// 2.4.2  Copy the next pages
+		boolean EhzDataBase::stepBackup(void)
+		{
+			if (isBackupRunning())
+			{
+				const sint rc = sqlite3_backup_step(backup, backupPagesPerStep);
+				if (SQLITE_DONE == rc)
+				{
+					finishBackup(true);
+				}
+				// Busy or locked: Try again with the next step
+				else if ((SQLITE_OK != rc) && (SQLITE_BUSY != rc) && (SQLITE_LOCKED != rc))
+				{
+					showErrorMessage(std::string("Database backup failed: ") + sqlite3_errstr(rc));
+					finishBackup(false);
+				}
+				else
+				{
+					// More pages to copy
+				}
+			}
+			return isBackupRunning();
+		}
+		
+		// -------------------------------------------------------------------
+		// 2.4.3  End the backup. Only a complete backup replaces the old one
+		void EhzDataBase::finishBackup(const boolean isComplete)
+		{
+			sint rc = SQLITE_ERROR;
+			if (null<sqlite3_backup *>() != backup)
+			{
+				rc = sqlite3_backup_finish(backup);
+				backup = null<sqlite3_backup *>();
+			}
+			if (null<sqlite3 *>() != backupDbHandle)
+			{
+				//lint -e{534}
+				sqlite3_close(backupDbHandle);
+				backupDbHandle = null<sqlite3 *>();
+			}
+			if (!backupName.empty())
+			{
+				const std::string temporaryName = backupName + backupTemporarySuffix;
+				if (isComplete && (SQLITE_OK == rc) && (0 == rename(temporaryName.c_str(), backupName.c_str())))
+				{
+					showErrorMessage("Database backup finished: " + backupName);
+				}
+				else
+				{
+					//lint -e{534}
+					remove(temporaryName.c_str());
+				}
+				backupName.clear();
+			}
+		}
+		
+		// -------------------------------------------------------------------
+		// 2.4.4  Page size of the database
+		sint EhzDataBase::getPageSize(void) const
+		{
+			sint pageSize = 4096;
+			sqlite3_stmt *stmt = null<sqlite3_stmt *>();
+			//lint -e{971}
+			if ((SQLITE_OK == sqlite3_prepare_v2(dbHandle, "PRAGMA page_size;", -1, &stmt, null<const mchar **>())) && (SQLITE_ROW == sqlite3_step(stmt)))
+			{
+				pageSize = sqlite3_column_int(stmt, 0);
+			}
+			//lint -e{534}
+			sqlite3_finalize(stmt);
+			return (pageSize > 0) ? pageSize : 4096;
+		}
+		
+		
+		
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Database with an own writer thread
+
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 3.1 Construction / Destruction
+		
+		// -----------------------------
+		// 3.1.1 Snapshot. Measured values for all EHZ
+		EhzDataBaseWriter::Snapshot::Snapshot(void) : timeOfValues(null<EhzLogTimeUnit>()), measuredValues(EhzInternal::getNumberOfEhz())
+		{
+		}
+		
+		// -----------------------------
+		// 3.1.2 Explicit constructor
+		// The database is opened by the base class in the context of the caller. Then the writer thread is started
+		EhzDataBaseWriter::EhzDataBaseWriter(const std::string &ehzDatabaseNamel, const uint queueSize, const OverflowPolicy::Type overflowPolicyl, const DatabaseSchema::Type databaseSchemal) :
+																		EhzDataBase(ehzDatabaseNamel, databaseSchemal),
+																		ring((null<uint>() == queueSize) ? 1U : queueSize),
+																		head(null<u64>()),
+																		tail(null<u64>()),
+																		positionBeingCopied(null<u64>()),
+																		overflowPolicy(overflowPolicyl),
+																		coalescedSnapshot(),
+																		coalescedSnapshotIsPending(false),
+																		numberOfLostSnapshots(null<u64>()),
+																		snapshotInWriterThread(),
+																		valuesInWriterThread(EhzInternal::getNumberOfEhz()),
+																		writerThread(),
+																		writerThreadIsRunning(false),
+																		snapshotAvailable(),
+																		stopRequested(false),
+																		//lint -e{921}
+																		lastBackupInterval((static_cast<EhzLogTimeUnit>(time(null<time_t*>())) - DatabaseBackupOffsetInS) / DatabaseBackupIntervalInS),
+																		backupStartRequested(false),
+																		backupStepRequested(false),
+																		backupIsRunning(false),
+																		deferredErrorMessagesMutex(),
+																		deferredErrorMessages()
+		{
+			//lint -e{534}
+			pthread_mutex_init(&deferredErrorMessagesMutex, null<const pthread_mutexattr_t *>());
+			//lint -e{534}
+			sem_init(&snapshotAvailable, 0, 0U);
+			
+			if (0 == pthread_create(&writerThread, null<const pthread_attr_t *>(), &EhzDataBaseWriter::writerThreadFunction, this))
+			{
+				writerThreadIsRunning = true;
+			}
+			else
+			{
+				ui << "Could not start database writer thread. Writing directly"  << std::endl;
+			}
+		}
+		
+		// -----------------------------
+		// 3.1.3 Destructor
+		// Stop the writer thread. It will write everything from the ring.
+		// Then the base class writes the rest of its write behind queue and closes the database
+		//lint -e{1579}
+		EhzDataBaseWriter::~EhzDataBaseWriter(void)
+		{
+			try
+			{
+				if (writerThreadIsRunning)
+				{
+					__atomic_store_n(&stopRequested, true, __ATOMIC_SEQ_CST);
+					//lint -e{534}
+					sem_post(&snapshotAvailable);
+					//lint -e{534}
+					pthread_join(writerThread, null<void **>());
+					writerThreadIsRunning = false;
+				}
+				// Now we are alone. Write a coalesced snapshot, that did not fit into the ring any longer
+				if (coalescedSnapshotIsPending)
+				{
+					coalescedSnapshot.measuredValues.extract(valuesInWriterThread);
+					storeMeasuredValues(valuesInWriterThread, coalescedSnapshot.timeOfValues);
+					coalescedSnapshotIsPending = false;
+				}
+				showDeferredErrorMessages();
+				//lint -e{534}
+				sem_destroy(&snapshotAvailable);
+				//lint -e{534}
+				pthread_mutex_destroy(&deferredErrorMessagesMutex);
+			}
+			catch(...)
+			{
+			}
+		}
+
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 3.2 Producer side. Called by the event loop
+	
+		// -------------------------------------------------------------------
+		// 3.2.1  Push measured values into the ring
+		boolean EhzDataBaseWriter::push(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz)
+		{
+			boolean nothingLost = true;
+			
+			// Show what the writer thread had to complain about
+			showDeferredErrorMessages();
+			
+			//lint -e{921}
+			const EhzLogTimeUnit nowTime = static_cast<EhzLogTimeUnit>(time(null<time_t*>() ));
+			
+			if (!writerThreadIsRunning)
+			{
+				// No thread. Store in the context of the caller
+				storeMeasuredValues(allMeasuredValuesForAllEhz, nowTime);
+			}
+			else
+			{
+				nothingLost = prepareCoalescedSnapshot(nowTime);
+				coalescedSnapshot.measuredValues.assign(allMeasuredValuesForAllEhz);
+				coalescedSnapshotIsPending = !putSnapshot(coalescedSnapshot);
+			}
+			return nothingLost;
+		}
+		
+		// The same for the published values of the EhzSystem. They are used directly to build the snapshot
+		boolean EhzDataBaseWriter::push(const EhzInternal::PublishedMeasuredValues &publishedMeasuredValues)
+		{
+			boolean nothingLost = true;
+			showDeferredErrorMessages();
+			//lint -e{921}
+			const EhzLogTimeUnit nowTime = static_cast<EhzLogTimeUnit>(time(null<time_t*>() ));
+			
+			if (!writerThreadIsRunning)
+			{
+				// No thread. The database needs the values with strings
+				coalescedSnapshot.measuredValues.assign(publishedMeasuredValues);
+				coalescedSnapshot.measuredValues.extract(valuesInWriterThread);
+				storeMeasuredValues(valuesInWriterThread, nowTime);
+			}
+			else
+			{
+				nothingLost = prepareCoalescedSnapshot(nowTime);
+				coalescedSnapshot.measuredValues.assign(publishedMeasuredValues);
+				coalescedSnapshotIsPending = !putSnapshot(coalescedSnapshot);
+			}
+			return nothingLost;
+		}
+		
+		// Build the snapshot directly in the coalesced snapshot buffer. So nothing needs to be copied twice
+		// Returns false, if an older coalesced snapshot is overwritten
+		boolean EhzDataBaseWriter::prepareCoalescedSnapshot(const EhzLogTimeUnit nowTime)
+		{
+			boolean nothingLost = true;
+			// First try to get rid of an older coalesced snapshot
+			if (coalescedSnapshotIsPending && putSnapshot(coalescedSnapshot))
+			{
+				coalescedSnapshotIsPending = false;
+			}
+			
+			// The buffer is free, if there is nothing pending. If something is pending, it will be overwritten (coalesced)
+			if (coalescedSnapshotIsPending)
+			{
+				++numberOfLostSnapshots;
+				nothingLost = false;
+			}
+			coalescedSnapshot.timeOfValues = nowTime;
+			return nothingLost;
+		}
+		
+		// -------------------------------------------------------------------
+		// 3.2.2  Put a snapshot into the ring
+		boolean EhzDataBaseWriter::putSnapshot(const Snapshot &snapshot)
+		{
+			boolean snapshotStored = true;
+			const u64 ringSize = static_cast<u64>(ring.size());
+			u64 oldestPosition = __atomic_load_n(&tail, __ATOMIC_SEQ_CST);
+			
+			// Ring full?
+			if ((head - oldestPosition) >= ringSize)
+			{
+				if (OverflowPolicy::DropOldest == overflowPolicy)
+				{
+					// Take away the oldest snapshot. If the consumer was faster, it has taken it. Also fine
+					if (__atomic_compare_exchange_n(&tail, &oldestPosition, oldestPosition + 1ULL, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+					{
+						++numberOfLostSnapshots;
+					}
+				}
+				else
+				{
+					// Coalesce. Caller keeps the snapshot
+					snapshotStored = false;
+				}
+			}
+			
+			if (snapshotStored)
+			{
+				// The slot has been used for position head - ringSize before. The consumer may still copy it. This takes only a moment
+				if (head >= ringSize)
+				{
+					while ((head - ringSize + 1ULL) == __atomic_load_n(&positionBeingCopied, __ATOMIC_SEQ_CST))
+					{
+						//lint -e{534}
+						sched_yield();
+					}
+				}
+				ring[static_cast<uint>(head % ringSize)] = snapshot;
+				__atomic_store_n(&head, head + 1ULL, __ATOMIC_SEQ_CST);
+				// Wake up the writer thread
+				//lint -e{534}
+				sem_post(&snapshotAvailable);
+			}
+			return snapshotStored;
+		}
+		
+		// -------------------------------------------------------------------
+		// 3.2.3  Backup timer. Start a backup at the beginning of an interval and drive a running backup
+		void EhzDataBaseWriter::requestBackupStep(const EhzLogTimeUnit nowTime)
+		{
+			const EhzLogTimeUnit backupInterval = (nowTime - DatabaseBackupOffsetInS) / DatabaseBackupIntervalInS;
+			if (backupInterval != lastBackupInterval)
+			{
+				lastBackupInterval = backupInterval;
+				requestBackup();
+			}
+			if (__atomic_load_n(&backupStartRequested, __ATOMIC_SEQ_CST) || __atomic_load_n(&backupIsRunning, __ATOMIC_SEQ_CST))
+			{
+				if (!writerThreadIsRunning)
+				{
+					runBackupStep();
+				}
+				// There is at most one outstanding step. If the writer thread is busy with inserts, steps are left out
+				else if (!__atomic_exchange_n(&backupStepRequested, true, __ATOMIC_SEQ_CST))
+				{
+					//lint -e{534}
+					sem_post(&snapshotAvailable);
+				}
+				else
+				{
+					// The last step has not been done yet
+				}
+			}
+			// Messages about the backup
+			showDeferredErrorMessages();
+		}
+		
+		// -------------------------------------------------------------------
+		// 3.2.4  Show error messages from the writer thread
+		// The user interface may only be used by the event loop
+		void EhzDataBaseWriter::showDeferredErrorMessages(void)
+		{
+			// Never wait for the writer thread. If the messages are locked now, we will show them next time
+			if (0 == pthread_mutex_trylock(&deferredErrorMessagesMutex))
+			{
+				if (!deferredErrorMessages.empty())
+				{
+					ui << deferredErrorMessages;
+					deferredErrorMessages.clear();
+				}
+				//lint -e{534}
+				pthread_mutex_unlock(&deferredErrorMessagesMutex);
+			}
+		}
+
+
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 3.3 Consumer side. The writer thread
+	
+		// -------------------------------------------------------------------
+		// 3.3.1  Thread function. Run the loop of the writer
+		void *EhzDataBaseWriter::writerThreadFunction(void *ehzDataBaseWriter)
+		{
+			static_cast<EhzDataBaseWriter *>(ehzDataBaseWriter)->runWriterThread();
+			return null<void *>();
+		}
+		
+		// -------------------------------------------------------------------
+		// 3.3.2  Writer loop. Wait for snapshots and store them
+		void EhzDataBaseWriter::runWriterThread(void)
+		{
+			const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Database);
+			boolean stop = false;
+			while (!stop)
+			{
+				// Wait for the next snapshot or for the stop request
+				if (0 == sem_wait(&snapshotAvailable))
+				{
+					// Read the stop request before emptying the ring. So nothing that was pushed before the request gets lost
+					stop = __atomic_load_n(&stopRequested, __ATOMIC_SEQ_CST);
+					while (takeSnapshot(snapshotInWriterThread))
+					{
+						snapshotInWriterThread.measuredValues.extract(valuesInWriterThread);
+						storeMeasuredValues(valuesInWriterThread, snapshotInWriterThread.timeOfValues);
+					}
+					// The backup continues between the inserts
+					if (__atomic_exchange_n(&backupStepRequested, false, __ATOMIC_SEQ_CST))
+					{
+						runBackupStep();
+					}
+				}
+			}
+		}
+		
+		// -------------------------------------------------------------------
+		// 3.3.3  Copy the oldest snapshot out of the ring
+		boolean EhzDataBaseWriter::takeSnapshot(Snapshot &snapshot)
+		{
+			boolean snapshotTaken = false;
+			boolean ringIsEmpty = false;
+			const u64 ringSize = static_cast<u64>(ring.size());
+			
+			while (!snapshotTaken && !ringIsEmpty)
+			{
+				u64 oldestPosition = __atomic_load_n(&tail, __ATOMIC_SEQ_CST);
+				if (oldestPosition == __atomic_load_n(&head, __ATOMIC_SEQ_CST))
+				{
+					ringIsEmpty = true;
+				}
+				else
+				{
+					// Tell the producer what we are going to copy. Then claim it
+					__atomic_store_n(&positionBeingCopied, oldestPosition + 1ULL, __ATOMIC_SEQ_CST);
+					if (__atomic_compare_exchange_n(&tail, &oldestPosition, oldestPosition + 1ULL, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+					{
+						snapshot = ring[static_cast<uint>(oldestPosition % ringSize)];
+						snapshotTaken = true;
+					}
+					// Else: The producer has dropped it. Try the next one
+					__atomic_store_n(&positionBeingCopied, null<u64>(), __ATOMIC_SEQ_CST);
+				}
+			}
+			return snapshotTaken;
+		}
+		
+		// -------------------------------------------------------------------
+		// 3.3.4  Start a requested backup and copy the next pages
+		void EhzDataBaseWriter::runBackupStep(void)
+		{
+			if (__atomic_exchange_n(&backupStartRequested, false, __ATOMIC_SEQ_CST))
+			{
+				// The records in the write behind queue belong into the backup
+				flush();
+				startBackup(EhzDatabaseBackupName);
+			}
+			__atomic_store_n(&backupIsRunning, stepBackup(), __ATOMIC_SEQ_CST);
+		}
+		
+		// -------------------------------------------------------------------
+		// 3.3.5  Collect error messages for the event loop
+		void EhzDataBaseWriter::showErrorMessage(const std::string &errorMessage) const
+		{
+			//lint -e{534}
+			pthread_mutex_lock(&deferredErrorMessagesMutex);
+			deferredErrorMessages += errorMessage;
+			deferredErrorMessages += '\n';
+			//lint -e{534}
+			pthread_mutex_unlock(&deferredErrorMessagesMutex);
+		}
+		
+		
+		
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. Read only access for queries
+
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 4.1 Construction / Destruction
+		
+		// Open the database read only. The writer must have created it before
+		EhzDataBaseReader::EhzDataBaseReader(const std::string &ehzDatabaseNamel, const DatabaseSchema::Type databaseSchemal) :
+																		databaseSchema(databaseSchemal),
+																		dbHandle(null<sqlite3 *>()),
+																		preparedSql(),
+																		rangeStmt(null<sqlite3_stmt *>()),
+																		seekStmt(null<sqlite3_stmt *>())
+		{
+			//lint -e{971}
+			if (SQLITE_OK != sqlite3_open_v2(ehzDatabaseNamel.c_str(), &dbHandle, SQLITE_OPEN_READONLY, null<mchar *>() ))
+			{
+				//lint -e{534}
+				sqlite3_close(dbHandle);
+				dbHandle = null<sqlite3 *>();
+				ui << "Could not open database for queries"  << std::endl;
+			}
+		}
+		
+		//lint -e{1579}
+		EhzDataBaseReader::~EhzDataBaseReader(void)
+		{
+			try
+			{
+				//lint -e{534}
+				sqlite3_finalize( rangeStmt );
+				//lint -e{534}
+				sqlite3_finalize( seekStmt );
+				if (isOpen())
+				{
+					//lint -e{534}
+					sqlite3_close(dbHandle);
+				}
+			}
+			catch(...)
+			{
+			}
+		}
+		
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 4.2 Queries
+		
+		// -------------------------------------------------------------------
+		// 4.2.1  Build the SQL string for a range query
+		
+		// The longest period that fits into the resolution. At least the shortest one
+		uint EhzDataBaseReader::getRollUpPeriodForResolution(const EhzLogTimeUnit resolution)
+		{
+			uint period = null<uint>();
+			for (uint i = null<uint>(); i < EhzLogPeriodCount; ++i)
+			{
+				if ((EhzLogPeriodInS[i] <= resolution) && (EhzLogPeriodInS[i] > EhzLogPeriodInS[period]))
+				{
+					period = i;
+				}
+			}
+			return period;
+		}
+		
+		// Parameter: ?1 from time, ?2 to time, ?3 maximum number of rows. Empty string, if there is no such numerical value
+		// The seek query gets the time of the first row at or after ?1. This is one lookup in the primary key
+		std::string EhzDataBaseReader::buildRangeQuery(const uint meter, const uint valueId, const EhzLogTimeUnit resolution, std::string &seekSql) const
+		{
+			std::ostringstream sql;
+			std::ostringstream seekSqlStream;
+			if ((meter < EhzInternal::getNumberOfEhz()) && (valueId < NumberOfEhzMeasuredData) && 
+				(EhzMeasuredDataType::Number == EhzInternal::getEhzConfigDefinition(meter).ehzMeasuredDataType[valueId]))
+			{
+				std::ostringstream columnName;
+				//lint --e{1963,9050}
+				columnName << measuredValueColumnName << valueId << ehzColumnName << meter;
+				if (null<EhzLogTimeUnit>() == resolution)
+				{
+					// Raw data. The value is selected 4 times, so that the result has always the same columns
+					const std::string valueName((DatabaseSchema::Narrow == databaseSchema) ? std::string(&valueColumnName[0]) : columnName.str());
+					const mchar *const tableName = (DatabaseSchema::Narrow == databaseSchema) ? &ehzSqliteSampleTableName[0] : &ehzSqliteDatabaseTableName[0];
+					sql << "SELECT " << timeBaseColumnName << ", " << valueName << ", " << valueName << ", " << valueName << ", " << valueName << " FROM " << tableName << " WHERE ";
+					seekSqlStream << "SELECT MIN(" << timeBaseColumnName << ") FROM " << tableName << " WHERE ";
+					if (DatabaseSchema::Narrow == databaseSchema)
+					{
+						sql << meterColumnName << '=' << meter << " AND " << valueIdColumnName << '=' << valueId << " AND ";
+						seekSqlStream << meterColumnName << '=' << meter << " AND " << valueIdColumnName << '=' << valueId << " AND ";
+					}
+					else
+					{
+						// Records without this value (e.g. EHZ not available) are skipped
+						sql << valueName << " IS NOT NULL AND ";
+					}
+					sql << timeBaseColumnName << " BETWEEN ?1 AND ?2 ORDER BY " << timeBaseColumnName << " LIMIT ?3;";
+					seekSqlStream << timeBaseColumnName << " >= ?1;";
+				}
+				else
+				{
+					const uint period = getRollUpPeriodForResolution(resolution);
+					sql << "SELECT " << bucketStartColumnName;
+					for (uint suffix = null<uint>(); suffix < NumberOfRollUpColumnSuffixes; ++suffix)
+					{
+						sql << ", " << columnName.str() << rollUpColumnSuffix[suffix];
+					}
+					// Buckets without valid samples of this value are skipped
+					sql << " FROM " << ehzSqliteRollUpTableName << EhzLogPeriodInS[period] << " WHERE " << columnName.str() << rollUpColumnSuffix[null<uint>()] << " IS NOT NULL AND "
+						<< bucketStartColumnName << " BETWEEN ?1 AND ?2 ORDER BY " 
+						<< bucketStartColumnName << " LIMIT ?3;";
+					seekSqlStream << "SELECT MIN(" << bucketStartColumnName << ") FROM " << ehzSqliteRollUpTableName << EhzLogPeriodInS[period] << " WHERE " 
+						<< bucketStartColumnName << " >= ?1;";
+				}
+			}
+			seekSql = seekSqlStream.str();
+			return sql.str();
+		}
+		
+		// -------------------------------------------------------------------
+		// 4.2.2  Read rows in a time range
+		
+		boolean EhzDataBaseReader::readRange(const uint meter, const uint valueId, const EhzLogTimeUnit fromTime, const EhzLogTimeUnit toTime, 
+											 const EhzLogTimeUnit resolution, const uint maxRows, std::vector<HistoryRow> &historyRows, EhzLogTimeUnit &nextFromTime)
+		{
+			//lint --e{534,917}
+			historyRows.clear();
+			nextFromTime = toTime + 1;
+			std::string seekSql;
+			const std::string sql(buildRangeQuery(meter, valueId, resolution, seekSql));
+			boolean rc = isOpen() && !sql.empty();
+			
+			// Prepare only, if this is a different query than the last one
+			if (rc && (sql != preparedSql))
+			{
+				sqlite3_finalize( rangeStmt );
+				rangeStmt = null<sqlite3_stmt *>();
+				sqlite3_finalize( seekStmt );
+				seekStmt = null<sqlite3_stmt *>();
+				preparedSql.clear();
+				//lint -e{971}
+				rc = (SQLITE_OK == sqlite3_prepare_v2( dbHandle, sql.c_str(), -1, &rangeStmt, null<const mchar **>() )) &&
+					 (SQLITE_OK == sqlite3_prepare_v2( dbHandle, seekSql.c_str(), -1, &seekStmt, null<const mchar **>() ));
+				if (rc)
+				{
+					preparedSql = sql;
+				}
+			}
+			
+			// The window starts at the first row. So parts of the range without rows do not need pages
+			EhzLogTimeUnit windowStartTime = nextFromTime;
+			if (rc)
+			{
+				sqlite3_bind_int64(seekStmt, 1, static_cast<sqlite3_int64>(fromTime));
+				if ((SQLITE_ROW == sqlite3_step(seekStmt)) && (SQLITE_NULL != sqlite3_column_type(seekStmt, 0)))
+				{
+					windowStartTime = static_cast<EhzLogTimeUnit>(sqlite3_column_int64(seekStmt, 0));
+				}
+				sqlite3_reset( seekStmt );
+			}
+			
+			if (rc && (windowStartTime <= toTime))
+			{
+				// The time is part of the primary key. So one page scans at most one row per second or per bucket of the window
+				// Rows without the value (e.g. wide schema and EHZ not available) are skipped, but still scanned
+				const EhzLogTimeUnit secondsPerRow = (null<EhzLogTimeUnit>() == resolution) ? 1 : static_cast<EhzLogTimeUnit>(EhzLogPeriodInS[getRollUpPeriodForResolution(resolution)]);
+				const EhzLogTimeUnit window = static_cast<EhzLogTimeUnit>(HistoryQueryMaxScannedRows) * secondsPerRow;
+				const EhzLogTimeUnit windowEndTime = ((toTime - windowStartTime) < window) ? toTime : ((windowStartTime + window) - 1);
+				nextFromTime = windowEndTime + 1;
+				
+				sqlite3_bind_int64(rangeStmt, 1, static_cast<sqlite3_int64>(windowStartTime));
+				sqlite3_bind_int64(rangeStmt, 2, static_cast<sqlite3_int64>(windowEndTime));
+				sqlite3_bind_int64(rangeStmt, 3, static_cast<sqlite3_int64>(maxRows));
+				HistoryRow historyRow;
+				while (SQLITE_ROW == sqlite3_step(rangeStmt))
+				{
+					historyRow.time = static_cast<EhzLogTimeUnit>(sqlite3_column_int64(rangeStmt, 0));
+					historyRow.minimum = sqlite3_column_double(rangeStmt, 1);
+					historyRow.maximum = sqlite3_column_double(rangeStmt, 2);
+					historyRow.average = sqlite3_column_double(rangeStmt, 3);
+					historyRow.last = sqlite3_column_double(rangeStmt, 4);
+					historyRows.push_back(historyRow);
+				}
+				sqlite3_reset( rangeStmt );
+				// A full page. The time is unique in all tables for one value of one meter. So the next page starts after the last row
+				if (maxRows == historyRows.size())
+				{
+					nextFromTime = historyRows.back().time + 1;
+				}
+			}
+			return rc;
+		}
+		
+		
+
+	} // End of namespace
+
@@ -1,573 +1,1038 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-// ehz.cpp
-//
-// General Description
-//
-// This module is a part of an application tor read the data from Electronic Meters for Electric Power
-//
-// In Germany they are called EHZ. Hence the name of the module an variables.
-//
-// The EHZ transmits data via an infrared interface. The protocoll is described in:
-//
-//  http://www.emsycon.de/downloads/SML_081112_103.pdf
-//
-// In this module the properties and functionalities of one EHZ and an EHZ System
-// consisting of 1 or more EHZ are desribed. Every EHZ has an associted serial port.
-// All data are received thorugh the serial port. The serial port is managed via an
-// Eventhandler. The EHZ parses the data from the serial port, builds a data structure
-// (the parse tree) and informs others that data is available
-//
-// The EHZ System is configuered via one "Configuration" structure.
-// It gets the data from the contained EHZ and stores it in a database.
-// A timer is used for cyclic storage of data records.
-// Other interested parties are informed as well abaout the availability of new datasets
-// via a publisher subscriber mechanism.
-// 
-
-
-#include "ehz.hpp"
-#include "reactor.hpp"
-#include "bytestring.hpp"
-#include "userinterface.hpp"
-
-#include <set>
-
- 
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 1. Definition of EHZ member functions
-
-
-	namespace EhzInternal
-	{
-
-	
-	// ---------------------------------------------
-	// 1.1 Set the properties for one dedicated EHZ
-
-		//lint -e{1901,1911}
-		// Add a subscription for the serial port. So make EHZ ready to receive data
-		// Constructor for Ehz
-		Ehz::Ehz(const EhzConfigDefinition &ecd) : Publisher<Ehz>(), 								// Initialize base class publisher
-													Subscriber<SerialInternal::EhzSerialPort>(),	// Initialize base class subscriber
-													ehzConfigDefinition(ecd), 						// Store Ehz specific properties
-													ehzSerialPort(ecd.EhzSerialPortName), 			// The Ehz has a serial port 
-													smlListEntryEvaluation(ecd, &allMeasuredValuesForOneEhz), 	// Set reference to result values
-													parser(), 										// Ehz has a parser
-													allMeasuredValuesForOneEhz() 					// Ehz will hold the resulting data 
-		{
-			// Ehz is a subscriber to the serial port
-			// Evertime when a byte arrives, we want to know and process this byte
-			ehzSerialPort.addSubscription(this);
-		}
-
-	// -------------------------------
-	// 1.2 Detach EHZ from Serial port
-	
-		// Destructor
-		Ehz::~Ehz(void) 
-		{ 
-
-			// We call an external function and never know what could happen
-			try 
-			{ 
-			
-				// Remove subscription
-				
-				ehzSerialPort.removeSubscription(this); 
-				// Debug info
-			}
-			catch(...)
-			{
-				// We don't care on result
-			}
-		}
-
-	// ------------------------------------------
-	// 1.3 Start receiving Data from serial port
-
-		// Open port and register Ehz with Event Reactor
-		void Ehz::start(void)  
-		{ 
-			// Open Serial Port
-			ehzSerialPort.start();
-			if(null<Handle>() != ehzSerialPort.getHandle())
-			{
-				// If serial port could be opened then register the 
-				// instance of this serial port of this Ehz
-				reactorRegisterEventHandler(&ehzSerialPort,EventTypeIn);
-						
-			}
-		}
-
-	// -------------------------------------------------------
-	// 1.4 Stop reading from serial port and close serial port
-	
-		// 
-		void Ehz::stop(void)   
-		{ 
-			if (null<Handle>() != ehzSerialPort.getHandle())
-			{
-				// Unregister this serial port of this Ehz from the Event Handler
-				reactorUnRegisterEventHandler(&ehzSerialPort);
-			
-				// Close the serial port
-				ehzSerialPort.stop(); 
-			}
-			
-		}
-
-		
-	// ------------------------------------------
-	// 1.5 Process data recievied via serial port
-		
-		// One of the major functions:
-		// - Receive data stream from serial port
-		// - Parse data
-		// - Build a parse tree
-		// - Extract needed data from parse tree
-		// - Inform interested parties that a new dataset is available
-		
-		// The serial port called has a notification function
-		// Therefore the Ehz will be updated here
-		void Ehz::update(SerialInternal::EhzSerialPort *const publisher) 
-		{
-			// Get data from serial port
-			const EhzDatabyte ehzDatabyte = publisher->getLastReceivedByte();
-			//ui[ehzConfigDefinition.index] << ehzDatabyte;
-
-			// Push the received byte into the parser. The parser
-			// will build a parse tree and get a complete SML File
-			// with all data
-			const prCode parserResult = parser.parse(ehzDatabyte, getEhzIndex() );
-			//Check output of parser function and act accordingly
-			//lint -e{788}
-			switch (parserResult)
-			{
-				case pr_PROCESSING:
-					// Everything ongoing without error. Bytes from the serial port are processed 
-					// normally and the SML file is not yet fully read. Simply do nothing and wait
-					// until parser has completed
-					// Debug output
-					//ui << "--------> Parse Result SML Overall: Processing"  << std::endl; 
-					break;
-				case pr_DONE:
-					// The parser read successfully a complete SML File. It built a parse tree and
-					// all data are stored in this parse tree. We will now traverse the tree
-					// with our dedicated visitor and retrieve our desired information
-					smlListEntryEvaluation.clear();
-					parser.traverseAndEvaluate(&smlListEntryEvaluation);
-
-					// The Ehz informs now interested parties (subscribers) that new data is available
-									
-					Ehz::notifySubscribers();
-					// Reset the parser and be ready for the next SML File
-					parser.reset();
-					break;
-					
-				// In case of error or any othe outcome
-				case pr_ERROR:
-					//FALLTHROUGH
-				default: 
-					{
-						// Show a debug Error message
-						
-						// Get time of now
-						std::string strNow;
-						//lint -e{534}    // Do not need return value
-						getNowTime(strNow);
-						
-						// Show error message
-						ui[ehzConfigDefinition.index] << strNow; 
-						//lint -e{641,1911,911}
-						ui[ehzConfigDefinition.index] << "Parser Error: " << parserResult << std::endl; 
-						
-						// And reset the parser
-						parser.reset();
-					}
-					break;
-			}	
-		}
-
-	} // End of namespace 
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 2. Definition of EHZ System member functions
-//
-// The EHZ System is a collection of EHZ
-// It will be automatically be configured using a configuration structure
-
-
-	// ---------------------------------------
-	// 2.1 Initialize and setup the EHZ System
-
-		 
-		//lint -e429    We store the pointer to Ehz in a vector
-		// Constructor
-		EhzSystem::EhzSystem(const std::vector<EhzConfigDefinition> &vecd)  : 	Subscriber<EhzInternal::Ehz>(), 
-																				Subscriber<EventTimer>(),
-																				vecEhzConfigDefinitionNULL(),
-																				allMeasuredValuesForAllEhz(EhzInternal::MyNumberOfEhz), 
-																				vehzConfigDefinition(vecd), 
-																				vehz(), 
-																				ehzSystemTimer(10000UL), 
-																				ehzDataBase(null<DatabaseInternal::EhzDataBase *>())  
-		{
-			// Pointer to Ehz. Initialize to 0
-			EhzInternal::Ehz *pehz = null<EhzInternal::Ehz *>();
-
-			// The configuration defines the number of the EHZ's in the system that need to be created now
-			for (uint ehzInstance = 0U; ehzInstance < vehzConfigDefinition.size(); ehzInstance++)
-			{	
-				//This will read the properties for this specific Ehz that we are going to create
-				const EhzConfigDefinition &ecd = vehzConfigDefinition[ehzInstance];
-				
-				// Create a new Ehz
-				 
-				//lint -e774 -e948 --e(1938)
-				pehz = new EhzInternal::Ehz(ecd);
-				
-				// Ehz could be created. Store result in our container
-				vehz.push_back(pehz);
-				// And add a subscriber in the created Ehz for us
-				// Sow the EHZ system will receive information that the EHZ has new data
-				pehz->addSubscription(this);
-			}
-		
-			//lint -e{1901,1911}
-			// Create a new database, where the Results of all EHZ will be stored
-			ehzDataBase = new DatabaseInternal::EhzDataBase(DatabaseInternal::EhzDatabaseName);
-
-			// And, we want ro receive a timerevent all x seconds. Then the data, stored internally in the EHZ System class,
-			// will be stored in the database
-			ehzSystemTimer.addSubscription(this);
-		}
-		 
-
-		
-	// ---------------------
-	// 2.2 Clear EHZ System
-		
-		// Destructor. Delete Ehz and their subscriptions
-		//lint -e{1740,1702,1579}
-		EhzSystem::~EhzSystem(void) 
-		{ 
-		
-			// Try catch because we call external functions and never know if they throw or not
-			try
-			{
-				
-				stop();
-			
-				// Stop cyclic timer for events to store datasets in the database
-				//ehzSystemTimer.stopTimer();
-
-				// We do not want to be notified any longer from the timer
-				ehzSystemTimer.removeSubscription(this);
-
-				// Close the database
-				delete ehzDataBase;
-
-				// Get number of Ehz in our Ehz System
-				const uint numberOfElements = vehz.size();
-
-				// For all Ehz in our EhzSystem
-				for (uint i=0U; i<numberOfElements; i++)
-				{
-					// remove subscription from Ehz
-					vehz[i]->removeSubscription(this);
-					// and delete it . . . 
-					delete vehz[i];
-				}
-
-			}
-			catch(...)
-			{
-				// No error handling
-			}
-		}
-
-		
-	// --------------------------------
-	// 2.3 Sanity chaeck for EHZ System
-	
-		// Check if the EhzSystem was initialized and contains plausible data
-		// The "index" from the configuratio data will be check.
-		// It must be in valid boundaries and the indices need to be unique
-		
-		boolean EhzSystem::isInitialized(void) const
-		{
-			// Assume that function returns OK
-			boolean rc = true;
-
-			// Get number of Ehz's in this EHZ System instance
-			// The indices must be between 0..(max-1)
-			const uint numberOfEhz = vehz.size();
-			
-			// Check, if Ehz are existing in our system at all
-			// Of course there must be EHZ in the system. Otherwise nothing will work
-			if (numberOfEhz > 0U)
-			{
-				// OK, at least one Ehz is existing. Check plausible indices
-				
-				// Iterate through existing Ehz and check indices
-				// Indices must be >=0 and <max
-				// Indices must be unique. We will use a c++ set to check this
-				std::set<uint> Indices;
-				// Result of the insert into a set function
-				std::pair<std::set<uint>::iterator,bool> insertResult;
-
-				// Iterate through all existing EHZ in the EHZ system
-				// and only as long as everything is ok and no error has been found
-				for (uint ehzIndex=0U; (ehzIndex <numberOfEhz) && rc; ehzIndex++)
-				{
-					// Read the index of the EHZ under check
-					const uint indexToCheck = vehz[ehzIndex]->getEhzIndex();
-					
-					// Index is uint. Cannot be < 0. Check for max value
-					if (indexToCheck >= numberOfEhz)
-					{
-						// Index number too big --> error
-						rc = false;
-						// Show debug message
-						ui << "Ehz Index wrong" << std::endl;
-					}
-					else
-					{
-						// Check if insert is double. Try to insert the index into a temporary c++ set
-						// This will fail, if index is already in
-						insertResult = Indices.insert(indexToCheck);
-						// Check for error
-						if (!insertResult.second)
-						{
-							// Double index --> error
-							rc = false;
-							// Show debug message
-							ui  << "Ehz Index wrong"  << std::endl;
-						}
-					}
-				}
-			}
-			else
-			{
-				// No Ehz in the system --> Error
-				rc = false;
-				// Show debug message
-				ui << "EhzSystem not initialized"  << std::endl;
-			}
-			return rc;
-		}
-
-	// ------------------------
-	// 2.4 Start the EHZ System
-
-		// Start all Ehz in our EHZ System
-		void EhzSystem::start(void)
-		{
-			// If the system has been initalized and there are Ehz in our EHZ System
-			if (isInitialized())
-			{
-				// Get number of Ehz's in our EHZ System 
-				const uint numberOfEhz = vehz.size();
-				
-				// Iterate through existing Ehz and start them
-				for (uint ehzIndex=0U; ehzIndex <numberOfEhz; ehzIndex++)
-				{
-					// Start Ehz
-					vehz[ehzIndex]->start();
-				}
-				// And start the timer
-				ehzSystemTimer.startTimerPeriodic();
-			}
-			else
-			{
-				ui << "EHZ System is not initialized. Could not be started" << std::endl;
-			}
-		}
-		
-		
-	// -----------------------
-	// 2.5 Stop the EHZ System
-	
-		// Stop all EHZ in our Ehz System
-		void EhzSystem::stop(void)
-		{
-			// If the system has been initalized and there are Ehz in our EHZ System
-			if (isInitialized())
-			{
-				// Stop the periodic timer
-				ehzSystemTimer.stopTimer();
-			
-				// Get number of Ehz's in our EHZ System 
-				const uint numberOfEhz = vehz.size();
-				// Iterate through existing Ehz and stop them
-				for (uint ehzIndex=0U; ehzIndex <numberOfEhz; ehzIndex++)
-				{
-					// Stop Ehz
-					vehz[ehzIndex]->stop();
-				}
-			}
-		}
-			
-	// ---------------------------------
-	// 2.6 Handle EHZ data present event
-			
-		// After one EHZ has parsed data from the serial port data stream
-		// and produced a result, it will call this function
-			
-		// This is the function that should do something with the results of all data
-		// At this moment we simply store print the results
-		void EhzSystem::update(EhzInternal::Ehz *const publisher)
-		{
-			// Check, which Ehz in our Ehz System sent the notification
-			const uint ehzIndex = publisher->getEhzIndex();
-			
-			// Get the resulting values
-			const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz = publisher->getAllMeasuredDataForOneEhz();
-			
-			// Make a copy of EHZ's latest values
-			// Yes, we want to copy data
-			allMeasuredValuesForAllEhz[ehzIndex] = allMeasuredValuesForOneEhz;
-
-			//lint -e{641,911}
-			if (DebugModeObis == globalDebugMode) 
-			{
-				//lint -e{1702}
-				// print all Obis Values:
-				for (std::set<std::string>::iterator ovi = allMeasuredValuesForOneEhz.obisValues.begin(); ovi != allMeasuredValuesForOneEhz.obisValues.end(); ++ovi)
-				{
-					ui[ehzIndex] << *ovi << "\n";
-				}
-				ui[ehzIndex] << "------------" << std::endl;
-			}
-			
-			// Print out result in debug screen
-			// Show Ehz number and time, when the data had been captured
-			ui(ehzIndex) << SetPos(0,0) << '(' << ehzIndex << "): " << allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluatedString;
-			
-			// Go through all measured value
-			for (uint i = 0U; i<NumberOfEhzMeasuredData; i++)
-			{
-				// What type does this value have
-				const EhzMeasuredDataType::Type emdt = vehzConfigDefinition[ehzIndex].ehzMeasuredDataType[i];
-				// Show status byte
-				const u32 status = (static_cast<u32>(allMeasuredValuesForOneEhz.measuredValueForOneEhz[i].status));	//lint !e921
-				ui(ehzIndex) << "\n(" << status << "): ";				
-			
-				
-				// If there is a value at all, then
-				if (EhzMeasuredDataType::Null != emdt)
-				{
-				
-					// Depending on the result beeing a string or a number
-					switch (emdt)
-					{
-						// If it is a number then print the numerical value
-						case EhzMeasuredDataType::Number:
-							
-							ui(ehzIndex) << allMeasuredValuesForOneEhz.measuredValueForOneEhz[i].doubleValue;
-							break;
-							
-						// If it is a string, then show that
-						case EhzMeasuredDataType::String:	
-							{
-								// Caveat: String may contain none printable characters
-								std::string smlStringTemp;
-								// In this case it will be converted to ascii coded hex
-								convertSmlByteStringNonePrintableCharacters(allMeasuredValuesForOneEhz.measuredValueForOneEhz[i].smlByteString, smlStringTemp);
-								// And show it
-								ui(ehzIndex) << smlStringTemp;
-							}
-							break;
-						case EhzMeasuredDataType::Null:
-							// Fallthrough
-						default:
-							// Nothing or Error: Don't do a thing
-							break;
-							
-					}
-					
-					
-					// Show the unit for this value
-					ui(ehzIndex) << allMeasuredValuesForOneEhz.measuredValueForOneEhz[i].unit;
-					
-				}
-			}
-			
-			ui(ehzIndex) << std::endl;
-		}
-
-		
-	// -----------------------------------------------------
-	// 2.7 Convert EHZ system data in a readable data stream
-		
-		// Data will be in a frame between STX and ETX
-		// Datasets will be separated by US
-		std::ostream& operator<< (std::ostream &out, const EhzSystem &ehzSystemP)
-		{
-			// Datastream will be in the form: STX data1 US data2 US .... dataN US ETX
-			//lint --e{1963,1950,9050}
-			
-			// So first an starting STX
-			out << charSTX;
-			// Then we will iterate though all measured values of all EHZ and convert them
-			for (std::vector<EhzInternal::AllMeasuredValuesForOneEhz>::const_iterator amvfoeI = ehzSystemP.allMeasuredValuesForAllEhz.begin(); amvfoeI != ehzSystemP.allMeasuredValuesForAllEhz.end(); ++amvfoeI)
-			{
-				out << *amvfoeI;
-			}
-			// And finalize data stream with ETX
-			out << charETX;
-			return out;
-		}
-
-
-	// ---------------------------------------------
-	// 2.8 Timer Call back. Store data in database
-
-		// Timer Callback
-		void EhzSystem::update(EventTimer *const)
-		{
-			ehzDataBase->storeMeasuredValues(allMeasuredValuesForAllEhz);
-		}
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+// ehz.cpp
+//
+// General Description
+//
+// This module is a part of an application tor read the data from Electronic Meters for Electric Power
+//
+// In Germany they are called EHZ. Hence the name of the module an variables.
+//
+// The EHZ transmits data via an infrared interface. The protocoll is described in:
+//
+//  http://www.emsycon.de/downloads/SML_081112_103.pdf
+//
+// In this module the properties and functionalities of one EHZ and an EHZ System
+// consisting of 1 or more EHZ are desribed. Every EHZ has an associted serial port.
+// All data are received thorugh the serial port. The serial port is managed via an
+// Eventhandler. The EHZ parses the data from the serial port, builds a data structure
+// (the parse tree) and informs others that data is available
+//
+// The EHZ System is configuered via one "Configuration" structure.
+// It gets the data from the contained EHZ and stores it in a database.
+// A timer is used for cyclic storage of data records.
+// Other interested parties are informed as well abaout the availability of new datasets
+// via a publisher subscriber mechanism.
+//
+// Normally the main reactor reads and parses the data of all EHZ. An EHZ may be moved into a worker
+// thread instead. The worker thread has its own reactor. It owns the serial port, the parser and the
+// evaluation of the EHZ. Complete values are handed over to the main reactor through a lock free ring
+// of buffers in the EHZ. The main reactor publishes them, as if it had parsed them itself.
+// 
+
+
+#include "ehz.hpp"
+#include "reactor.hpp"
+#include "bytestring.hpp"
+#include "userinterface.hpp"
+#include "logger.hpp"
+#include "allocation.hpp"
+#include "trace.hpp"
+
+#include <sys/eventfd.h>
+
+#include <map>
+#include <set>
+
+ 
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Definition of EHZ member functions
+
+
+	namespace EhzInternal
+	{
+
+	
+	// ---------------------------------------------
+	// 1.1 Set the properties for one dedicated EHZ
+
+		//lint -e{1901,1911}
+		// The data source of an Ehz: A serial port or a TCP connection, optionally with recording, or a replay of a capture file
+		SerialInternal::EhzSerialPort *createEhzSerialPort(const EhzConfigDefinition &ecd)
+		{
+			SerialInternal::EhzSerialPort *ehzSerialPort = null<SerialInternal::EhzSerialPort *>();
+			if (null<mchar>() != ecd.EhzReplayFileName[0])
+			{
+				ehzSerialPort = new SerialInternal::EhzReplayPort(ecd.EhzReplayFileName, ecd.EhzReplaySpeed);
+			}
+			else
+			{
+				if (null<mchar>() != ecd.EhzNetworkHost[0])
+				{
+					ehzSerialPort = new SerialInternal::EhzNetworkPort(ecd.EhzNetworkHost, ecd.EhzNetworkPort);
+				}
+				else
+				{
+					ehzSerialPort = new SerialInternal::EhzSerialPort(ecd.EhzSerialPortName);
+					ehzSerialPort->setFrameGap(ecd.EhzFrameGapInMs);
+				}
+				if (null<mchar>() != ecd.EhzCaptureFileName[0])
+				{
+					ehzSerialPort->setCaptureFileName(ecd.EhzCaptureFileName);
+				}
+			}
+			return ehzSerialPort;
+		}
+
+		//lint -e{1901,1911}
+		// Add a subscription for the serial port. So make EHZ ready to receive data
+		// Constructor for Ehz
+		Ehz::Ehz(const EhzConfigDefinition &ecd) : Publisher<Ehz>(), 								// Initialize base class publisher
+													Subscriber<SerialInternal::EhzSerialPort>(),	// Initialize base class subscriber
+													ehzConfigDefinition(ecd), 						// Store Ehz specific properties
+													ehzSerialPort(createEhzSerialPort(ecd)), 		// The Ehz has a serial port or a replay
+													smlListEntryEvaluation(ecd, &measuredValuesBuffer[1]), 	// Set reference to result values
+													parser(), 										// Ehz has a parser
+													measuredValuesBuffer(),							// Values of the SML File currently parsed, the last results and waiting ones
+													receivingMeasuredValues(&measuredValuesBuffer[1]),
+													publishedMeasuredValues(&measuredValuesBuffer[0]),
+													generation(null<u64>()),
+													numberOfHandedOverMeasuredValues(1ULL),			// Nothing handed over and nothing taken yet
+													numberOfTakenMeasuredValues(1ULL),
+													handOverTimeInNs(),
+													ehzWorkerNotification(null<EhzWorkerNotification *>()),	// Parsed by the main reactor
+													parserBoundaryList(),							// Results of the block oriented parser
+													ehzMetrics(),
+													updateStartTimeInNs(null<u64>())
+		{
+			// Ehz is a subscriber to the serial port
+			// Evertime when a byte arrives, we want to know and process this byte
+			ehzSerialPort->addSubscription(this);
+			// Get the values from the SmlListEntries during parsing. No parse tree traversal
+			parser.setStreamingVisitor(&smlListEntryEvaluation);
+			// Only the configured values are needed. Skip the rest, if configured
+			parser.setSkipMode(ecd.EhzSkipMode, &smlListEntryEvaluation);
+		}
+
+	// -------------------------------
+	// 1.2 Detach EHZ from Serial port
+	
+		// Destructor
+		Ehz::~Ehz(void) 
+		{ 
+
+			// We call an external function and never know what could happen
+			try 
+			{ 
+			
+				// Remove subscription
+				
+				ehzSerialPort->removeSubscription(this); 
+				delete ehzSerialPort;
+			}
+			catch(...)
+			{
+				// We don't care on result
+			}
+		}
+
+	// ------------------------------------------
+	// 1.3 Start receiving Data from serial port
+
+		// Open port and register Ehz with Event Reactor
+		void Ehz::start(void)  
+		{ 
+			// Open Serial Port
+			ehzSerialPort->start();
+			if(null<Handle>() != ehzSerialPort->getHandle())
+			{
+				// If serial port could be opened then register the 
+				// instance of this serial port of this Ehz
+				// A network port registers itself, when the connection has been made
+				reactorRegisterEventHandler(ehzSerialPort,EventTypeIn);
+						
+			}
+		}
+
+	// -------------------------------------------------------
+	// 1.4 Stop reading from serial port and close serial port
+	
+		// 
+		void Ehz::stop(void)   
+		{ 
+			if (null<Handle>() != ehzSerialPort->getHandle())
+			{
+				// Unregister this serial port of this Ehz from the Event Handler
+				reactorUnRegisterEventHandler(ehzSerialPort);
+			}
+			// Close the serial port. A network port may have no handle, while it waits for a reconnect
+			ehzSerialPort->stop(); 
+		}
+
+		
+	// ------------------------------------------
+	// 1.5 Process data recievied via serial port
+		
+		// One of the major functions:
+		// - Receive data stream from serial port
+		// - Parse data
+		// - Build a parse tree
+		// - Extract needed data from parse tree
+		// - Inform interested parties that a new dataset is available
+		
+		// The serial port called has a notification function
+		// Therefore the Ehz will be updated here
+		void Ehz::update(SerialInternal::EhzSerialPort *const publisher) 
+		{
+			const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Input);
+			// Get data from serial port. This may be one byte or a complete block of bytes
+			size_t numberOfBytes = null<size_t>();
+			const EhzDatabyte *const ehzDatabytes = publisher->getLastReceivedBytes(numberOfBytes);
+			//ui[ehzConfigDefinition.index] << ehzDatabyte;
+			updateStartTimeInNs = MetricsInternal::getMonotonicTimeInNs();
+			ehzMetrics.bytesRead.add(numberOfBytes);
+
+			// Push the received bytes into the parser. The parser
+			// will build a parse tree and get a complete SML File
+			// with all data
+			const TraceInternal::TraceSpan traceSpan(TraceInternal::TraceProbe::Parse, getEhzIndex());
+			size_t consumedBytes = null<size_t>();
+			while (consumedBytes < numberOfBytes)
+			{
+				consumedBytes += parser.parse(&ehzDatabytes[consumedBytes], numberOfBytes - consumedBytes, getEhzIndex(), parserBoundaryList);
+				// Check all positions, where the parser finished its work and act accordingly
+				for (ParserBoundaryList::iterator pbli = parserBoundaryList.begin(); pbli != parserBoundaryList.end(); ++pbli)
+				{
+					evaluateParserResult(pbli->parserResult);
+				}
+			}
+		}
+		
+		// Check output of parser function and act accordingly
+		// As long as the parser returns pr_PROCESSING, nothing will be reported and nothing needs to be done.
+		// Bytes from the serial port are processed normally and the SML file is not yet fully read.
+		void Ehz::evaluateParserResult(const prCode parserResult)
+		{
+			//lint -e{788}
+			switch (parserResult)
+			{
+				case pr_PROCESSING:
+					// Simply do nothing and wait until parser has completed
+					// Debug output
+					//ui << "--------> Parse Result SML Overall: Processing"  << std::endl; 
+					break;
+				case pr_DONE:
+					// The parser read successfully a complete SML File. All SmlListEntries have already been
+					// evaluated by our streaming visitor. Now, after the checksums have been verified, we hand over the values
+					// The main reactor publishes them. Nothing is copied
+					TraceInternal::traceInstant(TraceInternal::TraceProbe::ParserDone, getEhzIndex());
+					handOverMeasuredValues();
+					// Reset the parser and be ready for the next SML File
+					parser.reset();
+					break;
+					
+				// In case of error or any othe outcome
+				case pr_ERROR:
+					//FALLTHROUGH
+				default: 
+					{
+						ehzMetrics.parserResyncs.increment();
+						TraceInternal::traceInstant(TraceInternal::TraceProbe::ParserError, getEhzIndex());
+						
+						// Show a debug Error message
+						
+						// Get time of now
+						std::string strNow;
+						//lint -e{534}    // Do not need return value
+						getNowTime(strNow);
+						
+						// Show error message. A broken line gives many errors. They are rate limited
+						static LogSite logSite;
+						Log log(logSite, ehzConfigDefinition.index);
+						//lint -e{641,1911,911}
+						log << strNow << "Parser Error: " << parserResult; 
+						
+						// Values of this SML file, that have been published early, are not valid
+						smlListEntryEvaluation.discardEarlyValues();
+						
+						// The block oriented parser has already reset the parse tree and skips
+						// the bytes up to the next SML file. So nothing more to do here
+					}
+					break;
+			}	
+		}
+
+	// ------------------------------------------
+	// 1.6 Hand over the values to the main reactor
+	
+		// Parsing thread. The buffer after the one handed over must be free: Not published and not waiting
+		// If the main reactor is that far behind, the values are dropped. The buffer is overwritten by the next SML File
+		void Ehz::handOverMeasuredValues(void)
+		{
+			const u64 numberOfTaken = __atomic_load_n(&numberOfTakenMeasuredValues, __ATOMIC_ACQUIRE);
+			if ((numberOfHandedOverMeasuredValues + 1ULL - numberOfTaken) <= static_cast<u64>(NumberOfMeasuredValuesBuffers - 2U))
+			{
+				handOverTimeInNs[numberOfHandedOverMeasuredValues % NumberOfMeasuredValuesBuffers] = updateStartTimeInNs;
+				__atomic_store_n(&numberOfHandedOverMeasuredValues, numberOfHandedOverMeasuredValues + 1ULL, __ATOMIC_RELEASE);
+				receivingMeasuredValues = &measuredValuesBuffer[numberOfHandedOverMeasuredValues % NumberOfMeasuredValuesBuffers];
+				smlListEntryEvaluation.setMeasuredValues(receivingMeasuredValues);
+				
+				if (null<EhzWorkerNotification *>() == ehzWorkerNotification)
+				{
+					// We are the main reactor. Publish at once
+					//lint -e{534}
+					takeMeasuredValues();
+				}
+				else
+				{
+					ehzWorkerNotification->requestWakeUp();
+				}
+			}
+			else
+			{
+				ehzMetrics.droppedMeasuredValues.increment();
+				// The values are overwritten by the next SML file. The early published ones are not valid
+				smlListEntryEvaluation.discardEarlyValues();
+			}
+		}
+		
+		// Main reactor. The buffer published before is given back to the parsing thread
+		boolean Ehz::takeMeasuredValues(void)
+		{
+			const boolean valuesAreAvailable = (numberOfTakenMeasuredValues != __atomic_load_n(&numberOfHandedOverMeasuredValues, __ATOMIC_ACQUIRE));
+			if (valuesAreAvailable)
+			{
+				const uint bufferIndex = static_cast<uint>(numberOfTakenMeasuredValues % NumberOfMeasuredValuesBuffers);
+				__atomic_store_n(&publishedMeasuredValues, &measuredValuesBuffer[bufferIndex], __ATOMIC_RELEASE);
+				//lint -e{534}
+				__atomic_add_fetch(&generation, 1ULL, __ATOMIC_RELEASE);
+				__atomic_store_n(&numberOfTakenMeasuredValues, numberOfTakenMeasuredValues + 1ULL, __ATOMIC_RELEASE);
+				
+				// The Ehz informs now interested parties (subscribers) that new data is available
+				Ehz::notifySubscribers();
+				ehzMetrics.parseToPublishLatency.observeSince(handOverTimeInNs[bufferIndex]);
+			}
+			return valuesAreAvailable;
+		}
+
+	// ------------------------------------------
+	// 1.7 Metrics
+	
+		// The ESC analysis counts frames and checksum errors itself, the parser the skipped bytes. Nothing extra on the hot path
+		// The parser may run in a worker thread. So the values are maybe a little bit old
+		const MetricsInternal::EhzMetrics &Ehz::getEhzMetrics(void)
+		{
+			const EscAnalysisStatistics &escAnalysisStatistics = parser.getEscAnalysisStatistics();
+			ehzMetrics.escFrames.set(__atomic_load_n(&escAnalysisStatistics.numberOfEscFrames, __ATOMIC_RELAXED));
+			ehzMetrics.crc16Mismatches.set(__atomic_load_n(&escAnalysisStatistics.numberOfCrc16Mismatches, __ATOMIC_RELAXED));
+			ehzMetrics.resyncSkippedBytes.set(__atomic_load_n(&parser.getParserStatistics().numberOfSkippedBytes, __ATOMIC_RELAXED));
+			ehzMetrics.octetBufferOverflows.set(__atomic_load_n(&parser.getParserStatistics().numberOfOctetBufferOverflows, __ATOMIC_RELAXED));
+			return ehzMetrics;
+		}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Worker threads
+
+
+	// ---------------------------------------------
+	// 2.1 Wake up of the main reactor
+	
+		// The eventfd is always registered with the main reactor
+		EhzWorkerNotification::EhzWorkerNotification(void) : EventHandlerBasic(), Publisher<EhzWorkerNotification>(), wakeUpIsRequested(false)
+		{
+			handle = eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+			if (handle < null<Handle>())
+			{
+				handle = null<Handle>();
+			}
+		}
+		
+		EhzWorkerNotification::~EhzWorkerNotification(void)
+		{
+			if (null<Handle>() != handle)
+			{
+				//lint -e{534}
+				close(handle);
+			}
+		}
+		
+		// Only the first request after a wake up writes the eventfd
+		void EhzWorkerNotification::requestWakeUp(void)
+		{
+			if (!__atomic_exchange_n(&wakeUpIsRequested, true, __ATOMIC_SEQ_CST))
+			{
+				const u64 wakeUp = 1ULL;
+				(void)::write(handle, &wakeUp, sizeof(wakeUp));
+			}
+		}
+		
+		// Reset the request before the values are taken. A hand over after that writes the eventfd again
+		EventProcessing::Action EhzWorkerNotification::handleEvent(const EventType)
+		{
+			u64 wakeUp;
+			(void)::read(handle, &wakeUp, sizeof(wakeUp));
+			__atomic_store_n(&wakeUpIsRequested, false, __ATOMIC_SEQ_CST);
+			notifySubscribers();
+			return EventProcessing::Continue;
+		}
+		
+		
+	// ---------------------------------------------
+	// 2.2 Worker thread
+	
+		// Called in the thread. The serial ports are registered with its reactor
+		void EhzWorkerThread::initialize(void)
+		{
+			for (std::vector<Ehz *>::iterator ehzIterator = vehz.begin(); ehzIterator != vehz.end(); ++ehzIterator)
+			{
+				(*ehzIterator)->start();
+			}
+		}
+		
+		void EhzWorkerThread::finalize(void)
+		{
+			for (std::vector<Ehz *>::iterator ehzIterator = vehz.begin(); ehzIterator != vehz.end(); ++ehzIterator)
+			{
+				(*ehzIterator)->stop();
+			}
+		}
+
+	} // End of namespace 
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Definition of EHZ System member functions
+//
+// The EHZ System is a collection of EHZ
+// It will be automatically be configured using a configuration structure
+
+
+	// ---------------------------------------
+	// 3.1 Initialize and setup the EHZ System
+
+		 
+		//lint -e429    We store the pointer to Ehz in a vector
+		// Constructor
+		EhzSystem::EhzSystem(const std::vector<EhzConfigDefinition> &vecd)  : 	Subscriber<EhzInternal::Ehz>(), 
+																				Subscriber<EventTimer>(),
+																				Subscriber<EhzInternal::EhzWorkerNotification>(),
+																				Subscriber<ParserInternal::SmlListEntryEvaluation>(),
+																				Publisher<EhzSystem>(),
+																				vecEhzConfigDefinitionNULL(),
+																				publishedMeasuredValues(EhzInternal::getNumberOfEhz()), 
+																				vehzConfigDefinition(vecd), 
+																				vehz(), 
+																				ehzSystemTimer(10000UL), 
+																				ehzDataBase(null<DatabaseInternal::EhzDataBaseWriter *>()),
+																				backupTimer(DatabaseInternal::DatabaseBackupStepPeriodInMs),
+																				ehzHistorian(null<HistorianInternal::EhzHistorian *>()),
+																				snapshotSegmentWriter(null<SnapshotSegmentInternal::SnapshotSegmentWriter *>()),
+																				windowAggregates(),
+																				provisionalMeasuredValues(),
+																				lastUpdatedEhzIndex(null<uint>()),
+																				lastUpdateIsKeyframe(false),
+																				changeDetection(),
+																				versionedMeasuredValues(),
+																				versionedMeasuredValuesAreUsed(false),
+																				renderTimer(EhzInternal::DefaultRenderPeriodInMs),
+																				resultWindowIsDirty(EhzInternal::getNumberOfEhz(), false),
+																				ehzWorkerThreads(),
+																				ehzWorkerNotification()
+		{
+			// Pointer to Ehz. Initialize to 0
+			EhzInternal::Ehz *pehz = null<EhzInternal::Ehz *>();
+
+			// The configuration defines the number of the EHZ's in the system that need to be created now
+			for (uint ehzInstance = 0U; ehzInstance < vehzConfigDefinition.size(); ehzInstance++)
+			{	
+				//This will read the properties for this specific Ehz that we are going to create
+				const EhzConfigDefinition &ecd = vehzConfigDefinition[ehzInstance];
+				
+				// Create a new Ehz
+				 
+				//lint -e774 -e948 --e(1938)
+				pehz = new EhzInternal::Ehz(ecd);
+				
+				// Ehz could be created. Store result in our container
+				vehz.push_back(pehz);
+				// And add a subscriber in the created Ehz for us
+				// Sow the EHZ system will receive information that the EHZ has new data
+				pehz->addSubscription(this);
+				// Some values are wanted before the SML file is complete
+				if (null<u32>() != ecd.EhzEarlyPublication)
+				{
+					pehz->getSmlListEntryEvaluation().addSubscription(this);
+				}
+				// Readers see the (empty) values of the Ehz until it has parsed its first SML File
+				publishedMeasuredValues.publish(pehz->getEhzIndex(), &pehz->getAllMeasuredDataForOneEhz());
+			}
+			createWorkerThreads();
+		
+			//lint -e{1901,1911}
+			// Create a new database, where the Results of all EHZ will be stored
+			// The database has an own thread for writing, so that it will not slow down the event loop
+			ehzDataBase = new DatabaseInternal::EhzDataBaseWriter(DatabaseInternal::EhzDatabaseName);
+			
+			// The historian stores every telegram and not only the values at the timer ticks
+			if (HistorianInternal::EhzHistorianIsActive)
+			{
+				//lint -e{1901,1911}
+				ehzHistorian = new HistorianInternal::EhzHistorian(HistorianInternal::EhzHistorianDirectory);
+			}
+			
+			// Local programs read the latest values from shared memory
+			if (SnapshotSegmentInternal::SnapshotSegmentIsActive)
+			{
+				//lint -e{1901,1911}
+				snapshotSegmentWriter = new SnapshotSegmentInternal::SnapshotSegmentWriter(&SnapshotSegmentInternal::SnapshotSegmentName[0], EhzInternal::getNumberOfEhz());
+			}
+
+			// And, we want ro receive a timerevent all x seconds. Then the data, stored internally in the EHZ System class,
+			// will be stored in the database
+			ehzSystemTimer.addSubscription(this);
+			renderTimer.addSubscription(this);
+			backupTimer.addSubscription(this);
+		}
+		
+		// One thread for every worker number in the configuration. Each thread needs a reactor index
+		// If there are no more indices, the main reactor parses the data of the Ehz
+		void EhzSystem::createWorkerThreads(void)
+		{
+			std::map<uint, EhzInternal::EhzWorkerThread *> ehzWorkerThreadForWorker;
+			for (std::vector<EhzInternal::Ehz *>::iterator ehzIterator = vehz.begin(); ehzIterator != vehz.end(); ++ehzIterator)
+			{
+				const uint worker = (*ehzIterator)->getWorker();
+				if (null<uint>() != worker)
+				{
+					std::map<uint, EhzInternal::EhzWorkerThread *>::iterator workerIterator = ehzWorkerThreadForWorker.find(worker);
+					if (ehzWorkerThreadForWorker.end() == workerIterator)
+					{
+						EhzInternal::EhzWorkerThread *ehzWorkerThread = null<EhzInternal::EhzWorkerThread *>();
+						const uint reactorIndex = ReactorInternal::reserveReactorIndex();
+						if (null<uint>() != reactorIndex)
+						{
+							//lint -e{1901,1911}
+							ehzWorkerThread = new EhzInternal::EhzWorkerThread(reactorIndex);
+							ehzWorkerThreads.push_back(ehzWorkerThread);
+						}
+						else
+						{
+							static LogSite logSite;
+							Log log(logSite);
+							log << "No reactor left for worker " << worker << ". The main reactor parses its Ehz";
+						}
+						workerIterator = ehzWorkerThreadForWorker.insert(std::make_pair(worker, ehzWorkerThread)).first;
+					}
+					if (null<EhzInternal::EhzWorkerThread *>() != workerIterator->second)
+					{
+						workerIterator->second->addEhz(*ehzIterator);
+						(*ehzIterator)->setWorkerNotification(&ehzWorkerNotification);
+					}
+				}
+			}
+			ehzWorkerNotification.addSubscription(this);
+		}
+		 
+
+		
+	// ---------------------
+	// 3.2 Clear EHZ System
+		
+		// Destructor. Delete Ehz and their subscriptions
+		//lint -e{1740,1702,1579}
+		EhzSystem::~EhzSystem(void) 
+		{ 
+		
+			// Try catch because we call external functions and never know if they throw or not
+			try
+			{
+				
+				stop();
+			
+				// Stop cyclic timer for events to store datasets in the database
+				//ehzSystemTimer.stopTimer();
+
+				// We do not want to be notified any longer from the timer
+				ehzSystemTimer.removeSubscription(this);
+				renderTimer.removeSubscription(this);
+				backupTimer.removeSubscription(this);
+				ehzWorkerNotification.removeSubscription(this);
+				
+				// The threads have been stopped. Their Ehz are deleted below
+				for (std::vector<EhzInternal::EhzWorkerThread *>::iterator workerIterator = ehzWorkerThreads.begin(); workerIterator != ehzWorkerThreads.end(); ++workerIterator)
+				{
+					delete *workerIterator;
+				}
+
+				// Close the database
+				delete ehzDataBase;
+				// Close the historian
+				delete ehzHistorian;
+				// Unmap the shared memory. Readers keep the last values
+				delete snapshotSegmentWriter;
+
+				// Get number of Ehz in our Ehz System
+				const uint numberOfElements = vehz.size();
+
+				// For all Ehz in our EhzSystem
+				for (uint i=0U; i<numberOfElements; i++)
+				{
+					// remove subscription from Ehz
+					vehz[i]->removeSubscription(this);
+					vehz[i]->getSmlListEntryEvaluation().removeSubscription(this);
+					// and delete it . . . 
+					delete vehz[i];
+				}
+
+			}
+			catch(...)
+			{
+				// No error handling
+			}
+		}
+
+		
+	// --------------------------------
+	// 3.3 Sanity chaeck for EHZ System
+	
+		// Check if the EhzSystem was initialized and contains plausible data
+		// The "index" from the configuratio data will be check.
+		// It must be in valid boundaries and the indices need to be unique
+		
+		boolean EhzSystem::isInitialized(void) const
+		{
+			// Assume that function returns OK
+			boolean rc = true;
+
+			// Get number of Ehz's in this EHZ System instance
+			// The indices must be between 0..(max-1)
+			const uint numberOfEhz = vehz.size();
+			
+			// Check, if Ehz are existing in our system at all
+			// Of course there must be EHZ in the system. Otherwise nothing will work
+			if (numberOfEhz > 0U)
+			{
+				// OK, at least one Ehz is existing. Check plausible indices
+				
+				// Iterate through existing Ehz and check indices
+				// Indices must be >=0 and <max
+				// Indices must be unique. We will use a c++ set to check this
+				std::set<uint> Indices;
+				// Result of the insert into a set function
+				std::pair<std::set<uint>::iterator,bool> insertResult;
+
+				// Iterate through all existing EHZ in the EHZ system
+				// and only as long as everything is ok and no error has been found
+				for (uint ehzIndex=0U; (ehzIndex <numberOfEhz) && rc; ehzIndex++)
+				{
+					// Read the index of the EHZ under check
+					const uint indexToCheck = vehz[ehzIndex]->getEhzIndex();
+					
+					// Index is uint. Cannot be < 0. Check for max value
+					if (indexToCheck >= numberOfEhz)
+					{
+						// Index number too big --> error
+						rc = false;
+						// Show debug message
+						ui << "Ehz Index wrong" << std::endl;
+					}
+					else
+					{
+						// Check if insert is double. Try to insert the index into a temporary c++ set
+						// This will fail, if index is already in
+						insertResult = Indices.insert(indexToCheck);
+						// Check for error
+						if (!insertResult.second)
+						{
+							// Double index --> error
+							rc = false;
+							// Show debug message
+							ui  << "Ehz Index wrong"  << std::endl;
+						}
+					}
+				}
+			}
+			else
+			{
+				// No Ehz in the system --> Error
+				rc = false;
+				// Show debug message
+				ui << "EhzSystem not initialized"  << std::endl;
+			}
+			return rc;
+		}
+
+	// ------------------------
+	// 3.4 Start the EHZ System
+
+		// Start all Ehz in our EHZ System
+		void EhzSystem::start(void)
+		{
+			// If the system has been initalized and there are Ehz in our EHZ System
+			if (isInitialized())
+			{
+				// Get number of Ehz's in our EHZ System 
+				const uint numberOfEhz = vehz.size();
+				
+				// Iterate through existing Ehz and start them. Worker threads start their Ehz themselves
+				for (uint ehzIndex=0U; ehzIndex <numberOfEhz; ehzIndex++)
+				{
+					if (!vehz[ehzIndex]->isParsedInWorkerThread())
+					{
+						// Start Ehz
+						vehz[ehzIndex]->start();
+					}
+				}
+				// The worker threads wake up the main reactor, if they have values
+				if (!ehzWorkerThreads.empty() && (null<Handle>() != ehzWorkerNotification.getHandle()))
+				{
+					reactorRegisterEventHandler(&ehzWorkerNotification, EventTypeIn);
+					for (uint i = null<uint>(); i < ehzWorkerThreads.size(); ++i)
+					{
+						if (!ehzWorkerThreads[i]->start())
+						{
+							ui << "Could not start worker thread " << (i + 1U) << std::endl;
+						}
+					}
+				}
+				// And start the timer
+				ehzSystemTimer.startTimerPeriodic();
+				backupTimer.startTimerPeriodic();
+				// Without a terminal there is nothing to render
+				if (!UserinterfaceIsHeadless)
+				{
+					renderTimer.startTimerPeriodic();
+				}
+			}
+			else
+			{
+				ui << "EHZ System is not initialized. Could not be started" << std::endl;
+			}
+		}
+		
+		
+	// -----------------------
+	// 3.5 Stop the EHZ System
+	
+		// Stop all EHZ in our Ehz System
+		void EhzSystem::stop(void)
+		{
+			// If the system has been initalized and there are Ehz in our EHZ System
+			if (isInitialized())
+			{
+				// Stop the periodic timer
+				ehzSystemTimer.stopTimer();
+				renderTimer.stopTimer();
+				backupTimer.stopTimer();
+			
+				// The worker threads stop their Ehz and end
+				if (!ehzWorkerThreads.empty() && (null<Handle>() != ehzWorkerNotification.getHandle()))
+				{
+					for (uint i = null<uint>(); i < ehzWorkerThreads.size(); ++i)
+					{
+						ehzWorkerThreads[i]->stop();
+					}
+					reactorUnRegisterEventHandler(&ehzWorkerNotification);
+				}
+			
+				// Get number of Ehz's in our EHZ System 
+				const uint numberOfEhz = vehz.size();
+				// Iterate through existing Ehz and stop them
+				for (uint ehzIndex=0U; ehzIndex <numberOfEhz; ehzIndex++)
+				{
+					if (!vehz[ehzIndex]->isParsedInWorkerThread())
+					{
+						// Stop Ehz
+						vehz[ehzIndex]->stop();
+					}
+				}
+			}
+		}
+			
+	// ---------------------------------
+	// 3.6 Handle EHZ data present event
+			
+		// After one EHZ has parsed data from the serial port data stream
+		// and produced a result, it will call this function
+			
+		// This is the function that should do something with the results of all data
+		// At this moment we simply store print the results
+		void EhzSystem::update(EhzInternal::Ehz *const publisher)
+		{
+			const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Evaluation);
+			// Check, which Ehz in our Ehz System sent the notification
+			const uint ehzIndex = publisher->getEhzIndex();
+			const TraceInternal::TraceSpan traceSpan(TraceInternal::TraceProbe::EhzSystemUpdate, ehzIndex);
+			
+			// Get the resulting values
+			const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz = publisher->getAllMeasuredDataForOneEhz();
+			
+			// Only values that changed beyond their deadband or a keyframe are worth publishing
+			boolean isKeyframe = false;
+			const u32 reportedValues = changeDetection.filter(ehzIndex, allMeasuredValuesForOneEhz, allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated, isKeyframe);
+			const boolean valuesArePublished = (null<u32>() != reportedValues);
+			
+			// The Ehz has swapped its buffers. Store the pointer to the latest values. No copy
+			if (valuesArePublished)
+			{
+				publishedMeasuredValues.publish(ehzIndex, &allMeasuredValuesForOneEhz);
+				// Other threads must not read the buffers of the Ehz. They get a copy
+				if (versionedMeasuredValuesAreUsed)
+				{
+					versionedMeasuredValues.store(publishedMeasuredValues);
+				}
+				// Local readers of the shared memory get the same values as the subscribers
+				if (null<SnapshotSegmentInternal::SnapshotSegmentWriter *>() != snapshotSegmentWriter)
+				{
+					snapshotSegmentWriter->publish(ehzIndex, allMeasuredValuesForOneEhz);
+				}
+			}
+			else
+			{
+				// The old pointer refers to the buffer that the parser fills now. Same generation, so no copies are renewed
+				publishedMeasuredValues.refresh(ehzIndex, &allMeasuredValuesForOneEhz);
+			}
+			// The checksum has been verified. The early published values are confirmed
+			provisionalMeasuredValues.discard(ehzIndex, publisher->getPublishedSmlFileNumber());
+			
+			// Store the new values in the historian. This is a copy into mapped memory
+			if (null<HistorianInternal::EhzHistorian *>() != ehzHistorian)
+			{
+				ehzHistorian->append(ehzIndex, allMeasuredValuesForOneEhz);
+			}
+			// The aggregates need every set of values. Also the ones that are not published
+			windowAggregates.add(ehzIndex, allMeasuredValuesForOneEhz);
+			
+			// Inform subscribers (for example TCP connections that push new values) 
+			if (valuesArePublished)
+			{
+				lastUpdatedEhzIndex = ehzIndex;
+				lastUpdateIsKeyframe = isKeyframe;
+				const AllocationInternal::AllocationScope serverAllocationScope(AllocationInternal::AllocationSubsystem::Server);
+				notifySubscribers();
+			}
+
+			// OBIS discovery (on request or in debug mode). Print all OBIS IDs of the SML file
+			if (null<uint>() != allMeasuredValuesForOneEhz.discoveredObis.numberOfObis)
+			{
+				ui[ehzIndex] << allMeasuredValuesForOneEhz.discoveredObis << "------------" << std::endl;
+			}
+			
+			// The result window will be drawn by the render timer
+			resultWindowIsDirty[ehzIndex] = true;
+			
+			// Accounting of allocations. After the warm up of all Ehz, nothing shall be allocated any more
+			if (AllocationInternal::AllocationAccountingIsActive && !AllocationInternal::isSteadyState())
+			{
+				boolean warmUpIsFinished = true;
+				for (uint i = null<uint>(); i < vehz.size(); ++i)
+				{
+					warmUpIsFinished = warmUpIsFinished && (vehz[i]->getGeneration() >= AllocationInternal::AllocationWarmUpSmlFiles);
+				}
+				if (warmUpIsFinished)
+				{
+					AllocationInternal::beginSteadyState();
+				}
+			}
+		}
+
+
+	// ---------------------------------------------
+	// 3.7 Show the values of one Ehz
+
+		// Called by the render timer for result windows with new values only
+		void EhzSystem::renderMeasuredValues(const uint ehzIndex)
+		{
+			const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz = publishedMeasuredValues[ehzIndex];
+
+			// Show Ehz number and time, when the data had been captured
+			ui(ehzIndex) << SetPos(0,0) << '(' << ehzIndex << "): " << allMeasuredValuesForOneEhz.getTimeWhenDataHasBeenEvaluatedString();
+			
+			// Go through all measured value that are defined for this Ehz
+			const uint numberOfUsedEhzMeasuredData = EhzInternal::EhzSystemConfiguration::getInstance()->getNumberOfUsedEhzMeasuredData(ehzIndex);
+			for (uint i = 0U; i<numberOfUsedEhzMeasuredData; i++)
+			{
+				// What type does this value have
+				const EhzMeasuredDataType::Type emdt = vehzConfigDefinition[ehzIndex].ehzMeasuredDataType[i];
+				// Show status byte
+				const u32 status = (static_cast<u32>(allMeasuredValuesForOneEhz.measuredValueForOneEhz[i].status));	//lint !e921
+				ui(ehzIndex) << "\n(" << status << "): ";				
+			
+				
+				// If there is a value at all, then
+				if (EhzMeasuredDataType::Null != emdt)
+				{
+				
+					// Depending on the result beeing a string or a number
+					switch (emdt)
+					{
+						// If it is a number then print the numerical value
+						case EhzMeasuredDataType::Number:
+							
+							ui(ehzIndex) << allMeasuredValuesForOneEhz.measuredValueForOneEhz[i].getScaledValueAsString();
+							break;
+							
+						// If it is a string, then show that
+						case EhzMeasuredDataType::String:	
+							{
+								// Caveat: String may contain none printable characters
+								std::string smlStringTemp;
+								// In this case it will be converted to ascii coded hex
+								convertSmlByteStringNonePrintableCharacters(allMeasuredValuesForOneEhz.measuredValueForOneEhz[i].smlByteString, smlStringTemp);
+								// And show it
+								ui(ehzIndex) << smlStringTemp;
+							}
+							break;
+						case EhzMeasuredDataType::Null:
+							// Fallthrough
+						default:
+							// Nothing or Error: Don't do a thing
+							break;
+							
+					}
+					
+					
+					// Show the unit for this value
+					ui(ehzIndex) << allMeasuredValuesForOneEhz.measuredValueForOneEhz[i].unit;
+					
+				}
+			}
+			
+			ui(ehzIndex) << std::endl;
+		}
+
+		
+	// -----------------------------------------------------
+	// 3.8 Convert EHZ system data in a readable data stream
+		
+		// Data will be in a frame between STX and ETX
+		// Datasets will be separated by US
+		std::ostream& operator<< (std::ostream &out, const EhzSystem &ehzSystemP)
+		{
+			// Datastream will be in the form: STX version US data1 US data2 US .... dataN US ETX
+			//lint --e{1963,1950,9050}
+			
+			// So first an starting STX and the version of the layout
+			out << charSTX << EhzInternal::TextFormatVersionField << charUS;
+			// Then we will iterate though all measured values of all EHZ and convert them
+			for (uint ehzIndex = null<uint>(); ehzIndex < ehzSystemP.publishedMeasuredValues.size(); ++ehzIndex)
+			{
+				out << ehzSystemP.publishedMeasuredValues[ehzIndex];
+			}
+			// And finalize data stream with ETX
+			out << charETX;
+			return out;
+		}
+
+
+	// ---------------------------------------------
+	// 3.9 Values from the worker threads
+
+		// Every Ehz in a worker thread may have handed over values. Publish them in order
+		// Each publication informs the EhzSystem through the update function above
+		void EhzSystem::update(EhzInternal::EhzWorkerNotification *const)
+		{
+			for (uint ehzIndex = null<uint>(); ehzIndex < vehz.size(); ++ehzIndex)
+			{
+				boolean valuesAreAvailable = vehz[ehzIndex]->isParsedInWorkerThread();
+				while (valuesAreAvailable)
+				{
+					valuesAreAvailable = vehz[ehzIndex]->takeMeasuredValues();
+				}
+			}
+		}
+		
+		// Early publication. Store or discard the provisional values. This may run in a worker thread
+		void EhzSystem::update(ParserInternal::SmlListEntryEvaluation *const publisher)
+		{
+			const uint ehzIndex = publisher->getEhzIndex();
+			const uint valueIndex = publisher->getEarlyValueIndex();
+			// We are in the parsing thread of the Ehz
+			const u64 smlFileNumber = vehz[ehzIndex]->getReceivingSmlFileNumber();
+			if (valueIndex < NumberOfEhzMeasuredData)
+			{
+				provisionalMeasuredValues.set(ehzIndex, smlFileNumber, valueIndex, publisher->getEarlyValue());
+			}
+			else
+			{
+				provisionalMeasuredValues.discard(ehzIndex, smlFileNumber);
+			}
+		}
+
+
+	// ---------------------------------------------
+	// 3.10 Timer Call back. Store data in database or redraw the results
+
+		// Timer Callback
+		void EhzSystem::update(EventTimer *const eventTimer)
+		{
+			if (&renderTimer == eventTimer)
+			{
+				const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Userinterface);
+				// Only windows with new values are drawn. Each refresh goes to the terminal
+				for (uint ehzIndex = null<uint>(); ehzIndex < resultWindowIsDirty.size(); ++ehzIndex)
+				{
+					if (resultWindowIsDirty[ehzIndex])
+					{
+						resultWindowIsDirty[ehzIndex] = false;
+						renderMeasuredValues(ehzIndex);
+					}
+				}
+			}
+			else if (&backupTimer == eventTimer)
+			{
+				const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Database);
+				// The writer thread copies the next pages of a backup, if there is one
+				//lint -e{921}
+				ehzDataBase->requestBackupStep(static_cast<DatabaseInternal::EhzLogTimeUnit>(time(null<time_t*>())));
+			}
+			else
+			{
+				// Hand over a copy to the database writer thread
+				const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Database);
+				//lint -e{534}
+				ehzDataBase->push(publishedMeasuredValues);
+			}
+		}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
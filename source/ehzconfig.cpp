@@ -0,0 +1,355 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// ehzconfig.cpp
+//
+// General Description
+//
+// Runtime configuration of the EHZ system. Reads the definitions of the EHZ from a configuration file
+// The format of the file is described in ehzconfig.hpp
+//
+
+
+
+#include "ehzconfig.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Helper functions
+
+	namespace EhzInternal
+	{
+		// Definitions are sorted by the index of the EHZ
+		inline bool ehzConfigDefinitionIndexLess(const EhzConfigDefinition &left, const EhzConfigDefinition &right)
+		{
+			return left.index < right.index;
+		}
+
+		// Convert an OBIS ID, given as 12 hex digits, into the 6 bytes used by the parser
+		boolean convertObisId(const std::string &hexDigits, std::string &obisId)
+		{
+			boolean rc = (hexDigits.size() == (2U * ObisDataLength));
+			obisId.clear();
+			for (uint i = null<uint>(); rc && (i < ObisDataLength); ++i)
+			{
+				uint byteValue = null<uint>();
+				std::istringstream iss(hexDigits.substr(2U * i, 2U));
+				iss >> std::hex >> byteValue;
+				rc = (!iss.fail() && iss.eof());
+				//lint -e{921}
+				obisId.push_back(static_cast<mchar>(byteValue));
+			}
+			return rc;
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Configuration of the EHZ system
+
+	namespace EhzInternal
+	{
+		// ------------------------------------------------------------------------
+		// 2.1 Constructor. Start with the built-in definition
+
+		EhzSystemConfiguration::EhzSystemConfiguration(void) :	ehzConfigDefinition(),
+																numberOfUsedEhzMeasuredData(),
+																numberValueIds(),
+																numberOfEhz(null<uint>()),
+																maxNumberOfUsedEhzMeasuredData(null<uint>()),
+																configurationTexts()
+		{
+			const uint numberOfBuiltInEhz = sizeof(myEhzConfigDefinition)/sizeof(myEhzConfigDefinition[0]);
+			const std::vector<EhzConfigDefinition> builtInEhzConfigDefinition(&myEhzConfigDefinition[0], &myEhzConfigDefinition[numberOfBuiltInEhz]);
+			assign(builtInEhzConfigDefinition);
+		}
+
+
+		// ------------------------------------------------------------------------
+		// 2.2 Take over definitions and precalculate everything, what is needed later
+
+		void EhzSystemConfiguration::assign(const std::vector<EhzConfigDefinition> &ecd)
+		{
+			ehzConfigDefinition = ecd;
+			std::sort(ehzConfigDefinition.begin(), ehzConfigDefinition.end(), ehzConfigDefinitionIndexLess);
+			numberOfEhz = ehzConfigDefinition.size();
+
+			numberOfUsedEhzMeasuredData.assign(numberOfEhz, null<uint>());
+			numberValueIds.assign(numberOfEhz, std::vector<uint>());
+			maxNumberOfUsedEhzMeasuredData = null<uint>();
+			for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+			{
+				numberOfUsedEhzMeasuredData[ehzIndex] = ehzConfigDefinition[ehzIndex].getNumberOfUsedEhzMeasuredData();
+				maxNumberOfUsedEhzMeasuredData = std::max(maxNumberOfUsedEhzMeasuredData, numberOfUsedEhzMeasuredData[ehzIndex]);
+				for (uint valueId = null<uint>(); valueId < NumberOfEhzMeasuredData; ++valueId)
+				{
+					if (EhzMeasuredDataType::Number == ehzConfigDefinition[ehzIndex].ehzMeasuredDataType[valueId])
+					{
+						numberValueIds[ehzIndex].push_back(valueId);
+					}
+				}
+			}
+		}
+
+
+		// ------------------------------------------------------------------------
+		// 2.3 Read the configuration file
+
+		boolean EhzSystemConfiguration::load(const mchar *const fileName, std::string &errorMessage)
+		{
+			boolean rc = true;
+			std::ifstream configFile(fileName);
+			std::vector<EhzConfigDefinition> newEhzConfigDefinition;
+			std::list<std::string> newConfigurationTexts;
+			// Slots that are already defined for the EHZ in the last "ehz" line
+			std::vector<boolean> slotIsDefined(NumberOfEhzMeasuredData, false);
+
+			if (!configFile.is_open())
+			{
+				errorMessage = std::string("Cannot open configuration file ") + fileName;
+				rc = false;
+			}
+
+			std::string line;
+			uint lineNumber = null<uint>();
+			while (rc && std::getline(configFile, line))
+			{
+				++lineNumber;
+				std::istringstream iss(line);
+				std::string keyword;
+				iss >> keyword;
+
+				if (keyword.empty() || ('#' == keyword[0]))
+				{
+					// Empty line or comment. Ignore
+				}
+				else if ("ehz" == keyword)
+				{
+					uint index = null<uint>();
+					std::string serialPortName;
+					std::string ehzName;
+					iss >> index >> serialPortName;
+					rc = !iss.fail() && !serialPortName.empty();
+					// The name is the rest of the line. Without a name, the EHZ is named after its index
+					if (rc && !std::getline(iss >> std::ws, ehzName))
+					{
+						std::ostringstream defaultName;
+						defaultName << "EHZ " << index;
+						ehzName = defaultName.str();
+					}
+					if (rc)
+					{
+						// Start with an empty definition. All values are Null
+						EhzConfigDefinition ecd = ehzConfigDefinitionNULL;
+						ecd.index = index;
+						newConfigurationTexts.push_back(ehzName);
+						ecd.EhzName = newConfigurationTexts.back().c_str();
+						newConfigurationTexts.push_back(serialPortName);
+						ecd.EhzSerialPortName = newConfigurationTexts.back().c_str();
+						for (uint valueId = null<uint>(); valueId < NumberOfEhzMeasuredData; ++valueId)
+						{
+							ecd.ehzDataValueDefinition[valueId].ObisForDataValue = "";
+							ecd.ehzDataValueDefinition[valueId].NameForDataValue = "";
+							ecd.ehzMeasuredDataType[valueId] = EhzMeasuredDataType::Null;
+							ecd.ehzDeadband[valueId] = 0.0;
+						}
+						newEhzConfigDefinition.push_back(ecd);
+						slotIsDefined.assign(NumberOfEhzMeasuredData, false);
+					}
+				}
+				else if ("value" == keyword)
+				{
+					uint slot = null<uint>();
+					std::string obisHexDigits;
+					std::string typeName;
+					std::string valueName;
+					std::string obisId;
+					iss >> slot >> obisHexDigits >> typeName;
+					std::getline(iss >> std::ws, valueName);
+					rc = !iss.fail() && !newEhzConfigDefinition.empty() && (slot < NumberOfEhzMeasuredData) && !slotIsDefined[slot] &&
+						 convertObisId(obisHexDigits, obisId) && (("number" == typeName) || ("string" == typeName));
+					if (rc)
+					{
+						EhzConfigDefinition &ecd = newEhzConfigDefinition.back();
+						newConfigurationTexts.push_back(obisId);
+						ecd.ehzDataValueDefinition[slot].ObisForDataValue = newConfigurationTexts.back().c_str();
+						newConfigurationTexts.push_back(valueName);
+						ecd.ehzDataValueDefinition[slot].NameForDataValue = newConfigurationTexts.back().c_str();
+						ecd.ehzMeasuredDataType[slot] = ("number" == typeName) ? EhzMeasuredDataType::Number : EhzMeasuredDataType::String;
+						slotIsDefined[slot] = true;
+					}
+				}
+				else if ("capture" == keyword)
+				{
+					std::string captureFileName;
+					iss >> captureFileName;
+					rc = !iss.fail() && !newEhzConfigDefinition.empty();
+					if (rc)
+					{
+						newConfigurationTexts.push_back(captureFileName);
+						newEhzConfigDefinition.back().EhzCaptureFileName = newConfigurationTexts.back().c_str();
+					}
+				}
+				else if ("replay" == keyword)
+				{
+					std::string replayFileName;
+					u32 replaySpeed = 1U;
+					iss >> replayFileName;
+					rc = !iss.fail() && !newEhzConfigDefinition.empty();
+					// The speed is optional
+					if (rc && !(iss >> std::ws).eof())
+					{
+						iss >> replaySpeed;
+						rc = !iss.fail();
+					}
+					if (rc)
+					{
+						newConfigurationTexts.push_back(replayFileName);
+						newEhzConfigDefinition.back().EhzReplayFileName = newConfigurationTexts.back().c_str();
+						newEhzConfigDefinition.back().EhzReplaySpeed = replaySpeed;
+					}
+				}
+				else if ("worker" == keyword)
+				{
+					uint worker = null<uint>();
+					iss >> worker;
+					rc = !iss.fail() && !newEhzConfigDefinition.empty();
+					if (rc)
+					{
+						newEhzConfigDefinition.back().EhzWorker = worker;
+					}
+				}
+				else if ("deadband" == keyword)
+				{
+					uint slot = null<uint>();
+					mdouble deadband = 0.0;
+					iss >> slot >> deadband;
+					rc = !iss.fail() && !newEhzConfigDefinition.empty() && (slot < NumberOfEhzMeasuredData) && (deadband >= 0.0);
+					if (rc)
+					{
+						newEhzConfigDefinition.back().ehzDeadband[slot] = deadband;
+					}
+				}
+				else if ("keyframe" == keyword)
+				{
+					u32 keyframeIntervalInS = null<u32>();
+					iss >> keyframeIntervalInS;
+					rc = !iss.fail() && !newEhzConfigDefinition.empty();
+					if (rc)
+					{
+						newEhzConfigDefinition.back().EhzKeyframeIntervalInS = keyframeIntervalInS;
+					}
+				}
+				else if ("early" == keyword)
+				{
+					uint slot = null<uint>();
+					iss >> slot;
+					rc = !iss.fail() && !newEhzConfigDefinition.empty() && (slot < NumberOfEhzMeasuredData);
+					if (rc)
+					{
+						newEhzConfigDefinition.back().EhzEarlyPublication |= (1UL << slot);
+					}
+				}
+				else if ("skip" == keyword)
+				{
+					rc = !newEhzConfigDefinition.empty();
+					if (rc)
+					{
+						newEhzConfigDefinition.back().EhzSkipMode = true;
+					}
+				}
+				else if ("lowlatency" == keyword)
+				{
+					// The frame gap is optional
+					u32 frameGapInMs = EhzInternal::DefaultFrameGapInMs;
+					rc = !newEhzConfigDefinition.empty();
+					if (rc && !(iss >> std::ws).eof())
+					{
+						iss >> frameGapInMs;
+						rc = !iss.fail() && (null<u32>() != frameGapInMs);
+					}
+					if (rc)
+					{
+						newEhzConfigDefinition.back().EhzFrameGapInMs = frameGapInMs;
+					}
+				}
+				else if ("network" == keyword)
+				{
+					std::string networkHost;
+					std::string networkPort;
+					iss >> networkHost >> networkPort;
+					rc = !iss.fail() && !newEhzConfigDefinition.empty();
+					if (rc)
+					{
+						newConfigurationTexts.push_back(networkHost);
+						newEhzConfigDefinition.back().EhzNetworkHost = newConfigurationTexts.back().c_str();
+						newConfigurationTexts.push_back(networkPort);
+						newEhzConfigDefinition.back().EhzNetworkPort = newConfigurationTexts.back().c_str();
+					}
+				}
+				else
+				{
+					rc = false;
+				}
+
+				if (!rc)
+				{
+					std::ostringstream oss;
+					oss << "Error in configuration file " << fileName << " line " << lineNumber << ": " << line;
+					errorMessage = oss.str();
+				}
+			}
+
+			// Check the indices of the EHZ. They must be 0..(Number of EHZ-1) and unique
+			if (rc)
+			{
+				const uint numberOfNewEhz = newEhzConfigDefinition.size();
+				std::vector<boolean> indexIsUsed(numberOfNewEhz, false);
+				for (uint i = null<uint>(); rc && (i < numberOfNewEhz); ++i)
+				{
+					const uint index = newEhzConfigDefinition[i].index;
+					rc = (index < numberOfNewEhz) && !indexIsUsed[index];
+					if (rc)
+					{
+						indexIsUsed[index] = true;
+					}
+				}
+				rc = rc && (numberOfNewEhz > null<uint>());
+				if (!rc)
+				{
+					errorMessage = std::string("Wrong EHZ indices in configuration file ") + fileName;
+				}
+			}
+
+			// Everything OK. Take over the new definitions
+			if (rc)
+			{
+				assign(newEhzConfigDefinition);
+				configurationTexts.swap(newConfigurationTexts);
+			}
+			return rc;
+		}
+	}
@@ -1,192 +1,976 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-// ehzmeasureddata.cpp
-//
-// General Description
-//
-// This module is a part of an application tor read the data from Electronic Meters for Electric Power
-//
-// In Germany they are called EHZ. Hence the name of the module
-//
-// The EHZ transmits data via an infrared interface. The protocoll is described in:
-//
-//  http://www.emsycon.de/downloads/SML_081112_103.pdf
-//
-// The EHZ System consists of one or more EHZ
-//
-// The software parses the datastream from an EHZ and provides resulting values as defined
-// in the following data structures.
-// The EHZ may transport several values of different types. In the configuration file
-// the needed values are selected.
-//
-// Definition of functions necessary tp process EHZ measured values in data structures
-//
-
-
-
-#include "ehzmeasureddata.hpp"
-#include "bytestring.hpp"
-#include "userinterface.hpp"
-
-#include <cstdlib>
-#include <sstream>
-
-//
-// For data streams we us the format: STX data1 US data2 US ... dataN US ETX
-//
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 1. Setters and output functions for one EHZ
-
-
-	namespace EhzInternal
-	{
-	
-		// 1.0 Assignment operator
-		// Default behaviour
-		OneMeasuredValueForOneEhz &OneMeasuredValueForOneEhz::operator =(const OneMeasuredValueForOneEhz &assignFromOneMeasuredValueForOneEhz)
-		{
-			if (this != &assignFromOneMeasuredValueForOneEhz)
-			{
-
-				
-				doubleValue = assignFromOneMeasuredValueForOneEhz.doubleValue;
-				smlByteString = assignFromOneMeasuredValueForOneEhz.smlByteString;
-				unit = assignFromOneMeasuredValueForOneEhz.unit;
-				status = assignFromOneMeasuredValueForOneEhz.status;
-			}
-			return *this;
-		}
-
-
-		// 1.1 Convert a vector of strings received via a data stream to internal structures
-		
-		void OneMeasuredValueForOneEhz::setValuesFromStrings(std::vector<std::string>::iterator &iter)
-		{
-			// Copy data and advance the iterator
-			//lint -e{586}
-	
-			doubleValue = std::atof((*iter).c_str());++iter;
-			smlByteString = *iter;++iter;
-			unit = *iter;++iter;
-			//lint -e{586,732,919,915,1960}
-			status = atol((*iter).c_str());++iter;
-		}
-
-		// 1.2 Push data into output stream
-		//lint -e{1929,957}
-		std::ostream& operator<< (std::ostream &out, const OneMeasuredValueForOneEhz &oneMeasuredValueForOneEhz)
-		{
-			// Output internal data into a data stream
-			//lint -e{1963,9050,1929}
-			out << 	
-					oneMeasuredValueForOneEhz.doubleValue << charUS << 
-					oneMeasuredValueForOneEhz.smlByteString << charUS << 
-					oneMeasuredValueForOneEhz.unit << charUS << 
-					oneMeasuredValueForOneEhz.status << charUS;
-			return out;
-		}
-
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 2. Setters and output functions for an array measured values for one EHZ
-
-
-		// 2.1 Convert a vector of strings received via a data stream to internal structurs
-		void AllMeasuredValuesForOneEhz::setValuesFromStrings(std::vector<std::string>::iterator &iter)
-		{
-			for (uint i = null<uint>(); i<NumberOfEhzMeasuredData; ++i)
-			{
-				measuredValueForOneEhz[i].setValuesFromStrings(iter);
-			}
-			//lint -e{586}
-			timeWhenDataHasBeenEvaluated = atol((*iter).c_str());++iter;
-			timeWhenDataHasBeenEvaluatedString = *iter;++iter;
-		}
-
-		// 2.2 Helper function. Get current time as string and tm struct
-		void AllMeasuredValuesForOneEhz::storeNowTime(void) 
-		{	
-			// Use global function to get the time of now
-			timeWhenDataHasBeenEvaluated = getNowTime(timeWhenDataHasBeenEvaluatedString);
-		}
-		
-		// 2.3 Push data into output stream
-		//lint -e{1929}
-		std::ostream& operator<< (std::ostream &out, const AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz)
-		{
-			// Output internal data into a data stream
-			// For all measured data of one EHZ
-			for (uint i = null<uint>(); i<NumberOfEhzMeasuredData; ++i)
-			{
-				//lint -e{1963,9050}
-				out << allMeasuredValuesForOneEhz.measuredValueForOneEhz[i];
-			}
-			//lint -e{1963,9050}
-			// And append the time as tm struct and as string
-			out << allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated << charUS << allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluatedString << charUS;
-			return out;
-		}
-		
-
-		// 2.4 Clear all values
-	
-		void AllMeasuredValuesForOneEhz::clear(void)
-		{
-			for (uint i = 0U; i< NumberOfEhzMeasuredData; ++i)
-			{
-				measuredValueForOneEhz[i].clear();
-			}
-			timeWhenDataHasBeenEvaluatedString.clear();
-			timeWhenDataHasBeenEvaluated = null<time_t>();
-			obisValues.clear();
-		}
-
-
-		// 2.5 Assignment operator
-		// Default behaviour
-		//lint -e{1539}  Warning 1539: member 'EhzInternal::AllMeasuredValuesForOneEhz::obisValues' (line 116, file p:\project\ehz\include\ehzmeasureddata.hpp
-		AllMeasuredValuesForOneEhz &AllMeasuredValuesForOneEhz::operator = (const AllMeasuredValuesForOneEhz &assignFromAllMeasuredValuesForOneEhz)
-		{
-		
-			
-			if (this != &assignFromAllMeasuredValuesForOneEhz)
-			{
-				for (uint i = 0U; i< NumberOfEhzMeasuredData; ++i)
-				{
-					measuredValueForOneEhz[i] = assignFromAllMeasuredValuesForOneEhz.measuredValueForOneEhz[i];
-				}
-				timeWhenDataHasBeenEvaluatedString = assignFromAllMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluatedString;
-				timeWhenDataHasBeenEvaluated = assignFromAllMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated;
-				
-			}
-			return *this;
-		}	
-	
-	}
-	
-	
-// ------------------------------------------------------------------------------------------------------------------------------
-// 3. Dummy for default constructors
-	//lint -e{1935,1937}
-	EhzInternal::AllMeasuredValuesForOneEhz emdaDummy;
-
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+// ehzmeasureddata.cpp
+//
+// General Description
+//
+// This module is a part of an application tor read the data from Electronic Meters for Electric Power
+//
+// In Germany they are called EHZ. Hence the name of the module
+//
+// The EHZ transmits data via an infrared interface. The protocoll is described in:
+//
+//  http://www.emsycon.de/downloads/SML_081112_103.pdf
+//
+// The EHZ System consists of one or more EHZ
+//
+// The software parses the datastream from an EHZ and provides resulting values as defined
+// in the following data structures.
+// The EHZ may transport several values of different types. In the configuration file
+// the needed values are selected.
+//
+// Definition of functions necessary tp process EHZ measured values in data structures
+//
+
+
+
+#include "ehzmeasureddata.hpp"
+#include "bytestring.hpp"
+#include "userinterface.hpp"
+#include "obisunit.hpp"
+#include "ehzconfig.hpp"
+#include "clock.hpp"
+
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+//
+// For data streams we us the format: STX data1 US data2 US ... dataN US ETX
+//
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Setters and output functions for one EHZ
+
+
+	namespace EhzInternal
+	{
+	
+		// 1.0 Assignment operator
+		// Default behaviour
+		OneMeasuredValueForOneEhz &OneMeasuredValueForOneEhz::operator =(const OneMeasuredValueForOneEhz &assignFromOneMeasuredValueForOneEhz)
+		{
+			if (this != &assignFromOneMeasuredValueForOneEhz)
+			{
+
+				
+				doubleValue = assignFromOneMeasuredValueForOneEhz.doubleValue;
+				mantissa = assignFromOneMeasuredValueForOneEhz.mantissa;
+				scaler = assignFromOneMeasuredValueForOneEhz.scaler;
+				smlByteString = assignFromOneMeasuredValueForOneEhz.smlByteString;
+				unit = assignFromOneMeasuredValueForOneEhz.unit;
+				unitIndex = assignFromOneMeasuredValueForOneEhz.unitIndex;
+				status = assignFromOneMeasuredValueForOneEhz.status;
+			}
+			return *this;
+		}
+
+
+		// 1.1 Convert a vector of strings received via a data stream to internal structures
+		
+		void OneMeasuredValueForOneEhz::setValuesFromStrings(std::vector<std::string>::iterator &iter)
+		{
+			// Copy data and advance the iterator
+			//lint -e{586}
+	
+			doubleValue = std::atof((*iter).c_str());++iter;
+			// Mantissa and scaler. 64 bit integer, so use a string stream
+			{
+				std::istringstream iss(*iter);
+				mantissa = null<s64>();
+				iss >> mantissa;
+				++iter;
+			}
+			//lint -e{586}
+			scaler = static_cast<s8>(std::atoi((*iter).c_str()));++iter;
+			smlByteString = *iter;++iter;
+			unit = *iter;++iter;
+			//lint -e{586,732,919,915,1960}
+			status = atol((*iter).c_str());++iter;
+		}
+
+		// Version 1 has no mantissa and scaler. The double value was written with the default precision of a stream
+		void OneMeasuredValueForOneEhz::setValuesFromVersion1Strings(std::vector<std::string>::iterator &iter)
+		{
+			convertStringToScaledValue(*iter, mantissa, scaler);
+			//lint -e{586}
+			doubleValue = std::atof((*iter).c_str());++iter;
+			smlByteString = *iter;++iter;
+			unit = *iter;++iter;
+			//lint -e{586,732,919,915,1960}
+			status = atol((*iter).c_str());++iter;
+		}
+
+		// 1.2 Push data into output stream
+		//lint -e{1929,957}
+		std::ostream& operator<< (std::ostream &out, const OneMeasuredValueForOneEhz &oneMeasuredValueForOneEhz)
+		{
+			// Output internal data into a data stream
+			//lint -e{1963,9050,1929}
+			out << 	
+					oneMeasuredValueForOneEhz.doubleValue << charUS << 
+					oneMeasuredValueForOneEhz.mantissa << charUS << 
+					static_cast<sint>(oneMeasuredValueForOneEhz.scaler) << charUS << 
+					oneMeasuredValueForOneEhz.smlByteString << charUS << 
+					oneMeasuredValueForOneEhz.unit << charUS << 
+					oneMeasuredValueForOneEhz.status << charUS;
+			return out;
+		}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Setters and output functions for an array measured values for one EHZ
+
+
+		// 2.1 Convert a vector of strings received via a data stream to internal structurs
+		void AllMeasuredValuesForOneEhz::setValuesFromStrings(std::vector<std::string>::iterator &iter)
+		{
+			for (uint i = null<uint>(); i<NumberOfEhzMeasuredData; ++i)
+			{
+				measuredValueForOneEhz[i].setValuesFromStrings(iter);
+			}
+			//lint -e{586}
+			timeWhenDataHasBeenEvaluated = atol((*iter).c_str());++iter;
+			// The time as string is formatted again from the time_t, if needed
+			++iter;
+		}
+
+		// Version 1 of the data stream had less values per EHZ
+		void AllMeasuredValuesForOneEhz::setValuesFromVersion1Strings(std::vector<std::string>::iterator &iter, const uint numberOfValues)
+		{
+			for (uint i = null<uint>(); (i < NumberOfEhzMeasuredData) || (i < numberOfValues); ++i)
+			{
+				if (i >= numberOfValues)
+				{
+					measuredValueForOneEhz[i].clear();
+				}
+				else if (i < NumberOfEhzMeasuredData)
+				{
+					measuredValueForOneEhz[i].setValuesFromVersion1Strings(iter);
+				}
+				else
+				{
+					// More values than we can store. Skip them
+					iter += static_cast<std::vector<std::string>::difference_type>(NumberOfStringsPerValueVersion1);
+				}
+			}
+			//lint -e{586}
+			timeWhenDataHasBeenEvaluated = atol((*iter).c_str());++iter;
+			++iter;
+		}
+
+		// 2.2 Helper function. Get current time. One time stamp for the whole SML file
+		void AllMeasuredValuesForOneEhz::storeNowTime(void) 
+		{	
+			timeWhenDataHasBeenEvaluated = ClockInternal::getCoarseRealTime();
+		}
+
+		const mchar *AllMeasuredValuesForOneEhz::getTimeWhenDataHasBeenEvaluatedString(void) const
+		{
+			return (null<time_t>() == timeWhenDataHasBeenEvaluated) ? "" : ClockInternal::formatTime(timeWhenDataHasBeenEvaluated);
+		}
+		
+		// 2.3 Push data into output stream
+		//lint -e{1929}
+		std::ostream& operator<< (std::ostream &out, const AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz)
+		{
+			// Output internal data into a data stream
+			// For all measured data of one EHZ
+			for (uint i = null<uint>(); i<NumberOfEhzMeasuredData; ++i)
+			{
+				//lint -e{1963,9050}
+				out << allMeasuredValuesForOneEhz.measuredValueForOneEhz[i];
+			}
+			//lint -e{1963,9050}
+			// And append the time as tm struct and as string
+			out << allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated << charUS << allMeasuredValuesForOneEhz.getTimeWhenDataHasBeenEvaluatedString() << charUS;
+			return out;
+		}
+		
+
+		// 2.4 Clear all values
+	
+		void AllMeasuredValuesForOneEhz::clear(void)
+		{
+			for (uint i = 0U; i< NumberOfEhzMeasuredData; ++i)
+			{
+				measuredValueForOneEhz[i].clear();
+			}
+			timeWhenDataHasBeenEvaluated = null<time_t>();
+			discoveredObis.clear();
+		}
+
+
+		// 2.5 Assignment operator
+		// Default behaviour
+		//lint -e{1539}  Warning 1539: member 'EhzInternal::AllMeasuredValuesForOneEhz::discoveredObis' (line 116, file p:\project\ehz\include\ehzmeasureddata.hpp
+		AllMeasuredValuesForOneEhz &AllMeasuredValuesForOneEhz::operator = (const AllMeasuredValuesForOneEhz &assignFromAllMeasuredValuesForOneEhz)
+		{
+		
+			
+			if (this != &assignFromAllMeasuredValuesForOneEhz)
+			{
+				for (uint i = 0U; i< NumberOfEhzMeasuredData; ++i)
+				{
+					measuredValueForOneEhz[i] = assignFromAllMeasuredValuesForOneEhz.measuredValueForOneEhz[i];
+				}
+				timeWhenDataHasBeenEvaluated = assignFromAllMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated;
+				
+			}
+			return *this;
+		}	
+
+
+		// 2.6 OBIS discovery
+		// Only few OBIS IDs per SML file. A linear search is sufficient
+		void DiscoveredObis::add(const u64 obisKey)
+		{
+			uint i = null<uint>();
+			while ((i < numberOfObis) && (obis[i] != obisKey))
+			{
+				++i;
+			}
+			if ((i == numberOfObis) && (numberOfObis < MaxNumberOfDiscoveredObis))
+			{
+				obis[numberOfObis] = obisKey;
+				++numberOfObis;
+			}
+		}
+
+		// Same format as convertSmlByteStringToHex
+		//lint -e{1929}
+		std::ostream& operator<< (std::ostream &out, const DiscoveredObis &discoveredObis)
+		{
+			const mchar hexDigit[] = "0123456789ABCDEF";
+			for (uint i = null<uint>(); i < discoveredObis.numberOfObis; ++i)
+			{
+				for (uint byteIndex = null<uint>(); byteIndex < 6U; ++byteIndex)
+				{
+					const uint databyte = static_cast<uint>((discoveredObis.obis[i] >> (8U * (5U - byteIndex))) & 0xFFULL);
+					out << hexDigit[databyte >> 4U] << hexDigit[databyte & 0x0FU] << ' ';
+				}
+				out << '\n';
+			}
+			return out;
+		}
+	}
+	
+	
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Dummy for default constructors
+	//lint -e{1935,1937}
+	EhzInternal::AllMeasuredValuesForOneEhz emdaDummy;
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. Conversion of decimal fixed point values
+
+	namespace EhzInternal
+	{
+		// 4.0 Powers of ten up to 10^22 can be represented exactly as double
+		const uint NumberOfExactPowersOfTen = 23U;
+		const mdouble exactPowersOfTen[NumberOfExactPowersOfTen] =
+		{
+			1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		// 4.1 Calculate mantissa * 10^scaler
+		mdouble convertScaledValueToDouble(const s64 mantissa, const s8 scaler)
+		{
+			mdouble rc;
+			const mdouble mantissaAsDouble = static_cast<mdouble>(mantissa);
+			const uint absoluteScaler = (scaler < null<s8>()) ? static_cast<uint>(-static_cast<sint>(scaler)) : static_cast<uint>(scaler);
+			
+			if (absoluteScaler < NumberOfExactPowersOfTen)
+			{
+				// For negative scalers we divide. Dividing by an exact power of ten is correctly rounded. Multiplying by 0.1 is not
+				rc = (scaler < null<s8>()) ? (mantissaAsDouble / exactPowersOfTen[absoluteScaler]) : (mantissaAsDouble * exactPowersOfTen[absoluteScaler]);
+			}
+			else
+			{
+				// Will never be seen in real life
+				rc = mantissaAsDouble * pow(10.0, static_cast<mdouble>(scaler));
+			}
+			return rc;
+		}
+		
+		// 4.2 Build the exact decimal representation of mantissa * 10^scaler
+		std::string convertScaledValueToString(const s64 mantissa, const s8 scaler)
+		{
+			std::ostringstream oss;
+			if (null<s64>() == mantissa)
+			{
+				oss << '0';
+			}
+			else if (scaler >= null<s8>())
+			{
+				// Integer value. Append the zeros
+				oss << mantissa << std::string(static_cast<size_t>(scaler), '0');
+			}
+			else
+			{
+				// Get the digits of the absolute value. Works also for the smallest s64
+				const u64 absoluteMantissa = (mantissa < null<s64>()) ? (null<u64>() - static_cast<u64>(mantissa)) : static_cast<u64>(mantissa);
+				std::ostringstream digitsStream;
+				digitsStream << absoluteMantissa;
+				std::string digits = digitsStream.str();
+				
+				// Pad with leading zeros, so that there is at least one digit before the decimal point
+				const size_t numberOfDecimals = static_cast<size_t>(-static_cast<sint>(scaler));
+				if (digits.length() <= numberOfDecimals)
+				{
+					digits.insert(null<size_t>(), (numberOfDecimals - digits.length()) + 1U, '0');
+				}
+				digits.insert(digits.length() - numberOfDecimals, 1U, '.');
+				
+				if (mantissa < null<s64>())
+				{
+					oss << '-';
+				}
+				oss << digits;
+			}
+			return oss.str();
+		}
+		
+		// 4.3 Get mantissa and scaler from a decimal string
+		// Used for version 1 of the data stream, where only the double value was transferred
+		// Anything that is not a number gives 0
+		void convertStringToScaledValue(const std::string &decimalString, s64 &mantissa, s8 &scaler)
+		{
+			// More digits would not fit into the mantissa. They are only counted for the scaler
+			const uint MaxNumberOfMantissaDigits = 18U;
+			uint numberOfMantissaDigits = null<uint>();
+			sint exponent = null<sint>();
+			boolean isNegative = false;
+			boolean afterDecimalPoint = false;
+			s64 absoluteMantissa = null<s64>();
+			std::string::size_type i = null<std::string::size_type>();
+			
+			if ((i < decimalString.length()) && (('-' == decimalString[i]) || ('+' == decimalString[i])))
+			{
+				isNegative = ('-' == decimalString[i]);
+				++i;
+			}
+			for (; (i < decimalString.length()) && (('.' == decimalString[i]) || ((decimalString[i] >= '0') && (decimalString[i] <= '9'))); ++i)
+			{
+				if ('.' == decimalString[i])
+				{
+					afterDecimalPoint = true;
+				}
+				else if (numberOfMantissaDigits < MaxNumberOfMantissaDigits)
+				{
+					absoluteMantissa = (absoluteMantissa * 10) + static_cast<s64>(decimalString[i] - '0');
+					// Leading zeros do not count
+					if (null<s64>() != absoluteMantissa)
+					{
+						++numberOfMantissaDigits;
+					}
+					if (afterDecimalPoint)
+					{
+						--exponent;
+					}
+				}
+				else if (!afterDecimalPoint)
+				{
+					++exponent;
+				}
+				else
+				{
+					// Digit after the decimal point, that does not fit. Dropped
+				}
+			}
+			// Exponent like in 1.23457e+07
+			if ((i < decimalString.length()) && (('e' == decimalString[i]) || ('E' == decimalString[i])))
+			{
+				//lint -e{586}
+				exponent += std::atoi(decimalString.c_str() + i + 1U);
+			}
+			
+			if ((null<s64>() == absoluteMantissa) || (exponent < -128) || (exponent > 127))
+			{
+				mantissa = null<s64>();
+				scaler = null<s8>();
+			}
+			else
+			{
+				mantissa = isNegative ? -absoluteMantissa : absoluteMantissa;
+				scaler = static_cast<s8>(exponent);
+			}
+		}
+	}
+
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 5. Compact snapshot of the measured values of all EHZ
+
+	namespace EhzInternal
+	{
+		// 5.1 Constructor. All values are 0
+		MeasuredValuesSnapshot::MeasuredValuesSnapshot(const uint numberOfEhz) : compactMeasuredValues(numberOfEhz), textValues(), numberOfTextValues(null<uint>())
+		{
+		}
+		
+		// 5.2 Take over the values of all EHZ
+		// The values may come from a vector or from the published values. Both have operator[] and size()
+		template <class AllEhz>
+		void assignMeasuredValuesToSnapshot(const AllEhz &allMeasuredValuesForAllEhz, std::vector<CompactMeasuredValuesForOneEhz> &compactMeasuredValues, 
+											std::vector<CompactTextValue> &textValues, uint &numberOfTextValues)
+		{
+			compactMeasuredValues.resize(allMeasuredValuesForAllEhz.size());
+			numberOfTextValues = null<uint>();
+			for (uint ehzIndex = null<uint>(); ehzIndex < allMeasuredValuesForAllEhz.size(); ++ehzIndex)
+			{
+				const AllMeasuredValuesForOneEhz &amvfoe = allMeasuredValuesForAllEhz[ehzIndex];
+				CompactMeasuredValuesForOneEhz &cmvfoe = compactMeasuredValues[ehzIndex];
+				cmvfoe.timeWhenDataHasBeenEvaluated = amvfoe.timeWhenDataHasBeenEvaluated;
+				for (uint i = null<uint>(); i < NumberOfEhzMeasuredData; ++i)
+				{
+					const OneMeasuredValueForOneEhz &omv = amvfoe.measuredValueForOneEhz[i];
+					cmvfoe.doubleValue[i] = omv.doubleValue;
+					cmvfoe.mantissa[i] = omv.mantissa;
+					cmvfoe.status[i] = omv.status;
+					cmvfoe.scaler[i] = omv.scaler;
+					cmvfoe.unitIndex[i] = omv.unitIndex;
+					if (!omv.smlByteString.empty())
+					{
+						// Reuse the elements and their string buffers
+						if (numberOfTextValues >= textValues.size())
+						{
+							textValues.push_back(CompactTextValue());
+						}
+						CompactTextValue &ctv = textValues[numberOfTextValues];
+						ctv.ehzIndex = static_cast<u16>(ehzIndex);
+						ctv.valueIndex = static_cast<u16>(i);
+						ctv.text = omv.smlByteString;
+						++numberOfTextValues;
+					}
+				}
+			}
+		}
+		
+		void MeasuredValuesSnapshot::assign(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz)
+		{
+			assignMeasuredValuesToSnapshot(allMeasuredValuesForAllEhz, compactMeasuredValues, textValues, numberOfTextValues);
+		}
+		
+		void MeasuredValuesSnapshot::assign(const PublishedMeasuredValues &publishedMeasuredValues)
+		{
+			assignMeasuredValuesToSnapshot(publishedMeasuredValues, compactMeasuredValues, textValues, numberOfTextValues);
+		}
+		
+		// 5.3 Write the values back into the structures with strings
+		void MeasuredValuesSnapshot::extract(AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz) const
+		{
+			const uint numberOfEhz = (allMeasuredValuesForAllEhz.size() < compactMeasuredValues.size()) ? allMeasuredValuesForAllEhz.size() : compactMeasuredValues.size();
+			for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+			{
+				AllMeasuredValuesForOneEhz &amvfoe = allMeasuredValuesForAllEhz[ehzIndex];
+				const CompactMeasuredValuesForOneEhz &cmvfoe = compactMeasuredValues[ehzIndex];
+				amvfoe.timeWhenDataHasBeenEvaluated = cmvfoe.timeWhenDataHasBeenEvaluated;
+				for (uint i = null<uint>(); i < NumberOfEhzMeasuredData; ++i)
+				{
+					OneMeasuredValueForOneEhz &omv = amvfoe.measuredValueForOneEhz[i];
+					omv.doubleValue = cmvfoe.doubleValue[i];
+					omv.mantissa = cmvfoe.mantissa[i];
+					omv.status = cmvfoe.status[i];
+					omv.scaler = cmvfoe.scaler[i];
+					omv.unitIndex = cmvfoe.unitIndex[i];
+					omv.unit = ObisUnitLookup[cmvfoe.unitIndex[i]].unit;
+					omv.smlByteString.clear();
+				}
+			}
+			for (uint t = null<uint>(); t < numberOfTextValues; ++t)
+			{
+				const CompactTextValue &ctv = textValues[t];
+				if (ctv.ehzIndex < numberOfEhz)
+				{
+					allMeasuredValuesForAllEhz[ctv.ehzIndex].measuredValueForOneEhz[ctv.valueIndex].smlByteString = ctv.text;
+				}
+			}
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 6. Published measured values of all EHZ
+
+	namespace EhzInternal
+	{
+		// 6.1 Constructor. Nothing published yet
+		PublishedMeasuredValues::PublishedMeasuredValues(const uint numberOfEhz) : measuredValues(numberOfEhz, &emdaDummy), generation(null<u64>())
+		{
+		}
+		
+		// 6.2 An EHZ swapped its buffers. From now on, readers get the new values
+		void PublishedMeasuredValues::publish(const uint ehzIndex, const AllMeasuredValuesForOneEhz *const allMeasuredValuesForOneEhz)
+		{
+			measuredValues[ehzIndex] = allMeasuredValuesForOneEhz;
+			//lint -e{534}
+			__atomic_add_fetch(&generation, 1ULL, __ATOMIC_RELEASE);
+		}
+		
+		// 6.3 Point to the elements of a copy
+		void PublishedMeasuredValues::assign(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz, const u64 generationOfValues)
+		{
+			measuredValues.resize(allMeasuredValuesForAllEhz.size());
+			for (uint ehzIndex = null<uint>(); ehzIndex < allMeasuredValuesForAllEhz.size(); ++ehzIndex)
+			{
+				measuredValues[ehzIndex] = &allMeasuredValuesForAllEhz[ehzIndex];
+			}
+			__atomic_store_n(&generation, generationOfValues, __ATOMIC_RELEASE);
+		}
+		
+		
+		// 6.4 Versions of the published values for other threads. Buffer 0 is the current one with empty values
+		VersionedMeasuredValues::VersionedMeasuredValues(void) : currentBuffer(null<uint>()), generation(null<u64>())
+		{
+			for (uint i = null<uint>(); i < NumberOfVersionBuffers; ++i)
+			{
+				generationOfBuffer[i] = null<u64>();
+				numberOfReaders[i] = null<uint>();
+			}
+		}
+		
+		// 6.5 Deep copy of the published values. Called in the thread of the EHZ after a publication
+		// The pin of a reader and the check of the owner, if a buffer is pinned, are sequentially consistent.
+		// So either the owner sees the pin or the reader sees, that its buffer is no longer the current one
+		void VersionedMeasuredValues::store(const PublishedMeasuredValues &publishedMeasuredValues)
+		{
+			uint freeBuffer = null<uint>();
+			boolean freeBufferFound = false;
+			for (uint i = null<uint>(); !freeBufferFound && (i < NumberOfVersionBuffers); ++i)
+			{
+				freeBuffer = i;
+				freeBufferFound = (i != currentBuffer) && (null<uint>() == __atomic_load_n(&numberOfReaders[i], __ATOMIC_SEQ_CST));
+			}
+			// There is always a free buffer, as long as not more than MaxNumberOfVersionReaders threads read
+			if (freeBufferFound)
+			{
+				AllMeasuredValuesForAllEhz &nextVersion = measuredValues[freeBuffer];
+				nextVersion.resize(publishedMeasuredValues.size());
+				for (uint ehzIndex = null<uint>(); ehzIndex < publishedMeasuredValues.size(); ++ehzIndex)
+				{
+					nextVersion[ehzIndex] = publishedMeasuredValues[ehzIndex];
+				}
+				generationOfBuffer[freeBuffer] = publishedMeasuredValues.getGeneration();
+				__atomic_store_n(&currentBuffer, freeBuffer, __ATOMIC_SEQ_CST);
+				__atomic_store_n(&generation, generationOfBuffer[freeBuffer], __ATOMIC_RELEASE);
+			}
+		}
+		
+		// 6.6 Copy for a reader. Mostly there is nothing new
+		boolean VersionedMeasuredValues::load(AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz, u64 &generationOfValues) const
+		{
+			boolean rc = false;
+			if (__atomic_load_n(&generation, __ATOMIC_ACQUIRE) != generationOfValues)
+			{
+				// Pin the current buffer. If the owner made another one current in the meantime, try again
+				uint buffer = __atomic_load_n(&currentBuffer, __ATOMIC_SEQ_CST);
+				//lint -e{534}
+				__atomic_add_fetch(&numberOfReaders[buffer], 1U, __ATOMIC_SEQ_CST);
+				while (buffer != __atomic_load_n(&currentBuffer, __ATOMIC_SEQ_CST))
+				{
+					//lint -e{534}
+					__atomic_sub_fetch(&numberOfReaders[buffer], 1U, __ATOMIC_SEQ_CST);
+					buffer = __atomic_load_n(&currentBuffer, __ATOMIC_SEQ_CST);
+					//lint -e{534}
+					__atomic_add_fetch(&numberOfReaders[buffer], 1U, __ATOMIC_SEQ_CST);
+				}
+				allMeasuredValuesForAllEhz = measuredValues[buffer];
+				generationOfValues = generationOfBuffer[buffer];
+				//lint -e{534}
+				__atomic_sub_fetch(&numberOfReaders[buffer], 1U, __ATOMIC_RELEASE);
+				rc = true;
+			}
+			return rc;
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 7. Binary wire format for the values of all EHZ
+
+	namespace EhzInternal
+	{
+		// 7.1 Helper functions. Little endian with fixed width
+		inline void appendBinaryUnsigned(std::string &out, const u64 value, const uint numberOfBytes)
+		{
+			for (uint i = null<uint>(); i < numberOfBytes; ++i)
+			{
+				//lint -e{921}
+				out.push_back(static_cast<mchar>((value >> (8U * i)) & 0xFFULL));
+			}
+		}
+		
+		inline void appendBinaryString(std::string &out, const std::string &text)
+		{
+			// Longer strings are cut. SML strings are much shorter anyway
+			const uint length = (text.size() < 0xFFFFU) ? text.size() : 0xFFFFU;
+			appendBinaryUnsigned(out, length, 2U);
+			out.append(text, 0U, length);
+		}
+		
+		// The same for C strings. No temporary std::string
+		inline void appendBinaryString(std::string &out, const mchar *const text)
+		{
+			const size_t textLength = strlen(text);
+			const uint length = (textLength < 0xFFFFU) ? textLength : 0xFFFFU;
+			appendBinaryUnsigned(out, length, 2U);
+			out.append(text, length);
+		}
+		
+		// Reading advances the position. If there are not enough bytes, the result is false and nothing is read
+		inline boolean readBinaryUnsigned(const std::string &in, uint &position, u64 &value, const uint numberOfBytes)
+		{
+			const boolean rc = ((position + numberOfBytes) <= in.size());
+			value = null<u64>();
+			if (rc)
+			{
+				for (uint i = null<uint>(); i < numberOfBytes; ++i)
+				{
+					//lint -e{921}
+					value |= static_cast<u64>(static_cast<u8>(in[position + i])) << (8U * i);
+				}
+				position += numberOfBytes;
+			}
+			return rc;
+		}
+		
+		inline boolean readBinaryString(const std::string &in, uint &position, std::string &text)
+		{
+			u64 length = null<u64>();
+			boolean rc = readBinaryUnsigned(in, position, length, 2U);
+			rc = rc && ((position + length) <= in.size());
+			if (rc)
+			{
+				text.assign(in, position, length);
+				position += static_cast<uint>(length);
+			}
+			return rc;
+		}
+
+		// For strings, that are not needed by the receiver
+		inline boolean skipBinaryString(const std::string &in, uint &position)
+		{
+			u64 length = null<u64>();
+			boolean rc = readBinaryUnsigned(in, position, length, 2U);
+			rc = rc && ((position + length) <= in.size());
+			if (rc)
+			{
+				position += static_cast<uint>(length);
+			}
+			return rc;
+		}
+		
+		// 7.2 Build the frame. The values may come from a vector or from the published values. Both have operator[] and size()
+		template <class AllEhz>
+		void encodeMeasuredValuesToBinaryFrame(const AllEhz &allMeasuredValuesForAllEhz, std::string &frame)
+		{
+			static const OneMeasuredValueForOneEhz emptyValue;
+			
+			frame.clear();
+			frame.push_back(BinaryFrameStart);
+			//lint -e{921}
+			frame.push_back(static_cast<mchar>(BinaryFormatVersion));
+			// Placeholder for the length of the payload
+			appendBinaryUnsigned(frame, null<u64>(), 4U);
+			
+			appendBinaryUnsigned(frame, allMeasuredValuesForAllEhz.size(), 2U);
+			for (uint ehzIndex = null<uint>(); ehzIndex < allMeasuredValuesForAllEhz.size(); ++ehzIndex)
+			{
+				const AllMeasuredValuesForOneEhz &amvfoe = allMeasuredValuesForAllEhz[ehzIndex];
+				//lint -e{571}
+				appendBinaryUnsigned(frame, static_cast<u64>(amvfoe.timeWhenDataHasBeenEvaluated), 8U);
+				appendBinaryString(frame, amvfoe.getTimeWhenDataHasBeenEvaluatedString());
+				
+				// Empty values at the end are not transferred
+				uint numberOfValues = NumberOfEhzMeasuredData;
+				while ((numberOfValues > null<uint>()) && !amvfoe.measuredValueForOneEhz[numberOfValues - 1U].hasChanged(emptyValue))
+				{
+					--numberOfValues;
+				}
+				appendBinaryUnsigned(frame, numberOfValues, 2U);
+				for (uint i = null<uint>(); i < numberOfValues; ++i)
+				{
+					const OneMeasuredValueForOneEhz &omv = amvfoe.measuredValueForOneEhz[i];
+					//lint -e{571}
+					appendBinaryUnsigned(frame, static_cast<u64>(omv.mantissa), 8U);
+					//lint -e{571}
+					appendBinaryUnsigned(frame, static_cast<u64>(static_cast<u8>(omv.scaler)), 1U);
+					appendBinaryUnsigned(frame, omv.unitIndex, 1U);
+					appendBinaryUnsigned(frame, omv.status, 8U);
+					appendBinaryString(frame, omv.smlByteString);
+				}
+			}
+			
+			// Now the length is known
+			const u64 payloadSize = frame.size() - BinaryFrameHeaderSize;
+			for (uint i = null<uint>(); i < 4U; ++i)
+			{
+				//lint -e{921}
+				frame[2U + i] = static_cast<mchar>((payloadSize >> (8U * i)) & 0xFFULL);
+			}
+		}
+		
+		void encodeBinaryFrame(const PublishedMeasuredValues &publishedMeasuredValues, std::string &frame)
+		{
+			encodeMeasuredValuesToBinaryFrame(publishedMeasuredValues, frame);
+		}
+		
+		void encodeBinaryFrame(const AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz, std::string &frame)
+		{
+			encodeMeasuredValuesToBinaryFrame(allMeasuredValuesForAllEhz, frame);
+		}
+		
+		// 7.3 Check the header and get the size of the frame
+		sint getBinaryFrameSize(const std::string &receivedData)
+		{
+			sint rc = null<sint>();
+			if (receivedData.size() >= BinaryFrameHeaderSize)
+			{
+				uint position = 2U;
+				u64 payloadSize = null<u64>();
+				//lint -e{534}
+				readBinaryUnsigned(receivedData, position, payloadSize, 4U);
+				//lint -e{921}
+				if ((BinaryFrameStart != receivedData[0]) || (BinaryFormatVersion != static_cast<u8>(receivedData[1])) || (payloadSize > MaxBinaryPayloadSize))
+				{
+					rc = -1;
+				}
+				else
+				{
+					rc = static_cast<sint>(payloadSize + BinaryFrameHeaderSize);
+				}
+			}
+			return rc;
+		}
+		
+		// 7.4 Take over the values from a complete frame
+		boolean decodeBinaryFrame(const std::string &frame, AllMeasuredValuesForAllEhz &allMeasuredValuesForAllEhz)
+		{
+			uint position = BinaryFrameHeaderSize;
+			u64 numberOfEhz = null<u64>();
+			boolean rc = (getBinaryFrameSize(frame) == static_cast<sint>(frame.size())) && readBinaryUnsigned(frame, position, numberOfEhz, 2U);
+			if (rc)
+			{
+				allMeasuredValuesForAllEhz.resize(numberOfEhz);
+			}
+			for (uint ehzIndex = null<uint>(); rc && (ehzIndex < numberOfEhz); ++ehzIndex)
+			{
+				AllMeasuredValuesForOneEhz &amvfoe = allMeasuredValuesForAllEhz[ehzIndex];
+				u64 value = null<u64>();
+				u64 numberOfValues = null<u64>();
+				rc = readBinaryUnsigned(frame, position, value, 8U) && skipBinaryString(frame, position) &&
+					 readBinaryUnsigned(frame, position, numberOfValues, 2U) && (numberOfValues <= NumberOfEhzMeasuredData);
+				//lint -e{571}
+				amvfoe.timeWhenDataHasBeenEvaluated = static_cast<time_t>(value);
+				
+				for (uint i = null<uint>(); rc && (i < numberOfValues); ++i)
+				{
+					OneMeasuredValueForOneEhz &omv = amvfoe.measuredValueForOneEhz[i];
+					u64 mantissa = null<u64>();
+					u64 scaler = null<u64>();
+					u64 unitIndex = null<u64>();
+					rc = readBinaryUnsigned(frame, position, mantissa, 8U) && readBinaryUnsigned(frame, position, scaler, 1U) &&
+						 readBinaryUnsigned(frame, position, unitIndex, 1U) && readBinaryUnsigned(frame, position, omv.status, 8U) &&
+						 readBinaryString(frame, position, omv.smlByteString) && (unitIndex < ObisUnitLookup.size());
+					if (rc)
+					{
+						//lint -e{921}
+						omv.setScaledValue(static_cast<s64>(mantissa), static_cast<s8>(static_cast<u8>(scaler)));
+						omv.unitIndex = static_cast<u8>(unitIndex);
+						omv.unit = ObisUnitLookup[omv.unitIndex].unit;
+					}
+				}
+				for (uint i = static_cast<uint>(numberOfValues); rc && (i < NumberOfEhzMeasuredData); ++i)
+				{
+					amvfoe.measuredValueForOneEhz[i].clear();
+				}
+			}
+			return rc && (position == frame.size());
+		}
+	}
+
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 8. Change detection
+
+	namespace EhzInternal
+	{
+		// 8.1 Compare with a tolerance. Strings, status and unit must be equal
+		boolean OneMeasuredValueForOneEhz::hasChangedBeyond(const OneMeasuredValueForOneEhz &other, const mdouble deadband) const
+		{
+			boolean rc = hasChanged(other);
+			if (rc && (deadband > 0.0))
+			{
+				rc = (fabs(doubleValue - other.doubleValue) > deadband) || (status != other.status) || (unitIndex != other.unitIndex) || (smlByteString != other.smlByteString);
+			}
+			return rc;
+		}
+		
+		// 8.2 Constructor. Nothing reported yet. So the first values are a keyframe
+		ChangeDetection::ChangeDetection(void) : lastReportedValues(getNumberOfEhz()), lastKeyframeTime(getNumberOfEhz(), null<time_t>())
+		{
+		}
+		
+		// 8.3 Check which values must be reported
+		u32 ChangeDetection::filter(const uint ehzIndex, const AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz, const time_t nowTime, boolean &isKeyframe)
+		{
+			u32 reportedValues = AllMeasuredValuesReported;
+			isKeyframe = false;
+			const EhzConfigDefinition &ecd = getEhzConfigDefinition(ehzIndex);
+			if (null<u32>() != ecd.EhzKeyframeIntervalInS)
+			{
+				AllMeasuredValuesForOneEhz &reported = lastReportedValues[ehzIndex];
+				isKeyframe = (null<time_t>() == lastKeyframeTime[ehzIndex]) || (nowTime >= (lastKeyframeTime[ehzIndex] + static_cast<time_t>(ecd.EhzKeyframeIntervalInS)));
+				if (isKeyframe)
+				{
+					lastKeyframeTime[ehzIndex] = nowTime;
+				}
+				else
+				{
+					reportedValues = null<u32>();
+				}
+				
+				const uint numberOfUsedEhzMeasuredData = EhzSystemConfiguration::getInstance()->getNumberOfUsedEhzMeasuredData(ehzIndex);
+				for (uint valueId = null<uint>(); valueId < numberOfUsedEhzMeasuredData; ++valueId)
+				{
+					const OneMeasuredValueForOneEhz &omv = allMeasuredValuesForOneEhz.measuredValueForOneEhz[valueId];
+					if (isKeyframe || omv.hasChangedBeyond(reported.measuredValueForOneEhz[valueId], ecd.ehzDeadband[valueId]))
+					{
+						reportedValues |= (1UL << valueId);
+						reported.measuredValueForOneEhz[valueId] = omv;
+					}
+				}
+			}
+			return reportedValues;
+		}
+	}
+
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 9. Provisional values
+
+	namespace EhzInternal
+	{
+		// 9.1 Constructor and destructor
+		ProvisionalMeasuredValues::ProvisionalMeasuredValues(void) : measuredValues(getNumberOfEhz() * NumberOfEhzMeasuredData), sequenceOfEhz(getNumberOfEhz(), null<u64>()),
+																		isProvisional(getNumberOfEhz(), null<u32>()), smlFileNumberOfEhz(getNumberOfEhz(), null<u64>())
+		{
+		}
+		
+		// The parser and the EHZ system change the values. A writer waits only for the copy of one value by the other
+		u64 ProvisionalMeasuredValues::lock(const uint ehzIndex)
+		{
+			u64 sequence = __atomic_load_n(&sequenceOfEhz[ehzIndex], __ATOMIC_RELAXED);
+			while ((null<u64>() != (sequence & 1ULL)) || !__atomic_compare_exchange_n(&sequenceOfEhz[ehzIndex], &sequence, sequence + 1ULL, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			{
+				sequence = __atomic_load_n(&sequenceOfEhz[ehzIndex], __ATOMIC_RELAXED);
+			}
+			// Odd: Readers must not use the values. The values must not be written before the sequence
+			__atomic_thread_fence(__ATOMIC_RELEASE);
+			return sequence;
+		}
+		
+		// 9.2 Store a value of the SML file, that is just parsed. Only the parser of the EHZ calls this
+		void ProvisionalMeasuredValues::set(const uint ehzIndex, const u64 smlFileNumber, const uint valueId, const OneMeasuredValueForOneEhz &oneMeasuredValueForOneEhz)
+		{
+			if ((ehzIndex < isProvisional.size()) && (valueId < NumberOfEhzMeasuredData))
+			{
+				ProvisionalValue &provisionalValue = measuredValues[(ehzIndex * NumberOfEhzMeasuredData) + valueId];
+				const u64 sequence = lock(ehzIndex);
+				// The first value of a new SML file. The values of an older SML file, that was not discarded, are not valid
+				if (smlFileNumber != smlFileNumberOfEhz[ehzIndex])
+				{
+					smlFileNumberOfEhz[ehzIndex] = smlFileNumber;
+					__atomic_store_n(&isProvisional[ehzIndex], null<u32>(), __ATOMIC_RELAXED);
+				}
+				provisionalValue.mantissa = oneMeasuredValueForOneEhz.mantissa;
+				provisionalValue.status = oneMeasuredValueForOneEhz.status;
+				provisionalValue.doubleValue = oneMeasuredValueForOneEhz.doubleValue;
+				provisionalValue.scaler = oneMeasuredValueForOneEhz.scaler;
+				provisionalValue.unitIndex = oneMeasuredValueForOneEhz.unitIndex;
+				//lint -e{534}
+				__atomic_or_fetch(&isProvisional[ehzIndex], (1UL << valueId), __ATOMIC_RELAXED);
+				// Even again: The values are consistent
+				unlock(ehzIndex, sequence);
+			}
+		}
+		
+		// 9.3 The values are confirmed or invalid. The parser may already have set values of the next SML file. They stay
+		void ProvisionalMeasuredValues::discard(const uint ehzIndex, const u64 smlFileNumber)
+		{
+			if (ehzIndex < isProvisional.size())
+			{
+				const u64 sequence = lock(ehzIndex);
+				if (smlFileNumber == smlFileNumberOfEhz[ehzIndex])
+				{
+					__atomic_store_n(&isProvisional[ehzIndex], null<u32>(), __ATOMIC_RELAXED);
+				}
+				unlock(ehzIndex, sequence);
+			}
+		}
+		
+		// 9.4 Copy for a reader. The valid bits are copied under the lock together with the value
+		boolean ProvisionalMeasuredValues::get(const uint ehzIndex, const uint valueId, OneMeasuredValueForOneEhz &oneMeasuredValueForOneEhz) const
+		{
+			boolean rc = false;
+			if ((ehzIndex < isProvisional.size()) && (valueId < NumberOfEhzMeasuredData) && (null<u32>() != (__atomic_load_n(&isProvisional[ehzIndex], __ATOMIC_RELAXED) & (1UL << valueId))))
+			{
+				const ProvisionalValue &provisionalValue = measuredValues[(ehzIndex * NumberOfEhzMeasuredData) + valueId];
+				ProvisionalValue copyOfValue;
+				u32 copyOfIsProvisional = null<u32>();
+				boolean copyIsValid = false;
+				while (!copyIsValid)
+				{
+					// Wait until the writer has finished
+					u64 sequence = __atomic_load_n(&sequenceOfEhz[ehzIndex], __ATOMIC_ACQUIRE);
+					while (null<u64>() != (sequence & 1ULL))
+					{
+						sequence = __atomic_load_n(&sequenceOfEhz[ehzIndex], __ATOMIC_ACQUIRE);
+					}
+					copyOfIsProvisional = __atomic_load_n(&isProvisional[ehzIndex], __ATOMIC_RELAXED);
+					copyOfValue = provisionalValue;
+					// The value must have been read, before the sequence is read again
+					__atomic_thread_fence(__ATOMIC_ACQUIRE);
+					copyIsValid = (sequence == __atomic_load_n(&sequenceOfEhz[ehzIndex], __ATOMIC_RELAXED));
+				}
+				rc = (null<u32>() != (copyOfIsProvisional & (1UL << valueId)));
+				if (rc)
+				{
+					oneMeasuredValueForOneEhz.clear();
+					oneMeasuredValueForOneEhz.mantissa = copyOfValue.mantissa;
+					oneMeasuredValueForOneEhz.status = copyOfValue.status;
+					oneMeasuredValueForOneEhz.doubleValue = copyOfValue.doubleValue;
+					oneMeasuredValueForOneEhz.scaler = copyOfValue.scaler;
+					oneMeasuredValueForOneEhz.unitIndex = copyOfValue.unitIndex;
+					oneMeasuredValueForOneEhz.unit = ObisUnitLookup[copyOfValue.unitIndex].unit;
+				}
+			}
+			return rc;
+		}
+	}
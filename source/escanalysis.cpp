@@ -119,6 +119,8 @@
 
 #include "escanalysis.hpp"		
 
+#include <string.h>
+
 
 // ----------------------------------------------------------------------------------------------------------------------------------
 // 1. Implementation of "analyse" functions for concrete state
@@ -169,6 +171,7 @@ namespace EscAnalyisInternal
 			
 		// Get the result from the running calculation of the checksum	
 		eacd.escSmlFileEndData.crc16Calculated = eacd.smlFileCrc16Calculator.getResult();
+		++eacd.escAnalysisStatistics.numberOfEscFrames;
 
 		// Compare the calculated result with the checksum transmitted in the data stream
 		if ((eacd.escSmlFileEndData.crc16FromEscStop == eacd.escSmlFileEndData.crc16Calculated))
@@ -180,6 +183,7 @@ namespace EscAnalyisInternal
 		{
 			// Checksum mismatch --> error
 			eacd.resultCode = EscAnalysisResult::ESC_ANALYSIS_RESULT_ERROR;
+			++eacd.escAnalysisStatistics.numberOfCrc16Mismatches;
 		}
 		// In any case go back to Idle state
 		return getInstance<EscStateIdle>();
@@ -302,6 +306,120 @@ namespace EscAnalyisInternal
 } // End of	namespace EscAnalyisInternal
 
 
+// ----------------------------------------------------------------------------------------------------------------------------------
+// 2. Table driven ESC analysis
+// ----------------------------------------------------------------------------------------------------------------------------------
+namespace EscAnalyisInternal
+{
+	// Shortcuts to keep the table readable
+	#define ESC_TT(nextState, resultCode, action) { EscTableState::nextState, EscAnalysisResult::resultCode, EscTableAction::action }
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 2.1 The transition table
+    // ------------------------------------------------------------------------------------------------------------------------------
+
+	// Rows: current state. Columns: byte class ESC, START, STOP, Other
+	// This is a 1:1 translation of the state classes in chapter 1 and in the header file
+	const EscTableTransition escTransitionTable[EscTableState::NumberOfStates][EscByteClass::NumberOfByteClasses] =
+	{
+		// Idle
+		{ ESC_TT(WaitFor2ndEsc, ESC_CONDITION_ANALYSING, None),		ESC_TT(Idle, ESC_CONDITION_WAITING, None),				ESC_TT(Idle, ESC_CONDITION_WAITING, None),				ESC_TT(Idle, ESC_CONDITION_WAITING, None) },
+		// WaitFor2ndEsc
+		{ ESC_TT(WaitFor3rdEsc, ESC_CONDITION_ANALYSING, None),		ESC_TT(Idle, ESC_CONDITION_WAITING, None),				ESC_TT(Idle, ESC_CONDITION_WAITING, None),				ESC_TT(Idle, ESC_CONDITION_WAITING, None) },
+		// WaitFor3rdEsc
+		{ ESC_TT(WaitFor4thEsc, ESC_CONDITION_ANALYSING, None),		ESC_TT(Idle, ESC_CONDITION_WAITING, None),				ESC_TT(Idle, ESC_CONDITION_WAITING, None),				ESC_TT(Idle, ESC_CONDITION_WAITING, None) },
+		// WaitFor4thEsc
+		{ ESC_TT(InitialEscRead, ESC_CONDITION_ANALYSING, None),		ESC_TT(Idle, ESC_CONDITION_WAITING, None),				ESC_TT(Idle, ESC_CONDITION_WAITING, None),				ESC_TT(Idle, ESC_CONDITION_WAITING, None) },
+		// InitialEscRead
+		{ ESC_TT(WaitFor2ndEscEsc, ESC_ANALYSIS_RESULT_ESCESC, None),	ESC_TT(WaitFor2ndStart, ESC_CONDITION_ANALYSING, None),	ESC_TT(WaitForFillByte, ESC_CONDITION_ANALYSING, None),	ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None) },
+		// WaitFor2ndEscEsc
+		{ ESC_TT(WaitFor3rdEscEsc, ESC_ANALYSIS_RESULT_ESCESC, None),	ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),			ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),			ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None) },
+		// WaitFor3rdEscEsc
+		{ ESC_TT(WaitFor4thEscEsc, ESC_ANALYSIS_RESULT_ESCESC, None),	ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),			ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),			ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None) },
+		// WaitFor4thEscEsc
+		{ ESC_TT(Idle, ESC_ANALYSIS_RESULT_ESCESC, None),				ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),			ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),			ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None) },
+		// WaitFor2ndStart
+		{ ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),				ESC_TT(WaitFor3rdStart, ESC_CONDITION_ANALYSING, None),	ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),			ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None) },
+		// WaitFor3rdStart
+		{ ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),				ESC_TT(WaitFor4thStart, ESC_CONDITION_ANALYSING, None),	ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),			ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None) },
+		// WaitFor4thStart
+		{ ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),				ESC_TT(Idle, ESC_ANALYSIS_RESULT_START, StartCrc16),		ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None),			ESC_TT(Idle, ESC_ANALYSIS_RESULT_ERROR, None) },
+		// WaitForFillByte. Any byte is accepted
+		{ ESC_TT(WaitForCrc16Byte1, ESC_CONDITION_ANALYSING, StoreFillByte),	ESC_TT(WaitForCrc16Byte1, ESC_CONDITION_ANALYSING, StoreFillByte),	ESC_TT(WaitForCrc16Byte1, ESC_CONDITION_ANALYSING, StoreFillByte),	ESC_TT(WaitForCrc16Byte1, ESC_CONDITION_ANALYSING, StoreFillByte) },
+		// WaitForCrc16Byte1. Any byte is accepted
+		{ ESC_TT(WaitForCrc16Byte2, ESC_CONDITION_ANALYSING, StoreCrc16Byte1),	ESC_TT(WaitForCrc16Byte2, ESC_CONDITION_ANALYSING, StoreCrc16Byte1),	ESC_TT(WaitForCrc16Byte2, ESC_CONDITION_ANALYSING, StoreCrc16Byte1),	ESC_TT(WaitForCrc16Byte2, ESC_CONDITION_ANALYSING, StoreCrc16Byte1) },
+		// WaitForCrc16Byte2. Any byte is accepted. Result will be set to error in case of a checksum mismatch
+		{ ESC_TT(Idle, ESC_ANALYSIS_RESULT_STOP, CheckCrc16),			ESC_TT(Idle, ESC_ANALYSIS_RESULT_STOP, CheckCrc16),		ESC_TT(Idle, ESC_ANALYSIS_RESULT_STOP, CheckCrc16),		ESC_TT(Idle, ESC_ANALYSIS_RESULT_STOP, CheckCrc16) }
+	};
+	
+	#undef ESC_TT
+
+} // End of	namespace EscAnalyisInternal
+
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 2.2 Look ahead for net data
+    // ------------------------------------------------------------------------------------------------------------------------------
+
+	// Only in state Idle the bytes up to the next ESC are net data
+	size_t EscAnalysisTableDriven::analysePayload(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes)
+	{
+		size_t numberOfPayloadBytes = null<size_t>();
+		
+		if ((EscAnalyisInternal::EscTableState::Idle == currentState) && (numberOfBytes > null<size_t>()))
+		{
+			// The C library has highly optimized functions for searching a byte
+			//lint -e{925,1773}
+			const EhzDatabyte *const nextEsc = static_cast<const EhzDatabyte *>(memchr(ehzDatabytes, EscAnalyisInternal::DATABYTE_ESC, numberOfBytes));
+			numberOfPayloadBytes = (null<const EhzDatabyte *>() == nextEsc) ? numberOfBytes : static_cast<size_t>(nextEsc - ehzDatabytes);
+			
+			if (numberOfPayloadBytes > null<size_t>())
+			{
+				// Net data must be part of the checksum of the SML file
+				eacd.smlFileCrc16Calculator.update(ehzDatabytes, numberOfPayloadBytes);
+				// Same result as the state machine would have produced
+				eacd.resultCode = EscAnalysisResult::ESC_CONDITION_WAITING;
+			}
+		}
+		return numberOfPayloadBytes;
+	}
 
 
+// ----------------------------------------------------------------------------------------------------------------------------------
+// 3. Search for the next ESC-Start sequence
+// ----------------------------------------------------------------------------------------------------------------------------------
 
+	size_t findEscStartSequence(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes)
+	{
+		//lint -e{921}
+		static const EhzDatabyte escStartSequence[8] = 
+		{
+			EscAnalyisInternal::DATABYTE_ESC, EscAnalyisInternal::DATABYTE_ESC, EscAnalyisInternal::DATABYTE_ESC, EscAnalyisInternal::DATABYTE_ESC,
+			EscAnalyisInternal::DATABYTE_START, EscAnalyisInternal::DATABYTE_START, EscAnalyisInternal::DATABYTE_START, EscAnalyisInternal::DATABYTE_START
+		};
+		size_t position = null<size_t>();
+		boolean escStartSequenceFound = false;
+		
+		while ((!escStartSequenceFound) && (position < numberOfBytes))
+		{
+			// The C library searches the ESC much faster than we could do it byte by byte
+			//lint -e{925,1773}
+			const EhzDatabyte *const nextEsc = static_cast<const EhzDatabyte *>(memchr(&ehzDatabytes[position], EscAnalyisInternal::DATABYTE_ESC, numberOfBytes - position));
+			if (null<const EhzDatabyte *>() == nextEsc)
+			{
+				position = numberOfBytes;
+			}
+			else
+			{
+				position = static_cast<size_t>(nextEsc - ehzDatabytes);
+				// At the end of the block only the available bytes can be compared
+				const size_t numberOfBytesToCompare = ((numberOfBytes - position) < sizeof(escStartSequence)) ? (numberOfBytes - position) : sizeof(escStartSequence);
+				escStartSequenceFound = (0 == memcmp(nextEsc, &escStartSequence[0], numberOfBytesToCompare));
+				if (!escStartSequenceFound)
+				{
+					++position;
+				}
+			}
+		}
+		return position;
+	}
@@ -0,0 +1,532 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// historian.cpp
+//
+// General Description
+//
+// Append only storage for measured values in memory mapped segment files.
+// See historian.hpp for the layout of the files
+//
+
+
+
+#include "historian.hpp"
+#include "ehzconfig.hpp"
+#include "userinterface.hpp"
+
+#include "sqlite3.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General definitions
+
+	namespace HistorianInternal
+	{
+		// Segment files: prefix + time of the first record (20 digits, so that names sort by time) + suffix
+		const mchar SegmentFilePrefix[] = "segment_";
+		const mchar SegmentFileSuffix[] = ".ehs";
+		const size_t SegmentFilePrefixLength = sizeof(SegmentFilePrefix) - 1U;
+		const size_t SegmentFileSuffixLength = sizeof(SegmentFileSuffix) - 1U;
+		
+		// Size of one segment file
+		const size_t SegmentFileSize = static_cast<size_t>(HistorianHeaderSize) + (static_cast<size_t>(HistorianRecordsPerSegment) * sizeof(HistorianRecord));
+		
+		// Table for the export into SQLITE
+		// More than one SML file of a meter may be evaluated in the same second. The sequence number keeps them apart
+		const mchar HistorianExportDdl[] = 	"CREATE TABLE IF NOT EXISTS ehzHistorian (\n"
+											"timeBase INTEGER NOT NULL,\n"
+											"meter INTEGER NOT NULL,\n"
+											"valueId INTEGER NOT NULL,\n"
+											"sequenceNumber INTEGER NOT NULL DEFAULT 0,\n"
+											"mantissa INTEGER,\n"
+											"scaler INTEGER,\n"
+											"value FLOAT,\n"
+											"status INTEGER,\n"
+											"PRIMARY KEY (meter, valueId, timeBase, sequenceNumber)) WITHOUT ROWID;";
+		// Exporting again the same data does no harm. A record is identified by its key
+		const mchar HistorianExportMdl[] = 	"INSERT OR IGNORE INTO ehzHistorian (timeBase, meter, valueId, sequenceNumber, mantissa, scaler, value, status) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8);";
+		// The table of the first version has no sequence number and a different primary key. It is copied into the new one
+		const mchar HistorianMigrationDdl[] = "ALTER TABLE ehzHistorian RENAME TO ehzHistorianVersion1;\n";
+		const mchar HistorianMigrationMdl[] = "INSERT INTO ehzHistorian (timeBase, meter, valueId, sequenceNumber, mantissa, scaler, value, status) "
+											  "SELECT timeBase, meter, valueId, 0, mantissa, scaler, value, status FROM ehzHistorianVersion1;\n"
+											  "DROP TABLE ehzHistorianVersion1;";
+		
+		// Time stamp of a meter, that has not yet appended records since program start
+		const s64 HistorianNoTimeStamp = -1LL;
+		
+		// Get the time of the first record from the name of a segment file
+		inline s64 getTimeOfSegmentFile(const std::string &fileName)
+		{
+			const size_t nameStart = fileName.rfind('/') + 1U;
+			//lint -e{586}
+			return static_cast<s64>(strtoll(fileName.c_str() + nameStart + SegmentFilePrefixLength, null<mchar **>(), 10));
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Construction and destruction
+
+	namespace HistorianInternal
+	{
+		// 2.1 Constructor. Continue with the newest segment
+		EhzHistorian::EhzHistorian(const std::string &directoryl) : directory(directoryl), activeSegmentFileName(), activeSegment(), lastTimeStampAndSequenceNumber()
+		{
+			// Create the directory, if it is not existing
+			if ((0 != mkdir(directory.c_str(), 0755U)) && (EEXIST != errno))
+			{
+				ui << "Historian: Could not create directory " << directory << std::endl;
+			}
+			
+			std::vector<std::string> segmentFileNames;
+			getSegmentFileNames(segmentFileNames);
+			if (!segmentFileNames.empty())
+			{
+				// The segment is only used, if it is valid. Otherwise a new one will be started with the next record
+				if (mapSegment(segmentFileNames.back(), false, activeSegment))
+				{
+					activeSegmentFileName = segmentFileNames.back();
+					ui << "Historian: Continue with " << activeSegmentFileName << std::endl;
+				}
+			}
+		}
+		
+		// 2.2 Destructor. Write the active segment to disk
+		//lint -e{1579}
+		EhzHistorian::~EhzHistorian(void)
+		{
+			try
+			{
+				sync();
+				unmapSegment(activeSegment);
+			}
+			catch(...)
+			{
+			}
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Segment files
+
+	namespace HistorianInternal
+	{
+		// 3.1 Map a segment file into memory
+		boolean EhzHistorian::mapSegment(const std::string &fileName, const boolean create, MappedSegment &mappedSegmentl)
+		{
+			boolean rc = false;
+			const sint flags = create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR;
+			const Handle handle = open(fileName.c_str(), flags, 0644U);
+			if (handle < 0)
+			{
+				ui << "Historian: Could not open " << fileName << std::endl;
+			}
+			else
+			{
+				struct stat fileStatus;
+				// A new file gets its full size at once. The blocks are allocated, when the pages are written
+				const boolean sizeOk = create ? (0 == ftruncate(handle, static_cast<off_t>(SegmentFileSize))) : ((0 == fstat(handle, &fileStatus)) && (static_cast<size_t>(fileStatus.st_size) == SegmentFileSize));
+				if (sizeOk)
+				{
+					void *const memory = mmap(null<void *>(), SegmentFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+					if (MAP_FAILED != memory)
+					{
+						mappedSegmentl.memory = static_cast<u8 *>(memory);
+						//lint -e{826,9176}
+						mappedSegmentl.header = reinterpret_cast<HistorianSegmentHeader *>(mappedSegmentl.memory);
+						//lint -e{826,9176}
+						mappedSegmentl.records = reinterpret_cast<HistorianRecord *>(mappedSegmentl.memory + HistorianHeaderSize);
+						if (create)
+						{
+							mappedSegmentl.header->magic = HistorianMagic;
+							mappedSegmentl.header->version = HistorianVersion;
+							mappedSegmentl.header->recordSize = static_cast<uint>(sizeof(HistorianRecord));
+							mappedSegmentl.header->numberOfRecords = null<uint>();
+						}
+						// Check if this is really one of our files
+						rc = (HistorianMagic == mappedSegmentl.header->magic) && (HistorianVersion == mappedSegmentl.header->version) && 
+							 (sizeof(HistorianRecord) == mappedSegmentl.header->recordSize) && (HistorianRecordsPerSegment >= mappedSegmentl.header->numberOfRecords);
+						if (!rc)
+						{
+							ui << "Historian: Invalid segment " << fileName << std::endl;
+							unmapSegment(mappedSegmentl);
+						}
+					}
+				}
+				// The mapping stays valid after closing the file
+				//lint -e{534}
+				close(handle);
+			}
+			return rc;
+		}
+		
+		// 3.2 Remove a segment from memory
+		void EhzHistorian::unmapSegment(MappedSegment &mappedSegmentl)
+		{
+			if (null<u8 *>() != mappedSegmentl.memory)
+			{
+				//lint -e{534}
+				munmap(mappedSegmentl.memory, SegmentFileSize);
+			}
+			mappedSegmentl = MappedSegment();
+		}
+		
+		// 3.3 Close the active segment and start a new one
+		void EhzHistorian::startNewSegment(const s64 timeOfFirstRecord)
+		{
+			sync();
+			unmapSegment(activeSegment);
+			
+			mchar timeString[24];
+			//lint -e{586}
+			snprintf(&timeString[0], sizeof(timeString), "%020lld", static_cast<long long>(timeOfFirstRecord));
+			std::string fileName(directory);
+			fileName += '/';
+			fileName += SegmentFilePrefix;
+			fileName += &timeString[0];
+			fileName += SegmentFileSuffix;
+			
+			if (mapSegment(fileName, true, activeSegment))
+			{
+				activeSegmentFileName = fileName;
+			}
+			else
+			{
+				activeSegmentFileName.clear();
+			}
+		}
+		
+		// 3.4 All segment files in the directory, sorted by time
+		void EhzHistorian::getSegmentFileNames(std::vector<std::string> &segmentFileNames) const
+		{
+			segmentFileNames.clear();
+			DIR *const dir = opendir(directory.c_str());
+			if (null<DIR *>() != dir)
+			{
+				for (const struct dirent *entry = readdir(dir); null<const struct dirent *>() != entry; entry = readdir(dir))
+				{
+					const std::string name(&entry->d_name[0]);
+					if ((name.length() > (SegmentFilePrefixLength + SegmentFileSuffixLength)) && (0 == name.compare(0U, SegmentFilePrefixLength, SegmentFilePrefix)) && 
+						(0 == name.compare(name.length() - SegmentFileSuffixLength, SegmentFileSuffixLength, SegmentFileSuffix)))
+					{
+						segmentFileNames.push_back(directory + "/" + name);
+					}
+				}
+				//lint -e{534}
+				closedir(dir);
+			}
+			// Names contain the time with leading zeros
+			std::sort(segmentFileNames.begin(), segmentFileNames.end());
+		}
+		
+		// 3.5 Write the mapped pages of the active segment to disk
+		void EhzHistorian::sync(void) const
+		{
+			if (isOpen())
+			{
+				//lint -e{534}
+				msync(activeSegment.memory, SegmentFileSize, MS_SYNC);
+			}
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. Writing and reading
+
+	namespace HistorianInternal
+	{
+		// 4.1 Append all numerical values of one EHZ
+		void EhzHistorian::append(const uint meterIndex, const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz)
+		{
+			HistorianRecord historianRecord;
+			historianRecord.timeStamp = static_cast<s64>(allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated);
+			historianRecord.meterIndex = static_cast<u16>(meterIndex);
+			historianRecord.sequenceNumber = getSequenceNumber(meterIndex, historianRecord.timeStamp);
+			// The slots of the numerical values have been determined when the configuration was loaded
+			const std::vector<uint> &numberValueIds = EhzInternal::EhzSystemConfiguration::getInstance()->getNumberValueIds(meterIndex);
+			for (std::vector<uint>::const_iterator it = numberValueIds.begin(); it != numberValueIds.end(); ++it)
+			{
+				const EhzInternal::OneMeasuredValueForOneEhz &omv = allMeasuredValuesForOneEhz.measuredValueForOneEhz[*it];
+				historianRecord.valueIndex = static_cast<u8>(*it);
+				historianRecord.mantissa = omv.mantissa;
+				historianRecord.scaler = omv.scaler;
+				historianRecord.status = omv.status;
+				append(historianRecord);
+			}
+		}
+		
+		// 4.2 Append one record. This is only a store into the mapped memory
+		void EhzHistorian::append(const HistorianRecord &historianRecord)
+		{
+			if (!isOpen() || (HistorianRecordsPerSegment <= activeSegment.header->numberOfRecords))
+			{
+				startNewSegment(historianRecord.timeStamp);
+			}
+			if (isOpen())
+			{
+				HistorianSegmentHeader *const header = activeSegment.header;
+				const uint recordIndex = header->numberOfRecords;
+				activeSegment.records[recordIndex] = historianRecord;
+				if (null<uint>() == (recordIndex % HistorianIndexStride))
+				{
+					header->timeIndex[recordIndex / HistorianIndexStride] = historianRecord.timeStamp;
+				}
+				// The record counts only after it has been written completely
+				__atomic_store_n(&header->numberOfRecords, recordIndex + 1U, __ATOMIC_RELEASE);
+			}
+		}
+		
+		// 4.3 All values of one SML file get the same sequence number. The next SML file in the same second gets the next one
+		uint EhzHistorian::getSequenceNumber(const uint meterIndex, const s64 timeStamp)
+		{
+			if (meterIndex >= lastTimeStampAndSequenceNumber.size())
+			{
+				lastTimeStampAndSequenceNumber.resize(meterIndex + 1U, std::make_pair(HistorianNoTimeStamp, null<uint>()));
+			}
+			std::pair<s64, uint> &last = lastTimeStampAndSequenceNumber[meterIndex];
+			
+			if (timeStamp == last.first)
+			{
+				++last.second;
+			}
+			else if ((HistorianNoTimeStamp == last.first) && isOpen())
+			{
+				// First records after program start. There may be records of this second from before the restart.
+				// Look at the end of the active segment. Time stamps of different meters are not strictly ordered. So allow one second
+				last.second = null<uint>();
+				for (uint recordIndex = activeSegment.header->numberOfRecords; (recordIndex > null<uint>()) && (activeSegment.records[recordIndex - 1U].timeStamp >= (timeStamp - 1LL)); --recordIndex)
+				{
+					const HistorianRecord &historianRecord = activeSegment.records[recordIndex - 1U];
+					if ((historianRecord.meterIndex == meterIndex) && (historianRecord.timeStamp == timeStamp) && (historianRecord.sequenceNumber >= last.second))
+					{
+						last.second = historianRecord.sequenceNumber + 1U;
+					}
+				}
+			}
+			else
+			{
+				last.second = null<uint>();
+			}
+			last.first = timeStamp;
+			return last.second;
+		}
+		
+		// 4.4 Read records in a time range
+		void EhzHistorian::read(const s64 fromTime, const s64 toTime, std::vector<HistorianRecord> &historianRecords) const
+		{
+			read(fromTime, null<uint>(), toTime, HistorianAnyIndex, HistorianAnyIndex, 0xFFFFFFFFU, historianRecords);
+		}
+		
+		void EhzHistorian::read(const s64 fromTime, const uint fromSequenceNumber, const s64 toTime, const uint meterIndex, const uint valueIndex, const uint maxRecords, std::vector<HistorianRecord> &historianRecords) const
+		{
+			historianRecords.clear();
+			std::vector<std::string> segmentFileNames;
+			getSegmentFileNames(segmentFileNames);
+			
+			for (uint i = null<uint>(); (i < segmentFileNames.size()) && (historianRecords.size() < maxRecords); ++i)
+			{
+				// Segments start with increasing times. Skip if the next one starts before the range. Stop if this one starts after it
+				if (((i + 1U) < segmentFileNames.size()) && (getTimeOfSegmentFile(segmentFileNames[i + 1U]) < fromTime))
+				{
+					continue;
+				}
+				if (getTimeOfSegmentFile(segmentFileNames[i]) > toTime)
+				{
+					break;
+				}
+				
+				if (segmentFileNames[i] == activeSegmentFileName)
+				{
+					readFromSegment(activeSegment, fromTime, fromSequenceNumber, toTime, meterIndex, valueIndex, maxRecords, historianRecords);
+				}
+				else
+				{
+					MappedSegment segment;
+					if (mapSegment(segmentFileNames[i], false, segment))
+					{
+						readFromSegment(segment, fromTime, fromSequenceNumber, toTime, meterIndex, valueIndex, maxRecords, historianRecords);
+						unmapSegment(segment);
+					}
+				}
+			}
+		}
+		
+		// 4.5 Read the records in a time range from one segment
+		// Binary search in the sparse index, then a sequential scan. Records are in time order
+		void EhzHistorian::readFromSegment(const MappedSegment &segment, const s64 fromTime, const uint fromSequenceNumber, const s64 toTime, const uint meterIndex, const uint valueIndex, const uint maxRecords, std::vector<HistorianRecord> &historianRecords)
+		{
+			const uint numberOfRecords = __atomic_load_n(&segment.header->numberOfRecords, __ATOMIC_ACQUIRE);
+			const uint numberOfIndexEntries = (numberOfRecords + HistorianIndexStride - 1U) / HistorianIndexStride;
+			const s64 *const indexBegin = &segment.header->timeIndex[0];
+			
+			// The first block whose successor starts at or after fromTime
+			uint block = static_cast<uint>(std::lower_bound(indexBegin, indexBegin + numberOfIndexEntries, fromTime) - indexBegin);
+			if (block > null<uint>())
+			{
+				--block;
+			}
+			for (uint recordIndex = block * HistorianIndexStride; (recordIndex < numberOfRecords) && (historianRecords.size() < maxRecords); ++recordIndex)
+			{
+				const HistorianRecord &historianRecord = segment.records[recordIndex];
+				if (historianRecord.timeStamp > toTime)
+				{
+					break;
+				}
+				if (((historianRecord.timeStamp > fromTime) || ((historianRecord.timeStamp == fromTime) && (historianRecord.sequenceNumber >= fromSequenceNumber))) && 
+					((HistorianAnyIndex == meterIndex) || (historianRecord.meterIndex == meterIndex)) && 
+					((HistorianAnyIndex == valueIndex) || (historianRecord.valueIndex == valueIndex)))
+				{
+					historianRecords.push_back(historianRecord);
+				}
+			}
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 5. Export into an SQLITE database
+
+	namespace HistorianInternal
+	{
+		// One transaction per segment. Segments are only removed, if their transaction succeeded
+		u64 EhzHistorian::exportToSqlite(const std::string &databaseName, const boolean removeSegments)
+		{
+			u64 numberOfExportedRecords = null<u64>();
+			sqlite3 *db = null<sqlite3 *>();
+			//lint -e{921}
+			const sint flags = static_cast<sint>(static_cast<uint>(SQLITE_OPEN_READWRITE) | static_cast<uint>(SQLITE_OPEN_CREATE));
+			//lint -e{971}
+			if (SQLITE_OK != sqlite3_open_v2(databaseName.c_str(), &db, flags, null<mchar *>()))
+			{
+				ui << "Historian: Could not open database " << databaseName << std::endl;
+			}
+			else
+			{
+				sqlite3_stmt *stmt = null<sqlite3_stmt *>();
+				//lint -e{971}
+				boolean prepared = (SQLITE_OK == sqlite3_exec(db, &HistorianExportDdl[0], null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>())) &&
+								   (SQLITE_OK == sqlite3_prepare_v2(db, &HistorianExportMdl[0], -1, &stmt, null<const mchar **>()));
+				if (!prepared)
+				{
+					// Maybe a table of the first version without sequence number. Copy it into a new table in one transaction
+					//lint --e{534,971}
+					sqlite3_finalize(stmt);
+					stmt = null<sqlite3_stmt *>();
+					sqlite3_exec(db, "BEGIN TRANSACTION;", null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>());
+					if ((SQLITE_OK == sqlite3_exec(db, &HistorianMigrationDdl[0], null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>())) &&
+						(SQLITE_OK == sqlite3_exec(db, &HistorianExportDdl[0], null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>())) &&
+						(SQLITE_OK == sqlite3_exec(db, &HistorianMigrationMdl[0], null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>())) &&
+						(SQLITE_OK == sqlite3_exec(db, "COMMIT TRANSACTION;", null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>())))
+					{
+						ui << "Historian: Table in " << databaseName << " converted to the version with sequence numbers" << std::endl;
+						prepared = (SQLITE_OK == sqlite3_prepare_v2(db, &HistorianExportMdl[0], -1, &stmt, null<const mchar **>()));
+					}
+					else
+					{
+						sqlite3_exec(db, "ROLLBACK TRANSACTION;", null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>());
+					}
+				}
+				if (prepared)
+				{
+					std::vector<std::string> segmentFileNames;
+					getSegmentFileNames(segmentFileNames);
+					for (std::vector<std::string>::const_iterator sfni = segmentFileNames.begin(); sfni != segmentFileNames.end(); ++sfni)
+					{
+						const boolean isActiveSegment = (*sfni == activeSegmentFileName);
+						MappedSegment segment;
+						if (isActiveSegment)
+						{
+							segment = activeSegment;
+						}
+						else if (!mapSegment(*sfni, false, segment))
+						{
+							continue;
+						}
+						
+						//lint --e{534}
+						sqlite3_exec(db, "BEGIN TRANSACTION;", null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>());
+						const uint numberOfRecords = __atomic_load_n(&segment.header->numberOfRecords, __ATOMIC_ACQUIRE);
+						for (uint recordIndex = null<uint>(); recordIndex < numberOfRecords; ++recordIndex)
+						{
+							const HistorianRecord &hr = segment.records[recordIndex];
+							sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(hr.timeStamp));
+							sqlite3_bind_int(stmt, 2, static_cast<sint>(hr.meterIndex));
+							sqlite3_bind_int(stmt, 3, static_cast<sint>(hr.valueIndex));
+							sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(hr.sequenceNumber));
+							sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(hr.mantissa));
+							sqlite3_bind_int(stmt, 6, static_cast<sint>(hr.scaler));
+							sqlite3_bind_double(stmt, 7, EhzInternal::convertScaledValueToDouble(hr.mantissa, hr.scaler));
+							sqlite3_bind_int64(stmt, 8, static_cast<sqlite3_int64>(hr.status));
+							sqlite3_step(stmt);
+							sqlite3_reset(stmt);
+						}
+						const boolean committed = (SQLITE_OK == sqlite3_exec(db, "COMMIT TRANSACTION;", null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>()));
+						
+						if (committed)
+						{
+							numberOfExportedRecords += numberOfRecords;
+						}
+						else
+						{
+							sqlite3_exec(db, "ROLLBACK TRANSACTION;", null<sint (*)(void*,sint,mchar**,mchar**)>(), null<void *>(), null<mchar **>());
+							ui << "Historian: Export of " << *sfni << " failed" << std::endl;
+						}
+						
+						if (!isActiveSegment)
+						{
+							unmapSegment(segment);
+							// Compaction: The data is in the database now. The active segment is kept, we still write into it
+							if (committed && removeSegments)
+							{
+								unlink(sfni->c_str());
+							}
+						}
+					}
+				}
+				else
+				{
+					ui << "Historian: Could not prepare export into " << databaseName << std::endl;
+				}
+				//lint -e{534}
+				sqlite3_finalize(stmt);
+				//lint -e{534}
+				sqlite3_close(db);
+			}
+			return numberOfExportedRecords;
+		}
+	}
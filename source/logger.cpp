@@ -0,0 +1,407 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// logger.cpp
+//
+// General Description
+//
+// Lock free queue of diagnostic records. They are written by the main reactor. See logger.hpp
+//
+
+
+
+#include "logger.hpp"
+#include "reactor.hpp"
+#include "userinterface.hpp"
+
+#include <string.h>
+#include <syslog.h>
+#include <sys/eventfd.h>
+
+#include <algorithm>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Ring buffer
+
+namespace LoggerInternal
+{
+	// In the beginning every record can be written for its own position
+	LogRingBuffer::LogRingBuffer(void) : logRecord(), enqueuePosition(null<uint>()), dequeuePosition(null<uint>())
+	{
+		for (uint i = null<uint>(); i < NumberOfLogRecords; ++i)
+		{
+			logRecord[i].sequence = i;
+		}
+	}
+
+	// Reserve a position with compare and swap. Then fill the record and release it for the reader
+	boolean LogRingBuffer::push(const uint windowNumber, const time_t timeOfRecord, const mchar *const text, const uint length)
+	{
+		boolean rc = false;
+		boolean searchPosition = true;
+		uint position = __atomic_load_n(&enqueuePosition, __ATOMIC_RELAXED);
+		LogRecord *record = null<LogRecord *>();
+		while (searchPosition)
+		{
+			record = &logRecord[position & (NumberOfLogRecords - 1U)];
+			const uint sequence = __atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE);
+			const sint difference = static_cast<sint>(sequence - position);
+			if (null<sint>() == difference)
+			{
+				// The record is free. Try to get it. If another thread was faster, position is updated
+				if (__atomic_compare_exchange_n(&enqueuePosition, &position, position + 1U, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				{
+					rc = true;
+					searchPosition = false;
+				}
+			}
+			else if (difference < null<sint>())
+			{
+				// The reader did not yet free this record. Buffer is full
+				searchPosition = false;
+			}
+			else
+			{
+				position = __atomic_load_n(&enqueuePosition, __ATOMIC_RELAXED);
+			}
+		}
+		if (rc)
+		{
+			record->windowNumber = windowNumber;
+			record->timeOfRecord = timeOfRecord;
+			record->length = std::min(length, LogRecordTextSize);
+			memcpy(&record->text[0], text, record->length);
+			__atomic_store_n(&record->sequence, position + 1U, __ATOMIC_RELEASE);
+		}
+		return rc;
+	}
+
+	boolean LogRingBuffer::pop(LogRecord &logRecordP)
+	{
+		LogRecord &record = logRecord[dequeuePosition & (NumberOfLogRecords - 1U)];
+		const boolean rc = ((dequeuePosition + 1U) == __atomic_load_n(&record.sequence, __ATOMIC_ACQUIRE));
+		if (rc)
+		{
+			logRecordP = record;
+			// Free for the writers in the next round
+			__atomic_store_n(&record.sequence, dequeuePosition + NumberOfLogRecords, __ATOMIC_RELEASE);
+			++dequeuePosition;
+		}
+		return rc;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Logger
+
+	// ------------------------------------------------------------------------
+	// 2.1 Constructor and Destructor
+
+	// The eventfd is always registered with the main reactor. Also if the logger is created in another thread
+	Logger::Logger(void) :	EventHandlerBasic(),
+							logRingBuffer(),
+							logSink(LogSink::Userinterface),
+							logFile(null<FILE *>()),
+							drainIsRequested(false),
+							numberOfDroppedRecords(null<u32>())
+	{
+		handle = eventfd(0U, EFD_NONBLOCK);
+		if (null<Handle>() <= handle)
+		{
+			Reactor::getInstance()->registerHandler(this, EventTypeIn);
+		}
+	}
+
+	// Write, what is left. The user interface is destroyed after the logger
+	Logger::~Logger(void)
+	{
+		try
+		{
+			drain();
+			if (null<FILE *>() != logFile)
+			{
+				fclose(logFile);
+			}
+			if (LogSink::Syslog == logSink)
+			{
+				closelog();
+			}
+			if (null<Handle>() <= handle)
+			{
+				close(handle);
+			}
+		}
+		catch(...)
+		{
+		}
+	}
+
+
+	// ------------------------------------------------------------------------
+	// 2.2 Select the sink
+
+	boolean Logger::setSink(const LogSink::Type logSinkP, const std::string &fileName)
+	{
+		boolean rc = true;
+		// Everything queued so far goes to the old sink
+		drain();
+		if (null<FILE *>() != logFile)
+		{
+			fclose(logFile);
+			logFile = null<FILE *>();
+		}
+		if (LogSink::File == logSinkP)
+		{
+			logFile = fopen(fileName.c_str(), "a");
+			rc = (null<FILE *>() != logFile);
+		}
+		else if (LogSink::Syslog == logSinkP)
+		{
+			openlog("ehz", LOG_PID, LOG_DAEMON);
+		}
+		else
+		{
+			// User interface. Nothing to open
+		}
+		logSink = rc ? logSinkP : LogSink::Userinterface;
+		return rc;
+	}
+
+
+	// ------------------------------------------------------------------------
+	// 2.3 Queue a record
+
+	// Only the first record after a drain costs a system call
+	void Logger::log(const uint windowNumber, const mchar *const text, const uint length)
+	{
+		if (logRingBuffer.push(windowNumber, time(null<time_t *>()), text, length))
+		{
+			if (!__atomic_exchange_n(&drainIsRequested, true, __ATOMIC_ACQ_REL))
+			{
+				const u64 wakeUp = 1ULL;
+				(void)::write(handle, &wakeUp, sizeof(wakeUp));
+			}
+		}
+		else
+		{
+			//lint -e{534}
+			__atomic_add_fetch(&numberOfDroppedRecords, 1UL, __ATOMIC_RELAXED);
+		}
+	}
+
+
+	// ------------------------------------------------------------------------
+	// 2.4 Write the records in the main reactor
+
+	EventProcessing::Action Logger::handleEvent(const EventType)
+	{
+		u64 counter;
+		(void)read(handle, &counter, sizeof(counter));
+		// Records queued from now on will wake us up again
+		__atomic_store_n(&drainIsRequested, false, __ATOMIC_RELEASE);
+		drain();
+		return EventProcessing::Continue;
+	}
+
+	// The user interface is refreshed once for every window, not for every record
+	void Logger::drain(void)
+	{
+		LoggerInternal::LogRecord logRecord;
+		uint lastWindowNumber = LoggerInternal::LogMainWindow;
+		boolean recordsWritten = false;
+		while (logRingBuffer.pop(logRecord))
+		{
+			if (recordsWritten && (lastWindowNumber != logRecord.windowNumber))
+			{
+				flush(lastWindowNumber);
+			}
+			write(logRecord);
+			lastWindowNumber = logRecord.windowNumber;
+			recordsWritten = true;
+		}
+
+		const u32 numberOfDroppedRecordsBefore = __atomic_exchange_n(&numberOfDroppedRecords, null<u32>(), __ATOMIC_RELAXED);
+		if (null<u32>() != numberOfDroppedRecordsBefore)
+		{
+			if (recordsWritten && (LoggerInternal::LogMainWindow != lastWindowNumber))
+			{
+				flush(lastWindowNumber);
+			}
+			const sint length = snprintf(&logRecord.text[0], sizeof(logRecord.text), "Log buffer full. Dropped records: %lu", numberOfDroppedRecordsBefore);
+			logRecord.length = std::min(static_cast<uint>(std::max(length, null<sint>())), LoggerInternal::LogRecordTextSize - 1U);
+			logRecord.windowNumber = LoggerInternal::LogMainWindow;
+			logRecord.timeOfRecord = time(null<time_t *>());
+			write(logRecord);
+			lastWindowNumber = LoggerInternal::LogMainWindow;
+			recordsWritten = true;
+		}
+
+		if (recordsWritten)
+		{
+			flush(lastWindowNumber);
+		}
+	}
+
+	void Logger::flush(const uint windowNumber)
+	{
+		if (LogSink::Userinterface == logSink)
+		{
+			ui[windowNumber] << std::flush;
+		}
+		else if (LogSink::File == logSink)
+		{
+			//lint -e{534}
+			fflush(logFile);
+		}
+		else
+		{
+			// Syslog has written everything already
+		}
+	}
+
+	void Logger::write(const LoggerInternal::LogRecord &logRecord)
+	{
+		switch (logSink)
+		{
+			case LogSink::File:
+				{
+					mchar timeString[32];
+					struct tm tmOfRecord;
+					//lint -e{534}
+					strftime(timeString, sizeof(timeString), "%Y-%m-%d %H:%M:%S", localtime_r(&logRecord.timeOfRecord, &tmOfRecord));
+					fprintf(logFile, "%s ", timeString);
+					if (LoggerInternal::LogMainWindow != logRecord.windowNumber)
+					{
+						fprintf(logFile, "EHZ %u: ", logRecord.windowNumber);
+					}
+					(void)fwrite(&logRecord.text[0], 1U, logRecord.length, logFile);
+					(void)fputc('\n', logFile);
+				}
+				break;
+			case LogSink::Syslog:
+				if (LoggerInternal::LogMainWindow != logRecord.windowNumber)
+				{
+					syslog(LOG_INFO, "EHZ %u: %.*s", logRecord.windowNumber, static_cast<sint>(logRecord.length), &logRecord.text[0]);
+				}
+				else
+				{
+					syslog(LOG_INFO, "%.*s", static_cast<sint>(logRecord.length), &logRecord.text[0]);
+				}
+				break;
+			case LogSink::Userinterface:
+				// Fallthrough
+			default:
+				// An unknown window number gives the main window
+				ui[logRecord.windowNumber].write(&logRecord.text[0], static_cast<std::streamsize>(logRecord.length));
+				ui[logRecord.windowNumber] << '\n';
+				break;
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Rate limit
+
+	// A new second starts a new count. Threads may race at the change of the second. Then maybe one record more is allowed
+	boolean LogSite::allow(u32 &numberOfSuppressedRecordsP)
+	{
+		const time_t now = time(null<time_t *>());
+		time_t second = __atomic_load_n(&currentSecond, __ATOMIC_RELAXED);
+		if ((now != second) && __atomic_compare_exchange_n(&currentSecond, &second, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		{
+			__atomic_store_n(&numberOfRecordsInCurrentSecond, null<u32>(), __ATOMIC_RELAXED);
+		}
+		const boolean rc = (__atomic_add_fetch(&numberOfRecordsInCurrentSecond, 1UL, __ATOMIC_RELAXED) <= maxNumberOfRecordsPerSecond);
+		if (rc)
+		{
+			numberOfSuppressedRecordsP = __atomic_exchange_n(&numberOfSuppressedRecords, null<u32>(), __ATOMIC_RELAXED);
+		}
+		else
+		{
+			//lint -e{534}
+			__atomic_add_fetch(&numberOfSuppressedRecords, 1UL, __ATOMIC_RELAXED);
+		}
+		return rc;
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. Stream for one record
+
+	// A suppressed record is not even formatted
+	Log::Log(LogSite &logSite, const uint windowNumberP) :	std::ostream(this),
+															windowNumber(windowNumberP),
+															isAllowed(false),
+															length(null<uint>()),
+															text()
+	{
+		u32 numberOfSuppressedRecords = null<u32>();
+		isAllowed = logSite.allow(numberOfSuppressedRecords);
+		if (!isAllowed)
+		{
+			setstate(std::ios_base::badbit);
+		}
+		else if (null<u32>() != numberOfSuppressedRecords)
+		{
+			*this << '(' << numberOfSuppressedRecords << " suppressed) ";
+		}
+		else
+		{
+			// Allowed and nothing to report
+		}
+	}
+
+	Log::~Log(void)
+	{
+		try
+		{
+			if (isAllowed)
+			{
+				Logger::getInstance()->log(windowNumber, &text[0], length);
+			}
+		}
+		catch(...)
+		{
+		}
+	}
+
+	// Characters, that do not fit, are ignored
+	std::streambuf::int_type Log::overflow(std::streambuf::int_type c)
+	{
+		if ((length < LoggerInternal::LogRecordTextSize) && (std::streambuf::traits_type::eof() != c))
+		{
+			//lint -e{921}
+			text[length] = static_cast<mchar>(c);
+			++length;
+		}
+		return c;
+	}
+
+	std::streamsize Log::xsputn(const mchar *s, std::streamsize num)
+	{
+		const uint numberOfCharacters = std::min(static_cast<uint>(num), LoggerInternal::LogRecordTextSize - length);
+		std::copy(s, s + numberOfCharacters, &text[length]);
+		length += numberOfCharacters;
+		return num;
+	}
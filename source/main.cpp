@@ -25,6 +25,12 @@
 #include "server.hpp"
 #include "ehz.hpp"
 #include "servertcpfactory.hpp"
+#include "ehzconfig.hpp"
+#include "logger.hpp"
+#include "allocation.hpp"
+#include "trace.hpp"
+
+#include <unistd.h>
 
 // Main 
 
@@ -46,6 +52,9 @@ NCursesUserinterface ui;
 //lint -e{641,911}
 sint globalDebugMode = DebugModeError;
 
+//lint -e{956}
+u32 globalObisDiscoveryRequest = 0UL;
+
 namespace MainInternal
 {
 
@@ -53,12 +62,44 @@ namespace MainInternal
 	const sint MainReturnCode_OK = 0;
 	const sint MainReturnCode_WrongProgramInvocationParameter = -1;
 	const sint MainReturnCode_ErrorInEventloop = -2;
+	const sint MainReturnCode_ErrorInConfiguration = -3;
+	const sint MainReturnCode_AllocationsInSteadyState = -4;
+	
+	// What the program shall do. Selected with the program parameter
+	struct ProgramMode
+	{
+		enum Type
+		{
+			Server,
+			Client,
+			Export
+		};
+	};
+	
+	// What the client requests from the server. Selected with the program parameter after 'client'
+	struct ClientMode
+	{
+		enum Type
+		{
+			PowerState,
+			Poll,
+			Binary,
+			Subscribe
+		};
+	};
+	
+	// The server of the client, if no address is given as program parameter
+	const mchar DefaultServerAddress[] = "192.168.40.150";
 
 	// Protoytpes:
 	EventProcessing::Action runMainEventLoop(void);
 	sint runAsServer(void);
-	sint runAsClient(void);
-	boolean checkProgramParameter(const sint argc, mchar *const argv[], boolean &isServer);
+	template<class TcpConnectionType> sint runClient(const std::string &portNumber, const std::string &serverAddress);
+	sint runAsClient(const ClientMode::Type clientMode, const std::string &serverAddress);
+	sint runExport(void);
+	boolean loadConfiguration(const std::string &configFileName);
+	boolean checkClientMode(const std::string &parameter, ClientMode::Type &clientMode);
+	boolean checkProgramParameter(const sint argc, mchar *const argv[], ProgramMode::Type &programMode, ClientMode::Type &clientMode, std::string &serverAddress, std::string &configFileName);
 		
 	// ---------------------------------------------------------------------------------------------------------
 	// Main event loop of the whole program
@@ -105,8 +146,8 @@ namespace MainInternal
 		// Defintion and initilization of event loop return code. 
 		EventProcessing::Action returnCodeEventHandler;
 		
-		const std::vector<EhzConfigDefinition> myVecEhzConfigDefinition(&EhzInternal::myEhzConfigDefinition[0], &EhzInternal::myEhzConfigDefinition[EhzInternal::MyNumberOfEhz]);
-		EhzSystem ehzSystem(myVecEhzConfigDefinition);
+		// The definitions of the EHZ have been loaded at program start
+		EhzSystem ehzSystem(EhzInternal::EhzSystemConfiguration::getInstance()->getEhzConfigDefinitions());
 		// Define a factory class for TCP connection. Depending on the port number
 		// a TCP class will be created and run
 		TcpConnectionFactoryServerForEhzSystemData tfss(&ehzSystem);
@@ -121,13 +162,26 @@ namespace MainInternal
 		// And run the main event loop 
 		returnCodeEventHandler = runMainEventLoop();
 
-
+		// A running trace is written now. Otherwise it would be lost
+		if (TraceInternal::isTraceActive() && TraceInternal::stopTrace())
+		{
+			ui << "Trace written to " << TraceInternal::EhzTraceFileName << std::endl;
+		}
 
 		// In case of error, inform calling function
 		if (EventProcessing::Error  == returnCodeEventHandler)
 		{
 			returnCode = MainReturnCode_ErrorInEventloop;
 		}
+		// Build mode with accounting of allocations. Nothing shall have been allocated after the warm up
+		else if (AllocationInternal::AllocationAccountingIsActive && !AllocationInternal::reportSteadyStateAllocations(ui))
+		{
+			returnCode = MainReturnCode_AllocationsInSteadyState;
+		}
+		else
+		{
+			// Everything OK
+		}
 		return returnCode;
 	}
 		
@@ -139,20 +193,16 @@ namespace MainInternal
 	// Call the main event loop
 	// Stop all necessary classes again
 
-	sint runAsClient(void)
+	template<class TcpConnectionType> 
+	sint runClient(const std::string &portNumber, const std::string &serverAddress)
 	{
-		// We will call this port an ip address
-		const std::string portNumber3456("3456");
-		const std::string rpi2("192.168.40.150");
-//		const std::string rpi2("192.168.40.199");
-		
 		// Assume that everything is ok
 		sint returnCode = MainReturnCode_OK;
 		// Defintion and initilization of event loop return code. 
 		EventProcessing::Action returnCodeEventHandler;
 		
 		// Instantiate the client
-		ClientWithAutoReconnect<TcpConnectionGetEhzPowerStateClient> client(portNumber3456,rpi2);
+		ClientWithAutoReconnect<TcpConnectionType> client(portNumber,serverAddress);
 		// And start it
 		client.start();
 		
@@ -166,6 +216,78 @@ namespace MainInternal
 		}
 		return returnCode;
 	}
+	
+	// Each client mode talks with its own server port
+	sint runAsClient(const ClientMode::Type clientMode, const std::string &serverAddress)
+	{
+		sint returnCode;
+		switch (clientMode)
+		{
+			case ClientMode::Poll:
+				// Text format on the data server port
+				returnCode = runClient<TcpConnectionGetEhzDataClient>(std::string("5678"), serverAddress);
+				break;
+			case ClientMode::Binary:
+				// Binary format on the data server port
+				returnCode = runClient<TcpConnectionGetEhzDataBinaryClient>(std::string("5678"), serverAddress);
+				break;
+			case ClientMode::Subscribe:
+				// Pushed values from the push server port
+				returnCode = runClient<TcpConnectionSubscribeEhzDataClient>(std::string("5681"), serverAddress);
+				break;
+			case ClientMode::PowerState:
+				// Fallthrough
+			default:
+				returnCode = runClient<TcpConnectionGetEhzPowerStateClient>(std::string("3456"), serverAddress);
+				break;
+		}
+		return returnCode;
+	}
+
+	// ---------------------------------------------------------------------------------------------------------
+	// Export functionality
+	//
+	// Copy all records of the historian into the SQLITE database
+	// Exported segments, but the newest one, will be removed
+
+	sint runExport(void)
+	{
+		HistorianInternal::EhzHistorian historian(HistorianInternal::EhzHistorianDirectory);
+		const u64 numberOfExportedRecords = historian.exportToSqlite(DatabaseInternal::EhzDatabaseName, true);
+		ui << "Exported records: " << numberOfExportedRecords << std::endl;
+		return MainReturnCode_OK;
+	}
+
+	// ---------------------------------------------------------------------------------------------------------
+	// Load the definitions of the EHZ system
+	//
+	// A configuration file given as program parameter must be readable
+	// Otherwise the default configuration file is used, if it is existing. And if not, then the built-in definitions
+
+	boolean loadConfiguration(const std::string &configFileName)
+	{
+		boolean rc = true;
+		const boolean useDefaultFile = configFileName.empty();
+		const std::string fileName(useDefaultFile ? std::string(EhzInternal::EhzConfigFileName) : configFileName);
+		
+		if (!useDefaultFile || (0 == access(fileName.c_str(), F_OK)))
+		{
+			std::string errorMessage;
+			rc = EhzInternal::EhzSystemConfiguration::getInstance()->load(fileName.c_str(), errorMessage);
+			if (rc)
+			{
+				// The number of windows depends on the number of EHZ
+				ui.reInitialize();
+				ui << "Configuration loaded from " << fileName << std::endl;
+			}
+			else
+			{
+				ui << errorMessage << "\nPress key to end" << std::endl;
+				waitForKeyPress();
+			}
+		}
+		return rc;
+	}
 
 	// ---------------------------------------------------------------------------------------------------------
 	// Check program invocation options
@@ -173,13 +295,46 @@ namespace MainInternal
 	// Program may be called  with either
 	// 	ehz server
 	//or
-	// 	ehz client
-	// Check this and additionally return the evaluated paramter: isServer
+	// 	ehz client  [power | poll | binary | subscribe  [server address]]
+	//or
+	// 	ehz export
+	// Optionally followed by the name of a configuration file
+	// Without a client mode the client gets the power state. The server address can only be given after a client mode
+	// and a configuration file for a client with a client mode only after the server address
+	// Check this and additionally return the evaluated paramter: programMode, client mode, server address and the name of the configuration file
+
+	boolean checkClientMode(const std::string &parameter, ClientMode::Type &clientMode)
+	{
+		boolean isClientMode = true;
+		if (parameter == "power")
+		{
+			clientMode = ClientMode::PowerState;
+		}
+		else if (parameter == "poll")
+		{
+			clientMode = ClientMode::Poll;
+		}
+		else if (parameter == "binary")
+		{
+			clientMode = ClientMode::Binary;
+		}
+		else if (parameter == "subscribe")
+		{
+			clientMode = ClientMode::Subscribe;
+		}
+		else
+		{
+			isClientMode = false;
+		}
+		return isClientMode;
+	}
 
-	boolean checkProgramParameter(const sint argc, mchar *const argv[], boolean &isServer)
+	boolean checkProgramParameter(const sint argc, mchar *const argv[], ProgramMode::Type &programMode, ClientMode::Type &clientMode, std::string &serverAddress, std::string &configFileName)
 	{
 		// CHeck number of program parameters
-		boolean programParameterOK = (2 == argc);
+		boolean programParameterOK = ((argc >= 2) && (argc <= 5));
+		// Index of the first program parameter after the mode
+		sint parameterIndex = 2;
 		// If that is OK then
 		if (programParameterOK)
 		{
@@ -188,21 +343,45 @@ namespace MainInternal
 			if (parameter == "server")
 			{
 				ui << "Server Modus" << std::endl;
-				isServer = true;
+				programMode = ProgramMode::Server;
 			}
 			else if (parameter == "client")
 			{
 				ui << "Client Modus" << std::endl;
-				isServer = false;		}
+				programMode = ProgramMode::Client;		
+				// An optional client mode and then an optional server address
+				if ((argc > parameterIndex) && checkClientMode(std::string(argv[parameterIndex]), clientMode))
+				{
+					++parameterIndex;
+					if (argc > parameterIndex)
+					{
+						serverAddress = argv[parameterIndex];
+						++parameterIndex;
+					}
+				}
+			}
+			else if (parameter == "export")
+			{
+				ui << "Export Modus" << std::endl;
+				programMode = ProgramMode::Export;
+			}
 			else
 			{
 				programParameterOK = false;
 			}
+			if (argc == (parameterIndex + 1))
+			{
+				configFileName = argv[parameterIndex];
+			}
+			else if (argc > (parameterIndex + 1))
+			{
+				programParameterOK = false;
+			}
 		}
 		// If called with wrong parameters, inform user
 		if (!programParameterOK)
 		{
-				ui << "Wrong program parameter\nCall Program with  'ehz  server | client'\nPress key to end" << std::endl;
+				ui << "Wrong program parameter\nCall Program with  'ehz  server | client [power | poll | binary | subscribe [server address]] | export  [configuration file]'\nPress key to end" << std::endl;
 				waitForKeyPress();	
 		}
 		return programParameterOK;
@@ -223,27 +402,43 @@ namespace MainInternal
 sint main(const sint argc, mchar *const argv[])
 {
 	sint mainRc = MainInternal::MainReturnCode_OK;
-	boolean isServer = false;
+	MainInternal::ProgramMode::Type programMode = MainInternal::ProgramMode::Server;
+	MainInternal::ClientMode::Type clientMode = MainInternal::ClientMode::PowerState;
+	std::string serverAddress(MainInternal::DefaultServerAddress);
 	
 	ui << "START\n" << cls <<  SetPos(0,0) << "Hello World" << std::endl;	
+	// Without a terminal the diagnostic messages go to syslog
+	//lint -e{534}
+	Logger::getInstance()->setSink(UserinterfaceIsHeadless ? LogSink::Syslog : LogSink::Userinterface);
 
 	// Check parameter
-	const boolean programParameterOK = MainInternal::checkProgramParameter(argc,argv,isServer);
+	std::string configFileName;
+	const boolean programParameterOK = MainInternal::checkProgramParameter(argc,argv,programMode,clientMode,serverAddress,configFileName);
 	if (!programParameterOK)
 	{
 		mainRc = MainInternal::MainReturnCode_WrongProgramInvocationParameter;
 	}
+	else if (!MainInternal::loadConfiguration(configFileName))
+	{
+		mainRc = MainInternal::MainReturnCode_ErrorInConfiguration;
+	}
 	else
 	{
 		//Run program
 
-		if (isServer)
-		{
-			mainRc = MainInternal::runAsServer();
-		}
-		else
+		switch (programMode)
 		{
-			mainRc = MainInternal::runAsClient();
+			case MainInternal::ProgramMode::Server:
+				mainRc = MainInternal::runAsServer();
+				break;
+			case MainInternal::ProgramMode::Export:
+				mainRc = MainInternal::runExport();
+				break;
+			case MainInternal::ProgramMode::Client:
+				// Fallthrough
+			default:
+				mainRc = MainInternal::runAsClient(clientMode, serverAddress);
+				break;
 		}
 	
 		ui << "Press key to end" << std::endl;
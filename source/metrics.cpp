@@ -0,0 +1,145 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// metrics.cpp
+//
+// General Description
+//
+// Counters and histograms for the hot paths and their output in the format of Prometheus. See metrics.hpp
+//
+
+
+
+#include "metrics.hpp"
+
+#include <sstream>
+#include <algorithm>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Histogram
+
+namespace MetricsInternal
+{
+	// The bucket with the smallest upper bound 4^i us, that is not less than the duration
+	void Histogram::observe(const u64 durationInNs)
+	{
+		const u64 durationInUs = durationInNs / 1000ULL;
+		uint bucketIndex = null<uint>();
+		if (durationInUs > 1ULL)
+		{
+			// Number of bits of (duration - 1). Two bits per bucket
+			//lint -e{921}
+			const uint numberOfBits = 64U - static_cast<uint>(__builtin_clzll(durationInUs - 1ULL));
+			bucketIndex = std::min((numberOfBits + 1U) / 2U, NumberOfHistogramBuckets - 1U);
+		}
+		bucket[bucketIndex].increment();
+		sumInNs.add(durationInNs);
+	}
+
+	u64 Histogram::getCount(void) const
+	{
+		u64 count = null<u64>();
+		for (uint i = null<uint>(); i < NumberOfHistogramBuckets; ++i)
+		{
+			count += bucket[i].get();
+		}
+		return count;
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Text format of Prometheus
+
+	void writeMetricHeader(std::ostream &os, const mchar *const name, const mchar *const type, const mchar *const help)
+	{
+		os << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+	}
+
+	void writeCounter(std::ostream &os, const mchar *const name, const std::string &labels, const Counter &counter)
+	{
+		os << name << '{' << labels << "} " << counter.get() << '\n';
+	}
+
+	// Buckets are cumulative. Times in seconds
+	void writeHistogram(std::ostream &os, const mchar *const name, const std::string &labels, const Histogram &histogram)
+	{
+		u64 cumulativeCount = null<u64>();
+		u64 upperBoundInUs = 1ULL;
+		// Enough digits for 4^11 us and for sums in ns
+		const std::streamsize precision = os.precision(12);
+		for (uint i = null<uint>(); i < NumberOfHistogramBuckets; ++i)
+		{
+			cumulativeCount += histogram.getBucket(i);
+			os << name << "_bucket{" << labels << ",le=\"";
+			if ((NumberOfHistogramBuckets - 1U) == i)
+			{
+				os << "+Inf";
+			}
+			else
+			{
+				//lint -e{747,921}
+				os << (static_cast<mdouble>(upperBoundInUs) / 1.0E6);
+			}
+			os << "\"} " << cumulativeCount << '\n';
+			upperBoundInUs *= 4ULL;
+		}
+		//lint -e{747,921}
+		os << name << "_sum{" << labels << "} " << (static_cast<mdouble>(histogram.getSumInNs()) / 1.0E9) << '\n';
+		os << name << "_count{" << labels << "} " << cumulativeCount << '\n';
+		//lint -e{534}
+		os.precision(precision);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Metrics of the reactors and the database
+
+	// Reactors, that never ran, are not shown. The main reactor always
+	void Metrics::write(std::ostream &os) const
+	{
+		MetricsInternal::writeMetricHeader(os, "ehz_reactor_loop_seconds", "histogram", "Time for handling all events of one wake up of a reactor");
+		for (uint reactorIndex = null<uint>(); reactorIndex < MetricsInternal::NumberOfReactorsWithMetrics; ++reactorIndex)
+		{
+			if ((null<uint>() == reactorIndex) || (null<u64>() != reactorMetrics[reactorIndex].eventLoopLatency.getCount()))
+			{
+				std::ostringstream labels;
+				labels << "reactor=\"" << reactorIndex << '"';
+				MetricsInternal::writeHistogram(os, "ehz_reactor_loop_seconds", labels.str(), reactorMetrics[reactorIndex].eventLoopLatency);
+			}
+		}
+		MetricsInternal::writeMetricHeader(os, "ehz_reactor_dispatch_seconds", "histogram", "Time for one call of an event handler");
+		for (uint reactorIndex = null<uint>(); reactorIndex < MetricsInternal::NumberOfReactorsWithMetrics; ++reactorIndex)
+		{
+			if ((null<uint>() == reactorIndex) || (null<u64>() != reactorMetrics[reactorIndex].dispatchLatency.getCount()))
+			{
+				std::ostringstream labels;
+				labels << "reactor=\"" << reactorIndex << '"';
+				MetricsInternal::writeHistogram(os, "ehz_reactor_dispatch_seconds", labels.str(), reactorMetrics[reactorIndex].dispatchLatency);
+			}
+		}
+		MetricsInternal::writeMetricHeader(os, "ehz_database_insert_seconds", "histogram", "Time for writing the queued records in one transaction");
+		MetricsInternal::writeHistogram(os, "ehz_database_insert_seconds", "database=\"ehz\"", databaseInsertLatency);
+		MetricsInternal::writeMetricHeader(os, "ehz_database_lost_records_total", "counter", "Queued records, that could not be written and were given up");
+		MetricsInternal::writeCounter(os, "ehz_database_lost_records_total", "database=\"ehz\"", databaseLostRecords);
+	}
@@ -34,6 +34,7 @@
 #include "parser2.hpp"
 #include "bytestring.hpp"
 #include "userinterface.hpp"
+#include "trace.hpp"
 
 
 // ------------------------------------------------------------------------------------------------------------------------------
@@ -150,14 +151,25 @@ namespace ParserInternal
 	// the end of the message we go back over the edge of the SmlMessagebody into the SmLMessage and it its bytes also.
 	// For this we need a special handling. We use the ignoreRestOfSequence-flag to indicate this situation.
 		//lint -e{1961}   // 1961 virtual member function 'Symbol' could be made const
+		// In skip mode the body is skipped with the help of the TL fields. It ends exactly before the crc16
+		// of the SmlMessage. So the crc16 is checked as for the known message bodies.
 		prCode SmlMessageBodyAny::parse(ParserContext &pc)
 		{
 			// Assume that the parsing is still ongoing
 			prCode rc = pr_PROCESSING;
 			
+			if (pc.skipMode)
+			{
+				// The message body is one element. Maybe a list with further elements
+				if (null<TokenLength>() == pc.numberOfElementsToSkip)
+				{
+					pc.numberOfElementsToSkip = 1U;
+				}
+				rc = skipElements(pc);
+			}
 			// Eat every byte until we receive an EndOfMessage (0x00).
 			// So did we receive this know?
-			if (Token::END_OF_MESSAGE == pc.token->getType())
+			else if (Token::END_OF_MESSAGE == pc.token->getType())
 			{
 				// Indicate that we are ignoring everything
 				pc.ignoreRestOfSequence = true;
@@ -288,6 +300,165 @@ namespace ParserInternal
 			return rc;
 		}
 
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 1.5 Static parsing of the known message bodies:
+
+		// The structure of these containers is fixed. So the element to parse is selected with a switch
+		// and its parse function is called without virtual dispatch. The bookkeeping of the sequence
+		// (next element, end of sequence, streaming visitor) is the same as for the dynamic parsing.
+		// SmlValList and SmlTimeOptional use static parsing by themselves, if it is switched on.
+
+		prCode SmlListEntry::parseStatic(ParserContext &pc)
+		{
+			prCode pr;
+			if (isSkippingRest)
+			{
+				pr = skipRest(pc);
+			}
+			else
+			{
+				const ptrdiff_t stepBefore = getStep();
+				switch (stepBefore)
+				{
+					case 0:	pr = parseStatically(smlList, pc);			break;
+					case 1:	pr = parseStatically(objName, pc);			break;
+					case 2:	pr = parseStatically(status, pc);			break;
+					case 3:	pr = parseStatically(valTime, pc);			break;
+					case 4:	pr = parseStatically(unit, pc);				break;
+					case 5:	pr = parseStatically(scaler, pc);			break;
+					case 6:	pr = parseStatically(value, pc);			break;
+					case 7:	pr = parseStatically(valueSignature, pc);	break;
+					default: pr = pr_ERROR;								break;
+				}
+				pr = completeStep(pr, pc);
+				checkIfRestIsNeeded(stepBefore, pr, pc);
+			}
+			return pr;
+		}
+
+		prCode SmlGetListResponse::parseStatic(ParserContext &pc)
+		{
+			prCode pr;
+			switch (getStep())
+			{
+				case 0:	pr = parseStatically(smlList, pc);			break;
+				case 1:	pr = parseStatically(clientID, pc);			break;
+				case 2:	pr = parseStatically(serverID, pc);			break;
+				case 3:	pr = parseStatically(listName, pc);			break;
+				case 4:	pr = parseStatically(actSensorTime, pc);	break;
+				case 5:	pr = parseStatically(valList, pc);			break;
+				case 6:	pr = parseStatically(listSignature, pc);	break;
+				case 7:	pr = parseStatically(actGatewayTime, pc);	break;
+				default: pr = pr_ERROR;								break;
+			}
+			return completeStep(pr, pc);
+		}
+
+		prCode SmlPublicOpenResponse::parseStatic(ParserContext &pc)
+		{
+			prCode pr;
+			switch (getStep())
+			{
+				case 0:	pr = parseStatically(smlList, pc);			break;
+				case 1:	pr = parseStatically(codepage, pc);			break;
+				case 2:	pr = parseStatically(clientId, pc);			break;
+				case 3:	pr = parseStatically(reqFileId, pc);		break;
+				case 4:	pr = parseStatically(serverId, pc);			break;
+				case 5:	pr = parseStatically(refTime, pc);			break;
+				case 6:	pr = parseStatically(smlVersion, pc);		break;
+				default: pr = pr_ERROR;								break;
+			}
+			return completeStep(pr, pc);
+		}
+
+		prCode SmlPublicCloseResponse::parseStatic(ParserContext &pc)
+		{
+			prCode pr;
+			switch (getStep())
+			{
+				case 0:	pr = parseStatically(smlList, pc);			break;
+				case 1:	pr = parseStatically(globalSignature, pc);	break;
+				default: pr = pr_ERROR;								break;
+			}
+			return completeStep(pr, pc);
+		}
+
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 1.6 Skip mode:
+
+		// Eat the tokens of pc.numberOfElementsToSkip elements. A list counts as one element and adds its own
+		// elements. Only the TL fields are evaluated. Anything else than an element of a SML message body is an error
+		prCode skipElements(ParserContext &pc)
+		{
+			prCode rc = pr_PROCESSING;
+			//lint --e{788}  //enum constant 'Symbol' not used within defaulted switch
+			switch (pc.token->getType())
+			{
+				case Token::LIST:
+					pc.numberOfElementsToSkip += pc.token->getLength();
+					--pc.numberOfElementsToSkip;
+					break;
+				case Token::OPTIONAL:			// fallthrough
+				case Token::BOOLEAN:			// fallthrough
+				case Token::SIGNED_INTEGER:		// fallthrough
+				case Token::UNSIGNED_INTEGER:	// fallthrough
+				case Token::OCTET:
+					--pc.numberOfElementsToSkip;
+					break;
+				default:
+					pc.numberOfElementsToSkip = null<TokenLength>();
+					rc = pr_ERROR;
+					break;
+			}
+			if ((pr_PROCESSING == rc) && (null<TokenLength>() == pc.numberOfElementsToSkip))
+			{
+				rc = pr_DONE;
+			}
+			return rc;
+		}
+
+		// Dynamic parsing of a SmlListEntry. Same as the static parsing
+		prCode SmlListEntry::parse(ParserContext &pc)
+		{
+			prCode pr;
+			if (isSkippingRest)
+			{
+				pr = skipRest(pc);
+			}
+			else
+			{
+				const ptrdiff_t stepBefore = getStep();
+				pr = SmlSequence<7UL>::parse(pc);
+				checkIfRestIsNeeded(stepBefore, pr, pc);
+			}
+			return pr;
+		}
+
+		// The OBIS ID has just been parsed. If the filter does not need it, the remaining 6 elements are skipped
+		void SmlListEntry::checkIfRestIsNeeded(const ptrdiff_t stepBefore, const prCode pr, ParserContext &pc)
+		{
+			if (pc.skipMode && (null<const SmlListEntryFilter *>() != pc.smlListEntryFilter) && (1 == stepBefore) && (pr_PROCESSING == pr) && (2 == getStep()))
+			{
+				if (!pc.smlListEntryFilter->isNeeded(objName.value))
+				{
+					isSkippingRest = true;
+					pc.numberOfElementsToSkip = 6U;
+				}
+			}
+		}
+
+		// The entry is finished without visitor. Also in case of an error
+		prCode SmlListEntry::skipRest(ParserContext &pc)
+		{
+			const prCode pr = skipElements(pc);
+			if (pr_PROCESSING != pr)
+			{
+				isSkippingRest = false;
+				resetIterator();
+			}
+			return pr;
+		}
+
 // ------------------------------------------------------------------------------------------------------------------------------
 // 2. General methods of parser classes
 		
@@ -331,7 +502,7 @@ namespace ParserInternal
 			// Temporary pointer to Base Element of container hierarchy
 			SmlContainer *smlContainer;
 			// Iterator for this container (that we are traversing at this moment). Set it to the first element
-			std::vector<SmlElementBase *>::iterator smlTraverseIterator = smlElementContainer.begin();
+			SmlElementVector::iterator smlTraverseIterator = smlElementContainer.begin();
 			
 			// Now iterate through all elements of this container
 			while (smlElementContainer.end() != smlTraverseIterator)
@@ -366,6 +537,69 @@ namespace ParserInternal
 		}
 
 
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 2.4 Memory pool for the nodes of the parse tree
+
+		// The free lists. Thread local static data, so initialized with 0 for every thread
+		__thread SmlNodePool::FreeBlock *SmlNodePool::freeList[SmlNodePoolNumberOfSizeClasses];
+
+		// Take a block of the requested size class out of the free list. If the free list is empty, get
+		// memory for a block of the size class from the heap. Big objects will be allocated directly.
+		void *SmlNodePool::allocate(const size_t size)
+		{
+			void *memory;
+			const size_t sizeClass = getSizeClass(size);
+			if (sizeClass >= SmlNodePoolNumberOfSizeClasses)
+			{
+				// Too big for the pool
+				memory = ::operator new(size);
+			}
+			else if (null<FreeBlock *>() != freeList[sizeClass])
+			{
+				// Reuse a previously released block
+				FreeBlock *const freeBlock = freeList[sizeClass];
+				freeList[sizeClass] = freeBlock->next;
+				memory = freeBlock;
+			}
+			else
+			{
+				// Nothing in the free list. Allocate a chunk of blocks with the full size of the size class.
+				// The first block is returned, the others are linked into the free list. Chunks are never given back
+				const size_t blockSize = (sizeClass + 1U) * SmlNodePoolGranularity;
+				u8 *const chunk = static_cast<u8 *>(::operator new(blockSize * SmlNodePoolBlocksPerRefill));
+				for (size_t block = 1U; block < SmlNodePoolBlocksPerRefill; ++block)
+				{
+					//lint -e{826}  // 826 Suspicious pointer-to-pointer conversion (area too small)
+					FreeBlock *const freeBlock = reinterpret_cast<FreeBlock *>(&chunk[block * blockSize]);
+					freeBlock->next = freeList[sizeClass];
+					freeList[sizeClass] = freeBlock;
+				}
+				memory = chunk;
+			}
+			return memory;
+		}
+		
+		// Put the block back into the free list for its size class. The memory is kept for
+		// the next SML file. Big objects will be given back to the heap
+		void SmlNodePool::release(void *const memory, const size_t size)
+		{
+			if (null<void *>() != memory)
+			{
+				const size_t sizeClass = getSizeClass(size);
+				if (sizeClass >= SmlNodePoolNumberOfSizeClasses)
+				{
+					::operator delete(memory);
+				}
+				else
+				{
+					FreeBlock *const freeBlock = static_cast<FreeBlock *>(memory);
+					freeBlock->next = freeList[sizeClass];
+					freeList[sizeClass] = freeBlock;
+				}
+			}
+		}
+
+
 // ------------------------------------------------------------------------------------------------------------------------------
 // 3. SmlChoice Factory functions
 
@@ -412,22 +646,100 @@ namespace ParserInternal
 	}
 
 
+	// Static parsing. The same selectors and types as in the factories above, but without the lookup in the map
+	// and without the call through a function pointer. Unknown selectors are left to the factory
+	SmlElementBase *ChoiceFactorySmlMessageBody::createKnownInstance(const u32 selector)
+	{
+		SmlElementBase *smlElementBase;
+		switch (selector)
+		{
+			case 0x0101UL:	smlElementBase = new SmlPublicOpenResponse;		break;
+			case 0x0201UL:	smlElementBase = new SmlPublicCloseResponse;	break;
+			case 0x0701UL:	smlElementBase = new SmlGetListResponse;		break;
+			default:		smlElementBase = null<SmlElementBase *>();		break;
+		}
+		return smlElementBase;
+	}
+
+	// The type of the message body follows from the selector. SmlMessageBodyAny is parsed dynamically
+	//lint -e{1939}   // Down cast. The type has been created for the selector
+	prCode ChoiceFactorySmlMessageBody::parseKnownInstance(const u32 selector, SmlElementBase *const smlElement, ParserContext &pc)
+	{
+		prCode pr;
+		switch (selector)
+		{
+			case 0x0101UL:	pr = static_cast<SmlPublicOpenResponse *>(smlElement)->parseStatic(pc);	break;
+			case 0x0201UL:	pr = static_cast<SmlPublicCloseResponse *>(smlElement)->parseStatic(pc);	break;
+			case 0x0701UL:	pr = static_cast<SmlGetListResponse *>(smlElement)->parseStatic(pc);		break;
+			default:		pr = smlElement->parse(pc);													break;
+		}
+		return pr;
+	}
+
+	SmlElementBase *ChoiceFactorySmlTime::createKnownInstance(const u32 selector)
+	{
+		SmlElementBase *smlElementBase;
+		switch (selector)
+		{
+			case 0x01UL:	smlElementBase = new SmlSecIndex;			break;
+			case 0x02UL:	smlElementBase = new SmlTimestamp;			break;
+			default:		smlElementBase = null<SmlElementBase *>();	break;
+		}
+		return smlElementBase;
+	}
+
+	// SmlSecIndex and SmlTimestamp are both an Unsigned32. An unknown selector has already been an error
+	//lint -e{1939}   // Down cast. The type has been created for the selector
+	prCode ChoiceFactorySmlTime::parseKnownInstance(const u32 selector, SmlElementBase *const smlElement, ParserContext &pc)
+	{
+		prCode pr;
+		switch (selector)
+		{
+			case 0x01UL:	pr = parseStatically(*static_cast<SmlSecIndex *>(smlElement), pc);	break;
+			case 0x02UL:	pr = parseStatically(*static_cast<SmlTimestamp *>(smlElement), pc);	break;
+			default:		pr = smlElement->parse(pc);											break;
+		}
+		return pr;
+	}
+
+
 
 
 }  // End of namespace ParserInternal
 
 	prCode Parser::parse(const EhzDatabyte databyte,  const uint ehzIndex)
+	{
+		pc.token = &(scanner.scan(databyte));
+		return parseToken(databyte, ehzIndex);
+	}
+	
+	// Match the token that the scanner produced for the databyte
+	prCode Parser::parseToken(const EhzDatabyte databyte,  const uint ehzIndex)
 	{
 
 		prCode rc = pr_PROCESSING;
 		
-		pc.token = &(scanner.scan(databyte));
 		pc.crc16Calculator.update(databyte);
 
 		
 		if (pc.token->getType() != Token::CONDITION_NOT_YET_DETECTED)
 		{
-	
+			// Boundaries of the ESC frame
+			if (TraceInternal::isTraceActive())
+			{
+				if (Token::START_OF_SML_FILE == pc.token->getType())
+				{
+					TraceInternal::recordInstant(TraceInternal::TraceProbe::EscFrameStart, ehzIndex);
+				}
+				else if (Token::END_OF_SML_FILE == pc.token->getType())
+				{
+					TraceInternal::recordInstant(TraceInternal::TraceProbe::EscFrameEnd, ehzIndex);
+				}
+				else
+				{
+					// Inside of the frame
+				}
+			}
 			
 			//lint -e{641,911}
 			if (DebugModeParseResult == globalDebugMode)
@@ -488,7 +800,26 @@ namespace ParserInternal
 				}
 			}	
 			pc.ignoreRestOfSequence = false;
-			rc = smlFile.parse(pc);
+			pc.isOctetContentSkipped = false;
+			if ((Token::OCTET == pc.token->getType()) && pc.token->isByteStringTruncated())
+			{
+				// The octet buffer for the SML file is full. A value with missing bytes would be wrong. So the file is dropped
+				// The octet buffer will be larger for the next SML file
+				++parserStatistics.numberOfOctetBufferOverflows;
+				reset();
+				rc = pr_ERROR;
+			}
+			else
+			{
+				rc = smlFile.parse(pc);
+			}
+			// Skip mode: Nothing is skipped beyond the end of a SML file or an error
+			if (pr_PROCESSING != rc)
+			{
+				pc.numberOfElementsToSkip = null<TokenLength>();
+			}
+			// Skip mode: Tell the scanner, if the content of the next octet string is needed
+			scanner.setSkippingOctetContent(pc.isOctetContentSkipped || (null<TokenLength>() != pc.numberOfElementsToSkip));
 			
 			
 		}
@@ -509,8 +840,85 @@ namespace ParserInternal
 	}
 
 
+	// Block oriented parse function. Let the byte oriented parse function do the work
+	size_t Parser::parse(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes, const uint ehzIndex, ParserBoundaryList &parserBoundaryList)
+	{
+		size_t consumedBytes = null<size_t>();
+		// Number of following bytes, that need no ESC analysis
+		size_t numberOfPayloadBytes = null<size_t>();
+		
+		parserBoundaryList.clear();
+		while (consumedBytes < numberOfBytes)
+		{
+			if (isResynchronizing)
+			{
+				// Nothing before the next ESC-Start sequence can be used. So nothing is scanned or parsed
+				const size_t numberOfSkippedBytes = findEscStartSequence(&ehzDatabytes[consumedBytes], numberOfBytes - consumedBytes);
+				parserStatistics.numberOfSkippedBytes += numberOfSkippedBytes;
+				consumedBytes += numberOfSkippedBytes;
+				// If the sequence is not in this chunk, continue the search with the next one
+				isResynchronizing = (consumedBytes == numberOfBytes);
+				numberOfPayloadBytes = null<size_t>();
+			}
+			else
+			{
+				if (null<size_t>() == numberOfPayloadBytes)
+				{
+					numberOfPayloadBytes = scanner.analysePayload(&ehzDatabytes[consumedBytes], numberOfBytes - consumedBytes);
+				}
+				if (numberOfPayloadBytes > null<size_t>())
+				{
+					// Net data. ESC analysis has been done already
+					size_t numberOfScannedBytes = null<size_t>();
+					pc.token = &(scanner.scanPayloadBlock(&ehzDatabytes[consumedBytes], numberOfPayloadBytes, numberOfScannedBytes));
+					numberOfPayloadBytes -= numberOfScannedBytes;
+					// The scanner may have read several bytes. Only the last one can produce a token.
+					// The others are just part of the checksum of the SML message
+					pc.crc16Calculator.update(&ehzDatabytes[consumedBytes], numberOfScannedBytes - 1U);
+					consumedBytes += numberOfScannedBytes - 1U;
+				}
+				else
+				{
+					pc.token = &(scanner.scan(ehzDatabytes[consumedBytes]));
+				}
+				const prCode rc = parseToken(ehzDatabytes[consumedBytes], ehzIndex);
+				if (pr_PROCESSING != rc)
+				{
+					parserBoundaryList.push_back(ParserBoundary(consumedBytes, rc));
+				}
+				++consumedBytes;
+				if (pr_DONE == rc)
+				{
+					// The parse tree contains a complete SML File. Give the caller the chance to evaluate it
+					break;
+				}
+				if (pr_ERROR == rc)
+				{
+					// Same behaviour as in the byte oriented case. Start over with a fresh parse tree
+					reset();
+					if (Token::START_OF_SML_FILE == pc.token->getType())
+					{
+						// The next SML file started, before the current one was complete. It is not lost. It begins with this token
+						//lint -e{534}
+						parseToken(ehzDatabytes[consumedBytes - 1U], ehzIndex);
+					}
+					else
+					{
+						// Skip the rest of the broken SML file. The scanner waits for the ESC-Start sequence
+						scanner.reset();
+						isResynchronizing = true;
+						++parserStatistics.numberOfResyncs;
+					}
+				}
+			}
+		}
+		return consumedBytes;
+	}
+
+
 void Parser::traverseAndEvaluate(ParserInternal::VisitorForSmlListEntry * const visitorForSmlListEntry )
 {
+	const TraceInternal::TraceSpan traceSpan(TraceInternal::TraceProbe::TraverseAndEvaluate);
 	smlFile.traverseAndVisit(visitorForSmlListEntry);
 }
 
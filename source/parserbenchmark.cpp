@@ -0,0 +1,1453 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// parserbenchmark.cpp
+//
+// General Description
+//
+// Throughput benchmark for the SML input chain. The benchmark is an own program (make benchmark)
+// and not part of the ehz.
+//
+// Recorded SML data is replayed through each stage of the chain:
+//
+//  - ESC analysis (state pattern based reference and table driven implementation)
+//  - Scanner (state pattern based reference and switch based implementation)
+//  - Parser (with the scanner selected at compile time via ScannerEngine). With static parsing of the
+//    known message bodies (default), with dynamic parsing of everything and in skip mode
+//
+// Every stage is fed byte by byte and, where available, with the block oriented interface that
+// is used by the Ehz (analysePayload / scanPayloadBlock / block parse).
+//
+// Input data are raw captures of a serial port, for example recorded with "cat /dev/ttyUSB0 > file", or capture
+// files, that the Ehz recorded (EHZCAP01). Of these only the received bytes of the records are used.
+// A capture is split into SML files at the ESC start sequences. Without capture files, the benchmark
+// generates telegrams for 3 typical meters itself. So the numbers are comparable between versions.
+//
+// For each corpus and stage, the benchmark reports: MB/s, SML files/s, memory allocations per SML file
+// and the 99th percentile of the time needed for one SML file.
+//
+// Invocation: parserbenchmark [-i iterations] [capture file] . . .
+// The return code is not 0, if a stage did not recognise all SML files. So the benchmark can be used in scripts
+//
+// Before the measurement, static and dynamic parsing are compared for each corpus. All values of the
+// parse tree and all parse results must be the same. Also for SML files, where single bytes have been changed.
+// In the same way, the token streams of the reference and the switch based scanner are compared, byte by byte
+// and block oriented, and the results of the reference and the table driven ESC analysis, also for fuzzed
+// data. Any difference makes the return code not 0.
+//
+// The frame gap detection of the serial ports uses the timing wheel of the reactor. So the benchmark also checks,
+// that a one shot timer is not delayed by a periodic timer, that expires later.
+//
+// To measure the parser with the reference engines, build with: make benchmark-reference
+//
+
+
+
+#include "parser.hpp"
+#include "scanner.hpp"
+#include "escanalysis.hpp"
+#include "crc16.hpp"
+#include "bytestring.hpp"
+#include "parsetreevisitor.hpp"
+#include "ehzconfig.hpp"
+#include "ehzmeasureddata.hpp"
+#include "metrics.hpp"
+#include "userinterface.hpp"
+#include "timerevent.hpp"
+#include "reactor.hpp"
+#include "serial.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+// ---------------------------------------------------------------------------------------------------------
+// Globals
+
+// Needed by the modules of the parser. Always headless. Debug output is switched off
+//lint --e(1935,1937)
+NCursesUserinterface ui;
+
+//lint -e{641,911}
+sint globalDebugMode = DebugModeHeaderOnly;
+
+//lint -e{956}
+u32 globalObisDiscoveryRequest = 0UL;
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Counting memory allocations
+//
+// The global operator new is replaced. The benchmark runs in one thread, so a simple counter is sufficient
+
+	namespace ParserBenchmarkInternal
+	{
+		u64 numberOfAllocations = null<u64>();
+
+		inline void *allocate(const size_t size)
+		{
+			++numberOfAllocations;
+			void *const memory = malloc((null<size_t>() == size) ? 1U : size);
+			if (null<void *>() == memory)
+			{
+				throw std::bad_alloc();
+			}
+			return memory;
+		}
+	}
+
+	void *operator new(const size_t size) { return ParserBenchmarkInternal::allocate(size); }
+	void *operator new[](const size_t size) { return ParserBenchmarkInternal::allocate(size); }
+	void operator delete(void *const memory) throw() { free(memory); }
+	void operator delete[](void *const memory) throw() { free(memory); }
+	void operator delete(void *const memory, const size_t) throw() { free(memory); }
+	void operator delete[](void *const memory, const size_t) throw() { free(memory); }
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Corpora
+
+	namespace ParserBenchmarkInternal
+	{
+		// One complete SML File, from ESC start to the last byte of the ESC stop sequence
+		typedef std::vector<EhzDatabyte> SmlFileData;
+
+		struct Corpus
+		{
+			Corpus(void) : name(), smlFiles(), numberOfBytes(null<u64>()) {}
+			std::string name;
+			std::vector<SmlFileData> smlFiles;
+			u64 numberOfBytes;
+		};
+
+		const EhzDatabyte EscStartSequence[8] = { 0x1BU, 0x1BU, 0x1BU, 0x1BU, 0x01U, 0x01U, 0x01U, 0x01U };
+
+
+		// ------------------------------------------------------------------------
+		// 2.1 Read a capture of a serial port and split it into SML files
+
+		// A capture file of the Ehz has a header and a record for each read call of the serial port.
+		// Only the received bytes are kept. A record, that has been cut off at the end of the file, is ignored
+		void extractReceivedBytes(std::vector<EhzDatabyte> &capture)
+		{
+			std::vector<EhzDatabyte> receivedBytes;
+			receivedBytes.reserve(capture.size());
+			size_t readPosition = SerialInternal::CaptureFileHeaderSize;
+			boolean recordIsComplete = true;
+			while (recordIsComplete && ((readPosition + SerialInternal::CaptureRecordHeaderSize) <= capture.size()))
+			{
+				// The record may be unaligned in the file. So the number is copied
+				uint numberOfBytes;
+				memcpy(&numberOfBytes, &capture[readPosition + sizeof(u64)], sizeof(numberOfBytes));
+				readPosition += SerialInternal::CaptureRecordHeaderSize;
+				recordIsComplete = ((readPosition + numberOfBytes) <= capture.size());
+				if (recordIsComplete)
+				{
+					receivedBytes.insert(receivedBytes.end(), capture.begin() + static_cast<std::ptrdiff_t>(readPosition), capture.begin() + static_cast<std::ptrdiff_t>(readPosition + numberOfBytes));
+					readPosition += numberOfBytes;
+				}
+			}
+			capture.swap(receivedBytes);
+		}
+
+		boolean loadCapture(const mchar *const fileName, Corpus &corpus)
+		{
+			std::ifstream captureFile(fileName, std::ios::binary);
+			const boolean rc = captureFile.is_open();
+			if (rc)
+			{
+				std::vector<EhzDatabyte> capture((std::istreambuf_iterator<mchar>(captureFile)), std::istreambuf_iterator<mchar>());
+				if ((capture.size() >= SerialInternal::CaptureFileHeaderSize) && (0 == memcmp(&capture[0], &SerialInternal::CaptureFileMagic[0], SerialInternal::CaptureFileHeaderSize)))
+				{
+					extractReceivedBytes(capture);
+				}
+				const std::vector<EhzDatabyte>::const_iterator captureBegin = capture.begin();
+				const std::vector<EhzDatabyte>::const_iterator captureEnd = capture.end();
+				const EhzDatabyte *const escStartSequenceEnd = &EscStartSequence[sizeof(EscStartSequence)];
+
+				corpus.name = fileName;
+				// Bytes before the first ESC start sequence belong to an incomplete SML file
+				std::vector<EhzDatabyte>::const_iterator smlFileStart = std::search(captureBegin, captureEnd, &EscStartSequence[0], escStartSequenceEnd);
+				while (captureEnd != smlFileStart)
+				{
+					const std::vector<EhzDatabyte>::const_iterator nextSmlFileStart = std::search(smlFileStart + 1, captureEnd, &EscStartSequence[0], escStartSequenceEnd);
+					corpus.smlFiles.push_back(SmlFileData(smlFileStart, nextSmlFileStart));
+					corpus.numberOfBytes += static_cast<u64>(nextSmlFileStart - smlFileStart);
+					smlFileStart = nextSmlFileStart;
+				}
+			}
+			return rc;
+		}
+
+
+		// ------------------------------------------------------------------------
+		// 2.2 Encoder for SML files
+		//
+		// Writes Type-Length fields, values and checksums. Only what is needed for the generated telegrams
+
+		class SmlFileWriter
+		{
+			public:
+				explicit SmlFileWriter(SmlFileData &sfd) : smlFileData(sfd), messageStart(null<size_t>()) { }
+
+				void put(const u8 databyte) { smlFileData.push_back(databyte); }
+				void optional(void) { put(0x01U); }
+				void list(const uint numberOfElements) { put(static_cast<u8>(0x70U | numberOfElements)); }
+				// Octet string. Type-Length field with 2 bytes, if the string is too long for 1 byte
+				void octets(const mchar *const octetString, const size_t length);
+				// Integer values, big endian. Type 0x50 is signed, type 0x60 is unsigned
+				void integer(const u8 type, const u64 value, const uint numberOfBytes);
+				void unsignedInteger(const u64 value, const uint numberOfBytes) { integer(0x60U, value, numberOfBytes); }
+				void signedInteger(const s64 value, const uint numberOfBytes) { integer(0x50U, static_cast<u64>(value), numberOfBytes); }
+
+				// Start of SML file and SML message and corresponding end with checksum
+				void beginSmlFile(void);
+				void beginMessage(const uint transactionId, const uint messageBodyTag);
+				void endMessage(void);
+				void endSmlFile(void);
+
+			protected:
+				void putCrc16(const crc16t crc16) { put(static_cast<u8>(crc16 >> 8U)); put(static_cast<u8>(crc16 & 0xFFU)); }
+				crc16t calculateCrc16(const size_t startPosition) const;
+
+				SmlFileData &smlFileData;
+				// Position of the first byte of the current SML message
+				size_t messageStart;
+			private:
+				SmlFileWriter(const SmlFileWriter &);
+				const SmlFileWriter &operator=(const SmlFileWriter &);
+		};
+
+		void SmlFileWriter::octets(const mchar *const octetString, const size_t length)
+		{
+			if (length < 15U)
+			{
+				put(static_cast<u8>(length + 1U));
+			}
+			else
+			{
+				// The length includes both bytes of the Type-Length field
+				const size_t lengthWithTl = length + 2U;
+				put(static_cast<u8>(0x80U | ((lengthWithTl >> 4U) & 0x0FU)));
+				put(static_cast<u8>(lengthWithTl & 0x0FU));
+			}
+			smlFileData.insert(smlFileData.end(), octetString, octetString + length);
+		}
+
+		void SmlFileWriter::integer(const u8 type, const u64 value, const uint numberOfBytes)
+		{
+			put(static_cast<u8>(type | (numberOfBytes + 1U)));
+			for (uint i = numberOfBytes; i > null<uint>(); --i)
+			{
+				put(static_cast<u8>((value >> (8U * (i - 1U))) & 0xFFU));
+			}
+		}
+
+		crc16t SmlFileWriter::calculateCrc16(const size_t startPosition) const
+		{
+			Crc16Calculator crc16Calculator;
+			crc16Calculator.start();
+			crc16Calculator.update(&smlFileData[startPosition], smlFileData.size() - startPosition);
+			return crc16Calculator.getResult();
+		}
+
+		void SmlFileWriter::beginSmlFile(void)
+		{
+			smlFileData.assign(&EscStartSequence[0], &EscStartSequence[sizeof(EscStartSequence)]);
+		}
+
+		// SmlMessage: transactionId, groupNo, abortOnError, messageBody (tag and body), crc16, endOfSmlMsg
+		void SmlFileWriter::beginMessage(const uint transactionId, const uint messageBodyTag)
+		{
+			messageStart = smlFileData.size();
+			list(6U);
+			const mchar transactionIdOctets[4] = { 0x3A, 0x00, static_cast<mchar>(transactionId >> 8U), static_cast<mchar>(transactionId & 0xFFU) };
+			octets(&transactionIdOctets[0], sizeof(transactionIdOctets));
+			unsignedInteger(null<u64>(), 1U);
+			unsignedInteger(null<u64>(), 1U);
+			list(2U);
+			unsignedInteger(messageBodyTag, 2U);
+		}
+
+		// The checksum covers the message from its first byte up to the end of the message body
+		void SmlFileWriter::endMessage(void)
+		{
+			const crc16t crc16 = calculateCrc16(messageStart);
+			put(0x63U);
+			putCrc16(crc16);
+			put(0x00U);
+		}
+
+		// Fill bytes up to a multiple of 4, ESC stop sequence and checksum over the complete SML file
+		void SmlFileWriter::endSmlFile(void)
+		{
+			const u8 numberOfFillBytes = static_cast<u8>((4U - (smlFileData.size() % 4U)) % 4U);
+			smlFileData.insert(smlFileData.end(), numberOfFillBytes, 0x00U);
+			for (uint i = null<uint>(); i < 4U; ++i)
+			{
+				put(0x1BU);
+			}
+			put(0x1AU);
+			put(numberOfFillBytes);
+			putCrc16(calculateCrc16(null<size_t>()));
+		}
+
+
+		// ------------------------------------------------------------------------
+		// 2.3 Generated telegrams for typical meters
+		//
+		// Each meter sends an OpenResponse, a GetListResponse with the values and a CloseResponse
+
+		namespace SmlValueType
+		{
+			enum Code { Text, Unsigned, Signed };
+		}
+
+		struct SmlListEntryDefinition
+		{
+			const mchar *objName;			// OBIS ID, 6 bytes
+			SmlValueType::Code valueType;
+			uint numberOfValueBytes;		// Numbers only. Text uses the length of the text
+			const mchar *text;				// Value for Text
+			u8 unit;						// 0 = no unit and no scaler
+			boolean hasStatusAndValTime;	// Status word and time of the value (newer meters)
+			u64 increment;					// Change of the value from one SML file to the next
+		};
+
+		struct MeterDefinition
+		{
+			const mchar *name;
+			const SmlListEntryDefinition *smlListEntryDefinition;
+			uint numberOfSmlListEntries;
+			boolean hasActSensorTime;
+		};
+
+		// Simple meter with manufacturer, ID, energy and power
+		const SmlListEntryDefinition basicMeter[] =
+		{
+			//lint --e{1901,1911,915}
+			{ "\x81\x81\xC7\x82\x03\xFF", SmlValueType::Text, 0U, "EMH", 0U, false, 0U },
+			{ "\x01\x00\x00\x00\x00\xFF", SmlValueType::Text, 0U, "\x06\x45\x4D\x48\x01\x02\x03\x04\x05\x06", 0U, false, 0U },
+			{ "\x01\x00\x01\x08\x00\xFF", SmlValueType::Unsigned, 8U, null<const mchar *>(), 0x1EU, false, 3U },
+			{ "\x01\x00\x01\x08\x01\xFF", SmlValueType::Unsigned, 8U, null<const mchar *>(), 0x1EU, false, 3U },
+			{ "\x01\x00\x01\x07\x01\xFF", SmlValueType::Signed, 4U, null<const mchar *>(), 0x1BU, false, 7U }
+		};
+
+		// Meter for consumption and production with 2 tariffs. Values have a status word and a time
+		const SmlListEntryDefinition twoTariffMeter[] =
+		{
+			//lint --e{1901,1911,915}
+			{ "\x81\x81\xC7\x82\x03\xFF", SmlValueType::Text, 0U, "ISK", 0U, false, 0U },
+			{ "\x01\x00\x00\x00\x09\xFF", SmlValueType::Text, 0U, "\x09\x01\x49\x53\x4B\x00\x04\x72\x81\x15", 0U, false, 0U },
+			{ "\x01\x00\x01\x08\x00\xFF", SmlValueType::Unsigned, 5U, null<const mchar *>(), 0x1EU, true, 5U },
+			{ "\x01\x00\x01\x08\x01\xFF", SmlValueType::Unsigned, 5U, null<const mchar *>(), 0x1EU, true, 5U },
+			{ "\x01\x00\x01\x08\x02\xFF", SmlValueType::Unsigned, 5U, null<const mchar *>(), 0x1EU, true, 0U },
+			{ "\x01\x00\x02\x08\x00\xFF", SmlValueType::Unsigned, 5U, null<const mchar *>(), 0x1EU, true, 2U },
+			{ "\x01\x00\x02\x08\x01\xFF", SmlValueType::Unsigned, 5U, null<const mchar *>(), 0x1EU, true, 2U },
+			{ "\x01\x00\x10\x07\x00\xFF", SmlValueType::Signed, 4U, null<const mchar *>(), 0x1BU, true, 11U }
+		};
+
+		// Three phase meter with power per phase, firmware version and a public key (2 byte Type-Length field)
+		const SmlListEntryDefinition threePhaseMeter[] =
+		{
+			//lint --e{1901,1911,915}
+			{ "\x81\x81\xC7\x82\x03\xFF", SmlValueType::Text, 0U, "EBZ", 0U, false, 0U },
+			{ "\x01\x00\x00\x00\x09\xFF", SmlValueType::Text, 0U, "\x09\x01\x45\x42\x5A\x01\x00\x0A\x1B\x2C", 0U, false, 0U },
+			{ "\x01\x00\x01\x08\x00\xFF", SmlValueType::Unsigned, 8U, null<const mchar *>(), 0x1EU, true, 9U },
+			{ "\x01\x00\x02\x08\x00\xFF", SmlValueType::Unsigned, 8U, null<const mchar *>(), 0x1EU, true, 1U },
+			{ "\x01\x00\x10\x07\x00\xFF", SmlValueType::Signed, 4U, null<const mchar *>(), 0x1BU, false, 13U },
+			{ "\x01\x00\x24\x07\x00\xFF", SmlValueType::Signed, 4U, null<const mchar *>(), 0x1BU, false, 5U },
+			{ "\x01\x00\x38\x07\x00\xFF", SmlValueType::Signed, 4U, null<const mchar *>(), 0x1BU, false, 3U },
+			{ "\x01\x00\x4C\x07\x00\xFF", SmlValueType::Signed, 4U, null<const mchar *>(), 0x1BU, false, 5U },
+			{ "\x01\x00\x20\x07\x00\xFF", SmlValueType::Unsigned, 2U, null<const mchar *>(), 0x23U, false, 1U },
+			{ "\x01\x00\x00\x02\x00\x00", SmlValueType::Text, 0U, "01.03.07", 0U, false, 0U },
+			{ "\x81\x81\xC7\x82\x05\xFF", SmlValueType::Text, 0U, "\x3D\x85\x1C\x72\xA0\x0E\x4B\x19\x66\xD2\x05\xE8\x91\x3F\x7A\xC4\x10\x5B\x88\x2E\xF1\x06\x9D\x34\xB7\x4A\x02\xE3\x58\xCA", 0U, false, 0U }
+		};
+
+		const MeterDefinition meterDefinition[] =
+		{
+			//lint --e{1901,1911,915}
+			{ "basic meter", &basicMeter[0], sizeof(basicMeter)/sizeof(basicMeter[0]), false },
+			{ "two tariff meter", &twoTariffMeter[0], sizeof(twoTariffMeter)/sizeof(twoTariffMeter[0]), true },
+			{ "three phase meter", &threePhaseMeter[0], sizeof(threePhaseMeter)/sizeof(threePhaseMeter[0]), true }
+		};
+
+		const uint NumberOfGeneratedSmlFiles = 256U;
+		const uint SmlMessageBodyTagOpenResponse = 0x0101U;
+		const uint SmlMessageBodyTagCloseResponse = 0x0201U;
+		const uint SmlMessageBodyTagGetListResponse = 0x0701U;
+		const mchar ServerId[10] = { 0x06, 0x45, 0x4D, 0x48, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 };
+		const mchar ListName[6] = { 0x01, 0x00, 0x62, 0x0A, static_cast<mchar>(0xFF), static_cast<mchar>(0xFF) };
+
+		// SmlTime as seconds index
+		void writeSecIndex(SmlFileWriter &smlFileWriter, const u64 secIndex)
+		{
+			smlFileWriter.list(2U);
+			smlFileWriter.unsignedInteger(1U, 1U);
+			smlFileWriter.unsignedInteger(secIndex, 4U);
+		}
+
+		void writeSmlListEntry(SmlFileWriter &smlFileWriter, const SmlListEntryDefinition &slde, const uint smlFileNumber)
+		{
+			const u64 secIndex = 0x01000000ULL + smlFileNumber;
+			smlFileWriter.list(7U);
+			smlFileWriter.octets(slde.objName, EhzInternal::ObisDataLength);
+			if (slde.hasStatusAndValTime)
+			{
+				smlFileWriter.unsignedInteger(0x1A2U, 3U);
+				writeSecIndex(smlFileWriter, secIndex);
+			}
+			else
+			{
+				smlFileWriter.optional();
+				smlFileWriter.optional();
+			}
+			if (null<u8>() != slde.unit)
+			{
+				smlFileWriter.unsignedInteger(slde.unit, 1U);
+				smlFileWriter.signedInteger(-1, 1U);
+			}
+			else
+			{
+				smlFileWriter.optional();
+				smlFileWriter.optional();
+			}
+			const u64 value = 12345U + (slde.increment * smlFileNumber);
+			switch (slde.valueType)
+			{
+				case SmlValueType::Unsigned:
+					smlFileWriter.unsignedInteger(value, slde.numberOfValueBytes);
+					break;
+				case SmlValueType::Signed:
+					smlFileWriter.signedInteger(static_cast<s64>(value), slde.numberOfValueBytes);
+					break;
+				case SmlValueType::Text:
+					//FALLTHROUGH
+				default:
+					smlFileWriter.octets(slde.text, strlen(slde.text));
+					break;
+			}
+			// No value signature
+			smlFileWriter.optional();
+		}
+
+		void generateSmlFile(const MeterDefinition &md, const uint smlFileNumber, SmlFileData &smlFileData)
+		{
+			SmlFileWriter smlFileWriter(smlFileData);
+			const uint transactionId = 3U * smlFileNumber;
+			const mchar requestFileId[4] = { 0x00, 0x10, static_cast<mchar>(smlFileNumber >> 8U), static_cast<mchar>(smlFileNumber & 0xFFU) };
+
+			smlFileWriter.beginSmlFile();
+
+			// OpenResponse: codepage, clientId, reqFileId, serverId, refTime, smlVersion
+			smlFileWriter.beginMessage(transactionId, SmlMessageBodyTagOpenResponse);
+			smlFileWriter.list(6U);
+			smlFileWriter.optional();
+			smlFileWriter.optional();
+			smlFileWriter.octets(&requestFileId[0], sizeof(requestFileId));
+			smlFileWriter.octets(&ServerId[0], sizeof(ServerId));
+			smlFileWriter.optional();
+			smlFileWriter.optional();
+			smlFileWriter.endMessage();
+
+			// GetListResponse: clientId, serverId, listName, actSensorTime, valList, listSignature, actGatewayTime
+			smlFileWriter.beginMessage(transactionId + 1U, SmlMessageBodyTagGetListResponse);
+			smlFileWriter.list(7U);
+			smlFileWriter.optional();
+			smlFileWriter.octets(&ServerId[0], sizeof(ServerId));
+			smlFileWriter.octets(&ListName[0], sizeof(ListName));
+			if (md.hasActSensorTime)
+			{
+				writeSecIndex(smlFileWriter, 0x01000000ULL + smlFileNumber);
+			}
+			else
+			{
+				smlFileWriter.optional();
+			}
+			smlFileWriter.list(md.numberOfSmlListEntries);
+			for (uint i = null<uint>(); i < md.numberOfSmlListEntries; ++i)
+			{
+				writeSmlListEntry(smlFileWriter, md.smlListEntryDefinition[i], smlFileNumber);
+			}
+			smlFileWriter.optional();
+			smlFileWriter.optional();
+			smlFileWriter.endMessage();
+
+			// CloseResponse: globalSignature
+			smlFileWriter.beginMessage(transactionId + 2U, SmlMessageBodyTagCloseResponse);
+			smlFileWriter.list(1U);
+			smlFileWriter.optional();
+			smlFileWriter.endMessage();
+
+			smlFileWriter.endSmlFile();
+		}
+
+		void generateCorpus(const MeterDefinition &md, Corpus &corpus)
+		{
+			corpus.name = md.name;
+			corpus.smlFiles.resize(NumberOfGeneratedSmlFiles);
+			for (uint smlFileNumber = null<uint>(); smlFileNumber < NumberOfGeneratedSmlFiles; ++smlFileNumber)
+			{
+				generateSmlFile(md, smlFileNumber, corpus.smlFiles[smlFileNumber]);
+				corpus.numberOfBytes += corpus.smlFiles[smlFileNumber].size();
+			}
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Stages of the input chain
+//
+// All stages have the same interface: "process" takes one SML file and returns the number of
+// SML files that have been completely recognised in the data (normally 1)
+
+	namespace ParserBenchmarkInternal
+	{
+		// ------------------------------------------------------------------------
+		// 3.1 ESC analysis. Byte by byte and with look ahead for net data
+
+		template <class EscAnalysisType>
+		class EscAnalysisStage
+		{
+			public:
+				EscAnalysisStage(void) : escAnalysis() {}
+				uint process(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes)
+				{
+					uint numberOfSmlFiles = null<uint>();
+					for (size_t i = null<size_t>(); i < numberOfBytes; ++i)
+					{
+						if (EscAnalysisResult::ESC_ANALYSIS_RESULT_STOP == escAnalysis.analyse(ehzDatabytes[i]))
+						{
+							++numberOfSmlFiles;
+						}
+					}
+					return numberOfSmlFiles;
+				}
+			protected:
+				EscAnalysisType escAnalysis;
+		};
+
+		template <class EscAnalysisType>
+		class EscAnalysisBlockStage : public EscAnalysisStage<EscAnalysisType>
+		{
+			public:
+				uint process(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes)
+				{
+					uint numberOfSmlFiles = null<uint>();
+					size_t i = null<size_t>();
+					while (i < numberOfBytes)
+					{
+						i += this->escAnalysis.analysePayload(&ehzDatabytes[i], numberOfBytes - i);
+						if (i < numberOfBytes)
+						{
+							if (EscAnalysisResult::ESC_ANALYSIS_RESULT_STOP == this->escAnalysis.analyse(ehzDatabytes[i]))
+							{
+								++numberOfSmlFiles;
+							}
+							++i;
+						}
+					}
+					return numberOfSmlFiles;
+				}
+		};
+
+
+		// ------------------------------------------------------------------------
+		// 3.2 Scanner. Byte by byte and block oriented in the same way as the parser uses it
+
+		template <class ScannerType>
+		class ScannerStage
+		{
+			public:
+				ScannerStage(void) : scanner() {}
+				uint process(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes)
+				{
+					uint numberOfSmlFiles = null<uint>();
+					for (size_t i = null<size_t>(); i < numberOfBytes; ++i)
+					{
+						if (Token::END_OF_SML_FILE == scanner.scan(ehzDatabytes[i]).getType())
+						{
+							++numberOfSmlFiles;
+						}
+					}
+					return numberOfSmlFiles;
+				}
+			protected:
+				ScannerType scanner;
+		};
+
+		template <class ScannerType>
+		class ScannerBlockStage : public ScannerStage<ScannerType>
+		{
+			public:
+				uint process(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes)
+				{
+					uint numberOfSmlFiles = null<uint>();
+					size_t numberOfPayloadBytes = null<size_t>();
+					size_t i = null<size_t>();
+					while (i < numberOfBytes)
+					{
+						if (null<size_t>() == numberOfPayloadBytes)
+						{
+							numberOfPayloadBytes = this->scanner.analysePayload(&ehzDatabytes[i], numberOfBytes - i);
+						}
+						if (numberOfPayloadBytes > null<size_t>())
+						{
+							size_t numberOfScannedBytes = null<size_t>();
+							//lint -e{534}
+							this->scanner.scanPayloadBlock(&ehzDatabytes[i], numberOfPayloadBytes, numberOfScannedBytes);
+							numberOfPayloadBytes -= numberOfScannedBytes;
+							i += numberOfScannedBytes;
+						}
+						else
+						{
+							if (Token::END_OF_SML_FILE == this->scanner.scan(ehzDatabytes[i]).getType())
+							{
+								++numberOfSmlFiles;
+							}
+							++i;
+						}
+					}
+					return numberOfSmlFiles;
+				}
+		};
+
+
+		// ------------------------------------------------------------------------
+		// 3.3 Parser. Evaluation of the values with a streaming visitor, like in the Ehz
+
+		class ParserStage
+		{
+			public:
+				ParserStage(void) : parser(), allMeasuredValuesForOneEhz(), smlListEntryEvaluation(EhzInternal::getEhzConfigDefinition(null<uint>()), &allMeasuredValuesForOneEhz)
+				{
+					parser.setStreamingVisitor(&smlListEntryEvaluation);
+				}
+				uint process(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes)
+				{
+					uint numberOfSmlFiles = null<uint>();
+					for (size_t i = null<size_t>(); i < numberOfBytes; ++i)
+					{
+						if (pr_DONE == parser.parse(ehzDatabytes[i], null<uint>()))
+						{
+							++numberOfSmlFiles;
+							parser.reset();
+						}
+					}
+					return numberOfSmlFiles;
+				}
+			protected:
+				Parser parser;
+				EhzInternal::AllMeasuredValuesForOneEhz allMeasuredValuesForOneEhz;
+				ParserInternal::SmlListEntryEvaluation smlListEntryEvaluation;
+			private:
+				ParserStage(const ParserStage &);
+				const ParserStage &operator=(const ParserStage &);
+		};
+
+		class ParserBlockStage : public ParserStage
+		{
+			public:
+				ParserBlockStage(void) : ParserStage(), parserBoundaryList() {}
+				uint process(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes)
+				{
+					uint numberOfSmlFiles = null<uint>();
+					size_t consumedBytes = null<size_t>();
+					while (consumedBytes < numberOfBytes)
+					{
+						consumedBytes += parser.parse(&ehzDatabytes[consumedBytes], numberOfBytes - consumedBytes, null<uint>(), parserBoundaryList);
+						for (ParserBoundaryList::const_iterator pbli = parserBoundaryList.begin(); pbli != parserBoundaryList.end(); ++pbli)
+						{
+							if (pr_DONE == pbli->parserResult)
+							{
+								++numberOfSmlFiles;
+								parser.reset();
+							}
+						}
+					}
+					return numberOfSmlFiles;
+				}
+			protected:
+				ParserBoundaryList parserBoundaryList;
+		};
+
+		// Everything is parsed dynamically. For comparison with the static parsing of the known message bodies
+		class ParserDynamicStage : public ParserStage
+		{
+			public:
+				ParserDynamicStage(void) : ParserStage() { parser.setStaticParsing(false); }
+		};
+
+		// Skip mode. Not configured list entries and the content of signatures and server IDs are skipped
+		class ParserSkipStage : public ParserStage
+		{
+			public:
+				ParserSkipStage(void) : ParserStage() { parser.setSkipMode(true, &smlListEntryEvaluation); }
+		};
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. Differential check of static and dynamic parsing
+//
+// The same data are parsed with static and dynamic parsing. A visitor records everything, that has been parsed,
+// together with the parse results. The records must be identical. This is done for the unchanged SML files and for
+// copies, where one byte has been replaced by another value. So also the error handling is compared
+//
+// In skip mode, the parser does not check the skipped elements against the grammar. So errors may be found later.
+// But for each recognised SML file, the measured values must be the same as without skip mode
+
+	namespace ParserBenchmarkInternal
+	{
+		// Number of SML files of a corpus, in which every byte will be replaced
+		const size_t NumberOfChangedSmlFiles = 4U;
+		// Replacement values: List, optional, end of message and unsigned 8
+		const EhzDatabyte ReplacementDatabyte[] = { 0x72U, 0x01U, 0x00U, 0x62U };
+
+		//lint -e{1790}
+		class ParseTreeRecorder : public ParserInternal::VisitorForSmlListEntry,
+								  public Visitor<ParserInternal::SmlPublicOpenResponse>,
+								  public Visitor<ParserInternal::SmlGetListResponse>,
+								  public Visitor<ParserInternal::SmlPublicCloseResponse>
+		{
+			public:
+				ParseTreeRecorder(void) : VisitorForSmlListEntry(), record() {}
+				virtual ~ParseTreeRecorder(void) {}
+
+				virtual void visit(ParserInternal::SmlListEntry &smlListEntry)
+				{
+					record << "E " << convertSmlByteStringToHex(smlListEntry.objName.value) << ' ' << smlListEntry.status.isOptional << ' ' << smlListEntry.status.value
+						   << ' ' << smlListEntry.valTime.optionalValueRead << ' ' << smlListEntry.unit.isOptional << ' ' << static_cast<uint>(smlListEntry.unit.value)
+						   << ' ' << smlListEntry.scaler.isOptional << ' ' << static_cast<sint>(smlListEntry.scaler.value) << ' ' << static_cast<uint>(smlListEntry.value.token.getType())
+						   << ' ' << smlListEntry.value.value << ' ' << convertSmlByteStringToHex(smlListEntry.value.sbs) << ' ' << smlListEntry.valueSignature.isOptional << '\n';
+				}
+				virtual void visit(ParserInternal::SmlPublicOpenResponse &smlPublicOpenResponse)
+				{
+					record << "O " << convertSmlByteStringToHex(smlPublicOpenResponse.reqFileId.value) << ' ' << convertSmlByteStringToHex(smlPublicOpenResponse.serverId.value)
+						   << ' ' << smlPublicOpenResponse.refTime.optionalValueRead << '\n';
+				}
+				virtual void visit(ParserInternal::SmlGetListResponse &smlGetListResponse)
+				{
+					record << "L " << convertSmlByteStringToHex(smlGetListResponse.serverID.value) << ' ' << smlGetListResponse.listName.isOptional
+						   << ' ' << smlGetListResponse.actSensorTime.optionalValueRead << ' ' << smlGetListResponse.actGatewayTime.optionalValueRead << '\n';
+				}
+				virtual void visit(ParserInternal::SmlPublicCloseResponse &smlPublicCloseResponse)
+				{
+					record << "C " << smlPublicCloseResponse.globalSignature.isOptional << '\n';
+				}
+				std::ostringstream record;
+		};
+
+		// Parse the data byte by byte. Record the parse results. Without streaming, the complete parse tree is recorded after pr_DONE
+		std::string recordParsing(const SmlFileData &smlFileData, const boolean staticParsing, const boolean streaming)
+		{
+			Parser parser;
+			ParseTreeRecorder parseTreeRecorder;
+			parser.setStaticParsing(staticParsing);
+			parser.setStreamingVisitor(streaming ? &parseTreeRecorder : null<ParseTreeRecorder *>());
+			for (size_t i = null<size_t>(); i < smlFileData.size(); ++i)
+			{
+				const prCode pr = parser.parse(smlFileData[i], null<uint>());
+				if (pr_PROCESSING != pr)
+				{
+					parseTreeRecorder.record << "R " << i << ' ' << static_cast<sint>(pr) << '\n';
+				}
+				if (pr_DONE == pr)
+				{
+					if (!streaming)
+					{
+						parser.traverseAndEvaluate(&parseTreeRecorder);
+					}
+					parser.reset();
+				}
+			}
+			return parseTreeRecorder.record.str();
+		}
+
+		boolean isParsingEqual(const SmlFileData &smlFileData)
+		{
+			return (recordParsing(smlFileData, true, true) == recordParsing(smlFileData, false, true))
+				&& (recordParsing(smlFileData, true, false) == recordParsing(smlFileData, false, false));
+		}
+
+		// Compares two implementations for the given data. Returns false, if they have different results
+		typedef boolean (*IsEqualFunction)(const SmlFileData &smlFileData);
+
+		// All SML files of the corpus in one piece
+		void concatenateSmlFiles(const Corpus &corpus, SmlFileData &allSmlFiles)
+		{
+			for (std::vector<SmlFileData>::const_iterator sfdi = corpus.smlFiles.begin(); sfdi != corpus.smlFiles.end(); ++sfdi)
+			{
+				allSmlFiles.insert(allSmlFiles.end(), sfdi->begin(), sfdi->end());
+			}
+		}
+
+		// Compare the complete corpus and then copies of the first SML files, where one byte has been replaced.
+		// The following SML file shows, that both find the next SML file in the same way. Returns the number of differences
+		uint compareUnchangedAndChangedSmlFiles(const Corpus &corpus, const EhzDatabyte *const replacementDatabyte, const uint numberOfReplacementDatabytes,
+												const IsEqualFunction isEqual, uint &numberOfComparisons)
+		{
+			uint numberOfDifferences = null<uint>();
+			SmlFileData allSmlFiles;
+			concatenateSmlFiles(corpus, allSmlFiles);
+			numberOfDifferences += isEqual(allSmlFiles) ? null<uint>() : 1U;
+			++numberOfComparisons;
+
+			const size_t numberOfChangedSmlFiles = std::min(NumberOfChangedSmlFiles, corpus.smlFiles.size());
+			for (size_t smlFileIndex = null<size_t>(); smlFileIndex < numberOfChangedSmlFiles; ++smlFileIndex)
+			{
+				const SmlFileData &smlFileData = corpus.smlFiles[smlFileIndex];
+				const SmlFileData &nextSmlFileData = corpus.smlFiles[(smlFileIndex + 1U) % corpus.smlFiles.size()];
+				SmlFileData changedSmlFileData(smlFileData);
+				changedSmlFileData.insert(changedSmlFileData.end(), nextSmlFileData.begin(), nextSmlFileData.end());
+				for (size_t i = null<size_t>(); i < smlFileData.size(); ++i)
+				{
+					for (uint r = null<uint>(); r < numberOfReplacementDatabytes; ++r)
+					{
+						if (replacementDatabyte[r] != smlFileData[i])
+						{
+							changedSmlFileData[i] = replacementDatabyte[r];
+							numberOfDifferences += isEqual(changedSmlFileData) ? null<uint>() : 1U;
+							++numberOfComparisons;
+						}
+					}
+					changedSmlFileData[i] = smlFileData[i];
+				}
+			}
+			return numberOfDifferences;
+		}
+
+		// Returns false, if static and dynamic parsing have different results
+		boolean compareStaticAndDynamicParsing(const Corpus &corpus)
+		{
+			uint numberOfComparisons = null<uint>();
+			const uint numberOfDifferences = compareUnchangedAndChangedSmlFiles(corpus, &ReplacementDatabyte[0], sizeof(ReplacementDatabyte) / sizeof(ReplacementDatabyte[0]),
+																				&isParsingEqual, numberOfComparisons);
+			std::cout << std::left << std::setw(22) << corpus.name.substr(0U, 21U) << "Static and dynamic parsing: " << numberOfComparisons << " comparisons, "
+					  << numberOfDifferences << " differences" << '\n';
+			return null<uint>() == numberOfDifferences;
+		}
+
+		// Parse the data byte by byte with the evaluation of the Ehz. Record the measured values after each recognised SML file.
+		// Not the time of the evaluation. It depends on the clock
+		std::string recordMeasuredValues(const SmlFileData &smlFileData, const boolean skipMode)
+		{
+			Parser parser;
+			EhzInternal::AllMeasuredValuesForOneEhz allMeasuredValuesForOneEhz;
+			ParserInternal::SmlListEntryEvaluation smlListEntryEvaluation(EhzInternal::getEhzConfigDefinition(null<uint>()), &allMeasuredValuesForOneEhz);
+			std::ostringstream record;
+			parser.setStreamingVisitor(&smlListEntryEvaluation);
+			parser.setSkipMode(skipMode, &smlListEntryEvaluation);
+			for (size_t i = null<size_t>(); i < smlFileData.size(); ++i)
+			{
+				if (pr_DONE == parser.parse(smlFileData[i], null<uint>()))
+				{
+					record << "R " << i;
+					for (uint valueIndex = null<uint>(); valueIndex < NumberOfEhzMeasuredData; ++valueIndex)
+					{
+						record << ' ' << allMeasuredValuesForOneEhz.measuredValueForOneEhz[valueIndex];
+					}
+					record << '\n';
+					parser.reset();
+				}
+			}
+			return record.str();
+		}
+
+		// Returns false, if the skip mode produced other measured values
+		boolean compareSkipModeAndNormalParsing(const Corpus &corpus)
+		{
+			SmlFileData allSmlFiles;
+			concatenateSmlFiles(corpus, allSmlFiles);
+			const boolean isEqual = (recordMeasuredValues(allSmlFiles, true) == recordMeasuredValues(allSmlFiles, false));
+			std::cout << std::left << std::setw(22) << corpus.name.substr(0U, 21U) << "Skip mode and normal parsing: " << (isEqual ? "same" : "different") << " measured values" << '\n';
+			return isEqual;
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 5. Differential check of the reference and the switch based scanner
+//
+// Both scanners get the same data. Every produced token is recorded with its position, type, length and value.
+// The token streams must be identical. Byte by byte with "scan" and block oriented with "analysePayload" and
+// "scanPayloadBlock", as the parser uses it. Again for the unchanged SML files and for copies with one changed byte
+
+	namespace ParserBenchmarkInternal
+	{
+		// Position of the last byte of the token and everything, that the token carries
+		void recordToken(std::ostringstream &record, const size_t index, const Token &token)
+		{
+			record << "T " << index << ' ' << static_cast<uint>(token.getType()) << ' ' << static_cast<uint>(token.getLength());
+			//lint -e{788}
+			switch (token.getType())
+			{
+				case Token::BOOLEAN:
+					record << ' ' << token.getBoolValue();
+					break;
+				case Token::SIGNED_INTEGER:
+					record << ' ' << token.getS64Value();
+					break;
+				case Token::UNSIGNED_INTEGER:
+					record << ' ' << token.getU64Value();
+					break;
+				case Token::OCTET:
+				{
+					SmlByteString smlByteString;
+					token.getValueForType(&smlByteString);
+					record << ' ' << convertSmlByteStringToHex(smlByteString) << ' ' << token.isByteStringTruncated();
+					break;
+				}
+				case Token::END_OF_SML_FILE:
+				{
+					EscSmlFileEndData escSmlFileEndData;
+					token.getEscSmlFileEndData(escSmlFileEndData);
+					record << ' ' << escSmlFileEndData.crc16FromEscStop << ' ' << escSmlFileEndData.crc16Calculated << ' ' << static_cast<uint>(escSmlFileEndData.numberOfFillBytes);
+					break;
+				}
+				default:
+					break;
+			}
+			record << '\n';
+		}
+
+		// Scan the data byte by byte or block oriented like in ScannerBlockStage. Record every produced token
+		template <class ScannerType>
+		std::string recordScanning(const SmlFileData &smlFileData, const boolean blockMode)
+		{
+			ScannerType scanner;
+			std::ostringstream record;
+			size_t numberOfPayloadBytes = null<size_t>();
+			size_t i = null<size_t>();
+			while (i < smlFileData.size())
+			{
+				if (blockMode && (null<size_t>() == numberOfPayloadBytes))
+				{
+					numberOfPayloadBytes = scanner.analysePayload(&smlFileData[i], smlFileData.size() - i);
+				}
+				const Token *token;
+				if (numberOfPayloadBytes > null<size_t>())
+				{
+					size_t numberOfScannedBytes = null<size_t>();
+					token = &scanner.scanPayloadBlock(&smlFileData[i], numberOfPayloadBytes, numberOfScannedBytes);
+					numberOfPayloadBytes -= numberOfScannedBytes;
+					i += numberOfScannedBytes;
+				}
+				else
+				{
+					token = &scanner.scan(smlFileData[i]);
+					++i;
+				}
+				if (Token::CONDITION_NOT_YET_DETECTED != token->getType())
+				{
+					recordToken(record, i - 1U, *token);
+				}
+			}
+			return record.str();
+		}
+
+		// The reference scanner fed byte by byte is the reference for all others
+		boolean isScanningEqual(const SmlFileData &smlFileData)
+		{
+			const std::string reference = recordScanning<Scanner>(smlFileData, false);
+			return (reference == recordScanning<Scanner>(smlFileData, true))
+				&& (reference == recordScanning<ScannerSwitchBased>(smlFileData, false))
+				&& (reference == recordScanning<ScannerSwitchBased>(smlFileData, true));
+		}
+
+		// Returns false, if the switch based scanner produced other tokens than the reference scanner
+		boolean compareReferenceAndSwitchBasedScanner(const Corpus &corpus)
+		{
+			uint numberOfComparisons = null<uint>();
+			const uint numberOfDifferences = compareUnchangedAndChangedSmlFiles(corpus, &ReplacementDatabyte[0], sizeof(ReplacementDatabyte) / sizeof(ReplacementDatabyte[0]),
+																				&isScanningEqual, numberOfComparisons);
+			std::cout << std::left << std::setw(22) << corpus.name.substr(0U, 21U) << "Reference and switch based scanner: " << numberOfComparisons << " comparisons, "
+					  << numberOfDifferences << " differences" << '\n';
+			return null<uint>() == numberOfDifferences;
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 6. Differential check of the reference and the table driven ESC analysis
+//
+// Both ESC analyses get the same data. The result code of every byte is recorded. At each ESC-Stop and at each
+// checksum mismatch also the checksum from the ESC-Stop, the calculated checksum and the number of fill bytes.
+// The table driven ESC analysis is fed byte by byte and with the look ahead of "analysePayload". Bytes, that
+// have been consumed by the look ahead, count as ESC_CONDITION_WAITING. The records must be identical.
+//
+// This is done for the unchanged SML files, for copies with one changed byte and for fuzzed data. For the fuzzing,
+// 2 SML files are changed randomly: ESC runs and ESC sequences are inserted, bytes are replaced or removed and
+// the fill byte of the ESC-Stop is changed with a correct checksum. The random numbers are always the same
+
+	namespace ParserBenchmarkInternal
+	{
+		// Replacement values: ESC, start, stop and fill byte
+		const EhzDatabyte EscReplacementDatabyte[] = { 0x1BU, 0x01U, 0x1AU, 0x00U };
+		// Number of fuzzed data per corpus and maximum number of changes in one of them
+		const uint NumberOfFuzzedSmlFiles = 2000U;
+		const uint MaxNumberOfFuzzChanges = 4U;
+
+		// Record the result code of every byte and the data of every ESC-Stop and checksum mismatch
+		template <class EscAnalysisType>
+		std::string recordEscAnalysis(const SmlFileData &smlFileData, const boolean blockMode)
+		{
+			EscAnalysisType escAnalysis;
+			std::ostringstream record;
+			u64 numberOfCrc16Mismatches = null<u64>();
+			size_t i = null<size_t>();
+			while (i < smlFileData.size())
+			{
+				if (blockMode)
+				{
+					const size_t numberOfPayloadBytes = escAnalysis.analysePayload(&smlFileData[i], smlFileData.size() - i);
+					record << std::string(numberOfPayloadBytes, static_cast<mchar>('0' + static_cast<sint>(EscAnalysisResult::ESC_CONDITION_WAITING)));
+					i += numberOfPayloadBytes;
+				}
+				if (i < smlFileData.size())
+				{
+					const EscAnalysisResult::Code escAnalysisResultCode = escAnalysis.analyse(smlFileData[i]);
+					record << static_cast<mchar>('0' + static_cast<sint>(escAnalysisResultCode));
+					if ((EscAnalysisResult::ESC_ANALYSIS_RESULT_STOP == escAnalysisResultCode)
+						|| (numberOfCrc16Mismatches != escAnalysis.getEscAnalysisStatistics().numberOfCrc16Mismatches))
+					{
+						const EscSmlFileEndData &escSmlFileEndData = escAnalysis.getLastEscFileEndData();
+						record << " E " << i << ' ' << escSmlFileEndData.crc16FromEscStop << ' ' << escSmlFileEndData.crc16Calculated
+							   << ' ' << static_cast<uint>(escSmlFileEndData.numberOfFillBytes) << '\n';
+						numberOfCrc16Mismatches = escAnalysis.getEscAnalysisStatistics().numberOfCrc16Mismatches;
+					}
+					++i;
+				}
+			}
+			record << " S " << escAnalysis.getEscAnalysisStatistics().numberOfEscFrames << ' ' << numberOfCrc16Mismatches << '\n';
+			return record.str();
+		}
+
+		// The reference ESC analysis is the reference for the table driven one
+		boolean isEscAnalysisEqual(const SmlFileData &smlFileData)
+		{
+			const std::string reference = recordEscAnalysis<EscAnalysis>(smlFileData, false);
+			return (reference == recordEscAnalysis<EscAnalysisTableDriven>(smlFileData, false))
+				&& (reference == recordEscAnalysis<EscAnalysisTableDriven>(smlFileData, true));
+		}
+
+		// Linear congruential generator. Fuzzing shall be reproducible
+		uint getRandomNumber(u32 &seed, const uint limit)
+		{
+			seed = (seed * 1664525UL) + 1013904223UL;
+			return static_cast<uint>(seed >> 16U) % limit;
+		}
+
+		// One random change of the data
+		void fuzzSmlFileData(SmlFileData &smlFileData, u32 &seed)
+		{
+			const EhzDatabyte escSequence[3][5] = { { 0x1BU, 0x1BU, 0x1BU, 0x1BU, 0x01U }, { 0x1BU, 0x1BU, 0x1BU, 0x1BU, 0x1BU }, { 0x1BU, 0x1BU, 0x1BU, 0x1BU, 0x1AU } };
+			const size_t position = getRandomNumber(seed, static_cast<uint>(smlFileData.size()));
+			const SmlFileData::iterator changedDatabyte = smlFileData.begin() + static_cast<std::ptrdiff_t>(position);
+			const size_t numberOfFollowingBytes = smlFileData.size() - position;
+			switch (getRandomNumber(seed, 6U))
+			{
+				case 0U:	// Any byte value
+					*changedDatabyte = static_cast<EhzDatabyte>(getRandomNumber(seed, 256U));
+					break;
+				case 1U:	// Value that is meaningful for the ESC analysis
+					*changedDatabyte = EscReplacementDatabyte[getRandomNumber(seed, sizeof(EscReplacementDatabyte) / sizeof(EscReplacementDatabyte[0]))];
+					break;
+				case 2U:	// Run of 1 to 9 ESC
+					//lint -e{534}
+					smlFileData.insert(changedDatabyte, static_cast<size_t>(getRandomNumber(seed, 9U) + 1U), 0x1BU);
+					break;
+				case 3U:	// ESC sequence with 3 random bytes. ESC-Start, escaped ESC and ESC-Stop with fill byte and checksum
+				{
+					const uint sequenceType = getRandomNumber(seed, 3U);
+					SmlFileData sequence(&escSequence[sequenceType][0], &escSequence[sequenceType][5]);
+					for (uint i = null<uint>(); i < 3U; ++i)
+					{
+						sequence.push_back((0U == sequenceType) ? 0x01U : static_cast<EhzDatabyte>(getRandomNumber(seed, 256U)));
+					}
+					smlFileData.insert(changedDatabyte, sequence.begin(), sequence.end());
+					break;
+				}
+				case 4U:	// Remove up to 8 bytes
+					//lint -e{534}
+					smlFileData.erase(changedDatabyte, changedDatabyte + static_cast<std::ptrdiff_t>(std::min(numberOfFollowingBytes, static_cast<size_t>(getRandomNumber(seed, 8U) + 1U))));
+					break;
+				default:	// Other fill byte in the first ESC-Stop after the position. The checksum is correct
+				{
+					const EhzDatabyte *const escStopSequence = &escSequence[2][0];
+					const SmlFileData::iterator escStop = std::search(changedDatabyte, smlFileData.end(), escStopSequence, escStopSequence + 5);
+					if (std::distance(escStop, smlFileData.end()) >= 8)
+					{
+						escStop[5] = static_cast<EhzDatabyte>(getRandomNumber(seed, 4U));
+						Crc16Calculator crc16Calculator;
+						crc16Calculator.start();
+						crc16Calculator.update(&smlFileData[0], static_cast<size_t>(std::distance(smlFileData.begin(), escStop)) + 6U);
+						const crc16t crc16 = crc16Calculator.getResult();
+						escStop[6] = static_cast<EhzDatabyte>(crc16 >> 8U);
+						escStop[7] = static_cast<EhzDatabyte>(crc16 & 0xFFU);
+					}
+					break;
+				}
+			}
+		}
+
+		// Returns false, if the table driven ESC analysis has other results than the reference
+		boolean compareReferenceAndTableDrivenEscAnalysis(const Corpus &corpus)
+		{
+			uint numberOfComparisons = null<uint>();
+			uint numberOfDifferences = compareUnchangedAndChangedSmlFiles(corpus, &EscReplacementDatabyte[0], sizeof(EscReplacementDatabyte) / sizeof(EscReplacementDatabyte[0]),
+																		  &isEscAnalysisEqual, numberOfComparisons);
+			u32 seed = 1U;
+			for (uint fuzzIndex = null<uint>(); fuzzIndex < NumberOfFuzzedSmlFiles; ++fuzzIndex)
+			{
+				const SmlFileData &smlFileData = corpus.smlFiles[fuzzIndex % corpus.smlFiles.size()];
+				const SmlFileData &nextSmlFileData = corpus.smlFiles[(fuzzIndex + 1U) % corpus.smlFiles.size()];
+				SmlFileData fuzzedSmlFileData(smlFileData);
+				fuzzedSmlFileData.insert(fuzzedSmlFileData.end(), nextSmlFileData.begin(), nextSmlFileData.end());
+				const uint numberOfFuzzChanges = getRandomNumber(seed, MaxNumberOfFuzzChanges) + 1U;
+				for (uint i = null<uint>(); (i < numberOfFuzzChanges) && !fuzzedSmlFileData.empty(); ++i)
+				{
+					fuzzSmlFileData(fuzzedSmlFileData, seed);
+				}
+				numberOfDifferences += isEscAnalysisEqual(fuzzedSmlFileData) ? null<uint>() : 1U;
+				++numberOfComparisons;
+			}
+			std::cout << std::left << std::setw(22) << corpus.name.substr(0U, 21U) << "Reference and table driven ESC analysis: " << numberOfComparisons << " comparisons, "
+					  << numberOfDifferences << " differences" << '\n';
+			return null<uint>() == numberOfDifferences;
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 7. Check of the timing wheel
+//
+// A periodic timer and a one shot timer are started. The one shot timer expires after the first and before the second
+// period. When the periodic timer is started again, the timerfd must still wake up for the one shot timer
+
+	namespace ParserBenchmarkInternal
+	{
+		const u32 PeriodicTimerInMs = 200UL;
+		const u32 OneShotTimerInMs = 260UL;
+		// Some ticks of the wheel (10ms) for a busy machine
+		const u64 MaxTimerDelayInMs = 50ULL;
+		// Long enough for the one shot timer, even if it wrongly waits for the second period
+		const u32 TimingWheelCheckDurationInMs = 3UL * PeriodicTimerInMs;
+		// The timers run in an own reactor thread. The benchmark has no other reactor threads
+		const uint TimingWheelCheckReactorIndex = 1U;
+
+		// The timers are started in the reactor thread. Its event loop is left with stop
+		class TimingWheelCheck : public ReactorInternal::ReactorThread, public Subscriber<EventTimer>
+		{
+			public:
+				TimingWheelCheck(void) : ReactorInternal::ReactorThread(TimingWheelCheckReactorIndex), Subscriber<EventTimer>(), periodicTimer(PeriodicTimerInMs),
+										 oneShotTimer(OneShotTimerInMs), startTimeInMs(null<u64>()), oneShotTimerExpiryTimeInMs(null<u64>()) {}
+				virtual ~TimingWheelCheck(void) {}
+
+				virtual void update(EventTimer *eventTimer)
+				{
+					if (&oneShotTimer == eventTimer)
+					{
+						oneShotTimerExpiryTimeInMs = MetricsInternal::getMonotonicTimeInNs() / 1000000ULL;
+					}
+				}
+				// Time from the start until the one shot timer expired. 0, if it did not expire. Valid after stop
+				u64 getOneShotTimerDelayInMs(void) const { return (null<u64>() == oneShotTimerExpiryTimeInMs) ? null<u64>() : (oneShotTimerExpiryTimeInMs - startTimeInMs); }
+
+			protected:
+				virtual void initialize(void)
+				{
+					periodicTimer.addSubscription(this);
+					oneShotTimer.addSubscription(this);
+					startTimeInMs = MetricsInternal::getMonotonicTimeInNs() / 1000000ULL;
+					periodicTimer.startTimerPeriodic();
+					oneShotTimer.startTimerOneShot();
+				}
+				virtual void finalize(void)
+				{
+					periodicTimer.stopTimer();
+					oneShotTimer.stopTimer();
+					periodicTimer.removeSubscription(this);
+					oneShotTimer.removeSubscription(this);
+				}
+
+				EventTimer periodicTimer;
+				EventTimer oneShotTimer;
+				u64 startTimeInMs;
+				u64 oneShotTimerExpiryTimeInMs;
+			private:
+				// No copies
+				TimingWheelCheck(const TimingWheelCheck &);
+				TimingWheelCheck &operator =(const TimingWheelCheck &);
+		};
+
+		// Returns false, if the one shot timer expired too late or not at all
+		boolean checkTimingWheel(void)
+		{
+			TimingWheelCheck timingWheelCheck;
+			boolean rc = timingWheelCheck.start();
+			if (rc)
+			{
+				//lint -e{534}
+				usleep(TimingWheelCheckDurationInMs * 1000UL);
+				timingWheelCheck.stop();
+				const u64 oneShotTimerDelayInMs = timingWheelCheck.getOneShotTimerDelayInMs();
+				rc = (null<u64>() != oneShotTimerDelayInMs) && (oneShotTimerDelayInMs <= (OneShotTimerInMs + MaxTimerDelayInMs));
+				std::cout << "Timing wheel: One shot timer of " << OneShotTimerInMs << "ms beside a periodic timer of " << PeriodicTimerInMs << "ms expired after "
+						  << oneShotTimerDelayInMs << "ms" << '\n';
+			}
+			else
+			{
+				std::cout << "Timing wheel: Reactor thread could not be started" << '\n';
+			}
+			return rc;
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 8. Measurement and report
+
+	namespace ParserBenchmarkInternal
+	{
+		struct StageResult
+		{
+			StageResult(void) : numberOfBytes(null<u64>()), numberOfSmlFiles(null<u64>()), numberOfRecognisedSmlFiles(null<u64>()),
+								numberOfAllocations(null<u64>()), durationInNs(null<u64>()), durationPerSmlFileInNs() {}
+			u64 numberOfBytes;
+			u64 numberOfSmlFiles;
+			u64 numberOfRecognisedSmlFiles;
+			u64 numberOfAllocations;
+			u64 durationInNs;
+			std::vector<u64> durationPerSmlFileInNs;
+		};
+
+		// Feed all SML files of the corpus "iterations" times into a fresh instance of the stage.
+		// Allocations done by the benchmark itself are not counted
+		template <class Stage>
+		void measureStage(const Corpus &corpus, const uint iterations, StageResult &stageResult)
+		{
+			Stage stage;
+			const size_t numberOfSmlFiles = corpus.smlFiles.size();
+			stageResult.durationPerSmlFileInNs.reserve(numberOfSmlFiles * iterations);
+			for (uint iteration = null<uint>(); iteration < iterations; ++iteration)
+			{
+				for (size_t smlFileIndex = null<size_t>(); smlFileIndex < numberOfSmlFiles; ++smlFileIndex)
+				{
+					const SmlFileData &smlFileData = corpus.smlFiles[smlFileIndex];
+					const u64 numberOfAllocationsBefore = numberOfAllocations;
+					const u64 startTimeInNs = MetricsInternal::getMonotonicTimeInNs();
+
+					stageResult.numberOfRecognisedSmlFiles += stage.process(&smlFileData[0], smlFileData.size());
+
+					const u64 durationInNs = MetricsInternal::getMonotonicTimeInNs() - startTimeInNs;
+					stageResult.numberOfAllocations += numberOfAllocations - numberOfAllocationsBefore;
+					stageResult.durationInNs += durationInNs;
+					stageResult.durationPerSmlFileInNs.push_back(durationInNs);
+				}
+			}
+			stageResult.numberOfBytes = corpus.numberOfBytes * iterations;
+			stageResult.numberOfSmlFiles = numberOfSmlFiles * iterations;
+		}
+
+		void printHeader(void)
+		{
+			std::cout << std::left << std::setw(22) << "Corpus" << std::setw(34) << "Stage" << std::right
+					  << std::setw(10) << "MB/s" << std::setw(12) << "Files/s" << std::setw(13) << "Allocs/File"
+					  << std::setw(10) << "p99 us" << std::setw(12) << "Recognised" << '\n';
+		}
+
+		void printStageResult(const std::string &corpusName, const mchar *const stageName, StageResult &stageResult)
+		{
+			std::vector<u64> &duration = stageResult.durationPerSmlFileInNs;
+			const mdouble durationInNs = static_cast<mdouble>(std::max(stageResult.durationInNs, static_cast<u64>(1U)));
+			const mdouble numberOfSmlFiles = static_cast<mdouble>(std::max(stageResult.numberOfSmlFiles, static_cast<u64>(1U)));
+			mdouble p99InUs = 0.0;
+			if (!duration.empty())
+			{
+				const size_t p99Index = (duration.size() * 99U) / 100U;
+				std::nth_element(duration.begin(), duration.begin() + static_cast<std::ptrdiff_t>(p99Index), duration.end());
+				p99InUs = static_cast<mdouble>(duration[p99Index]) / 1000.0;
+			}
+			std::ostringstream recognised;
+			recognised << stageResult.numberOfRecognisedSmlFiles << '/' << stageResult.numberOfSmlFiles;
+
+			std::cout << std::left << std::setw(22) << corpusName.substr(0U, 21U) << std::setw(34) << stageName << std::right << std::fixed
+					  << std::setw(10) << std::setprecision(1) << ((static_cast<mdouble>(stageResult.numberOfBytes) * 1000.0) / durationInNs)
+					  << std::setw(12) << std::setprecision(0) << ((numberOfSmlFiles * 1.0e9) / durationInNs)
+					  << std::setw(13) << std::setprecision(2) << (static_cast<mdouble>(stageResult.numberOfAllocations) / numberOfSmlFiles)
+					  << std::setw(10) << std::setprecision(2) << p99InUs
+					  << std::setw(12) << recognised.str() << '\n';
+		}
+
+		// Returns false, if the stage did not recognise every SML file. That is a regression
+		template <class Stage>
+		boolean runStage(const Corpus &corpus, const uint iterations, const mchar *const stageName)
+		{
+			StageResult stageResult;
+			measureStage<Stage>(corpus, iterations, stageResult);
+			printStageResult(corpus.name, stageName, stageResult);
+			return stageResult.numberOfRecognisedSmlFiles == stageResult.numberOfSmlFiles;
+		}
+
+		boolean runAllStages(const Corpus &corpus, const uint iterations)
+		{
+			boolean rc = true;
+			rc = runStage<EscAnalysisStage<EscAnalysis> >(corpus, iterations, "EscAnalysis (state) bytes") && rc;
+			rc = runStage<EscAnalysisStage<EscAnalysisTableDriven> >(corpus, iterations, "EscAnalysisTableDriven bytes") && rc;
+			rc = runStage<EscAnalysisBlockStage<EscAnalysisTableDriven> >(corpus, iterations, "EscAnalysisTableDriven block") && rc;
+			rc = runStage<ScannerStage<Scanner> >(corpus, iterations, "Scanner (state) bytes") && rc;
+			rc = runStage<ScannerBlockStage<Scanner> >(corpus, iterations, "Scanner (state) block") && rc;
+			rc = runStage<ScannerStage<ScannerSwitchBased> >(corpus, iterations, "ScannerSwitchBased bytes") && rc;
+			rc = runStage<ScannerBlockStage<ScannerSwitchBased> >(corpus, iterations, "ScannerSwitchBased block") && rc;
+			rc = runStage<ParserStage>(corpus, iterations, "Parser bytes") && rc;
+			rc = runStage<ParserBlockStage>(corpus, iterations, "Parser block") && rc;
+			rc = runStage<ParserDynamicStage>(corpus, iterations, "Parser dynamic parsing bytes") && rc;
+			rc = runStage<ParserSkipStage>(corpus, iterations, "Parser skip mode bytes") && rc;
+			return rc;
+		}
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 9. Main
+
+namespace ParserBenchmarkInternal
+{
+	const sint ParserBenchmarkReturnCode_OK = 0;
+	const sint ParserBenchmarkReturnCode_WrongProgramInvocationParameter = -1;
+	const sint ParserBenchmarkReturnCode_CannotReadCapture = -2;
+	const sint ParserBenchmarkReturnCode_SmlFileNotRecognised = -3;
+	const sint ParserBenchmarkReturnCode_StaticAndDynamicParsingDiffer = -4;
+	const sint ParserBenchmarkReturnCode_SkipModeDiffers = -5;
+	const sint ParserBenchmarkReturnCode_ScannersDiffer = -6;
+	const sint ParserBenchmarkReturnCode_EscAnalysesDiffer = -7;
+	const sint ParserBenchmarkReturnCode_TimerTooLate = -8;
+
+	const uint DefaultNumberOfIterations = 20U;
+
+	// The parser uses the engines that have been selected at compile time
+#ifdef SCANNER_REFERENCE
+	const mchar *const ParserScannerEngineName = "Scanner (state)";
+#else
+	const mchar *const ParserScannerEngineName = "ScannerSwitchBased";
+#endif
+#ifdef ESC_ANALYSIS_REFERENCE
+	const mchar *const ParserEscAnalysisEngineName = "EscAnalysis (state)";
+#else
+	const mchar *const ParserEscAnalysisEngineName = "EscAnalysisTableDriven";
+#endif
+}
+
+sint main(const sint argc, mchar *const argv[])
+{
+	sint rc = ParserBenchmarkInternal::ParserBenchmarkReturnCode_OK;
+	uint iterations = ParserBenchmarkInternal::DefaultNumberOfIterations;
+	std::vector<ParserBenchmarkInternal::Corpus> corpus;
+
+	for (sint i = 1; (ParserBenchmarkInternal::ParserBenchmarkReturnCode_OK == rc) && (i < argc); ++i)
+	{
+		if (0 == strcmp(argv[i], "-i"))
+		{
+			++i;
+			iterations = (i < argc) ? static_cast<uint>(strtoul(argv[i], null<mchar **>(), 10)) : null<uint>();
+			if (null<uint>() == iterations)
+			{
+				std::cerr << "Usage: " << argv[0] << " [-i iterations] [capture file] . . ." << std::endl;
+				rc = ParserBenchmarkInternal::ParserBenchmarkReturnCode_WrongProgramInvocationParameter;
+			}
+		}
+		else
+		{
+			corpus.push_back(ParserBenchmarkInternal::Corpus());
+			if (!ParserBenchmarkInternal::loadCapture(argv[i], corpus.back()))
+			{
+				std::cerr << "Cannot read capture file " << argv[i] << std::endl;
+				rc = ParserBenchmarkInternal::ParserBenchmarkReturnCode_CannotReadCapture;
+			}
+		}
+	}
+
+	if (ParserBenchmarkInternal::ParserBenchmarkReturnCode_OK == rc)
+	{
+		// No recorded data given. Use the generated telegrams
+		if (corpus.empty())
+		{
+			const uint numberOfMeterDefinitions = sizeof(ParserBenchmarkInternal::meterDefinition)/sizeof(ParserBenchmarkInternal::meterDefinition[0]);
+			corpus.resize(numberOfMeterDefinitions);
+			for (uint i = null<uint>(); i < numberOfMeterDefinitions; ++i)
+			{
+				ParserBenchmarkInternal::generateCorpus(ParserBenchmarkInternal::meterDefinition[i], corpus[i]);
+			}
+		}
+
+		std::cout << "Parser and scanners use " << ParserBenchmarkInternal::ParserEscAnalysisEngineName << ". Parser uses "
+				  << ParserBenchmarkInternal::ParserScannerEngineName << ". " << iterations << " iterations" << '\n';
+		for (std::vector<ParserBenchmarkInternal::Corpus>::const_iterator ci = corpus.begin(); ci != corpus.end(); ++ci)
+		{
+			if (!ci->smlFiles.empty() && !ParserBenchmarkInternal::compareStaticAndDynamicParsing(*ci))
+			{
+				rc = ParserBenchmarkInternal::ParserBenchmarkReturnCode_StaticAndDynamicParsingDiffer;
+			}
+			if (!ci->smlFiles.empty() && !ParserBenchmarkInternal::compareSkipModeAndNormalParsing(*ci))
+			{
+				rc = ParserBenchmarkInternal::ParserBenchmarkReturnCode_SkipModeDiffers;
+			}
+			if (!ci->smlFiles.empty() && !ParserBenchmarkInternal::compareReferenceAndSwitchBasedScanner(*ci))
+			{
+				rc = ParserBenchmarkInternal::ParserBenchmarkReturnCode_ScannersDiffer;
+			}
+			if (!ci->smlFiles.empty() && !ParserBenchmarkInternal::compareReferenceAndTableDrivenEscAnalysis(*ci))
+			{
+				rc = ParserBenchmarkInternal::ParserBenchmarkReturnCode_EscAnalysesDiffer;
+			}
+		}
+		if (!ParserBenchmarkInternal::checkTimingWheel())
+		{
+			rc = ParserBenchmarkInternal::ParserBenchmarkReturnCode_TimerTooLate;
+		}
+		ParserBenchmarkInternal::printHeader();
+		for (std::vector<ParserBenchmarkInternal::Corpus>::const_iterator ci = corpus.begin(); ci != corpus.end(); ++ci)
+		{
+			if (ci->smlFiles.empty())
+			{
+				std::cout << ci->name << ": no SML file found" << '\n';
+			}
+			else if (!ParserBenchmarkInternal::runAllStages(*ci, iterations))
+			{
+				rc = ParserBenchmarkInternal::ParserBenchmarkReturnCode_SmlFileNotRecognised;
+			}
+		}
+		std::cout << std::flush;
+	}
+	return rc;
+}
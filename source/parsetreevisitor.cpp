@@ -1,160 +1,260 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-// 
-// parsetreevisitor.cpp
-//
-// Special Visitor for evaluation of an SmlListEntry
-//
-// Please refer also to parser.hpp/cpp
-// After the parser has successfully read a SML File, a parse tree with all information
-// regarding that file is available. That tree will be traversed. All needed information
-// will be extracted. This is done using the visitor pattern. And the following class
-// gets all important information for a Ehz
-//
-
-
-#include "parsetreevisitor.hpp"
-#include "bytestring.hpp"
-#include "obisunit.hpp"
-#include "userinterface.hpp"
-#include "crc16.hpp"
-#include <cstring>
-
-namespace ParserInternal
-{
-// ------------------------------------------------------------------------------------------------------------------------------------------------
-// 1. Visitor class member functions
-
-
-	// -----------------------------------------------------------------------
-	// 1.1 Simple constructor
-
-	// Constructor for our visitor class
-	SmlListEntryEvaluation::SmlListEntryEvaluation(const EhzConfigDefinition &ecd, EhzInternal::AllMeasuredValuesForOneEhz *const emd) : ParserInternal::VisitorForSmlListEntry(), ehzConfigDefinition(ecd), allMeasuredValuesForOneEhz(emd)
-	{
-	}
-
-	// -----------------------------------------------------------------------
-	// 1.2 Visitor function (called by accept) for gettinmg all values of an SML List Entry
-
-	
-	// This is the implementation for the specific visitor. It is an override for the visit function
-	// of the abstract Visitor Base class
-	void SmlListEntryEvaluation::visit(ParserInternal::SmlListEntry &smlListEntry)				
-	{ 
-	
-		// First store all OBIS IDs for debug purposes
-		// Ignore Return Value
-		allMeasuredValuesForOneEhz->obisValues.insert(convertSmlByteStringToHex(smlListEntry.objName.value));	//lint !e534
-
-	
-		// NumberOfEhzMeasuredData is a constant. It was defined for the special context of EHZ that can produce 4 (x) relevant values
-		// Now go through all possible x values and search, if this desired value is in the SML List Entry
-		for (uint indexEhzMeasuredData=0U; indexEhzMeasuredData<NumberOfEhzMeasuredData; ++indexEhzMeasuredData)
-		{
-			// A SML list measuredValueForOneEhz contains a so called OBIS identifier that indicates what type of value is tored
-			// We are looking for specific values. For example the Electric power. This has an associated OBIS ID
-			
-			
-			
-			
-			
-			// Check, if this measuredValueForOneEhz is of the desired type
-			if (0 == std::memcmp(
-									ehzConfigDefinition.ehzDataValueDefinition[indexEhzMeasuredData].ObisForDataValue,
-									smlListEntry.objName.value.c_str(),
-									EhzInternal::ObisDataLength
-								)
-				)
-			{
-				// We found a match
-				
-				// Status
-				// First we want to check the "status" info. This may or may not be available. 
-				// The status info in a SmlListEntry has different flags with information for the result.
-				// For example a direction flag that shows if current is flowing in or out of the meter.
-				// This value maybe an optional value. If omitted, there is no real data available
-				// So, if it is optional
-				if (smlListEntry.status.isOptional)
-				{
-					// then set status to 0
-					allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].status = 0ULL;
-				}
-				else
-				{
-					// Status info is avalable. Store it
-					allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].status = smlListEntry.status.value;
-				}
-				// Data
-				// The actual data could be a text or a string (or nothing, not existing). Check what
-				switch( ehzConfigDefinition.ehzMeasuredDataType[indexEhzMeasuredData])
-				{
-					// It is a number
-					case EhzMeasuredDataType::Number:
-						//lint --e(922)   // 922 Cast from Type to Type
-						// Calculate the value. It consists of a integer type base value and an exponent.
-						// Calculate result and store it
-						allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].doubleValue =  (smlListEntry.value.value * pow(10.0,static_cast<mdouble>(smlListEntry.scaler.value)));
-						break;
-
-					// It is a text
-					case EhzMeasuredDataType::String:
-						// Simply copy the text
-						allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].smlByteString = smlListEntry.value.sbs;
-
-						break;
-					
-					// Data Type not existing or error
-					case EhzMeasuredDataType::Null:  
-						//FALLTHRU
-					default:
-						// Reset result to 0
-						allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].doubleValue = 0.0;
-						allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].smlByteString = "";
-						break;
-				}
-				
-				// Unit
-				// Data may have a associated unit like "kWh" or "A" or "V"
-				// or may not. The unit is a optional information
-				// Check if unit was omitted
-				if (smlListEntry.unit.isOptional)
-				{
-					// No unit available.
-					allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].unit = "";
-				}
-				else
-				{
-					// Store unit String
-					//lint --e(921) // Cast OK
-					allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].unit = EhzInternal::ObisUnitLookup[static_cast<uint>(smlListEntry.unit.value)].unit;
-				}
-
-				break;
-			}
-		}
-		// And last but not least store the timestamp of now
-		allMeasuredValuesForOneEhz->storeNowTime();
-	}
-
-}
-
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+// 
+// parsetreevisitor.cpp
+//
+// Special Visitor for evaluation of an SmlListEntry
+//
+// Please refer also to parser.hpp/cpp
+// After the parser has successfully read a SML File, a parse tree with all information
+// regarding that file is available. That tree will be traversed. All needed information
+// will be extracted. This is done using the visitor pattern. And the following class
+// gets all important information for a Ehz
+//
+
+
+#include "parsetreevisitor.hpp"
+#include "bytestring.hpp"
+#include "obisunit.hpp"
+#include "userinterface.hpp"
+#include "crc16.hpp"
+#include <algorithm>
+
+namespace ParserInternal
+{
+// ------------------------------------------------------------------------------------------------------------------------------------------------
+// 1. Lookup index for OBIS values
+
+	// -----------------------------------------------------------------------
+	// 1.1 Build the index
+
+	// Take all configured values of the Ehz and sort them by their OBIS ID
+	ObisIndex::ObisIndex(const EhzConfigDefinition &ecd) : obisIndexEntries()
+	{
+		obisIndexEntries.reserve(NumberOfEhzMeasuredData);
+		for (uint indexEhzMeasuredData=0U; indexEhzMeasuredData<NumberOfEhzMeasuredData; ++indexEhzMeasuredData)
+		{
+			// Only values with a type have an OBIS ID
+			if ((EhzMeasuredDataType::Null != ecd.ehzMeasuredDataType[indexEhzMeasuredData]) &&
+				(null<const mchar *>() != ecd.ehzDataValueDefinition[indexEhzMeasuredData].ObisForDataValue))
+			{
+				//lint -e{926,9176}
+				const ObisIndexEntry obisIndexEntry(getKey(reinterpret_cast<const EhzDatabyte *>(ecd.ehzDataValueDefinition[indexEhzMeasuredData].ObisForDataValue)), indexEhzMeasuredData);
+				// If an OBIS ID is given several times, then the first definition will be used
+				const std::vector<ObisIndexEntry>::iterator it = std::lower_bound(obisIndexEntries.begin(), obisIndexEntries.end(), obisIndexEntry);
+				if ((obisIndexEntries.end() == it) || (it->key != obisIndexEntry.key))
+				{
+					//lint -e{534}
+					obisIndexEntries.insert(it, obisIndexEntry);
+				}
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------
+	// 1.2 Search for an OBIS ID
+
+	// Binary search in the sorted index. Returns NumberOfEhzMeasuredData, if we are not interested in this OBIS ID
+	uint ObisIndex::find(const SmlByteStringView &obis) const
+	{
+		uint indexEhzMeasuredData = NumberOfEhzMeasuredData;
+		// Only OBIS IDs with the full length can match
+		if (static_cast<TokenLength>(EhzInternal::ObisDataLength) <= obis.length)
+		{
+			const ObisIndexEntry obisIndexEntry(getKey(obis.data), NumberOfEhzMeasuredData);
+			const std::vector<ObisIndexEntry>::const_iterator it = std::lower_bound(obisIndexEntries.begin(), obisIndexEntries.end(), obisIndexEntry);
+			if ((obisIndexEntries.end() != it) && (it->key == obisIndexEntry.key))
+			{
+				indexEhzMeasuredData = it->indexEhzMeasuredData;
+			}
+		}
+		return indexEhzMeasuredData;
+	}
+
+	// -----------------------------------------------------------------------
+	// 1.3 Build the key for an OBIS ID
+
+	// The 6 bytes of the OBIS ID are packed into one integer. So one comparison is sufficient
+	u64 ObisIndex::getKey(const EhzDatabyte *const obis)
+	{
+		u64 key = 0ULL;
+		for (uint i=0U; i<EhzInternal::ObisDataLength; ++i)
+		{
+			key = (key << 8U) | static_cast<u64>(obis[i]);
+		}
+		return key;
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------
+// 2. Visitor class member functions
+
+
+	// -----------------------------------------------------------------------
+	// 2.1 Simple constructor
+
+	// Constructor for our visitor class. The OBIS index will be built once
+	SmlListEntryEvaluation::SmlListEntryEvaluation(const EhzConfigDefinition &ecd, EhzInternal::AllMeasuredValuesForOneEhz *const emd) : ParserInternal::VisitorForSmlListEntry(), Visitor<ParserInternal::SmlPublicOpenResponse>(), Publisher<SmlListEntryEvaluation>(), ParserInternal::SmlListEntryFilter(), ehzConfigDefinition(ecd), obisIndex(ecd), allMeasuredValuesForOneEhz(emd),
+																																	earlyValueIndex(NumberOfEhzMeasuredData), earlyValuesAreAnnounced(false), isDiscoveringObis(false),
+																																	handledObisDiscoveryRequest(__atomic_load_n(&globalObisDiscoveryRequest, __ATOMIC_ACQUIRE))
+	{
+	}
+
+	// -----------------------------------------------------------------------
+	// 2.2 Visitor function (called by accept) for gettinmg all values of an SML List Entry
+
+	
+	// This is the implementation for the specific visitor. It is an override for the visit function
+	// of the abstract Visitor Base class
+	void SmlListEntryEvaluation::visit(ParserInternal::SmlListEntry &smlListEntry)				
+	{ 
+	
+		// Store all OBIS IDs, if a discovery is running. Only the raw bytes. They are converted, when they are shown
+		if (isDiscoveringObis && (static_cast<TokenLength>(EhzInternal::ObisDataLength) <= smlListEntry.objName.value.length))
+		{
+			allMeasuredValuesForOneEhz->discoveredObis.add(ObisIndex::getKey(smlListEntry.objName.value.data));
+		}
+
+		// A SML list measuredValueForOneEhz contains a so called OBIS identifier that indicates what type of value is tored
+		// We are looking for specific values. For example the Electric power. This has an associated OBIS ID
+		// Look up, if this measuredValueForOneEhz is of one of the desired types
+		const uint indexEhzMeasuredData = obisIndex.find(smlListEntry.objName.value);
+		if (indexEhzMeasuredData < NumberOfEhzMeasuredData)
+		{
+			// We found a match
+			
+			// Status
+			// First we want to check the "status" info. This may or may not be available. 
+			// The status info in a SmlListEntry has different flags with information for the result.
+			// For example a direction flag that shows if current is flowing in or out of the meter.
+			// This value maybe an optional value. If omitted, there is no real data available
+			// So, if it is optional
+			if (smlListEntry.status.isOptional)
+			{
+				// then set status to 0
+				allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].status = 0ULL;
+			}
+			else
+			{
+				// Status info is avalable. Store it
+				allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].status = smlListEntry.status.value;
+			}
+			// Data
+			// The actual data could be a text or a string (or nothing, not existing). Check what
+			switch( ehzConfigDefinition.ehzMeasuredDataType[indexEhzMeasuredData])
+			{
+				// It is a number
+				case EhzMeasuredDataType::Number:
+					//lint --e(922)   // 922 Cast from Type to Type
+					// The value consists of a integer type base value and an exponent. Keep both
+					// An omitted scaler means 10^0. In streaming mode the list entry is reused, so do not take the old value
+					allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].setScaledValue(smlListEntry.value.value, (smlListEntry.scaler.isOptional ? null<s8>() : smlListEntry.scaler.value));
+					break;
+
+				// It is a text
+				case EhzMeasuredDataType::String:
+					// Simply copy the text. Here we need an own copy, because the parse tree will be reused
+					copySmlByteStringView(smlListEntry.value.sbs, allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].smlByteString);
+
+					break;
+				
+				// Data Type not existing or error
+				case EhzMeasuredDataType::Null:  
+					//FALLTHRU
+				default:
+					// Reset result to 0
+					allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].setScaledValue(null<s64>(), null<s8>());
+					allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].smlByteString = "";
+					break;
+			}
+			
+			// Unit
+			// Data may have a associated unit like "kWh" or "A" or "V"
+			// or may not. The unit is a optional information
+			// Check if unit was omitted
+			if (smlListEntry.unit.isOptional)
+			{
+				// No unit available.
+				allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].unit = "";
+				allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].unitIndex = null<u8>();
+			}
+			else
+			{
+				// Store unit String
+				//lint --e(921) // Cast OK
+				allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].unit = EhzInternal::ObisUnitLookup[static_cast<uint>(smlListEntry.unit.value)].unit;
+				//lint --e(921)
+				allMeasuredValuesForOneEhz->measuredValueForOneEhz[indexEhzMeasuredData].unitIndex = static_cast<u8>(smlListEntry.unit.value);
+			}
+			
+			// Some values are needed at once. Do not wait for the end of the SML file
+			if (null<u32>() != (ehzConfigDefinition.EhzEarlyPublication & (1UL << indexEhzMeasuredData)))
+			{
+				earlyValueIndex = indexEhzMeasuredData;
+				earlyValuesAreAnnounced = true;
+				notifySubscribers();
+			}
+		}
+	}
+	
+	
+	// -----------------------------------------------------------------------
+	// 2.3 Start of a new SML file
+	
+	// In OBIS debug mode, the OBIS IDs of every SML file are collected. Otherwise only after a request
+	// All values of the SML file get the same timestamp. Also the early values
+	void SmlListEntryEvaluation::visit(ParserInternal::SmlPublicOpenResponse &)
+	{
+		clear();
+		allMeasuredValuesForOneEhz->storeNowTime();
+		const u32 obisDiscoveryRequest = __atomic_load_n(&globalObisDiscoveryRequest, __ATOMIC_ACQUIRE);
+		//lint -e{641,911}
+		isDiscoveringObis = (DebugModeObis == globalDebugMode) || (obisDiscoveryRequest != handledObisDiscoveryRequest);
+		handledObisDiscoveryRequest = obisDiscoveryRequest;
+	}
+
+
+	// -----------------------------------------------------------------------
+	// 2.4 Early publication of an invalid SML file
+	
+	void SmlListEntryEvaluation::discardEarlyValues(void)
+	{
+		if (earlyValuesAreAnnounced)
+		{
+			earlyValuesAreAnnounced = false;
+			earlyValueIndex = NumberOfEhzMeasuredData;
+			notifySubscribers();
+		}
+	}
+
+
+	// -----------------------------------------------------------------------
+	// 2.5 Filter for the skip mode of the parser
+
+	// The parser skips the rest of a SmlListEntry, if its OBIS ID is not configured. During a discovery all are needed
+	boolean SmlListEntryEvaluation::isNeeded(const SmlByteStringView &objName) const
+	{
+		return isDiscoveringObis || (obisIndex.find(objName) < NumberOfEhzMeasuredData);
+	}
+
+}
+
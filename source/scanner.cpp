@@ -134,6 +134,8 @@
 			{
 				// ESC Start sequence found. Set Token type
 				scd.token.setTlType(Token::START_OF_SML_FILE);
+				// A new SML file starts. The octet strings of the previous file are no longer needed
+				scd.octetBuffer.reset();
 				// Goto next state
 				nextState = getInstance<ScannerStateAnalyzeTl>();
 			}
@@ -211,8 +213,11 @@
 			// already consumed the first 4 ESCs of an escaped ESC sequence as data bytes
 			if (EscAnalysisResult::ESC_ANALYSIS_RESULT_ESCESC  != scd.escAnalysisResultCode)
 			{
-				// Add one byte to the resulting string
-				scd.token.setValue(ehzDatabyte);
+				// Add one byte to the resulting string. Not, if the parser does not need the content
+				if (!scd.isSkippingOctetContent)
+				{
+					scd.token.setValue(ehzDatabyte);
+				}
 
 				// Check if we read all bytes as indicated by the TL field
 				--scd.ehzDatabyteReadLoopCounter;
@@ -249,6 +254,10 @@
 			//lint -e921          921 Cast from Type to Type
 			if (0U == (0xF0U & static_cast<uint>(ehzDatabyte)))
 			{
+				// The last TL byte contributes its low nibble to the length as well
+				scd.multiByteLength <<= 4;
+				scd.multiByteLength += (static_cast<TokenLength>(ehzDatabyte) & 0x0FLU);
+				++scd.multiByteNumberOfTlbyteRead;
 				// TL fields are also contained in the length information.
 				// Therefore we must subtract the number of read TL bytes to obtain the net data length
 				scd.ehzDatabyteReadLoopCounter = scd.multiByteLength - scd.multiByteNumberOfTlbyteRead;
@@ -317,7 +326,9 @@
 				if (scd.isFirstSignedIntegerByte)
 				{
 					// First byte. If the byte is negative the whole s64 will be negative 
-					scd.s64TempSignedInteger = s64(ehzDatabyte);
+					//lint -e{921}
+					scd.s64TempSignedInteger = s64(static_cast<s8>(ehzDatabyte));
+					scd.isFirstSignedIntegerByte = false;
 				}
 				else
 				{
@@ -443,4 +454,307 @@
 
 
 
+// ----------------------------------------------------------------------------------------------------------------------------------
+// 2. Switch based scanner
+// ----------------------------------------------------------------------------------------------------------------------------------
+
+	// The cases are a 1:1 translation of the "scan" functions of the concrete states in chapter 1
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 2.1 Handling of a TL byte. Replaces TlByteAnalysis and the handler functions in typelengthfield.cpp
+	// ------------------------------------------------------------------------------------------------------------------------------
+
+	void ScannerSwitchBased::analyzeTlByte(const EhzDatabyte ehzDatabyte)
+	{
+		//lint -e{921}
+		const ScannerInternal::TlByteAnalysis::TLBT &tlbt = ScannerInternal::TlByteAnalysis::tlbt[static_cast<uint>(ehzDatabyte)];
+
+		// Set the type and length of the token from the TL Byte
+		scd.token.setTokenTypeAndLength(tlbt.tokenType, tlbt.tokenLength);
+		// Number of bytes to read for this type
+		scd.ehzDatabyteReadLoopCounter = tlbt.tokenLength;
+		
+		switch (tlbt.tlByteAction)
+		{
+			case ScannerInternal::TlByteAction::Basic:
+				currentState = ScannerInternal::ScannerSwitchState::AnalyzeTl;
+				break;
+			case ScannerInternal::TlByteAction::Optional:
+				scd.token.setValue();
+				currentState = ScannerInternal::ScannerSwitchState::AnalyzeTl;
+				break;
+			case ScannerInternal::TlByteAction::Octet:
+				scd.token.setValue();
+				currentState = ScannerInternal::ScannerSwitchState::ReadOctet;
+				break;
+			case ScannerInternal::TlByteAction::Boolean:
+				currentState = ScannerInternal::ScannerSwitchState::ReadBoolean;
+				break;
+			case ScannerInternal::TlByteAction::SignedInteger:
+				scd.isFirstSignedIntegerByte = true;
+				currentState = ScannerInternal::ScannerSwitchState::ReadSignedInteger;
+				break;
+			case ScannerInternal::TlByteAction::UnsignedInteger:
+				scd.u64TempUnsignedInteger = 0ULL;
+				currentState = ScannerInternal::ScannerSwitchState::ReadUnsignedInteger;
+				break;
+			case ScannerInternal::TlByteAction::MultiByteOctet:
+				scd.multiByteNumberOfTlbyteRead = 1UL;
+				scd.multiByteLength = scd.token.getLength();
+				currentState = ScannerInternal::ScannerSwitchState::ReadMultiByteOctet;
+				break;
+			case ScannerInternal::TlByteAction::MultiByteList:
+				scd.multiByteNumberOfTlbyteRead = 1UL;
+				scd.multiByteLength = scd.token.getLength();
+				currentState = ScannerInternal::ScannerSwitchState::ReadMultiByteList;
+				break;
+			case ScannerInternal::TlByteAction::BasicReset:
+				//FALLTHROUGH
+			default:
+				currentState = ScannerInternal::ScannerSwitchState::Idle;
+				break;
+		}
+	}
+
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 2.2 The state machine
+	// ------------------------------------------------------------------------------------------------------------------------------
+
+	//lint -e{921}
+	void ScannerSwitchBased::scanDatabyte(const EhzDatabyte ehzDatabyte)
+	{
+		// Default: We need to analyze more data. Boolean is the only state that produces always a token
+		scd.token.setTlType(Token::CONDITION_NOT_YET_DETECTED);
+		
+		switch (currentState)
+		{
+			case ScannerInternal::ScannerSwitchState::Idle:
+				// Wait for ESC Start sequence
+				if (EscAnalysisResult::ESC_ANALYSIS_RESULT_START == scd.escAnalysisResultCode)
+				{
+					scd.token.setTlType(Token::START_OF_SML_FILE);
+					scd.octetBuffer.reset();
+					currentState = ScannerInternal::ScannerSwitchState::AnalyzeTl;
+				}
+				break;
+				
+			case ScannerInternal::ScannerSwitchState::AnalyzeTl:
+				if (EscAnalysisResult::ESC_CONDITION_WAITING == scd.escAnalysisResultCode)
+				{
+					analyzeTlByte(ehzDatabyte);
+				}
+				else if (EscAnalysisResult::ESC_ANALYSIS_RESULT_STOP == scd.escAnalysisResultCode)
+				{
+					// We found an "end of SML File"
+					scd.token.setTlType(Token::END_OF_SML_FILE);
+					scd.token.setValue(scd.escAnalysis.getLastEscFileEndData());
+					currentState = ScannerInternal::ScannerSwitchState::Idle;
+				}
+				else if (EscAnalysisResult::ESC_CONDITION_ANALYSING != scd.escAnalysisResultCode)
+				{
+					// ESC Analyser is not busy, but we could not see a valid TL byte
+					scd.token.setTlType(Token::CONDITION_ERROR);
+					currentState = ScannerInternal::ScannerSwitchState::Idle;
+				}
+				else
+				{
+					// The ESC handler is still active and is doing something
+				}
+				break;
+				
+			case ScannerInternal::ScannerSwitchState::ReadOctet:
+				if (EscAnalysisResult::ESC_ANALYSIS_RESULT_ESCESC != scd.escAnalysisResultCode)
+				{
+					if (!scd.isSkippingOctetContent)
+					{
+						scd.token.setValue(ehzDatabyte);
+					}
+					--scd.ehzDatabyteReadLoopCounter;
+					if (0UL == scd.ehzDatabyteReadLoopCounter)
+					{
+						scd.token.setTlType(Token::OCTET);
+						currentState = ScannerInternal::ScannerSwitchState::AnalyzeTl;
+					}
+				}
+				break;
+				
+			case ScannerInternal::ScannerSwitchState::ReadMultiByteOctet:
+				if (0U == (0xF0U & static_cast<uint>(ehzDatabyte)))
+				{
+					// Last TL byte. Net data length is total length minus number of TL bytes
+					scd.multiByteLength <<= 4;
+					scd.multiByteLength += (static_cast<TokenLength>(ehzDatabyte) & 0x0FLU);
+					++scd.multiByteNumberOfTlbyteRead;
+					scd.ehzDatabyteReadLoopCounter = scd.multiByteLength - scd.multiByteNumberOfTlbyteRead;
+					scd.token.setTlLength(scd.ehzDatabyteReadLoopCounter);
+					currentState = ScannerInternal::ScannerSwitchState::ReadOctet;
+				}
+				else if (0x80U == (0x80U & static_cast<uint>(ehzDatabyte)))
+				{
+					// Further TL byte
+					scd.multiByteLength <<= 4;
+					scd.multiByteLength += (static_cast<TokenLength>(ehzDatabyte) & 0x0FLU);
+					++scd.multiByteNumberOfTlbyteRead;
+				}
+				else
+				{
+					scd.token.setTlType(Token::CONDITION_ERROR);
+					currentState = ScannerInternal::ScannerSwitchState::Idle;
+				}
+				break;
+				
+			case ScannerInternal::ScannerSwitchState::ReadBoolean:
+				scd.token.setValue((0U != static_cast<uint>(ehzDatabyte)));
+				scd.token.setTlType(Token::BOOLEAN);
+				currentState = ScannerInternal::ScannerSwitchState::AnalyzeTl;
+				break;
+				
+			case ScannerInternal::ScannerSwitchState::ReadSignedInteger:
+				if (EscAnalysisResult::ESC_ANALYSIS_RESULT_ESCESC != scd.escAnalysisResultCode)
+				{
+					// Big endian with sign propagation from the first byte
+					if (scd.isFirstSignedIntegerByte)
+					{
+						scd.s64TempSignedInteger = s64(static_cast<s8>(ehzDatabyte));
+						scd.isFirstSignedIntegerByte = false;
+					}
+					else
+					{
+						scd.s64TempSignedInteger *= 256LL;
+						scd.s64TempSignedInteger += (static_cast<s64>(ehzDatabyte) % 256LL);
+					}
+					--scd.ehzDatabyteReadLoopCounter;
+					if (null<TokenLength>() == scd.ehzDatabyteReadLoopCounter)
+					{
+						scd.token.setValue(scd.s64TempSignedInteger);
+						scd.token.setTlType(Token::SIGNED_INTEGER);
+						currentState = ScannerInternal::ScannerSwitchState::AnalyzeTl;
+					}
+				}
+				break;
+				
+			case ScannerInternal::ScannerSwitchState::ReadUnsignedInteger:
+				if (EscAnalysisResult::ESC_ANALYSIS_RESULT_ESCESC != scd.escAnalysisResultCode)
+				{
+					scd.u64TempUnsignedInteger <<= 8;
+					scd.u64TempUnsignedInteger |= (static_cast<u64>(ehzDatabyte) & 0xFFLLU);
+					--scd.ehzDatabyteReadLoopCounter;
+					if (null<TokenLength>() == scd.ehzDatabyteReadLoopCounter)
+					{
+						scd.token.setValue(scd.u64TempUnsignedInteger);
+						scd.token.setTlType(Token::UNSIGNED_INTEGER);
+						currentState = ScannerInternal::ScannerSwitchState::AnalyzeTl;
+					}
+				}
+				break;
+				
+			case ScannerInternal::ScannerSwitchState::ReadMultiByteList:
+				if (0x70U == (0xF0U & static_cast<uint>(ehzDatabyte)))
+				{
+					// Last TL byte of the list
+					scd.multiByteLength <<= 4;
+					scd.multiByteLength += (static_cast<TokenLength>(ehzDatabyte) & 0x0FLU);
+					scd.token.setTlLength(scd.multiByteLength);
+					scd.token.setTlType(Token::LIST);
+					currentState = ScannerInternal::ScannerSwitchState::AnalyzeTl;
+				}
+				else if (0xF0U == (0xF0U & static_cast<uint>(ehzDatabyte)))
+				{
+					// Further TL byte
+					scd.multiByteLength <<= 4;
+					scd.multiByteLength += (static_cast<TokenLength>(ehzDatabyte) & 0x0FLU);
+					++scd.multiByteNumberOfTlbyteRead;
+				}
+				else
+				{
+					scd.token.setTlType(Token::CONDITION_ERROR);
+					currentState = ScannerInternal::ScannerSwitchState::Idle;
+				}
+				break;
+				
+			default:
+				// Cannot happen
+				scd.token.setTlType(Token::CONDITION_ERROR);
+				currentState = ScannerInternal::ScannerSwitchState::Idle;
+				break;
+		}
+	}
+	
+
+	// ------------------------------------------------------------------------------------------------------------------------------
+	// 2.3 Read complete values from a block of net data
+	// ------------------------------------------------------------------------------------------------------------------------------
+
+	const Token &ScannerSwitchBased::scanPayloadBlock(const EhzDatabyte *const ehzDatabytes, const size_t numberOfBytes, size_t &numberOfScannedBytes)
+	{
+		// All bytes are net data. So the ESC analysis result is known
+		scd.escAnalysisResultCode = EscAnalysisResult::ESC_CONDITION_WAITING;
+		
+		// Number of bytes needed to complete the current value
+		const size_t bytesNeeded = static_cast<size_t>(scd.ehzDatabyteReadLoopCounter);
+		// Only values with at least 2 missing bytes are worth the effort
+		const boolean allBytesAvailable = (bytesNeeded > 1U) && (bytesNeeded <= numberOfBytes);
+		
+		if (allBytesAvailable && (ScannerInternal::ScannerSwitchState::ReadUnsignedInteger == currentState))
+		{
+			// Big endian. Continue with the already read bytes (if any)
+			u64 value = scd.u64TempUnsignedInteger;
+			for (size_t i = 0U; i < bytesNeeded; ++i)
+			{
+				value = (value << 8U) | static_cast<u64>(ehzDatabytes[i]);
+			}
+			scd.u64TempUnsignedInteger = value;
+			scd.token.setValue(value);
+			scd.token.setTlType(Token::UNSIGNED_INTEGER);
+			scd.ehzDatabyteReadLoopCounter = null<TokenLength>();
+			currentState = ScannerInternal::ScannerSwitchState::AnalyzeTl;
+			numberOfScannedBytes = bytesNeeded;
+		}
+		else if (allBytesAvailable && (ScannerInternal::ScannerSwitchState::ReadSignedInteger == currentState))
+		{
+			size_t i = 0U;
+			s64 value = scd.s64TempSignedInteger;
+			if (scd.isFirstSignedIntegerByte)
+			{
+				// Sign propagation from the first byte
+				//lint -e{921}
+				value = s64(static_cast<s8>(ehzDatabytes[0]));
+				scd.isFirstSignedIntegerByte = false;
+				i = 1U;
+			}
+			for (; i < bytesNeeded; ++i)
+			{
+				value = (value * 256LL) + static_cast<s64>(ehzDatabytes[i]);
+			}
+			scd.s64TempSignedInteger = value;
+			scd.token.setValue(value);
+			scd.token.setTlType(Token::SIGNED_INTEGER);
+			scd.ehzDatabyteReadLoopCounter = null<TokenLength>();
+			currentState = ScannerInternal::ScannerSwitchState::AnalyzeTl;
+			numberOfScannedBytes = bytesNeeded;
+		}
+		else if (allBytesAvailable && (ScannerInternal::ScannerSwitchState::ReadOctet == currentState))
+		{
+			// Copy the string at once. Or skip it, if the parser does not need the content
+			if (!scd.isSkippingOctetContent)
+			{
+				scd.token.setValue(ehzDatabytes, bytesNeeded);
+			}
+			scd.token.setTlType(Token::OCTET);
+			scd.ehzDatabyteReadLoopCounter = null<TokenLength>();
+			currentState = ScannerInternal::ScannerSwitchState::AnalyzeTl;
+			numberOfScannedBytes = bytesNeeded;
+		}
+		else
+		{
+			// Standard: byte by byte
+			scanDatabyte(*ehzDatabytes);
+			numberOfScannedBytes = 1U;
+		}
+		return scd.token;
+	}
+
+
+
 
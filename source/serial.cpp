@@ -1,163 +1,879 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-// serial.hpp
-//
-// General Description
-//
-// This module is a part of an application tor read the data from Electronic Meters for Electric Power
-//
-// In Germany they are called EHZ. Hence the name of the module an variables.
-//
-// The EHZ transmits data via an infrared interface. The protocoll is described in:
-//
-//  http://www.emsycon.de/downloads/SML_081112_103.pdf
-//
-// All this is done via a standard serial RS232 optical interface
-// Here we have some basic classes to handle a serial port
-//
-
-#include "userinterface.hpp"
-
-#include "serial.hpp"
-
-#include <unistd.h>
-#include <fcntl.h>
-
-#include <sys/ioctl.h>
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 1. Setting Serial Port Parameters
-
-
-namespace SerialInternal
-{
-	// ---------------------------------------------------------------------
-	// 1.1 Construcor reads the current settings of an already opend port
-	SerialPortParameter::SerialPortParameter(const Handle handleSerialPort) : serialOptions() , ok(false), handle(handleSerialPort)
-	{
-		ok = false;
-		handle = handleSerialPort;
-		if (handleSerialPort >= null<Handle>())
-		{
-			if (null<sint>() == tcgetattr(handleSerialPort, &serialOptions))
-			{
-				ok = true;
-			}
-		}
-	}
-	
-	// ---------------------------------------------------------------------
-	// 1.2 Set serial Port options to 9600N81
-
-	void EhzSerialPortParameter::setSerialPortParameter(void)
-	{
-
-		//lint -e{917,1960,9001}
-		//Note 9001: Octal constant used
-		//Note 917: Prototype coercion (arg. no. 2) int to unsigned int
-		if (-1 == cfsetispeed(&serialOptions, B9600))
-		{
-			ok = false;
-		}
-		if (isOK())
-		{
-			cfmakeraw(&serialOptions);	
-			if (null<sint>() != tcsetattr(handle, TCSANOW, &serialOptions))
-			{
-				ok = false;
-			}
-			// Switch on DTR
-			sint DTR_flag = TIOCM_DTR;
-			if (-1 == ioctl(handle, TIOCMBIS, &DTR_flag))
-			{
-				ok = false;
-			}
-			else
-			{
-				ui << "Set DTR" << std::endl;
-			}
-		}
-	}
-	
-// ------------------------------------------------------------------------------------------------------------------------------
-// 2. Handle Serial Port
-	
-	// ---------------------------------------------------------------------
-	// 2.1 Open and set serial port connection options / parameters
-	void EhzSerialPort::start(void)
-	{
-		boolean rc = false;
-		// if it is not open, then open serial port
-		if (null<Handle>() == handle)
-		{
-			//lint -e{9001} Octal constant used
-			handle = open(portName.c_str(),O_RDWR);	//lint !e1960
-			if (handle >= null<Handle>())
-			{
-				// Set port parameter
-				//ui.msgf("Open  %s   %d\n",  portName.c_str(), handle);
-				EhzSerialPortParameter ehzSerialPortParameter(handle);
-				rc = ehzSerialPortParameter.isOK();
-			}
-		}
-		if (!rc)
-		{
-			ui << "Error: Could not open serial port --> " << portName << std::endl;
-			//lint -e{1933}   Note 1933: Call to unqualified virtual function 'CommunicationEndPoint::stop(void)' from non-static member function
-			// Close in case of problems
-			stop();
-		}
-	}
-	
-	
-	// ---------------------------------------------------------------------
-	// 2.2 Reactor reported that data is available. Read it
-	EventProcessing::Action EhzSerialPort::handleEvent(const EventType et) 	
-	{ 
-		//lint --e{921} 921 Cast from Type to Type --
-		//ui.msgf("Serial Port EventHandler %d\n",static_cast<sint>(et));
-		EventProcessing::Action rc = EventProcessing::Continue;
-		switch (static_cast<sint>(et))
-		{
-			case EventTypeIn:
-				{
-					sint bytesread;
-					bytesread = read(handle,&databyte,1U);
-					// CHeck if have read one databyte from the serial port 
-					if (1 == bytesread)
-					{
-						//lint -e{1933}   Note 1933: Call to unqualified virtual function 'CommunicationEndPoint::stop(void)' from non-static member function
-						//ui.msgf("-(%02X)-  ",static_cast<sint>(databyte));
-						notifySubscribers();
-					}
-				}
-				break;
-			default:
-				// unexpected Event
-				rc = EventProcessing::Stop;
-				break;
-			
-		}
-		return rc; 
-	}
-}		
-
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+// serial.hpp
+//
+// General Description
+//
+// This module is a part of an application tor read the data from Electronic Meters for Electric Power
+//
+// In Germany they are called EHZ. Hence the name of the module an variables.
+//
+// The EHZ transmits data via an infrared interface. The protocoll is described in:
+//
+//  http://www.emsycon.de/downloads/SML_081112_103.pdf
+//
+// All this is done via a standard serial RS232 optical interface
+// Here we have some basic classes to handle a serial port
+//
+
+#include "serial.hpp"
+#include "metrics.hpp"
+#include "logger.hpp"
+#include "acceptorconnector.hpp"
+#include "allocation.hpp"
+#include "trace.hpp"
+#include "escanalysis.hpp"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <linux/serial.h>
+
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Setting Serial Port Parameters
+
+
+namespace SerialInternal
+{
+	// ---------------------------------------------------------------------
+	// 1.1 Construcor reads the current settings of an already opend port
+	SerialPortParameter::SerialPortParameter(const Handle handleSerialPort) : serialOptions() , ok(false), handle(handleSerialPort)
+	{
+		ok = false;
+		handle = handleSerialPort;
+		if (handleSerialPort >= null<Handle>())
+		{
+			if (null<sint>() == tcgetattr(handleSerialPort, &serialOptions))
+			{
+				ok = true;
+			}
+		}
+	}
+	
+	// ---------------------------------------------------------------------
+	// 1.2 Set serial Port options to 9600N81
+
+	void EhzSerialPortParameter::setSerialPortParameter(void)
+	{
+
+		//lint -e{917,1960,9001}
+		//Note 9001: Octal constant used
+		//Note 917: Prototype coercion (arg. no. 2) int to unsigned int
+		if (-1 == cfsetispeed(&serialOptions, B9600))
+		{
+			ok = false;
+		}
+		if (isOK())
+		{
+			cfmakeraw(&serialOptions);	
+			if (null<u32>() != frameGapInMs)
+			{
+				// Poll reports data, when half of the bytes of one frame gap are there. So the reader
+				// gets new data well before the frame gap timer expires, while a frame is received
+				const u32 minimumNumberOfBytes = ((frameGapInMs * SerialBytesPerSecond) / 1000UL) / 2UL;
+				serialOptions.c_cc[VMIN] = static_cast<cc_t>(std::max(1UL, std::min(minimumNumberOfBytes, 255UL)));
+				serialOptions.c_cc[VTIME] = null<cc_t>();
+			}
+			if (null<sint>() != tcsetattr(handle, TCSANOW, &serialOptions))
+			{
+				ok = false;
+			}
+			// Switch on DTR
+			sint DTR_flag = TIOCM_DTR;
+			if (-1 == ioctl(handle, TIOCMBIS, &DTR_flag))
+			{
+				ok = false;
+			}
+			else
+			{
+				static LogSite logSite;
+				Log log(logSite);
+				log << "Set DTR";
+			}
+			if (isOK() && (null<u32>() != frameGapInMs))
+			{
+				setLowLatencyProfile();
+			}
+		}
+	}
+	
+	// ---------------------------------------------------------------------
+	// 1.3 Low latency profile
+	
+	void EhzSerialPortParameter::setLowLatencyProfile(void)
+	{
+		// A read must not wait for VMIN bytes. The rest of a frame is read, when the line is idle
+		const sint fileStatusFlags = fcntl(handle, F_GETFL);
+		if ((fileStatusFlags < 0) || (-1 == fcntl(handle, F_SETFL, fileStatusFlags | O_NONBLOCK)))
+		{
+			ok = false;
+		}
+		// The driver shall push received bytes without delay. Not all drivers support this. The profile works without it
+		struct serial_struct serialInfo;
+		boolean lowLatencyFlagIsSet = false;
+		if (0 == ioctl(handle, TIOCGSERIAL, &serialInfo))
+		{
+			//lint -e{9130}
+			serialInfo.flags |= ASYNC_LOW_LATENCY;
+			lowLatencyFlagIsSet = (0 == ioctl(handle, TIOCSSERIAL, &serialInfo));
+		}
+		static LogSite logSite;
+		Log log(logSite);
+		log << "Low latency profile. Frame gap " << frameGapInMs << " ms, VMIN " << static_cast<uint>(serialOptions.c_cc[VMIN]) << (lowLatencyFlagIsSet ? ", low latency flag set" : ", no low latency flag");
+	}
+	
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Handle Serial Port
+	
+	// ---------------------------------------------------------------------
+	// 2.1 Open and set serial port connection options / parameters
+	void EhzSerialPort::start(void)
+	{
+		boolean rc = false;
+		// if it is not open, then open serial port
+		if (null<Handle>() == handle)
+		{
+			//lint -e{9001} Octal constant used
+			handle = open(portName.c_str(),O_RDWR);	//lint !e1960
+			if (handle >= null<Handle>())
+			{
+				// Set port parameter
+				//ui.msgf("Open  %s   %d\n",  portName.c_str(), handle);
+				// The low latency profile needs block reads
+				EhzSerialPortParameter ehzSerialPortParameter(handle, (SerialReadMode::Block == serialReadMode) ? frameGapInMs : null<u32>());
+				rc = ehzSerialPortParameter.isOK();
+			}
+		}
+		// The end of a frame is found with the frame gap timer
+		if (rc && (SerialReadMode::Block == serialReadMode) && (null<u32>() != frameGapInMs))
+		{
+			frameGapTimer.addSubscription(this);
+		}
+		else
+		{
+			frameGapInMs = null<u32>();
+		}
+		// Record the received data, if requested
+		if (rc)
+		{
+			openCaptureFile();
+		}
+		if (!rc)
+		{
+			static LogSite logSite;
+			{
+				Log log(logSite);
+				log << "Error: Could not open serial port --> " << portName;
+			}
+			//lint -e{1933}   Note 1933: Call to unqualified virtual function 'CommunicationEndPoint::stop(void)' from non-static member function
+			// Close in case of problems
+			stop();
+		}
+	}
+	
+	
+	// ---------------------------------------------------------------------
+	// 2.2 Reactor reported that data is available. Read it
+	EventProcessing::Action EhzSerialPort::handleEvent(const EventType et) 	
+	{ 
+		const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Input);
+		//lint --e{921} 921 Cast from Type to Type --
+		//ui.msgf("Serial Port EventHandler %d\n",static_cast<sint>(et));
+		EventProcessing::Action rc = EventProcessing::Continue;
+		switch (static_cast<sint>(et))
+		{
+			case EventTypeIn:
+				if (SerialReadMode::SingleByte == serialReadMode)
+				{
+					sint bytesread;
+					bytesread = read(handle,&databyte,1U);
+					// CHeck if have read one databyte from the serial port 
+					if (1 == bytesread)
+					{
+						// The span of received data is this one byte
+						numberOfLastReceivedBytes = 1U;
+						captureLastReceivedBytes();
+						//lint -e{1933}   Note 1933: Call to unqualified virtual function 'CommunicationEndPoint::stop(void)' from non-static member function
+						//ui.msgf("-(%02X)-  ",static_cast<sint>(databyte));
+						notifySubscribers();
+					}
+				}
+				else
+				{
+					//lint -e{534}
+					readBlock();
+				}
+				break;
+			default:
+				// unexpected Event
+				rc = EventProcessing::Stop;
+				break;
+			
+		}
+		return rc; 
+	}
+	
+	// The port is in raw mode. So read will return all available bytes, as much as fits into the buffer
+	// A socket behaves the same way
+	ssize_t EhzSerialPort::readBlock(void)
+	{
+		// Not enough room at the end of the ring buffer. Wrap around. The bytes of a frame must be contiguous. So they are handed over before
+		if ((SerialReceiveBufferSize - receiveBufferWriteIndex) < SerialReceiveBufferMinimumReadSize)
+		{
+			deliverFrame();
+			receiveBufferWriteIndex = null<size_t>();
+		}
+		const ssize_t bytesread = readIntoReceiveBuffer();
+		if (bytesread > 0)
+		{
+			if (null<u32>() == frameGapInMs)
+			{
+				// Inform subscribers only once for the whole block
+				notifySubscribers();
+			}
+			else
+			{
+				// Low latency profile. The frame is complete with the ESC end sequence of the SML file
+				// If that is not found, then the frame is complete, when nothing has been received for the frame gap
+				if (null<size_t>() == numberOfFrameBytes)
+				{
+					frameStartIndex = lastReceivedBytesStartIndex;
+				}
+				const size_t numberOfBytesChecked = numberOfFrameBytes;
+				numberOfFrameBytes += numberOfLastReceivedBytes;
+				lastReadTimeInNs = MetricsInternal::getMonotonicTimeInNs();
+				const size_t endOfSmlFile = findEndOfSmlFile(numberOfBytesChecked);
+				if (null<size_t>() != endOfSmlFile)
+				{
+					deliverFrameUntil(endOfSmlFile);
+				}
+				// The timer is not restarted with every read. It checks the time of the last read, when it expires
+				// A timer, that is still running after the frame has been delivered, finds nothing to deliver
+				if (!frameGapTimerIsRunning && (null<size_t>() != numberOfFrameBytes))
+				{
+					frameGapTimer.setTimerValues(frameGapInMs);
+					frameGapTimer.startTimerOneShot();
+					frameGapTimerIsRunning = true;
+				}
+			}
+		}
+		return bytesread;
+	}
+	
+	ssize_t EhzSerialPort::readIntoReceiveBuffer(void)
+	{
+		TraceInternal::TraceSpan traceSpan(TraceInternal::TraceProbe::SerialRead);
+		const ssize_t bytesread = read(handle, &receiveBuffer[receiveBufferWriteIndex], SerialReceiveBufferSize - receiveBufferWriteIndex);
+		if (bytesread > 0)
+		{
+			traceSpan.setArgument(static_cast<u64>(bytesread));
+			lastReceivedBytesStartIndex = receiveBufferWriteIndex;
+			numberOfLastReceivedBytes = static_cast<size_t>(bytesread);
+			receiveBufferWriteIndex += numberOfLastReceivedBytes;
+			databyte = receiveBuffer[receiveBufferWriteIndex - 1U];
+			captureLastReceivedBytes();
+		}
+		return bytesread;
+	}
+	
+	// Low latency profile. Less than VMIN bytes do not wake up the reactor. So they are read now.
+	// If the line has been idle for the frame gap, the frame is handed over. Else wait for the rest of the gap
+	void EhzSerialPort::update(EventTimer *)
+	{
+		const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Input);
+		frameGapTimerIsRunning = false;
+		//lint -e{534}
+		readBlock();
+		// If something has been read, the timer runs again
+		if (!frameGapTimerIsRunning && (null<size_t>() != numberOfFrameBytes))
+		{
+			const u64 idleTimeInMs = (MetricsInternal::getMonotonicTimeInNs() - lastReadTimeInNs) / 1000000ULL;
+			if (idleTimeInMs >= static_cast<u64>(frameGapInMs))
+			{
+				deliverFrame();
+			}
+			else
+			{
+				frameGapTimer.setTimerValues(frameGapInMs - static_cast<u32>(idleTimeInMs));
+				frameGapTimer.startTimerOneShot();
+				frameGapTimerIsRunning = true;
+			}
+		}
+	}
+	
+	// All bytes of the frame in one notification
+	void EhzSerialPort::deliverFrame(void)
+	{
+		deliverFrameUntil(numberOfFrameBytes);
+	}
+	
+	// Bytes after the end of the SML file have been received with the same read. They start the next frame
+	void EhzSerialPort::deliverFrameUntil(const size_t numberOfBytes)
+	{
+		if (null<size_t>() != numberOfBytes)
+		{
+			lastReceivedBytesStartIndex = frameStartIndex;
+			numberOfLastReceivedBytes = numberOfBytes;
+			frameStartIndex += numberOfBytes;
+			numberOfFrameBytes -= numberOfBytes;
+			databyte = receiveBuffer[lastReceivedBytesStartIndex + numberOfLastReceivedBytes - 1U];
+			notifySubscribers();
+		}
+	}
+	
+	// The end sequence is 1B 1B 1B 1B 1A xx yy zz. Escape sequences start at a multiple of 4 bytes from the start of the
+	// SML file. 1B 1B 1B 1B in the data is escaped by doubling it. So the end sequence is only real, if it is preceded by
+	// an even number of 1B 1B 1B 1B groups.
+	// The frame is assumed to start with the SML file. If it does not, for example after start up, then the end sequence is not
+	// found at the right alignment and the frame gap delivers the frame
+	size_t EhzSerialPort::findEndOfSmlFile(const size_t numberOfBytesChecked) const
+	{
+		const EhzDatabyte escapeGroup[] = { EscAnalyisInternal::DATABYTE_ESC, EscAnalyisInternal::DATABYTE_ESC, EscAnalyisInternal::DATABYTE_ESC, EscAnalyisInternal::DATABYTE_ESC };
+		const size_t escapeSequenceLength = sizeof(escapeGroup);
+		const size_t endSequenceLength = 2U * escapeSequenceLength;
+		const EhzDatabyte *const frame = &receiveBuffer[frameStartIndex];
+		size_t endOfSmlFile = null<size_t>();
+		
+		// The first aligned position, where an end sequence could end in the newly received bytes
+		size_t position = (numberOfBytesChecked >= endSequenceLength) ? (numberOfBytesChecked - endSequenceLength + 1U) : null<size_t>();
+		position = ((position + escapeSequenceLength - 1U) / escapeSequenceLength) * escapeSequenceLength;
+		for (; (position + endSequenceLength) <= numberOfFrameBytes; position += escapeSequenceLength)
+		{
+			if ((EscAnalyisInternal::DATABYTE_STOP == frame[position + escapeSequenceLength]) && (0 == memcmp(&frame[position], escapeGroup, escapeSequenceLength)))
+			{
+				// Count the escape groups before the end sequence
+				size_t numberOfEscapeGroups = 1U;
+				for (size_t groupPosition = position; (groupPosition >= escapeSequenceLength) && (0 == memcmp(&frame[groupPosition - escapeSequenceLength], escapeGroup, escapeSequenceLength)); groupPosition -= escapeSequenceLength)
+				{
+					++numberOfEscapeGroups;
+				}
+				if (0U != (numberOfEscapeGroups % 2U))
+				{
+					endOfSmlFile = position + endSequenceLength;
+				}
+			}
+		}
+		return endOfSmlFile;
+	}
+	
+	// ---------------------------------------------------------------------
+	// 2.3 Give access to the data received by the last read call
+	const EhzDatabyte *EhzSerialPort::getLastReceivedBytes(size_t &numberOfBytes) const
+	{
+		numberOfBytes = numberOfLastReceivedBytes;
+		// In single byte mode we have only the one byte
+		return (SerialReadMode::SingleByte == serialReadMode) ? &databyte : &receiveBuffer[lastReceivedBytesStartIndex];
+	}
+	
+	// ---------------------------------------------------------------------
+	// 2.4 Close serial port and capture file
+	void EhzSerialPort::stop(void)
+	{
+		if (null<Handle>() != captureHandle)
+		{
+			close(captureHandle);
+			captureHandle = null<Handle>();
+		}
+		// An incomplete frame is thrown away
+		frameGapTimer.stopTimer();
+		frameGapTimerIsRunning = false;
+		numberOfFrameBytes = null<size_t>();
+		SerialPort::stop();
+	}
+
+	EhzSerialPort::~EhzSerialPort(void)
+	{
+		if (null<Handle>() != captureHandle)
+		{
+			close(captureHandle);
+		}
+	}
+	
+	// ---------------------------------------------------------------------
+	// 2.5 Capture file
+	
+	// A new file gets the file header. Data of an existing file are kept
+	void EhzSerialPort::openCaptureFile(void)
+	{
+		if (!captureFileName.empty() && (null<Handle>() == captureHandle))
+		{
+			//lint -e{9001} Octal constant used
+			captureHandle = open(captureFileName.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644U);
+			struct stat fileStatus;
+			if ((captureHandle < null<Handle>()) || (0 != fstat(captureHandle, &fileStatus)) ||
+				((0 == fileStatus.st_size) && (static_cast<ssize_t>(CaptureFileHeaderSize) != write(captureHandle, &CaptureFileMagic[0], CaptureFileHeaderSize))))
+			{
+				static LogSite logSite;
+				{
+					Log log(logSite);
+					log << "Error: Could not open capture file --> " << captureFileName;
+				}
+				if (captureHandle >= null<Handle>())
+				{
+					close(captureHandle);
+				}
+				captureHandle = null<Handle>();
+			}
+		}
+	}
+	
+	// Append the data of the last read call to the capture file
+	
+	// One record per read call. So the replay delivers the same blocks with the same timing
+	void EhzSerialPort::captureLastReceivedBytes(void)
+	{
+		if (null<Handle>() != captureHandle)
+		{
+			size_t numberOfBytes = null<size_t>();
+			const EhzDatabyte *const ehzDatabytes = EhzSerialPort::getLastReceivedBytes(numberOfBytes);
+			u64 timeInNs = MetricsInternal::getMonotonicTimeInNs();
+			uint numberOfBytesInRecord = static_cast<uint>(numberOfBytes);
+			//lint --e{1773,9005}
+			struct iovec captureRecord[3] =
+			{
+				{ &timeInNs, sizeof(timeInNs) },
+				{ &numberOfBytesInRecord, sizeof(numberOfBytesInRecord) },
+				{ const_cast<EhzDatabyte *>(ehzDatabytes), numberOfBytes }
+			};
+			// With O_APPEND the record is written in one piece. A write error stops the recording
+			if (static_cast<ssize_t>(CaptureRecordHeaderSize + numberOfBytes) != writev(captureHandle, &captureRecord[0], 3))
+			{
+				static LogSite logSite;
+				{
+					Log log(logSite);
+					log << "Error: Could not write capture file --> " << captureFileName;
+				}
+				close(captureHandle);
+				captureHandle = null<Handle>();
+			}
+		}
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. Replay of a capture file
+
+namespace SerialInternal
+{
+	// ---------------------------------------------------------------------
+	// 3.1 Constructor and destructor
+	
+	EhzReplayPort::EhzReplayPort(const std::string &captureFileNameForReplay, const u32 rs) : EhzSerialPort(captureFileNameForReplay), replaySpeed(rs), 
+																	capture(null<const EhzDatabyte *>()), captureSize(null<size_t>()), readPosition(null<size_t>()),
+																	firstRecordTimeInNs(null<u64>()), replayStartTimeInNs(null<u64>()), lastReceivedBytes(&databyte)
+	{
+	}
+	
+	EhzReplayPort::~EhzReplayPort(void)
+	{
+		if (null<const EhzDatabyte *>() != capture)
+		{
+			//lint -e{534,1773}
+			munmap(const_cast<EhzDatabyte *>(capture), captureSize);
+		}
+	}
+	
+	// ---------------------------------------------------------------------
+	// 3.2 Map the capture file and start the timer
+	
+	// The mapping is private and read only. Many virtual meters may replay the same file. They share the pages
+	void EhzReplayPort::start(void)
+	{
+		if ((null<Handle>() == handle) && (null<const EhzDatabyte *>() == capture))
+		{
+			const Handle captureFileHandle = open(portName.c_str(), O_RDONLY);
+			struct stat fileStatus;
+			if ((captureFileHandle >= null<Handle>()) && (0 == fstat(captureFileHandle, &fileStatus)) && (static_cast<size_t>(fileStatus.st_size) > CaptureFileHeaderSize))
+			{
+				void *const memory = mmap(null<void *>(), static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, captureFileHandle, 0);
+				if (MAP_FAILED != memory)
+				{
+					//lint -e{534}
+					madvise(memory, static_cast<size_t>(fileStatus.st_size), MADV_SEQUENTIAL);
+					capture = static_cast<const EhzDatabyte *>(memory);
+					captureSize = static_cast<size_t>(fileStatus.st_size);
+				}
+			}
+			if (captureFileHandle >= null<Handle>())
+			{
+				close(captureFileHandle);
+			}
+			
+			// The file must have the header and at least one complete record
+			u64 recordTimeInNs = null<u64>();
+			uint numberOfBytes = null<uint>();
+			readPosition = CaptureFileHeaderSize;
+			if ((null<const EhzDatabyte *>() != capture) && (0 == memcmp(capture, &CaptureFileMagic[0], CaptureFileHeaderSize)) && readRecordHeader(recordTimeInNs, numberOfBytes))
+			{
+				firstRecordTimeInNs = recordTimeInNs;
+				handle = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+				if (handle >= null<Handle>())
+				{
+					rewind();
+					setTimerForNextRecord();
+				}
+				else
+				{
+					handle = null<Handle>();
+				}
+			}
+			if (null<Handle>() == handle)
+			{
+				static LogSite logSite;
+				{
+					Log log(logSite);
+					log << "Error: Could not replay capture file --> " << portName;
+				}
+				stop();
+			}
+		}
+	}
+	
+	void EhzReplayPort::stop(void)
+	{
+		EhzSerialPort::stop();
+		if (null<const EhzDatabyte *>() != capture)
+		{
+			//lint -e{534,1773}
+			munmap(const_cast<EhzDatabyte *>(capture), captureSize);
+			capture = null<const EhzDatabyte *>();
+			captureSize = null<size_t>();
+		}
+	}
+	
+	// ---------------------------------------------------------------------
+	// 3.3 Records and time
+	
+	// The record may be unaligned in the file. So the numbers are copied
+	boolean EhzReplayPort::readRecordHeader(u64 &recordTimeInNs, uint &numberOfBytes) const
+	{
+		boolean rc = ((readPosition + CaptureRecordHeaderSize) <= captureSize);
+		if (rc)
+		{
+			memcpy(&recordTimeInNs, &capture[readPosition], sizeof(recordTimeInNs));
+			memcpy(&numberOfBytes, &capture[readPosition + sizeof(recordTimeInNs)], sizeof(numberOfBytes));
+			// A record, that has been cut off at the end of the file, is ignored
+			rc = ((readPosition + CaptureRecordHeaderSize + numberOfBytes) <= captureSize);
+		}
+		return rc;
+	}
+	
+	// The distances between the records are divided by the replay speed
+	u64 EhzReplayPort::getDueTimeInNs(const u64 recordTimeInNs) const
+	{
+		u64 dueTimeInNs = null<u64>();
+		if (ReplaySpeedAsFastAsPossible != replaySpeed)
+		{
+			dueTimeInNs = replayStartTimeInNs + ((recordTimeInNs - firstRecordTimeInNs) / replaySpeed);
+		}
+		return dueTimeInNs;
+	}
+	
+	void EhzReplayPort::rewind(void)
+	{
+		readPosition = CaptureFileHeaderSize;
+		replayStartTimeInNs = MetricsInternal::getMonotonicTimeInNs();
+	}
+	
+	// An absolute time in the past lets the timerfd expire immediately. 0 would disarm it
+	void EhzReplayPort::setTimerForNextRecord(void)
+	{
+		u64 recordTimeInNs = null<u64>();
+		uint numberOfBytes = null<uint>();
+		if (!readRecordHeader(recordTimeInNs, numberOfBytes))
+		{
+			rewind();
+			//lint -e{534}  The first record has been checked in start
+			readRecordHeader(recordTimeInNs, numberOfBytes);
+		}
+		const u64 dueTimeInNs = std::max(getDueTimeInNs(recordTimeInNs), static_cast<u64>(1U));
+		struct itimerspec its;
+		its.it_interval.tv_sec = 0;
+		its.it_interval.tv_nsec = 0;
+		its.it_value.tv_sec = static_cast<time_t>(dueTimeInNs / 1000000000ULL);
+		its.it_value.tv_nsec = static_cast<long>(dueTimeInNs % 1000000000ULL);
+		//lint -e{534}
+		timerfd_settime(handle, TFD_TIMER_ABSTIME, &its, null<struct itimerspec *>());
+	}
+	
+	// ---------------------------------------------------------------------
+	// 3.4 Timer expired. Hand over the records that are due. One notification per record
+	
+	EventProcessing::Action EhzReplayPort::handleEvent(const EventType et)
+	{
+		const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Input);
+		EventProcessing::Action rc = EventProcessing::Continue;
+		if (EventTypeIn == et)
+		{
+			u64 numberOfExpirations = null<u64>();
+			//lint -e{534}  Nothing to read, if the timer has been set again in the meantime
+			read(handle, &numberOfExpirations, sizeof(numberOfExpirations));
+			
+			boolean recordIsDue = true;
+			for (uint i = null<uint>(); recordIsDue && (i < ReplayMaximumNumberOfRecordsPerEvent); ++i)
+			{
+				u64 recordTimeInNs = null<u64>();
+				uint numberOfBytes = null<uint>();
+				if (!readRecordHeader(recordTimeInNs, numberOfBytes))
+				{
+					// End of the capture. Start again
+					rewind();
+					//lint -e{534}
+					readRecordHeader(recordTimeInNs, numberOfBytes);
+				}
+				recordIsDue = (getDueTimeInNs(recordTimeInNs) <= MetricsInternal::getMonotonicTimeInNs());
+				if (recordIsDue)
+				{
+					lastReceivedBytes = &capture[readPosition + CaptureRecordHeaderSize];
+					numberOfLastReceivedBytes = numberOfBytes;
+					readPosition += CaptureRecordHeaderSize + numberOfBytes;
+					if (null<uint>() != numberOfBytes)
+					{
+						TraceInternal::traceInstant(TraceInternal::TraceProbe::SerialRead, numberOfBytes);
+						databyte = lastReceivedBytes[numberOfBytes - 1U];
+						notifySubscribers();
+					}
+				}
+			}
+			setTimerForNextRecord();
+		}
+		else
+		{
+			rc = EventProcessing::Stop;
+		}
+		return rc;
+	}
+	
+	const EhzDatabyte *EhzReplayPort::getLastReceivedBytes(size_t &numberOfBytes) const
+	{
+		numberOfBytes = numberOfLastReceivedBytes;
+		return lastReceivedBytes;
+	}
+}
+
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. Meter attached via the network
+
+namespace SerialInternal
+{
+	// ---------------------------------------------------------------------
+	// 4.1 Constructor and destructor
+	
+	// The port name is only used for messages
+	EhzNetworkPort::EhzNetworkPort(const std::string &hostName, const std::string &portNameOrNumber) : EhzSerialPort(hostName + ':' + portNameOrNumber),
+																	Subscriber<AcceptorConnectorInternal::Connector>(),
+																	networkHostName(hostName), networkPortNameOrNumber(portNameOrNumber),
+																	connector(new AcceptorConnectorInternal::Connector(networkPortNameOrNumber, networkHostName)),
+																	reconnectTimer(NetworkReconnectMinimumDelayInMs), reconnectDelayInMs(NetworkReconnectMinimumDelayInMs),
+																	receiveIdleTimer(NetworkReceiveIdleTimeoutInMs), dataReceivedSinceIdleCheck(false), started(false)
+	{
+		connector->addSubscription(this);
+		reconnectTimer.addSubscription(this);
+		receiveIdleTimer.addSubscription(this);
+	}
+	
+	EhzNetworkPort::~EhzNetworkPort(void)
+	{
+		try
+		{
+			reconnectTimer.stopTimer();
+			reconnectTimer.removeSubscription(this);
+			receiveIdleTimer.stopTimer();
+			receiveIdleTimer.removeSubscription(this);
+			connector->removeSubscription(this);
+			delete connector;
+		}
+		catch(...)
+		{
+		}
+	}
+	
+	// ---------------------------------------------------------------------
+	// 4.2 Start and stop
+	
+	// Like a serial port, the network port runs in the thread, that started it. Connector and timer use the reactor of this thread
+	void EhzNetworkPort::start(void)
+	{
+		if (!started)
+		{
+			started = true;
+			openCaptureFile();
+			reconnectDelayInMs = NetworkReconnectMinimumDelayInMs;
+			connect();
+		}
+	}
+	
+	void EhzNetworkPort::stop(void)
+	{
+		started = false;
+		reconnectTimer.stopTimer();
+		receiveIdleTimer.stopTimer();
+		connector->cancel();
+		if (null<Handle>() != handle)
+		{
+			reactorUnRegisterEventHandler(this);
+		}
+		EhzSerialPort::stop();
+	}
+	
+	// ---------------------------------------------------------------------
+	// 4.3 Connect and disconnect
+	
+	// If the connection cannot be made immediately, the connector will notify us later. Or the timer expires before
+	void EhzNetworkPort::connect(void)
+	{
+		connector->start();
+		if (null<Handle>() == handle)
+		{
+			reconnectTimer.setTimerValues(reconnectDelayInMs);
+			reconnectTimer.startTimerOneShot();
+			reconnectDelayInMs = std::min(2U * reconnectDelayInMs, NetworkReconnectMaximumDelayInMs);
+		}
+	}
+	
+	// Only the socket is closed. The capture file continues with the next connection
+	void EhzNetworkPort::disconnect(void)
+	{
+		static LogSite logSite;
+		{
+			Log log(logSite);
+			log << "Connection lost to meter at " << portName << ". Reconnect in " << reconnectDelayInMs << " ms";
+		}
+		receiveIdleTimer.stopTimer();
+		reactorUnRegisterEventHandler(this);
+		SerialPort::stop();
+		reconnectTimer.setTimerValues(reconnectDelayInMs);
+		reconnectTimer.startTimerOneShot();
+	}
+	
+	// Without the options the connection stays open, even if the peer is gone. Failing is not critical: the idle timer is still there
+	void EhzNetworkPort::setKeepAlive(void)
+	{
+		const sint on = 1;
+		boolean rc = (0 == setsockopt(handle, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on)));
+		rc = rc && (0 == setsockopt(handle, IPPROTO_TCP, TCP_KEEPIDLE, &NetworkKeepAliveIdleInS, sizeof(NetworkKeepAliveIdleInS)));
+		rc = rc && (0 == setsockopt(handle, IPPROTO_TCP, TCP_KEEPINTVL, &NetworkKeepAliveIntervalInS, sizeof(NetworkKeepAliveIntervalInS)));
+		rc = rc && (0 == setsockopt(handle, IPPROTO_TCP, TCP_KEEPCNT, &NetworkKeepAliveProbes, sizeof(NetworkKeepAliveProbes)));
+		if (!rc)
+		{
+			static LogSite logSite;
+			Log log(logSite);
+			log << "Keep alive not set for meter at " << portName << ": " << strerror(errno);
+		}
+	}
+	
+	// The connector forgets the socket. From now on it is the handle of this port
+	void EhzNetworkPort::update(AcceptorConnectorInternal::Connector *)
+	{
+		reconnectTimer.stopTimer();
+		handle = connector->takeOverHandle();
+		setKeepAlive();
+		reactorRegisterEventHandler(this, EventTypeIn);
+		dataReceivedSinceIdleCheck = false;
+		receiveIdleTimer.startTimerPeriodic();
+	}
+	
+	// A connect, that has not finished until now, is given up. Then try again
+	// A connection, that delivered nothing since the last idle check, is closed and made again
+	void EhzNetworkPort::update(EventTimer *publisher)
+	{
+		if (&reconnectTimer == publisher)
+		{
+			if (started && (null<Handle>() == handle))
+			{
+				connector->cancel();
+				connect();
+			}
+		}
+		else if (&receiveIdleTimer == publisher)
+		{
+			if (null<Handle>() != handle)
+			{
+				if (dataReceivedSinceIdleCheck)
+				{
+					dataReceivedSinceIdleCheck = false;
+				}
+				else
+				{
+					static LogSite logSite;
+					{
+						Log log(logSite);
+						log << "No data from meter at " << portName << " for " << NetworkReceiveIdleTimeoutInMs << " ms";
+					}
+					disconnect();
+				}
+			}
+		}
+		else
+		{
+			EhzSerialPort::update(publisher);
+		}
+	}
+	
+	// ---------------------------------------------------------------------
+	// 4.4 Data received or connection lost
+	
+	// Pending data are read first. The end of the connection is then seen by the read call
+	EventProcessing::Action EhzNetworkPort::handleEvent(const EventType et)
+	{
+		const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Input);
+		//lint --e{921} 921 Cast from Type to Type --
+		boolean connectionIsLost = (0 != (static_cast<sint>(et) & static_cast<sint>(EventTypeError | EventTypeHangup)));
+		if (0 != (static_cast<sint>(et) & static_cast<sint>(EventTypeIn)))
+		{
+			const ssize_t bytesRead = readBlock();
+			if (bytesRead > 0)
+			{
+				// The remote end delivers. The next reconnect will be fast again
+				reconnectDelayInMs = NetworkReconnectMinimumDelayInMs;
+				dataReceivedSinceIdleCheck = true;
+				connectionIsLost = false;
+			}
+			else
+			{
+				// Zero bytes: the remote end closed the connection
+				connectionIsLost = ((0 == bytesRead) || ((EAGAIN != errno) && (EINTR != errno)));
+			}
+		}
+		if (connectionIsLost)
+		{
+			disconnect();
+		}
+		return EventProcessing::Continue;
+	}
+}
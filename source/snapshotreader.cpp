@@ -0,0 +1,116 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// snapshotreader.cpp
+//
+// General Description
+//
+// The reader of the shared memory segment with the latest values of all EHZ.
+// This is the only module of the library libehzsnapshot.a. It does not depend on the rest of the EHZ program
+// See snapshotsegment.hpp for the layout and the sequence lock
+//
+
+
+
+#include "snapshotsegment.hpp"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. The reader
+
+	namespace SnapshotSegmentInternal
+	{
+		// 3.1 Constructor. Map the segment read only and check the header
+		SnapshotSegmentReader::SnapshotSegmentReader(const mchar *const segmentName) : header(null<const SharedSnapshotHeader *>()), ehz(null<const SharedSnapshotEhz *>()), numberOfEhz(null<uint>()), segmentSize(null<size_t>()), writerStarts(null<u64>())
+		{
+			const Handle handle = shm_open(segmentName, O_RDONLY, 0U);
+			if (handle >= 0)
+			{
+				struct stat fileStatus;
+				if ((0 == fstat(handle, &fileStatus)) && (static_cast<size_t>(fileStatus.st_size) >= sizeof(SharedSnapshotHeader)))
+				{
+					const size_t mappedSize = static_cast<size_t>(fileStatus.st_size);
+					void *const memory = mmap(null<void *>(), mappedSize, PROT_READ, MAP_SHARED, handle, 0);
+					if (MAP_FAILED != memory)
+					{
+						//lint -e{826,9176}
+						const SharedSnapshotHeader *const mappedHeader = static_cast<const SharedSnapshotHeader *>(memory);
+						// The writer sets the magic after all other fields of the header
+						const boolean valid = (SnapshotSegmentMagic == __atomic_load_n(&mappedHeader->magic, __ATOMIC_ACQUIRE)) && (SnapshotSegmentVersion == mappedHeader->version) && 
+											  (sizeof(SharedSnapshotHeader) == mappedHeader->headerSize) && (sizeof(SharedSnapshotEhz) == mappedHeader->ehzSize) &&
+											  (sizeof(SharedSnapshotValue) == mappedHeader->valueSize) && (NumberOfEhzMeasuredData == mappedHeader->numberOfValues) &&
+											  (getSnapshotSegmentSize(mappedHeader->numberOfEhz) <= mappedSize);
+						if (valid)
+						{
+							header = mappedHeader;
+							//lint -e{826,9176}
+							ehz = reinterpret_cast<const SharedSnapshotEhz *>(static_cast<const u8 *>(memory) + sizeof(SharedSnapshotHeader));
+							numberOfEhz = mappedHeader->numberOfEhz;
+							segmentSize = mappedSize;
+							writerStarts = __atomic_load_n(&mappedHeader->writerStarts, __ATOMIC_RELAXED);
+						}
+						else
+						{
+							//lint -e{534}
+							munmap(memory, mappedSize);
+						}
+					}
+				}
+				// The mapping stays valid after closing the handle
+				//lint -e{534}
+				close(handle);
+			}
+		}
+		
+		//lint -e{1579}
+		SnapshotSegmentReader::~SnapshotSegmentReader(void)
+		{
+			if (isOpen())
+			{
+				//lint -e{534,1773}
+				munmap(const_cast<SharedSnapshotHeader *>(header), segmentSize);
+			}
+		}
+		
+		// 3.2 Copy the block of one EHZ. Repeat until the writer did not change it during the copy
+		boolean SnapshotSegmentReader::read(const uint ehzIndex, SharedSnapshotEhz &sharedSnapshotEhz) const
+		{
+			const boolean rc = isOpen() && (ehzIndex < numberOfEhz);
+			if (rc)
+			{
+				u64 sequence;
+				do
+				{
+					sequence = beginRead(ehzIndex);
+					memcpy(&sharedSnapshotEhz, &ehz[ehzIndex], sizeof(SharedSnapshotEhz));
+				} while (!isReadValid(ehzIndex, sequence));
+			}
+			return rc;
+		}
+	}
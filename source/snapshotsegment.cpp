@@ -0,0 +1,166 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// snapshotsegment.cpp
+//
+// General Description
+//
+// The writer of the shared memory segment with the latest values of all EHZ.
+// See snapshotsegment.hpp for the layout and the sequence lock
+//
+
+
+
+#include "snapshotsegment.hpp"
+#include "ehzmeasureddata.hpp"
+#include "userinterface.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. The writer
+
+	namespace SnapshotSegmentInternal
+	{
+		// 2.1 Constructor. Create and map the segment
+		SnapshotSegmentWriter::SnapshotSegmentWriter(const mchar *const segmentName, const uint numberOfEhzl) : numberOfEhz(numberOfEhzl), header(null<SharedSnapshotHeader *>()), ehz(null<SharedSnapshotEhz *>())
+		{
+			const size_t segmentSize = getSnapshotSegmentSize(numberOfEhz);
+			// Readers need only read access
+			const Handle handle = shm_open(segmentName, O_RDWR | O_CREAT, 0644U);
+			if (handle < 0)
+			{
+				ui << "Snapshot: Could not open shared memory " << segmentName << std::endl;
+			}
+			else
+			{
+				// Readers may have mapped an existing segment with its size. Making it smaller lets them crash (SIGBUS)
+				struct stat fileStatus;
+				const boolean isLargeEnough = (0 == fstat(handle, &fileStatus)) && (static_cast<size_t>(fileStatus.st_size) >= segmentSize);
+				if (isLargeEnough || (0 == ftruncate(handle, static_cast<off_t>(segmentSize))))
+				{
+					void *const memory = mmap(null<void *>(), segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+					if (MAP_FAILED != memory)
+					{
+						//lint -e{826,9176}
+						header = static_cast<SharedSnapshotHeader *>(memory);
+						//lint -e{826,9176}
+						ehz = reinterpret_cast<SharedSnapshotEhz *>(static_cast<u8 *>(memory) + sizeof(SharedSnapshotHeader));
+						
+						// Readers that start now must wait until the header is complete
+						__atomic_store_n(&header->magic, null<uint>(), __ATOMIC_RELAXED);
+						header->version = SnapshotSegmentVersion;
+						header->headerSize = static_cast<uint>(sizeof(SharedSnapshotHeader));
+						header->ehzSize = static_cast<uint>(sizeof(SharedSnapshotEhz));
+						header->valueSize = static_cast<uint>(sizeof(SharedSnapshotValue));
+						header->numberOfEhz = numberOfEhz;
+						header->numberOfValues = NumberOfEhzMeasuredData;
+						for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+						{
+							// The sequence of an existing segment continues. A reader of the old values sees the change
+							// If the last writer stopped in the middle of an update, the sequence is made even again
+							SharedSnapshotEhz &sse = ehz[ehzIndex];
+							const u64 sequence = __atomic_load_n(&sse.sequence, __ATOMIC_RELAXED);
+							__atomic_store_n(&sse.sequence, sequence + 1ULL + (sequence & 1ULL), __ATOMIC_RELAXED);
+							__atomic_thread_fence(__ATOMIC_RELEASE);
+							sse.timeWhenDataHasBeenEvaluated = null<s64>();
+							sse.generation = null<u64>();
+							std::fill(&sse.reserved[0], &sse.reserved[5], null<u64>());
+							memset(&sse.value[0], 0, sizeof(sse.value));
+							__atomic_store_n(&sse.sequence, sequence + 2ULL + (sequence & 1ULL), __ATOMIC_RELEASE);
+						}
+						// Readers of the old layout see, that they must map the segment again
+						__atomic_store_n(&header->writerStarts, header->writerStarts + 1ULL, __ATOMIC_RELAXED);
+						__atomic_store_n(&header->magic, SnapshotSegmentMagic, __ATOMIC_RELEASE);
+						ui << "Snapshot: Values are published in shared memory " << segmentName << std::endl;
+					}
+				}
+				if (!isOpen())
+				{
+					ui << "Snapshot: Could not map shared memory " << segmentName << std::endl;
+				}
+				// The mapping stays valid after closing the handle
+				//lint -e{534}
+				close(handle);
+			}
+		}
+		
+		// 2.2 Destructor. The segment stays in /dev/shm with the last values
+		//lint -e{1579}
+		SnapshotSegmentWriter::~SnapshotSegmentWriter(void)
+		{
+			try
+			{
+				if (isOpen())
+				{
+					//lint -e{534}
+					munmap(header, getSnapshotSegmentSize(numberOfEhz));
+				}
+			}
+			catch(...)
+			{
+			}
+		}
+		
+		
+		// 2.3 Copy the values of one EHZ into its block. The block is locked with its sequence
+		void SnapshotSegmentWriter::publish(const uint ehzIndex, const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz)
+		{
+			if (isOpen() && (ehzIndex < numberOfEhz))
+			{
+				SharedSnapshotEhz &sse = ehz[ehzIndex];
+				const u64 sequence = sse.sequence;
+				// Odd: Readers must not use the block. The values must not be written before the sequence
+				__atomic_store_n(&sse.sequence, sequence + 1ULL, __ATOMIC_RELAXED);
+				__atomic_thread_fence(__ATOMIC_RELEASE);
+				
+				sse.timeWhenDataHasBeenEvaluated = static_cast<s64>(allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated);
+				++sse.generation;
+				for (uint valueIndex = null<uint>(); valueIndex < NumberOfEhzMeasuredData; ++valueIndex)
+				{
+					const EhzInternal::OneMeasuredValueForOneEhz &omv = allMeasuredValuesForOneEhz.measuredValueForOneEhz[valueIndex];
+					SharedSnapshotValue &ssv = sse.value[valueIndex];
+					ssv.mantissa = omv.mantissa;
+					ssv.status = omv.status;
+					ssv.doubleValue = omv.doubleValue;
+					ssv.scaler = omv.scaler;
+					ssv.unitIndex = omv.unitIndex;
+					const size_t textLength = std::min(omv.smlByteString.size(), static_cast<size_t>(SnapshotTextLength));
+					ssv.textLength = static_cast<u16>(textLength);
+					//lint -e{534}
+					omv.smlByteString.copy(&ssv.text[0], textLength);
+				}
+				
+				// Even again: The block is consistent
+				__atomic_store_n(&sse.sequence, sequence + 2ULL, __ATOMIC_RELEASE);
+				//lint -e{534}
+				__atomic_add_fetch(&header->generation, 1ULL, __ATOMIC_RELEASE);
+			}
+		}
+	}
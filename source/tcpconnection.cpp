@@ -1,668 +1,1823 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-//
-// tcpconnection.hpp
-//
-//
-// General Description
-//
-// This module is a part of an application tor read the data from Electronic Meters for Electric Power
-//
-// In Germany they are called EHZ. Hence the name of the module an variables.
-//
-// The EHZ transmits data via an infrared interface. The protocoll is described in:
-//
-//  http://www.emsycon.de/downloads/SML_081112_103.pdf
-//
-// After data has been evaluated it will be provided to others for further usage.
-//
-// Server and Client classes for communicating data over a TCP Connection
-// Socket must be open and ready to use
-//
-// There are generic classes for Communication and EHZ specific classses.
-// Additionally a nano WebServer is present.
-//
-// Either all measured values from an EHZ can be shown or just the Powerstate are transmitted
-// With that it is possible to see, if there is spare power that can be consumed by special devices
-//
-
-
-
-#include "tcpconnection.hpp"
-#include "ehz.hpp"
-#include "reactor.hpp"
-#include "transfer.hpp"
-#include "timerevent.hpp"
-
-#include <sys/socket.h>
-#include <errno.h>
-
-#include <sstream>
-
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 1. General Definitions
-
-	const size_t EhzIndexForEhzPowerState = 1U;
-	const size_t EhzValueIndexForEhaPowerState = 3U;
-
-// ------------------------------------------------------------------------------------------------------------------------------
-// 2. Generic Base class for all TCP Connections
-			
-
-	// ------------------------------------------------------------------------
-	// 2.1 Event handler for TCP connection. The reactor got an read event
-	
-		EventProcessing::Action TcpConnectionBase::handleEvent(const EventType et)
-		{
-			// Standard eventhandler for TCP connections
-			// We assume that everything will be OK and that we will continue the main event loop of the reactor
-			EventProcessing::Action rc = EventProcessing::Continue;
-			//lint -e{911}   Note 911: Implicit expression promotion from short to int
-			// Check returned Event type. We asked for EventTypeIn  (POLLIN)
-			if (EventTypeIn == et)
-			{
-				// Data should be available. Read the data. Of course we have a top cap with buffer size.
-				// Reading is done buffered in chunks
-				const sint bytesRead = read(handle, &receivedRawData[0], MaxSizeReceiveBuffer);
-				// Did we read something
-				if (bytesRead > null<sint>())
-				{
-					//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
-					// Process the read data. Overloaded Function
-					// Every derived class can have a different handling of the read data
-					rc = handleReadData(bytesRead);
-				}
-				else if (null<sint>() == bytesRead)
-				{	
-					//lint -e{911}   Note 911: Implicit expression promotion from short to int
-
-					// Zero bytes read. This means: The peer closed the connection
-					
-					// Some debug stuff
-					static volatile sint i=1;
-					
-					ui << "TCP Connection " << i << " closed: " << getPeerIPAddress() << ':' <<  getPeerIPAddressPort() << std::endl;
-					++i;
-					
-					
-					// Inform others on this event. CLose the TCP connection
-					//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
-					notifySubscribers();
-				}
-				else
-				{
-					// Read return value was negative
-					
-					// This can happen if we got the info that an POLLIN event is available
-					// but meanwhile the connection has been closed.
-					// In an implementation with epoll, this could of course happen if there are
-					// tons of pending events but only few events processed in one run
-					if (ECONNRESET != errno)
-					{
-						// If the read function shows a different error then we will terminate the main event loop
-						rc = EventProcessing::Error;
-					}
-					ui << "TCP Connection  Error Data Server: "<< bytesRead << " Error Number: " << errno<< " "<< strerror(errno);
-					// In any case. Stop this connection
-					//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
-					notifySubscribers();
-				}
-			}
-			else
-			{
-				// For Events like POLLERR or POLLHUP or POLLRDHUP or something
-				// In any case. Stop and close this connection
-
-				// Debug messages	
-				sint result;
-				socklen_t result_len = sizeof(result);
-				// Check for error
-				const sint getsockoptResult = getsockopt(handle, SOL_SOCKET, SO_ERROR, &result, &result_len);
-				if (getsockoptResult >= null<sint>())
-				{
-					static volatile sint i = null<sint>();
-					ui << "------------------TCP Connection " << i << this << et << result << strerror(result) << std::endl;
-					
-					++i;
-				}
-				else
-				{
-					ui << "------------------Get Sock Option Error" << std::endl;
-				}
-
-				// Inform others on this event. Close the TCP connection
-				//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
-				notifySubscribers();
-			}
-			return rc; 	
-		}
-	
-	
-	
-// ------------------------------------------------------------------------------------------------------------------------------
-// 3. TCP Connection Server
-
-	// -------------------------------------------------------------------------------
-	// 3.1. TCP Connection Server for transmitting all measured values from all EHZ
-		
-		// Handle the data read by handleEvent
-		EventProcessing::Action TcpConnectionEhzDataServer::handleReadData(const sint )
-		{
-			//lint -e{911}   /Note 911: Implicit expression promotion from char to int
-			//ui << "TcpConnectionEhzDataServer::handleReadData   " <<receivedRawData[0] << std::endl;
-			// Wiat for a one digit request command
-			//lint -e{911,1960,917}   /
-			//Note 911: Implicit expression promotion from char to int
-			//Note 1960: Violates MISRA C++ 2008 Required Rule 5-0-4, Implicit conversion changes signedness
-			//Note 917: Prototype coercion (arg. no. 1) int to unsigned int
-			if (tcpConnectionGetEhzDataCommand[0] == receivedRawData[0])
-			{
-				//lint -e{1933} Note 1933: Call to unqualified virtual function 'TcpConnectionEhzDataServer::buildOutputData(void)' from non-static member function			
-				// Received request command
-				// Build the data that we want to send back
-				buildOutputData();
-				// And send back the data asynchronously
-				writeDataAsynchronous(outputData,handle);
-			}
-			// Continue main ecent loop of reactor
-			return EventProcessing::Continue;
-		}
-		
-		// Build the output data for an EhzDataServer
-		// Return the information of the complete EHZ system
-		void TcpConnectionEhzDataServer::buildOutputData(void)
-		{
-			std::ostringstream oss;
-			// Will call all child functions. Output all EhzSystem data in a raw format
-			// STX data1 US data2 US ... dataN US ETX
-			if (null<EhzSystem *>() == ehzSystem)
-			{
-				ui << "NULL Pointer derefencing in void TcpConnectionEhzDataServer::buildOutputData(void)" << std::endl;
-			}
-			else
-			{
-				oss << *ehzSystem;
-			}
-			outputData = oss.str();
-		}
-
-	// -------------------------------------------------------------------------------
-	// 3.2. TCP Connection Server for transmitting the overall Power state
-
-
-		// Inform other side, how many KW the complete system is using
-		// This is important for an avaluation, if solar power is available for usage or not.
-		void TcpConnectionEhzPowerStateServer::buildOutputData(void)
-		{
-			std::ostringstream oss;
-			//lint -e{1963,1950,9050}
-			// This is completely specific for my own system. For others it has to be adapted.
-			if (null<EhzSystem *>() == ehzSystem)
-			{
-				ui << "NULL Pointer derefencing in void TcpConnectionEhzPowerStateServer::buildOutputData(void)" << std::endl;
-			}
-			else
-			{
-				oss << charSTX << (ehzSystem->getEhzSystemResult()[EhzIndexForEhzPowerState].measuredValueForOneEhz[EhzValueIndexForEhaPowerState].doubleValue ) << charUS << charETX; 
-			}
-			outputData = oss.str();
-		}
-
-
-
-
-	// -------------------------------------------------------------------------------------
-	// 3.3. TCP Connection Server for transmitting all measured values from all EHZ in HTML
-
-		// Build an answer (without the HTML header) for a HTML GET request
-		// Build HTML for all EHZ System data
-		void TcpConnectionSimpleHtmlAnswer::buildOutputData(void)
-		{
-			//This will hold the complete HTML output page
-			std::ostringstream htmlOut;
-			
-			if (null<EhzSystem *>() == ehzSystem)
-			{
-				ui << "Dereferencing null pointer in void TcpConnectionSimpleHtmlAnswer::buildOutputData(void)"  << std::endl;
-			}
-			else
-			{
-				
-				
-				//lint -e{1963,1950,9050}
-				// Oh Oh. We misuse HTML tables for formatting
-				htmlOut << "<html><body><table border=""0"">";
-				
-				// For all EHZ in the EHZ system
-				for (uint noEhz = null<uint>(); noEhz < EhzInternal::MyNumberOfEhz; ++noEhz)
-				{
-					//lint -e{1963,1950,9050}
-					// Start HTML table and insert Name of the EHZ
-					htmlOut << "<tr><td><br><b>" << EhzInternal::myEhzConfigDefinition[noEhz].EhzName << "</b></td><td> </td><td> </td><td> </td></tr>";
-					// Now for each value for one of the EHZ in the EHZ system
-					for (uint noemd = null<uint>(); noemd< NumberOfEhzMeasuredData; ++noemd)
-					{
-						// Get the type of the value stored in the EHZ. Either Double or Text, or NULL (Nothing)
-						const EhzMeasuredDataType::Type emdt = EhzInternal::myEhzConfigDefinition[noEhz].ehzMeasuredDataType[noemd];
-						// If there is an associated value
-						if (EhzMeasuredDataType::Null != emdt)
-						{
-							//lint -e{1963,1950,9050}
-							htmlOut << "<tr><td>" << EhzInternal::myEhzConfigDefinition[noEhz].ehzDataValueDefinition[noemd].NameForDataValue << ":</td><td> </td><td>";
-							// Check the type of the value. Is either Number (Double) or Text
-							// and then define the type of the corresponding field
-							// Basically SQLITE doesnt care so much about types, but anyway. Lets assign the right type
-							if (EhzMeasuredDataType::Number == emdt)
-							{
-								// Type: Number / DOUBLE / Float
-								//lint -e{1963,1950,9050}
-								htmlOut << ehzSystem->getEhzSystemResult()[noEhz].measuredValueForOneEhz[noemd].doubleValue;
-							}
-							else
-							{
-								// Type: Text
-								//lint -e{1963,1950,9050}
-								htmlOut << ehzSystem->getEhzSystemResult()[noEhz].measuredValueForOneEhz[noemd].smlByteString.c_str();
-							}
-							//lint -e{1963,1950,9050}
-							htmlOut << " " << ehzSystem->getEhzSystemResult()[noEhz].measuredValueForOneEhz[noemd].unit.c_str() << "</td><td> </td></tr>";
-						}
-					}
-				}
-				//lint -e{1963,1950,9050}
-				htmlOut << "</table></body></html>";
-			}
-			// And copy to internal buffer
-			outputData = htmlOut.str();
-			
-
-		}
-
-	// -------------------------------------------------------------------------------------
-	// 3.4. Web Server for EHZ System specific data
-	
-		
-		// Handle read date given by handleEvent from the reactor
-		// This will implement a web server
-		// Wait for HTML GET header. Parse it. Send requested data back
-		EventProcessing::Action TcpConnectionSimpleHtmlAnswer::handleReadData(const sint bytesRead)
-		{
-			// For all bytes in the buffer read by handleEvent
-			for (sint byteIndex = null<sint>(); byteIndex < bytesRead; ++byteIndex)
-			{	
-				// Get the current byte out of the buffer
-				const mchar currentByte = receivedRawData[byteIndex];
-				// Ignore \r
-				//lint -e{911}   /Note 911: Implicit expression promotion from char to int
-				// Skip \r
-				if ('\r' != currentByte) 
-				{
-					// So. It was no \r. This is a small state machine for parsing the HTML GET string
-					// We expect: "GET <url> \n\n"
-					switch (state)
-					{
-						case StateWaitForGet:
-							{
-								// In the beginning we wait for the wort "GET "
-								const mchar gc[] = "GET ";
-								// Did we find the expected character
-								//lint -e{911}   /Note 911: Implicit expression promotion from char to int
-								if (gc[matchIndex] == currentByte)
-								{
-									// Then wait for next
-									++matchIndex;
-									const uint sz = (sizeof(gc)/sizeof(gc[0]))-1U;
-									// did we find all expected characters?
-									if (sz == matchIndex)
-									{
-										// If so, then reset internal variables for next try and goto next state
-										matchIndex = null<uint>();
-										// Now we want to read the URL
-										state = StateWaitForUrl;
-										// Reset URL to empty
-										url = "";
-									}
-								} 
-								else
-								{
-									// No, we did not find the expected character. 
-									// We will wait for the first character of the search string "GET " again
-									matchIndex = null<uint>();
-								}
-							}
-							break;
-							
-						// So. We read "GET ". Now we want to read the url	
-						case StateWaitForUrl:
-							//lint -e{911}   /Note 911: Implicit expression promotion from char to int
-							// The blank is the separator and shows the end of the url
-							if (' ' == currentByte)
-							{
-								// End of url string found. Go and wait for the end of the header (\n\n)
-								state = WaitForHeaderEnd;
-								// The headerLengthCounter is used as a safeguard. 
-								// If there are too many bytes, we will terminate the functionality
-								headerLengthCounter = null<sint>();
-								// This will count the newlines. We are waiting for 2
-								newLineCounter = null<sint>();
-							}
-							else
-							{
-								// Strill reading url. Add next byte to url string
-								url += currentByte;
-							}
-							break;
-							
-						// We have read the url and a blank. Now we are waiting for 2 \n as in indicator for end of header	
-						case WaitForHeaderEnd:
-							//lint -e{911}   /Note 911: Implicit expression promotion from char to int
-							// \n found?
-							if ('\n' == currentByte)
-							{	
-								++newLineCounter;
-								// If we found 2 \n in a row. The header is complete
-								if (2 == newLineCounter)
-								{
-									//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
-
-									// Build the HTML reply string
-									buildOutputData();
-									// Get the length (necessary for the header)
-									const std::string::size_type length = outputData.length();
-									
-									// Build the header for the reply string
-									std::ostringstream htmlOut;
-									//lint -e{1963,1950,9050}
-									htmlOut << "HTTP/1.1 200 OK\r\nContent-Length: " << length << "\r\n\r\n" << outputData;	
-
-									// Send complete reply to peer
-									writeDataAsynchronous(htmlOut,handle);
-									
-									// Wait for next GET command
-									state = StateWaitForGet;
-								}
-							}
-							else
-							{
-								// No 2 \n in a row
-								// Reset the counter for the next try
-								newLineCounter = null<sint>();
-								// Safeguard counter.
-								// If there are 2 many bytes without an end of header, we will stop parsing
-								++headerLengthCounter;
-								if (headerLengthCounter > maxHeaderLength)
-								{
-									// Wait for next get
-									state = StateWaitForGet;   
-								}
-							}
-							break;
-							
-						default:
-							// Should not happen
-							matchIndex = null<uint>();
-							state = StateWaitForGet;
-							break;
-					}
-				}
-			}
-			return EventProcessing::Continue;
-		}
-
-	// -------------------------------------------------------------------------------------
-	// 3.5. TCP Connection Server for transmitting the Powerstate of the EHZ System in HTML
-
-		// Inform other side, how many KW the complete system is using
-		// This is important for an evaluation, if solar power is available for usage or not.
-		void TcpConnectionSimpleHtmlAnswerPowerState::buildOutputData(void)
-		{
-			std::ostringstream htmlOut;
-			
-			if (null<EhzSystem *>() == ehzSystem)
-			{
-				ui << "Dereferencing NULL pointer in void TcpConnectionSimpleHtmlAnswerPowerState::buildOutputData(void)"  << std::endl;
-			}
-			else
-			{
-				//lint -e{1963,1950,9050}
-				htmlOut << "<html><body>Gesamtleistung: ";
-				//lint -e{1963,1950,9050}	
-				htmlOut << ehzSystem->getEhzSystemResult()[EhzIndexForEhzPowerState].measuredValueForOneEhz[EhzValueIndexForEhaPowerState].doubleValue;
-				//lint -e{1963,1950,9050}
-				htmlOut << ehzSystem->getEhzSystemResult()[EhzIndexForEhzPowerState].measuredValueForOneEhz[EhzValueIndexForEhaPowerState].unit.c_str();
-				//lint -e{1963,1950,9050}	
-				htmlOut << "</body></html>";
-			}
-			outputData = htmlOut.str();
-		}
-
-
-		
-		
-// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-	
-// ------------------------------------------------------------------------------------------------------------------------------
-// 4. TCP Connection Clients
-
-	// --------------------------------------------------------------------------------------------------------------------------
-	// 4.1 TCP Connection Client: Get EHZ System data from connected Server
-	
-	
-		// Get periodically data from a connected server
-
-		// ---------------------
-		// 4.1.1 Administration
-		
-			// Explicit constructor
-			TcpConnectionGetEhzDataClient::TcpConnectionGetEhzDataClient(const Handle connectionHandle, const u32 pollPeriod) : 	
-					TcpConnectionBase(connectionHandle),
-					Subscriber<EventTimer>(),
-					vEMDA(EhzInternal::MyNumberOfEhz),
-					requestCommand(&tcpConnectionGetEhzDataCommand[0]),
-					pollTimer(pollPeriod),
-					receivedDataAsStrings(),
-					convertedDataPart(),
-					state(StateWaitForStart)
-			{
-		
-			}
-
-			// private constructor. Must not be used
-			TcpConnectionGetEhzDataClient::TcpConnectionGetEhzDataClient(void) : 	
-					TcpConnectionBase(null<Handle>()),
-					Subscriber<EventTimer>(),
-					vEMDA(),
-					requestCommand(&tcpConnectionGetEhzDataCommand[0]),
-					pollTimer(null<u32>()),
-					receivedDataAsStrings(),
-					convertedDataPart(),
-					state()
-			{
-			}
-
-			// Destructor
-			TcpConnectionGetEhzDataClient::~TcpConnectionGetEhzDataClient(void)
-			{
-				try
-				{
-					// STop the Timer
-					TcpConnectionGetEhzDataClient::stopPoll();
-				}
-				catch(...)
-				{
-				}
-			}
-
-			
-			// Start the poll timer and add handler to reactor
-			 void TcpConnectionGetEhzDataClient::startPoll(void)  
-			 {
-				pollTimer.addSubscription(this); 
-				pollTimer.startTimerPeriodic();
-			}
-
-			 // Stop timer
-			 void TcpConnectionGetEhzDataClient::stopPoll(void)  
-			 {
-				
-				pollTimer.stopTimer();
-				pollTimer.removeSubscription(this);
-			}
-			
-			 // Override of Publisher function 
-			 // In case of stop of TCP connection we will first stop the poll timer
-			 void TcpConnectionGetEhzDataClient::notifySubscribers(void)
-			 {
-				//lint -e{1933}     Note 1933: Call to unqualified virtual function 'TcpConnectionGetEhzDataClient::stopPoll(void)' from non-static member function
-				stopPoll();
-				//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
-				TcpConnectionBase::notifySubscribers();
-			 }
-			
-			
-		// -------------------------------------
-		// 4.1.2 Update function for timer Event
-		
-			// The Client starts a timer and wants to get data from the connected peer for all x seconds
-			// Wen the timer fires the we handle this event here
-			// We will send one byte (the request command) in raw mode to the peer
-
-			void TcpConnectionGetEhzDataClient::update(EventTimer *const)
-			{
-				//ui << "TcpConnectionGetEhzDataClient::update(EventTimer  "  << std::endl;
-				if (null<Handle>() != handle)
-				{
-					//lint -e{925}    925 Cast from pointer to pointer
-					// Send the request. The server shall send data
-					ui << "TCP Client: Sending Get Request"  << std::endl;
-					
-					writeDataAsynchronous(requestCommand, handle);
-				}
-				
-			}
-
-
-
-		// -------------------------------------
-		// 4.1.3 Store received data
-
-			// The server sends the data in the format:
-			// STX data1 US data2 US ... dataN US ETX
-			// The data will be parsed an the result will be stored into a vector of strings
-			// This will be stored in the correct part for an EhzInternal::AllMeasuredValuesForOneEhz
-			void TcpConnectionGetEhzDataClient::setValuesFromStrings(std::vector<std::string>::iterator &iter)
-			{
-				// For the system
-				for (std::vector<EhzInternal::AllMeasuredValuesForOneEhz>::iterator emdaI = vEMDA.begin(); emdaI != vEMDA.end(); ++emdaI)
-				{
-					// For a single EHZ
-					(emdaI)->setValuesFromStrings(iter);
-				}
-			}
-
-
-
-		// ---------------------------------------------------
-		// 4.1.3 Handle data receive from handleEvent function
-		
-			EventProcessing::Action TcpConnectionGetEhzDataClient::handleReadData(const sint bytesRead)
-			{
-				// Assume that everything is OK
-				EventProcessing::Action rc = EventProcessing::Continue;
-				
-				// Check all bytes in the buffer
-				// Parse the sring received by the Server in the format
-				// STX data1 US data2 US ... dataN US ETX
-				
-				for (sint i = null<sint>(); i<bytesRead; i++)
-				{
-					switch (state)
-					{
-						// Wait for STX
-						case StateWaitForStart:
-							//lint -e{911}   /Note 911: Implicit expression promotion from char to int
-							if (charSTX == receivedRawData[i])
-							{
-								// If we saw an ETX, then we will read strings in the next step
-								state = StateDoConversion;
-								// Clear result string from one parse step
-								convertedDataPart.clear();
-							}
-							break;
-							
-						// Now we will read strings, separated by US	
-						case StateDoConversion:
-							// Is the current byte an US
-							//lint -e{911}   /Note 911: Implicit expression promotion from char to int
-							if (charUS == receivedRawData[i])
-							{
-								// If so, store the result in a vector of strings. Yes, copy data
-								receivedDataAsStrings.push_back(convertedDataPart);
-								// And reset container for next run
-								convertedDataPart.clear();
-							}
-							// Check for end of transmission
-							//lint -e{911}   /Note 911: Implicit expression promotion from char to int
-							else if (charETX == receivedRawData[i])
-							{
-								// ETX found. Stop function and reset state for next run
-								state = StateWaitForStart;
-								// And now store the read strings 
-								std::vector<std::string>::iterator iter = receivedDataAsStrings.begin();
-								// If there are strings at all
-								if (iter != receivedDataAsStrings.end())
-								{
-									//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
-									// The derived classes know where to store the strings
-									setValuesFromStrings(iter);
-									
-								}
-								// Make ready for next run. Reste internal variables
-								receivedDataAsStrings.clear();
-								
-								//Publisher<TcpConnectionGetEhzDataClient>::notifySubscribers(static_cast<vo*>(&vEMDA));
-							}
-							else
-							{
-								// Add next received byte to internal string
-								convertedDataPart += receivedRawData[i];
-							}
-							break;
-							
-						default:
-							// Should not happen
-							ui << "Conversion Error"  << std::endl;
-							// STop reactor Event loop
-							rc = EventProcessing::Error;
-							// Close TCP connection
-							TcpConnectionBase::notifySubscribers();
-							break;
-					}
-				}
-				return rc;
-			}
-
-
-
-
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+//
+// tcpconnection.hpp
+//
+//
+// General Description
+//
+// This module is a part of an application tor read the data from Electronic Meters for Electric Power
+//
+// In Germany they are called EHZ. Hence the name of the module an variables.
+//
+// The EHZ transmits data via an infrared interface. The protocoll is described in:
+//
+//  http://www.emsycon.de/downloads/SML_081112_103.pdf
+//
+// After data has been evaluated it will be provided to others for further usage.
+//
+// Server and Client classes for communicating data over a TCP Connection
+// Socket must be open and ready to use
+//
+// There are generic classes for Communication and EHZ specific classses.
+// Additionally a nano WebServer is present.
+//
+// Either all measured values from an EHZ can be shown or just the Powerstate are transmitted
+// With that it is possible to see, if there is spare power that can be consumed by special devices
+//
+
+
+
+#include "tcpconnection.hpp"
+#include "ehz.hpp"
+#include "reactor.hpp"
+#include "transfer.hpp"
+#include "timerevent.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+#include "allocation.hpp"
+#include "trace.hpp"
+
+#include <sys/socket.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <cctype>
+#include <ctime>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. General Definitions
+
+	const size_t EhzIndexForEhzPowerState = 1U;
+	const size_t EhzValueIndexForEhaPowerState = 3U;
+	
+	// One window of an aggregate: window US number of samples US min US max US avg US
+	static void writeWindowAggregate(std::ostringstream &oss, const uint window, const AggregateInternal::WindowAggregate &windowAggregate)
+	{
+		//lint -e{1963,9050}
+		oss << AggregateInternal::AggregationWindowInS[window] << charUS << windowAggregate.numberOfSamples << charUS << windowAggregate.minimum << charUS
+			<< windowAggregate.maximum << charUS << windowAggregate.average << charUS;
+	}
+	
+	// One early published value: scaled value US P|C US. The provisional value, if there is one. Else the published value
+	static void writeEarlyValue(std::ostringstream &oss, const EhzInternal::ProvisionalMeasuredValues &provisionalMeasuredValues, 
+								const EhzInternal::PublishedMeasuredValues &measuredValues, const uint ehzIndex, const uint valueId)
+	{
+		EhzInternal::OneMeasuredValueForOneEhz oneMeasuredValueForOneEhz;
+		if (provisionalMeasuredValues.get(ehzIndex, valueId, oneMeasuredValueForOneEhz))
+		{
+			//lint -e{1963,9050}
+			oss << oneMeasuredValueForOneEhz.getScaledValueAsString() << charUS << 'P' << charUS;
+		}
+		else
+		{
+			//lint -e{1963,9050}
+			oss << measuredValues[ehzIndex].measuredValueForOneEhz[valueId].getScaledValueAsString() << charUS << 'C' << charUS;
+		}
+	}
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Generic Base class for all TCP Connections
+			
+
+	// ------------------------------------------------------------------------
+	// 2.1 Event handler for TCP connection. The reactor got an read or write event
+	
+		EventProcessing::Action TcpConnectionBase::handleEvent(const EventType et)
+		{
+			const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Server);
+			// Standard eventhandler for TCP connections
+			// We assume that everything will be OK and that we will continue the main event loop of the reactor
+			EventProcessing::Action rc = EventProcessing::Continue;
+			//lint -e{911,921}   Note 911: Implicit expression promotion from short to int
+			// EventTypeOut is only monitored, as long as there is unsent data
+			if (EventTypeOut == (et & EventTypeOut))
+			{
+				handleWriteReady();
+			}
+			//lint -e{911,921}
+			const EventType eventTypeWithoutOut = static_cast<EventType>(et & ~EventTypeOut);
+			
+			//lint -e{911}   Note 911: Implicit expression promotion from short to int
+			// Check returned Event type. We asked for EventTypeIn  (POLLIN)
+			if (null<EventType>() == eventTypeWithoutOut)
+			{
+				// Only writable. Nothing more to do
+			}
+			else if (EventTypeIn == eventTypeWithoutOut)
+			{
+				boolean readMore = true;
+				while (readMore)
+				{
+					// Data should be available. Read the data. Of course we have a top cap with buffer size.
+					// Reading is done buffered in chunks
+					const sint bytesRead = read(handle, &receivedRawData[0], MaxSizeReceiveBuffer);
+					// With edge triggered events, everything must be read now. A full buffer means: There may be more
+					//lint -e{571,737}
+					readMore = (static_cast<size_t>(bytesRead) == MaxSizeReceiveBuffer);
+					// Did we read something
+					if (bytesRead > null<sint>())
+					{
+						//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
+						// Process the read data. Overloaded Function
+						// Every derived class can have a different handling of the read data
+						rc = handleReadData(bytesRead);
+						// The connection may have been closed meanwhile
+						readMore = readMore && (EventProcessing::Continue == rc) && (null<Handle>() != handle);
+					}
+					else if (null<sint>() == bytesRead)
+					{	
+						//lint -e{911}   Note 911: Implicit expression promotion from short to int
+
+						// Zero bytes read. This means: The peer closed the connection
+					
+						// Some debug stuff. The counter is shared by all reactor threads
+						static uint numberOfClosedConnections = null<uint>();
+						static LogSite logSite;
+						{
+							Log log(logSite);
+							log << "TCP Connection " << __atomic_add_fetch(&numberOfClosedConnections, 1U, __ATOMIC_RELAXED) << " closed: " << getPeerIPAddress() << ':' <<  getPeerIPAddressPort();
+						}
+					
+					
+						// Inform others on this event. CLose the TCP connection
+						//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
+						notifySubscribers();
+					}
+					else
+					{
+						// Read return value was negative
+					
+						// This can happen if we got the info that an POLLIN event is available
+						// but meanwhile the connection has been closed.
+						// In an implementation with epoll, this could of course happen if there are
+						// tons of pending events but only few events processed in one run
+						if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+						{
+							// Accepted sockets are non blocking. There was nothing to read. Wait for the next event
+						}
+						else
+						{
+							if (ECONNRESET != errno)
+							{
+								// If the read function shows a different error then we will terminate the main event loop
+								rc = EventProcessing::Error;
+							}
+							static LogSite logSite;
+							{
+								Log log(logSite);
+								log << "TCP Connection  Error Data Server: "<< bytesRead << " Error Number: " << errno<< " "<< strerror(errno);
+							}
+							// In any case. Stop this connection
+							//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
+							notifySubscribers();
+						}
+					}
+				}
+			}
+			else
+			{
+				// For Events like POLLERR or POLLHUP or POLLRDHUP or something
+				// In any case. Stop and close this connection
+
+				// Debug messages	
+				sint result;
+				socklen_t result_len = sizeof(result);
+				// Check for error
+				const sint getsockoptResult = getsockopt(handle, SOL_SOCKET, SO_ERROR, &result, &result_len);
+				static LogSite logSite;
+				Log log(logSite);
+				if (getsockoptResult >= null<sint>())
+				{
+					log << "------------------TCP Connection " << this << ' ' << et << ' ' << result << ' ' << strerror(result);
+				}
+				else
+				{
+					log << "------------------Get Sock Option Error";
+				}
+
+				// Inform others on this event. Close the TCP connection
+				//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
+				notifySubscribers();
+			}
+			return rc; 	
+		}
+		
+		
+	// ------------------------------------------------------------------------
+	// 2.2 Non blocking write with a queue
+	
+		// Wait for EventTypeOut only, if something could not be sent at once
+		void TcpConnectionBase::writeData(const SharedString &sharedString)
+		{
+			if ((null<Handle>() != handle) && !closeAfterWriteIsRequested)
+			{
+				//lint -e{571,737}
+				const TraceInternal::TraceSpan traceSpan(TraceInternal::TraceProbe::TcpWrite, static_cast<u64>(handle));
+				const TransferInternal::WriteQueue::WriteState writeState = writeQueue.write(sharedString, handle);
+				if (TransferInternal::WriteQueue::Pending == writeState)
+				{
+					//lint -e{921}
+					reactorModifyEventHandler(this, static_cast<EventType>(EventTypeIn | EventTypeOut));
+				}
+				else if (TransferInternal::WriteQueue::Complete == writeState)
+				{
+					//lint -e{571,737}
+					TraceInternal::traceInstant(TraceInternal::TraceProbe::TcpWriteComplete, static_cast<u64>(handle));
+				}
+				else
+				{
+					// Error. Seen by the next read
+				}
+			}
+		}
+		
+		// A write error is not handled here. The next read will show that the connection is broken
+		void TcpConnectionBase::handleWriteReady(void)
+		{
+			const TransferInternal::WriteQueue::WriteState writeState = writeQueue.flush(handle);
+			if (TransferInternal::WriteQueue::Pending != writeState)
+			{
+				reactorModifyEventHandler(this, EventTypeIn);
+			}
+			if (TransferInternal::WriteQueue::Complete == writeState)
+			{
+				//lint -e{571,737}
+				TraceInternal::traceInstant(TraceInternal::TraceProbe::TcpWriteComplete, static_cast<u64>(handle));
+				if (closeAfterWriteIsRequested)
+				{
+					//lint -e{534}
+					shutdown(handle, SHUT_WR);
+				}
+			}
+		}
+		
+		// Closing the socket at once could lose queued data. And with unread data from the peer, close sends a reset
+		// that may destroy the reply at the peer. So only the sending direction is shut down. The peer sees the end
+		// of the data and closes. Then we read 0 bytes and close, too
+		void TcpConnectionBase::closeAfterWrite(void)
+		{
+			if ((null<Handle>() != handle) && !closeAfterWriteIsRequested)
+			{
+				closeAfterWriteIsRequested = true;
+				if (writeQueue.isEmpty())
+				{
+					//lint -e{534}
+					shutdown(handle, SHUT_WR);
+				}
+			}
+		}
+	
+	
+	
+// ------------------------------------------------------------------------------------------------------------------------------
+// 3. TCP Connection Server
+
+	// -------------------------------------------------------------------------------
+	// 3.1. TCP Connection Server for transmitting all measured values from all EHZ
+		
+		// Handle the data read by handleEvent
+		EventProcessing::Action TcpConnectionEhzDataServer::handleReadData(const sint )
+		{
+			//lint -e{911}   /Note 911: Implicit expression promotion from char to int
+			//ui << "TcpConnectionEhzDataServer::handleReadData   " <<receivedRawData[0] << std::endl;
+			// Wiat for a one digit request command
+			//lint -e{911,1960,917}   /
+			//Note 911: Implicit expression promotion from char to int
+			//Note 1960: Violates MISRA C++ 2008 Required Rule 5-0-4, Implicit conversion changes signedness
+			//Note 917: Prototype coercion (arg. no. 1) int to unsigned int
+			if (tcpConnectionGetEhzDataCommand[0] == receivedRawData[0])
+			{
+				// Received request command
+				// Get the data that we want to send back. It is only built, if there are new values
+				// And send back the data asynchronously
+				writeData(getSharedReply());
+			}
+			//lint -e{911,1960,917}
+			else if (tcpConnectionGetEhzDataBinaryCommand[0] == receivedRawData[0])
+			{
+				writeData(getSharedBinaryReply());
+			}
+			//lint -e{911,1960,917}
+			else if ((tcpConnectionGetEhzAggregatesCommand[0] == receivedRawData[0]) && (null<EhzSystem *>() != ehzSystem))
+			{
+				buildAggregateOutputData();
+				writeData(outputData);
+			}
+			//lint -e{911,1960,917}
+			else if ((tcpConnectionGetEhzEarlyValuesCommand[0] == receivedRawData[0]) && (null<EhzSystem *>() != ehzSystem))
+			{
+				buildEarlyOutputData();
+				writeData(outputData);
+			}
+			else
+			{
+				// Unknown command. Ignore
+			}
+			// Continue main ecent loop of reactor
+			return EventProcessing::Continue;
+		}
+		
+		// Build the output data for an EhzDataServer
+		// Return the information of the complete EHZ system
+		void TcpConnectionEhzDataServer::buildOutputData(void)
+		{
+			std::ostringstream oss;
+			// Will call all child functions. Output all EhzSystem data in a raw format
+			// STX version US data1 US data2 US ... dataN US ETX
+			if (null<EhzSystem *>() == ehzSystem)
+			{
+				if (isMainReactorThread())
+				{
+					ui << "NULL Pointer derefencing in void TcpConnectionEhzDataServer::buildOutputData(void)" << std::endl;
+				}
+			}
+			else
+			{
+				const EhzInternal::PublishedMeasuredValues &measuredValues = getMeasuredValues();
+				oss << charSTX << EhzInternal::TextFormatVersionField << charUS;
+				for (uint ehzIndex = null<uint>(); ehzIndex < measuredValues.size(); ++ehzIndex)
+				{
+					oss << measuredValues[ehzIndex];
+				}
+				oss << charETX;
+			}
+			outputData = oss.str();
+		}
+		
+		// All windows of all numerical values with samples. The aggregates can be read in any thread
+		void TcpConnectionEhzDataServer::buildAggregateOutputData(void)
+		{
+			std::ostringstream oss;
+			const AggregateInternal::EhzWindowAggregates &windowAggregates = ehzSystem->getWindowAggregates();
+			const time_t nowTime = time(null<time_t *>());
+			AggregateInternal::WindowAggregate windowAggregate;
+			
+			oss << charSTX;
+			for (uint ehzIndex = null<uint>(); ehzIndex < EhzInternal::getNumberOfEhz(); ++ehzIndex)
+			{
+				const uint numberOfUsedEhzMeasuredData = EhzInternal::EhzSystemConfiguration::getInstance()->getNumberOfUsedEhzMeasuredData(ehzIndex);
+				for (uint valueId = null<uint>(); valueId < numberOfUsedEhzMeasuredData; ++valueId)
+				{
+					for (uint window = null<uint>(); window < AggregateInternal::NumberOfAggregationWindows; ++window)
+					{
+						if (windowAggregates.get(ehzIndex, valueId, window, nowTime, windowAggregate))
+						{
+							//lint -e{1963,9050}
+							oss << ehzIndex << charUS << valueId << charUS;
+							writeWindowAggregate(oss, window, windowAggregate);
+						}
+					}
+				}
+			}
+			oss << charETX;
+			outputData = oss.str();
+		}
+		
+		// All values of all Ehz, that are configured for early publication
+		void TcpConnectionEhzDataServer::buildEarlyOutputData(void)
+		{
+			std::ostringstream oss;
+			const EhzInternal::PublishedMeasuredValues &measuredValues = getMeasuredValues();
+			
+			oss << charSTX;
+			for (uint ehzIndex = null<uint>(); ehzIndex < measuredValues.size(); ++ehzIndex)
+			{
+				const u32 earlyPublication = EhzInternal::getEhzConfigDefinition(ehzIndex).EhzEarlyPublication;
+				for (uint valueId = null<uint>(); valueId < NumberOfEhzMeasuredData; ++valueId)
+				{
+					if (null<u32>() != (earlyPublication & (1UL << valueId)))
+					{
+						//lint -e{1963,9050}
+						oss << ehzIndex << charUS << valueId << charUS;
+						writeEarlyValue(oss, ehzSystem->getProvisionalMeasuredValues(), measuredValues, ehzIndex, valueId);
+					}
+				}
+			}
+			oss << charETX;
+			outputData = oss.str();
+		}
+		
+		// The main reactor reads the published values directly. A reactor thread takes a copy of the latest version
+		// There is one copy per reactor thread. It is shared by all connections of this thread
+		typedef char VersionReadersCheck[(MaxNumberOfReactors <= EhzInternal::MaxNumberOfVersionReaders) ? 1 : -1];
+		const EhzInternal::PublishedMeasuredValues &TcpConnectionEhzDataServer::getMeasuredValues(void)
+		{
+			static MeasuredValuesOfReactorThread measuredValuesOfReactorThread[MaxNumberOfReactors];
+			const EhzInternal::PublishedMeasuredValues *measuredValues = &ehzSystem->getEhzSystemResult();
+			const uint reactorIndex = getReactorIndexForThisThread();
+			if (null<uint>() != reactorIndex)
+			{
+				MeasuredValuesOfReactorThread &mvort = measuredValuesOfReactorThread[reactorIndex];
+				if (ehzSystem->getVersionedMeasuredValues().load(mvort.measuredValues, mvort.generation))
+				{
+					mvort.publishedMeasuredValues.assign(mvort.measuredValues, mvort.generation);
+				}
+				measuredValues = &mvort.publishedMeasuredValues;
+			}
+			return *measuredValues;
+		}
+		
+		// All raw data servers of one reactor share one reply
+		SharedReplyCache &TcpConnectionEhzDataServer::getSharedReplyCache(void)
+		{
+			static SharedReplyCache sharedReplyCache[MaxNumberOfReactors];
+			return sharedReplyCache[getReactorIndexForThisThread()];
+		}
+		
+		// Formatting is done once per generation of measured values and not for every request
+		const SharedString &TcpConnectionEhzDataServer::getSharedReply(void)
+		{
+			//lint -e{1933}
+			SharedReplyCache &sharedReplyCache = getSharedReplyCache();
+			const u64 generation = (null<EhzSystem *>() == ehzSystem) ? null<u64>() : getMeasuredValues().getGeneration();
+			if (!sharedReplyCache.isValid || (generation != sharedReplyCache.generation))
+			{
+				//lint -e{1933}
+				buildOutputData();
+				//lint -e{1933}
+				buildReply(generation);
+				sharedReplyCache.reply = SharedString(outputData);
+				sharedReplyCache.generation = generation;
+				sharedReplyCache.isValid = true;
+			}
+			return sharedReplyCache.reply;
+		}
+		
+		// The binary format is the same for all derived classes. So there is one cache
+		const SharedString &TcpConnectionEhzDataServer::getSharedBinaryReply(void)
+		{
+			static SharedReplyCache sharedBinaryReplyCaches[MaxNumberOfReactors];
+			SharedReplyCache &sharedBinaryReplyCache = sharedBinaryReplyCaches[getReactorIndexForThisThread()];
+			const u64 generation = (null<EhzSystem *>() == ehzSystem) ? null<u64>() : getMeasuredValues().getGeneration();
+			if (!sharedBinaryReplyCache.isValid || (generation != sharedBinaryReplyCache.generation))
+			{
+				std::string frame;
+				if (null<EhzSystem *>() == ehzSystem)
+				{
+					EhzInternal::encodeBinaryFrame(AllMeasuredValuesForAllEhz(), frame);
+				}
+				else
+				{
+					EhzInternal::encodeBinaryFrame(getMeasuredValues(), frame);
+				}
+				sharedBinaryReplyCache.reply = SharedString(frame);
+				sharedBinaryReplyCache.generation = generation;
+				sharedBinaryReplyCache.isValid = true;
+			}
+			return sharedBinaryReplyCache.reply;
+		}
+
+	// -------------------------------------------------------------------------------
+	// 3.2. TCP Connection Server for transmitting the overall Power state
+
+
+		// Inform other side, how many KW the complete system is using
+		// This is important for an avaluation, if solar power is available for usage or not.
+		void TcpConnectionEhzPowerStateServer::buildOutputData(void)
+		{
+			std::ostringstream oss;
+			//lint -e{1963,1950,9050}
+			// This is completely specific for my own system. For others it has to be adapted.
+			if (null<EhzSystem *>() == ehzSystem)
+			{
+				if (isMainReactorThread())
+				{
+					ui << "NULL Pointer derefencing in void TcpConnectionEhzPowerStateServer::buildOutputData(void)" << std::endl;
+				}
+			}
+			else
+			{
+				oss << charSTX << (getMeasuredValues()[EhzIndexForEhzPowerState].measuredValueForOneEhz[EhzValueIndexForEhaPowerState].getScaledValueAsString() ) << charUS << charETX; 
+			}
+			outputData = oss.str();
+		}
+		
+		// All windows of the power value. A window without samples has a count of 0
+		void TcpConnectionEhzPowerStateServer::buildAggregateOutputData(void)
+		{
+			std::ostringstream oss;
+			const AggregateInternal::EhzWindowAggregates &windowAggregates = ehzSystem->getWindowAggregates();
+			const time_t nowTime = time(null<time_t *>());
+			AggregateInternal::WindowAggregate windowAggregate;
+			
+			oss << charSTX;
+			for (uint window = null<uint>(); window < AggregateInternal::NumberOfAggregationWindows; ++window)
+			{
+				//lint -e{534}
+				windowAggregates.get(EhzIndexForEhzPowerState, EhzValueIndexForEhaPowerState, window, nowTime, windowAggregate);
+				writeWindowAggregate(oss, window, windowAggregate);
+			}
+			oss << charETX;
+			outputData = oss.str();
+		}
+		
+		// The power value. Provisional, if it is published early and its SML file is not yet verified
+		void TcpConnectionEhzPowerStateServer::buildEarlyOutputData(void)
+		{
+			std::ostringstream oss;
+			oss << charSTX;
+			writeEarlyValue(oss, ehzSystem->getProvisionalMeasuredValues(), getMeasuredValues(), EhzIndexForEhzPowerState, EhzValueIndexForEhaPowerState);
+			oss << charETX;
+			outputData = oss.str();
+		}
+		
+		SharedReplyCache &TcpConnectionEhzPowerStateServer::getSharedReplyCache(void)
+		{
+			static SharedReplyCache sharedReplyCache[MaxNumberOfReactors];
+			return sharedReplyCache[getReactorIndexForThisThread()];
+		}
+
+
+
+
+	// -------------------------------------------------------------------------------------
+	// 3.3. TCP Connection Server for transmitting all measured values from all EHZ in HTML
+
+		// Constructor. The idle timer runs from the beginning. A peer that never sends a request will be disconnected
+		TcpConnectionSimpleHtmlAnswer::TcpConnectionSimpleHtmlAnswer(const Handle connectionHandle) : 	TcpConnectionEhzDataServer(connectionHandle),
+																										Subscriber<EventTimer>(),
+																										state(StateWaitForGet),
+																										url(),
+																										headerLengthCounter(null<sint>()),
+																										newLineCounter(null<sint>()),
+																										matchIndex(null<uint>()),
+																										headerLine(),
+																										requestIsHttp10(false),
+																										requestConnectionClose(false),
+																										requestConnectionKeepAlive(false),
+																										requestEntityTag(),
+																										idleTimer(HttpKeepAliveTimeoutInMs)
+		{
+			idleTimer.addSubscription(this);
+			idleTimer.startTimerOneShot();
+		}
+		
+		// The timer must not be known by the reactor any longer
+		TcpConnectionSimpleHtmlAnswer::~TcpConnectionSimpleHtmlAnswer(void)
+		{
+			try
+			{
+				idleTimer.stopTimer();
+				idleTimer.removeSubscription(this);
+			}
+			catch(...)
+			{
+			}
+		}
+		
+		// The connection is closed. No more timer events
+		void TcpConnectionSimpleHtmlAnswer::stop(void)
+		{
+			idleTimer.stopTimer();
+			TcpConnectionEhzDataServer::stop();
+		}
+		
+		// No request during the idle time. Inform the acceptor. It will close the connection
+		void TcpConnectionSimpleHtmlAnswer::update(EventTimer *const)
+		{
+			static LogSite logSite;
+			{
+				Log log(logSite);
+				log << "HTTP connection idle: " << getPeerIPAddress() << ':' << getPeerIPAddressPort();
+			}
+			notifySubscribers();
+		}
+
+		// Build an answer (without the HTML header) for a HTML GET request
+		// Build HTML for all EHZ System data
+		void TcpConnectionSimpleHtmlAnswer::buildOutputData(void)
+		{
+			//This will hold the complete HTML output page
+			std::ostringstream htmlOut;
+			
+			if (null<EhzSystem *>() == ehzSystem)
+			{
+				if (isMainReactorThread())
+				{
+					ui << "Dereferencing null pointer in void TcpConnectionSimpleHtmlAnswer::buildOutputData(void)"  << std::endl;
+				}
+			}
+			else
+			{
+				
+				
+				//lint -e{1963,1950,9050}
+				// Oh Oh. We misuse HTML tables for formatting
+				htmlOut << "<html><body><table border=""0"">";
+				
+				// For all EHZ in the EHZ system
+				for (uint noEhz = null<uint>(); noEhz < EhzInternal::getNumberOfEhz(); ++noEhz)
+				{
+					//lint -e{1963,1950,9050}
+					// Start HTML table and insert Name of the EHZ
+					htmlOut << "<tr><td><br><b>" << EhzInternal::getEhzConfigDefinition(noEhz).EhzName << "</b></td><td> </td><td> </td><td> </td></tr>";
+					// Now for each value for one of the EHZ in the EHZ system
+					for (uint noemd = null<uint>(); noemd< NumberOfEhzMeasuredData; ++noemd)
+					{
+						// Get the type of the value stored in the EHZ. Either Double or Text, or NULL (Nothing)
+						const EhzMeasuredDataType::Type emdt = EhzInternal::getEhzConfigDefinition(noEhz).ehzMeasuredDataType[noemd];
+						// If there is an associated value
+						if (EhzMeasuredDataType::Null != emdt)
+						{
+							//lint -e{1963,1950,9050}
+							htmlOut << "<tr><td>" << EhzInternal::getEhzConfigDefinition(noEhz).ehzDataValueDefinition[noemd].NameForDataValue << ":</td><td> </td><td>";
+							// Check the type of the value. Is either Number (Double) or Text
+							// and then define the type of the corresponding field
+							// Basically SQLITE doesnt care so much about types, but anyway. Lets assign the right type
+							if (EhzMeasuredDataType::Number == emdt)
+							{
+								// Type: Number / DOUBLE / Float
+								//lint -e{1963,1950,9050}
+								htmlOut << getMeasuredValues()[noEhz].measuredValueForOneEhz[noemd].getScaledValueAsString();
+							}
+							else
+							{
+								// Type: Text
+								//lint -e{1963,1950,9050}
+								htmlOut << getMeasuredValues()[noEhz].measuredValueForOneEhz[noemd].smlByteString.c_str();
+							}
+							//lint -e{1963,1950,9050}
+							htmlOut << " " << getMeasuredValues()[noEhz].measuredValueForOneEhz[noemd].unit.c_str() << "</td><td> </td></tr>";
+						}
+					}
+				}
+				//lint -e{1963,1950,9050}
+				htmlOut << "</table></body></html>";
+			}
+			// And copy to internal buffer
+			outputData = htmlOut.str();
+			
+
+		}
+		
+		// Put the HTTP header in front of the HTML page. The shared reply is for persistent connections
+		void TcpConnectionSimpleHtmlAnswer::buildReply(const u64 generation)
+		{
+			// Get the length (necessary for the header)
+			const std::string::size_type length = outputData.length();
+			std::ostringstream htmlOut;
+			//lint -e{1963,1950,9050}
+			htmlOut << "HTTP/1.1 200 OK\r\nContent-Length: " << length << "\r\nETag: " << getEntityTag(generation) 
+					<< "\r\nConnection: keep-alive\r\nKeep-Alive: timeout=" << (HttpKeepAliveTimeoutInMs / 1000UL) << "\r\n\r\n" << outputData;
+			outputData = htmlOut.str();
+		}
+		
+		// The entity tag is the start of the program and the generation of the measured values in quotes
+		// Without the start, a peer could get 304 for old values from before a restart
+		std::string TcpConnectionSimpleHtmlAnswer::getEntityTag(const u64 generation)
+		{
+			static const time_t processStartTime = time(null<time_t *>());
+			static const pid_t processId = getpid();
+			std::ostringstream oss;
+			//lint -e{1963,9050}
+			oss << '"' << processStartTime << '.' << processId << '-' << generation << '"';
+			return oss.str();
+		}
+		
+		// We are only interested in the HTTP version and in the headers "Connection" and "If-None-Match"
+		void TcpConnectionSimpleHtmlAnswer::evaluateHeaderLine(void)
+		{
+			// Header names are case insensitive
+			std::string lowerCaseLine(headerLine);
+			for (std::string::iterator it = lowerCaseLine.begin(); it != lowerCaseLine.end(); ++it)
+			{
+				//lint -e{921}
+				*it = static_cast<mchar>(tolower(static_cast<u8>(*it)));
+			}
+			
+			const std::string connectionHeader("connection:");
+			const std::string ifNoneMatchHeader("if-none-match:");
+			// The first line is the rest of the request line. It contains the version
+			if (0 == lowerCaseLine.compare(0U, 8U, "http/1.0"))
+			{
+				requestIsHttp10 = true;
+			}
+			else if (0 == lowerCaseLine.compare(0U, connectionHeader.length(), connectionHeader))
+			{
+				requestConnectionClose = (std::string::npos != lowerCaseLine.find("close"));
+				requestConnectionKeepAlive = (std::string::npos != lowerCaseLine.find("keep-alive"));
+			}
+			else if (0 == lowerCaseLine.compare(0U, ifNoneMatchHeader.length(), ifNoneMatchHeader))
+			{
+				// Take the value without leading and trailing blanks
+				const std::string::size_type begin = headerLine.find_first_not_of(" \t", ifNoneMatchHeader.length());
+				const std::string::size_type end = headerLine.find_last_not_of(" \t");
+				requestEntityTag = (std::string::npos == begin) ? std::string() : headerLine.substr(begin, (end - begin) + 1U);
+			}
+			else
+			{
+				// Not interesting
+			}
+		}
+		
+		// Reply with the shared reply, or with 304, if the peer has the current values already
+		void TcpConnectionSimpleHtmlAnswer::answerRequest(void)
+		{
+			// HTTP/1.1 connections are persistent, if not requested otherwise. HTTP/1.0 connections only on request
+			const boolean keepAlive = !requestConnectionClose && (!requestIsHttp10 || requestConnectionKeepAlive);
+			
+			// Get the HTML reply string with header. It is only built, if there are new values
+			const SharedString &sharedReply = getSharedReply();
+			const std::string entityTag(getEntityTag(getSharedReplyCache().generation));
+			
+			if (entityTag == requestEntityTag)
+			{
+				// The peer has the current values already
+				std::ostringstream htmlOut;
+				//lint -e{1963,1950,9050}
+				htmlOut << "HTTP/1.1 304 Not Modified\r\nETag: " << entityTag << "\r\nConnection: " << (keepAlive ? "keep-alive" : "close") << "\r\n\r\n";
+				writeData(htmlOut);
+			}
+			else if (keepAlive)
+			{
+				// Send complete reply to peer
+				writeData(sharedReply);
+			}
+			else
+			{
+				// Seldom. The shared reply is for persistent connections. So build an own one
+				//lint -e{1933}
+				buildOutputData();
+				std::ostringstream htmlOut;
+				//lint -e{1963,1950,9050}
+				htmlOut << "HTTP/1.1 200 OK\r\nContent-Length: " << outputData.length() << "\r\nETag: " << entityTag << "\r\nConnection: close\r\n\r\n" << outputData;
+				writeData(htmlOut);
+			}
+			
+			if (!keepAlive)
+			{
+				// The idle timer is the fallback, if the peer does not close
+				closeAfterWrite();
+			}
+		}
+		
+		SharedReplyCache &TcpConnectionSimpleHtmlAnswer::getSharedReplyCache(void)
+		{
+			static SharedReplyCache sharedReplyCache[MaxNumberOfReactors];
+			return sharedReplyCache[getReactorIndexForThisThread()];
+		}
+
+	// -------------------------------------------------------------------------------------
+	// 3.4. Web Server for EHZ System specific data
+	
+		
+		// Handle read date given by handleEvent from the reactor
+		// This will implement a web server
+		// Wait for HTML GET header. Parse it. Send requested data back
+		EventProcessing::Action TcpConnectionSimpleHtmlAnswer::handleReadData(const sint bytesRead)
+		{
+			// The peer is active. Restart the idle time
+			idleTimer.setTimerValues(HttpKeepAliveTimeoutInMs);
+			idleTimer.startTimerOneShot();
+			
+			// For all bytes in the buffer read by handleEvent
+			for (sint byteIndex = null<sint>(); byteIndex < bytesRead; ++byteIndex)
+			{	
+				// Get the current byte out of the buffer
+				const mchar currentByte = receivedRawData[byteIndex];
+				// Ignore \r
+				//lint -e{911}   /Note 911: Implicit expression promotion from char to int
+				// Skip \r
+				if ('\r' != currentByte) 
+				{
+					// So. It was no \r. This is a small state machine for parsing the HTML GET string
+					// We expect: "GET <url> \n\n"
+					switch (state)
+					{
+						case StateWaitForGet:
+							{
+								// In the beginning we wait for the wort "GET "
+								const mchar gc[] = "GET ";
+								// Did we find the expected character
+								//lint -e{911}   /Note 911: Implicit expression promotion from char to int
+								if (gc[matchIndex] == currentByte)
+								{
+									// Then wait for next
+									++matchIndex;
+									const uint sz = (sizeof(gc)/sizeof(gc[0]))-1U;
+									// did we find all expected characters?
+									if (sz == matchIndex)
+									{
+										// If so, then reset internal variables for next try and goto next state
+										matchIndex = null<uint>();
+										// Now we want to read the URL
+										state = StateWaitForUrl;
+										// Reset URL to empty
+										url = "";
+										// Reset the evaluation of the header
+										headerLine.clear();
+										requestIsHttp10 = false;
+										requestConnectionClose = false;
+										requestConnectionKeepAlive = false;
+										requestEntityTag.clear();
+									}
+								} 
+								else
+								{
+									// No, we did not find the expected character. 
+									// We will wait for the first character of the search string "GET " again
+									matchIndex = null<uint>();
+								}
+							}
+							break;
+							
+						// So. We read "GET ". Now we want to read the url	
+						case StateWaitForUrl:
+							//lint -e{911}   /Note 911: Implicit expression promotion from char to int
+							// The blank is the separator and shows the end of the url
+							if (' ' == currentByte)
+							{
+								// End of url string found. Go and wait for the end of the header (\n\n)
+								state = WaitForHeaderEnd;
+								// The headerLengthCounter is used as a safeguard. 
+								// If there are too many bytes, we will terminate the functionality
+								headerLengthCounter = null<sint>();
+								// This will count the newlines. We are waiting for 2
+								newLineCounter = null<sint>();
+							}
+							else
+							{
+								// Strill reading url. Add next byte to url string
+								url += currentByte;
+							}
+							break;
+							
+						// We have read the url and a blank. Now we are waiting for 2 \n as in indicator for end of header	
+						case WaitForHeaderEnd:
+							//lint -e{911}   /Note 911: Implicit expression promotion from char to int
+							// \n found?
+							if ('\n' == currentByte)
+							{	
+								++newLineCounter;
+								// If we found 2 \n in a row. The header is complete
+								if (2 == newLineCounter)
+								{
+									// Send the reply to the peer
+									// Further requests in the received data will be handled in the next loop runs (pipelining)
+									answerRequest();
+									
+									// Wait for next GET command
+									state = StateWaitForGet;
+								}
+								else
+								{
+									evaluateHeaderLine();
+								}
+								headerLine.clear();
+							}
+							else
+							{
+								// No 2 \n in a row
+								// Reset the counter for the next try
+								newLineCounter = null<sint>();
+								// Safeguard counter.
+								// If there are 2 many bytes without an end of header, we will stop parsing
+								++headerLengthCounter;
+								if (headerLengthCounter > maxHeaderLength)
+								{
+									// Wait for next get
+									state = StateWaitForGet;   
+								}
+								else
+								{
+									headerLine += currentByte;
+								}
+							}
+							break;
+							
+						default:
+							// Should not happen
+							matchIndex = null<uint>();
+							state = StateWaitForGet;
+							break;
+					}
+				}
+			}
+			return EventProcessing::Continue;
+		}
+
+	// -------------------------------------------------------------------------------------
+	// 3.5. TCP Connection Server for transmitting the Powerstate of the EHZ System in HTML
+
+		// Inform other side, how many KW the complete system is using
+		// This is important for an evaluation, if solar power is available for usage or not.
+		void TcpConnectionSimpleHtmlAnswerPowerState::buildOutputData(void)
+		{
+			std::ostringstream htmlOut;
+			
+			if (null<EhzSystem *>() == ehzSystem)
+			{
+				if (isMainReactorThread())
+				{
+					ui << "Dereferencing NULL pointer in void TcpConnectionSimpleHtmlAnswerPowerState::buildOutputData(void)"  << std::endl;
+				}
+			}
+			else
+			{
+				//lint -e{1963,1950,9050}
+				htmlOut << "<html><body>Gesamtleistung: ";
+				//lint -e{1963,1950,9050}	
+				htmlOut << getMeasuredValues()[EhzIndexForEhzPowerState].measuredValueForOneEhz[EhzValueIndexForEhaPowerState].getScaledValueAsString();
+				//lint -e{1963,1950,9050}
+				htmlOut << getMeasuredValues()[EhzIndexForEhzPowerState].measuredValueForOneEhz[EhzValueIndexForEhaPowerState].unit.c_str();
+				//lint -e{1963,1950,9050}	
+				htmlOut << "</body></html>";
+			}
+			outputData = htmlOut.str();
+		}
+		
+		SharedReplyCache &TcpConnectionSimpleHtmlAnswerPowerState::getSharedReplyCache(void)
+		{
+			static SharedReplyCache sharedReplyCache[MaxNumberOfReactors];
+			return sharedReplyCache[getReactorIndexForThisThread()];
+		}
+
+
+	// -------------------------------------------------------------------------------------
+	// 3.6. TCP Connection Server for queries of time ranges
+	
+		// Constructor. The database is opened with the first query
+		TcpConnectionEhzHistoryServer::TcpConnectionEhzHistoryServer(const Handle connectionHandle) : 	TcpConnectionEhzDataServer(connectionHandle),
+																										requestLine(),
+																										queryIsActive(false),
+																										queryMeter(null<uint>()),
+																										queryValueId(null<uint>()),
+																										queryFromTime(null<s64>()),
+																										queryFromSequenceNumber(null<uint>()),
+																										queryToTime(null<s64>()),
+																										queryResolution(null<s64>()),
+																										ehzDataBaseReader(null<DatabaseInternal::EhzDataBaseReader *>())
+		{
+		}
+		
+		// Destructor. Close the read only connection to the database
+		//lint -e{1579}
+		TcpConnectionEhzHistoryServer::~TcpConnectionEhzHistoryServer(void)
+		{
+			try
+			{
+				delete ehzDataBaseReader;
+			}
+			catch(...)
+			{
+			}
+		}
+		
+		// Collect the bytes of a request. A line is complete with \n
+		EventProcessing::Action TcpConnectionEhzHistoryServer::handleReadData(const sint bytesRead)
+		{
+			for (sint byteIndex = null<sint>(); byteIndex < bytesRead; ++byteIndex)
+			{
+				const mchar currentByte = receivedRawData[byteIndex];
+				//lint -e{911}
+				if ('\n' == currentByte)
+				{
+					if (evaluateRequest())
+					{
+						//lint -e{1933}
+						buildOutputData();
+					}
+					else
+					{
+						outputData.clear();
+						outputData += charSTX;
+						outputData += 'E';
+						outputData += charUS;
+						outputData += charETX;
+					}
+					writeData(outputData);
+					requestLine.clear();
+				}
+				//lint -e{911}
+				else if (('\r' != currentByte) && (requestLine.length() <= MaxSizeQueryRequest))
+				{
+					// One byte more than allowed is stored. Then the request is too long and invalid
+					requestLine += currentByte;
+				}
+				else
+				{
+					// Ignore \r and the rest of a too long request
+				}
+			}
+			return EventProcessing::Continue;
+		}
+		
+		// A new query or the next page of the active one
+		boolean TcpConnectionEhzHistoryServer::evaluateRequest(void)
+		{
+			boolean rc = false;
+			if (requestLine.length() > MaxSizeQueryRequest)
+			{
+				requestLine.clear();
+			}
+			std::istringstream iss(requestLine);
+			mchar command = null<mchar>();
+			iss >> command;
+			
+			//lint -e{911}
+			if (tcpConnectionQueryCommand == command)
+			{
+				//lint -e{1963,9050}
+				iss >> queryMeter >> queryValueId >> queryFromTime >> queryToTime >> queryResolution;
+				queryFromSequenceNumber = null<uint>();
+				// The next page starts at a time after the last one. This must not overflow
+				queryIsActive = !iss.fail() && (queryFromTime >= null<s64>()) && (queryFromTime <= queryToTime) && (queryToTime < HistoryQueryMaxTime) && (queryResolution >= null<s64>());
+				rc = queryIsActive;
+			}
+			//lint -e{911}
+			else if ((tcpConnectionNextPageCommand == command) && (requestLine.length() == 1U))
+			{
+				rc = queryIsActive;
+			}
+			else
+			{
+				// Unknown command
+			}
+			return rc;
+		}
+		
+		// Answer one page and remember, where the next page starts
+		void TcpConnectionEhzHistoryServer::buildOutputData(void)
+		{
+			std::vector<DatabaseInternal::HistoryRow> historyRows;
+			// Where the next page starts. After queryToTime: No next page
+			s64 nextFromTime = queryToTime + 1LL;
+			uint nextFromSequenceNumber = null<uint>();
+			const HistorianInternal::EhzHistorian *const historian = (null<EhzSystem *>() == ehzSystem) ? null<const HistorianInternal::EhzHistorian *>() : ehzSystem->getHistorian();
+			
+			if ((null<s64>() == queryResolution) && (null<const HistorianInternal::EhzHistorian *>() != historian))
+			{
+				// Raw data from the historian
+				std::vector<HistorianInternal::HistorianRecord> historianRecords;
+				historian->read(queryFromTime, queryFromSequenceNumber, queryToTime, queryMeter, queryValueId, HistoryQueryPageSize, historianRecords);
+				DatabaseInternal::HistoryRow historyRow;
+				for (std::vector<HistorianInternal::HistorianRecord>::const_iterator hri = historianRecords.begin(); hri != historianRecords.end(); ++hri)
+				{
+					historyRow.time = static_cast<DatabaseInternal::EhzLogTimeUnit>(hri->timeStamp);
+					historyRow.minimum = EhzInternal::convertScaledValueToDouble(hri->mantissa, hri->scaler);
+					historyRow.maximum = historyRow.minimum;
+					historyRow.average = historyRow.minimum;
+					historyRow.last = historyRow.minimum;
+					historyRows.push_back(historyRow);
+				}
+				// A full page: There may be more. More than one record may have the same time. So continue after the time and the sequence number
+				if (HistoryQueryPageSize == historianRecords.size())
+				{
+					nextFromTime = historianRecords.back().timeStamp;
+					nextFromSequenceNumber = historianRecords.back().sequenceNumber + 1U;
+				}
+			}
+			else
+			{
+				// Raw data or roll-ups from the database
+				if (null<DatabaseInternal::EhzDataBaseReader *>() == ehzDataBaseReader)
+				{
+					//lint -e{1901,1911}
+					ehzDataBaseReader = new DatabaseInternal::EhzDataBaseReader(DatabaseInternal::EhzDatabaseName);
+				}
+				// The reader scans only a window of the range. The next page continues after it
+				DatabaseInternal::EhzLogTimeUnit nextFromTimeOfDatabase = static_cast<DatabaseInternal::EhzLogTimeUnit>(nextFromTime);
+				if (ehzDataBaseReader->readRange(queryMeter, queryValueId, static_cast<DatabaseInternal::EhzLogTimeUnit>(queryFromTime), static_cast<DatabaseInternal::EhzLogTimeUnit>(queryToTime), 
+											 static_cast<DatabaseInternal::EhzLogTimeUnit>(queryResolution), HistoryQueryPageSize, historyRows, nextFromTimeOfDatabase))
+				{
+					nextFromTime = static_cast<s64>(nextFromTimeOfDatabase);
+				}
+			}
+			
+			queryFromTime = nextFromTime;
+			queryFromSequenceNumber = nextFromSequenceNumber;
+			queryIsActive = (queryFromTime <= queryToTime);
+			
+			std::ostringstream oss;
+			// Counters have many digits
+			oss.precision(15);
+			//lint --e{1963,1950,9050}
+			oss << charSTX << (queryIsActive ? '1' : '0') << charUS;
+			for (std::vector<DatabaseInternal::HistoryRow>::const_iterator hri = historyRows.begin(); hri != historyRows.end(); ++hri)
+			{
+				oss << hri->time << charUS << hri->minimum << charUS << hri->maximum << charUS << hri->average << charUS << hri->last << charUS;
+			}
+			oss << charETX;
+			outputData = oss.str();
+		}
+
+
+	// -------------------------------------------------------------------------------------
+	// 3.7. TCP Connection Server pushing new values to subscribers
+	
+		// Current time of the monotonic clock in ms. For the rate limit
+		static u64 getMonotonicTimeInMs(void)
+		{
+			struct timespec monotonicTime;
+			//lint -e{534}
+			clock_gettime(CLOCK_MONOTONIC, &monotonicTime);
+			return (static_cast<u64>(monotonicTime.tv_sec) * 1000ULL) + (static_cast<u64>(monotonicTime.tv_nsec) / 1000000ULL);
+		}
+	
+		// Constructor. The subscription starts with the first request
+		TcpConnectionEhzPushServer::TcpConnectionEhzPushServer(const Handle connectionHandle) : 	TcpConnectionEhzDataServer(connectionHandle),
+																								Subscriber<EhzSystem>(),
+																								Subscriber<EventTimer>(),
+																								requestLine(),
+																								isSubscribed(false),
+																								minimumPeriodInMs(null<u32>()),
+																								lastPushTime(null<u64>()),
+																								pushIsPending(),
+																								keyframeIsPending(),
+																								sentMeasuredValues(),
+																								rateLimitTimer(null<u32>()),
+																								rateLimitTimerIsRunning(false)
+		{
+			rateLimitTimer.addSubscription(this);
+		}
+		
+		// Destructor. The EhzSystem and the reactor must not know us any longer
+		TcpConnectionEhzPushServer::~TcpConnectionEhzPushServer(void)
+		{
+			try
+			{
+				unsubscribe();
+			}
+			catch(...)
+			{
+			}
+		}
+		
+		// The connection is closed
+		void TcpConnectionEhzPushServer::stop(void)
+		{
+			unsubscribe();
+			TcpConnectionEhzDataServer::stop();
+		}
+		
+		// No more pushes. Also no deferred one
+		void TcpConnectionEhzPushServer::unsubscribe(void)
+		{
+			if (isSubscribed && (null<EhzSystem *>() != ehzSystem))
+			{
+				ehzSystem->removeSubscription(this);
+			}
+			isSubscribed = false;
+			if (rateLimitTimerIsRunning)
+			{
+				rateLimitTimer.stopTimer();
+				rateLimitTimerIsRunning = false;
+			}
+		}
+		
+		// Collect the bytes of a request. A line is complete with \n
+		EventProcessing::Action TcpConnectionEhzPushServer::handleReadData(const sint bytesRead)
+		{
+			for (sint byteIndex = null<sint>(); byteIndex < bytesRead; ++byteIndex)
+			{
+				const mchar currentByte = receivedRawData[byteIndex];
+				//lint -e{911}
+				if ('\n' == currentByte)
+				{
+					if (!evaluateRequest())
+					{
+						outputData.clear();
+						outputData += charSTX;
+						outputData += 'E';
+						outputData += charUS;
+						outputData += charETX;
+						writeData(outputData);
+					}
+					requestLine.clear();
+				}
+				//lint -e{911}
+				else if (('\r' != currentByte) && (requestLine.length() <= MaxSizeQueryRequest))
+				{
+					// One byte more than allowed is stored. Then the request is too long and invalid
+					requestLine += currentByte;
+				}
+				else
+				{
+					// Ignore
+				}
+			}
+			return EventProcessing::Continue;
+		}
+		
+		// Subscribe or unsubscribe
+		boolean TcpConnectionEhzPushServer::evaluateRequest(void)
+		{
+			boolean rc = false;
+			if (requestLine.length() > MaxSizeQueryRequest)
+			{
+				requestLine.clear();
+			}
+			std::istringstream iss(requestLine);
+			mchar command = null<mchar>();
+			iss >> command;
+			
+			//lint -e{911}
+			if ((tcpConnectionSubscribeCommand == command) && (null<EhzSystem *>() != ehzSystem))
+			{
+				//lint -e{1963,9050}
+				iss >> minimumPeriodInMs;
+				rc = !iss.fail();
+				if (rc)
+				{
+					// The peer knows nothing. So send everything now
+					const uint numberOfEhz = ehzSystem->getEhzSystemResult().size();
+					sentMeasuredValues.assign(numberOfEhz, EhzInternal::AllMeasuredValuesForOneEhz());
+					pushIsPending.assign(numberOfEhz, true);
+					keyframeIsPending.assign(numberOfEhz, false);
+					ehzSystem->addSubscription(this);
+					isSubscribed = true;
+					pushPendingValues(true);
+				}
+			}
+			//lint -e{911}
+			else if ((tcpConnectionUnsubscribeCommand == command) && (requestLine.length() == 1U))
+			{
+				unsubscribe();
+				rc = true;
+			}
+			else
+			{
+				// Unknown command
+			}
+			return rc;
+		}
+		
+		// An Ehz has new values. Push them now, or after the minimum period
+		void TcpConnectionEhzPushServer::update(EhzSystem *const publisher)
+		{
+			const uint ehzIndex = publisher->getLastUpdatedEhzIndex();
+			if (ehzIndex < pushIsPending.size())
+			{
+				pushIsPending[ehzIndex] = true;
+				if (publisher->isLastUpdateKeyframe())
+				{
+					keyframeIsPending[ehzIndex] = true;
+				}
+			}
+			// If the timer runs, then the values will be sent, when it fires
+			if (!rateLimitTimerIsRunning)
+			{
+				const u64 timeSinceLastPush = getMonotonicTimeInMs() - lastPushTime;
+				if (timeSinceLastPush >= static_cast<u64>(minimumPeriodInMs))
+				{
+					pushPendingValues(false);
+				}
+				else
+				{
+					rateLimitTimer.setTimerValues(static_cast<u32>(static_cast<u64>(minimumPeriodInMs) - timeSinceLastPush));
+					rateLimitTimer.startTimerOneShot();
+					rateLimitTimerIsRunning = true;
+				}
+			}
+		}
+		
+		// The minimum period is over
+		void TcpConnectionEhzPushServer::update(EventTimer *const)
+		{
+			const AllocationInternal::AllocationScope allocationScope(AllocationInternal::AllocationSubsystem::Server);
+			rateLimitTimer.stopTimer();
+			rateLimitTimerIsRunning = false;
+			pushPendingValues(false);
+		}
+		
+		// One message for each Ehz with changed values. Nothing, if no value changed
+		void TcpConnectionEhzPushServer::pushPendingValues(const boolean sendAllValues)
+		{
+			lastPushTime = getMonotonicTimeInMs();
+			const EhzInternal::PublishedMeasuredValues &publishedMeasuredValues = ehzSystem->getEhzSystemResult();
+			std::ostringstream oss;
+			
+			const uint numberOfEhz = pushIsPending.size();
+			for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+			{
+				if (pushIsPending[ehzIndex])
+				{
+					pushIsPending[ehzIndex] = false;
+					const boolean sendAllValuesOfEhz = sendAllValues || keyframeIsPending[ehzIndex];
+					keyframeIsPending[ehzIndex] = false;
+					const EhzInternal::AllMeasuredValuesForOneEhz &currentValues = publishedMeasuredValues[ehzIndex];
+					EhzInternal::AllMeasuredValuesForOneEhz &sentValues = sentMeasuredValues[ehzIndex];
+					
+					std::ostringstream changedValues;
+					const uint numberOfUsedEhzMeasuredData = EhzInternal::EhzSystemConfiguration::getInstance()->getNumberOfUsedEhzMeasuredData(ehzIndex);
+					const mdouble *const deadband = &EhzInternal::getEhzConfigDefinition(ehzIndex).ehzDeadband[0];
+					for (uint valueId = null<uint>(); valueId < numberOfUsedEhzMeasuredData; ++valueId)
+					{
+						if (sendAllValuesOfEhz || currentValues.measuredValueForOneEhz[valueId].hasChangedBeyond(sentValues.measuredValueForOneEhz[valueId], deadband[valueId]))
+						{
+							//lint -e{1963,9050}
+							changedValues << valueId << charUS << currentValues.measuredValueForOneEhz[valueId];
+							sentValues.measuredValueForOneEhz[valueId] = currentValues.measuredValueForOneEhz[valueId];
+						}
+					}
+					
+					const std::string changedValuesString(changedValues.str());
+					if (!changedValuesString.empty())
+					{
+						//lint -e{1963,9050}
+						oss << charSTX << ehzIndex << charUS << currentValues.timeWhenDataHasBeenEvaluated << charUS 
+							<< currentValues.getTimeWhenDataHasBeenEvaluatedString() << charUS << changedValuesString << charETX;
+					}
+				}
+			}
+			
+			if (!oss.str().empty() && (null<Handle>() != handle))
+			{
+				writeData(oss);
+			}
+		}
+
+
+	// -------------------------------------------------------------------------------------
+	// 3.8. TCP Connection Server for the metrics
+
+		// One block per metric with the lines of all Ehz
+		void TcpConnectionEhzMetricsServer::buildOutputData(void)
+		{
+			std::ostringstream metricsOut;
+			if (null<EhzSystem *>() != ehzSystem)
+			{
+				const uint numberOfEhz = EhzInternal::getNumberOfEhz();
+				std::vector<const MetricsInternal::EhzMetrics *> ehzMetrics(numberOfEhz, null<const MetricsInternal::EhzMetrics *>());
+				std::vector<std::string> labels(numberOfEhz);
+				for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+				{
+					ehzMetrics[ehzIndex] = &ehzSystem->getEhzMetrics(ehzIndex);
+					std::ostringstream oss;
+					//lint -e{1963,9050}
+					oss << "ehz=\"" << ehzIndex << '"';
+					labels[ehzIndex] = oss.str();
+				}
+				
+				MetricsInternal::writeMetricHeader(metricsOut, "ehz_bytes_read_total", "counter", "Bytes read from the serial port");
+				for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+				{
+					MetricsInternal::writeCounter(metricsOut, "ehz_bytes_read_total", labels[ehzIndex], ehzMetrics[ehzIndex]->bytesRead);
+				}
+				MetricsInternal::writeMetricHeader(metricsOut, "ehz_esc_frames_total", "counter", "SML Files with an ESC-Stop sequence");
+				for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+				{
+					MetricsInternal::writeCounter(metricsOut, "ehz_esc_frames_total", labels[ehzIndex], ehzMetrics[ehzIndex]->escFrames);
+				}
+				MetricsInternal::writeMetricHeader(metricsOut, "ehz_crc_mismatches_total", "counter", "SML Files with a wrong CRC16 in the ESC-Stop sequence");
+				for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+				{
+					MetricsInternal::writeCounter(metricsOut, "ehz_crc_mismatches_total", labels[ehzIndex], ehzMetrics[ehzIndex]->crc16Mismatches);
+				}
+				MetricsInternal::writeMetricHeader(metricsOut, "ehz_parser_resyncs_total", "counter", "Parser errors. The parser waits for the next SML File");
+				for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+				{
+					MetricsInternal::writeCounter(metricsOut, "ehz_parser_resyncs_total", labels[ehzIndex], ehzMetrics[ehzIndex]->parserResyncs);
+				}
+				MetricsInternal::writeMetricHeader(metricsOut, "ehz_resync_skipped_bytes_total", "counter", "Bytes skipped after parser errors while searching the next SML File");
+				for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+				{
+					MetricsInternal::writeCounter(metricsOut, "ehz_resync_skipped_bytes_total", labels[ehzIndex], ehzMetrics[ehzIndex]->resyncSkippedBytes);
+				}
+				MetricsInternal::writeMetricHeader(metricsOut, "ehz_octet_buffer_overflows_total", "counter", "SML Files dropped, because their octet strings did not fit in the octet buffer. It grows for the next SML File");
+				for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+				{
+					MetricsInternal::writeCounter(metricsOut, "ehz_octet_buffer_overflows_total", labels[ehzIndex], ehzMetrics[ehzIndex]->octetBufferOverflows);
+				}
+				MetricsInternal::writeMetricHeader(metricsOut, "ehz_dropped_values_total", "counter", "SML Files of a worker thread, that were overwritten, because the main reactor did not take the values in time");
+				for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+				{
+					MetricsInternal::writeCounter(metricsOut, "ehz_dropped_values_total", labels[ehzIndex], ehzMetrics[ehzIndex]->droppedMeasuredValues);
+				}
+				MetricsInternal::writeMetricHeader(metricsOut, "ehz_parse_to_publish_seconds", "histogram", "Time from reading the last bytes of an SML File until all subscribers know the values");
+				for (uint ehzIndex = null<uint>(); ehzIndex < numberOfEhz; ++ehzIndex)
+				{
+					MetricsInternal::writeHistogram(metricsOut, "ehz_parse_to_publish_seconds", labels[ehzIndex], ehzMetrics[ehzIndex]->parseToPublishLatency);
+				}
+			}
+			Metrics::getInstance()->write(metricsOut);
+			AllocationInternal::writeAllocationMetrics(metricsOut);
+			outputData = metricsOut.str();
+		}
+		
+		// Same handling of persistent connections as for the HTML pages
+		void TcpConnectionEhzMetricsServer::answerRequest(void)
+		{
+			const boolean keepAlive = !requestConnectionClose && (!requestIsHttp10 || requestConnectionKeepAlive);
+			
+			//lint -e{1933}
+			buildOutputData();
+			std::ostringstream httpOut;
+			//lint -e{1963,1950,9050}
+			httpOut << "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " << outputData.length() 
+					<< "\r\nConnection: " << (keepAlive ? "keep-alive" : "close") << "\r\n\r\n" << outputData;
+			writeData(httpOut);
+			
+			if (!keepAlive)
+			{
+				// The idle timer is the fallback, if the peer does not close
+				closeAfterWrite();
+			}
+		}
+
+		
+		
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	
+// ------------------------------------------------------------------------------------------------------------------------------
+// 4. TCP Connection Clients
+
+	// --------------------------------------------------------------------------------------------------------------------------
+	// 4.1 TCP Connection Client: Get EHZ System data from connected Server
+	
+	
+		// Get periodically data from a connected server
+
+		// ---------------------
+		// 4.1.1 Administration
+		
+			// Explicit constructor
+			TcpConnectionGetEhzDataClient::TcpConnectionGetEhzDataClient(const Handle connectionHandle, const u32 pollPeriod, const boolean subscribe, const boolean binary) : 	
+					TcpConnectionBase(connectionHandle),
+					Subscriber<EventTimer>(),
+					vEMDA(EhzInternal::getNumberOfEhz()),
+					requestCommand(binary ? &tcpConnectionGetEhzDataBinaryCommand[0] : &tcpConnectionGetEhzDataCommand[0]),
+					pollTimer(pollPeriod),
+					subscribeForPush(subscribe),
+					pollPeriodInMs(pollPeriod),
+					binaryFormat(binary && !subscribe),
+					receivedBinaryData(),
+					receivedDataAsStrings(),
+					convertedDataPart(),
+					state(StateWaitForStart)
+			{
+		
+			}
+
+			// private constructor. Must not be used
+			TcpConnectionGetEhzDataClient::TcpConnectionGetEhzDataClient(void) : 	
+					TcpConnectionBase(null<Handle>()),
+					Subscriber<EventTimer>(),
+					vEMDA(),
+					requestCommand(&tcpConnectionGetEhzDataCommand[0]),
+					pollTimer(null<u32>()),
+					subscribeForPush(false),
+					pollPeriodInMs(null<u32>()),
+					binaryFormat(false),
+					receivedBinaryData(),
+					receivedDataAsStrings(),
+					convertedDataPart(),
+					state()
+			{
+			}
+
+			// Destructor
+			TcpConnectionGetEhzDataClient::~TcpConnectionGetEhzDataClient(void)
+			{
+				try
+				{
+					// STop the Timer
+					TcpConnectionGetEhzDataClient::stopPoll();
+				}
+				catch(...)
+				{
+				}
+			}
+
+			
+			// Start polling or subscribe at the push server
+			void TcpConnectionGetEhzDataClient::start(void)
+			{
+				if (subscribeForPush)
+				{
+					if (null<Handle>() != handle)
+					{
+						std::ostringstream oss;
+						//lint -e{1963,9050}
+						oss << tcpConnectionSubscribeCommand << ' ' << pollPeriodInMs << '\n';
+						ui << "TCP Client: Sending Subscription"  << std::endl;
+						writeData(oss);
+					}
+				}
+				else
+				{
+					//lint -e{1933}
+					startPoll();
+				}
+			}
+			
+			// Start the poll timer and add handler to reactor
+			 void TcpConnectionGetEhzDataClient::startPoll(void)  
+			 {
+				pollTimer.addSubscription(this); 
+				pollTimer.startTimerPeriodic();
+			}
+
+			 // Stop timer
+			 void TcpConnectionGetEhzDataClient::stopPoll(void)  
+			 {
+				
+				pollTimer.stopTimer();
+				pollTimer.removeSubscription(this);
+			}
+			
+			 // Override of Publisher function 
+			 // In case of stop of TCP connection we will first stop the poll timer
+			 void TcpConnectionGetEhzDataClient::notifySubscribers(void)
+			 {
+				//lint -e{1933}     Note 1933: Call to unqualified virtual function 'TcpConnectionGetEhzDataClient::stopPoll(void)' from non-static member function
+				stopPoll();
+				//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
+				TcpConnectionBase::notifySubscribers();
+			 }
+			
+			
+		// -------------------------------------
+		// 4.1.2 Update function for timer Event
+		
+			// The Client starts a timer and wants to get data from the connected peer for all x seconds
+			// Wen the timer fires the we handle this event here
+			// We will send one byte (the request command) in raw mode to the peer
+
+			void TcpConnectionGetEhzDataClient::update(EventTimer *const)
+			{
+				//ui << "TcpConnectionGetEhzDataClient::update(EventTimer  "  << std::endl;
+				if (null<Handle>() != handle)
+				{
+					//lint -e{925}    925 Cast from pointer to pointer
+					// Send the request. The server shall send data
+					ui << "TCP Client: Sending Get Request"  << std::endl;
+					
+					writeData(requestCommand);
+				}
+				
+			}
+
+
+
+		// -------------------------------------
+		// 4.1.3 Store received data
+
+			// The server sends the data in the format:
+			// STX version US data1 US data2 US ... dataN US ETX
+			// The data will be parsed an the result will be stored into a vector of strings
+			// This will be stored in the correct part for an EhzInternal::AllMeasuredValuesForOneEhz
+			// Servers with version 1 send no version field. Their layout is still understood
+			void TcpConnectionGetEhzDataClient::setValuesFromStrings(std::vector<std::string>::iterator &iter, const std::vector<std::string>::iterator &end)
+			{
+				const std::vector<std::string>::difference_type numberOfStringsPerEhz = static_cast<std::vector<std::string>::difference_type>((NumberOfEhzMeasuredData * EhzInternal::NumberOfStringsPerValue) + EhzInternal::NumberOfStringsPerEhzTime);
+				
+				if (EhzInternal::TextFormatVersionField == *iter)
+				{
+					++iter;
+					if ((end - iter) >= (numberOfStringsPerEhz * static_cast<std::vector<std::string>::difference_type>(vEMDA.size())))
+					{
+						// For the system
+						for (std::vector<EhzInternal::AllMeasuredValuesForOneEhz>::iterator emdaI = vEMDA.begin(); emdaI != vEMDA.end(); ++emdaI)
+						{
+							// For a single EHZ
+							(emdaI)->setValuesFromStrings(iter);
+						}
+						for (uint ehzIndex = null<uint>(); ehzIndex < vEMDA.size(); ++ehzIndex)
+						{
+							showReceivedValues(ehzIndex);
+						}
+					}
+					else
+					{
+						ui << "TCP Client: Incomplete data"  << std::endl;
+					}
+				}
+				else if (!vEMDA.empty())
+				{
+					// Version 1. The number of values per EHZ follows from the number of strings
+					const uint numberOfStringsPerEhzVersion1 = static_cast<uint>(end - iter) / static_cast<uint>(vEMDA.size());
+					if (numberOfStringsPerEhzVersion1 >= EhzInternal::NumberOfStringsPerEhzTime)
+					{
+						const uint numberOfValues = (numberOfStringsPerEhzVersion1 - EhzInternal::NumberOfStringsPerEhzTime) / EhzInternal::NumberOfStringsPerValueVersion1;
+						for (std::vector<EhzInternal::AllMeasuredValuesForOneEhz>::iterator emdaI = vEMDA.begin(); emdaI != vEMDA.end(); ++emdaI)
+						{
+							(emdaI)->setValuesFromVersion1Strings(iter, numberOfValues);
+						}
+						for (uint ehzIndex = null<uint>(); ehzIndex < vEMDA.size(); ++ehzIndex)
+						{
+							showReceivedValues(ehzIndex);
+						}
+					}
+				}
+				else
+				{
+					// No EHZ configured. Nothing to store
+				}
+			}
+
+			// The push server sends the data in the format:
+			// STX ehz US time US time as string US (slot US value1 US ... value6 US)* ETX
+			// The slots that are not in the message did not change
+			void TcpConnectionGetEhzDataClient::setPushedValuesFromStrings(std::vector<std::string>::iterator &iter, const std::vector<std::string>::iterator &end)
+			{
+				// An error reply has only one string. Then there is nothing to store
+				const std::vector<std::string>::difference_type numberOfStrings = end - iter;
+				const std::vector<std::string>::difference_type numberOfStringsPerValue = 7;
+				if (numberOfStrings >= 3)
+				{
+					uint ehzIndex = null<uint>();
+					std::istringstream iss(*iter); ++iter;
+					iss >> ehzIndex;
+					if (!iss.fail() && (ehzIndex < vEMDA.size()))
+					{
+						EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz = vEMDA[ehzIndex];
+						//lint -e{586}
+						allMeasuredValuesForOneEhz.timeWhenDataHasBeenEvaluated = atol((*iter).c_str()); ++iter;
+						// The time as string is formatted again from the time_t, if needed
+						++iter;
+						while ((end - iter) >= numberOfStringsPerValue)
+						{
+							//lint -e{586,732,919,915,1960}
+							const uint slot = static_cast<uint>(atol((*iter).c_str())); ++iter;
+							if (slot < NumberOfEhzMeasuredData)
+							{
+								allMeasuredValuesForOneEhz.measuredValueForOneEhz[slot].setValuesFromStrings(iter);
+							}
+							else
+							{
+								// Unknown slot. Skip the value
+								iter += (numberOfStringsPerValue - 1);
+							}
+						}
+						showReceivedValues(ehzIndex);
+					}
+				}
+			}
+
+
+
+		// ---------------------------------------------------
+		// 4.1.3 Handle data receive from handleEvent function
+		
+			EventProcessing::Action TcpConnectionGetEhzDataClient::handleReadData(const sint bytesRead)
+			{
+				// Assume that everything is OK
+				EventProcessing::Action rc = EventProcessing::Continue;
+				
+				if (binaryFormat)
+				{
+					handleReadBinaryData(bytesRead);
+				}
+				
+				// Check all bytes in the buffer
+				// Parse the sring received by the Server in the format
+				// STX data1 US data2 US ... dataN US ETX
+				
+				for (sint i = null<sint>(); !binaryFormat && (i<bytesRead); i++)
+				{
+					switch (state)
+					{
+						// Wait for STX
+						case StateWaitForStart:
+							//lint -e{911}   /Note 911: Implicit expression promotion from char to int
+							if (charSTX == receivedRawData[i])
+							{
+								// If we saw an ETX, then we will read strings in the next step
+								state = StateDoConversion;
+								// Clear result string from one parse step
+								convertedDataPart.clear();
+							}
+							break;
+							
+						// Now we will read strings, separated by US	
+						case StateDoConversion:
+							// Is the current byte an US
+							//lint -e{911}   /Note 911: Implicit expression promotion from char to int
+							if (charUS == receivedRawData[i])
+							{
+								// If so, store the result in a vector of strings. Yes, copy data
+								receivedDataAsStrings.push_back(convertedDataPart);
+								// And reset container for next run
+								convertedDataPart.clear();
+							}
+							// Check for end of transmission
+							//lint -e{911}   /Note 911: Implicit expression promotion from char to int
+							else if (charETX == receivedRawData[i])
+							{
+								// ETX found. Stop function and reset state for next run
+								state = StateWaitForStart;
+								// And now store the read strings 
+								std::vector<std::string>::iterator iter = receivedDataAsStrings.begin();
+								// If there are strings at all
+								if (subscribeForPush)
+								{
+									//lint -e{1933}
+									setPushedValuesFromStrings(iter, receivedDataAsStrings.end());
+								}
+								else if (iter != receivedDataAsStrings.end())
+								{
+									//lint -e{1933}    Note 1933: Call to unqualified virtual function 'TcpConnectionBase::handleReadData(int)' from non-static member function
+									// The derived classes know where to store the strings
+									setValuesFromStrings(iter, receivedDataAsStrings.end());
+									
+								}
+								// Make ready for next run. Reste internal variables
+								receivedDataAsStrings.clear();
+								
+								//Publisher<TcpConnectionGetEhzDataClient>::notifySubscribers(static_cast<vo*>(&vEMDA));
+							}
+							else
+							{
+								// Add next received byte to internal string
+								convertedDataPart += receivedRawData[i];
+							}
+							break;
+							
+						default:
+							// Should not happen
+							ui << "Conversion Error"  << std::endl;
+							// STop reactor Event loop
+							rc = EventProcessing::Error;
+							// Close TCP connection
+							TcpConnectionBase::notifySubscribers();
+							break;
+					}
+				}
+				return rc;
+			}
+
+
+
+		// ---------------------------------------------------
+		// 4.1.4 Handle binary data
+		
+			// A frame may be split over several reads. Or one read may contain more than one frame
+			void TcpConnectionGetEhzDataClient::handleReadBinaryData(const sint bytesRead)
+			{
+				receivedBinaryData.append(&receivedRawData[0], static_cast<size_t>(bytesRead));
+				boolean frameIsComplete = true;
+				while (frameIsComplete)
+				{
+					const sint frameSize = EhzInternal::getBinaryFrameSize(receivedBinaryData);
+					if (frameSize < null<sint>())
+					{
+						// Not a frame. Wait for the next one
+						ui << "TCP Client: Invalid binary data"  << std::endl;
+						receivedBinaryData.clear();
+						frameIsComplete = false;
+					}
+					else if ((null<sint>() == frameSize) || (receivedBinaryData.size() < static_cast<size_t>(frameSize)))
+					{
+						// Wait for more data
+						frameIsComplete = false;
+					}
+					else
+					{
+						const std::string frame(receivedBinaryData, 0U, static_cast<size_t>(frameSize));
+						receivedBinaryData.erase(0U, static_cast<size_t>(frameSize));
+						if (!EhzInternal::decodeBinaryFrame(frame, vEMDA))
+						{
+							ui << "TCP Client: Invalid binary frame"  << std::endl;
+						}
+						else
+						{
+							for (uint ehzIndex = null<uint>(); ehzIndex < vEMDA.size(); ++ehzIndex)
+							{
+								showReceivedValues(ehzIndex);
+							}
+						}
+					}
+				}
+			}
+			
+			// One line per EHZ: Index, time and the numerical values with unit
+			void TcpConnectionGetEhzDataClient::showReceivedValues(const uint ehzIndex)
+			{
+				const EhzInternal::AllMeasuredValuesForOneEhz &allMeasuredValuesForOneEhz = vEMDA[ehzIndex];
+				const std::vector<uint> &numberValueIds = EhzInternal::EhzSystemConfiguration::getInstance()->getNumberValueIds(ehzIndex);
+				//lint --e{1963,9050}
+				ui << "EHZ " << ehzIndex << ": " << allMeasuredValuesForOneEhz.getTimeWhenDataHasBeenEvaluatedString();
+				for (std::vector<uint>::const_iterator it = numberValueIds.begin(); it != numberValueIds.end(); ++it)
+				{
+					ui << "  " << allMeasuredValuesForOneEhz.measuredValueForOneEhz[*it].getScaledValueAsString() << ' ' << allMeasuredValuesForOneEhz.measuredValueForOneEhz[*it].unit;
+				}
+				ui << std::endl;
+			}
+
+
+
+
@@ -0,0 +1,344 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// timerevent.cpp
+//
+// General Description
+//
+// Implementation of the EventTimer and of the timing wheel, that drives all timers of a reactor
+// with one timerfd. See timerevent.hpp
+//
+
+
+
+#include "timerevent.hpp"
+
+#include <time.h>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. EventTimer
+
+	// ------------------------------------------------------------------------
+	// 1.1 Constructor and Destructor
+
+	EventTimer::EventTimer(const u32 periodInMsP) :	Publisher<EventTimer>(),
+													periodInMs(periodInMsP),
+													periodic(false),
+													expiryTimeInMs(null<u64>()),
+													timerWheel(null<TimerEventInternal::TimerWheel *>()),
+													timerList(null<TimerEventInternal::TimerList *>()),
+													previous(null<EventTimer *>()),
+													next(null<EventTimer *>())
+	{
+	}
+
+	// A running timer must not stay in the wheel
+	EventTimer::~EventTimer(void)
+	{
+		try
+		{
+			stopTimer();
+		}
+		catch(...)
+		{
+		}
+	}
+
+
+	// ------------------------------------------------------------------------
+	// 1.2 Start, stop and set values
+
+	// A running timer will be restarted
+	void EventTimer::startTimer(const boolean periodicP)
+	{
+		stopTimer();
+		periodic = periodicP;
+		TimerEventInternal::TimerWheel::getInstance()->add(this, periodInMs);
+	}
+
+	void EventTimer::startTimerPeriodic(void)
+	{
+		startTimer(true);
+	}
+
+	void EventTimer::startTimerOneShot(void)
+	{
+		startTimer(false);
+	}
+
+	void EventTimer::stopTimer(void)
+	{
+		if (null<TimerEventInternal::TimerWheel *>() != timerWheel)
+		{
+			timerWheel->remove(this);
+		}
+	}
+
+	void EventTimer::setTimerValues(const u32 periodInMsP)
+	{
+		periodInMs = periodInMsP;
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Timing wheel
+
+namespace TimerEventInternal
+{
+	// ------------------------------------------------------------------------
+	// 2.1 Intrusive list of timers
+
+	// New timers are inserted at the front
+	void TimerList::insert(EventTimer *const eventTimer)
+	{
+		eventTimer->timerList = this;
+		eventTimer->previous = null<EventTimer *>();
+		eventTimer->next = first;
+		if (null<EventTimer *>() != first)
+		{
+			first->previous = eventTimer;
+		}
+		first = eventTimer;
+	}
+
+	void TimerList::remove(EventTimer *const eventTimer)
+	{
+		TimerList *const timerList = eventTimer->timerList;
+		if (null<TimerList *>() != timerList)
+		{
+			if (null<EventTimer *>() != eventTimer->previous)
+			{
+				eventTimer->previous->next = eventTimer->next;
+			}
+			else
+			{
+				timerList->first = eventTimer->next;
+			}
+			if (null<EventTimer *>() != eventTimer->next)
+			{
+				eventTimer->next->previous = eventTimer->previous;
+			}
+			eventTimer->timerList = null<TimerList *>();
+			eventTimer->previous = null<EventTimer *>();
+			eventTimer->next = null<EventTimer *>();
+		}
+	}
+
+
+	// ------------------------------------------------------------------------
+	// 2.2 Constructor and Destructor
+
+	// The timerfd is opened, when the first timer is started
+	TimerWheel::TimerWheel(void) :	EventHandlerBasic(),
+									slot(),
+									expiredTimers(),
+									lastHandledTick(null<u64>()),
+									armedTick(null<u64>()),
+									numberOfTimers(null<uint>()),
+									isRegistered(false)
+	{
+		handle = -1;
+	}
+
+	// The reactor may already be gone. So only close the handle
+	TimerWheel::~TimerWheel(void)
+	{
+		if (null<Handle>() < handle) close(handle);
+	}
+
+	// One wheel for each reactor. A wheel is only used by the thread of its reactor
+	TimerWheel *TimerWheel::getInstance(void)
+	{
+		static TimerWheel timerWheel[MaxNumberOfReactors];
+		return &timerWheel[getReactorIndexForThisThread()];
+	}
+
+
+	// ------------------------------------------------------------------------
+	// 2.3 Time and timerfd
+
+	u64 TimerWheel::getCurrentTimeInMs(void)
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (static_cast<u64>(ts.tv_sec) * 1000ULL) + (static_cast<u64>(ts.tv_nsec) / 1000000ULL);
+	}
+
+	// The timerfd runs on absolute monotonic time. A timer will never expire before its tick
+	void TimerWheel::arm(const u64 tick)
+	{
+		struct itimerspec its;
+		const u64 timeInMs = tick * TimerWheelTickInMs;
+		its.it_interval.tv_sec = null<time_t>();
+		its.it_interval.tv_nsec = null<long>();
+		its.it_value.tv_sec = static_cast<time_t>(timeInMs / 1000ULL);
+		its.it_value.tv_nsec = static_cast<long>((timeInMs % 1000ULL) * 1000000ULL);
+		timerfd_settime(handle, TFD_TIMER_ABSTIME, &its, null<struct itimerspec *>());
+		armedTick = tick;
+	}
+
+	// Look for the next slot with timers. Timers for later revolutions just cause a wake up without effect
+	void TimerWheel::armForNextTimer(void)
+	{
+		u64 nextTick = null<u64>();
+		for (uint i = 1U; (null<u64>() == nextTick) && (numberOfTimers > null<uint>()) && (i <= NumberOfTimerWheelSlots); ++i)
+		{
+			if (null<EventTimer *>() != slot[(lastHandledTick + i) % NumberOfTimerWheelSlots].getFirst())
+			{
+				nextTick = lastHandledTick + i;
+			}
+		}
+		arm(nextTick);
+	}
+
+
+	// ------------------------------------------------------------------------
+	// 2.4 Add and remove timers
+
+	void TimerWheel::add(EventTimer *const eventTimer, const u32 delayInMs)
+	{
+		if (null<Handle>() > handle)
+		{
+			handle = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+		}
+		if (!isRegistered)
+		{
+			reactorRegisterEventHandler(this, EventTypeIn);
+			isRegistered = true;
+		}
+
+		const u64 currentTimeInMs = getCurrentTimeInMs();
+		if (null<uint>() == numberOfTimers)
+		{
+			// The wheel was idle. Start counting from now
+			lastHandledTick = currentTimeInMs / TimerWheelTickInMs;
+		}
+		eventTimer->expiryTimeInMs = currentTimeInMs + delayInMs;
+		u64 tick = (eventTimer->expiryTimeInMs + TimerWheelTickInMs - 1ULL) / TimerWheelTickInMs;
+		// Slots up to the last handled tick will only be looked at again in the next revolution
+		if (tick <= lastHandledTick)
+		{
+			tick = lastHandledTick + 1ULL;
+		}
+		slot[tick % NumberOfTimerWheelSlots].insert(eventTimer);
+		eventTimer->timerWheel = this;
+		++numberOfTimers;
+
+		if ((null<u64>() == armedTick) || (tick < armedTick))
+		{
+			arm(tick);
+		}
+	}
+
+	// Timers in the list of expired timers are not counted
+	void TimerWheel::remove(EventTimer *const eventTimer)
+	{
+		if (&expiredTimers != eventTimer->timerList)
+		{
+			--numberOfTimers;
+		}
+		TimerList::remove(eventTimer);
+		eventTimer->timerWheel = null<TimerWheel *>();
+
+		// No timers any more. Stop waking up. The reactor may belong to a thread, that will be stopped
+		if ((null<uint>() == numberOfTimers) && (null<EventTimer *>() == expiredTimers.getFirst()))
+		{
+			arm(null<u64>());
+			if (isRegistered)
+			{
+				reactorUnRegisterEventHandler(this);
+				isRegistered = false;
+			}
+		}
+	}
+
+
+	// ------------------------------------------------------------------------
+	// 2.5 Handle the timerfd event
+
+	// Collect all expired timers first. Subscribers may start and stop any timer during notification
+	EventProcessing::Action TimerWheel::handleEvent(const EventType)
+	{
+		u64 numberOfExpirations;
+		// The timerfd may have been set again in the meantime. Then there is nothing to read
+		(void)read(handle, &numberOfExpirations, sizeof(numberOfExpirations));
+		armedTick = null<u64>();
+
+		const u64 currentTimeInMs = getCurrentTimeInMs();
+		const u64 currentTick = currentTimeInMs / TimerWheelTickInMs;
+		// Look at every slot, which has been passed since the last event. But at most once
+		const u64 numberOfTicks = currentTick - lastHandledTick;
+		const u64 numberOfSlotsToHandle = (numberOfTicks < NumberOfTimerWheelSlots) ? numberOfTicks : static_cast<u64>(NumberOfTimerWheelSlots);
+		for (u64 i = 1ULL; i <= numberOfSlotsToHandle; ++i)
+		{
+			EventTimer *eventTimer = slot[(lastHandledTick + i) % NumberOfTimerWheelSlots].getFirst();
+			while (null<EventTimer *>() != eventTimer)
+			{
+				EventTimer *const nextEventTimer = eventTimer->next;
+				if (((eventTimer->expiryTimeInMs + TimerWheelTickInMs - 1ULL) / TimerWheelTickInMs) <= currentTick)
+				{
+					TimerList::remove(eventTimer);
+					expiredTimers.insert(eventTimer);
+					--numberOfTimers;
+				}
+				eventTimer = nextEventTimer;
+			}
+		}
+		if (currentTick > lastHandledTick)
+		{
+			lastHandledTick = currentTick;
+		}
+
+		while (null<EventTimer *>() != expiredTimers.getFirst())
+		{
+			EventTimer *const eventTimer = expiredTimers.getFirst();
+			TimerList::remove(eventTimer);
+			eventTimer->timerWheel = null<TimerWheel *>();
+			if (eventTimer->periodic)
+			{
+				// Keep the period without drift. If we are late for more than a period, start again from now
+				const u64 nextExpiryTimeInMs = eventTimer->expiryTimeInMs + eventTimer->periodInMs;
+				const u32 delayInMs = (nextExpiryTimeInMs > currentTimeInMs) ? static_cast<u32>(nextExpiryTimeInMs - currentTimeInMs) : eventTimer->periodInMs;
+				add(eventTimer, delayInMs);
+			}
+			// The subscriber may even destroy the timer. Do not touch it afterwards
+			eventTimer->notifySubscribers();
+		}
+
+		if (null<uint>() == numberOfTimers)
+		{
+			if (isRegistered)
+			{
+				reactorUnRegisterEventHandler(this);
+				isRegistered = false;
+			}
+		}
+		else
+		{
+			// The periodic timers have been added again and armed the timerfd for their own next tick.
+			// A timer, that was already waiting, may expire earlier. So look for the next timer in the whole wheel
+			armForNextTimer();
+		}
+		return EventProcessing::Continue;
+	}
+}
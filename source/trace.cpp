@@ -0,0 +1,196 @@
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+// -----------------------------------------------------------------------------------------------------
+//
+// trace.cpp
+//
+// General Description
+//
+// Ring buffers for the records of the probes and the output in the Chrome trace format. See trace.hpp
+//
+
+
+
+#include "trace.hpp"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iomanip>
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 1. Ring buffers
+
+namespace TraceInternal
+{
+	//lint -e{956}
+	boolean traceIsActive = false;
+
+	namespace
+	{
+		// Names of the probes in the trace file
+		const mchar *const TraceProbeName[TraceProbe::NumberOfProbes] = 
+		{
+			"SerialRead", "EscFrameStart", "EscFrameEnd", "Parse", "ParserDone", "ParserError", "TraverseAndEvaluate",
+			"EhzSystemUpdate", "StoreMeasuredValues", "ReactorDispatch", "TcpWrite", "TcpWriteComplete"
+		};
+
+		// Threads, that get a ring buffer. All further threads are not traced
+		const uint NumberOfTraceBuffers = 16U;
+		// Records per thread. The memory is only touched by threads, that really write records
+		const u64 TraceBufferCapacity = 4096ULL;
+
+		struct TraceRecord
+		{
+			u64 startTimeInNs;
+			u64 durationInNs;
+			u64 argument;
+			TraceProbe::Type probe;
+			boolean isInstant;
+		};
+
+		// Only the owning thread writes. The number of records is published with release semantic
+		struct TraceBuffer
+		{
+			TraceRecord traceRecord[TraceBufferCapacity];
+			u64 numberOfRecords;
+			sint threadId;
+		};
+
+		//lint -e{956}
+		TraceBuffer traceBuffer[NumberOfTraceBuffers];
+		//lint -e{956}
+		uint numberOfClaimedTraceBuffers = 0U;
+		// Records before this time belong to an earlier trace
+		//lint -e{956}
+		u64 traceStartTimeInNs = 0ULL;
+
+		// Thread local static data, so initialized with 0 for every thread
+		//lint -e{956}
+		__thread TraceBuffer *traceBufferForThisThread;
+		//lint -e{956}
+		__thread boolean traceBufferHasBeenClaimed;
+
+		// A thread claims its buffer with the first record. Null, if all buffers are taken
+		TraceBuffer *getTraceBufferForThisThread(void)
+		{
+			if (!traceBufferHasBeenClaimed)
+			{
+				traceBufferHasBeenClaimed = true;
+				const uint index = __atomic_fetch_add(&numberOfClaimedTraceBuffers, 1U, __ATOMIC_ACQ_REL);
+				if (index < NumberOfTraceBuffers)
+				{
+					traceBuffer[index].threadId = static_cast<sint>(syscall(SYS_gettid));
+					traceBufferForThisThread = &traceBuffer[index];
+				}
+			}
+			return traceBufferForThisThread;
+		}
+
+		void record(const TraceProbe::Type probe, const u64 startTimeInNs, const u64 durationInNs, const u64 argument, const boolean isInstant)
+		{
+			TraceBuffer *const tb = getTraceBufferForThisThread();
+			if (null<TraceBuffer *>() != tb)
+			{
+				TraceRecord &traceRecord = tb->traceRecord[tb->numberOfRecords % TraceBufferCapacity];
+				traceRecord.startTimeInNs = startTimeInNs;
+				traceRecord.durationInNs = durationInNs;
+				traceRecord.argument = argument;
+				traceRecord.probe = probe;
+				traceRecord.isInstant = isInstant;
+				__atomic_store_n(&tb->numberOfRecords, tb->numberOfRecords + 1ULL, __ATOMIC_RELEASE);
+			}
+		}
+	}
+
+	void recordSpan(const TraceProbe::Type probe, const u64 startTimeInNs, const u64 argument)
+	{
+		record(probe, startTimeInNs, MetricsInternal::getMonotonicTimeInNs() - startTimeInNs, argument, false);
+	}
+
+	void recordInstant(const TraceProbe::Type probe, const u64 argument)
+	{
+		record(probe, MetricsInternal::getMonotonicTimeInNs(), null<u64>(), argument, true);
+	}
+
+
+// ------------------------------------------------------------------------------------------------------------------------------
+// 2. Control and output
+
+	namespace
+	{
+		// Microseconds with 3 decimals. The unit of the Chrome trace format
+		void writeTimeInUs(std::ostream &os, const u64 timeInNs)
+		{
+			os << (timeInNs / 1000ULL) << '.' << std::setw(3) << std::setfill('0') << (timeInNs % 1000ULL) << std::setfill(' ');
+		}
+
+		void writeTraceRecord(std::ostream &os, const TraceRecord &traceRecord, const sint threadId, const boolean isFirstEvent)
+		{
+			os << (isFirstEvent ? "\n" : ",\n") << "{\"name\":\"" << TraceProbeName[traceRecord.probe] << "\",\"cat\":\"ehz\",\"ph\":\"" << (traceRecord.isInstant ? "i\",\"s\":\"t" : "X") << "\",\"ts\":";
+			writeTimeInUs(os, traceRecord.startTimeInNs - traceStartTimeInNs);
+			if (!traceRecord.isInstant)
+			{
+				os << ",\"dur\":";
+				writeTimeInUs(os, traceRecord.durationInNs);
+			}
+			os << ",\"pid\":" << getpid() << ",\"tid\":" << threadId << ",\"args\":{\"argument\":" << traceRecord.argument << "}}";
+		}
+	}
+
+	boolean startTrace(void)
+	{
+		__atomic_store_n(&traceStartTimeInNs, MetricsInternal::getMonotonicTimeInNs(), __ATOMIC_RELAXED);
+		__atomic_store_n(&traceIsActive, true, __ATOMIC_RELEASE);
+		return isTraceActive();
+	}
+
+	// A thread may still write the record of a span, that ended just now. It may overwrite the oldest
+	// record in its buffer. So this one is not written
+	boolean stopTrace(void)
+	{
+		__atomic_store_n(&traceIsActive, false, __ATOMIC_RELEASE);
+		std::ofstream traceFile(EhzTraceFileName);
+		traceFile << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		boolean isFirstEvent = true;
+		const uint claimedTraceBuffers = __atomic_load_n(&numberOfClaimedTraceBuffers, __ATOMIC_ACQUIRE);
+		for (uint i = null<uint>(); (i < claimedTraceBuffers) && (i < NumberOfTraceBuffers); ++i)
+		{
+			const TraceBuffer &tb = traceBuffer[i];
+			const u64 numberOfRecords = __atomic_load_n(&tb.numberOfRecords, __ATOMIC_ACQUIRE);
+			const u64 firstRecord = (numberOfRecords < TraceBufferCapacity) ? null<u64>() : (numberOfRecords - TraceBufferCapacity + 1ULL);
+			for (u64 r = firstRecord; r < numberOfRecords; ++r)
+			{
+				const TraceRecord &traceRecord = tb.traceRecord[r % TraceBufferCapacity];
+				if (traceRecord.startTimeInNs >= traceStartTimeInNs)
+				{
+					writeTraceRecord(traceFile, traceRecord, tb.threadId, isFirstEvent);
+					isFirstEvent = false;
+				}
+			}
+		}
+		traceFile << "\n]}\n";
+		traceFile.close();
+		return !traceFile.fail();
+	}
+}
@@ -1,93 +1,281 @@
-// -----------------------------------------------------------------------------------------------------
-//
-// SML Parser
-//
-// Copyright (C) 2018  Armin Montigny
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program. If not, see <http://www.gnu.org/licenses/>.
-//
-// -----------------------------------------------------------------------------------------------------
-//
-//
-// transfer.cpp
-//
-// Send data asynchronously to a stream
-//
-// Helper functions for asynchronous data transmission. Mainly used to send data via TCP.
-// in most cases, handles of file descriptors point to sockets
-//
-// A class is defined for transmitting data over a socket asynchronously and with
-// no handshake or whatsoever. Meaning, we don't care, if the function succeeds or not.
-// The class instance is dynamically created on the heap and self destructs after it
-// completes its work.
-//
-
-
-#include "transfer.hpp"
-
-// -------------------------------------------------------------------------------------------------------------------------------------
-// 1. Wrapper functions for transmitting data via class AsynchronousDataWriterWithSelfDestruct
-
-	// This functions will always be used to transmit the data
-	// So far we will not use and instance of AsynchronousDataWriterWithSelfDestruct explicetely
-	
-	
-	// Functions to write data from different source
-	
-
-	// From a string
-	void writeDataAsynchronous(const std::string &sourceString, const Handle h)
-	{
-		//lint --e{429}  "Custodial pointer 'Symbol' (Location) has not been freed or returned".   Yes, intended
-		TransferInternal::AsynchronousDataWriterWithSelfDestruct *const adw = new TransferInternal::AsynchronousDataWriterWithSelfDestruct(sourceString,h);
-		(*adw)();
-	}
-	
-	// From a ostringstream
-	void writeDataAsynchronous(const std::ostringstream &s, const Handle h)
-	{
-		//lint --e{429}  "Custodial pointer 'Symbol' (Location) has not been freed or returned".   Yes, intended
-		TransferInternal::AsynchronousDataWriterWithSelfDestruct *const adw = new TransferInternal::AsynchronousDataWriterWithSelfDestruct(s,h);
-		(*adw)();
-	}
-	
-	
-namespace TransferInternal
-{
-// -----------------------------------------------------------
-// 2. Event Handler for Proactor
-
-	// Call back for asynchronous function. We will do nothing
-	// Just forward to synchronous event handler
-	//lint -e{1961}    1961 virtual member function 'Symbol' could be made const
-	AsynchronousCompletionEvent::Action AsynchronousDataWriterWithSelfDestruct::handleCompletionEventAsync(ACT *)
-	{
-		return AsynchronousCompletionEvent::CallSynchronousEventhandler;
-	}
-	
-	// This object and function will be destroyed synchronously
-	//lint -e{952} "Parameter 'Symbol' (Location) could be declared const"   No. Cannot.
-	EventProcessing::Action  AsynchronousDataWriterWithSelfDestruct::handleCompletionEventSync(ACT *actl) 
-	{ 
-		// ACT for this operation is no longer in use
-		actl->actBusySynchronously = false;	
-		// We will delete "this"
-		destroy(); 
-		// Continue with main event loop of Reactor
-		return EventProcessing::Continue; 	
-	}
-}
-
- 
-
+// -----------------------------------------------------------------------------------------------------
+//
+// SML Parser
+//
+// Copyright (C) 2018  Armin Montigny
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------------------------------
+//
+//
+// transfer.cpp
+//
+// Send data asynchronously to a stream
+//
+// Helper functions for asynchronous data transmission. Mainly used to send data via TCP.
+// in most cases, handles of file descriptors point to sockets
+//
+// A class is defined for transmitting data over a socket asynchronously and with
+// no handshake or whatsoever. Meaning, we don't care, if the function succeeds or not.
+// The class instance is dynamically created on the heap and self destructs after it
+// completes its work.
+//
+
+
+#include "transfer.hpp"
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <string.h>
+
+// -------------------------------------------------------------------------------------------------------------------------------------
+// 1. Wrapper functions for transmitting data via class AsynchronousDataWriterWithSelfDestruct
+
+	// This functions will always be used to transmit the data
+	// So far we will not use and instance of AsynchronousDataWriterWithSelfDestruct explicetely
+	
+	
+	// Functions to write data from different source
+	
+
+	// From a string
+	void writeDataAsynchronous(const std::string &sourceString, const Handle h)
+	{
+		//lint --e{429}  "Custodial pointer 'Symbol' (Location) has not been freed or returned".   Yes, intended
+		TransferInternal::AsynchronousDataWriterWithSelfDestruct *const adw = new TransferInternal::AsynchronousDataWriterWithSelfDestruct(sourceString,h);
+		(*adw)();
+	}
+	
+	// From a ostringstream
+	void writeDataAsynchronous(const std::ostringstream &s, const Handle h)
+	{
+		//lint --e{429}  "Custodial pointer 'Symbol' (Location) has not been freed or returned".   Yes, intended
+		TransferInternal::AsynchronousDataWriterWithSelfDestruct *const adw = new TransferInternal::AsynchronousDataWriterWithSelfDestruct(s,h);
+		(*adw)();
+	}
+	
+	// From a shared buffer
+	void writeDataAsynchronous(const SharedString &sharedString, const Handle h)
+	{
+		//lint --e{429}  "Custodial pointer 'Symbol' (Location) has not been freed or returned".   Yes, intended
+		TransferInternal::AsynchronousDataWriterWithSelfDestruct *const adw = new TransferInternal::AsynchronousDataWriterWithSelfDestruct(sharedString,h);
+		(*adw)();
+	}
+	
+	
+namespace TransferInternal
+{
+// -----------------------------------------------------------
+// 2. Event Handler for Proactor
+
+	// Call back for asynchronous function. We will do nothing
+	// Just forward to synchronous event handler
+	//lint -e{1961}    1961 virtual member function 'Symbol' could be made const
+	AsynchronousCompletionEvent::Action AsynchronousDataWriterWithSelfDestruct::handleCompletionEventAsync(ACT *)
+	{
+		return AsynchronousCompletionEvent::CallSynchronousEventhandler;
+	}
+	
+	// This object and function will be destroyed synchronously
+	//lint -e{952} "Parameter 'Symbol' (Location) could be declared const"   No. Cannot.
+	EventProcessing::Action  AsynchronousDataWriterWithSelfDestruct::handleCompletionEventSync(ACT *actl) 
+	{ 
+		// ACT for this operation is no longer in use
+		actl->actBusySynchronously = false;	
+		// We will delete "this"
+		destroy(); 
+		// Continue with main event loop of Reactor
+		return EventProcessing::Continue; 	
+	}
+}
+
+ 
+
+
+
+// -----------------------------------------------------------
+// 3. Non blocking transmission of data with a queue per connection
+
+namespace TransferInternal
+{
+
+	// -----------------------------------------------------
+	// 3.1 Pool for the elements of the write queues
+
+	QueuedBufferPool::~QueuedBufferPool(void)
+	{
+		try
+		{
+			while (null<QueuedBuffer *>() != freeList)
+			{
+				QueuedBuffer *const queuedBuffer = freeList;
+				freeList = freeList->next;
+				delete queuedBuffer;
+			}
+		}
+		catch(...)
+		{
+		}
+	}
+	
+	// Take an element from the free list. Only if it is empty, a new one is created
+	QueuedBuffer *QueuedBufferPool::get(const SharedString &sharedString)
+	{
+		QueuedBuffer *queuedBuffer = freeList;
+		if (null<QueuedBuffer *>() == queuedBuffer)
+		{
+			queuedBuffer = new QueuedBuffer();
+		}
+		else
+		{
+			freeList = freeList->next;
+		}
+		queuedBuffer->sharedString = sharedString;
+		queuedBuffer->next = null<QueuedBuffer *>();
+		return queuedBuffer;
+	}
+	
+	void QueuedBufferPool::put(QueuedBuffer *const queuedBuffer)
+	{
+		// Release the data. The empty shared string has no own buffer
+		queuedBuffer->sharedString = SharedString();
+		queuedBuffer->next = freeList;
+		freeList = queuedBuffer;
+	}
+	
+
+	// -----------------------------------------------------
+	// 3.2 Write queue for one connection
+	
+	// Only if nothing is queued, the data may be sent at once. Otherwise the order would be wrong
+	WriteQueue::WriteState WriteQueue::write(const SharedString &sharedString, const Handle h)
+	{
+		WriteState rc = Complete;
+		const std::string &data = sharedString.str();
+		size_t bytesSent = null<size_t>();
+		if (isEmpty())
+		{
+			const ssize_t sendResult = send(h, data.data(), data.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+			if (sendResult >= 0)
+			{
+				//lint -e{571}
+				bytesSent = static_cast<size_t>(sendResult);
+			}
+			else if ((EAGAIN != errno) && (EWOULDBLOCK != errno))
+			{
+				// The connection is broken. The reader will notice it
+				rc = Error;
+			}
+			else
+			{
+				// Socket buffer is full. Queue everything
+			}
+		}
+		if ((Error != rc) && (bytesSent < data.size()))
+		{
+			QueuedBuffer *const queuedBuffer = QueuedBufferPool::getInstance()->get(sharedString);
+			if (isEmpty())
+			{
+				head = queuedBuffer;
+				headOffset = bytesSent;
+			}
+			else
+			{
+				tail->next = queuedBuffer;
+			}
+			tail = queuedBuffer;
+			rc = Pending;
+		}
+		return rc;
+	}
+	
+	// The socket is writable again. Send all queued buffers with one system call, as far as possible
+	WriteQueue::WriteState WriteQueue::flush(const Handle h)
+	{
+		const uint maxNumberOfBuffers = 16U;
+		WriteState rc = isEmpty() ? Complete : Pending;
+		boolean socketIsWritable = true;
+		while ((Pending == rc) && socketIsWritable)
+		{
+			struct iovec ioVector[maxNumberOfBuffers];
+			uint numberOfBuffers = null<uint>();
+			size_t bytesToSend = null<size_t>();
+			size_t offset = headOffset;
+			for (QueuedBuffer *queuedBuffer = head; (null<QueuedBuffer *>() != queuedBuffer) && (numberOfBuffers < maxNumberOfBuffers); queuedBuffer = queuedBuffer->next)
+			{
+				const std::string &data = queuedBuffer->sharedString.str();
+				//lint -e{1960,925,9005,926}
+				ioVector[numberOfBuffers].iov_base = const_cast<mchar *>(data.data() + offset);
+				ioVector[numberOfBuffers].iov_len = data.size() - offset;
+				bytesToSend += ioVector[numberOfBuffers].iov_len;
+				offset = null<size_t>();
+				++numberOfBuffers;
+			}
+			
+			struct msghdr messageHeader;
+			memset(&messageHeader, 0, sizeof(messageHeader));
+			messageHeader.msg_iov = &ioVector[0];
+			messageHeader.msg_iovlen = numberOfBuffers;
+			const ssize_t sendResult = sendmsg(h, &messageHeader, MSG_NOSIGNAL | MSG_DONTWAIT);
+			
+			if (sendResult < 0)
+			{
+				socketIsWritable = false;
+				if ((EAGAIN != errno) && (EWOULDBLOCK != errno))
+				{
+					rc = Error;
+					clear();
+				}
+			}
+			else
+			{
+				//lint -e{571}
+				size_t bytesSent = static_cast<size_t>(sendResult);
+				// If less was sent than requested, then the socket buffer is full. Wait for the next EventTypeOut
+				socketIsWritable = (bytesSent == bytesToSend);
+				// Remove everything that has been sent completely
+				while ((null<QueuedBuffer *>() != head) && (bytesSent >= (head->sharedString.str().size() - headOffset)))
+				{
+					bytesSent -= (head->sharedString.str().size() - headOffset);
+					pop();
+				}
+				headOffset += bytesSent;
+				rc = isEmpty() ? Complete : Pending;
+			}
+		}
+		return rc;
+	}
+	
+	void WriteQueue::pop(void)
+	{
+		QueuedBuffer *const queuedBuffer = head;
+		head = head->next;
+		if (null<QueuedBuffer *>() == head)
+		{
+			tail = null<QueuedBuffer *>();
+		}
+		headOffset = null<size_t>();
+		QueuedBufferPool::getInstance()->put(queuedBuffer);
+	}
+	
+	void WriteQueue::clear(void)
+	{
+		while (!isEmpty())
+		{
+			pop();
+		}
+	}
+}
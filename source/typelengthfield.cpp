@@ -133,262 +133,262 @@
 
 	const TlByteAnalysis::TLBT TlByteAnalysis::tlbt[256] = 
 	{
-		{ Token::END_OF_MESSAGE, 0UL, &handleTlByteBasic },             //0x00
-		{ Token::OPTIONAL, 1UL, &handleTlByteOptional },                   //0x01
-		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteOctet },                      //0x02
-		{ Token::CONDITION_NOT_YET_DETECTED, 2UL, &handleTlByteOctet },                      //0x03
-		{ Token::CONDITION_NOT_YET_DETECTED, 3UL, &handleTlByteOctet },                      //0x04
-		{ Token::CONDITION_NOT_YET_DETECTED, 4UL, &handleTlByteOctet },                      //0x05
-		{ Token::CONDITION_NOT_YET_DETECTED, 5UL, &handleTlByteOctet },                      //0x06
-		{ Token::CONDITION_NOT_YET_DETECTED, 6UL, &handleTlByteOctet },                      //0x07
-		{ Token::CONDITION_NOT_YET_DETECTED, 7UL, &handleTlByteOctet },                      //0x08
-		{ Token::CONDITION_NOT_YET_DETECTED, 8UL, &handleTlByteOctet },                      //0x09
-		{ Token::CONDITION_NOT_YET_DETECTED, 9UL, &handleTlByteOctet },                      //0x0A
-		{ Token::CONDITION_NOT_YET_DETECTED, 10UL, &handleTlByteOctet },                     //0x0B
-		{ Token::CONDITION_NOT_YET_DETECTED, 11UL, &handleTlByteOctet },                     //0x0C
-		{ Token::CONDITION_NOT_YET_DETECTED, 12UL, &handleTlByteOctet },                     //0x0D
-		{ Token::CONDITION_NOT_YET_DETECTED, 13UL, &handleTlByteOctet },                     //0x0E
-		{ Token::CONDITION_NOT_YET_DETECTED, 14UL, &handleTlByteOctet },                     //0x0F
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x10
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x11
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x12
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x13
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x14
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x15
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x16
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x17
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x18
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x19
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x1A
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x1B
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x1C
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x1D
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x1E
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x1F
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x20
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x21
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x22
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x23
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x24
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x25
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x26
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x27
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x28
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x29
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x2A
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x2B
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x2C
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x2D
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x2E
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x2F
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x30
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x31
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x32
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x33
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x34
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x35
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x36
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x37
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x38
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x39
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x3A
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x3B
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x3C
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x3D
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x3E
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x3F
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x40
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x41
-		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteBoolean },                  //0x42
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x43
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x44
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x45
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x46
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x47
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x48
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x49
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x4A
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x4B
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x4C
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x4D
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x4E
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x4F
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x50
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x51
-		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteSignedInteger },     //0x52
-		{ Token::CONDITION_NOT_YET_DETECTED, 2UL, &handleTlByteSignedInteger },     //0x53
-		{ Token::CONDITION_NOT_YET_DETECTED, 3UL, &handleTlByteSignedInteger },     //0x54
-		{ Token::CONDITION_NOT_YET_DETECTED, 4UL, &handleTlByteSignedInteger },     //0x55
-		{ Token::CONDITION_NOT_YET_DETECTED, 5UL, &handleTlByteSignedInteger },     //0x56
-		{ Token::CONDITION_NOT_YET_DETECTED, 6UL, &handleTlByteSignedInteger },     //0x57
-		{ Token::CONDITION_NOT_YET_DETECTED, 7UL, &handleTlByteSignedInteger },     //0x58
-		{ Token::CONDITION_NOT_YET_DETECTED, 8UL, &handleTlByteSignedInteger },     //0x59
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x5A
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x5B
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x5C
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x5D
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x5E
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x5F
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x60
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x61
-		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteUnsignedInteger }, //0x62
-		{ Token::CONDITION_NOT_YET_DETECTED, 2UL, &handleTlByteUnsignedInteger }, //0x63
-		{ Token::CONDITION_NOT_YET_DETECTED, 3UL, &handleTlByteUnsignedInteger }, //0x64
-		{ Token::CONDITION_NOT_YET_DETECTED, 4UL, &handleTlByteUnsignedInteger }, //0x65
-		{ Token::CONDITION_NOT_YET_DETECTED, 5UL, &handleTlByteUnsignedInteger }, //0x66
-		{ Token::CONDITION_NOT_YET_DETECTED, 6UL, &handleTlByteUnsignedInteger }, //0x67
-		{ Token::CONDITION_NOT_YET_DETECTED, 7UL, &handleTlByteUnsignedInteger }, //0x68
-		{ Token::CONDITION_NOT_YET_DETECTED, 8UL, &handleTlByteUnsignedInteger }, //0x69
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x6A
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x6B
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x6C
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x6D
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x6E
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x6F
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },       //0x70
-		{ Token::LIST, 1UL, &handleTlByteBasic },                       //0x71
-		{ Token::LIST, 2UL, &handleTlByteBasic },                       //0x72
-		{ Token::LIST, 3UL, &handleTlByteBasic },                       //0x73
-		{ Token::LIST, 4UL, &handleTlByteBasic },                       //0x74
-		{ Token::LIST, 5UL, &handleTlByteBasic },                       //0x75
-		{ Token::LIST, 6UL, &handleTlByteBasic },                       //0x76
-		{ Token::LIST, 7UL, &handleTlByteBasic },                       //0x77
-		{ Token::LIST, 8UL, &handleTlByteBasic },                       //0x78
-		{ Token::LIST, 9UL, &handleTlByteBasic },                       //0x79
-		{ Token::LIST, 10UL, &handleTlByteBasic },                      //0x7A
-		{ Token::LIST, 11UL, &handleTlByteBasic },                      //0x7B
-		{ Token::LIST, 12UL, &handleTlByteBasic },                      //0x7C
-		{ Token::LIST, 13UL, &handleTlByteBasic },                      //0x7D
-		{ Token::LIST, 14UL, &handleTlByteBasic },                      //0x7E
-		{ Token::LIST, 15UL, &handleTlByteBasic },                      //0x7F
-		{ Token::CONDITION_NOT_YET_DETECTED, 0UL, &handleTlByteMultiByteOctet },                      //0x80
-		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteMultiByteOctet },                      //0x81
-		{ Token::CONDITION_NOT_YET_DETECTED, 2UL, &handleTlByteMultiByteOctet},                      //0x82
-		{ Token::CONDITION_NOT_YET_DETECTED, 3UL, &handleTlByteMultiByteOctet },                      //0x83
-		{ Token::CONDITION_NOT_YET_DETECTED, 4UL, &handleTlByteMultiByteOctet },                      //0x84
-		{ Token::CONDITION_NOT_YET_DETECTED, 5UL, &handleTlByteMultiByteOctet },                      //0x85
-		{ Token::CONDITION_NOT_YET_DETECTED, 6UL, &handleTlByteMultiByteOctet },                      //0x86
-		{ Token::CONDITION_NOT_YET_DETECTED, 7UL, &handleTlByteMultiByteOctet },                      //0x87
-		{ Token::CONDITION_NOT_YET_DETECTED, 8UL, &handleTlByteMultiByteOctet },                      //0x88
-		{ Token::CONDITION_NOT_YET_DETECTED, 9UL, &handleTlByteMultiByteOctet },                      //0x89
-		{ Token::CONDITION_NOT_YET_DETECTED, 10UL, &handleTlByteMultiByteOctet },                      //0x8A
-		{ Token::CONDITION_NOT_YET_DETECTED, 11UL, &handleTlByteMultiByteOctet },                      //0x8B
-		{ Token::CONDITION_NOT_YET_DETECTED, 12UL, &handleTlByteMultiByteOctet },                      //0x8C
-		{ Token::CONDITION_NOT_YET_DETECTED, 13UL, &handleTlByteMultiByteOctet },                      //0x8D
-		{ Token::CONDITION_NOT_YET_DETECTED, 14UL, &handleTlByteMultiByteOctet },                      //0x8E
-		{ Token::CONDITION_NOT_YET_DETECTED, 15UL, &handleTlByteMultiByteOctet },                      //0x8F
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x90
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x91
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x92
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x93
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x94
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x95
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x96
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x97
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x98
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x99
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x9A
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x9B
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x9C
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x9D
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x9E
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0x9F
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xA0
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xA1
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xA2
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xA3
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xA4
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xA5
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xA6
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xA7
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xA8
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xA9
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xAA
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xAB
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xAC
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xAD
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xAE
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xAF
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xB0
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xB1
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xB2
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xB3
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xB4
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xB5
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xB6
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xB7
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xB8
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xB9
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xBA
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xBB
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xBC
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xBD
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xBE
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xBF
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xC0
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xC1
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xC2
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xC3
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xC4
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xC5
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xC6
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xC7
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xC8
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xC9
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xCA
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xCB
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xCC
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xCD
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xCE
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xCF
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xD0
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xD1
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xD2
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xD3
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xD4
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xD5
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xD6
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xD7
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xD8
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xD9
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xDA
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xDB
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xDC
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xDD
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xDE
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xDF
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xE0
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xE1
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xE2
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xE3
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xE4
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xE5
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xE6
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xE7
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xE8
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xE9
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xEA
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xEB
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xEC
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xED
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xEE
-		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset },      //0xEF
-		{ Token::CONDITION_NOT_YET_DETECTED, 0UL, &handleTlByteMultiByteList },      //0xF0
-		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteMultiByteList },      //0xF1
-		{ Token::CONDITION_NOT_YET_DETECTED, 2UL, &handleTlByteMultiByteList },      //0xF2
-		{ Token::CONDITION_NOT_YET_DETECTED, 3UL, &handleTlByteMultiByteList },      //0xF3
-		{ Token::CONDITION_NOT_YET_DETECTED, 4UL, &handleTlByteMultiByteList },      //0xF4
-		{ Token::CONDITION_NOT_YET_DETECTED, 5UL, &handleTlByteMultiByteList },      //0xF5
-		{ Token::CONDITION_NOT_YET_DETECTED, 6UL, &handleTlByteMultiByteList },      //0xF6
-		{ Token::CONDITION_NOT_YET_DETECTED, 7UL, &handleTlByteMultiByteList },      //0xF7
-		{ Token::CONDITION_NOT_YET_DETECTED, 8UL, &handleTlByteMultiByteList },      //0xF8
-		{ Token::CONDITION_NOT_YET_DETECTED, 9UL, &handleTlByteMultiByteList },      //0xF9
-		{ Token::CONDITION_NOT_YET_DETECTED, 10UL, &handleTlByteMultiByteList },      //0xFA
-		{ Token::CONDITION_NOT_YET_DETECTED, 11UL, &handleTlByteMultiByteList },      //0xFB
-		{ Token::CONDITION_NOT_YET_DETECTED, 12UL, &handleTlByteMultiByteList },      //0xFC
-		{ Token::CONDITION_NOT_YET_DETECTED, 13UL, &handleTlByteMultiByteList },      //0xFD
-		{ Token::CONDITION_NOT_YET_DETECTED, 14UL, &handleTlByteMultiByteList },      //0xFE
-		{ Token::CONDITION_NOT_YET_DETECTED, 15UL, &handleTlByteMultiByteList }       //0xFF
+		{ Token::END_OF_MESSAGE, 0UL, &handleTlByteBasic, TlByteAction::Basic },             //0x00
+		{ Token::OPTIONAL, 1UL, &handleTlByteOptional, TlByteAction::Optional },                   //0x01
+		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteOctet, TlByteAction::Octet },                      //0x02
+		{ Token::CONDITION_NOT_YET_DETECTED, 2UL, &handleTlByteOctet, TlByteAction::Octet },                      //0x03
+		{ Token::CONDITION_NOT_YET_DETECTED, 3UL, &handleTlByteOctet, TlByteAction::Octet },                      //0x04
+		{ Token::CONDITION_NOT_YET_DETECTED, 4UL, &handleTlByteOctet, TlByteAction::Octet },                      //0x05
+		{ Token::CONDITION_NOT_YET_DETECTED, 5UL, &handleTlByteOctet, TlByteAction::Octet },                      //0x06
+		{ Token::CONDITION_NOT_YET_DETECTED, 6UL, &handleTlByteOctet, TlByteAction::Octet },                      //0x07
+		{ Token::CONDITION_NOT_YET_DETECTED, 7UL, &handleTlByteOctet, TlByteAction::Octet },                      //0x08
+		{ Token::CONDITION_NOT_YET_DETECTED, 8UL, &handleTlByteOctet, TlByteAction::Octet },                      //0x09
+		{ Token::CONDITION_NOT_YET_DETECTED, 9UL, &handleTlByteOctet, TlByteAction::Octet },                      //0x0A
+		{ Token::CONDITION_NOT_YET_DETECTED, 10UL, &handleTlByteOctet, TlByteAction::Octet },                     //0x0B
+		{ Token::CONDITION_NOT_YET_DETECTED, 11UL, &handleTlByteOctet, TlByteAction::Octet },                     //0x0C
+		{ Token::CONDITION_NOT_YET_DETECTED, 12UL, &handleTlByteOctet, TlByteAction::Octet },                     //0x0D
+		{ Token::CONDITION_NOT_YET_DETECTED, 13UL, &handleTlByteOctet, TlByteAction::Octet },                     //0x0E
+		{ Token::CONDITION_NOT_YET_DETECTED, 14UL, &handleTlByteOctet, TlByteAction::Octet },                     //0x0F
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x10
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x11
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x12
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x13
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x14
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x15
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x16
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x17
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x18
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x19
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x1A
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x1B
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x1C
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x1D
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x1E
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x1F
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x20
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x21
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x22
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x23
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x24
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x25
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x26
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x27
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x28
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x29
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x2A
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x2B
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x2C
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x2D
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x2E
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x2F
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x30
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x31
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x32
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x33
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x34
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x35
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x36
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x37
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x38
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x39
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x3A
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x3B
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x3C
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x3D
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x3E
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x3F
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x40
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x41
+		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteBoolean, TlByteAction::Boolean },                  //0x42
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x43
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x44
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x45
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x46
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x47
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x48
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x49
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x4A
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x4B
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x4C
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x4D
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x4E
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x4F
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x50
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x51
+		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteSignedInteger, TlByteAction::SignedInteger },     //0x52
+		{ Token::CONDITION_NOT_YET_DETECTED, 2UL, &handleTlByteSignedInteger, TlByteAction::SignedInteger },     //0x53
+		{ Token::CONDITION_NOT_YET_DETECTED, 3UL, &handleTlByteSignedInteger, TlByteAction::SignedInteger },     //0x54
+		{ Token::CONDITION_NOT_YET_DETECTED, 4UL, &handleTlByteSignedInteger, TlByteAction::SignedInteger },     //0x55
+		{ Token::CONDITION_NOT_YET_DETECTED, 5UL, &handleTlByteSignedInteger, TlByteAction::SignedInteger },     //0x56
+		{ Token::CONDITION_NOT_YET_DETECTED, 6UL, &handleTlByteSignedInteger, TlByteAction::SignedInteger },     //0x57
+		{ Token::CONDITION_NOT_YET_DETECTED, 7UL, &handleTlByteSignedInteger, TlByteAction::SignedInteger },     //0x58
+		{ Token::CONDITION_NOT_YET_DETECTED, 8UL, &handleTlByteSignedInteger, TlByteAction::SignedInteger },     //0x59
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x5A
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x5B
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x5C
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x5D
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x5E
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x5F
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x60
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x61
+		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteUnsignedInteger, TlByteAction::UnsignedInteger }, //0x62
+		{ Token::CONDITION_NOT_YET_DETECTED, 2UL, &handleTlByteUnsignedInteger, TlByteAction::UnsignedInteger }, //0x63
+		{ Token::CONDITION_NOT_YET_DETECTED, 3UL, &handleTlByteUnsignedInteger, TlByteAction::UnsignedInteger }, //0x64
+		{ Token::CONDITION_NOT_YET_DETECTED, 4UL, &handleTlByteUnsignedInteger, TlByteAction::UnsignedInteger }, //0x65
+		{ Token::CONDITION_NOT_YET_DETECTED, 5UL, &handleTlByteUnsignedInteger, TlByteAction::UnsignedInteger }, //0x66
+		{ Token::CONDITION_NOT_YET_DETECTED, 6UL, &handleTlByteUnsignedInteger, TlByteAction::UnsignedInteger }, //0x67
+		{ Token::CONDITION_NOT_YET_DETECTED, 7UL, &handleTlByteUnsignedInteger, TlByteAction::UnsignedInteger }, //0x68
+		{ Token::CONDITION_NOT_YET_DETECTED, 8UL, &handleTlByteUnsignedInteger, TlByteAction::UnsignedInteger }, //0x69
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x6A
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x6B
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x6C
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x6D
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x6E
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x6F
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },       //0x70
+		{ Token::LIST, 1UL, &handleTlByteBasic, TlByteAction::Basic },                       //0x71
+		{ Token::LIST, 2UL, &handleTlByteBasic, TlByteAction::Basic },                       //0x72
+		{ Token::LIST, 3UL, &handleTlByteBasic, TlByteAction::Basic },                       //0x73
+		{ Token::LIST, 4UL, &handleTlByteBasic, TlByteAction::Basic },                       //0x74
+		{ Token::LIST, 5UL, &handleTlByteBasic, TlByteAction::Basic },                       //0x75
+		{ Token::LIST, 6UL, &handleTlByteBasic, TlByteAction::Basic },                       //0x76
+		{ Token::LIST, 7UL, &handleTlByteBasic, TlByteAction::Basic },                       //0x77
+		{ Token::LIST, 8UL, &handleTlByteBasic, TlByteAction::Basic },                       //0x78
+		{ Token::LIST, 9UL, &handleTlByteBasic, TlByteAction::Basic },                       //0x79
+		{ Token::LIST, 10UL, &handleTlByteBasic, TlByteAction::Basic },                      //0x7A
+		{ Token::LIST, 11UL, &handleTlByteBasic, TlByteAction::Basic },                      //0x7B
+		{ Token::LIST, 12UL, &handleTlByteBasic, TlByteAction::Basic },                      //0x7C
+		{ Token::LIST, 13UL, &handleTlByteBasic, TlByteAction::Basic },                      //0x7D
+		{ Token::LIST, 14UL, &handleTlByteBasic, TlByteAction::Basic },                      //0x7E
+		{ Token::LIST, 15UL, &handleTlByteBasic, TlByteAction::Basic },                      //0x7F
+		{ Token::CONDITION_NOT_YET_DETECTED, 0UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x80
+		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x81
+		{ Token::CONDITION_NOT_YET_DETECTED, 2UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x82
+		{ Token::CONDITION_NOT_YET_DETECTED, 3UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x83
+		{ Token::CONDITION_NOT_YET_DETECTED, 4UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x84
+		{ Token::CONDITION_NOT_YET_DETECTED, 5UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x85
+		{ Token::CONDITION_NOT_YET_DETECTED, 6UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x86
+		{ Token::CONDITION_NOT_YET_DETECTED, 7UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x87
+		{ Token::CONDITION_NOT_YET_DETECTED, 8UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x88
+		{ Token::CONDITION_NOT_YET_DETECTED, 9UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x89
+		{ Token::CONDITION_NOT_YET_DETECTED, 10UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x8A
+		{ Token::CONDITION_NOT_YET_DETECTED, 11UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x8B
+		{ Token::CONDITION_NOT_YET_DETECTED, 12UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x8C
+		{ Token::CONDITION_NOT_YET_DETECTED, 13UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x8D
+		{ Token::CONDITION_NOT_YET_DETECTED, 14UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x8E
+		{ Token::CONDITION_NOT_YET_DETECTED, 15UL, &handleTlByteMultiByteOctet, TlByteAction::MultiByteOctet },                      //0x8F
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x90
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x91
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x92
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x93
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x94
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x95
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x96
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x97
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x98
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x99
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x9A
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x9B
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x9C
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x9D
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x9E
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0x9F
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xA0
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xA1
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xA2
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xA3
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xA4
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xA5
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xA6
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xA7
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xA8
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xA9
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xAA
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xAB
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xAC
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xAD
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xAE
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xAF
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xB0
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xB1
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xB2
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xB3
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xB4
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xB5
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xB6
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xB7
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xB8
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xB9
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xBA
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xBB
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xBC
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xBD
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xBE
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xBF
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xC0
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xC1
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xC2
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xC3
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xC4
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xC5
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xC6
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xC7
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xC8
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xC9
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xCA
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xCB
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xCC
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xCD
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xCE
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xCF
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xD0
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xD1
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xD2
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xD3
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xD4
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xD5
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xD6
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xD7
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xD8
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xD9
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xDA
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xDB
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xDC
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xDD
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xDE
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xDF
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xE0
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xE1
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xE2
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xE3
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xE4
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xE5
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xE6
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xE7
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xE8
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xE9
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xEA
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xEB
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xEC
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xED
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xEE
+		{ Token::CONDITION_ERROR, 0UL, &handleTlByteBasicReset, TlByteAction::BasicReset },      //0xEF
+		{ Token::CONDITION_NOT_YET_DETECTED, 0UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xF0
+		{ Token::CONDITION_NOT_YET_DETECTED, 1UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xF1
+		{ Token::CONDITION_NOT_YET_DETECTED, 2UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xF2
+		{ Token::CONDITION_NOT_YET_DETECTED, 3UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xF3
+		{ Token::CONDITION_NOT_YET_DETECTED, 4UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xF4
+		{ Token::CONDITION_NOT_YET_DETECTED, 5UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xF5
+		{ Token::CONDITION_NOT_YET_DETECTED, 6UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xF6
+		{ Token::CONDITION_NOT_YET_DETECTED, 7UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xF7
+		{ Token::CONDITION_NOT_YET_DETECTED, 8UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xF8
+		{ Token::CONDITION_NOT_YET_DETECTED, 9UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xF9
+		{ Token::CONDITION_NOT_YET_DETECTED, 10UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xFA
+		{ Token::CONDITION_NOT_YET_DETECTED, 11UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xFB
+		{ Token::CONDITION_NOT_YET_DETECTED, 12UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xFC
+		{ Token::CONDITION_NOT_YET_DETECTED, 13UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xFD
+		{ Token::CONDITION_NOT_YET_DETECTED, 14UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList },      //0xFE
+		{ Token::CONDITION_NOT_YET_DETECTED, 15UL, &handleTlByteMultiByteList, TlByteAction::MultiByteList }       //0xFF
 	};		
 
 
@@ -44,11 +44,11 @@
 // ----------------------------------------------------------------------------------------------------------------------------------------------
 // 1. Helper functions
 
+// A headless user interface has no windows
+#ifndef HEADLESS_USERINTERFACE
 
 	namespace UserinterfaceInternal
 	{
-		extern const uint NumberOfSubWindows = EhzInternal::MyNumberOfEhz;
-
 
 		
 		// -----------------------------------------------------------------------------------------------
@@ -174,9 +174,9 @@
 			//lint -e{921}
 			// Height is 2 rows more than the number of results that we want to show
 			// So we have a fixed hight. Position will be chosen on top of the status window
-			ResultWindowHeight = static_cast<sint>(NumberOfEhzMeasuredData)+2;
+			ResultWindowHeight = static_cast<sint>(EhzInternal::getMaxNumberOfUsedEhzMeasuredData())+2;
 			//lint -e{573,921,737,912}
-			ResultWindowWidth = static_cast<sint>(OutputConsoleWidth / NumberOfSubWindows);
+			ResultWindowWidth = static_cast<sint>(OutputConsoleWidth / EhzInternal::getNumberOfEhz());
 			ResultWindowY = LogWindowY - ResultWindowHeight;
 			ResultWindowX = 0;
 
@@ -186,12 +186,13 @@
 			// Position is on top of screen
 			DebugWindowHeight = (OutputConsoleHeight - ResultWindowHeight) - LogWindowHeight;
 			//lint -e{573,921,737,912}
-			DebugWindowWidth = static_cast<sint>(OutputConsoleWidth / NumberOfSubWindows);
+			DebugWindowWidth = static_cast<sint>(OutputConsoleWidth / EhzInternal::getNumberOfEhz());
 			DebugWindowY = ResultWindowY - DebugWindowHeight;
 			DebugWindowX = 0;
 		}
 
 	}
+#endif
 
 	
 	
@@ -205,6 +206,18 @@
 	// Startup ncurses
 	// Create all windows
 	
+#ifdef HEADLESS_USERINTERFACE
+	// The main window writes to stdout. The windows for the Ehz have no file and discard their output
+	void NCursesUserinterface::initialize(void)
+	{
+		thisWindow = stdout;
+		for (uint i = 0U; i< EhzInternal::getNumberOfEhz(); i++)
+		{
+			resultWindowsStream.push_back(new UserinterfaceInternal::NCursesWindowStream(null<UserinterfaceInternal::NcursesWindow>()));
+			debugWindowsStream.push_back(new UserinterfaceInternal::NCursesWindowStream(null<UserinterfaceInternal::NcursesWindow>()));
+		}
+	}
+#else
 	void NCursesUserinterface::initialize(void)
 	{
 		// ncurses is a macrco catastrophy. Lint vomits tons of messages. We will ignore them
@@ -242,7 +255,8 @@
 		
 		// ----------------------------------------------
 		// Create 2*6 windows for debug output and result
-		for (uint i = 0U; i< UserinterfaceInternal::NumberOfSubWindows; i++)
+		// One for each Ehz. The number of Ehz may change, if a configuration file is loaded. Then the user interface is initialized again
+		for (uint i = 0U; i< EhzInternal::getNumberOfEhz(); i++)
 		{
 			// ----------------------------------
 			// Create result windows in this loop
@@ -279,6 +293,7 @@
 		}
 		this->setWindowHeaders();
 	}
+#endif
 	
 	
 	NCursesUserinterface::NCursesUserinterface(void) : NCursesWindowStream(thisWindow), debugWindowsStream(), resultWindowsStream(), eventHandlerSIGWINCH()
@@ -309,6 +324,10 @@
 			delete (*it);
 		}
 		debugWindowsStream.clear();
+#ifdef HEADLESS_USERINTERFACE
+		//lint --e{534}
+		fflush(thisWindow);
+#else
 		{
 			//lint --e{534}
 			delwin(thisWindow);
@@ -316,6 +335,7 @@
 			refresh();
 			endwin();
 		}
+#endif
 	}
 	
 	NCursesUserinterface::~NCursesUserinterface(void)
@@ -344,7 +364,7 @@
 		// Temporary function return varaible
 		UserinterfaceInternal::NCursesWindowStream *nCursesWindowStream;
 		// Boundary check
-		if (windowNumber < UserinterfaceInternal::NumberOfSubWindows)
+		if (windowNumber < debugWindowsStream.size())
 		{
 			// If in bounds, then return stream for debug window
 			nCursesWindowStream = debugWindowsStream[windowNumber];
@@ -366,7 +386,7 @@
 		// Temporary function return varaible
 		UserinterfaceInternal::NCursesWindowStream *nCursesWindowStream;
 		// Boundary check
-		if (windowNumber < UserinterfaceInternal::NumberOfSubWindows)
+		if (windowNumber < resultWindowsStream.size())
 		{
 			// If in bounds, then return stream for result window
 			nCursesWindowStream = resultWindowsStream[windowNumber];
@@ -380,6 +400,12 @@
 	}
 
 
+#ifdef HEADLESS_USERINTERFACE
+	// There are no windows. Nothing to resize
+	void NCursesUserinterface::resizeWindows(void)
+	{
+	}
+#else
 	void NCursesUserinterface::resizeWindows(void)
 	{
 		//lint --e{534}
@@ -391,7 +417,7 @@
 		mvwin(thisWindow,windowDimensions.LogWindowY,windowDimensions.LogWindowX);
 		wrefresh(thisWindow);
 
-		for (uint i = 0U; i< UserinterfaceInternal::NumberOfSubWindows; i++)
+		for (uint i = 0U; i< resultWindowsStream.size(); i++)
 		{
 			//lint --e{912,737,713,917,534}
 			wresize(resultWindowsStream[i]->getWindow(),windowDimensions.ResultWindowHeight, windowDimensions.ResultWindowWidth);
@@ -406,12 +432,13 @@
 		this->setWindowHeaders();
 		refresh();
 	}
+#endif
 
 	void NCursesUserinterface::setWindowHeaders(void) const
 	{
-		for (uint i = 0U; i< UserinterfaceInternal::NumberOfSubWindows; i++)
+		for (uint i = 0U; i< debugWindowsStream.size(); i++)
 		{
 			//lint -e{1963,9050,1901}
-			ui[i] << cls << SetPos(0,0) << EhzInternal::myEhzConfigDefinition[i].EhzName << std::endl;
+			ui[i] << cls << SetPos(0,0) << EhzInternal::getEhzConfigDefinition(i).EhzName << std::endl;
 		}
 	}